@@ -45,6 +45,8 @@ GLD_SOURCES_PLACE_HOLDER += gldcore/instance_cnx.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/instance.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/instance_slave.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/instance_slave.h
+GLD_SOURCES_PLACE_HOLDER += gldcore/instrument.c
+GLD_SOURCES_PLACE_HOLDER += gldcore/instrument.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/interpolate.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/interpolate.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/job.cpp
@@ -63,6 +65,8 @@ GLD_SOURCES_PLACE_HOLDER += gldcore/list.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/list.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/load.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/load.h
+GLD_SOURCES_PLACE_HOLDER += gldcore/loadcache.c
+GLD_SOURCES_PLACE_HOLDER += gldcore/loadcache.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/loadshape.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/loadshape.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/load_xml.cpp
@@ -84,6 +88,8 @@ GLD_SOURCES_PLACE_HOLDER += gldcore/object.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/object.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/output.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/output.h
+GLD_SOURCES_PLACE_HOLDER += gldcore/partition.c
+GLD_SOURCES_PLACE_HOLDER += gldcore/partition.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/platform.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/property.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/property.h
@@ -101,6 +107,8 @@ GLD_SOURCES_PLACE_HOLDER += gldcore/server.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/server.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/setup.cpp
 GLD_SOURCES_PLACE_HOLDER += gldcore/setup.h
+GLD_SOURCES_PLACE_HOLDER += gldcore/sparsesync.c
+GLD_SOURCES_PLACE_HOLDER += gldcore/sparsesync.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/stream.cpp
 GLD_SOURCES_PLACE_HOLDER += gldcore/stream.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/stream_type.h
@@ -121,6 +129,8 @@ GLD_SOURCES_PLACE_HOLDER += gldcore/validate.cpp
 GLD_SOURCES_PLACE_HOLDER += gldcore/validate.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/version.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/version.h
+GLD_SOURCES_PLACE_HOLDER += gldcore/whatif.c
+GLD_SOURCES_PLACE_HOLDER += gldcore/whatif.h
 
 GLD_SOURCES_EXTRA_PLACE_HOLDER =
 GLD_SOURCES_EXTRA_PLACE_HOLDER += gldcore/cmex.c
@@ -310,6 +310,11 @@ static int profile(int argc, char *argv[])
 	global_profiler = !global_profiler;
 	return 0;
 }
+static int instrument(int argc, char *argv[])
+{
+	global_instrument = !global_instrument;
+	return 0;
+}
 static int mt_profile(int argc, char *argv[])
 {
 	if ( argc>1 )
@@ -847,6 +852,24 @@ static int output(int argc, char *argv[])
 		return CMDERR;
 	}
 }
+static int partition(int argc, char *argv[])
+{
+	if (argc>1 && atoi(argv[1])>1)
+	{
+		global_partition_count = (argc--,atoi(*++argv));
+		return 1;
+	}
+	else
+	{
+		output_fatal("missing or invalid partition count");
+		/* TROUBLESHOOT
+			The <b>--partition</b> command line directive
+			was not followed by a valid number of partitions.  The correct syntax is
+			<b>--partition <i>number</i></b>, where the number is at least 2.
+		 */
+		return CMDERR;
+	}
+}
 static int environment(int argc, char *argv[])
 {
 	if (argc>1)
@@ -1227,6 +1250,7 @@ static CMDARG main[] = {
 	{"dumpall",		NULL,	dumpall,		NULL, "Dumps the global variable list" },
 	{"mt_profile",	NULL,	mt_profile,		"<n-threads>", "Analyses multithreaded performance profile" },
 	{"profile",		NULL,	profile,		NULL, "Toggles performance profiling of core and modules while simulation runs" },
+	{"instrument",	NULL,	instrument,		NULL, "Toggles wall-clock instrumentation of passes, barriers, solvers and I/O" },
 	{"quiet",		"q",	quiet,			NULL, "Toggles suppression of all but error and fatal messages" },
 	{"verbose",		"v",	verbose,		NULL, "Toggles output of verbose messages" },
 	{"warn",		"w",	warn,			NULL, "Toggles display of warning messages" },
@@ -1286,6 +1310,7 @@ static CMDARG main[] = {
 	{"compile",		"C",	compile,		NULL, "Toggles compile-only flags" },
 	{"environment",	"e",	environment,	"<appname>", "Set the application to use for run environment" },
 	{"output",		"o",	output,			"<file>", "Enables save of output to a file (default is gridlabd.glm)" },
+	{"partition",	NULL,	partition,		"<n>", "Splits the model into <n> multirun sub-models instead of running it" },
 	{"pause",		NULL,	pauseatexit,			NULL, "Toggles pause-at-exit feature" },
 	{"relax",		NULL,	relax,			NULL, "Allows implicit variable definition when assignments are made" },
 
@@ -92,7 +92,8 @@ int enduse_create(enduse *addr);
 int enduse_init(enduse *e);
 int enduse_initall(void);
 TIMESTAMP enduse_sync(enduse *e, PASSCONFIG pass, TIMESTAMP t1);
-TIMESTAMP enduse_syncall(TIMESTAMP t1);
+struct s_tptask *enduse_synctask(TIMESTAMP t1);
+TIMESTAMP enduse_syncdone(struct s_tptask *task);
 int convert_to_enduse(char *string, void *data, PROPERTY *prop);
 int convert_from_enduse(char *string,int size,void *data, PROPERTY *prop);
 int enduse_publish(CLASS *oclass, PROPERTYADDR struct_address, char *prefix);
@@ -133,6 +133,10 @@
 #include "test.h"
 #include "link.h"
 #include "save.h"
+#include "server.h"
+#include "whatif.h"
+#include "instrument.h"
+#include "sparsesync.h"
 
 #include "pthread.h"
 
@@ -270,14 +274,6 @@ int64 wlock_count = 0, wlock_spin = 0;
 extern pthread_mutex_t mls_inst_lock;
 extern pthread_cond_t mls_inst_signal;
 
-//sjin: struct for pthread_create arguments
-struct arg_data {
-	int thread;
-	void *item;
-	int incr;
-};
-struct arg_data arg_data_array[2];
-
 INDEX **exec_getranks(void)
 {
 	return ranks;
@@ -334,7 +330,8 @@ char *simtime(void)
 static STATUS show_progress(void)
 {
 	extern GUIACTIONSTATUS wait_status;
-	output_progress();
+	if ( global_show_progress ) /* what-if candidates turn progress off */
+		output_progress();
 	/* reschedule report */
 	realtime_schedule_event(realtime_now()+1,show_progress);
 	return SUCCESS;
@@ -555,27 +552,6 @@ static void ss_do_object_sync(int thread, void *item)
 	}
 }
 
-//sjin: implement new ss_do_object_sync_list for pthreads
-static void *ss_do_object_sync_list(void *threadarg)
-{
-	LISTITEM *ptr;
-	int iPtr;
-
-	struct arg_data *mydata = (struct arg_data *) threadarg;
-	int thread = mydata->thread;
-	void *item = mydata->item;
-	int incr = mydata->incr;
-
-	iPtr = 0;
-	for (ptr = item; ptr != NULL; ptr=ptr->next) {
-		if (iPtr < incr) {
-			ss_do_object_sync(thread, ptr->data);
-			iPtr++;
-		}
-	}
-	return NULL;
-}
-
 static STATUS init_by_creation()
 {
 	OBJECT *obj;
@@ -619,140 +595,235 @@ static STATUS init_by_creation()
 	return rv;
 }
 
-static int init_by_deferral_retry(OBJECT **def_array, int def_ct)
+/* deferred initialization state, indexed by object id */
+static struct {
+	OBJECT **ready; /**< objects to initialize in the current round */
+	unsigned int n_ready, max_ready;
+	OBJECT **next; /**< objects to initialize in the next round */
+	unsigned int n_next;
+	OBJECT **by_id; /**< objects by id */
+	int *head; /**< first object waiting on each object (-1 if none) */
+	int *tail; /**< last object waiting on each object (-1 if none) */
+	int *link; /**< next object waiting on the same object (-1 if none) */
+	unsigned int n_pending; /**< number of objects deferred and not yet initialized */
+	unsigned int n_done; /**< number of objects initialized in the current round */
+} init_state;
+
+/** Find the uninitialized object a deferred object is most likely waiting on.
+	This is the parent when it is not initialized yet, otherwise the first
+	uninitialized object referenced by one of the object's properties.
+	@return the object to wait on, or NULL if it cannot be determined
+ **/
+static OBJECT *init_dependency(OBJECT *obj)
 {
-	OBJECT *obj;
-	int ct = 0, i = 0, obj_rv = 0;
-	OBJECT **next_arr = (OBJECT **)malloc(def_ct * sizeof(OBJECT *)), **tarray = 0;
-	int rv = SUCCESS;
-	char b[64];
-	int retry = 1, tries = 0;
-
-	if (global_init_max_defer < 1)
+	CLASS *oclass;
+	if ( obj->parent!=NULL && (obj->parent->flags&OF_INIT)!=OF_INIT )
+		return obj->parent;
+	for ( oclass=obj->oclass; oclass!=NULL; oclass=oclass->parent )
 	{
-		output_warning("init_max_defer is less than 1, disabling deferred initialization");
+		PROPERTY *prop;
+		for ( prop=oclass->pmap; prop!=NULL && prop->oclass==oclass; prop=prop->next )
+		{
+			OBJECT *ref;
+			if ( prop->ptype!=PT_object )
+				continue;
+			ref = *(OBJECT**)GETADDR(obj,prop);
+			if ( ref!=NULL && ref!=obj && (ref->flags&OF_INIT)!=OF_INIT )
+				return ref;
+		}
 	}
-	while (retry)
-	{
-		if (global_init_max_defer <= tries)
+	return NULL;
+}
+
+/** Record the result of an object's init call.  Objects that complete release
+	the objects waiting on them later in the same round, as the retry passes did
+	when the waiting object came after its dependency, and objects that defer wait
+	on their dependency, or are retried in the next round when it is unknown.
+ **/
+static STATUS init_settle(OBJECT *obj, int obj_rv)
+{
+	char b[64];
+	OBJECT *dep;
+	int id;
+	switch ( obj_rv ) {
+	case 0:
+		memset(b, 0, 64);
+		output_error("init_by_deferral(): object %s initialization failed", object_name(obj, b, 63));
+		/* TROUBLESHOOT
+			The initialization of the named object has failed.  Make sure that the object's
+			requirements for initialization are satisfied and try again.
+		 */
+		return FAILED;
+	case 1:
+		wlock(&obj->lock);
+		if ( (obj->flags&OF_DEFERRED)==OF_DEFERRED )
 		{
-			output_error("init_by_deferral_retry(): exhausted initialization attempts");
-			rv = FAILED;
-			break;
+			obj->flags -= OF_DEFERRED;
+			init_state.n_pending--;
 		}
-		memset(next_arr, 0, def_ct * sizeof(OBJECT *));
-		// initialize each object in def_array
-		for (i = 0; i < def_ct; ++i)
+		obj->flags |= OF_INIT;
+		wunlock(&obj->lock);
+		init_state.n_done++;
+		for ( id=init_state.head[obj->id]; id>=0; id=init_state.link[id] )
 		{
-			obj = def_array[i];
-			obj_rv = object_init(obj);
-			switch (obj_rv)
+			if ( init_state.n_ready==init_state.max_ready )
 			{
-				case 0:
-					rv = FAILED;
-					memset(b, 0, 64);
-					output_error("init_by_deferral_retry(): object %s initialization failed", object_name(obj, b, 63));
-					break;
-				case 1:
-					wlock(&obj->lock);
-					obj->flags |= OF_INIT;
-					obj->flags -= OF_DEFERRED;
-					wunlock(&obj->lock);
-					break;
-				case 2:
-					next_arr[ct] = obj;
-					++ct;
-					break;
-				// no default
-			}
-			if (rv == FAILED)
-			{
-				free(next_arr);
-				return rv;
+				OBJECT **grow = (OBJECT **)realloc(init_state.ready, sizeof(OBJECT *) * init_state.max_ready * 2);
+				if ( grow==NULL )
+				{
+					output_error("init_by_deferral(): memory allocation failed");
+					return FAILED;
+				}
+				init_state.ready = grow;
+				init_state.max_ready *= 2;
 			}
+			init_state.ready[init_state.n_ready++] = init_state.by_id[id];
 		}
-
-		if (ct == def_ct)
+		init_state.head[obj->id] = init_state.tail[obj->id] = -1;
+		return SUCCESS;
+	case 2:
+		if ( (obj->flags&OF_DEFERRED)!=OF_DEFERRED )
 		{
-			output_error("init_by_deferral_retry(): all uninitialized objects deferred, model is unable to initialize");
-			rv = FAILED;
-			retry = 0;
-		} else if (0 == ct)
+			wlock(&obj->lock);
+			obj->flags |= OF_DEFERRED;
+			wunlock(&obj->lock);
+			init_state.n_pending++;
+		}
+		dep = init_dependency(obj);
+		if ( dep==NULL )
+			init_state.next[init_state.n_next++] = obj;
+		else
 		{
-			rv = SUCCESS;
-			retry = 0;
-		} else {
-			++tries;
-			retry = 1;
-			tarray = next_arr;
-			next_arr = def_array;
-			def_array = tarray;
-			def_ct = ct;
-			// three-point turn to swap the 'next' and the 'old' arrays, memset 0'ing at the top.
+			init_state.link[obj->id] = -1;
+			if ( init_state.tail[dep->id]<0 )
+				init_state.head[dep->id] = obj->id;
+			else
+				init_state.link[init_state.tail[dep->id]] = obj->id;
+			init_state.tail[dep->id] = obj->id;
 		}
+		return SUCCESS;
+	default:
+		return SUCCESS;
 	}
-
-	free(next_arr);
-	return rv;
 }
 
-static int init_by_deferral()
+/** Initialize objects in creation order, deferring those that ask for it
+	until the object they are waiting on has initialized.  As before, the first
+	round covers every object and init_max_defer limits the number of rounds
+	that follow it.  Objects are still initialized one at a time on the main
+	thread: house and line init share state and are not safe to run concurrently.
+ **/
+static STATUS init_by_deferral(void)
 {
-	OBJECT **def_array = 0;
-	int i = 0, obj_rv = 0, def_ct = 0;
-	OBJECT *obj = 0;
+	OBJECT *obj;
+	unsigned int n_ids = 0, n_obj = 0, i;
+	int rescan = 0, tries = 0;
 	STATUS rv = SUCCESS;
-	char b[64];
-	def_array = (OBJECT **)malloc(sizeof(OBJECT *) * object_get_count());
-	obj = object_get_first();
-	while (obj != 0)
+
+	if ( global_init_max_defer < 1 )
+	{
+		output_warning("init_max_defer is less than 1, disabling deferred initialization");
+	}
+
+	for ( obj=object_get_first(); obj!=NULL; obj=obj->next )
+	{
+		if ( obj->id>=n_ids )
+			n_ids = (unsigned int)obj->id+1;
+		n_obj++;
+	}
+	memset(&init_state, 0, sizeof(init_state));
+	init_state.max_ready = n_obj+1;
+	init_state.ready = (OBJECT **)malloc(sizeof(OBJECT *) * init_state.max_ready);
+	init_state.next = (OBJECT **)malloc(sizeof(OBJECT *) * (n_obj+1));
+	init_state.by_id = (OBJECT **)calloc(n_ids+1, sizeof(OBJECT *));
+	init_state.head = (int *)malloc(sizeof(int) * (n_ids+1));
+	init_state.tail = (int *)malloc(sizeof(int) * (n_ids+1));
+	init_state.link = (int *)malloc(sizeof(int) * (n_ids+1));
+	if ( init_state.ready==NULL || init_state.next==NULL || init_state.by_id==NULL
+		|| init_state.head==NULL || init_state.tail==NULL || init_state.link==NULL )
 	{
-		obj_rv = object_init(obj);
-		switch (obj_rv)
+		output_error("init_by_deferral(): memory allocation failed");
+		rv = FAILED;
+		goto Done;
+	}
+	memset(init_state.head, -1, sizeof(int) * (n_ids+1));
+	memset(init_state.tail, -1, sizeof(int) * (n_ids+1));
+
+	/* the first round covers every object in creation order */
+	for ( obj=object_get_first(); obj!=NULL; obj=obj->next )
+	{
+		init_state.by_id[obj->id] = obj;
+		init_state.ready[init_state.n_ready++] = obj;
+	}
+
+	while ( init_state.n_ready>0 )
+	{
+		init_state.n_next = 0;
+		init_state.n_done = 0;
+		for ( i=0; i<init_state.n_ready; i++ )
 		{
-			case 0:
+			obj = init_state.ready[i];
+			if ( init_settle(obj,object_init(obj))==FAILED )
+			{
 				rv = FAILED;
-				memset(b, 0, 64);
-				output_error("init_by_deferral(): object %s initialization failed", object_name(obj, b, 63));
-				break;
-			case 1:
-				wlock(&obj->lock);
-				obj->flags |= OF_INIT;
-				wunlock(&obj->lock);
-				break;
-			case 2:
-				def_array[def_ct] = obj;
-				++def_ct;
-				wlock(&obj->lock);
-				obj->flags |= OF_DEFERRED;
-				wunlock(&obj->lock);
-				break;
-			// no default
+				goto Done;
+			}
 		}
 
-		if (rv == FAILED)
+		if ( init_state.n_done==0 && rescan )
 		{
-			free(def_array);
-			return rv;
+			output_error("init_by_deferral(): all uninitialized objects deferred, model is unable to initialize");
+			/* TROUBLESHOOT
+				Every object that has not been initialized yet deferred its
+				initialization again, so no further progress is possible.  This
+				usually means two or more objects are waiting on each other.
+			 */
+			rv = FAILED;
+			goto Done;
 		}
 
-		obj = obj->next;
-	}
+		/* when nothing was released, fall back to retrying every deferred object */
+		rescan = ( init_state.n_pending>0 && (init_state.n_next==0 || init_state.n_done==0) );
+		if ( rescan )
+		{
+			init_state.n_next = 0;
+			memset(init_state.head, -1, sizeof(int) * (n_ids+1));
+			memset(init_state.tail, -1, sizeof(int) * (n_ids+1));
+			for ( obj=object_get_first(); obj!=NULL; obj=obj->next )
+			{
+				if ( (obj->flags&(OF_DEFERRED|OF_INIT))==OF_DEFERRED )
+					init_state.next[init_state.n_next++] = obj;
+			}
+		}
 
-	// recursecursecursive
-	if (def_ct > 0)
-	{
-		rv = init_by_deferral_retry(def_array, def_ct);
-		if (rv == FAILED) // got hung up retrying
-		{ 
-				free(def_array);
-				return FAILED;
+		if ( init_state.n_next>0 && global_init_max_defer<=tries++ )
+		{
+			output_error("init_by_deferral(): exhausted initialization attempts");
+			/* TROUBLESHOOT
+				Objects were still deferring their initialization after the number of
+				rounds allowed by the init_max_defer global.  Check that the objects they
+				depend on can be initialized, or increase init_max_defer.
+			 */
+			rv = FAILED;
+			goto Done;
 		}
+
+		/* the ready list may have grown in the round, so it is kept and refilled */
+		memcpy(init_state.ready, init_state.next, sizeof(OBJECT *) * init_state.n_next);
+		init_state.n_ready = init_state.n_next;
 	}
-	free(def_array);
 
-	obj = object_get_first();
-	while (obj != 0)
+Done:
+	free(init_state.ready);
+	free(init_state.next);
+	free(init_state.by_id);
+	free(init_state.head);
+	free(init_state.tail);
+	free(init_state.link);
+	if ( rv==FAILED )
+		return FAILED;
+
+	for ( obj=object_get_first(); obj!=NULL; obj=obj->next )
 	{
 		if ((obj->oclass->passconfig & PC_FORCE_NAME) == PC_FORCE_NAME)
 		{
@@ -765,7 +836,6 @@ static int init_by_deferral()
 				 */
 			}
 		}
-		obj = obj->next;
 	}
 	return SUCCESS;
 }
@@ -1256,17 +1326,42 @@ TIMESTAMP sync_heartbeats(void)
 TIMESTAMP syncall_internals(TIMESTAMP t1)
 {
 	TIMESTAMP h1, h2, s1, s2, s3, s4, s5, s6, se, sa;
+	TPTASK *rv, *chain[4], *task[5], *last = NULL;
+	unsigned int n, n_tasks = 0;
 
 	/* external link must be first */
 	h1 = link_syncall(t1);
 
 	/* @todo add other internal syncs here */
 	h2 = instance_syncall(t1);	
-	s1 = randomvar_syncall(t1);
-	s2 = schedule_syncall(t1);
-	s3 = loadshape_syncall(t1);
-	s4 = transform_syncall(t1,XS_SCHEDULE|XS_LOADSHAPE);
-	s5 = enduse_syncall(t1);
+
+	/* random variables are independent, but schedules, loadshapes, their 
+	   transforms and enduses each read the ones before, so they are chained */
+	rv = randomvar_synctask(t1);
+	chain[0] = schedule_synctask(t1);
+	chain[1] = loadshape_synctask(t1);
+	chain[2] = transform_synctask(t1,XS_SCHEDULE|XS_LOADSHAPE);
+	chain[3] = enduse_synctask(t1);
+	if ( rv!=NULL )
+	{
+		rv->depends = NULL;
+		task[n_tasks++] = rv;
+	}
+	for ( n=0 ; n<4 ; n++ )
+	{
+		if ( chain[n]==NULL )
+			continue;
+		chain[n]->depends = last;
+		task[n_tasks++] = last = chain[n];
+	}
+
+	/* run them all in one fork/join */
+	tp_run(task,n_tasks);
+	s1 = randomvar_syncdone(rv);
+	s2 = schedule_syncdone(chain[0]);
+	s3 = loadshape_syncdone(chain[1]);
+	s4 = transform_syncdone(chain[2]);
+	s5 = enduse_syncdone(chain[3]);
 
 	/* heartbeats go last */
 	s6 = sync_heartbeats();
@@ -1297,68 +1392,16 @@ void exec_sleep(unsigned int usec)
 #endif
 }
 
-typedef struct s_objsyncdata {
-	unsigned int n; // thread id 0~n_threads for this object rank list
-	pthread_t pt;
-	bool ok;
-	//void *item;
-	LISTITEM *ls;
-	unsigned int nObj; // number of obj in this object rank list
-	unsigned int t0;
-	int i; // index of mutex or cond this object rank list uses 
-} OBJSYNCDATA;
-
-static pthread_mutex_t *startlock;
-static pthread_mutex_t *donelock;
-static pthread_cond_t *start;
-static pthread_cond_t *done;
+/* pool tasks that sync each object rank list */
+static TPTASK *objsynctask = NULL;
 
-static unsigned int *next_t1;
-static unsigned int *donecount;
-static unsigned int *n_threads; //number of thread used in the threadpool of an object rank list
-
-static void *obj_syncproc(void *ptr)
+static TIMESTAMP obj_synccall(TPTASK *task, unsigned int first, unsigned int last, unsigned int thread)
 {
-	OBJSYNCDATA *data = (OBJSYNCDATA*)ptr;
-	LISTITEM *s;
+	OBJECT **obj = (OBJECT**)task->data;
 	unsigned int n;
-	int i = data->i;
-
-	// begin processing loop
-	while (data->ok)
-	{
-		// lock access to start condition
-		pthread_mutex_lock(&startlock[i]);
-
-		// wait for thread start condition)
-		while (data->t0 == next_t1[i]) 
-			pthread_cond_wait(&start[i], &startlock[i]);
-		// unlock access to start count
-		pthread_mutex_unlock(&startlock[i]);
-
-		// process the list for this thread
-		for (s=data->ls, n=0; s!=NULL, n<data->nObj; s=s->next,n++) {
-			OBJECT *obj = s->data;
-			ss_do_object_sync(data->n, s->data);
-		}
-
-		// signal completed condition
-		data->t0 = next_t1[i];
-
-		// lock access to done condition
-		pthread_mutex_lock(&donelock[i]);
-
-		// signal thread is done for now
-		donecount[i] --; 
-
-		// signal change in done condition
-		pthread_cond_broadcast(&done[i]);
-
-		//unlock access to done count
-		pthread_mutex_unlock(&donelock[i]);
-	}
-	pthread_exit((void*)0);
-	return (void*)0;
+	for ( n=first ; n<last ; n++ )
+		ss_do_object_sync(thread,obj[n]);
+	return TS_NEVER;
 }
 
 /** MAIN LOOP CONTROL ******************************************************************/
@@ -1415,6 +1458,8 @@ void exec_mls_suspend(void)
 	sched_update(global_clock,global_mainloopstate=MLS_PAUSED);
 	output_debug("wait loop_");
 	while ( global_clock==TS_ZERO || (global_clock>=global_mainlooppauseat && global_mainlooppauseat<TS_NEVER) ) {
+		/* no pass is running, so event streams opened during the pause can be sampled now */
+		server_update(global_clock);
 		if (loopctr > 0)
 		{
 			output_debug(" * tick (%i)", --loopctr);
@@ -1456,6 +1501,18 @@ void exec_mls_resume(TIMESTAMP ts)
 	}
 }
 
+/** Wake the main loop while it is paused, without resuming it, so that it
+	updates the server event streams
+ **/
+void exec_mls_wake(void)
+{
+	if ( !mls_created )
+		return;
+	pthread_mutex_lock(&mls_svr_lock);
+	pthread_cond_broadcast(&mls_svr_signal);
+	pthread_mutex_unlock(&mls_svr_lock);
+}
+
 void exec_mls_statewait(unsigned states)
 {
 	pthread_mutex_lock(&mls_svr_lock);
@@ -1672,18 +1729,15 @@ STATUS exec_start(void)
 	int pc_rv = 0; // precommit return value
 	STATUS fnl_rv = 0; // finalize all return value
 	time_t started_at = realtime_now(); // for profiler
-	int j, k;
+	int j;
 	LISTITEM *ptr;
-	int incr;
-	struct arg_data *arg_data_array;
-
-	// Only setup threadpool for each object rank list at the first iteration;
-	// After the first iteration, setTP = false;
-	bool setTP = true; 
-	//int n_threads; //number of thread used in the threadpool of an object rank list
-	OBJSYNCDATA *thread = NULL;
 
 	int nObjRankList, iObjRankList;
+	static const char *instrument_pass[] = {"presync","sync","postsync"};
+	int64 instrument_t;
+	bool sparse = false;
+
+	instrument_thread("main");
 
 	/* run create scripts, if any */
 	if ( exec_run_createscripts()!=XC_SUCCESS )
@@ -1739,16 +1793,8 @@ STATUS exec_start(void)
 			realtime_schedule_event(realtime_now()+1,show_progress);
 		}
 
-		/* set thread count equal to processor count if not passed on command-line */
-		if (global_threadcount == 0)
-		{
-			global_threadcount = processor_count();
-			output_verbose("using %d helper thread(s)", global_threadcount);
-		}
-
-		//sjin: allocate arg_data_array to store pthreads creation argument
-		arg_data_array = (struct arg_data *) malloc(sizeof(struct arg_data) 
-						 * global_threadcount);
+		/* start the worker pool (this sets the thread count to the processor count if not passed on command-line) */
+		tp_init();
 
 		/* allocate thread synchronization data */
 		thread_data = (struct thread_data *) malloc(sizeof(struct thread_data) +
@@ -1765,6 +1811,20 @@ STATUS exec_start(void)
 		thread_data->data = (struct sync_data *) (thread_data + 1);
 		for (j = 0; j < thread_data->count; j++) 
 			thread_data->data[j].status = SUCCESS;
+
+		/* index the skip-safe objects for sparse dispatch */
+		if (global_sparse_sync && global_threadcount==1)
+		{
+			if (sparsesync_init(ranks)==FAILED)
+				return FAILED;
+			sparse = true;
+		}
+		else if (global_sparse_sync)
+			output_warning("sparse_sync is only used when threadcount is 1");
+			/* TROUBLESHOOT
+				Sparse dispatch of object syncs is done only on the single threaded
+				sync path.  Set threadcount to 1 to use it, or turn off sparse_sync.
+			 */
 	}
 	else
 	{
@@ -1843,29 +1903,17 @@ STATUS exec_start(void)
 		}
 	}
 
-	/* allocate and initialize thread data */
+	/* allocate the pool tasks of the object rank lists */
 	output_debug("nObjRankList=%d ",nObjRankList);
-
-	next_t1 = malloc(sizeof(next_t1[0])*nObjRankList);
-	memset(next_t1,0,sizeof(next_t1[0])*nObjRankList);
-
-	donecount = malloc(sizeof(donecount[0])*nObjRankList);
-	memset(donecount,0,sizeof(donecount[0])*nObjRankList);
-
-	n_threads = malloc(sizeof(n_threads[0])*nObjRankList);
-	memset(n_threads,0,sizeof(n_threads[0])*nObjRankList);
-
-	// allocation and nitialize mutex and cond for object rank lists
-	startlock = malloc(sizeof(startlock[0])*nObjRankList);
-	donelock = malloc(sizeof(donelock[0])*nObjRankList);
-	start = malloc(sizeof(start[0])*nObjRankList);
-	done = malloc(sizeof(done[0])*nObjRankList);
-	for(k=0;k<nObjRankList;k++) 
+	objsynctask = (TPTASK*)calloc(nObjRankList>0?nObjRankList:1,sizeof(TPTASK));
+	if ( objsynctask==NULL )
 	{
-		pthread_mutex_init(&startlock[k], NULL);
-		pthread_mutex_init(&donelock[k], NULL);
-		pthread_cond_init(&start[k], NULL);
-		pthread_cond_init(&done[k], NULL);
+		output_error("object rank list task allocation failed");
+		/* TROUBLESHOOT
+			The pool tasks used to sync the object rank lists could not be allocated.
+			Follow the standard process for freeing up memory and try again.
+		 */
+		return FAILED;
 	}
 
 	// global test mode
@@ -1890,8 +1938,9 @@ STATUS exec_start(void)
 			TIMESTAMP internal_synctime;
 			output_debug("*** main loop event at %lli; stoptime=%lli, n_events=%i, exitcode=%i ***", exec_sync_get(NULL), global_stoptime, exec_sync_getevents(NULL), exec_getexitcode());
 
-			/* update the process table info */
-			sched_update(global_clock,MLS_RUNNING);
+			/* update the process table info (what-if candidates do not own a process table entry) */
+			if ( !whatif_ischild() )
+				sched_update(global_clock,MLS_RUNNING);
 
 			/* main loop control */
 			if ( global_clock>=global_mainlooppauseat && global_mainlooppauseat<TS_NEVER )
@@ -1940,6 +1989,12 @@ STATUS exec_start(void)
 			/* operate delta mode if necessary (but only when event mode is active, e.g., not right after init) */
 			/* note that delta mode cannot be supported for realtime simulation */
 			global_deltaclock = 0;
+
+			/* publish the calendar context for the new clock */
+			timestamp_update_calendar(global_clock);
+
+			/* run pending what-if searches (what-if candidates continue from here in their own process) */
+			whatif_run(global_clock);
 //			if ( global_run_realtime==0 )
 			{
 				/* determine whether any modules seek delta mode */
@@ -2008,7 +2063,9 @@ STATUS exec_start(void)
 				exec_sync_set(NULL,global_stoptime+1);
 
 			/* synchronize all internal schedules */
+			instrument_t = instrument_now();
 			internal_synctime = syncall_internals(global_clock);
+			instrument_span("internals",IC_CORE,instrument_t);
 			if( internal_synctime!=TS_NEVER && absolute_timestamp(internal_synctime)<global_clock )
 			{
 				// must be able to force reiterations for m/s mode.
@@ -2037,7 +2094,9 @@ STATUS exec_start(void)
 			/* run precommit only on first iteration */
 			if (iteration_counter == global_iteration_limit)
 			{
+				instrument_t = instrument_now();
 				pc_rv = precommit_all(global_clock);
+				instrument_span("precommit",IC_CORE,instrument_t);
 				if(SUCCESS != pc_rv)
 				{
 					THROW("precommit failure");
@@ -2045,6 +2104,10 @@ STATUS exec_start(void)
 			}
 			iObjRankList = -1;
 
+			/* return the parked objects that are due to their rank lists */
+			if (sparse)
+				sparsesync_wake(global_clock);
+
 			/* scan the ranks of objects for each pass */
 			for (pass = 0; ranks[pass] != NULL; pass++)
 			{
@@ -2058,6 +2121,7 @@ STATUS exec_start(void)
 						continue;
 
 					iObjRankList ++;
+					instrument_t = instrument_now();
 
 					if (global_debug_mode)
 					{
@@ -2075,7 +2139,9 @@ STATUS exec_start(void)
 					else
 					{
 						//sjin: if global_threadcount == 1, no pthread multhreading
-						if (global_threadcount == 1) 
+						if (sparse)
+							sparsesync_run(pass,i,ss_do_object_sync);
+						else if (global_threadcount == 1) 
 						{
 							for (ptr = ranks[pass]->ordinal[i]->first; ptr != NULL; ptr=ptr->next) {
 								OBJECT *obj = ptr->data;
@@ -2091,78 +2157,28 @@ STATUS exec_start(void)
 							//printf("\n");
 						} 
 						else 
-						{ //sjin: implement pthreads
-							unsigned int n_items,objn=0,n;
-							unsigned int n_obj = ranks[pass]->ordinal[i]->size;
-
-							// Only create threadpool for each object rank list at the first iteration. 
-							// Reuse the threadppol of each object rank list at all other iterations.
-							if (setTP == true) { 
-								incr = (int)ceil((float) n_obj / global_threadcount);
-								// if the number of objects is less than or equal to the number of threads, each thread process one object 
-								if (incr <= 1) {
-									n_threads[iObjRankList] = n_obj;
-									n_items = 1;
-								// if the number of objects is greater than the number of threads, each thread process the same number of 
-								// objects (incr), except that the last thread may process less objects 
-								} else {
-									n_threads[iObjRankList] = (int)ceil((float) n_obj / incr);
-									n_items = incr;
-								}
-								if ((int)n_threads[iObjRankList] > global_threadcount) {
-									output_error("Running threads > global_threadcount");
-									exit(0);
-								}
-
-								// allocate thread list
-								thread = (OBJSYNCDATA*)malloc(sizeof(OBJSYNCDATA)*n_threads[iObjRankList]);
-								memset(thread,0,sizeof(OBJSYNCDATA)*n_threads[iObjRankList]);
-								// assign starting obj for each thread
-								for (ptr=ranks[pass]->ordinal[i]->first;ptr!=NULL;ptr=ptr->next)
-								{
-									if (thread[objn].nObj==n_items)
-										objn++;
-									if (thread[objn].nObj==0) {
-										thread[objn].ls=ptr;
-									}
-									thread[objn].nObj++;
-								}
-								// create threads
-								for (n=0; n<n_threads[iObjRankList]; n++) {
-									thread[n].ok = true;
-									thread[n].i = iObjRankList;
-									if (pthread_create(&(thread[n].pt),NULL,obj_syncproc,&(thread[n]))!=0) {
-										output_fatal("obj_sync thread creation failed");
-										thread[n].ok = false;
-									} else
-										thread[n].n = n;
-								}
+						{
+							TPTASK *task = &objsynctask[iObjRankList];
 
+							// index the objects of the rank list on the first iteration
+							if ( task->data==NULL )
+							{
+								unsigned int n = 0, n_obj = ranks[pass]->ordinal[i]->size;
+								OBJECT **obj = (OBJECT**)malloc(sizeof(OBJECT*)*(n_obj+1));
+								if ( obj==NULL )
+									THROW("object rank list indexing failed");
+								for ( ptr=ranks[pass]->ordinal[i]->first ; ptr!=NULL && n<n_obj ; ptr=ptr->next )
+									obj[n++] = (OBJECT*)ptr->data;
+								task->name = instrument_pass[pass];
+								task->call = obj_synccall;
+								task->data = (void*)obj;
+								task->n_items = n;
+								task->grain = 1;
+								task->list = iObjRankList+1;
 							}
-														
-							// lock access to done count
-							pthread_mutex_lock(&donelock[iObjRankList]);
-							
-							// initialize wait count
-							donecount[iObjRankList] = n_threads[iObjRankList];
-
-							// lock access to start condition
-							pthread_mutex_lock(&startlock[iObjRankList]);
-
-							// update start condition
-							next_t1[iObjRankList] ++;
-
-							// signal all the threads
-							pthread_cond_broadcast(&start[iObjRankList]);
-							// unlock access to start count
-							pthread_mutex_unlock(&startlock[iObjRankList]);
-
-							// begin wait
-							while (donecount[iObjRankList]>0)
-								pthread_cond_wait(&done[iObjRankList],&donelock[iObjRankList]);
-							// unlock done count
-							pthread_mutex_unlock(&donelock[iObjRankList]);
+							tp_run(&task,1);
 						}
+						instrument_span_arg(instrument_pass[pass],IC_PASS,instrument_t,iObjRankList);
 
 						for (j = 0; j < thread_data->count; j++) {
 							if (thread_data->data[j].status == FAILED) {
@@ -2180,7 +2196,6 @@ STATUS exec_start(void)
 					exec_sync_set(NULL,st);
 				}
 			}
-			setTP = false;
 
 			if (!global_debug_mode)
 			{
@@ -2189,6 +2204,10 @@ STATUS exec_start(void)
 					exec_sync_merge(NULL,&thread_data->data[j]);
 				}
 
+				/* post the times the parked objects stop skipping */
+				if (sparse)
+					exec_sync_set(NULL,sparsesync_next());
+
 				/* report progress */
 				realtime_run_schedule();
 			}
@@ -2215,7 +2234,9 @@ STATUS exec_start(void)
 			if ( exec_sync_get(NULL)!=global_clock )
 			{
 				TIMESTAMP commit_time = TS_NEVER;
+				instrument_t = instrument_now();
 				commit_time = commit_all(global_clock, exec_sync_get(NULL));
+				instrument_span("commit",IC_CORE,instrument_t);
 				if ( absolute_timestamp(commit_time) <= global_clock)
 				{
 					// commit cannot force reiterations, and any event where the time is less than the global clock
@@ -2231,6 +2252,9 @@ STATUS exec_start(void)
 				{
 					exec_sync_set(NULL,commit_time);
 				}
+				/* update server event streams */
+				server_update(global_clock);
+
 				/* reset iteration count */
 				iteration_counter = global_iteration_limit;
 
@@ -2310,6 +2334,9 @@ STATUS exec_start(void)
 	}
 	ENDCATCH
 	output_debug("*** main loop ended at %lli; stoptime=%lli, n_events=%i, exitcode=%i ***", exec_sync_get(NULL), global_stoptime, exec_sync_getevents(NULL), exec_getexitcode());
+
+	/* what-if candidates report their objective and exit here */
+	whatif_child_exit(!exec_sync_isinvalid(NULL) && exec_getexitcode()==XC_SUCCESS);
 	if(global_multirun_mode == MRM_MASTER)
 	{
 		instance_master_done(TS_NEVER); // tell everyone to pack up and go home
@@ -2334,6 +2361,7 @@ STATUS exec_start(void)
 	/* deallocate threadpool */
 	if (!global_debug_mode)
 	{
+		tp_term();
 		free(thread_data);
 		thread_data = NULL;
 
@@ -2344,14 +2372,6 @@ STATUS exec_start(void)
 #endif
 	}
 
-	// Destroy mutex and cond
-	for(k=0;k<nObjRankList;k++) {
-		pthread_mutex_destroy(&startlock[k]);
-		pthread_mutex_destroy(&donelock[k]);
-		pthread_cond_destroy(&start[k]);
-		pthread_cond_destroy(&done[k]);
-	}
-
 	/* report performance */
 	if (global_profiler && !exec_sync_isinvalid(NULL) )
 	{
@@ -2404,6 +2424,12 @@ STATUS exec_start(void)
 		output_profile("Passes completed        %8d passes", passes);
 		output_profile("Time steps completed    %8d timesteps", tsteps);
 		output_profile("Convergence efficiency  %8.02lf passes/timestep", (double)passes/tsteps);
+		if ( sparse )
+		{
+			int64 visited, skipped;
+			sparsesync_getstats(&visited,&skipped);
+			output_profile("Sparse syncs skipped    %7.01lf%%", visited+skipped>0 ? (double)skipped/(double)(visited+skipped)*100 : 0);
+		}
 #ifndef NOLOCKS
 		output_profile("Read lock contention    %7.01lf%%", (rlock_spin>0 ? (1-(double)rlock_count/(double)rlock_spin)*100 : 0));
 		output_profile("Write lock contention   %7.01lf%%", (wlock_spin>0 ? (1-(double)wlock_count/(double)wlock_spin)*100 : 0));
@@ -40,6 +40,7 @@ void exec_mls_create(void);
 void exec_mls_init(void);
 void exec_mls_suspend(void);
 void exec_mls_resume(TIMESTAMP next_pause);
+void exec_mls_wake(void);
 void exec_mls_done(void);
 void exec_mls_statewait(unsigned states);
 void exec_slave_node();
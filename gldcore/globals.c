@@ -45,7 +45,8 @@ static KEYWORD cpt_keys[] = {
 
 static KEYWORD rng_keys[] = {
 	{"RNG2", RNG2, rng_keys+1},		/**< version 2 random number generator (stateless) */
-	{"RNG3", RNG3, NULL,},			/**< version 3 random number generator (statefull) */
+	{"RNG3", RNG3, rng_keys+2},		/**< version 3 random number generator (statefull) */
+	{"RNG4", RNG4, NULL,},			/**< version 4 random number generator (counter-based) */
 };
 
 static KEYWORD mls_keys[] = {
@@ -162,7 +163,7 @@ static struct s_varmap {
 	{"tmp", PT_char1024, &global_tmp, PA_PUBLIC, "temporary folder name"},
 	{"force_compile", PT_int32, &global_force_compile, PA_PUBLIC, "force recompile enable flag"},
 	{"nolocks", PT_bool, &global_nolocks, PA_PUBLIC, "locking disable flag"},
-	{"skipsafe", PT_bool, &global_skipsafe, PA_PUBLIC, "skip sync safe enable flag"},
+	{"skipsafe", PT_int32, &global_skipsafe, PA_PUBLIC, "number of seconds objects may safely skip on sync (0 disables skipsafe)"},
 	{"dateformat", PT_enumeration, &global_dateformat, PA_PUBLIC, "date format string", df_keys},
 	{"init_sequence", PT_enumeration, &global_init_sequence, PA_PUBLIC, "initialization sequence control flag", isc_keys},
 	{"minimum_timestep", PT_int32, &global_minimum_timestep, PA_PUBLIC, "minimum timestep"},
@@ -215,6 +216,11 @@ static struct s_varmap {
 	{"sanitize_prefix", PT_char8, &global_sanitizeprefix, PA_PUBLIC, "sanitized name prefix"},
 	{"sanitize_index", PT_char1024, &global_sanitizeindex, PA_PUBLIC, "sanitization index file spec"},
 	{"sanitize_offset", PT_char32, &global_sanitizeoffset, PA_PUBLIC, "sanitization lat/lon offset"},
+	{"partition_cuts", PT_char1024, &global_partition_cuts, PA_PUBLIC, "link classes at which the model may be partitioned"},
+	{"partition_write", PT_char1024, &global_partition_write, PA_PUBLIC, "boundary node properties written by the master"},
+	{"partition_read", PT_char1024, &global_partition_read, PA_PUBLIC, "boundary node properties read by the master"},
+	{"partition_boundary", PT_char1024, &global_partition_boundary, PA_PUBLIC, "settings applied to boundary nodes in slave sub-models"},
+	{"whatif_maxprocs", PT_int32, &global_whatif_maxprocs, PA_PUBLIC, "maximum number of what-if candidates simulated at once (0 for processor count)"},
 	{"simulation_mode",PT_enumeration,&global_simulation_mode,PA_PUBLIC, "current time simulation type",sm_keys},
 	{"deltamode_timestep",PT_int32,&global_deltamode_timestep,PA_PUBLIC, "uniform step size for deltamode simulations"},
 	{"deltamode_maximumtime", PT_int64,&global_deltamode_maximumtime,PA_PUBLIC, "maximum time (ns) deltamode can run"},
@@ -224,6 +230,13 @@ static struct s_varmap {
 	{"deltamode_iteration_limit", PT_int32, &global_deltamode_iteration_limit, PA_PUBLIC, "iteration limit for each delta timestep (object and interupdate)"},
 	{"run_powerworld", PT_bool, &global_run_powerworld, PA_PUBLIC, "boolean that that says your system is set up correctly to run with PowerWorld"},
 	{"bigranks", PT_bool, &global_bigranks, PA_PUBLIC, "enable fast/blind set_rank operations"},
+	{"object_slab_size", PT_int32, &global_object_slab_size, PA_PUBLIC, "size of the chunks objects of a class are allocated from (0 to allocate each object separately)"},
+	{"object_hugepages", PT_bool, &global_object_hugepages, PA_PUBLIC, "map object chunks on huge pages"},
+	{"model_cache", PT_char1024, &global_model_cache, PA_PUBLIC, "directory of the binary model cache of the loader"},
+	{"instrument", PT_bool, &global_instrument, PA_PUBLIC, "instrumentation enable flag"},
+	{"instrument_trace", PT_char1024, &global_instrument_trace, PA_PUBLIC, "file the instrumentation trace is written to"},
+	{"sparse_sync", PT_bool, &global_sparse_sync, PA_PUBLIC, "sparse dispatch of skip-safe object syncs enable flag"},
+	{"sparse_sync_skipped", PT_int64, &global_sparse_sync_skipped, PA_REFERENCE, "number of object syncs skipped by sparse sync"},
 	{"exename", PT_char1024, &global_execname, PA_REFERENCE, "argv[0] value"},
 	{"wget_options", PT_char1024, &global_wget_options, PA_PUBLIC, "wget options"},
 	{"svnroot", PT_char1024, &global_svnroot, PA_PUBLIC, "svnroot"},
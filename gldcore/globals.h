@@ -130,7 +130,7 @@ GLOBAL char global_tmp[1024] /**< location for temp files */
 GLOBAL int global_force_compile INIT(0); /** flag to force recompile of GLM file even when up to date */
 GLOBAL int global_nolocks INIT(0); /** flag to disable memory locking */
 GLOBAL int global_forbid_multiload INIT(0); /** flag to disable multiple GLM file loads */
-GLOBAL int global_skipsafe INIT(0); /** flag to allow skipping of safe syncs (see OF_SKIPSAFE) */
+GLOBAL int global_skipsafe INIT(0); /** number of seconds safe syncs may be skipped (see OF_SKIPSAFE) */
 typedef enum {DF_ISO=0, DF_US=1, DF_EURO=2} DATEFORMAT;
 GLOBAL int global_dateformat INIT(DF_ISO); /** date format (ISO=0, US=1, EURO=2) */
 typedef enum {IS_CREATION=0, IS_DEFERRED=1, IS_BOTTOMUP=2, IS_TOPDOWN=3} INITSEQ;
@@ -213,6 +213,7 @@ GLOBAL int global_check_version INIT(0); /**< check version flag */
 typedef enum {
 	RNG2=2, /**< random numbers generated using pre-V3 method */
 	RNG3=3, /**< random numbers generated using post-V2 method */
+	RNG4=4, /**< random numbers generated using counter-based method (Philox4x32-10) */
 } RANDOMNUMBERGENERATOR; /**< identifies the type of random number generator used */
 GLOBAL int global_randomnumbergenerator INIT(RNG3); /**< select which random number generator to use */
 
@@ -307,8 +308,23 @@ GLOBAL char8 global_sanitizeprefix INIT("GLD_"); /**< sanitized name prefix */
 GLOBAL char1024 global_sanitizeindex INIT(".txt"); /**< sanitize index file spec */
 GLOBAL char32 global_sanitizeoffset INIT(""); /**< sanitize lat/lon offset */
 
+GLOBAL int32 global_partition_count INIT(0); /**< number of sub-models to partition the model into (0 to run the model) */
+GLOBAL char1024 global_partition_cuts INIT("transformer,regulator"); /**< link classes at which the model may be partitioned */
+GLOBAL char1024 global_partition_write INIT("voltage_A,voltage_B,voltage_C"); /**< boundary node properties written by the master */
+GLOBAL char1024 global_partition_read INIT("power_A,power_B,power_C"); /**< boundary node properties read by the master */
+GLOBAL char1024 global_partition_boundary INIT("bustype=SWING"); /**< settings applied to boundary nodes in slave sub-models */
+
+GLOBAL int32 global_whatif_maxprocs INIT(0); /**< maximum number of what-if candidates simulated at once (0 for processor count) */
+
 GLOBAL bool global_run_powerworld INIT(false);
 GLOBAL bool global_bigranks INIT(true); /**< enable non-recursive set_rank function (good for very deep models) */
+GLOBAL int32 global_object_slab_size INIT(2*1024*1024); /**< size of the chunks objects of a class are carved from (0 to allocate each object separately) */
+GLOBAL bool global_object_hugepages INIT(false); /**< map object slab chunks on huge pages */
+GLOBAL char1024 global_model_cache INIT(""); /**< directory of the binary model cache of the loader (empty to disable) */
+GLOBAL bool global_instrument INIT(false); /**< time object passes, barriers, solvers and I/O on the wall clock */
+GLOBAL char1024 global_instrument_trace INIT(""); /**< file the instrumented spans are written to as a Chrome trace (empty to disable) */
+GLOBAL bool global_sparse_sync INIT(false); /**< park skip-safe objects until their syncs are due instead of visiting them every pass (requires skipsafe) */
+GLOBAL int64 global_sparse_sync_skipped INIT(0); /**< number of object syncs sparse sync has skipped by parking */
 GLOBAL char1024 global_svnroot INIT("http://gridlab-d.svn.sourceforge.net/svnroot/gridlab-d");
 GLOBAL char1024 global_wget_options INIT("maxsize:100MB;update:newer"); /**< maximum size of wget request */
 
@@ -238,7 +238,7 @@ CDECL EXTERN CALLBACKS *callback INIT(NULL);
 #ifdef __cplusplus
 inline void GL_THROW(char *format, ...)
 {
-	static char buffer[1024];
+	static THREADLOCAL char buffer[1024]; /* per thread, so concurrent throws on pool threads keep their own message */
 	va_list ptr;
 	va_start(ptr,format);
 	vsprintf(buffer,format,ptr);
@@ -825,6 +825,21 @@ inline bool *gl_get_bool(OBJECT *obj, /**< object to set dependency */
 #define gl_random_beta (*callback->random.beta)
 #define gl_random_weibull (*callback->random.weibull)
 #define gl_random_rayleigh (*callback->random.rayleigh)
+
+/** Initialize a counter-based random stream owned by an object
+	@see random_stream_init()
+ **/
+#define gl_random_stream_init (*callback->random.stream_init)
+
+/** Draw a uniform number from a counter-based random stream
+	@see random_stream_unit()
+ **/
+#define gl_random_stream_unit (*callback->random.stream_unit)
+
+/** Fill an array with samples from a counter-based random stream
+	@see random_stream_fill()
+ **/
+#define gl_random_stream_fill (*callback->random.stream_fill)
 /** @} **/
 
 /******************************************************************************
@@ -888,6 +903,16 @@ inline bool *gl_get_bool(OBJECT *obj, /**< object to set dependency */
  **/
 #define gl_localtime (*callback->time.local_datetime)
 
+/** Get the read-only calendar context of the current clock
+	@see timestamp_calendar()
+ **/
+#define gl_calendar (*callback->time.calendar)
+
+/** Convert a timestamp to a local calendar context
+	@see local_calendar()
+ **/
+#define gl_localcalendar (*callback->time.local_calendar)
+
 #ifdef __cplusplus
 inline int gl_getweekday(TIMESTAMP t)
 {
@@ -1150,6 +1175,85 @@ inline size_t nextpow2(register size_t x)
 #define gl_forecast_save (*callback->forecast.save)
 /**@}*/
 
+/******************************************************************************
+ * What-if evaluation
+ */
+/** @defgroup gridlabd_h_whatif What-if evaluation
+ @{
+ **/
+
+/** Create a what-if block for an object
+	@see whatif_create()
+ **/
+#define gl_whatif_create (*callback->whatif.create)
+
+/** Set the address of a what-if decision variable
+	@see whatif_set_variable()
+ **/
+#define gl_whatif_set_variable (*callback->whatif.set_variable)
+
+/** Set the address of the what-if objective
+	@see whatif_set_objective()
+ **/
+#define gl_whatif_set_objective (*callback->whatif.set_objective)
+
+/** Start a what-if search at the next safe point
+	@see whatif_start()
+ **/
+#define gl_whatif_start (*callback->whatif.start)
+
+/** Check whether a what-if search is waiting to run
+	@see whatif_pending()
+ **/
+#define gl_whatif_pending (*callback->whatif.pending)
+
+/** Check whether this process is evaluating a what-if candidate
+	@see whatif_ischild()
+ **/
+#define gl_whatif_ischild (*callback->whatif.ischild)
+/**@}*/
+
+/******************************************************************************
+ * Instrumentation
+ */
+/** @defgroup gridlabd_h_instrument Instrumentation
+ @{
+ **/
+
+/** Read the instrumentation clock (0 when instrumentation is off)
+	@see instrument_now()
+ **/
+#define gl_instrument_now (*callback->instrument.now)
+
+/** Record a span that started at a time read by gl_instrument_now()
+	@see instrument_span()
+ **/
+#define gl_instrument_span (*callback->instrument.span)
+/**@}*/
+
+/******************************************************************************
+ * Thread pool
+ */
+/** @defgroup gridlabd_h_pool Thread pool
+ @{
+ **/
+
+/** Get the number of core pool threads
+	@see tp_threadcount()
+ **/
+#define gl_pool_threadcount (*callback->pool.threadcount)
+
+/** Process tasks on the core pool threads and wait for them to complete
+	@see tp_run()
+ **/
+#define gl_pool_run (*callback->pool.run)
+
+/** Give a thread created by a pool thread all the processors of the process
+	@see tp_release()
+ **/
+#define gl_pool_release (*callback->pool.release)
+/**@}*/
+
 
 /******************************************************************************
  * Init/Sync/Create catchall macros
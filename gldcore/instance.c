@@ -18,6 +18,8 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <sys/errno.h>
+#include <sys/mman.h>
+#include <unistd.h>
 #define SOCKET int
 #define INVALID_SOCKET (-1)
 #define closesocket close
@@ -216,10 +218,13 @@ void *instance_runproc(void *ptr)
 #endif
 		case CI_SHMEM:
 #ifdef WIN32
+			output_error("Shared Memory (shmem) instance mode not supported under Windows, please use Memory Map (mmap) instead.");
 			rc = -1;
-			break;
 #else
-			// shmem not written yet
+			/* run new instance */
+			sprintf(cmd,"%s %s %s --slave localhost:%"FMT_INT64"x %s", global_execname, global_verbose_mode?"--verbose":"", global_debug_output?"--debug":"", inst->cacheid, inst->model);
+			output_verbose("starting new instance with command '%s'", cmd);
+			rc = system(cmd);
 #endif
 			break;
 		case CI_SOCKET:
@@ -381,6 +386,23 @@ int instance_master_wait_socket(instance *inst){
 	return 1;
 }
 
+int instance_master_wait_shmem(instance *inst){
+	SHMEMHEADER *hdr;
+
+	if(0 == inst){
+		output_error("instance_master_wait_shmem(): null inst pointer");
+		return 0;
+	}
+	hdr = (SHMEMHEADER*)inst->filemap;
+	if ( !instance_shmem_wait(&hdr->master_seq, &hdr->master_wait, &inst->shmseq) )
+	{
+		output_error("slave %d wait failed", inst->id);
+		return 0;
+	}
+	output_debug("slave %d wait completed", inst->id);
+	return 1;
+}
+
 /** instance_master_wait
 	Wait the master into a wait state for all the slave->master signal.
  **/
@@ -399,6 +421,9 @@ int instance_master_wait(void)
 #else
 	// @todo linux/unix slave signalling
 #endif
+		if(inst->cnxtype == CI_SHMEM){
+			status = instance_master_wait_shmem(inst);
+		}
 		if(inst->cnxtype == CI_SOCKET){
 			status = instance_master_wait_socket(inst);
 		}
@@ -427,7 +452,16 @@ void instance_master_done_mmap(instance *inst){
 }
 
 void instance_master_done_shmem(instance *inst){
-	;	// send
+	SHMEMHEADER *hdr;
+
+	if(0 == inst){
+		output_error("instance_master_done_shmem(): null inst pointer");
+		return;
+	}
+	/* the cache lives in the segment, so only the signal is needed */
+	hdr = (SHMEMHEADER*)inst->filemap;
+	if ( !instance_shmem_signal(&hdr->slave_seq, &hdr->slave_wait) )
+		output_error("instance_master_done_shmem(): unable to signal slave %d", inst->id);
 }
 
 void instance_master_done_socket(instance *inst){
@@ -648,9 +682,7 @@ STATUS instance_initall(void)
 		global_multirun_mode = MRM_MASTER;
 		output_verbose("entering multirun mode");
 		output_prefix_enable();
-		pthread_mutex_lock(&mls_inst_lock);
-		pthread_cond_wait(&mls_inst_signal, &mls_inst_lock);
-		
+		// nothing on the master side signals mls_inst_signal (it only pairs the slave's main and slaveproc threads)
 	} else {
 		return SUCCESS;
 	}
@@ -663,6 +695,18 @@ STATUS instance_initall(void)
 
 	// wait for slaves to signal init done
 	rv = instance_master_wait();
+#ifndef WIN32
+	// slaves have mapped their shmem segments by now (or never will), so the names are no longer needed
+	for ( inst=instance_list ; inst!=NULL ; inst=inst->next )
+	{
+		if ( inst->cnxtype==CI_SHMEM )
+		{
+			char cachename[1024];
+			sprintf(cachename,"/GLD-%"FMT_INT64"x",inst->cacheid);
+			shm_unlink(cachename);
+		}
+	}
+#endif
 	if(0 == rv){
 		output_error("instance_initall(): final wait() failed");
 		return FAILED;
@@ -694,7 +738,8 @@ STATUS instance_write_slave(instance *inst)
 		}
 	}
 	//output_verbose("copying %d bytes from %x to %x (%lli)", inst->cachesize, inst->cache, inst->buffer, inst->cache->ts);
-	memcpy(inst->buffer, inst->cache, inst->cachesize);
+	if ( inst->buffer!=(char*)inst->cache ) // shmem caches are written in place
+		memcpy(inst->buffer, inst->cache, inst->cachesize);
 	printcontent(inst->buffer, (int)inst->cachesize);
 	return SUCCESS;
 }
@@ -797,7 +842,15 @@ STATUS instance_dispose(){
 		instance_master_done(TS_NEVER);
 		for(inst = instance_list; inst != 0; inst = inst->next){
 			// release pthread and event resources
-			;
+#ifndef WIN32
+			if(inst->cnxtype == CI_SHMEM && inst->filemap != 0){
+				munmap(inst->filemap, SHMEM_MSGOFFSET + inst->cachesize);
+				close(inst->fd);
+				inst->filemap = 0;
+				inst->buffer = 0;
+				inst->cache = 0;
+			}
+#endif
 		}
 		return SUCCESS;
 	} else { // slave
@@ -60,6 +60,22 @@ typedef struct s_message {
 	char data;					///< first character in link data
 } MESSAGE; ///< message cache structure
 
+/** Shared memory segment header (linux localhost)
+
+	The segment starts with this header, followed by the MESSAGE cache at SHMEM_MSGOFFSET.
+	Each side signals the other by incrementing the other's sequence counter, and
+	only calls futex wake when the other side is actually blocked.
+ **/
+typedef struct s_shmem_header {
+	volatile int32 master_seq;	///< incremented by the slave when the master may resume
+	volatile int32 master_wait;	///< non-zero while the master is blocked on master_seq
+	volatile int32 slave_seq;	///< incremented by the master when the slave may resume
+	volatile int32 slave_wait;	///< non-zero while the slave is blocked on slave_seq
+	int64 cachesize;			///< size of the MESSAGE cache that follows the header
+} SHMEMHEADER;
+#define SHMEM_MSGOFFSET 64 ///< offset of the MESSAGE cache in the shared memory segment (keeps the signals on their own cache line)
+#define SHMEM_SPINCOUNT 10000 ///< number of polls before a waiting side blocks on the futex
+
 typedef struct s_message_wrapper {
 	MESSAGE *msg;
 	int16 *name_size;
@@ -126,6 +142,7 @@ typedef struct s_instance {
 			int fd; ///<
 			int shmkey; ///<
 			int shmid; ///<
+			int32 shmseq; ///< last signal sequence observed
 		};
 #endif
 		struct {
@@ -172,6 +189,9 @@ STATUS linkage_init(instance *inst, linkage *lnk);
 STATUS linkage_master_to_slave(char *buffer, linkage *lnk);
 STATUS linkage_slave_to_master(char *buffer, linkage *lnk);
 
+int instance_shmem_signal(volatile int32 *seq, volatile int32 *waiting);
+int instance_shmem_wait(volatile int32 *seq, volatile int32 *waiting, int32 *last);
+
 void printcontent(unsigned char *data, size_t len);
 
 #endif
@@ -1,5 +1,18 @@
 #include "instance_cnx.h"
 
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <limits.h>
+#include <stddef.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+#endif
+
 //extern pthread_mutex_t inst_sock_lock;
 extern pthread_cond_t inst_sock_signal;
 extern int sock_created;
@@ -94,8 +107,166 @@ STATUS instance_cnx_mmap(instance *inst){
 #endif
 }
 
+/** instance_shmem_signal
+	Wake the other side of a shmem instance by incrementing its sequence
+	counter.  The futex is only woken if the other side has given up
+	spinning and is actually blocked on the counter.
+	@returns 1 on success, 0 on failure.
+ **/
+int instance_shmem_signal(volatile int32 *seq, volatile int32 *waiting){
+#ifdef WIN32
+	output_error("instance_shmem_signal(): shared memory (shmem) instance mode not supported under Windows, please use Memory Map (mmap) instead.");
+	return 0;
+#else
+	__sync_add_and_fetch(seq, 1);
+	if ( __sync_add_and_fetch(waiting, 0) != 0 )
+	{
+#ifdef __linux__
+		if ( syscall(SYS_futex, seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0) < 0 )
+		{
+			output_error("instance_shmem_signal(): futex wake failed (%s)", strerror(errno));
+			return 0;
+		}
+#endif
+	}
+	return 1;
+#endif
+}
+
+/** instance_shmem_wait
+	Wait until the sequence counter moves past the last value observed.  The
+	counter is polled SHMEM_SPINCOUNT times first, which is usually enough when
+	the other side is only busy for a short while, and then the waiter blocks
+	on the futex until signalled or global_signal_timeout expires.
+	@returns 1 on success, 0 on failure or timeout.
+ **/
+int instance_shmem_wait(volatile int32 *seq, volatile int32 *waiting, int32 *last){
+#ifdef WIN32
+	output_error("instance_shmem_wait(): shared memory (shmem) instance mode not supported under Windows, please use Memory Map (mmap) instead.");
+	return 0;
+#else
+	int spin;
+	int32 value;
+	int status = 1;
+
+	for ( spin=0 ; spin<SHMEM_SPINCOUNT ; spin++ )
+	{
+		if ( *seq != *last )
+		{
+			__sync_synchronize();
+			*last = *seq;
+			return 1;
+		}
+	}
+
+	/* announce that we are about to block before checking the counter again */
+	__sync_fetch_and_or(waiting, 1);
+	while ( (value=__sync_add_and_fetch(seq, 0)) == *last )
+	{
+#ifdef __linux__
+		struct timespec timeout = {global_signal_timeout/1000, (global_signal_timeout%1000)*1000000};
+		if ( syscall(SYS_futex, seq, FUTEX_WAIT, value, global_signal_timeout<0?NULL:&timeout, NULL, 0) < 0 )
+		{
+			if ( errno==EAGAIN || errno==EINTR )
+				continue;
+			if ( errno==ETIMEDOUT )
+				output_error("instance_shmem_wait(): wait timeout");
+			else
+				output_error("instance_shmem_wait(): futex wait failed (%s)", strerror(errno));
+			status = 0;
+			break;
+		}
+#else
+		usleep(100);
+#endif
+	}
+	__sync_fetch_and_and(waiting, 0);
+	__sync_synchronize();
+	*last = *seq;
+	return status;
+#endif
+}
+
+/** instance_cnx_shmem
+	Create the POSIX shared memory segment for a local slave.  The segment holds
+	a SHMEMHEADER followed by the instance's MESSAGE cache, and the master's cache
+	is moved into the segment so that both sides exchange linkage data in place.
+	@returns SUCCESS or FAILED.
+ **/
 STATUS instance_cnx_shmem(instance *inst){
+#ifdef WIN32
+	output_error("Shared Memory (shmem) instance mode not supported under Windows, please use Memory Map (mmap) instead.");
 	return FAILED;
+#else
+	char cachename[1024];
+	SHMEMHEADER *hdr;
+	size_t mapsize;
+	ptrdiff_t delta;
+	linkage *lnk;
+
+	if(inst == 0){
+		output_error("instance_cnx_shmem: no instance provided");
+		return FAILED;
+	}
+
+	/* setup cache */
+	sprintf(cachename,"/GLD-%"FMT_INT64"x",inst->cacheid);
+	inst->fd = shm_open(cachename, O_RDWR|O_CREAT|O_EXCL, 0600);
+	if ( inst->fd<0 )
+	{
+		output_error("unable to create cache '%s' for instance '%s' (%s)", cachename, inst->model, strerror(errno));
+		/* TROUBLESHOOT
+		   The shared memory segment could not be created. If the error indicates that the file exists,
+		   a previous run may have left a stale segment in /dev/shm, which can be removed safely.
+		   */
+		return FAILED;
+	}
+	mapsize = SHMEM_MSGOFFSET + inst->cachesize;
+	if ( ftruncate(inst->fd, (off_t)mapsize)!=0 )
+	{
+		output_error("unable to size cache '%s' for instance '%s' (%s)", cachename, inst->model, strerror(errno));
+		close(inst->fd);
+		shm_unlink(cachename);
+		return FAILED;
+	}
+	inst->filemap = (char*)mmap(NULL, mapsize, PROT_READ|PROT_WRITE, MAP_SHARED, inst->fd, 0);
+	if ( inst->filemap==(char*)MAP_FAILED )
+	{
+		output_error("unable to map cache '%s' for instance '%s' (%s)", cachename, inst->model, strerror(errno));
+		inst->filemap = NULL;
+		close(inst->fd);
+		shm_unlink(cachename);
+		return FAILED;
+	}
+	output_debug("cache '%s' created for instance '%s'", cachename, inst->model);
+
+	/* initialize the signal header */
+	hdr = (SHMEMHEADER*)inst->filemap;
+	memset(hdr, 0, SHMEM_MSGOFFSET);
+	hdr->cachesize = inst->cachesize;
+	inst->shmseq = 0;
+
+	/* move the existing message buffer into the segment and point the links at it */
+	inst->buffer = inst->filemap + SHMEM_MSGOFFSET;
+	output_debug("copying %d bytes from %x to %x", inst->cachesize, inst->cache, inst->buffer);
+	memcpy(inst->buffer, inst->cache, inst->cachesize);
+	delta = inst->buffer - (char*)inst->cache;
+	for ( lnk=inst->write ; lnk!=NULL ; lnk=lnk->next )
+		lnk->addr += delta;
+	for ( lnk=inst->read ; lnk!=NULL ; lnk=lnk->next )
+		lnk->addr += delta;
+	free(inst->cache);
+	free(inst->message);
+	inst->cache = (MESSAGE*)inst->buffer;
+	if ( messagewrapper_init(&(inst->message), inst->cache)==FAILED )
+	{
+		output_error("unable to initialize message wrapper for cache '%s'", cachename);
+		return FAILED;
+	}
+
+	output_verbose("slave %d assigned to '%s'", inst->id, inst->model);
+	return SUCCESS;
+#endif
 }
 
 STATUS instance_cnx_socket(instance *inst){
@@ -1,5 +1,13 @@
 #include "instance_slave.h"
 
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#endif
+
 // in practice, these are initialized by instance.c
 extern clock_t instance_synctime;
 
@@ -331,6 +339,23 @@ int instance_slave_wait_socket(){
 	return status;
 }
 
+int instance_slave_wait_shmem(){
+#ifndef WIN32
+	SHMEMHEADER *hdr = (SHMEMHEADER*)local_inst.filemap;
+	/* the cache is mapped in place, so nothing needs to be copied */
+	if ( !instance_shmem_wait(&hdr->slave_seq, &hdr->slave_wait, &local_inst.shmseq) )
+	{
+		output_error("instance_slave_wait_shmem(): slave %d wait failed", slave_id);
+		return 0;
+	}
+	output_verbose("instance_slave_wait_shmem(): slave %d wait completed", slave_id);
+	return 1;
+#else
+	output_error("instance_slave_wait_shmem(): should not have been called under Windows");
+	return 0;
+#endif
+}
+
 /** instance_slave_wait
 	Place slave in wait state until master signal it to resume
 	@return 1 on success, 0 on failure.
@@ -348,7 +373,7 @@ int instance_slave_wait(void)
 	} else if(local_inst.cnxtype == CI_SOCKET){
 		status = instance_slave_wait_socket();
 	} else if(local_inst.cnxtype == CI_SHMEM){
-		; // linux-specific
+		status = instance_slave_wait_shmem();
 	}
 	/* signal main loop to resume with new timestamp */
 	return status;
@@ -368,6 +393,15 @@ int instance_slave_done_mmap(){
 	return 0;
 }
 
+int instance_slave_done_shmem(){
+#ifndef WIN32
+	SHMEMHEADER *hdr = (SHMEMHEADER*)local_inst.filemap;
+	return instance_shmem_signal(&hdr->master_seq, &hdr->master_wait) ? 0 : -1;
+#else
+	return -1;
+#endif
+}
+
 int instance_slave_done_socket(){
 	size_t offset = 0;
 	int rv = 0;
@@ -424,6 +458,7 @@ void instance_slave_done(void)
 			rv = instance_slave_done_mmap();
 			break;
 		case CI_SHMEM:
+			rv = instance_slave_done_shmem();
 			break;
 		case CI_SOCKET:
 			rv = instance_slave_done_socket();
@@ -485,7 +520,7 @@ void *instance_slaveproc(void *ptr)
 		//output_debug("slave %d controller resuming exec with %lli", slave_id, local_inst.cache->ts);
 		output_debug("slave %d controller resuming exec with %lli", local_inst.cache->id, local_inst.cache->ts);
 		output_debug("slave %d controller setting step_to %lli to cache->ts %lli", local_inst.cache->id, exec_sync_get(NULL), local_inst.cache->ts);
-		exec_sync_merge(NULL,(void*)&local_inst.cache);
+		exec_sync_set(NULL,local_inst.cache->ts);
 
 		pthread_cond_broadcast(&mls_inst_signal);
 
@@ -513,8 +548,7 @@ void *instance_slaveproc(void *ptr)
 
 		/* copy the next time stamp */
 		/* how about we copy the time we want to step to and see what the master says, instead? -MH */
-		exec_sync_reset((void*)&local_inst.cache);
-		exec_sync_set((void*)&local_inst.cache,0);
+		local_inst.cache->ts = exec_sync_get(NULL);
 
 		instance_slave_done();
 	} while (global_clock != TS_NEVER && rv == SUCCESS);
@@ -609,7 +643,53 @@ STATUS instance_slave_init_mem(){
 	}
 	return SUCCESS;
 #else
-	// @todo linux/unix slave signalling
+	SHMEMHEADER *hdr;
+	char cacheName[256];
+	struct stat st;
+
+	output_debug("instance_slave_init_mem()");
+	local_inst.cacheid = global_master_port;
+	sprintf(cacheName,"/GLD-%"FMT_INT64"x",global_master_port);
+	local_inst.fd = shm_open(cacheName, O_RDWR, 0);
+	if ( local_inst.fd<0 )
+	{
+		output_error("unable to open cache '%s' for slave (%s)", cacheName, strerror(errno));
+		return FAILED;
+	}
+	if ( fstat(local_inst.fd, &st)!=0 || st.st_size<(off_t)(SHMEM_MSGOFFSET+sizeof(MESSAGE)) )
+	{
+		output_error("cache '%s' is not a valid shared memory segment", cacheName);
+		close(local_inst.fd);
+		return FAILED;
+	}
+	local_inst.filemap = (char*)mmap(NULL, (size_t)st.st_size, PROT_READ|PROT_WRITE, MAP_SHARED, local_inst.fd, 0);
+	if ( local_inst.filemap==(char*)MAP_FAILED )
+	{
+		output_error("unable to map cache '%s' for slave (%s)", cacheName, strerror(errno));
+		local_inst.filemap = NULL;
+		close(local_inst.fd);
+		return FAILED;
+	}
+	output_debug("cache '%s' opened for slave", cacheName);
+
+	// the cache is used in place, no copies are made
+	hdr = (SHMEMHEADER*)local_inst.filemap;
+	local_inst.cache = (MESSAGE*)(local_inst.filemap + SHMEM_MSGOFFSET);
+	local_inst.buffer = (char*)local_inst.cache;
+	local_inst.buffer_size = local_inst.cachesize = (size_t)hdr->cachesize;
+	local_inst.shmseq = hdr->slave_seq;
+	if(local_inst.cache->name_size < 0){
+		return FAILED;
+	}
+	if(local_inst.cache->data_size < 0){
+		return FAILED;
+	}
+	local_inst.id = slave_id = local_inst.cache->id;
+	messagewrapper_init(&(local_inst.message), local_inst.cache);
+
+	local_inst.name_size = *(local_inst.message->name_size);
+	local_inst.prop_size = *(local_inst.message->data_size);
+	return SUCCESS;
 #endif
 }
 
@@ -0,0 +1,557 @@
+/* instrument.c
+ * Copyright (C) 2008 Battelle Memorial Institute
+ * Wall-clock instrumentation of object passes, barriers, solvers and I/O.
+ *
+ * When the instrument global is set (--instrument), every object call made by the core
+ * is timed with the monotonic clock and counted in a latency histogram for its class and
+ * pass.  The core and modules also time named spans: each rank list of a sync pass, the
+ * time threads sit idle at the pass barriers, solver phases and output writes.  Spans are
+ * summarized by name, and when instrument_trace names a file every span is also kept as
+ * an event and written there as a Chrome trace (chrome://tracing, Perfetto).
+ *
+ * Each thread records into its own buffer, found through thread-local storage and
+ * allocated on the thread's first record, so recording never takes a lock.  The buffers
+ * are only merged by instrument_report when the simulation is done.  When a thread
+ * exits, its buffer is merged into the buffer kept for an earlier exited thread of the
+ * same name and freed, so threads started over and over (writers, solver helpers) do
+ * not each hold on to a buffer.
+ *
+ * Histograms have four buckets per power of two of nanoseconds, so percentiles are
+ * reported to within 25%.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <pthread.h>
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+#include "platform.h"
+#include "output.h"
+#include "globals.h"
+#include "object.h"
+#include "class.h"
+#include "lock.h"
+#include "instrument.h"
+
+#define INSTR_OCTAVES 36			/**< histogram range, 2^36 ns is about 69 s */
+#define INSTR_BUCKETS (4*INSTR_OCTAVES)
+#define INSTR_MAXSPANS 32			/**< distinct span names a thread may record */
+#define INSTR_MINEVENTS 4096		/**< first trace event buffer of a thread */
+#define INSTR_MAXEVENTS (1<<20)		/**< most trace events kept per thread */
+
+/** Latency distribution **/
+typedef struct s_instrstat {
+	int64 count;
+	int64 total;	///< ns
+	int64 max;		///< ns
+	int64 hist[INSTR_BUCKETS];
+} INSTRSTAT;
+
+/** Named span summary **/
+typedef struct s_instrspan {
+	const char *name;
+	int category;
+	INSTRSTAT stat;
+} INSTRSPAN;
+
+/** Trace event **/
+typedef struct s_instrevent {
+	const char *name;
+	int64 t0, dt;	///< ns
+	int arg;		///< rank list of a pass or barrier span, -1 for none
+	int category;
+} INSTREVENT;
+
+/** Per-thread buffer **/
+typedef struct s_instrthread {
+	unsigned int id;
+	char name[64];
+	unsigned int n_classes;
+	INSTRSTAT **object;		///< per class and pass, allocated on first use
+	unsigned int n_spans;
+	INSTRSPAN span[INSTR_MAXSPANS];
+	INSTREVENT *event;
+	unsigned int n_events, max_events;
+	int64 dropped;			///< records that did not fit
+	unsigned int exited;	///< number of exited threads of this name whose records the buffer holds
+	struct s_instrthread *next;
+} INSTRTHREAD;
+
+static INSTRTHREAD *first_thread = NULL;
+static unsigned int n_threads = 0;
+static unsigned int thread_lock = 0;
+static THREADLOCAL INSTRTHREAD *my_thread = NULL;
+static pthread_key_t thread_key;
+static pthread_once_t thread_key_once = PTHREAD_ONCE_INIT;
+
+static const char *category_name[] = {"core","pass","wait","solver","io"};
+static const char *pass_name[] = {"presync","sync","postsync","init","heartbeat","precommit","commit","finalize"};
+
+/** Monotonic wall clock in ns, or 0 when instrumentation is off **/
+int64 instrument_now(void)
+{
+	if ( !global_instrument )
+		return 0;
+#ifdef WIN32
+	{
+		static LARGE_INTEGER freq = {0};
+		LARGE_INTEGER t;
+		if ( freq.QuadPart==0 )
+			QueryPerformanceFrequency(&freq);
+		QueryPerformanceCounter(&t);
+		return (int64)((double)t.QuadPart*1e9/(double)freq.QuadPart);
+	}
+#else
+	{
+		struct timespec t;
+		clock_gettime(CLOCK_MONOTONIC,&t);
+		return (int64)t.tv_sec*1000000000LL + t.tv_nsec;
+	}
+#endif
+}
+
+static void instrument_retire(void *arg);
+static void instrument_make_key(void)
+{
+	pthread_key_create(&thread_key,instrument_retire);
+}
+
+static INSTRTHREAD *instrument_get_thread(void)
+{
+	INSTRTHREAD *thread = my_thread;
+	if ( thread==NULL )
+	{
+		thread = (INSTRTHREAD*)malloc(sizeof(INSTRTHREAD));
+		if ( thread==NULL )
+			return NULL;
+		memset(thread,0,sizeof(INSTRTHREAD));
+		thread->n_classes = class_get_count();
+		thread->object = (INSTRSTAT**)calloc(thread->n_classes*_OPI_NUMITEMS,sizeof(INSTRSTAT*));
+		wlock(&thread_lock);
+		thread->id = n_threads++;
+		thread->next = first_thread;
+		first_thread = thread;
+		wunlock(&thread_lock);
+		my_thread = thread;
+
+		/* the main thread never runs the destructor, its buffer is kept until the report */
+		pthread_once(&thread_key_once,instrument_make_key);
+		pthread_setspecific(thread_key,thread);
+	}
+	return thread;
+}
+
+static unsigned int instrument_bucket(int64 dt)
+{
+	unsigned long long v = (unsigned long long)(dt>0?dt:0);
+	unsigned int o, b;
+	if ( v<4 )
+		return (unsigned int)v;
+#ifdef __GNUC__
+	o = 63-__builtin_clzll(v);
+#else
+	for ( o=2 ; (v>>(o+1))!=0 ; o++ ) {}
+#endif
+	b = 4*(o-1) + (unsigned int)((v>>(o-2))&3);
+	return b<INSTR_BUCKETS ? b : INSTR_BUCKETS-1;
+}
+
+/** Smallest duration (ns) of bucket b **/
+static double instrument_bucket_floor(unsigned int b)
+{
+	if ( b<4 )
+		return b;
+	return (double)(4+b%4) * (double)(1ULL<<(b/4-1));
+}
+
+static void instrument_add(INSTRSTAT *stat, int64 dt)
+{
+	stat->count++;
+	stat->total += dt;
+	if ( dt>stat->max )
+		stat->max = dt;
+	stat->hist[instrument_bucket(dt)]++;
+}
+
+static void instrument_merge(INSTRSTAT *to, INSTRSTAT *from)
+{
+	unsigned int b;
+	to->count += from->count;
+	to->total += from->total;
+	if ( from->max>to->max )
+		to->max = from->max;
+	for ( b=0 ; b<INSTR_BUCKETS ; b++ )
+		to->hist[b] += from->hist[b];
+}
+
+/** Upper edge (us) of the bucket holding quantile q, but never more than the maximum **/
+static double instrument_quantile(INSTRSTAT *stat, double q)
+{
+	int64 target = (int64)(q*stat->count), seen = 0;
+	unsigned int b;
+	for ( b=0 ; b<INSTR_BUCKETS-1 ; b++ )
+	{
+		seen += stat->hist[b];
+		if ( seen>target )
+		{
+			double edge = instrument_bucket_floor(b+1);
+			return (edge<stat->max ? edge : stat->max)/1e3;
+		}
+	}
+	return stat->max/1e3;
+}
+
+/** Find the span of a thread by name, adding it if there is room **/
+static INSTRSPAN *instrument_find_span(INSTRTHREAD *thread, const char *name, int category)
+{
+	INSTRSPAN *span;
+	unsigned int n;
+
+	/* names are usually literals, so the pointer almost always matches */
+	for ( n=0 ; n<thread->n_spans ; n++ )
+	{
+		if ( thread->span[n].name==name || strcmp(thread->span[n].name,name)==0 )
+			return &thread->span[n];
+	}
+	if ( thread->n_spans==INSTR_MAXSPANS )
+		return NULL;
+	span = &thread->span[thread->n_spans++];
+	span->name = name;
+	span->category = category;
+	return span;
+}
+
+/** Get the next trace event of a thread, growing its buffer as needed **/
+static INSTREVENT *instrument_add_event(INSTRTHREAD *thread)
+{
+	if ( thread->n_events==thread->max_events )
+	{
+		unsigned int size = thread->max_events>0 ? thread->max_events*2 : INSTR_MINEVENTS;
+		INSTREVENT *grow = size<=INSTR_MAXEVENTS ? (INSTREVENT*)realloc(thread->event,size*sizeof(INSTREVENT)) : NULL;
+		if ( grow==NULL )
+			return NULL;
+		thread->event = grow;
+		thread->max_events = size;
+	}
+	return &thread->event[thread->n_events++];
+}
+
+/** Record a call of an object's pass that started at t0 **/
+void instrument_object(OBJECT *obj, int pass, int64 t0)
+{
+	INSTRTHREAD *thread;
+	INSTRSTAT **stat;
+	int64 dt;
+
+	if ( t0==0 || (thread=instrument_get_thread())==NULL )
+		return;
+	dt = instrument_now()-t0;
+	if ( thread->object==NULL || (unsigned int)obj->oclass->id>=thread->n_classes )
+	{
+		thread->dropped++;
+		return;
+	}
+	stat = &thread->object[obj->oclass->id*_OPI_NUMITEMS+pass];
+	if ( *stat==NULL && (*stat=(INSTRSTAT*)calloc(1,sizeof(INSTRSTAT)))==NULL )
+	{
+		thread->dropped++;
+		return;
+	}
+	instrument_add(*stat,dt);
+}
+
+/** Record a named span that started at t0, with an argument shown in the trace (-1 for none) **/
+void instrument_span_arg(const char *name, int category, int64 t0, int arg)
+{
+	INSTRTHREAD *thread;
+	INSTRSPAN *span;
+	int64 dt;
+
+	if ( t0==0 || (thread=instrument_get_thread())==NULL )
+		return;
+	dt = instrument_now()-t0;
+
+	if ( (span=instrument_find_span(thread,name,category))==NULL )
+	{
+		thread->dropped++;
+		return;
+	}
+	instrument_add(&span->stat,dt);
+
+	if ( global_instrument_trace[0]!='\0' )
+	{
+		INSTREVENT *event = instrument_add_event(thread);
+		if ( event==NULL )
+		{
+			thread->dropped++;
+			return;
+		}
+		event->name = name;
+		event->category = category;
+		event->t0 = t0;
+		event->dt = dt;
+		event->arg = arg;
+	}
+}
+
+void instrument_span(const char *name, int category, int64 t0)
+{
+	instrument_span_arg(name,category,t0,-1);
+}
+
+/** Name the calling thread in the report and the trace **/
+void instrument_thread(const char *format, ...)
+{
+	INSTRTHREAD *thread;
+	va_list ptr;
+	if ( !global_instrument || (thread=instrument_get_thread())==NULL )
+		return;
+	va_start(ptr,format);
+	vsnprintf(thread->name,sizeof(thread->name),format,ptr);
+	va_end(ptr);
+}
+
+/** Merge the buffer of an exiting thread into the buffer kept for an exited thread of
+    the same name, or keep it as that buffer if it is the first **/
+static void instrument_retire(void *arg)
+{
+	INSTRTHREAD *thread = (INSTRTHREAD*)arg, *into, **item;
+	unsigned int n;
+
+	my_thread = NULL;
+	wlock(&thread_lock);
+	for ( into=first_thread ; into!=NULL ; into=into->next )
+	{
+		if ( into->exited && strcmp(into->name,thread->name)==0 )
+			break;
+	}
+	if ( into==NULL )
+	{
+		thread->exited = 1;
+		wunlock(&thread_lock);
+		return;
+	}
+	for ( item=&first_thread ; *item!=thread ; item=&(*item)->next ) {}
+	*item = thread->next;
+
+	/* the kept buffer belongs to no running thread, so the lock is all it needs */
+	for ( n=0 ; n<thread->n_classes*_OPI_NUMITEMS ; n++ )
+	{
+		if ( thread->object[n]==NULL )
+			continue;
+		if ( n>=into->n_classes*_OPI_NUMITEMS )
+			into->dropped += thread->object[n]->count;
+		else if ( into->object[n]==NULL )
+		{
+			into->object[n] = thread->object[n];
+			thread->object[n] = NULL;
+		}
+		else
+			instrument_merge(into->object[n],thread->object[n]);
+		free(thread->object[n]);
+	}
+	for ( n=0 ; n<thread->n_spans ; n++ )
+	{
+		INSTRSPAN *span = instrument_find_span(into,thread->span[n].name,thread->span[n].category);
+		if ( span==NULL )
+			into->dropped += thread->span[n].stat.count;
+		else
+			instrument_merge(&span->stat,&thread->span[n].stat);
+	}
+	for ( n=0 ; n<thread->n_events ; n++ )
+	{
+		INSTREVENT *event = instrument_add_event(into);
+		if ( event==NULL )
+		{
+			into->dropped += thread->n_events-n;
+			break;
+		}
+		*event = thread->event[n];
+	}
+	into->dropped += thread->dropped;
+	into->exited++;
+	wunlock(&thread_lock);
+
+	free(thread->object);
+	free(thread->event);
+	free(thread);
+}
+
+static int instrument_write_trace(char *filename)
+{
+	INSTRTHREAD *thread;
+	int64 origin = 0;
+	unsigned int n;
+	int first = 1;
+	FILE *fp = fopen(filename,"w");
+	if ( fp==NULL )
+	{
+		output_error("unable to open instrument trace file '%s'", filename);
+		/* TROUBLESHOOT
+			The file named by the instrument_trace global could not be opened for writing.
+			Check that the directory exists and is writable.
+		 */
+		return 0;
+	}
+
+	for ( thread=first_thread ; thread!=NULL ; thread=thread->next )
+	{
+		for ( n=0 ; n<thread->n_events ; n++ )
+		{
+			if ( origin==0 || thread->event[n].t0<origin )
+				origin = thread->event[n].t0;
+		}
+	}
+
+	fprintf(fp,"{\"traceEvents\":[");
+	for ( thread=first_thread ; thread!=NULL ; thread=thread->next )
+	{
+		fprintf(fp,"%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+			first?"":",", thread->id, thread->name[0]!='\0'?thread->name:"thread");
+		first = 0;
+		for ( n=0 ; n<thread->n_events ; n++ )
+		{
+			INSTREVENT *event = &thread->event[n];
+			fprintf(fp,",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u",
+				event->name, category_name[event->category], (event->t0-origin)/1e3, event->dt/1e3, thread->id);
+			if ( event->arg>=0 )
+				fprintf(fp,",\"args\":{\"list\":%d}}", event->arg);
+			else
+				fprintf(fp,"}");
+		}
+	}
+	fprintf(fp,"\n],\"displayTimeUnit\":\"ms\"}\n");
+	fclose(fp);
+	return 1;
+}
+
+static void instrument_row(const char *name, const char *kind, INSTRSTAT *stat)
+{
+	output_profile("%-24.24s %-9.9s %9"FMT_INT64"d %9.3f %9.1f %9.1f %9.1f %9.1f %9.1f",
+		name, kind, stat->count, stat->total/1e9, stat->total/1e3/stat->count,
+		instrument_quantile(stat,0.5), instrument_quantile(stat,0.9), instrument_quantile(stat,0.99), stat->max/1e3);
+}
+
+static int instrument_compare(const void *a, const void *b)
+{
+	int64 ta = (*(INSTRSTAT**)a)->total, tb = (*(INSTRSTAT**)b)->total;
+	return ta<tb ? 1 : (ta>tb ? -1 : 0);
+}
+
+/** Print the instrumentation tables and write the trace file, if one is named **/
+void instrument_report(void)
+{
+	INSTRTHREAD *thread;
+	unsigned int n_classes = class_get_count(), n, m, n_rows = 0;
+	INSTRSTAT *object, **row;
+	INSTRSPAN span[INSTR_MAXSPANS];
+	unsigned int n_spans = 0;
+	int64 dropped = 0;
+
+	if ( !global_instrument || first_thread==NULL )
+		return;
+
+	/* merge the object histograms of all threads */
+	object = (INSTRSTAT*)calloc(n_classes*_OPI_NUMITEMS,sizeof(INSTRSTAT));
+	row = (INSTRSTAT**)malloc(n_classes*_OPI_NUMITEMS*sizeof(INSTRSTAT*));
+	if ( object==NULL || row==NULL )
+	{
+		output_error("instrument_report(): memory allocation failed");
+		free(object);
+		free(row);
+		return;
+	}
+	for ( thread=first_thread ; thread!=NULL ; thread=thread->next )
+	{
+		for ( n=0 ; n<thread->n_classes*_OPI_NUMITEMS ; n++ )
+		{
+			if ( thread->object[n]!=NULL )
+				instrument_merge(&object[n],thread->object[n]);
+		}
+		for ( n=0 ; n<thread->n_spans ; n++ )
+		{
+			for ( m=0 ; m<n_spans ; m++ )
+			{
+				if ( strcmp(span[m].name,thread->span[n].name)==0 )
+					break;
+			}
+			if ( m==n_spans )
+			{
+				if ( n_spans==INSTR_MAXSPANS )
+					continue;
+				memset(&span[m],0,sizeof(INSTRSPAN));
+				span[m].name = thread->span[n].name;
+				span[m].category = thread->span[n].category;
+				n_spans++;
+			}
+			instrument_merge(&span[m].stat,&thread->span[n].stat);
+		}
+		dropped += thread->dropped;
+	}
+
+	output_profile("\nInstrumentation results (times in microseconds unless noted)");
+	output_profile("===========================================================\n");
+	output_profile("Class                    Pass          Calls  Total(s)      Mean       p50       p90       p99       Max");
+	output_profile("------------------------ --------- --------- --------- --------- --------- --------- --------- ---------");
+	for ( n=0 ; n<n_classes*_OPI_NUMITEMS ; n++ )
+	{
+		if ( object[n].count>0 )
+			row[n_rows++] = &object[n];
+	}
+	qsort(row,n_rows,sizeof(INSTRSTAT*),instrument_compare);
+	for ( n=0 ; n<n_rows ; n++ )
+	{
+		unsigned int index = (unsigned int)(row[n]-object);
+		CLASS *oclass;
+		for ( oclass=class_get_first_class() ; oclass!=NULL && (unsigned int)oclass->id!=index/_OPI_NUMITEMS ; oclass=oclass->next ) {}
+		instrument_row(oclass?oclass->name:"(unknown)",pass_name[index%_OPI_NUMITEMS],row[n]);
+	}
+
+	output_profile("\nSpan                     Category      Count  Total(s)      Mean       p50       p90       p99       Max");
+	output_profile("------------------------ --------- --------- --------- --------- --------- --------- --------- ---------");
+	for ( n=0 ; n<_IC_NUMCATS ; n++ )
+	{
+		for ( m=0 ; m<n_spans ; m++ )
+		{
+			if ( span[m].category==(int)n )
+				instrument_row(span[m].name,category_name[n],&span[m].stat);
+		}
+	}
+
+	/* objects is the time spent in object calls, idle the time spent waiting at barriers */
+	output_profile("\nThread                          Objects(s)   Idle(s)    Events");
+	output_profile("-------------------------------- --------- --------- ---------");
+	for ( thread=first_thread ; thread!=NULL ; thread=thread->next )
+	{
+		int64 busy = 0, idle = 0;
+		char label[64], count[32] = "";
+		for ( n=0 ; n<thread->n_classes*_OPI_NUMITEMS ; n++ )
+		{
+			if ( thread->object[n]!=NULL )
+				busy += thread->object[n]->total;
+		}
+		for ( n=0 ; n<thread->n_spans ; n++ )
+		{
+			if ( thread->span[n].category==IC_WAIT )
+				idle += thread->span[n].stat.total;
+		}
+		if ( thread->exited>1 )
+			snprintf(count,sizeof(count)," (%u threads)",thread->exited);
+		snprintf(label,sizeof(label),"%u %s%s",thread->id,thread->name[0]!='\0'?thread->name:"thread",count);
+		output_profile("%-32.32s %9.3f %9.3f %9u", label, busy/1e9, idle/1e9, thread->n_events);
+	}
+	if ( dropped>0 )
+		output_profile("\n%"FMT_INT64"d records were dropped (trace buffer or span table full)", dropped);
+	output_profile("\n");
+
+	if ( global_instrument_trace[0]!='\0' && instrument_write_trace(global_instrument_trace) )
+		output_verbose("instrument trace written to '%s'", global_instrument_trace);
+
+	free(object);
+	free(row);
+}
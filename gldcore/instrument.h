@@ -0,0 +1,38 @@
+/* instrument.h
+ * Copyright (C) 2008 Battelle Memorial Institute
+ * Wall-clock instrumentation of object passes, barriers, solvers and I/O.
+ */
+
+#ifndef _INSTRUMENT_H
+#define _INSTRUMENT_H
+
+#include "platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Kinds of timed spans; the category decides which summary a span is reported in **/
+typedef enum {
+	IC_CORE,	///< core work between passes (precommit, commit, internals)
+	IC_PASS,	///< one rank list of a sync pass
+	IC_WAIT,	///< time a thread spent idle at a barrier
+	IC_SOLVER,	///< phase of a module solver
+	IC_IO,		///< output written by a module
+	_IC_NUMCATS,
+} INSTRUMENTCATEGORY;
+
+struct s_object_list;
+
+int64 instrument_now(void);	/* 0 when instrumentation is off */
+void instrument_object(struct s_object_list *obj, int pass, int64 t0);
+void instrument_span(const char *name, int category, int64 t0);
+void instrument_span_arg(const char *name, int category, int64 t0, int arg);
+void instrument_thread(const char *format, ...);
+void instrument_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
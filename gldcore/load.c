@@ -185,9 +185,11 @@ typedef struct stat STAT;
 #include "instance.h"
 #include "linkage.h"
 #include "gui.h"
+#include "loadcache.h"
 
 static unsigned int linenum=1;
 static int include_fail = 0;
+static OBJECT *transform_source_object = NULL; /* object of the last property transform source */
 static char filename[1024];
 static time_t modtime = 0;
 static int last_good_depth = -1;
@@ -1002,6 +1004,8 @@ static UNRESOLVED *first_unresolved = NULL;
 	item->next = first_unresolved;
 	item->flags = flags;
 	first_unresolved = item;
+	if ( ptype!=PT_object )
+		loadcache_uncacheable("%s is a forward reference", id);
 	return item;
 }
 static int resolve_object(UNRESOLVED *item, char *filename)
@@ -1499,6 +1503,7 @@ static int functional_int(PARSER, int64 *value){
 			output_message("%s(%d): %s is not a valid random distribution", filename,linenum,fname);
 			REJECT;
 		}
+		loadcache_uncacheable("%s(%d): random.%s draws a value", filename, linenum, fname);
 		if (nargs==-1)
 		{
 			if (WHITE,TERM(real_value(HERE,&a)))
@@ -1666,6 +1671,7 @@ static int functional(PARSER, double *pValue)
 			output_error_raw("%s(%d): %s is not a valid random distribution", filename,linenum,fname);
 			REJECT;
 		}
+		loadcache_uncacheable("%s(%d): random.%s draws a value", filename, linenum, fname);
 		if (nargs==-1)
 		{
 			if (WHITE,TERM(real_value(HERE,&a)))
@@ -2358,6 +2364,7 @@ static int clock_properties(PARSER)
 		{
 			//global_clock = tsval;
 			global_starttime = tsval; // used to affect start time, before with 
+			loadcache_globals_changed();
 			ACCEPT;
 			goto Next;
 		}
@@ -2369,6 +2376,7 @@ static int clock_properties(PARSER)
 		if (TERM(time_value(HERE,&tsval)))
 		{
 			global_starttime = tsval;
+			loadcache_globals_changed();
 			ACCEPT;
 			goto Next;
 		}
@@ -2380,6 +2388,7 @@ static int clock_properties(PARSER)
 		if (TERM(time_value(HERE,&tsval)))
 		{
 			global_stoptime = tsval;
+			loadcache_globals_changed();
 			ACCEPT;
 			goto Next;
 		}
@@ -2390,6 +2399,7 @@ static int clock_properties(PARSER)
 	{
 		if (TERM(value(HERE,timezone,sizeof(timezone))) && (WHITE,LITERAL(";")) && strlen(timezone)>0)
 		{
+			loadcache_timezone(timezone);
 			if (timestamp_set_tz(timezone)==NULL)
 				output_warning("%s(%d): timezone %s is not defined",filename,linenum,timezone);
 				/* TROUBLESHOOT
@@ -2488,9 +2498,15 @@ static int expanded_value(char *text, char *result, int size, char *delims)
 				else if (strcmp(varname,"hostaddr")==0)
 					strcpy(value,global_hostaddr); 
 				else if (strcmp(varname,"cpu")==0)
+				{
 					sprintf(value,"%d",sched_get_cpuid(0)); 
+					loadcache_uncacheable("%s(%d): ${cpu} is expanded", filename, linenum);
+				}
 				else if (strcmp(varname,"pid")==0)
+				{
 					sprintf(value,"%d",sched_get_procid()); 
+					loadcache_uncacheable("%s(%d): ${pid} is expanded", filename, linenum);
+				}
 				else if (strcmp(varname,"port")==0)
 					sprintf(value,"%d",global_server_portnum);
 				else if (strcmp(varname,"mastername")==0)
@@ -2769,6 +2785,7 @@ static int module_properties(PARSER, MODULE *mod)
 			{
 				if (module_setvar(mod,propname,propvalue)>0)
 				{
+					loadcache_globals_changed();
 					ACCEPT;
 					goto Next;
 				}
@@ -2813,6 +2830,7 @@ static int module_block(PARSER)
 	if (TERM(name(HERE,fmod,sizeof(fmod))) && LITERAL("::") && TERM(name(HERE,mod,sizeof(mod))))
 	{
 		sprintf(module_name,"%s::%s",fmod,mod);
+		loadcache_uncacheable("%s(%d): foreign module %s is loaded", filename, linenum, module_name);
 		if ((module=module_load(module_name,0,NULL))!=NULL)
 		{
 			ACCEPT;
@@ -2828,8 +2846,10 @@ static int module_block(PARSER)
 	/* native C/C++ module */
 	if (TERM(name(HERE,module_name,sizeof(module_name))))
 	{
+		loadcache_module(module_name);
 		if ((module=module_load(module_name,0,NULL))!=NULL)
 		{
+			loadcache_module_loaded();
 			ACCEPT;
 		}
 		else
@@ -3709,6 +3729,7 @@ static int property_ref(PARSER, TRANSFORMSOURCE *xstype, void **ref, OBJECT *fro
 	if (TERM(name(HERE,oname,sizeof(oname))) && LITERAL(".") && TERM(dotted_name(HERE,pname,sizeof(pname))))
 	{
 		OBJECT *obj = (strcmp(oname,"this")==0 ? from : object_find_name(oname));
+		transform_source_object = obj;
 
 		// object isn't defined yet
 		if (obj==NULL)
@@ -3775,6 +3796,7 @@ static int transform_source(PARSER, TRANSFORMSOURCE *xstype, void **source, OBJE
 	{
 		*source = (void*)&(sch->value);
 		*xstype = XS_SCHEDULE;
+		transform_source_object = NULL;
 		ACCEPT;
 	}
 	else if (TERM(property_ref(HERE,xstype,source,from)))
@@ -3939,6 +3961,7 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 			{
 				if ( method->call(obj,propval)==1 )
 				{
+					loadcache_loadmethod(obj,propname,propval);
 					ACCEPT;
 				}
 				else
@@ -3983,7 +4006,10 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 					REJECT;
 				}
 				else
+				{
+					loadcache_set_complex(obj,propname,cval);
 					ACCEPT;
+				}
 			}
 			else if (prop!=NULL && prop->ptype==PT_double && TERM(expression(HERE, &dval, &unit, obj)))
 			{
@@ -3998,7 +4024,10 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 					REJECT;
 				}
 				else
+				{
+					loadcache_set_double(obj,propname,dval);
 					ACCEPT;
+				}
 			}
 			else if (prop!=NULL && prop->ptype==PT_double && TERM(functional_unit(HERE,&dval,&unit)))
 			{
@@ -4013,7 +4042,10 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 					REJECT;
 				}
 				else
+				{
+					loadcache_set_double(obj,propname,dval);
 					ACCEPT;
+				}
 			}
 			else if(prop != NULL && is_int(prop->ptype) && TERM(functional_unit(HERE, &dval, &unit))){
 				int64 ival = 0;
@@ -4047,6 +4079,7 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 						output_error_raw("%s(%d): property %s of %s %s could not be set to '%g'", filename, linenum, propname, format_object(obj), ival);
 						REJECT;
 					} else {
+						loadcache_set_integer(obj,propname,prop->ptype,prop->ptype==PT_int16?ival16:ival);
 						ACCEPT;
 					}
 #if 0
@@ -4079,6 +4112,8 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 
 						/* source was the unresolved entry, for now it will be the transform itself */
 						first_unresolved->ref = (void*)transform_getnext(NULL);
+					else
+						loadcache_transform(obj,prop,xstype,transform_source_object,source,scale,bias);
 
 					ACCEPT;
 				}
@@ -4110,6 +4145,7 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 				}
 
 				/* add to external transform list */
+				loadcache_uncacheable("%s(%d): external transforms are used", filename, linenum);
 				if ( !transform_add_external(obj,prop,transformname,source_obj,source_prop) )
 				{
 					output_error_raw("%s(%d): external transform could not be created - %s", filename, linenum, errno?strerror(errno):"(no details)");
@@ -4154,6 +4190,7 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 				}
 
 				/* add to external transform list */
+				loadcache_uncacheable("%s(%d): filter transforms are used", filename, linenum);
 				if ( !transform_add_filter(obj,prop,transformname,source_obj,source_prop) )
 				{
 					output_error_raw("%s(%d): filter transform could not be created - %s", filename, linenum, errno?strerror(errno):"(no details)");
@@ -4241,7 +4278,10 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 							REJECT;
 						}
 						else
+						{
+							loadcache_name(obj,propval);
 							ACCEPT;
+						}
 					}
 					else if ( strcmp(propname,"heartbeat")==0 )
 					{
@@ -4295,7 +4335,10 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 					REJECT;
 				}
 				else
+				{
+					loadcache_set_text(obj,propname,propval);
 					ACCEPT; // @todo shouldn't this be REJECT?
+				}
 			}
 		}
 		if WHITE ACCEPT;
@@ -4396,6 +4439,7 @@ static int object_block(PARSER, OBJECT *parent, OBJECT **subobj)
 	if WHITE ACCEPT;
 	if (LITERAL("namespace") && (WHITE,TERM(name(HERE,space,sizeof(space)))) && (WHITE,LITERAL("{")))
 	{
+		loadcache_uncacheable("%s(%d): namespace %s is used", filename, linenum, space);
 		if (!object_open_namespace(space))
 		{
 			output_error_raw("%s(%d): namespace %s could not be opened", filename, linenum, space);
@@ -4513,6 +4557,7 @@ static int object_block(PARSER, OBJECT *parent, OBJECT **subobj)
 			}
 			object_set_parent(obj,parent);
 		}
+		loadcache_create(obj,classname,parent);
 		if (id!=-1 && load_set_index(obj,(OBJECTNUM)id)==FAILED)
 		{
 			output_error_raw("%s(%d): unable to index object id number for %s:%d", filename, linenum, classname, id);
@@ -4738,6 +4783,7 @@ static int schedule(PARSER)
 		}
 		if (schedule_create(schedname, buffer))
 		{
+			loadcache_schedule(schedname,buffer);
 			ACCEPT;
 		}
 		else
@@ -5533,6 +5579,9 @@ static int global_declaration(PARSER)
 					REJECT;
 				}
 				var->prop->unit = pUnit;
+				if ( pUnit!=NULL )
+					loadcache_uncacheable("%s(%d): global '%s' has units", filename, linenum, varname);
+				loadcache_globals_changed();
 				if ( class_string_to_property(var->prop, var->prop->addr,pvalue)==0 )
 				{
 					output_error_raw("%s(%d): global '%s %s' cannot be set to '%s'", filename, linenum, proptype, varname, pvalue);
@@ -5693,20 +5742,20 @@ static int gridlabd_file(PARSER)
 	OR if LITERAL(";") {ACCEPT; DONE;}
 	OR if TERM(line_spec(HERE)) { ACCEPT; DONE; }
 	OR if TERM(object_block(HERE,NULL,NULL)) {ACCEPT; DONE;}
-	OR if TERM(class_block(HERE)) {ACCEPT; DONE;}
+	OR if TERM(class_block(HERE)) { loadcache_uncacheable("%s(%d): classes are defined", filename, linenum); ACCEPT; DONE; }
 	OR if TERM(module_block(HERE)) {ACCEPT; DONE;}
 	OR if TERM(clock_block(HERE)) {ACCEPT; DONE;}
-	OR if TERM(import(HERE)) {ACCEPT; DONE; }
-	OR if TERM(export(HERE)) {ACCEPT; DONE; }
-	OR if TERM(library(HERE)) {ACCEPT; DONE; }
+	OR if TERM(import(HERE)) { loadcache_uncacheable("%s(%d): files are imported", filename, linenum); ACCEPT; DONE; }
+	OR if TERM(export(HERE)) { loadcache_uncacheable("%s(%d): files are exported", filename, linenum); ACCEPT; DONE; }
+	OR if TERM(library(HERE)) { loadcache_uncacheable("%s(%d): libraries are used", filename, linenum); ACCEPT; DONE; }
 	OR if TERM(schedule(HERE)) {ACCEPT; DONE; }
-	OR if TERM(instance_block(HERE)) {ACCEPT; DONE; }
-	OR if TERM(gui(HERE)) {ACCEPT; DONE;}
-	OR if TERM(extern_block(HERE)) {ACCEPT; DONE; }
-	OR if TERM(filter_block(HERE)) {ACCEPT; DONE; }
+	OR if TERM(instance_block(HERE)) { loadcache_uncacheable("%s(%d): instances are defined", filename, linenum); ACCEPT; DONE; }
+	OR if TERM(gui(HERE)) { loadcache_uncacheable("%s(%d): a gui is defined", filename, linenum); ACCEPT; DONE; }
+	OR if TERM(extern_block(HERE)) { loadcache_uncacheable("%s(%d): external code is used", filename, linenum); ACCEPT; DONE; }
+	OR if TERM(filter_block(HERE)) { loadcache_uncacheable("%s(%d): filters are defined", filename, linenum); ACCEPT; DONE; }
 	OR if TERM(global_declaration(HERE)) {ACCEPT; DONE; }
-	OR if TERM(link_declaration(HERE)) { ACCEPT; DONE; }
-	OR if TERM(script_directive(HERE)) { ACCEPT; DONE; }
+	OR if TERM(link_declaration(HERE)) { loadcache_uncacheable("%s(%d): links are declared", filename, linenum); ACCEPT; DONE; }
+	OR if TERM(script_directive(HERE)) { loadcache_uncacheable("%s(%d): scripts are used", filename, linenum); ACCEPT; DONE; }
 	OR if (*(HERE)=='\0') {ACCEPT; DONE;}
 	else REJECT;
 	DONE;
@@ -5727,6 +5776,10 @@ int replace_variables(char *to,char *from,int len,int warn)
 			strncpy(to+n,e,m);
 			n += m;
 			var =  global_getvar(varname,to+n,len-n);
+			if (var==NULL)
+				loadcache_depend_env(varname);
+			else if ( strcmp(varname,"GUID")==0 || strcmp(varname,"NOW")==0 || strcmp(varname,"RUN")==0 )
+				loadcache_uncacheable("%s(%d): ${%s} is expanded", filename, linenum, varname);
 			if (var!=NULL)
 				n+=(int)strlen(var);
 			else if (env!=NULL)
@@ -6018,6 +6071,11 @@ static int include_file(char *incname, char *buffer, int size, int _linenum)
 
 	/* open file */
 	fp = find_file(incname,NULL,R_OK,ff,sizeof(ff)) ? fopen(ff, "rt") : NULL;
+	if ( fp!=NULL )
+	{
+		loadcache_depend_env("GLPATH");
+		loadcache_depend_file(ff);
+	}
 	
 	if(fp == NULL){
 		output_error_raw("%s(%d): include file open failed: %s", incname, _linenum, errno?strerror(errno):"(no details)");
@@ -6224,6 +6282,8 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 		}
 		//if (sscanf(term+1,"%[^\n\r]",value)==1 && global_getvar(value, buffer, 63)==NULL && getenv(value)==NULL)
 		strcpy(value, strip_right_white(term+1));
+		if ( !is_autodef(value) && global_getvar(value, buffer, 63)==NULL )
+			loadcache_depend_env(value);
 		if ( !is_autodef(value) && global_getvar(value, buffer, 63)==NULL && getenv(value)==NULL){
 			suppress |= (1<<nesting);
 		}
@@ -6253,6 +6313,7 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 			sscanf(value, "\"%[^\"\n]", stripbuf);
 			strcpy(value, stripbuf);
 		}
+		loadcache_depend_exist(value,find_file(value, NULL, F_OK, path,sizeof(path))!=NULL);
 		if (find_file(value, NULL, F_OK, path,sizeof(path))==NULL)
 			suppress |= (1<<nesting);
 		macro_line[nesting] = linenum;
@@ -6272,6 +6333,8 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 		}
 		//if (sscanf(term+1,"%[^\n\r]",value)==1 && global_getvar(value, buffer, 63)!=NULL || getenv(value)!=NULL))
 		strcpy(value, strip_right_white(term+1));
+		if ( global_getvar(value, buffer, 63)==NULL )
+			loadcache_depend_env(value);
 		if(global_getvar(value, buffer, 63)!=NULL || getenv(value)!=NULL){
 			suppress |= (1<<nesting);
 		}
@@ -6364,6 +6427,7 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 		} else if(sscanf(term, "<%[^>]>", value) == 1){
 			/* C include file */
 			output_verbose("added C include for \"%s\"", value);
+			loadcache_uncacheable("%s(%d): C include <%s> is used", filename, linenum, value);
 			append_code("#include <%s>\n",value);
 			strcpy(line,"\n");
 			return TRUE;
@@ -6376,6 +6440,7 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 			FILE *fp;
 			HTTPRESULT *http = http_read(value,0x40000);
 			char tmpname[1024];
+			loadcache_uncacheable("%s(%d): [%s] is included", filename, linenum, value);
 			if ( http==NULL )
 			{
 				output_error("%s(%d): unable to include [%s]", filename, linenum, value);
@@ -6440,6 +6505,7 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 		}
 		//if (sscanf(term+1,"%[^\n\r]",value)==1)
 		strcpy(value, strip_right_white(term+1));
+		loadcache_uncacheable("%s(%d): %ssetenv is used", filename, linenum, MACRO);
 		if(1){
 #ifdef WIN32
 			putenv(value);
@@ -6483,6 +6549,7 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 				global_strictnames = TRUE;
 				result = global_setvar(value);
 				global_strictnames = strncmp(value,"strictnames=",12)==0 ? global_strictnames : oldstrict;
+				loadcache_globals_changed();
 				if (result==FAILED)
 					output_error_raw("%s(%d): %sset term not found",filename,linenum,MACRO);
 				strcpy(line,"\n");
@@ -6531,6 +6598,7 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 			global_strictnames = FALSE;
 			result = global_setvar(value,"\"\""); // extra "" is used in case value is term is empty string
 			global_strictnames = oldstrict;
+			loadcache_globals_changed();
 			if (result==FAILED)
 				output_error_raw("%s(%d): %sdefine term not found",filename,linenum,MACRO);
 			strcpy(line,"\n");
@@ -6557,6 +6625,7 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 		strcpy(value, strip_right_white(term+1));
 		if(1){
 			output_message("%s(%d): %s", filename, linenum, value);
+			loadcache_message(0,"%s(%d): %s", filename, linenum, value);
 			strcpy(line,"\n");
 			return TRUE;
 		}
@@ -6606,6 +6675,7 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 		strcpy(value, strip_right_white(term+1));
 		if(1){
 			output_warning("%s(%d): %s", filename, linenum, value);
+			loadcache_message(1,"%s(%d): %s", filename, linenum, value);
 			strcpy(line,"\n");
 			return TRUE;
 		}
@@ -6628,6 +6698,7 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 		}
 		strcpy(value, strip_right_white(term+1));
 		output_debug("%s(%d): executing system(char *cmd='%s')", filename, linenum, value);
+		loadcache_uncacheable("%s(%d): %ssystem is used", filename, linenum, MACRO);
 		global_return_code = system(value);
 		if( global_return_code==127 || global_return_code==-1 )
 		{
@@ -6653,6 +6724,7 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 		}
 		strcpy(value, strip_right_white(term+1));
 		output_debug("%s(%d): executing system(char *cmd='%s')", filename, linenum, value);
+		loadcache_uncacheable("%s(%d): %sstart is used", filename, linenum, MACRO);
 		if( start_process(value)==NULL )
 		{
 			output_error_raw("%s(%d): ERROR unable to start '%s'", filename, linenum, value);
@@ -6677,6 +6749,7 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 		}
 		strcpy(value, strip_right_white(term+1));
 		strcpy(line,"\n");
+		loadcache_uncacheable("%s(%d): %soption is used", filename, linenum, MACRO);
 		return cmdarg_runoption(value)>=0;
 	}
 	else if ( strncmp(line,MACRO "wget",5)==0 )
@@ -6685,6 +6758,7 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 		size_t n = sscanf(line+5,"%s %[^\n\r]",url,file);
 		HTTPRESULT *http;
 		strcpy(line,"\n");
+		loadcache_uncacheable("%s(%d): %swget is used", filename, linenum, MACRO);
 		if ( n<1 )
 		{
 			output_error_raw("%s(%d): %swget missing url", filename, linenum, MACRO);
@@ -7019,7 +7093,23 @@ STATUS loadall(char *file){
 			load_status = SUCCESS;
 	}
 	else if (ext==NULL || strcmp(ext, ".glm")==0)
-		load_status = loadall_glm_roll(filename);
+	{
+		/* replay the model cache when it has the file */
+		int cached = loadcache_read(filename);
+		if ( cached>0 )
+		{
+			OBJECT *obj;
+			for ( obj=object_get_first() ; obj!=NULL ; obj=obj->next )
+				object_set_parent(obj,obj->parent);
+			load_status = SUCCESS;
+		}
+		else if ( cached==0 )
+		{
+			loadcache_record(filename);
+			load_status = loadall_glm_roll(filename);
+			loadcache_write(load_status);
+		}
+	}
 #ifdef HAVE_XERCES
 	else if(strcmp(ext, ".xml")==0)
 		load_status = loadall_xml(filename);
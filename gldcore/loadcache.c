@@ -0,0 +1,1049 @@
+/* loadcache.c
+ * Copyright (C) 2008 Battelle Memorial Institute
+ * Binary model cache of the GLM loader.
+ *
+ * When the model_cache global names a directory, the loader records what a GLM file
+ * does to the model while it parses it: the modules it loads, the globals it changes,
+ * the schedules it defines, the objects it creates and every property value it sets,
+ * already expanded, evaluated and converted to the property's units.  When the load
+ * succeeds, the record is written to the cache directory, followed by the final header
+ * of every object and its resolved object references, under a key that hashes the
+ * file and the global variables the load started from.  The next load of the same
+ * file with the same globals replays the record instead of parsing the file, provided
+ * none of the files, environment variables and file tests the first load depended on
+ * have changed since.
+ *
+ * The objects are still created by their modules and the properties are still set
+ * through the object API, in the order the loader did, so modules see the same calls
+ * as during a parse.  Loads that do anything that cannot be replayed this way (e.g.,
+ * runtime classes, scripts, shell commands, random values drawn by the parser) are
+ * simply not cached; the reason is reported as a verbose message.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include "platform.h"
+#include "output.h"
+#include "globals.h"
+#include "object.h"
+#include "class.h"
+#include "module.h"
+#include "schedule.h"
+#include "transform.h"
+#include "timestamp.h"
+#include "find.h"
+#include "loadcache.h"
+
+#ifdef WIN32
+#include <process.h>
+#include <io.h>
+#define getpid _getpid
+#define unlink _unlink
+#else
+#include <unistd.h>
+#endif
+
+/* cache file name - this should never be changed */
+#define CACHE_MAGIC "GLDCACHE"
+
+/* cache file version - change this when the structure of the cache changes */
+#define CACHE_VERSION 1
+
+/* record operations */
+typedef enum {
+	LC_END = 0,
+	LC_MODULE,		/* name */
+	LC_GLOBAL,		/* name, type, size, data */
+	LC_TIMEZONE,	/* tz */
+	LC_MESSAGE,		/* error flag, text */
+	LC_SCHEDULE,	/* name, definition */
+	LC_CREATE,		/* class, parent id */
+	LC_NAME,		/* id, name */
+	LC_DOUBLE,		/* id, property, value */
+	LC_COMPLEX,		/* id, property, value */
+	LC_INTEGER,		/* id, property, type, value */
+	LC_TEXT,		/* id, property, value */
+	LC_LOADMETHOD,	/* id, method, value */
+	LC_TRANSFORM,	/* id, property, source type, source schedule or source id and offset, scale, bias */
+	LC_HEADER,		/* id, final object header */
+	LC_OBJECTREF,	/* id, property, referenced id */
+} LOADCACHEOP;
+
+/* dependencies */
+typedef enum {
+	LD_FILE = 'F',	/* file contents */
+	LD_ENV = 'E',	/* environment variable */
+	LD_EXIST = 'X',	/* file found on the path */
+} LOADCACHEDEP;
+
+typedef struct s_loadcachedep {
+	LOADCACHEDEP type;
+	char name[1024];
+	int present;
+	unsigned int64 hash;
+	struct s_loadcachedep *next;
+} LOADCACHEDEPEND;
+
+typedef struct {
+	char magic[8];
+	unsigned int version;
+	unsigned int64 key;
+	int64 base;			/* number of objects before the load */
+	int64 deps;			/* file offset of the dependency list */
+} LOADCACHEHEADER;
+
+/* global variable copies */
+typedef struct {
+	GLOBALVAR *var;
+	size_t size;		/* 0 if the variable is not recorded */
+	char *data;
+} GLOBALCOPY;
+
+static int recording = 0;
+static int dirty = 0;
+static FILE *fp = NULL;
+static char cachename[1024];
+static char tmpname[1024];
+static char reason[1024];
+static LOADCACHEHEADER header;
+static LOADCACHEDEPEND *dependencies = NULL;
+static GLOBALCOPY *globals = NULL;
+static unsigned int n_globals = 0;
+static unsigned int max_globals = 0;
+static int64 n_created = 0;
+
+/****************************************************************
+ * Keys
+ ****************************************************************/
+
+#define HASH_INIT 0xcbf29ce484222325ULL
+
+/* 64-bit FNV-1a */
+static unsigned int64 hash_bytes(unsigned int64 hash, const void *data, size_t len)
+{
+	const unsigned char *p = (const unsigned char*)data;
+	while ( len-->0 )
+	{
+		hash ^= *p++;
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+/* hash the contents of a file, returns 0 if the file cannot be read */
+static int hash_file(char *path, unsigned int64 *hash)
+{
+	char buffer[65536];
+	size_t len;
+	FILE *in = fopen(path,"rb");
+	if ( in==NULL )
+		return 0;
+	*hash = HASH_INIT;
+	while ( (len=fread(buffer,1,sizeof(buffer),in))>0 )
+		*hash = hash_bytes(*hash,buffer,len);
+	fclose(in);
+	return 1;
+}
+
+/* only plain values are compared, copied and replayed */
+static int is_plain(PROPERTYTYPE ptype)
+{
+	switch ( ptype ) {
+	case PT_double:
+	case PT_complex:
+	case PT_enumeration:
+	case PT_set:
+	case PT_int16:
+	case PT_int32:
+	case PT_int64:
+	case PT_char8:
+	case PT_char32:
+	case PT_char256:
+	case PT_char1024:
+	case PT_bool:
+	case PT_timestamp:
+	case PT_float:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/* size of the value of a global that is recorded, 0 if it is not */
+static size_t global_size(GLOBALVAR *var)
+{
+	PROPERTY *prop = var->prop;
+	if ( prop==NULL || prop->access!=PA_PUBLIC || !is_plain(prop->ptype) )
+		return 0;
+	return property_size(prop) * (prop->size>1 ? prop->size : 1);
+}
+
+/* globals that only affect how a run reports, not the model it loads */
+static int is_volatile(char *name)
+{
+	static char *names[] = {"command_line","quiet","warn","debugger","gdb","debug","verbose","workdir","dumpfile","savefile",
+		"pauseatexit","show_progress","gdb_window","profiler","mainloop_state","return_code","exit_code","model_cache",NULL};
+	char **p;
+	for ( p=names ; *p!=NULL ; p++ )
+	{
+		if ( strcmp(name,*p)==0 )
+			return 1;
+	}
+	return 0;
+}
+
+/* key of a file loaded from the current globals */
+static unsigned int64 cache_key(char *file, unsigned int64 content)
+{
+	unsigned int64 key = HASH_INIT;
+	GLOBALVAR *var;
+	key = hash_bytes(key,file,strlen(file));
+	key = hash_bytes(key,&content,sizeof(content));
+	for ( var=global_getnext(NULL) ; var!=NULL ; var=global_getnext(var) )
+	{
+		size_t size = global_size(var);
+		if ( size==0 || is_volatile(var->prop->name) )
+			continue;
+		key = hash_bytes(key,var->prop->name,strlen(var->prop->name));
+		key = hash_bytes(key,var->prop->addr,size);
+	}
+	return key;
+}
+
+/* name of the cache file of a loaded file */
+static int cache_filename(char *file, unsigned int64 key, char *path, int size)
+{
+	char *base = strrchr(file,'/');
+#ifdef WIN32
+	char *wbase = strrchr(file,'\\');
+	if ( wbase!=NULL && (base==NULL || wbase>base) ) base = wbase;
+#endif
+	base = base ? base+1 : file;
+	return snprintf(path,size,"%s/%s.%016llx.glc",global_model_cache,base,(unsigned long long)key) < size;
+}
+
+/****************************************************************
+ * Global variable changes
+ ****************************************************************/
+
+/* update the copies of the globals, recording the changes when asked to */
+static void globals_sync(int record);
+
+/****************************************************************
+ * Writing
+ ****************************************************************/
+
+static void put(void *data, size_t len)
+{
+	if ( fp!=NULL && fwrite(data,1,len,fp)!=len )
+		loadcache_uncacheable("unable to write cache file '%s' (%s)", tmpname, strerror(errno));
+}
+static void put_op(LOADCACHEOP op) { unsigned char c = (unsigned char)op; put(&c,1); }
+static void put_int(int64 value) { put(&value,sizeof(value)); }
+static void put_double(double value) { put(&value,sizeof(value)); }
+static void put_string(char *str)
+{
+	unsigned int len = (unsigned int)strlen(str);
+	put(&len,sizeof(len));
+	put(str,len);
+}
+
+static void globals_sync(int record)
+{
+	GLOBALVAR *var;
+	unsigned int n;
+	for ( n=0, var=global_getnext(NULL) ; var!=NULL ; n++, var=global_getnext(var) )
+	{
+		GLOBALCOPY *copy;
+		if ( n>=n_globals || globals[n].var!=var )
+		{
+			/* a variable that was created since the last sync */
+			if ( n>=max_globals )
+			{
+				unsigned int size = max_globals ? max_globals*2 : 256;
+				GLOBALCOPY *list = (GLOBALCOPY*)realloc(globals,size*sizeof(GLOBALCOPY));
+				if ( list==NULL )
+				{
+					loadcache_uncacheable("unable to allocate global variable copies");
+					return;
+				}
+				globals = list;
+				max_globals = size;
+			}
+			copy = &globals[n];
+			copy->var = var;
+			copy->size = global_size(var);
+			copy->data = copy->size>0 ? (char*)malloc(copy->size) : NULL;
+			if ( copy->size>0 && copy->data==NULL )
+			{
+				loadcache_uncacheable("unable to allocate global variable copies");
+				return;
+			}
+			if ( n>=n_globals )
+				n_globals = n+1;
+			if ( copy->size==0 )
+				continue;
+			memcpy(copy->data,var->prop->addr,copy->size);
+			if ( record )
+			{
+				put_op(LC_GLOBAL);
+				put_string(var->prop->name);
+				put_int(var->prop->ptype);
+				put_int(copy->size);
+				put(copy->data,copy->size);
+			}
+		}
+		else
+		{
+			copy = &globals[n];
+			if ( copy->size==0 || memcmp(copy->data,var->prop->addr,copy->size)==0 )
+				continue;
+			memcpy(copy->data,var->prop->addr,copy->size);
+			if ( record )
+			{
+				put_op(LC_GLOBAL);
+				put_string(var->prop->name);
+				put_int(var->prop->ptype);
+				put_int(copy->size);
+				put(copy->data,copy->size);
+			}
+		}
+	}
+	dirty = 0;
+}
+
+static void globals_free(void)
+{
+	unsigned int n;
+	for ( n=0 ; n<n_globals ; n++ )
+		free(globals[n].data);
+	free(globals);
+	globals = NULL;
+	n_globals = max_globals = 0;
+}
+
+static void dependencies_free(void)
+{
+	while ( dependencies!=NULL )
+	{
+		LOADCACHEDEPEND *next = dependencies->next;
+		free(dependencies);
+		dependencies = next;
+	}
+}
+
+/* record any global changes that happened since the last record */
+static int begin_op(void)
+{
+	if ( !recording )
+		return 0;
+	if ( dirty )
+		globals_sync(1);
+	return recording;
+}
+
+/** Mark the current load as one that cannot be cached **/
+void loadcache_uncacheable(char *format, ...)
+{
+	va_list ptr;
+	if ( !recording )
+		return;
+	va_start(ptr,format);
+	vsnprintf(reason,sizeof(reason),format,ptr);
+	va_end(ptr);
+	recording = 0;
+}
+
+static void add_dependency(LOADCACHEDEP type, char *name, int present, unsigned int64 hash)
+{
+	LOADCACHEDEPEND *dep;
+	for ( dep=dependencies ; dep!=NULL ; dep=dep->next )
+	{
+		if ( dep->type==type && strcmp(dep->name,name)==0 )
+			return;
+	}
+	dep = (LOADCACHEDEPEND*)malloc(sizeof(LOADCACHEDEPEND));
+	if ( dep==NULL || strlen(name)>=sizeof(dep->name) )
+	{
+		free(dep);
+		loadcache_uncacheable("unable to record dependency on '%s'", name);
+		return;
+	}
+	dep->type = type;
+	strcpy(dep->name,name);
+	dep->present = present;
+	dep->hash = hash;
+	dep->next = dependencies;
+	dependencies = dep;
+}
+
+/** The load read the file \p path **/
+void loadcache_depend_file(char *path)
+{
+	unsigned int64 hash;
+	if ( !recording )
+		return;
+	if ( !hash_file(path,&hash) )
+		loadcache_uncacheable("unable to hash '%s'", path);
+	else
+		add_dependency(LD_FILE,path,1,hash);
+}
+
+/** The load looked up the environment variable \p name **/
+void loadcache_depend_env(char *name)
+{
+	char *value;
+	if ( !recording )
+		return;
+	value = getenv(name);
+	add_dependency(LD_ENV,name,value!=NULL,value ? hash_bytes(HASH_INIT,value,strlen(value)) : 0);
+}
+
+/** The load tested whether the file \p path exists **/
+void loadcache_depend_exist(char *path, int exists)
+{
+	if ( !recording )
+		return;
+	add_dependency(LD_EXIST,path,exists,0);
+}
+
+/** The load changed global variables **/
+void loadcache_globals_changed(void)
+{
+	dirty = 1;
+}
+
+/** Start recording the load of \p file **/
+void loadcache_record(char *file)
+{
+	unsigned int64 content;
+	recording = 0;
+	strcpy(reason,"");
+	if ( global_model_cache[0]=='\0' )
+		return;
+	if ( !hash_file(file,&content) )
+		return;
+
+	memset(&header,0,sizeof(header));
+	memcpy(header.magic,CACHE_MAGIC,sizeof(header.magic));
+	header.version = CACHE_VERSION;
+	header.key = cache_key(file,content);
+	header.base = object_get_count();
+	if ( !cache_filename(file,header.key,cachename,sizeof(cachename))
+		|| snprintf(tmpname,sizeof(tmpname),"%s.%d",cachename,getpid())>=(int)sizeof(tmpname) )
+		return;
+	fp = fopen(tmpname,"wb");
+	if ( fp==NULL )
+	{
+		output_warning("unable to create model cache file '%s' (%s)", tmpname, strerror(errno));
+		/* TROUBLESHOOT
+			The loader could not create a file in the directory given by the model_cache global, so
+			the model will not be cached.  Check that the directory exists and is writable.
+		 */
+		return;
+	}
+	put(&header,sizeof(header));
+	recording = 1;
+	dirty = 0;
+	n_created = 0;
+	globals_sync(0);
+	add_dependency(LD_FILE,file,1,content);
+	output_verbose("recording load of '%s' in model cache '%s'", file, cachename);
+}
+
+/** Finish recording the load, writing the cache if the load succeeded and can be replayed **/
+void loadcache_write(STATUS status)
+{
+	OBJECTNUM n, count = object_get_count();
+	if ( fp==NULL )
+		return;
+
+	if ( recording && status==SUCCESS )
+	{
+		globals_sync(1);
+		if ( header.base+n_created!=count )
+			loadcache_uncacheable("%d objects were not created by the loader", (int)(count-header.base-n_created));
+
+		/* final object headers and references, as they are after the references are resolved */
+		for ( n=(OBJECTNUM)header.base ; recording && n<count ; n++ )
+		{
+			OBJECT *obj = object_find_by_id(n);
+			CLASS *oclass;
+			PROPERTY *prop;
+			if ( obj==NULL || (obj->flags&OF_FOREIGN) )
+			{
+				loadcache_uncacheable("object %d was not created by the loader", n);
+				break;
+			}
+			if ( obj->space!=NULL )
+			{
+				loadcache_uncacheable("object %d is in a namespace", n);
+				break;
+			}
+			put_op(LC_HEADER);
+			put_int(obj->id);
+			put_int(obj->parent ? (int64)obj->parent->id : -1);
+			put(&obj->rank,sizeof(obj->rank));
+			put(&obj->clock,sizeof(obj->clock));
+			put(&obj->valid_to,sizeof(obj->valid_to));
+			put(&obj->schedule_skew,sizeof(obj->schedule_skew));
+			put(&obj->latitude,sizeof(obj->latitude));
+			put(&obj->longitude,sizeof(obj->longitude));
+			put(&obj->in_svc,sizeof(obj->in_svc));
+			put(&obj->out_svc,sizeof(obj->out_svc));
+			put(&obj->in_svc_micro,sizeof(obj->in_svc_micro));
+			put(&obj->out_svc_micro,sizeof(obj->out_svc_micro));
+			put(&obj->in_svc_double,sizeof(obj->in_svc_double));
+			put(&obj->out_svc_double,sizeof(obj->out_svc_double));
+			put(&obj->heartbeat,sizeof(obj->heartbeat));
+			put(obj->groupid,sizeof(obj->groupid));
+			put(&obj->flags,sizeof(obj->flags));
+
+			for ( oclass=obj->oclass ; recording && oclass!=NULL ; oclass=oclass->parent )
+			{
+				for ( prop=oclass->pmap ; prop!=NULL && prop->oclass==oclass ; prop=prop->next )
+				{
+					OBJECT *ref;
+					if ( prop->ptype!=PT_object )
+						continue;
+					ref = *(OBJECT**)((char*)(obj+1)+(int64)prop->addr);
+					if ( ref!=NULL && (ref->id>=count || object_find_by_id(ref->id)!=ref) )
+					{
+						loadcache_uncacheable("property %s of object %d does not refer to an object", prop->name, n);
+						break;
+					}
+					put_op(LC_OBJECTREF);
+					put_int(obj->id);
+					put_string(prop->name);
+					put_int(ref ? (int64)ref->id : -1);
+				}
+			}
+		}
+		put_op(LC_END);
+	}
+
+	if ( recording && status==SUCCESS )
+	{
+		LOADCACHEDEPEND *dep;
+		int64 count = 0;
+		header.deps = (int64)ftell(fp);
+		for ( dep=dependencies ; dep!=NULL ; dep=dep->next )
+			count++;
+		put_int(count);
+		for ( dep=dependencies ; dep!=NULL ; dep=dep->next )
+		{
+			put_int(dep->type);
+			put_string(dep->name);
+			put_int(dep->present);
+			put(&dep->hash,sizeof(dep->hash));
+		}
+		if ( recording && fseek(fp,0,SEEK_SET)==0 )
+			put(&header,sizeof(header));
+	}
+
+	fclose(fp);
+	fp = NULL;
+	if ( recording && status==SUCCESS && rename(tmpname,cachename)==0 )
+		output_verbose("model cache '%s' written", cachename);
+	else
+	{
+		unlink(tmpname);
+		if ( status==SUCCESS )
+			output_verbose("model not cached: %s", reason[0] ? reason : strerror(errno));
+	}
+	recording = 0;
+	dependencies_free();
+	globals_free();
+}
+
+/** The load is loading module \p name **/
+void loadcache_module(char *name)
+{
+	if ( !begin_op() ) return;
+	put_op(LC_MODULE);
+	put_string(name);
+}
+
+/** The module is loaded, which registers its globals **/
+void loadcache_module_loaded(void)
+{
+	if ( recording )
+		globals_sync(0);
+}
+
+/** The load set the timezone **/
+void loadcache_timezone(char *tz)
+{
+	if ( !begin_op() ) return;
+	put_op(LC_TIMEZONE);
+	put_string(tz);
+}
+
+/** The load output a message or a warning **/
+void loadcache_message(int warning, char *format, ...)
+{
+	char text[2048];
+	va_list ptr;
+	if ( !begin_op() ) return;
+	va_start(ptr,format);
+	vsnprintf(text,sizeof(text),format,ptr);
+	va_end(ptr);
+	put_op(LC_MESSAGE);
+	put_int(warning);
+	put_string(text);
+}
+
+/** The load defined a schedule **/
+void loadcache_schedule(char *name, char *definition)
+{
+	if ( !begin_op() ) return;
+	put_op(LC_SCHEDULE);
+	put_string(name);
+	put_string(definition);
+}
+
+/** The load created an object of class \p classname **/
+void loadcache_create(OBJECT *obj, char *classname, OBJECT *parent)
+{
+	if ( !begin_op() ) return;
+	if ( obj->id!=header.base+n_created )
+	{
+		loadcache_uncacheable("object %d was not created by the loader", (int)(header.base+n_created));
+		return;
+	}
+	n_created++;
+	put_op(LC_CREATE);
+	put_int(obj->id);
+	put_string(classname);
+	put_int(parent ? (int64)parent->id : -1);
+}
+
+/** The load named an object **/
+void loadcache_name(OBJECT *obj, char *name)
+{
+	if ( !begin_op() ) return;
+	put_op(LC_NAME);
+	put_int(obj->id);
+	put_string(name);
+}
+
+/** The load set a double property **/
+void loadcache_set_double(OBJECT *obj, char *name, double value)
+{
+	if ( !begin_op() ) return;
+	put_op(LC_DOUBLE);
+	put_int(obj->id);
+	put_string(name);
+	put_double(value);
+}
+
+/** The load set a complex property, the notation is kept with the value **/
+void loadcache_set_complex(OBJECT *obj, char *name, complex value)
+{
+	if ( !begin_op() ) return;
+	put_op(LC_COMPLEX);
+	put_int(obj->id);
+	put_string(name);
+	put(&value,sizeof(value));
+}
+
+/** The load set an integer property **/
+void loadcache_set_integer(OBJECT *obj, char *name, PROPERTYTYPE ptype, int64 value)
+{
+	if ( !begin_op() ) return;
+	put_op(LC_INTEGER);
+	put_int(obj->id);
+	put_string(name);
+	put_int(ptype);
+	put_int(value);
+}
+
+/** The load set a property from text **/
+void loadcache_set_text(OBJECT *obj, char *name, char *value)
+{
+	if ( !begin_op() ) return;
+	put_op(LC_TEXT);
+	put_int(obj->id);
+	put_string(name);
+	put_string(value);
+}
+
+/** The load called a load method **/
+void loadcache_loadmethod(OBJECT *obj, char *name, char *value)
+{
+	if ( !begin_op() ) return;
+	put_op(LC_LOADMETHOD);
+	put_int(obj->id);
+	put_string(name);
+	put_string(value);
+}
+
+/** The load added a linear transform, whose source is a schedule or a value in \p source_obj **/
+void loadcache_transform(OBJECT *obj, PROPERTY *prop, int xstype, OBJECT *source_obj, void *source, double scale, double bias)
+{
+	if ( !begin_op() ) return;
+	if ( xstype!=XS_SCHEDULE && source_obj==NULL )
+	{
+		loadcache_uncacheable("transform source of %s is not resolved", prop->name);
+		return;
+	}
+	put_op(LC_TRANSFORM);
+	put_int(obj->id);
+	put_string(prop->name);
+	put_int(xstype);
+	if ( xstype==XS_SCHEDULE )
+		put_string(((SCHEDULE*)source)->name); /* the value is the first member of the schedule */
+	else
+	{
+		put_int(source_obj->id);
+		put_int((char*)source-(char*)source_obj);
+	}
+	put_double(scale);
+	put_double(bias);
+}
+
+/****************************************************************
+ * Replay
+ ****************************************************************/
+
+static FILE *in = NULL;
+static char *text = NULL;
+static size_t text_size = 0;
+
+static int get(void *data, size_t len) { return fread(data,1,len,in)==len; }
+static int get_int(int64 *value) { return get(value,sizeof(*value)); }
+static int get_double(double *value) { return get(value,sizeof(*value)); }
+
+/* read a string into \p buffer, or into the shared text buffer if \p buffer is NULL */
+static char *get_string(char *buffer, size_t size)
+{
+	unsigned int len;
+	if ( !get(&len,sizeof(len)) )
+		return NULL;
+	if ( buffer==NULL )
+	{
+		if ( len+1>text_size )
+		{
+			char *p = (char*)realloc(text,len+1);
+			if ( p==NULL )
+				return NULL;
+			text = p;
+			text_size = len+1;
+		}
+		buffer = text;
+	}
+	else if ( len+1>size )
+		return NULL;
+	if ( !get(buffer,len) )
+		return NULL;
+	buffer[len] = '\0';
+	return buffer;
+}
+
+/* check that none of the dependencies changed */
+static int dependencies_valid(char *file)
+{
+	char name[1024], path[1024];
+	int64 count, type, stored_present;
+	unsigned int64 stored_hash;
+	if ( fseek(in,(long)header.deps,SEEK_SET)!=0 || !get_int(&count) )
+		return 0;
+	while ( count-->0 )
+	{
+		unsigned int64 hash = 0;
+		int present = 0;
+		char *value;
+		if ( !get_int(&type) || get_string(name,sizeof(name))==NULL || !get_int(&stored_present) || !get(&stored_hash,sizeof(stored_hash)) )
+			return 0;
+		switch ( type ) {
+		case LD_FILE:
+			present = hash_file(name,&hash);
+			break;
+		case LD_ENV:
+			value = getenv(name);
+			present = value!=NULL;
+			hash = value ? hash_bytes(HASH_INIT,value,strlen(value)) : 0;
+			break;
+		case LD_EXIST:
+			present = find_file(name,NULL,F_OK,path,sizeof(path))!=NULL;
+			break;
+		default:
+			return 0;
+		}
+		if ( present!=stored_present || hash!=stored_hash )
+		{
+			output_verbose("model cache of '%s' is stale, '%s' changed", file, name);
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/* object \p id of the replayed load */
+static OBJECT **objects = NULL;
+static int64 n_objects = 0;
+static OBJECT *get_object(int64 id)
+{
+	if ( id<0 )
+		return NULL;
+	if ( id>=header.base && id<header.base+n_objects )
+		return objects[id-header.base];
+	return id<header.base ? object_find_by_id((OBJECTNUM)id) : NULL;
+}
+
+/* replay the record, returns the failing operation or LC_END when done */
+static int replay(char *file)
+{
+	unsigned char op;
+	char name[1024];
+	int64 id, value, size;
+	OBJECT *obj;
+	PROPERTY *prop;
+
+	while ( get(&op,1) )
+	{
+		switch ( op ) {
+		case LC_END:
+			return LC_END;
+		case LC_MODULE:
+			if ( get_string(name,sizeof(name))==NULL || module_load(name,0,NULL)==NULL )
+				return op;
+			break;
+		case LC_GLOBAL:
+		{
+			GLOBALVAR *var;
+			if ( get_string(name,sizeof(name))==NULL || !get_int(&value) || !get_int(&size) )
+				return op;
+			var = global_find(name);
+			if ( var==NULL )
+				var = global_create(name,(PROPERTYTYPE)value,NULL,PT_SIZE,1,PT_ACCESS,PA_PUBLIC,NULL);
+			if ( var==NULL || var->prop->ptype!=(PROPERTYTYPE)value || global_size(var)!=(size_t)size || !get(var->prop->addr,(size_t)size) )
+				return op;
+			if ( var->callback )
+				var->callback(var->prop->name);
+			break;
+		}
+		case LC_TIMEZONE:
+			if ( get_string(name,sizeof(name))==NULL )
+				return op;
+			timestamp_set_tz(name);
+			break;
+		case LC_MESSAGE:
+			if ( !get_int(&value) || get_string(NULL,0)==NULL )
+				return op;
+			if ( value )
+				output_warning("%s", text);
+			else
+				output_message("%s", text);
+			break;
+		case LC_SCHEDULE:
+			if ( get_string(name,sizeof(name))==NULL || get_string(NULL,0)==NULL || schedule_create(name,text)==NULL )
+				return op;
+			break;
+		case LC_CREATE:
+		{
+			CLASS *oclass;
+			OBJECT *parent;
+			if ( !get_int(&id) || get_string(name,sizeof(name))==NULL || !get_int(&value) )
+				return op;
+			oclass = class_get_class_from_classname(name);
+			parent = get_object(value);
+			if ( oclass==NULL || (value>=0 && parent==NULL) )
+				return op;
+			obj = NULL;
+			if ( oclass->create!=NULL )
+			{
+				/* same as the loader, which passes a name object to create */
+				static OBJECT nameobj;
+				nameobj.name = name;
+				obj = &nameobj;
+				if ( (*oclass->create)(&obj,parent)==0 || obj==&nameobj )
+					return op;
+			}
+			else if ( (obj=object_create_single(oclass))!=NULL )
+				object_set_parent(obj,parent);
+			if ( obj==NULL || obj->id!=id || id!=header.base+n_objects )
+				return op;
+			if ( (n_objects&(n_objects-1))==0 )
+			{
+				OBJECT **list = (OBJECT**)realloc(objects,(n_objects?n_objects*2:1)*sizeof(OBJECT*));
+				if ( list==NULL )
+					return op;
+				objects = list;
+			}
+			objects[n_objects++] = obj;
+			break;
+		}
+		case LC_NAME:
+			if ( !get_int(&id) || (obj=get_object(id))==NULL || get_string(name,sizeof(name))==NULL || object_set_name(obj,name)==NULL )
+				return op;
+			break;
+		case LC_DOUBLE:
+		{
+			double x;
+			if ( !get_int(&id) || (obj=get_object(id))==NULL || get_string(name,sizeof(name))==NULL || !get_double(&x)
+				|| object_set_double_by_name(obj,name,x)==0 )
+				return op;
+			break;
+		}
+		case LC_COMPLEX:
+		{
+			complex z;
+			if ( !get_int(&id) || (obj=get_object(id))==NULL || get_string(name,sizeof(name))==NULL || !get(&z,sizeof(z))
+				|| object_set_complex_by_name(obj,name,z)==0 )
+				return op;
+			break;
+		}
+		case LC_INTEGER:
+		{
+			int64 ptype;
+			int ok = 0;
+			if ( !get_int(&id) || (obj=get_object(id))==NULL || get_string(name,sizeof(name))==NULL || !get_int(&ptype) || !get_int(&value) )
+				return op;
+			switch ( ptype ) {
+			case PT_int16: ok = object_set_int16_by_name(obj,name,(int16)value); break;
+			case PT_int32: ok = object_set_int32_by_name(obj,name,(int32)value); break;
+			case PT_int64: ok = object_set_int64_by_name(obj,name,value); break;
+			default: break;
+			}
+			if ( !ok )
+				return op;
+			break;
+		}
+		case LC_TEXT:
+			if ( !get_int(&id) || (obj=get_object(id))==NULL || get_string(name,sizeof(name))==NULL || get_string(NULL,0)==NULL
+				|| object_set_value_by_name(obj,name,text)==0 )
+				return op;
+			break;
+		case LC_LOADMETHOD:
+		{
+			LOADMETHOD *method;
+			if ( !get_int(&id) || (obj=get_object(id))==NULL || get_string(name,sizeof(name))==NULL || get_string(NULL,0)==NULL
+				|| (method=class_get_loadmethod(obj->oclass,name))==NULL || method->call(obj,text)!=1 )
+				return op;
+			break;
+		}
+		case LC_TRANSFORM:
+		{
+			int64 xstype, offset;
+			double scale, bias;
+			void *source;
+			SCHEDULE *sched = NULL;
+			if ( !get_int(&id) || (obj=get_object(id))==NULL || get_string(name,sizeof(name))==NULL || !get_int(&xstype)
+				|| (prop=class_find_property(obj->oclass,name))==NULL )
+				return op;
+			if ( xstype==XS_SCHEDULE )
+			{
+				if ( get_string(NULL,0)==NULL || (sched=schedule_find_byname(text))==NULL )
+					return op;
+				source = (void*)&(sched->value);
+			}
+			else
+			{
+				OBJECT *source_obj;
+				if ( !get_int(&value) || (source_obj=get_object(value))==NULL || !get_int(&offset) )
+					return op;
+				source = (void*)((char*)source_obj+offset);
+			}
+			if ( !get_double(&scale) || !get_double(&bias)
+				|| !transform_add_linear((TRANSFORMSOURCE)xstype,(double*)source,(void*)((char*)(obj+1)+(int64)prop->addr),scale,bias,obj,prop,sched) )
+				return op;
+			break;
+		}
+		case LC_HEADER:
+		{
+			int64 parent;
+			if ( !get_int(&id) || (obj=get_object(id))==NULL || !get_int(&parent) || (parent>=0 && get_object(parent)==NULL) )
+				return op;
+			obj->parent = get_object(parent);
+			if ( !get(&obj->rank,sizeof(obj->rank))
+				|| !get(&obj->clock,sizeof(obj->clock))
+				|| !get(&obj->valid_to,sizeof(obj->valid_to))
+				|| !get(&obj->schedule_skew,sizeof(obj->schedule_skew))
+				|| !get(&obj->latitude,sizeof(obj->latitude))
+				|| !get(&obj->longitude,sizeof(obj->longitude))
+				|| !get(&obj->in_svc,sizeof(obj->in_svc))
+				|| !get(&obj->out_svc,sizeof(obj->out_svc))
+				|| !get(&obj->in_svc_micro,sizeof(obj->in_svc_micro))
+				|| !get(&obj->out_svc_micro,sizeof(obj->out_svc_micro))
+				|| !get(&obj->in_svc_double,sizeof(obj->in_svc_double))
+				|| !get(&obj->out_svc_double,sizeof(obj->out_svc_double))
+				|| !get(&obj->heartbeat,sizeof(obj->heartbeat))
+				|| !get(obj->groupid,sizeof(obj->groupid))
+				|| !get(&obj->flags,sizeof(obj->flags)) )
+				return op;
+			break;
+		}
+		case LC_OBJECTREF:
+			if ( !get_int(&id) || (obj=get_object(id))==NULL || get_string(name,sizeof(name))==NULL || !get_int(&value)
+				|| (prop=class_find_property(obj->oclass,name))==NULL || prop->ptype!=PT_object || (value>=0 && get_object(value)==NULL) )
+				return op;
+			*(OBJECT**)((char*)(obj+1)+(int64)prop->addr) = get_object(value);
+			break;
+		default:
+			return op;
+		}
+	}
+	return -1;
+}
+
+/** Load \p file from the model cache
+	@return 1 if the file was loaded from the cache, 0 if it is not cached (nothing was done), -1 if the replay failed
+ **/
+int loadcache_read(char *file)
+{
+	unsigned int64 content;
+	char path[1024];
+	LOADCACHEHEADER stored;
+	int result;
+
+	if ( global_model_cache[0]=='\0' || !hash_file(file,&content) )
+		return 0;
+	memset(&header,0,sizeof(header));
+	header.key = cache_key(file,content);
+	if ( !cache_filename(file,header.key,path,sizeof(path)) )
+		return 0;
+	in = fopen(path,"rb");
+	if ( in==NULL )
+		return 0;
+	if ( !get(&stored,sizeof(stored)) || memcmp(stored.magic,CACHE_MAGIC,sizeof(stored.magic))!=0
+		|| stored.version!=CACHE_VERSION || stored.key!=header.key || stored.base!=(int64)object_get_count() )
+	{
+		fclose(in);
+		in = NULL;
+		return 0;
+	}
+	header = stored;
+	if ( !dependencies_valid(file) || fseek(in,(long)sizeof(header),SEEK_SET)!=0 )
+	{
+		fclose(in);
+		in = NULL;
+		return 0;
+	}
+
+	output_verbose("loading '%s' from model cache '%s'", file, path);
+	n_objects = 0;
+	result = replay(file);
+	fclose(in);
+	in = NULL;
+	free(objects);
+	objects = NULL;
+	free(text);
+	text = NULL;
+	text_size = 0;
+	if ( result!=LC_END )
+	{
+		output_error("unable to load '%s' from model cache '%s' (operation %d at object %d)", file, path, result, (int)(header.base+n_objects));
+		/* TROUBLESHOOT
+			The model cache entry for the file could not be replayed, most likely because a module
+			changed since the entry was written or the entry is damaged.  Delete the entry from the
+			directory given by the model_cache global and load the model again.
+		 */
+		return -1;
+	}
+	output_verbose("%d objects loaded from model cache", (int)n_objects);
+	return 1;
+}
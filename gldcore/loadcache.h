@@ -0,0 +1,43 @@
+/* loadcache.h
+ * Copyright (C) 2008 Battelle Memorial Institute
+ * Binary model cache of the GLM loader.
+ */
+
+#ifndef _LOADCACHE_H
+#define _LOADCACHE_H
+
+#include "object.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int loadcache_read(char *file);
+void loadcache_record(char *file);
+void loadcache_write(STATUS status);
+
+void loadcache_uncacheable(char *format, ...);
+void loadcache_depend_file(char *path);
+void loadcache_depend_env(char *name);
+void loadcache_depend_exist(char *path, int exists);
+void loadcache_globals_changed(void);
+
+void loadcache_module(char *name);
+void loadcache_module_loaded(void);
+void loadcache_timezone(char *tz);
+void loadcache_message(int warning, char *format, ...);
+void loadcache_schedule(char *name, char *definition);
+void loadcache_create(OBJECT *obj, char *classname, OBJECT *parent);
+void loadcache_name(OBJECT *obj, char *name);
+void loadcache_set_double(OBJECT *obj, char *name, double value);
+void loadcache_set_complex(OBJECT *obj, char *name, complex value);
+void loadcache_set_integer(OBJECT *obj, char *name, PROPERTYTYPE ptype, int64 value);
+void loadcache_set_text(OBJECT *obj, char *name, char *value);
+void loadcache_loadmethod(OBJECT *obj, char *name, char *value);
+void loadcache_transform(OBJECT *obj, PROPERTY *prop, int xstype, OBJECT *source_obj, void *source, double scale, double bias);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
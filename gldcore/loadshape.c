@@ -41,6 +41,7 @@
 #include "random.h"
 #include "schedule.h"
 #include "exec.h"
+#include "threadpool.h"
 
 static loadshape *loadshape_list = NULL;
 static unsigned int n_shapes = 0;
@@ -543,6 +544,8 @@ void loadshape_recalc(loadshape *ls)
 
 int loadshape_init(loadshape *ls) /**< load shape */
 {
+	static unsigned int n_init = 0; /* owner ids of the shape states */
+
 	/* unknown shape -> placeholder loadshape, needs no actions at all */
 	if(ls->type == MT_UNKNOWN){
 		ls->t2 = TS_NEVER;
@@ -733,8 +736,8 @@ int loadshape_init(loadshape *ls) /**< load shape */
 		break;
 	}
 	
-	/* initialize the random number generator state */
-	ls->rng_state = randwarn(NULL);
+	/* initialize the random number generator state (stream 2 keeps shapes apart from objects and randomvars) */
+	random_state_init(&(ls->rng_state),n_init++,2);
 
 	/* establish the initial parameters */
 	loadshape_recalc(ls);
@@ -865,199 +868,79 @@ TIMESTAMP loadshape_sync(loadshape *ls, TIMESTAMP t1)
 	return ls->t2>0?ls->t2:TS_NEVER;
 }
 
-typedef struct s_loadshapesyncdata {
-	unsigned int n;
-	pthread_t pt;
-	bool ok;
-	loadshape *ls;
-	unsigned int ns;
-	TIMESTAMP t0;
-	unsigned int ran;
-} LOADSHAPESYNCDATA;
-
-static pthread_cond_t start_ls = PTHREAD_COND_INITIALIZER;
-static pthread_mutex_t startlock_ls = PTHREAD_MUTEX_INITIALIZER;
-static pthread_cond_t done_ls = PTHREAD_COND_INITIALIZER;
-static pthread_mutex_t donelock_ls = PTHREAD_MUTEX_INITIALIZER;
-static TIMESTAMP next_t1_ls, next_t2_ls;
-static unsigned int run = 0;
-static unsigned int donecount_ls;
+static loadshape **loadshape_item = NULL; /* shapes indexed for the sync task */
+static TPTASK loadshape_task;
+static TIMESTAMP next_t2_ls;
 
 clock_t loadshape_synctime = 0;
 
-void *loadshape_syncproc(void *ptr)
+static TIMESTAMP loadshape_synccall(TPTASK *task, unsigned int first, unsigned int last, unsigned int thread)
 {
-	LOADSHAPESYNCDATA *data = (LOADSHAPESYNCDATA*)ptr;
-	loadshape *s;
+	loadshape **ls = (loadshape**)task->data;
+	TIMESTAMP t2 = TS_NEVER;
 	unsigned int n;
-	TIMESTAMP t2;
-
-	// begin processing loop
-	while ( data->ok )
+	for ( n=first ; n<last ; n++ )
 	{
-		// lock access to start condition
-		pthread_mutex_lock(&startlock_ls);
-
-		// wait for thread start condition
-		while ( data->t0==next_t1_ls && data->ran==run ) 
-			pthread_cond_wait(&start_ls,&startlock_ls);
-		
-		// unlock access to start count
-		pthread_mutex_unlock(&startlock_ls);
-
-		// process the list for this thread
-		t2 = TS_NEVER;
-		for ( s=data->ls, n=0 ; s!=NULL, n<data->ns ; s=s->next, n++ )
-		{
-			TIMESTAMP t = loadshape_sync(s,next_t1_ls);
-			if (t<t2) t2 = t;
-		}
-
-		// signal completed condition
-		data->t0 = next_t1_ls;
-		data->ran++;
-
-		// lock access to done condition
-		pthread_mutex_lock(&donelock_ls);
-
-		// signal thread is done for now
-		donecount_ls--;
-		///printf("action: donecount_ls-- = %d\n", donecount_ls);
-		if ( t2<next_t2_ls ) next_t2_ls = t2;
-
-		// signal change in done condition
-		pthread_cond_broadcast(&done_ls);
-
-		// unlock access to done count
-		pthread_mutex_unlock(&donelock_ls);
+		TIMESTAMP t = loadshape_sync(ls[n],task->t1);
+		if (t<t2) t2 = t;
 	}
-	pthread_exit((void*)0);
-	return (void*)0;
+	return t2;
 }
-TIMESTAMP loadshape_syncall(TIMESTAMP t1)
-{
-	static unsigned int n_threads_ls=0;
-	static LOADSHAPESYNCDATA *thread_ls = NULL;
-	TIMESTAMP t2 = TS_NEVER;
-	clock_t ts = (clock_t)exec_clock();
 
-	// skip loadshape_syncall if there's no loadshape in the glm
+/** get the pool task that synchronizes all the loadshapes to the time given
+    @return the task, or NULL if no loadshape needs to be synchronized
+ **/
+TPTASK *loadshape_synctask(TIMESTAMP t1)
+{
+	// skip loadshape sync if there's no loadshape in the glm
 	if (n_shapes == 0)
-		return TS_NEVER;
+		return NULL;
 
-	// number of threads desired
-	if (n_threads_ls==0) 
+	// index the shapes on first use
+	if (loadshape_item==NULL)
 	{
 		loadshape *s;
-		int n_items, ln=0;
-
-		output_debug("loadshape_syncall setting up for %d shapes", n_shapes);
-
-		// determine needed threads
-		n_threads_ls = global_threadcount;
-		if (n_threads_ls>1)
-		{
-			unsigned int n;
-			if (n_shapes<n_threads_ls*4)
-				n_threads_ls = n_shapes/4;
-
-			// only need 1 thread if n_shapes is less than 4
-			if (n_threads_ls == 0)
-				n_threads_ls = 1;
-
-			// determine shapes per thread
-			n_items = n_shapes/n_threads_ls;
-			n_threads_ls = n_shapes/n_items;
-			if (n_threads_ls*n_items<n_shapes) // not enough slots yet
-				n_threads_ls++; // add one underused threads
-
-			output_debug("loadshape_syncall is using %d of %d available threads", n_threads_ls, global_threadcount);
-			output_debug("loadshape_syncall is assigning %d shapes per thread", n_items);
-
-			// allocate thread list
-			thread_ls = (LOADSHAPESYNCDATA*)malloc(sizeof(LOADSHAPESYNCDATA)*n_threads_ls);
-			memset(thread_ls,0,sizeof(LOADSHAPESYNCDATA)*n_threads_ls);
-
-			// assign starting shape for each thread
-			for (s=loadshape_list; s!=NULL; s=s->next)
-			{
-				if (thread_ls[ln].ns==n_items)
-					ln++;
-				if (thread_ls[ln].ns==0)
-					thread_ls[ln].ls = s;
-				thread_ls[ln].ns++;
-			}
-
-			// create threads
-			for (n=0; n<n_threads_ls; n++)
-			{
-				thread_ls[n].ok = true;
-				if ( pthread_create(&(thread_ls[n].pt),NULL,loadshape_syncproc,&(thread_ls[n]))!=0 )
-				{
-					output_fatal("loadshape_sync thread creation failed");
-					thread_ls[n].ok = false;
-				}
-				else
-					thread_ls[n].n = n;
-			}
-		}
+		unsigned int n = 0;
+		output_debug("loadshape_synctask setting up for %d shapes", n_shapes);
+		loadshape_item = (loadshape**)malloc(sizeof(loadshape*)*n_shapes);
+		if (loadshape_item==NULL)
+			throw_exception("loadshape_synctask(): memory allocation failed");
+			/* TROUBLESHOOT
+				The loadshape list used by the sync task could not be allocated.
+				Free up memory and try again.
+			 */
+		for (s=loadshape_list; s!=NULL && n<n_shapes; s=s->next)
+			loadshape_item[n++] = s;
+		memset(&loadshape_task,0,sizeof(loadshape_task));
+		loadshape_task.name = "loadshape";
+		loadshape_task.call = loadshape_synccall;
+		loadshape_task.data = (void*)loadshape_item;
+		loadshape_task.n_items = n;
+		loadshape_task.grain = 4;
 	}
 
 	// don't update if next_t2 < next_t1
 	if ( next_t2_ls>t1 && next_t2_ls<TS_NEVER )
-		return next_t2_ls;
-
-	// no threading required
-	if (n_threads_ls<2) 
-	{
-		// process list directly
-		loadshape *s;
-		for (s=loadshape_list; s!=NULL; s=s->next)
-		{
-			TIMESTAMP t3 = loadshape_sync(s,t1);
-			if (t3<t2) t2 = t3;
-		}
-		next_t2_ls = t2;
-	}
-	else
-	{
-		// lock access to done count
-		pthread_mutex_lock(&donelock_ls);
+		return NULL;
 
-		// initialize wait count
-		donecount_ls = n_threads_ls;
-
-		// lock access to start condition
-		pthread_mutex_lock(&startlock_ls);
-
-		// update start condition
-		next_t1_ls = t1;
-		next_t2_ls = TS_NEVER;
-		run++;
-
-		// signal all the threads
-		pthread_cond_broadcast(&start_ls);
-
-		// unlock access to start count
-		pthread_mutex_unlock(&startlock_ls);
-
-		// begin wait
-		while (donecount_ls>0) {
-			///printf("status: donecount_ls-- = %d\n", donecount_ls);
-			///printf("thread_ls.ok=%d\n",thread_ls->ok);
-			pthread_cond_wait(&done_ls,&donelock_ls);
-		}
-		output_debug("passed donecount==0 condition");
-
-		// unlock done count
-		pthread_mutex_unlock(&donelock_ls);
+	loadshape_task.t1 = t1;
+	loadshape_task.runtime = 0;
+	return &loadshape_task;
+}
 
-		// process results from all threads
-		if (next_t2_ls<t2) t2=next_t2_ls;
+/** collect the result of the loadshape sync task, if it ran
+    @return the time of the next loadshape change
+ **/
+TIMESTAMP loadshape_syncdone(TPTASK *task)
+{
+	if (n_shapes == 0)
+		return TS_NEVER;
+	if (task!=NULL)
+	{
+		next_t2_ls = task->t2;
+		loadshape_synctime += task->runtime;
 	}
-
-	loadshape_synctime += exec_clock() - ts;
-	return t2;
+	return next_t2_ls;
 }
 
 int convert_from_loadshape(char *string,int size,void *data, PROPERTY *prop)
@@ -102,7 +102,8 @@ int loadshape_create(loadshape *shape);
 int loadshape_init(loadshape *shape);
 int loadshape_initall(void);
 TIMESTAMP loadshape_sync(loadshape *m, TIMESTAMP t1);
-TIMESTAMP loadshape_syncall(TIMESTAMP t1);
+struct s_tptask *loadshape_synctask(TIMESTAMP t1);
+TIMESTAMP loadshape_syncdone(struct s_tptask *task);
 
 int loadshape_test(void);
 
@@ -33,6 +33,8 @@
 #include "kml.h"
 #include "kill.h"
 #include "threadpool.h"
+#include "partition.h"
+#include "instrument.h"
 
 #if defined WIN32 && _DEBUG 
 /** Implements a pause on exit capability for Windows consoles
@@ -122,6 +124,21 @@ int main(int argc, /**< the number entries on command-line argument list \p argv
 		exit(XC_ARGERR);
 	}
 
+	/* partition the model instead of running it */
+	if (global_partition_count>0)
+	{
+		if (partition_model(global_partition_count)==FAILED)
+		{
+			output_fatal("model partitioning failed");
+			/*	TROUBLESHOOT
+				The model could not be split into sub-models.  This is usually
+				preceded by a more specific message regarding the problem.
+			 */
+			exit(XC_IOERR);
+		}
+		exit(XC_SUCCESS);
+	}
+
 	/* stitch clock */
 	global_clock = global_starttime;
 
@@ -216,6 +233,8 @@ int main(int argc, /**< the number entries on command-line argument list \p argv
 		class_profiles();
 		module_profiles();
 	}
+	if (global_instrument)
+		instrument_report();
 
 #ifdef DUMP_SCHEDULES
 	/* dump a copy of the schedules for reference */
@@ -195,11 +195,11 @@ static CALLBACKS callbacks = {
 	module_free,
 	{aggregate_mkgroup,aggregate_value,},
 	{module_getvar_addr,module_get_first,module_depends,module_find_transform_function},
-	{random_uniform, random_normal, random_bernoulli, random_pareto, random_lognormal, random_sampled, random_exponential, random_type, random_value, pseudorandom_value, random_triangle, random_beta, random_gamma, random_weibull, random_rayleigh},
+	{random_uniform, random_normal, random_bernoulli, random_pareto, random_lognormal, random_sampled, random_exponential, random_type, random_value, pseudorandom_value, random_triangle, random_beta, random_gamma, random_weibull, random_rayleigh, random_stream_init, random_stream_unit, random_stream_fill},
 	object_isa,
 	class_register_type,
 	class_define_type,
-	{mkdatetime,strdatetime,timestamp_to_days,timestamp_to_hours,timestamp_to_minutes,timestamp_to_seconds,local_datetime,convert_to_timestamp,convert_to_timestamp_delta,convert_from_timestamp,convert_from_deltatime_timestamp},
+	{mkdatetime,strdatetime,timestamp_to_days,timestamp_to_hours,timestamp_to_minutes,timestamp_to_seconds,local_datetime,convert_to_timestamp,convert_to_timestamp_delta,convert_from_timestamp,convert_from_deltatime_timestamp,timestamp_calendar,local_calendar},
 	unit_convert, unit_convert_ex, unit_find,
 	{create_exception_handler,delete_exception_handler,throw_exception,exception_msg},
 	{global_create, global_setvar, global_getvar, global_find},
@@ -226,6 +226,9 @@ static CALLBACKS callbacks = {
 	{transform_getnext,transform_add_linear,transform_add_external,transform_apply},
 	{randomvar_getnext,randomvar_getspec},
 	{version_major,version_minor,version_patch,version_build,version_branch},
+	{whatif_create,whatif_set_variable,whatif_set_objective,whatif_start,whatif_pending,whatif_ischild},
+	{instrument_now,instrument_span},
+	{tp_threadcount,tp_run,tp_release},
 	MAGIC /* used to check structure */
 };
 CALLBACKS *module_callbacks(void) { return &callbacks; }
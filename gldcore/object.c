@@ -32,6 +32,8 @@
 
 #ifdef WIN32
 #define isnan _isnan  /* map isnan to appropriate function under Windows */
+#else
+#include <sys/mman.h>
 #endif
 
 #include "object.h"
@@ -51,6 +53,26 @@ static OBJECT *last_object = NULL;
 static OBJECTNUM object_array_size = 0;
 static OBJECT **object_array = NULL;
 
+/* object slabs */
+#define SLAB_ALIGN 16 /* alignment of each object carved from a slab */
+#define SLAB_HUGEPAGE (2*1024*1024) /* huge page size used to round mapped chunks */
+typedef struct s_objectchunk {
+	size_t size; /**< size of the chunk, including this header */
+	bool mapped; /**< chunk was mapped rather than malloc'ed */
+	struct s_objectchunk *next; /**< next chunk of the same slab */
+} OBJECTCHUNK;
+typedef struct s_objectslab {
+	CLASS *oclass; /**< class whose objects are carved from this slab */
+	size_t size; /**< size of one object (header and class data) rounded to #SLAB_ALIGN */
+	char *next; /**< next free object in the current chunk */
+	char *end; /**< end of the current chunk */
+	OBJECTCHUNK *chunks; /**< chunks of this slab, most recent first */
+	struct s_objectslab *link; /**< next slab */
+} OBJECTSLAB;
+static OBJECTSLAB *first_slab = NULL;
+static OBJECTSLAB *last_slab = NULL; /* most recently used slab */
+static OBJECTNUM heap_object_count = 0; /* objects not carved from a slab */
+
 /* {name, val, next} */
 KEYWORD oflags[] = {
 	/* "name", value, next */
@@ -279,6 +301,139 @@ char *object_get_unit(OBJECT *obj, char *name)
 	}
 }
 
+/*	Allocate a slab chunk of at least \p size bytes, mapped on huge pages when object_hugepages is set.
+	Returns NULL when no memory is available.
+ */
+static OBJECTCHUNK *object_slab_chunk(size_t size)
+{
+	OBJECTCHUNK *chunk = NULL;
+#if !defined WIN32 && defined MAP_ANONYMOUS
+	if ( global_object_hugepages )
+	{
+		size_t mapsize = (size+SLAB_HUGEPAGE-1)/SLAB_HUGEPAGE*SLAB_HUGEPAGE;
+		void *addr = mmap(NULL,mapsize,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+		if ( addr!=MAP_FAILED )
+		{
+#ifdef MADV_HUGEPAGE
+			if ( madvise(addr,mapsize,MADV_HUGEPAGE)!=0 )
+				output_verbose("object slab chunk of %d kB is not backed by huge pages (%s)", (int)(mapsize/1024), strerror(errno));
+#endif
+			chunk = (OBJECTCHUNK*)addr;
+			chunk->size = mapsize;
+			chunk->mapped = true;
+			return chunk;
+		}
+		output_warning("unable to map a %d kB object slab chunk (%s), using the heap instead", (int)(mapsize/1024), strerror(errno));
+		/* TROUBLESHOOT
+			The system refused to map memory for the objects of a class, so the objects are placed on the
+			ordinary heap.  The model runs normally, but huge page backing is not used.  Set object_hugepages
+			to false to suppress this warning.
+		 */
+	}
+#endif
+	chunk = (OBJECTCHUNK*)malloc(size);
+	if ( chunk!=NULL )
+	{
+		chunk->size = size;
+		chunk->mapped = false;
+	}
+	return chunk;
+}
+
+/*	Carve the memory for an object of class \p oclass from the slab of that class, so objects
+	of the same class are laid out next to each other in the order they are created.
+	Returns NULL when no memory is available.
+ */
+static OBJECT *object_slab_alloc(CLASS *oclass)
+{
+	OBJECTSLAB *slab = last_slab;
+	char *addr;
+
+	if ( slab==NULL || slab->oclass!=oclass )
+	{
+		for ( slab=first_slab; slab!=NULL && slab->oclass!=oclass; slab=slab->link ) {}
+		if ( slab==NULL )
+		{
+			slab = (OBJECTSLAB*)malloc(sizeof(OBJECTSLAB));
+			if ( slab==NULL )
+				return NULL;
+			slab->oclass = oclass;
+			slab->size = (sizeof(OBJECT)+oclass->size+SLAB_ALIGN-1)/SLAB_ALIGN*SLAB_ALIGN;
+			slab->next = slab->end = NULL;
+			slab->chunks = NULL;
+			slab->link = first_slab;
+			first_slab = slab;
+		}
+		last_slab = slab;
+	}
+
+	if ( slab->next==NULL || slab->next+slab->size>slab->end )
+	{
+		size_t header = (sizeof(OBJECTCHUNK)+SLAB_ALIGN-1)/SLAB_ALIGN*SLAB_ALIGN;
+		size_t size = header + slab->size;
+		OBJECTCHUNK *chunk;
+		if ( size<(size_t)global_object_slab_size )
+			size = (size_t)global_object_slab_size;
+		chunk = object_slab_chunk(size);
+		if ( chunk==NULL )
+			return NULL;
+		chunk->next = slab->chunks;
+		slab->chunks = chunk;
+		slab->next = (char*)chunk + header;
+		slab->end = (char*)chunk + chunk->size;
+	}
+
+	addr = slab->next;
+	slab->next += slab->size;
+	return (OBJECT*)addr;
+}
+
+/*	Check whether an object was carved from a slab, in which case its memory
+	is only returned when all the slabs are released.
+ */
+static bool object_slab_owns(OBJECT *obj)
+{
+	OBJECTSLAB *slab;
+	OBJECTCHUNK *chunk;
+	for ( slab=first_slab; slab!=NULL; slab=slab->link )
+	{
+		if ( slab->oclass!=obj->oclass )
+			continue;
+		for ( chunk=slab->chunks; chunk!=NULL; chunk=chunk->next )
+		{
+			if ( (char*)obj>(char*)chunk && (char*)obj<(char*)chunk+chunk->size )
+				return true;
+		}
+	}
+	return false;
+}
+
+/*	Release all the slabs at once, with every object carved from them.
+ */
+static void object_slab_release(void)
+{
+	while ( first_slab!=NULL )
+	{
+		OBJECTSLAB *slab = first_slab;
+		while ( slab->chunks!=NULL )
+		{
+			OBJECTCHUNK *chunk = slab->chunks;
+			slab->chunks = chunk->next;
+#if !defined WIN32 && defined MAP_ANONYMOUS
+			if ( chunk->mapped )
+			{
+				munmap(chunk,chunk->size);
+				continue;
+			}
+#endif
+			free(chunk);
+		}
+		first_slab = slab->link;
+		free(slab);
+	}
+	last_slab = NULL;
+}
+
 /** Create a single object.
 	@return a pointer to object header, \p NULL of error, set \p errno as follows:
 	- \p EINVAL type is not valid
@@ -312,7 +467,13 @@ OBJECT *object_create_single(CLASS *oclass){ /**< the class of the object */
 		*/
 	}
 
-	obj = (OBJECT*)malloc(sz + oclass->size);
+	if ( global_object_slab_size>0 )
+		obj = object_slab_alloc(oclass);
+	else
+	{
+		obj = (OBJECT*)malloc(sz + oclass->size);
+		heap_object_count++;
+	}
 
 	if(obj == NULL){
 		throw_exception("object_create_single(CLASS *oclass='%s'): memory allocation failed", oclass->name);
@@ -342,7 +503,7 @@ OBJECT *object_create_single(CLASS *oclass){ /**< the class of the object */
 	obj->out_svc_double = (double)obj->out_svc;
 	obj->space = object_current_namespace();
 	obj->flags = OF_NONE;
-	obj->rng_state = randwarn(NULL);
+	random_state_init(&(obj->rng_state),obj->id,0);
 	obj->heartbeat = 0;
 
 	for ( prop=obj->oclass->pmap; prop!=NULL; prop=(prop->next?prop->next:(prop->oclass->parent?prop->oclass->parent->pmap:NULL)))
@@ -411,6 +572,7 @@ OBJECT *object_create_foreign(OBJECT *obj) /**< a pointer to the OBJECT data str
 	obj->out_svc_micro = 0;
 	obj->out_svc_double = (double)obj->out_svc;
 	obj->flags = OF_FOREIGN;
+	heap_object_count++;
 	
 	if(first_object == NULL){
 		first_object = obj;
@@ -483,7 +645,11 @@ OBJECT *object_remove_by_id(OBJECTNUM id){
 		next = target->next;
 		prev->next = next;
 		target->oclass->profiler.numobjs--;
-		free(target);
+		if ( !object_slab_owns(target) )
+		{
+			free(target);
+			heap_object_count--;
+		}
 		target = NULL;
 		deleted_object_count++;
 	}
@@ -1491,6 +1657,7 @@ TIMESTAMP object_sync(OBJECT *obj, /**< the object to synchronize */
 					  PASSCONFIG pass) /**< the pass configuration */
 {
 	clock_t t = (clock_t)exec_clock();
+	int64 it = instrument_now();
 	TIMESTAMP t2=TS_NEVER;
 	do {
 		/* don't call sync beyond valid horizon */
@@ -1507,6 +1674,7 @@ TIMESTAMP object_sync(OBJECT *obj, /**< the object to synchronize */
 		default: break;
 		}
 	}
+	instrument_object(obj,pass==PC_PRETOPDOWN?OPI_PRESYNC:(pass==PC_BOTTOMUP?OPI_SYNC:OPI_POSTSYNC),it);
 	if ( global_debug_output>0 )
 	{
 		const char *passname[]={"NOSYNC","PRESYNC","SYNC","INVALID","POSTSYNC"};
@@ -1520,8 +1688,10 @@ TIMESTAMP object_sync(OBJECT *obj, /**< the object to synchronize */
 TIMESTAMP object_heartbeat(OBJECT *obj)
 {
 	clock_t t = (clock_t)exec_clock();
+	int64 it = instrument_now();
 	TIMESTAMP t1 = obj->oclass->heartbeat ? obj->oclass->heartbeat(obj) : TS_NEVER;
 	object_profile(obj,OPI_HEARTBEAT,t);
+	instrument_object(obj,OPI_HEARTBEAT,it);
 		if ( global_debug_output>0 )
 		{
 			char dt[64]="(invalid)"; convert_from_timestamp(absolute_timestamp(t1),dt,sizeof(dt));
@@ -1538,11 +1708,13 @@ TIMESTAMP object_heartbeat(OBJECT *obj)
 int object_init(OBJECT *obj) /**< the object to initialize */
 {
 	clock_t t = (clock_t)exec_clock();
+	int64 it = instrument_now();
 	int rv = 1;
 	obj->clock = global_starttime;
 	if(obj->oclass->init != NULL)
 		rv = (int)(*(obj->oclass->init))(obj, obj->parent);
 	object_profile(obj,OPI_INIT,t);
+	instrument_object(obj,OPI_INIT,it);
 	if ( global_debug_output>0 )
 		output_debug("object %s:%d init -> %s", obj->oclass->name, obj->id, rv?"ok":"failed");
 	return rv;
@@ -1560,6 +1732,7 @@ int object_init(OBJECT *obj) /**< the object to initialize */
 STATUS object_precommit(OBJECT *obj, TIMESTAMP t1)
 {
 	clock_t t = (clock_t)exec_clock();
+	int64 it = instrument_now();
 	STATUS rv = SUCCESS;
 	if(obj->oclass->precommit != NULL){
 		rv = (STATUS)(*(obj->oclass->precommit))(obj, t1);
@@ -1568,6 +1741,7 @@ STATUS object_precommit(OBJECT *obj, TIMESTAMP t1)
 		rv = SUCCESS;
 	}
 	object_profile(obj,OPI_PRECOMMIT,t);
+	instrument_object(obj,OPI_PRECOMMIT,it);
 		if ( global_debug_output>0 )
 			output_debug("object %s:%d precommit -> %s", obj->oclass->name, obj->id, rv?"ok":"failed");
 	return rv;
@@ -1576,6 +1750,7 @@ STATUS object_precommit(OBJECT *obj, TIMESTAMP t1)
 TIMESTAMP object_commit(OBJECT *obj, TIMESTAMP t1, TIMESTAMP t2)
 {
 	clock_t t = (clock_t)exec_clock();
+	int64 it = instrument_now();
 	TIMESTAMP rv = 1;
 	if(obj->oclass->commit != NULL){
 		rv = (TIMESTAMP)(*(obj->oclass->commit))(obj, t1, t2);
@@ -1584,6 +1759,7 @@ TIMESTAMP object_commit(OBJECT *obj, TIMESTAMP t1, TIMESTAMP t2)
 		rv =TS_NEVER;
 	} 
 	object_profile(obj,OPI_COMMIT,t);
+	instrument_object(obj,OPI_COMMIT,it);
 	if ( global_debug_output>0 )
 	{
 		char dt[64]="(invalid)"; convert_from_timestamp(absolute_timestamp(rv),dt,sizeof(dt));
@@ -1601,6 +1777,7 @@ TIMESTAMP object_commit(OBJECT *obj, TIMESTAMP t1, TIMESTAMP t2)
 STATUS object_finalize(OBJECT *obj)
 {
 	clock_t t = (clock_t)exec_clock();
+	int64 it = instrument_now();
 	STATUS rv = SUCCESS;
 	if(obj->oclass->finalize != NULL){
 		rv = (STATUS)(*(obj->oclass->finalize))(obj);
@@ -1609,6 +1786,7 @@ STATUS object_finalize(OBJECT *obj)
 		rv = SUCCESS;
 	}
 	object_profile(obj,OPI_FINALIZE,t);
+	instrument_object(obj,OPI_FINALIZE,it);
 	if ( global_debug_output>0 )
 	{
 		output_debug("object %s:%d finalize -> %s", obj->oclass->name, obj->id, rv?"ok":"failed");
@@ -1785,79 +1963,92 @@ int object_save(char *buffer, int size, OBJECT *obj)
 	}
 }
 
-/** Save all the objects in the model to the stream \p fp in the \p .GLM format
-	@return the number of bytes written, 0 on error, with errno set.
+/** Save a single object to the stream \p fp in the \p .GLM format
+	@return the number of bytes written
  **/
-int object_saveall(FILE *fp) /**< the stream to write to */
+int object_saveglm(FILE *fp, /**< the stream to write to */
+				   OBJECT *obj) /**< the object to write */
 {
 	unsigned count = 0;
 	char buffer[1024];
+	PROPERTYACCESS access=PA_PUBLIC;
+	PROPERTY *prop = NULL;
+	CLASS *oclass;
+	char32 oname = "(unidentified)";
+	if ( obj->oclass->name )
+		count += fprintf(fp, "object %s:%d {\n", obj->oclass->name, obj->id);
 
-	count += fprintf(fp, "\n////////////////////////////////////////////////////////\n");
-	count += fprintf(fp, "// objects\n");
+	/* dump internal properties */
+	if ( obj->parent != NULL )
 	{
-		OBJECT *obj;
-		for (obj = first_object; obj != NULL; obj = obj->next)
-		{
-			PROPERTYACCESS access=PA_PUBLIC;
-			PROPERTY *prop = NULL;
-			char32 oname = "(unidentified)";
-			if ( obj->oclass->name )
-				count += fprintf(fp, "object %s:%d {\n", obj->oclass->name, obj->id);
-
-			/* dump internal properties */
-			if ( obj->parent != NULL )
-			{
-				if ( obj->parent->name != NULL )
-					count += fprintf(fp, "\tparent %s;\n", obj->parent->name);
-				else
-					count += fprintf(fp, "\tparent %s:%d;\n", obj->parent->oclass->name, obj->parent->id);
-			}
-			else
-			{
-				count += fprintf(fp,"#ifdef INCLUDE_ROOT\n\troot;\n#endif\n");
-			}
-			count += fprintf(fp, "\trank %d;\n", obj->rank);
-			if ( obj->name != NULL )
-				count += fprintf(fp, "\tname %s;\n", obj->name);
-			if ( convert_from_timestamp(obj->clock, buffer, sizeof(buffer)) )
-				count += fprintf(fp,"\tclock %s;\n",  buffer);
-			if ( !isnan(obj->latitude) )
-				count += fprintf(fp, "\tlatitude %s;\n", convert_from_latitude(obj->latitude, buffer, sizeof(buffer)) ? buffer : "(invalid)");
-			if ( !isnan(obj->longitude) )
-				count += fprintf(fp, "\tlongitude %s;\n", convert_from_longitude(obj->longitude, buffer, sizeof(buffer)) ? buffer : "(invalid)");
-			if ( convert_from_set(buffer, sizeof(buffer), &(obj->flags), object_flag_property()) > 0 )
-				count += fprintf(fp, "\tflags %s;\n",  buffer);
-			else
-				count += fprintf(fp, "\tflags %lld;\n", obj->flags);
+		if ( obj->parent->name != NULL )
+			count += fprintf(fp, "\tparent %s;\n", obj->parent->name);
+		else
+			count += fprintf(fp, "\tparent %s:%d;\n", obj->parent->oclass->name, obj->parent->id);
+	}
+	else
+	{
+		count += fprintf(fp,"#ifdef INCLUDE_ROOT\n\troot;\n#endif\n");
+	}
+	count += fprintf(fp, "\trank %d;\n", obj->rank);
+	if ( obj->name != NULL )
+		count += fprintf(fp, "\tname %s;\n", obj->name);
+	if ( convert_from_timestamp(obj->clock, buffer, sizeof(buffer)) )
+		count += fprintf(fp,"\tclock %s;\n",  buffer);
+	if ( !isnan(obj->latitude) )
+		count += fprintf(fp, "\tlatitude %s;\n", convert_from_latitude(obj->latitude, buffer, sizeof(buffer)) ? buffer : "(invalid)");
+	if ( !isnan(obj->longitude) )
+		count += fprintf(fp, "\tlongitude %s;\n", convert_from_longitude(obj->longitude, buffer, sizeof(buffer)) ? buffer : "(invalid)");
+	if ( convert_from_set(buffer, sizeof(buffer), &(obj->flags), object_flag_property()) > 0 )
+		count += fprintf(fp, "\tflags %s;\n",  buffer);
+	else
+		count += fprintf(fp, "\tflags %lld;\n", obj->flags);
 
-			/* dump properties */
-			for ( prop=obj->oclass->pmap; prop!=NULL; prop=(prop->next?prop->next:(prop->oclass->parent?prop->oclass->parent->pmap:NULL)) )
+	/* dump properties, including those inherited through classes that define none of their own */
+	for ( oclass=obj->oclass ; oclass!=NULL ; oclass=oclass->parent )
+	{
+		for ( prop=oclass->pmap; prop!=NULL && prop->oclass==oclass; prop=prop->next )
+		{
+			if ( object_property_to_string(obj, prop->name, buffer, sizeof(buffer)) != NULL )
 			{
-				if ( object_property_to_string(obj, prop->name, buffer, sizeof(buffer)) != NULL )
+				if ( prop->access != access )
 				{
-					if ( prop->access != access )
-					{
-						if ( access != PA_PUBLIC )
-							count += fprintf(fp, "#endif\n");
-						if ( prop->access == PA_REFERENCE)
-							count += fprintf(fp, "#ifdef INCLUDE_REFERENCE\n");
-						else if ( prop->access == PA_PROTECTED )
-							count += fprintf(fp, "#ifdef INCLUDE_PROTECTED\n");
-						else if ( prop->access == PA_PRIVATE )
-							count += fprintf(fp, "#ifdef INCLUDE_PRIVATE\n");
-						else if ( prop->access == PA_HIDDEN )
-							count += fprintf(fp, "#ifdef INCLUDE_HIDDEN\n");
-						access = prop->access;
-					}
-					count += fprintf(fp, "\t%s %s;\n", prop->name, buffer);
+					if ( access != PA_PUBLIC )
+						count += fprintf(fp, "#endif\n");
+					if ( prop->access == PA_REFERENCE)
+						count += fprintf(fp, "#ifdef INCLUDE_REFERENCE\n");
+					else if ( prop->access == PA_PROTECTED )
+						count += fprintf(fp, "#ifdef INCLUDE_PROTECTED\n");
+					else if ( prop->access == PA_PRIVATE )
+						count += fprintf(fp, "#ifdef INCLUDE_PRIVATE\n");
+					else if ( prop->access == PA_HIDDEN )
+						count += fprintf(fp, "#ifdef INCLUDE_HIDDEN\n");
+					access = prop->access;
 				}
+				count += fprintf(fp, "\t%s %s;\n", prop->name, buffer);
 			}
-			if ( access != PA_PUBLIC )
-				count += fprintf(fp, "#endif\n");
-			count += fprintf(fp,"}\n");
 		}
 	}
+	if ( access != PA_PUBLIC )
+		count += fprintf(fp, "#endif\n");
+	count += fprintf(fp,"}\n");
+	return count;
+}
+
+/** Save all the objects in the model to the stream \p fp in the \p .GLM format
+	@return the number of bytes written, 0 on error, with errno set.
+ **/
+int object_saveall(FILE *fp) /**< the stream to write to */
+{
+	unsigned count = 0;
+
+	count += fprintf(fp, "\n////////////////////////////////////////////////////////\n");
+	count += fprintf(fp, "// objects\n");
+	{
+		OBJECT *obj;
+		for (obj = first_object; obj != NULL; obj = obj->next)
+			count += object_saveglm(fp,obj);
+	}
 	return count;	
 }
 
@@ -2427,9 +2618,14 @@ void remove_objects(){
 	while(obj1 != NULL){
 		first_object = obj1->next;
 		obj1->oclass->profiler.numobjs--;
-		free(obj1);
+		if ( heap_object_count>0 && !object_slab_owns(obj1) )
+		{
+			free(obj1);
+			heap_object_count--;
+		}
 		obj1 = first_object;
 	}
+	object_slab_release();
 
 	next_object_id = 0;
 }
@@ -17,6 +17,9 @@
 #include "schedule.h"
 #include "transform.h"
 #include "enduse.h"
+#include "whatif.h"
+#include "instrument.h"
+#include "threadpool.h"
 
 /* this must match property_type list in object.c */
 typedef unsigned int OBJECTRANK; /**< Object rank number */
@@ -181,6 +184,9 @@ typedef struct s_callbacks {
 		double (*gamma)(unsigned int *rng,double a, double b);
 		double (*weibull)(unsigned int *rng,double a, double b);
 		double (*rayleigh)(unsigned int *rng,double a);
+		void (*stream_init)(RANDOMSTREAM *rs, unsigned int64 id, unsigned int stream);
+		double (*stream_unit)(RANDOMSTREAM *rs);
+		int (*stream_fill)(RANDOMSTREAM *rs, RANDOMTYPE type, double *sample, unsigned int count, ...);
 	} random;
 	int (*object_isa)(OBJECT *obj, char *type);
 	DELEGATEDTYPE* (*register_type)(CLASS *oclass, char *type,int (*from_string)(void*,char*),int (*to_string)(void*,char*,int));
@@ -197,6 +203,8 @@ typedef struct s_callbacks {
 		TIMESTAMP (*convert_to_timestamp_delta)(const char *value, unsigned int *microseconds, double *dbl_time_value);
 		int (*convert_from_timestamp)(TIMESTAMP ts, char *buffer, int size);
 		int (*convert_from_deltatime_timestamp)(double ts_v, char *buffer, int size);
+		const CALENDARCONTEXT *(*calendar)(void);
+		int (*local_calendar)(TIMESTAMP ts, CALENDARCONTEXT *cal);
 	} time;
 	int (*unit_convert)(char *from, char *to, double *value);
 	int (*unit_convert_ex)(UNIT *pFrom, UNIT *pTo, double *pValue);
@@ -323,6 +331,23 @@ typedef struct s_callbacks {
 		unsigned int (*build)(void);
 		const char * (*branch)(void);
 	} version;
+	struct {
+		WHATIF *(*create)(struct s_object_list *owner, unsigned int n_vars, unsigned int max_candidates, TIMESTAMP horizon);
+		int (*set_variable)(WHATIF *wi, unsigned int n, double *addr);
+		int (*set_objective)(WHATIF *wi, double *addr);
+		int (*start)(WHATIF *wi, WHATIFSEARCH search, void *context);
+		int (*pending)(WHATIF *wi);
+		int (*ischild)(void);
+	} whatif;
+	struct {
+		int64 (*now)(void);
+		void (*span)(const char *name, int category, int64 t0);
+	} instrument;
+	struct {
+		unsigned int (*threadcount)(void);
+		TIMESTAMP (*run)(TPTASK **task, unsigned int n_tasks);
+		void (*release)(void);
+	} pool;
 	long unsigned int magic; /* used to check structure alignment */
 } CALLBACKS; /**< core callback function table */
 
@@ -396,6 +421,7 @@ OBJECT *object_get_next(OBJECT *obj);
 unsigned int object_get_count(void);
 int object_dump(char *buffer, int size, OBJECT *obj);
 int object_save(char *buffer, int size, OBJECT *obj);
+int object_saveglm(FILE *fp, OBJECT *obj);
 int object_saveall(FILE *fp);
 int object_saveall_xml(FILE *fp);
 void object_stream_fixup(OBJECT *obj, char *classname, char *objname);
@@ -0,0 +1,554 @@
+/* partition.c
+ * Copyright (C) 2008 Battelle Memorial Institute
+ * Splits a loaded model into multirun master/slave sub-models.
+ *
+ * The object graph is built from parent relations and object references between
+ * objects that synchronize; objects that do not (e.g., configurations) are copied into
+ * every sub-model instead of tying the graph together.  The graph
+ * is only cut at link objects whose class is listed in the partition_cuts global
+ * (e.g., substation transformers and feeder head regulators): the link stays with its
+ * from node and the node on its to side becomes a boundary node.  The connected
+ * components that remain form a tree of cuts rooted at the largest component, which
+ * is kept by the master.  Subtrees hanging off the master are packed into partitions
+ * by estimated cost, largest first into the least loaded partition, and a subtree
+ * that is too large to fit a single partition is split by moving its top component
+ * into the master and packing its children instead.  The cost of a component is the
+ * number of objects in it: the model is partitioned before it runs, when the class
+ * profilers have no timings yet.
+ *
+ * Partition 0 is the master.  It keeps a replica of each boundary node, writes the
+ * partition_write properties to the slave's boundary node and reads the partition_read
+ * properties back.  The slave's boundary node is modified by the partition_boundary
+ * settings so that it acts as the source of its sub-model.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include "platform.h"
+#include "output.h"
+#include "globals.h"
+#include "object.h"
+#include "class.h"
+#include "module.h"
+#include "timestamp.h"
+#include "partition.h"
+
+typedef struct s_partcut {
+	OBJECT *link;	///< link object at which the graph is cut
+	OBJECT *node;	///< node on the to side of the link
+	struct s_partcut *next;
+} PARTCUT;
+
+typedef struct s_partcomp {
+	int used;		///< non-zero if this entry is the root of a component
+	int parent;		///< component above this one across a cut (-1 if none)
+	int child;		///< first component below this one across a cut (-1 if none)
+	int sibling;	///< next component below the same parent (-1 if none)
+	int part;		///< partition assigned (-1 if not assigned yet)
+	int master;		///< non-zero if the component is kept in the master
+	double cost;	///< estimated cost of the objects in the component (the object count)
+	double total;	///< estimated cost of the component and all components below it
+} PARTCOMP;
+
+static int *uf = NULL; ///< union-find table of components indexed by object id
+static PARTCOMP *comp = NULL; ///< component table indexed by object id
+
+static int uf_find(int i)
+{
+	while ( uf[i]!=i )
+	{
+		uf[i] = uf[uf[i]];
+		i = uf[i];
+	}
+	return i;
+}
+static void uf_union(int a, int b)
+{
+	a = uf_find(a);
+	b = uf_find(b);
+	if ( a!=b )
+		uf[b] = a;
+}
+
+/* check whether a name appears in a comma-separated list */
+static int in_list(char *list, char *name)
+{
+	size_t len = strlen(name);
+	char *p = list;
+	while ( (p=strstr(p,name))!=NULL )
+	{
+		if ( (p==list || p[-1]==',') && (p[len]=='\0' || p[len]==',') )
+			return 1;
+		p += len;
+	}
+	return 0;
+}
+
+/* check whether the graph may be cut at an object */
+static int is_cut(OBJECT *obj)
+{
+	CLASS *oclass;
+	for ( oclass=obj->oclass ; oclass!=NULL ; oclass=oclass->parent )
+	{
+		if ( in_list(global_partition_cuts,oclass->name) )
+			return 1;
+	}
+	return 0;
+}
+
+/* check whether an object is shared data (e.g., configurations) that every partition gets a copy of */
+static int is_shared(OBJECT *obj)
+{
+	return obj->parent==NULL && (obj->oclass->passconfig&(PC_PRETOPDOWN|PC_BOTTOMUP|PC_POSTTOPDOWN))==0;
+}
+
+static int object_part(OBJECT *obj)
+{
+	return comp[uf_find(obj->id)].part;
+}
+
+static int cmp_units(const void *a, const void *b)
+{
+	double ta = comp[*(int*)a].total, tb = comp[*(int*)b].total;
+	return ta<tb ? 1 : ( ta>tb ? -1 : 0 );
+}
+
+/* save an object with the partition_boundary settings applied */
+static int save_boundary(FILE *fp, OBJECT *obj)
+{
+	char list[1024], *item, *next;
+	char old[32][1024];
+	char *name[32];
+	int n = 0, i, count;
+
+	strcpy(list,global_partition_boundary);
+	for ( item=list ; item!=NULL && *item!='\0' && n<32 ; item=next )
+	{
+		char *value = strchr(item,'=');
+		next = strchr(item,',');
+		if ( next ) *next++ = '\0';
+		if ( value==NULL )
+		{
+			output_warning("partition_boundary setting '%s' is not a property=value pair", item);
+			continue;
+		}
+		*value++ = '\0';
+		if ( object_property_to_string(obj,item,old[n],sizeof(old[n]))==NULL )
+		{
+			output_warning("boundary node %s does not have property '%s'", obj->name, item);
+			continue;
+		}
+		if ( object_set_value_by_name(obj,item,value)==0 )
+		{
+			output_warning("unable to set boundary node %s property '%s' to '%s'", obj->name, item, value);
+			continue;
+		}
+		name[n++] = item;
+	}
+	count = object_saveglm(fp,obj);
+	for ( i=0 ; i<n ; i++ )
+		object_set_value_by_name(obj,name[i],old[i]);
+	return count;
+}
+
+/* write the linkages for a boundary node */
+static int save_linkage(FILE *fp, OBJECT *obj, char *properties, char *direction)
+{
+	char list[1024], *item, *next;
+	int count = 0;
+
+	strcpy(list,properties);
+	for ( item=list ; item!=NULL && *item!='\0' ; item=next )
+	{
+		next = strchr(item,',');
+		if ( next ) *next++ = '\0';
+		if ( object_get_property(obj,item,NULL)==NULL )
+		{
+			output_warning("boundary node %s does not have property '%s', no linkage created", obj->name, item);
+			continue;
+		}
+		count += fprintf(fp,"\t%s:%s %s %s:%s;\n", obj->name, item, direction, obj->name, item);
+	}
+	return count;
+}
+
+static int save_header(FILE *fp, int part, int n)
+{
+	char buffer[1024];
+	int count = 0;
+	count += fprintf(fp,"////////////////////////////////////////////////////////\n");
+	count += fprintf(fp,"// partition.. %d of %d (%s)\n", part, n, part==0?"master":"slave");
+	count += fprintf(fp,"// model...... %s\n", global_modelname);
+	count += fprintf(fp,"// command.... %s\n", global_command_line);
+	count += fprintf(fp,"////////////////////////////////////////////////////////\n");
+	count += fprintf(fp,"\n// CLOCK\n");
+	count += fprintf(fp,"clock {\n");
+	count += fprintf(fp,"\ttimezone %s;\n", timestamp_current_timezone());
+	if ( convert_from_timestamp(global_starttime,buffer,sizeof(buffer))>0 )
+		count += fprintf(fp,"\tstarttime '%s';\n", buffer);
+	if ( convert_from_timestamp(global_stoptime,buffer,sizeof(buffer))>0 )
+		count += fprintf(fp,"\tstoptime '%s';\n", buffer);
+	count += fprintf(fp,"}\n");
+	count += module_saveall(fp);
+	count += fprintf(fp,"\n////////////////////////////////////////////////////////\n");
+	count += fprintf(fp,"// objects\n");
+	return count;
+}
+
+static STATUS save_partitions(int n, PARTCUT *cuts, char *boundary)
+{
+	char stem[1024], *ext;
+	int part;
+
+	strcpy(stem,global_modelname);
+	ext = strrchr(stem,'.');
+	if ( ext!=NULL && strcmp(ext,".glm")==0 )
+		*ext = '\0';
+
+	for ( part=0 ; part<n ; part++ )
+	{
+		char filename[1100];
+		FILE *fp;
+		OBJECT *obj;
+		PARTCUT *cut;
+		int nobjs = 0;
+
+		sprintf(filename,"%s-%d.glm",stem,part);
+		fp = fopen(filename,"w");
+		if ( fp==NULL )
+		{
+			output_error("unable to open partition file '%s' for writing (%s)", filename, strerror(errno));
+			return FAILED;
+		}
+		save_header(fp,part,n);
+		for ( obj=object_get_first() ; obj!=NULL ; obj=obj->next )
+		{
+			if ( !is_shared(obj) && object_part(obj)!=part )
+				continue;
+			if ( part>0 && boundary[obj->id] )
+				save_boundary(fp,obj);
+			else
+				object_saveglm(fp,obj);
+			nobjs++;
+		}
+		if ( part==0 )
+		{
+			int slave;
+
+			/* master keeps a replica of each boundary node */
+			fprintf(fp,"\n////////////////////////////////////////////////////////\n");
+			fprintf(fp,"// boundary nodes\n");
+			for ( cut=cuts ; cut!=NULL ; cut=cut->next )
+			{
+				if ( boundary[cut->node->id]==1 )
+				{
+					object_saveglm(fp,cut->node);
+					boundary[cut->node->id] = 2;
+				}
+			}
+
+			/* linkages to each slave */
+			fprintf(fp,"\n////////////////////////////////////////////////////////\n");
+			fprintf(fp,"// instances\n");
+			for ( slave=1 ; slave<n ; slave++ )
+			{
+				char model[1100];
+				sprintf(model,"%s-%d.glm",stem,slave);
+				fprintf(fp,"instance localhost {\n");
+				fprintf(fp,"\tmodel \"%s\";\n", model);
+				for ( cut=cuts ; cut!=NULL ; cut=cut->next )
+				{
+					if ( boundary[cut->node->id]==2 && object_part(cut->node)==slave )
+					{
+						save_linkage(fp,cut->node,global_partition_write,"->");
+						save_linkage(fp,cut->node,global_partition_read,"<-");
+						boundary[cut->node->id] = 3;
+					}
+				}
+				fprintf(fp,"}\n");
+			}
+		}
+		fclose(fp);
+		output_verbose("partition %d saved to '%s' with %d objects", part, filename, nobjs);
+	}
+	return SUCCESS;
+}
+
+/** Partition the loaded model into \p n sub-models.
+	The sub-models are written to files named after the model with the partition number appended,
+	e.g., model-0.glm (the master) through model-<n-1>.glm.
+	@returns SUCCESS or FAILED
+ **/
+STATUS partition_model(int n) /**< the number of partitions (including the master) */
+{
+	OBJECT *obj;
+	PARTCUT *cuts = NULL, *cut;
+	double *load = NULL;
+	int *units = NULL, *stack = NULL, *map = NULL;
+	char *boundary = NULL;
+	int nobj = 0, nunits = 0, nstack = 0, nparts, i, changed, root = -1;
+	double total = 0, target;
+	STATUS result = FAILED;
+
+	if ( n<2 )
+	{
+		output_error("partition_model(n=%d): at least 2 partitions are required", n);
+		return FAILED;
+	}
+	if ( object_get_first()==NULL )
+	{
+		output_error("partition_model(): no objects loaded");
+		/* TROUBLESHOOT
+			The model must be loaded before it can be partitioned. Place the <b>--partition</b>
+			option after the model file name on the command line.
+		 */
+		return FAILED;
+	}
+
+	for ( obj=object_get_first() ; obj!=NULL ; obj=obj->next )
+	{
+		if ( (int)obj->id>=nobj )
+			nobj = obj->id+1;
+	}
+	uf = (int*)malloc(sizeof(int)*nobj);
+	comp = (PARTCOMP*)malloc(sizeof(PARTCOMP)*nobj);
+	units = (int*)malloc(sizeof(int)*nobj);
+	stack = (int*)malloc(sizeof(int)*nobj);
+	boundary = (char*)malloc(nobj);
+	load = (double*)malloc(sizeof(double)*n);
+	map = (int*)malloc(sizeof(int)*n);
+	if ( uf==NULL || comp==NULL || units==NULL || stack==NULL || boundary==NULL || load==NULL || map==NULL )
+	{
+		output_error("partition_model(): memory allocation failed");
+		goto Done;
+	}
+	for ( i=0 ; i<nobj ; i++ )
+		uf[i] = i;
+	memset(boundary,0,nobj);
+
+	/* build the object graph, leaving the to side of cut links unconnected */
+	for ( obj=object_get_first() ; obj!=NULL ; obj=obj->next )
+	{
+		CLASS *oclass;
+		PROPERTY *prop;
+		int cutlink = is_cut(obj);
+		if ( is_shared(obj) )
+			continue;
+		if ( obj->parent!=NULL )
+			uf_union(obj->id,obj->parent->id);
+		for ( oclass=obj->oclass ; oclass!=NULL ; oclass=oclass->parent )
+		for ( prop=oclass->pmap ; prop!=NULL && prop->oclass==oclass ; prop=prop->next )
+		{
+			OBJECT **ref;
+			if ( prop->ptype!=PT_object || prop->access==PA_PRIVATE )
+				continue;
+			ref = object_get_object(obj,prop);
+			if ( ref==NULL || *ref==NULL || is_shared(*ref) )
+				continue;
+			if ( cutlink && strcmp(prop->name,"to")==0 )
+			{
+				cut = (PARTCUT*)malloc(sizeof(PARTCUT));
+				if ( cut==NULL )
+				{
+					output_error("partition_model(): memory allocation failed");
+					goto Done;
+				}
+				cut->link = obj;
+				cut->node = *ref;
+				cut->next = cuts;
+				cuts = cut;
+			}
+			else
+				uf_union(obj->id,(*ref)->id);
+		}
+	}
+
+	/* build the tree of cuts, dropping cuts that do not separate the graph */
+	do {
+		changed = 0;
+		for ( i=0 ; i<nobj ; i++ )
+			comp[i].parent = -1;
+		for ( cut=cuts ; cut!=NULL ; cut=cut->next )
+		{
+			int from = uf_find(cut->link->id), to = uf_find(cut->node->id), up;
+			if ( from==to )
+				continue;
+			for ( up=from ; up>=0 && up!=to ; up=comp[up].parent ) {}
+			if ( up==to || ( comp[to].parent>=0 && comp[to].parent!=from ) )
+			{
+				/* loop or second feed into the same component */
+				uf_union(from,to);
+				changed = 1;
+				break;
+			}
+			comp[to].parent = from;
+		}
+	} while ( changed );
+
+	/* estimate component costs */
+	for ( i=0 ; i<nobj ; i++ )
+	{
+		comp[i].used = 0;
+		comp[i].child = comp[i].sibling = comp[i].part = -1;
+		comp[i].master = 0;
+		comp[i].cost = comp[i].total = 0;
+	}
+	for ( obj=object_get_first() ; obj!=NULL ; obj=obj->next )
+	{
+		int c = uf_find(obj->id);
+		if ( is_shared(obj) )
+			continue;
+		comp[c].used = 1;
+		comp[c].cost += 1;
+		total += 1;
+	}
+	for ( i=0 ; i<nobj ; i++ )
+	{
+		int up;
+		if ( !comp[i].used )
+			continue;
+		comp[i].total += comp[i].cost;
+		for ( up=comp[i].parent ; up>=0 ; up=comp[up].parent )
+			comp[up].total += comp[i].cost;
+		if ( comp[i].parent>=0 )
+		{
+			comp[i].sibling = comp[comp[i].parent].child;
+			comp[comp[i].parent].child = i;
+		}
+	}
+
+	/* the master keeps the largest tree, which is only known once all totals are in */
+	for ( i=0 ; i<nobj ; i++ )
+	{
+		if ( comp[i].used && comp[i].parent<0 && ( root<0 || comp[i].total>comp[root].total ) )
+			root = i;
+	}
+
+	/* choose the units to pack, splitting subtrees that are too large for one partition */
+	target = total/n;
+	comp[root].master = 1;
+	stack[nstack++] = root;
+	while ( nstack>0 )
+	{
+		int c, top = stack[--nstack];
+		for ( c=comp[top].child ; c>=0 ; c=comp[c].sibling )
+		{
+			if ( comp[c].total>target && comp[c].child>=0 )
+			{
+				comp[c].master = 1;
+				stack[nstack++] = c;
+			}
+			else
+				units[nunits++] = c;
+		}
+	}
+	for ( i=0 ; i<nobj ; i++ )
+	{
+		if ( comp[i].used && comp[i].parent<0 && i!=root )
+			units[nunits++] = i;
+	}
+
+	/* pack units largest first into the least loaded partition */
+	for ( i=0 ; i<n ; i++ )
+		load[i] = 0;
+	for ( i=0 ; i<nobj ; i++ )
+	{
+		if ( comp[i].used && comp[i].master )
+		{
+			comp[i].part = 0;
+			load[0] += comp[i].cost;
+		}
+	}
+	qsort(units,nunits,sizeof(int),cmp_units);
+	for ( i=0 ; i<nunits ; i++ )
+	{
+		int p, best = 0;
+		for ( p=1 ; p<n ; p++ )
+		{
+			if ( load[p]<load[best] )
+				best = p;
+		}
+		comp[units[i]].part = best;
+		load[best] += comp[units[i]].total;
+	}
+
+	/* components below a unit go with the unit */
+	for ( i=0 ; i<nobj ; i++ )
+	{
+		int up, part;
+		if ( !comp[i].used || comp[i].part>=0 )
+			continue;
+		for ( up=i ; comp[up].part<0 ; up=comp[up].parent ) {}
+		part = comp[up].part;
+		for ( up=i ; comp[up].part<0 ; up=comp[up].parent )
+			comp[up].part = part;
+	}
+
+	/* drop empty partitions */
+	nparts = 1;
+	map[0] = 0;
+	for ( i=1 ; i<n ; i++ )
+		map[i] = load[i]>0 ? nparts++ : -1;
+	if ( nparts<n )
+		output_warning("the model only has enough cuts for %d partitions", nparts);
+	if ( nparts<2 )
+	{
+		output_error("partition_model(): no partition_cuts objects found to split the model at");
+		/* TROUBLESHOOT
+			The model could not be partitioned because none of the objects listed in the <b>partition_cuts</b>
+			global variable separate the model into independent parts.  Set <b>partition_cuts</b> to the
+			link classes at which the model can be split, e.g., "transformer,regulator".
+		 */
+		goto Done;
+	}
+	for ( i=0 ; i<nobj ; i++ )
+	{
+		if ( comp[i].used )
+			comp[i].part = map[comp[i].part];
+	}
+	for ( i=0 ; i<n ; i++ )
+	{
+		if ( map[i]>=0 )
+			output_verbose("partition %d has estimated cost %.0f (%.1f%%)", map[i], load[i], load[i]/total*100);
+	}
+
+	/* identify the boundary nodes */
+	for ( cut=cuts ; cut!=NULL ; cut=cut->next )
+	{
+		if ( object_part(cut->link)==object_part(cut->node) )
+			continue;
+		if ( cut->node->name==NULL )
+		{
+			char name[256];
+			sprintf(name,"%s_%d",cut->node->oclass->name,cut->node->id);
+			if ( object_set_name(cut->node,name)==NULL )
+			{
+				output_error("partition_model(): unable to name boundary node %s:%d", cut->node->oclass->name, cut->node->id);
+				goto Done;
+			}
+		}
+		boundary[cut->node->id] = 1;
+	}
+
+	result = save_partitions(nparts,cuts,boundary);
+
+Done:
+	while ( cuts!=NULL )
+	{
+		cut = cuts->next;
+		free(cuts);
+		cuts = cut;
+	}
+	free(uf);
+	free(comp);
+	free(units);
+	free(stack);
+	free(boundary);
+	free(load);
+	free(map);
+	uf = NULL;
+	comp = NULL;
+	return result;
+}
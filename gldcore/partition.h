@@ -0,0 +1,21 @@
+/* partition.h
+ * Copyright (C) 2008 Battelle Memorial Institute
+ * Automatic partitioning of a model into multirun master/slave sub-models.
+ */
+
+#ifndef _PARTITION_H
+#define _PARTITION_H
+
+#include "object.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+STATUS partition_model(int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
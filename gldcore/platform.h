@@ -51,6 +51,11 @@
 	#else
 		#define NATIVE int32	/**< native integer size */
 	#endif
+	#ifdef _MSC_VER
+		#define THREADLOCAL __declspec(thread) /**< thread-local storage class */
+	#else
+		#define THREADLOCAL __thread /**< thread-local storage class */
+	#endif
 	static int64 _qnan = 0xffffffffffffffffLL;
 	#define QNAN (*(double*)&_qnan)
 #endif
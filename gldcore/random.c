@@ -10,6 +10,14 @@
 	a problem, unless you are using the pseudo-random sequences.  In that case, you
 	need to lock the state variable you are using when generating random numbers.
 
+	The counter-based generator (RNG4) uses the Philox4x32-10 block function.  Each
+	draw is a pure function of the seed, the stream key and a counter, so it needs
+	no lock and gives the same sequence regardless of the number of threads.  Streams
+	keyed by (object id, stream number) are available through random_stream_init(),
+	random_stream_unit() and random_stream_fill().  A legacy state given an owner by
+	random_state_init() (as object and randomvar states are) is keyed the same way
+	and only counts its draws, so the states of different owners are independent.
+
  @{
  **/
 
@@ -31,9 +39,11 @@
 #include "lock.h"
 #include "platform.h"
 #include "exec.h"
+#include "threadpool.h"
 
 #ifdef WIN32
 #define finite _finite
+#include <windows.h>
 #include <process.h>
 #define getpid _getpid
 #endif
@@ -74,6 +84,241 @@ inline char* strtok_t(char *str, const char *delim, char **nextp)
 
 static unsigned int *ur_state = NULL;
 
+/* stream being filled by random_stream_fill() on this thread, if any */
+static THREADLOCAL RANDOMSTREAM *fill_stream = NULL;
+
+/* counter for RNG4 draws that have no state of their own */
+static unsigned int ur_counter = 0;
+
+/* owners of legacy states, found by the address of the state (RNG4); tables are
+   only added to, and a grown table replaces the old one only once it is filled in,
+   so that draws can look up their owner without a lock */
+typedef struct s_stateowner {
+	unsigned int *state;
+	unsigned int64 id;
+	unsigned int stream;
+} STATEOWNER;
+typedef struct s_stateownertable {
+	unsigned int size; /* a power of 2 */
+	unsigned int count;
+	STATEOWNER *owner;
+	struct s_stateownertable *old; /* replaced tables, kept for draws still reading them */
+} STATEOWNERTABLE;
+static STATEOWNERTABLE *volatile owner_table = NULL;
+static unsigned int owner_lock = 0;
+#if defined(WIN32) && !defined(__MINGW32__)
+#define owner_barrier() MemoryBarrier()
+#else
+#define owner_barrier() __sync_synchronize()
+#endif
+
+static unsigned int owner_hash(unsigned int *state, unsigned int size)
+{
+	unsigned int64 h = ((unsigned int64)(size_t)state>>2) * 0x9E3779B97F4A7C15ULL;
+	return (unsigned int)(h>>32) & (size-1);
+}
+
+static STATEOWNER *owner_find(STATEOWNERTABLE *table, unsigned int *state)
+{
+	unsigned int n;
+	if ( table==NULL )
+		return NULL;
+	for ( n=owner_hash(state,table->size) ; table->owner[n].state!=NULL ; n=(n+1)&(table->size-1) )
+	{
+		if ( table->owner[n].state==state )
+			return &table->owner[n];
+	}
+	return NULL;
+}
+
+/* add or replace an owner; must be called with the owner lock held */
+static void owner_add(STATEOWNERTABLE *table, unsigned int *state, unsigned int64 id, unsigned int stream)
+{
+	unsigned int n;
+	for ( n=owner_hash(state,table->size) ; table->owner[n].state!=NULL && table->owner[n].state!=state ; n=(n+1)&(table->size-1) ) {}
+	table->owner[n].id = id;
+	table->owner[n].stream = stream;
+	if ( table->owner[n].state==NULL )
+	{
+		/* the key is published before the state that finds it */
+		owner_barrier();
+		table->owner[n].state = state;
+		table->count++;
+	}
+}
+
+/** Philox4x32-10 counter-based block function (Salmon et al., SC'11).
+	Maps a 128-bit counter and a 64-bit key to 128 random bits.
+ **/
+#define PHILOX_M0 0xD2511F53U
+#define PHILOX_M1 0xCD9E8D57U
+#define PHILOX_W0 0x9E3779B9U
+#define PHILOX_W1 0xBB67AE85U
+static void philox(unsigned int ctr[4], unsigned int key[2], unsigned int out[4])
+{
+	unsigned int c0=ctr[0], c1=ctr[1], c2=ctr[2], c3=ctr[3];
+	unsigned int k0=key[0], k1=key[1];
+	int round;
+	for ( round=0 ; round<10 ; round++ )
+	{
+		unsigned int64 p0 = (unsigned int64)PHILOX_M0*c0;
+		unsigned int64 p1 = (unsigned int64)PHILOX_M1*c2;
+		if ( round>0 )
+		{
+			k0 += PHILOX_W0;
+			k1 += PHILOX_W1;
+		}
+		c0 = (unsigned int)(p1>>32)^c1^k0;
+		c1 = (unsigned int)p1;
+		c2 = (unsigned int)(p0>>32)^c3^k1;
+		c3 = (unsigned int)p0;
+	}
+	out[0]=c0; out[1]=c1; out[2]=c2; out[3]=c3;
+}
+
+/* convert the first two words of a block to a 53-bit double in (0,1) */
+static double philox_unit(unsigned int out[4])
+{
+	unsigned int64 x = ((unsigned int64)(out[0]>>5)<<26) | (out[1]>>6);
+	return ((double)x+0.5)/9007199254740992.0;
+}
+
+/* generate the block for a legacy state (RNG4); a NULL state uses the shared counter,
+   and a state with an owner counts in the owner's own stream */
+static void philox_state(unsigned int *state, unsigned int out[4])
+{
+	unsigned int ctr[4], key[2];
+	STATEOWNER *owner;
+	key[0] = global_randomseed;
+	if ( state!=NULL && (owner=owner_find(owner_table,state))!=NULL )
+	{
+		ctr[0] = (*state)++;
+		ctr[1] = 0;
+		ctr[2] = (unsigned int)owner->id;
+		ctr[3] = (unsigned int)(owner->id>>32);
+		key[1] = owner->stream ^ 0x40000000;
+		philox(ctr,key,out);
+		return;
+	}
+	if ( state==NULL )
+	{
+		/* no lock needed, but the order is still up to the threads */
+#if defined(WIN32) && !defined(__MINGW32__)
+		ctr[0] = (unsigned int)_InterlockedIncrement((volatile long*)&ur_counter);
+#else
+		ctr[0] = __sync_add_and_fetch(&ur_counter,1);
+#endif
+		key[1] = 1;
+	}
+	else
+	{
+		ctr[0] = (*state)++;
+		key[1] = 0;
+	}
+	ctr[1] = 0;
+	ctr[2] = ctr[3] = 0xffffffff; /* keeps states without an owner out of the object id space */
+	philox(ctr,key,out);
+}
+
+/** Initialize a counter-based random stream.
+	The stream is keyed on the random seed, the owner id (usually the object id) and
+	the stream number, so each owner can have independent streams that don't depend
+	on the order in which objects are created or synchronized.
+ **/
+void random_stream_init(RANDOMSTREAM *rs, /**< the stream */
+						unsigned int64 id, /**< the stream owner id */
+						unsigned int stream) /**< the stream number */
+{
+	rs->id = id;
+	rs->stream = stream;
+	rs->counter = 0;
+}
+
+/** Draw a uniform number in the range (0,1) from a counter-based stream
+	@return a double with 53 bits of resolution
+ **/
+double random_stream_unit(RANDOMSTREAM *rs)
+{
+	unsigned int ctr[4], key[2], out[4];
+	ctr[0] = (unsigned int)rs->counter;
+	ctr[1] = (unsigned int)(rs->counter>>32);
+	ctr[2] = (unsigned int)rs->id;
+	ctr[3] = (unsigned int)(rs->id>>32);
+	key[0] = global_randomseed;
+	key[1] = rs->stream;
+	rs->counter++;
+	philox(ctr,key,out);
+	return philox_unit(out);
+}
+
+/** Get a 32-bit initial state for a legacy RNG state owned by id.
+	With RNG4 the state depends only on the seed and id; otherwise it is
+	drawn from the shared generator as before.
+ **/
+unsigned int random_stream_seed(unsigned int64 id, /**< the state owner id */
+								unsigned int stream) /**< the stream number */
+{
+	if ( global_randomnumbergenerator==RNG4 )
+	{
+		unsigned int ctr[4], key[2], out[4];
+		ctr[0] = ctr[1] = 0;
+		ctr[2] = (unsigned int)id;
+		ctr[3] = (unsigned int)(id>>32);
+		key[0] = global_randomseed;
+		key[1] = stream ^ 0x80000000;
+		philox(ctr,key,out);
+		return out[0];
+	}
+	else
+		return randwarn(NULL);
+}
+
+/** Initialize a legacy RNG state owned by id.
+	The state is set as by random_stream_seed().  With RNG4 the draws made with the
+	state are keyed on the owner id and stream number, so the sequences of two owners
+	are independent rather than windows of the same sequence.
+	@return 1 on success, 0 if the owner could not be recorded
+ **/
+int random_state_init(unsigned int *state, /**< the state */
+					  unsigned int64 id, /**< the state owner id */
+					  unsigned int stream) /**< the stream number */
+{
+	STATEOWNERTABLE *table;
+	*state = random_stream_seed(id,stream);
+	wlock(&owner_lock);
+	table = owner_table;
+	if ( table==NULL || (table->count+1)*2>table->size )
+	{
+		/* grow the table and copy the owners in before it is used */
+		STATEOWNERTABLE *grow = (STATEOWNERTABLE*)malloc(sizeof(STATEOWNERTABLE));
+		unsigned int n;
+		if ( grow==NULL || (grow->owner=(STATEOWNER*)calloc(table?table->size*2:1024,sizeof(STATEOWNER)))==NULL )
+		{
+			wunlock(&owner_lock);
+			free(grow);
+			output_error("random_state_init(): memory allocation failed");
+			/* TROUBLESHOOT
+				The owner of a random number generator state could not be recorded.
+				Free up memory and try again.
+			 */
+			return 0;
+		}
+		grow->size = table ? table->size*2 : 1024;
+		grow->count = 0;
+		grow->old = table;
+		for ( n=0 ; table!=NULL && n<table->size ; n++ )
+		{
+			if ( table->owner[n].state!=NULL )
+				owner_add(grow,table->owner[n].state,table->owner[n].id,table->owner[n].stream);
+		}
+		owner_barrier();
+		owner_table = table = grow;
+	}
+	owner_add(table,state,id,stream);
+	wunlock(&owner_lock);
+	return 1;
+}
+
 unsigned entropy_source(void)
 {
 	struct timeval t;
@@ -144,13 +389,20 @@ int random_nargs(char *name)
 int randwarn(unsigned int *state)
 {
 	static int warned=0;
-	if (global_nondeterminism_warning && !warned)
+	if (global_nondeterminism_warning && !warned && ( global_randomnumbergenerator!=RNG4 || state==NULL ) )
 	{
 		warned=1;
 		output_warning("non-deterministic behavior probable--rand was called while running multiple threads");
 	}
 	
-	if ( global_randomnumbergenerator==RNG2 )
+	if ( global_randomnumbergenerator==RNG4 )
+	{
+		/* counter-based (RNG4) - state is the counter */
+		unsigned int out[4];
+		philox_state(state,out);
+		return (out[0]>>17)&0x7fff;
+	}
+	else if ( global_randomnumbergenerator==RNG2 )
 	{
 		/* use the stdc (RNG2) rand functions */
 		if ( state!=NULL )
@@ -211,6 +463,24 @@ double randunit(unsigned int *state)
 	unsigned int ur;
 	static int random_lock=0;
 
+	/* stream being filled by random_stream_fill() */
+	if ( fill_stream!=NULL && state==&(fill_stream->stream) )
+		return random_stream_unit(fill_stream);
+
+	/* counter-based needs no lock and has no boundary values to retry */
+	if ( global_randomnumbergenerator==RNG4 )
+	{
+		unsigned int out[4];
+		static int warned=0;
+		if ( state==NULL && global_nondeterminism_warning && !warned )
+		{
+			warned=1;
+			output_warning("non-deterministic behavior probable--rand was called while running multiple threads");
+		}
+		philox_state(state==ur_state?NULL:state,out);
+		return philox_unit(out);
+	}
+
 	if ( state==NULL || state==ur_state )
 	{
 		state=ur_state;
@@ -781,6 +1051,48 @@ double pseudorandom_value(RANDOMTYPE type, /**< the type of distribution desired
 	return x;
 }
 
+/* draw a single value from a counter-based stream */
+static double _random_value_stream(RANDOMSTREAM *rs, RANDOMTYPE type, ...)
+{
+	double x;
+	va_list ptr;
+	RANDOMSTREAM *old = fill_stream;
+	va_start(ptr,type);
+	fill_stream = rs;
+	x = _random_value(type,&(rs->stream),ptr);
+	fill_stream = old;
+	va_end(ptr);
+	return x;
+}
+
+/** Fill an array with samples from a counter-based stream.
+	Accepts the same distributions and parameters as random_value().  The samples
+	depend only on the seed, the stream key and the stream counter, so the same
+	stream gives the same samples on any number of threads.
+	@return the number of samples generated
+ **/
+int random_stream_fill(RANDOMSTREAM *rs, /**< the stream */
+					   RANDOMTYPE type, /**< the type of distribution desired */
+					   double *sample, /**< the array to fill */
+					   unsigned int count, /**< the number of samples */
+					   ...) /**< the distribution's parameters */
+{
+	unsigned int n;
+	va_list ptr, arg;
+	RANDOMSTREAM *old = fill_stream;
+	va_start(ptr,count);
+	fill_stream = rs;
+	for ( n=0 ; n<count ; n++ )
+	{
+		va_copy(arg,ptr);
+		sample[n] = _random_value(type,&(rs->stream),arg);
+		va_end(arg);
+	}
+	fill_stream = old;
+	va_end(ptr);
+	return n;
+}
+
 /******************************************************************************/
 static double mean(double sample[], unsigned int count)
 {
@@ -1108,6 +1420,60 @@ int random_test(void)
 	else
 		output_test("Modulus = %d", count);
 
+	/* test counter-based generator against Philox4x32-10 known answers */
+	output_test("\nTesting Philox4x32-10 known answers");
+	{
+		unsigned int ctr0[4]={0,0,0,0}, key0[2]={0,0}, ans0[4]={0x6627e8d5,0xe169c58d,0xbc57ac4c,0x9b00dbd8};
+		unsigned int ctr1[4]={0xffffffff,0xffffffff,0xffffffff,0xffffffff}, key1[2]={0xffffffff,0xffffffff}, ans1[4]={0x408f276d,0x41c83b0e,0xa20bc7c6,0x6d5451fd};
+		unsigned int out[4];
+		philox(ctr0,key0,out);
+		if ( memcmp(out,ans0,sizeof(out))!=0 )
+			failed++,output_test("Philox block 0 did not match (%08x %08x %08x %08x)",out[0],out[1],out[2],out[3]);
+		philox(ctr1,key1,out);
+		if ( memcmp(out,ans1,sizeof(out))!=0 )
+			failed++,output_test("Philox block 1 did not match (%08x %08x %08x %08x)",out[0],out[1],out[2],out[3]);
+	}
+
+	/* test counter-based streams are reproducible */
+	count = 1000;
+	output_test("\nDeterministic test for counter-based streams (N=%d)",count);
+	{
+		RANDOMSTREAM rs;
+		random_stream_init(&rs,1,0);
+		random_stream_fill(&rs,RT_NORMAL,sample,count,0.0,1.0);
+		random_stream_init(&rs,1,0);
+		for (i=0; i<count; i++)
+		{
+			double v = _random_value_stream(&rs,RT_NORMAL,0.0,1.0);
+			if (sample[i] != v)
+				failed++,output_test("Sample %d did not match (%f!=%f)", i, sample[i],v);
+		}
+		if ( rs.counter==0 )
+			failed++,output_test("Stream counter did not advance");
+	}
+
+	/* test owned legacy states are not windows of one sequence */
+	output_test("\nIndependence test for owned legacy states (N=%d)",count);
+	{
+		static unsigned int a, b; /* owned states must outlive the test */
+		int rng = global_randomnumbergenerator, shifted = 0;
+		global_randomnumbergenerator = RNG4;
+		random_state_init(&a,1,0);
+		random_state_init(&b,2,0);
+		a = 100;
+		b = 101;
+		for (i=0; i<count; i++)
+			sample[i] = randunit(&a);
+		for (i=0; i<count-1; i++)
+		{
+			if ( randunit(&b)==sample[i+1] )
+				shifted++;
+		}
+		if ( shifted>0 )
+			failed++,output_test("%d draws of the second state repeat the first state",shifted);
+		global_randomnumbergenerator = rng;
+	}
+
 	/* report results */
 	if (failed)
 	{
@@ -1128,6 +1494,8 @@ int random_test(void)
 
 static randomvar *randomvar_list = NULL;
 static unsigned int n_randomvars = 0;
+static randomvar **randomvar_item = NULL; /* variables indexed for the sync task */
+static TPTASK randomvar_task;
 clock_t randomvar_synctime = 0;
 
 int convert_to_randomvar(char *string, void *data, PROPERTY *prop)
@@ -1261,7 +1629,7 @@ int randomvar_create(randomvar *var)
 {
 	memset(var,0,sizeof(randomvar));
 	var->next = randomvar_list;
-	var->state = randwarn(NULL);
+	random_state_init(&(var->state),n_randomvars,1); /* stream 1 keeps randomvars apart from objects */
 	randomvar_list = var;
 	n_randomvars++;
 	return 1;
@@ -1326,23 +1694,63 @@ size_t randomvar_getspec(char *str, size_t size, const randomvar *var)
 		return 0;
 }
 
-TIMESTAMP randomvar_syncall(TIMESTAMP t1)
+static TIMESTAMP randomvar_synccall(TPTASK *task, unsigned int first, unsigned int last, unsigned int thread)
 {
-	if ( randomvar_list )
+	randomvar **var = (randomvar**)task->data;
+	TIMESTAMP t2 = TS_NEVER;
+	unsigned int n;
+	for ( n=first ; n<last ; n++ )
+	{
+		TIMESTAMP t3 = randomvar_sync(var[n],task->t1);
+		if ( absolute_timestamp(t3)<absolute_timestamp(t2) ) t2 = t3;
+	}
+	return t2;
+}
+
+/** Get the pool task that updates the random variables at the time given
+	@return the task, or NULL if there are no random variables
+	Each variable draws from its own state, so the variables may be updated in any order.
+ **/
+TPTASK *randomvar_synctask(TIMESTAMP t1)
+{
+	if ( randomvar_list==NULL )
+		return NULL;
+
+	/* index the variables on first use */
+	if ( randomvar_item==NULL )
 	{
 		randomvar *var;
-		TIMESTAMP t2 = TS_NEVER;
-		clock_t ts = (clock_t)exec_clock();
-		for (var=randomvar_list; var!=NULL; var=var->next)
-		{
-			TIMESTAMP t3 = randomvar_sync(var,t1);
-			if ( absolute_timestamp(t3)<absolute_timestamp(t2) ) t2 = t3;
-		}
-		randomvar_synctime += (clock_t)exec_clock() - ts;
-		return t2!=TS_NEVER ? -absolute_timestamp(t2) : TS_NEVER;
+		unsigned int n = 0;
+		randomvar_item = (randomvar**)malloc(sizeof(randomvar*)*n_randomvars);
+		if ( randomvar_item==NULL )
+			throw_exception("randomvar_synctask(): memory allocation failed");
+			/* TROUBLESHOOT
+				The random variable list used by the sync task could not be allocated.
+				Free up memory and try again.
+			 */
+		for ( var=randomvar_list ; var!=NULL && n<n_randomvars ; var=var->next )
+			randomvar_item[n++] = var;
+		memset(&randomvar_task,0,sizeof(randomvar_task));
+		randomvar_task.name = "randomvar";
+		randomvar_task.call = randomvar_synccall;
+		randomvar_task.data = (void*)randomvar_item;
+		randomvar_task.n_items = n;
+		randomvar_task.grain = 16;
 	}
-	else
+	randomvar_task.t1 = t1;
+	randomvar_task.runtime = 0;
+	return &randomvar_task;
+}
+
+/** Collect the result of the random variable sync task
+	@return the next update as a soft event
+ **/
+TIMESTAMP randomvar_syncdone(TPTASK *task)
+{
+	if ( task==NULL )
 		return TS_NEVER;
+	randomvar_synctime += task->runtime;
+	return task->t2!=TS_NEVER ? -absolute_timestamp(task->t2) : TS_NEVER;
 }
 
 double random_get_part(void *x, char *name)
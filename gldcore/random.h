@@ -30,6 +30,13 @@ typedef enum {
 	RT_TRIANGLE,	/**< Triangle distribution; double a, double b */
 } RANDOMTYPE;
 
+/** Counter-based random stream (see RNG4) */
+typedef struct s_randomstream {
+	unsigned int64 id; /**< stream owner id (usually the object id) */
+	unsigned int stream; /**< stream number within the owner */
+	unsigned int64 counter; /**< number of draws made so far */
+} RANDOMSTREAM;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -57,6 +64,11 @@ extern "C" {
 	int random_nargs(char *name);
 	double random_value(RANDOMTYPE type, ...);
 	double pseudorandom_value(RANDOMTYPE, unsigned int *state, ...);
+	void random_stream_init(RANDOMSTREAM *rs, unsigned int64 id, unsigned int stream);
+	double random_stream_unit(RANDOMSTREAM *rs);
+	int random_stream_fill(RANDOMSTREAM *rs, RANDOMTYPE type, double *sample, unsigned int count, ...);
+	unsigned int random_stream_seed(unsigned int64 id, unsigned int stream);
+	int random_state_init(unsigned int *state, unsigned int64 id, unsigned int stream);
 #ifdef __cplusplus
 }
 #endif
@@ -81,7 +93,8 @@ int randomvar_create(randomvar *var);
 int randomvar_init(randomvar *var);
 int randomvar_initall(void);
 TIMESTAMP randomvar_sync(randomvar *var, TIMESTAMP t1);
-TIMESTAMP randomvar_syncall(TIMESTAMP t1);
+struct s_tptask *randomvar_synctask(TIMESTAMP t1);
+TIMESTAMP randomvar_syncdone(struct s_tptask *task);
 int convert_to_randomvar(char *string, void *data, PROPERTY *prop);
 int convert_from_randomvar(char *string,int size,void *data, PROPERTY *prop);
 unsigned int64 random_id(void);
@@ -21,6 +21,7 @@
 #include "exception.h"
 #include "lock.h"
 #include "exec.h"
+#include "threadpool.h"
 
 static SCHEDULE *schedule_list = NULL;
 static uint32 n_schedules = 0;
@@ -181,7 +182,7 @@ int find_value_index (SCHEDULE *sch, /// schedule to search
 
 int schedule_compile_block(SCHEDULE *sch, char *blockname, char *blockdef)
 {
-	char *token = NULL;
+	char *token = NULL, *last = NULL;
 	unsigned int minute=0;
 
 	/* check block count */
@@ -196,7 +197,8 @@ int schedule_compile_block(SCHEDULE *sch, char *blockname, char *blockdef)
 
 	/* first index is always default value 0 */
 	sch->count[sch->block]=1;
-	while ( (token=strtok(token==NULL?blockdef:NULL,";\r\n"))!=NULL )
+	/* deferred creations compile schedules on several threads at once */
+	while ( (token=strtok_s(token==NULL?blockdef:NULL,";\r\n",&last))!=NULL )
 	{
 		struct {
 			char *name;
@@ -908,11 +910,11 @@ int schedule_normalize(SCHEDULE *sch,	/**< the schedule to normalize */
 SCHEDULEINDEX schedule_index(SCHEDULE *sch, TIMESTAMP ts)
 {
 	SCHEDULEINDEX ref = 0;
-	DATETIME dt;
+	CALENDARCONTEXT ctx;
 	unsigned int cal, min;
 	
 	/* determine the local time */
-	if (!local_datetime(ts,&dt))
+	if (!local_calendar(ts,&ctx))
 	{
 		throw_exception("schedule_read(SCHEDULE *schedule={name='%s',...}, TIMESTAMP ts=%"FMT_INT64"d) unable to determine local time", sch->name, ts);
 		/* TROUBLESHOOT
@@ -921,11 +923,9 @@ SCHEDULEINDEX schedule_index(SCHEDULE *sch, TIMESTAMP ts)
 		 */
 	}
 
-	/* determine which calendar is used based on the weekday of Jan 1 and LY status */
-	cal = ((dt.weekday-dt.yearday+53*7)%7)*2 + ISLEAPYEAR(dt.year);
-
-	/* compute the minute of year */
-	min=(dt.yearday*24 + dt.hour)*60 + dt.minute;
+	/* calendar and minute of year */
+	cal = ctx.calendar;
+	min = ctx.minute;
 
 	if ( cal>=14 || min>=60*24*366 )
 		output_error("schedule_index(): timestamp %" FMT_INT64 "d has calendar %d minute %d which is invalid", ts, cal, min);
@@ -1058,201 +1058,83 @@ TIMESTAMP schedule_sync(SCHEDULE *sch, /**< the schedule that is to be synchroni
 	return sch->next_t;
 }
 
-typedef struct s_schedulesyncdata {
-	unsigned int n;
-	pthread_t pt;
-	bool ok;
-	SCHEDULE *sch;
-	unsigned int nsch;
-	TIMESTAMP t0;
-} SCHEDULESYNCDATA;
-
-static pthread_cond_t start_sch = PTHREAD_COND_INITIALIZER;
-static pthread_mutex_t startlock_sch = PTHREAD_MUTEX_INITIALIZER;
-static pthread_cond_t done_sch = PTHREAD_COND_INITIALIZER;
-static pthread_mutex_t donelock_sch = PTHREAD_MUTEX_INITIALIZER;
-static TIMESTAMP next_t1_sch;
+static SCHEDULE **schedule_item = NULL; /* schedules indexed for the sync task */
+static TPTASK schedule_task;
 static TIMESTAMP next_t2_sch = TS_ZERO;
-static unsigned int donecount_sch;
 
 clock_t schedule_synctime = 0;
 
-void *schedule_syncproc(void *ptr)
+static TIMESTAMP schedule_synccall(TPTASK *task, unsigned int first, unsigned int last, unsigned int thread)
 {
-	SCHEDULESYNCDATA *data = (SCHEDULESYNCDATA*)ptr;
-	SCHEDULE *sch;
+	SCHEDULE **sch = (SCHEDULE**)task->data;
+	TIMESTAMP t2 = TS_NEVER;
 	unsigned int n;
-	TIMESTAMP t2;
-
-	// begin processing loop
-	while ( data->ok )
+	for ( n=first ; n<last ; n++ )
 	{
-		// lock access to start condition
-		pthread_mutex_lock(&startlock_sch);
-
-		// wait for thread start condition
-		while (data->t0==next_t1_sch) 
-			pthread_cond_wait(&start_sch,&startlock_sch);
-		
-		// unlock access to start count
-		pthread_mutex_unlock(&startlock_sch);
-
-		// process the list for this thread
-		t2 = TS_NEVER;
-		for ( sch=data->sch, n=0 ; sch!=NULL, n<data->nsch ; sch=sch->next, n++ )
-		{
-			TIMESTAMP t = schedule_sync(sch,next_t1_sch);
-			if (t<t2) t2 = t;
-		}
-
-		// signal completed condition
-		data->t0 = next_t1_sch;
-
-		// lock access to done condition
-		pthread_mutex_lock(&donelock_sch);
-
-		// signal thread is done for now
-		donecount_sch--;
-		if ( t2<next_t2_sch ) next_t2_sch = t2;
-
-		// signal change in done condition
-		pthread_cond_broadcast(&done_sch);
-
-		// unlock access to done count
-		pthread_mutex_unlock(&donelock_sch);
+		TIMESTAMP t = schedule_sync(sch[n],task->t1);
+		if (t<t2) t2 = t;
 	}
-	pthread_exit((void*)0);
-	return (void*)0;
+	return t2;
 }
 
-/** synchronized all the schedules to the time given
-    @return the time of the next schedule change
+/** get the pool task that synchronizes all the schedules to the time given
+    @return the task, or NULL if no schedule needs to be synchronized
  **/
-TIMESTAMP schedule_syncall(TIMESTAMP t1) /**< the time to which the schedule is synchronized */
+TPTASK *schedule_synctask(TIMESTAMP t1) /**< the time to which the schedules are synchronized */
 {
-	static unsigned int n_threads_sch=0;
-	static SCHEDULESYNCDATA *thread_sch = NULL;
-	TIMESTAMP t2 = TS_NEVER;
-	clock_t ts = (clock_t)exec_clock();
-
-	// skip schedule_syncall if there's no schedule in the glm
+	// skip schedule sync if there's no schedule in the glm
 	if (n_schedules == 0)
-		return TS_NEVER;
-
+		return NULL;
 
-	// number of threads desired
-	if (n_threads_sch==0) 
+	// index the schedules on first use
+	if (schedule_item==NULL)
 	{
 		SCHEDULE *sch;
-		int n_items, schn=0;
-
-		output_debug("loadshape_syncall setting up for %d shapes", n_schedules);
-
-		// determine needed threads
-		n_threads_sch = global_threadcount;
-		if (n_threads_sch>1)
-		{
-			unsigned int n;
-			if (n_schedules<n_threads_sch*4)
-				n_threads_sch = n_schedules/4;
-
-			// only need 1 thread if n_schedules is less than 4
-			if (n_threads_sch == 0)
-				n_threads_sch = 1;
-
-			// determine shapes per thread
-			n_items = n_schedules/n_threads_sch;
-			n_threads_sch = n_schedules/n_items;
-			if (n_threads_sch*n_items<n_schedules) // not enough slots yet
-				n_threads_sch++; // add one underused threads
-
-			output_debug("schedule_syncall is using %d of %d available threads", n_threads_sch, global_threadcount);
-			output_debug("schedule_syncall is assigning %d shapes per thread", n_items);
-
-			// allocate thread list
-			thread_sch = (SCHEDULESYNCDATA*)malloc(sizeof(SCHEDULESYNCDATA)*n_threads_sch);
-			memset(thread_sch,0,sizeof(SCHEDULESYNCDATA)*n_threads_sch);
-
-			// assign starting shape for each thread
-			for (sch=schedule_list; sch!=NULL; sch=sch->next)
-			{
-				if (thread_sch[schn].nsch==n_items)
-					schn++;
-				if (thread_sch[schn].nsch==0)
-					thread_sch[schn].sch = sch;
-				thread_sch[schn].nsch++;
-			}
-
-			// create threads
-			for (n=0; n<n_threads_sch; n++)
-			{
-				thread_sch[n].ok = true;
-				if ( pthread_create(&(thread_sch[n].pt),NULL,schedule_syncproc,&(thread_sch[n]))!=0 )
-				{
-					output_fatal("loadshape_sync thread creation failed");
-					thread_sch[n].ok = false;
-				}
-				else
-					thread_sch[n].n = n;
-			}
-		}
+		unsigned int n = 0;
+		output_debug("schedule_synctask setting up for %d schedules", n_schedules);
+		schedule_item = (SCHEDULE**)malloc(sizeof(SCHEDULE*)*n_schedules);
+		if (schedule_item==NULL)
+			throw_exception("schedule_synctask(): memory allocation failed");
+			/* TROUBLESHOOT
+				The schedule list used by the sync task could not be allocated.
+				Free up memory and try again.
+			 */
+		for (sch=schedule_list; sch!=NULL && n<n_schedules; sch=sch->next)
+			schedule_item[n++] = sch;
+		memset(&schedule_task,0,sizeof(schedule_task));
+		schedule_task.name = "schedule";
+		schedule_task.call = schedule_synccall;
+		schedule_task.data = (void*)schedule_item;
+		schedule_task.n_items = n;
+		schedule_task.grain = 4;
 	}
 
 	// don't update if no schedules ever expect to change again
 	if (next_t2_sch == TS_NEVER)
-		return TS_NEVER;
+		return NULL;
 
 	// don't update if next_t2 < next_t1, but override this if there are interpolated schedules
 	if (next_t2_sch > t1 && !interpolated_schedules)
-		return next_t2_sch;
-
-	// no threading required
-	if (n_threads_sch<2) 
-	{
-		// process list directly
-		SCHEDULE *sch;
-		for (sch=schedule_list; sch!=NULL; sch=sch->next)
-		{
-			TIMESTAMP t3 = schedule_sync(sch,t1);
-			if (t3<t2) t2 = t3;
-		}
-		next_t2_sch = t2;
-	}
-	else
-	{
-		// lock access to done count
-		pthread_mutex_lock(&donelock_sch);
-
-		// initialize wait count
-		donecount_sch = n_threads_sch;
-
-		// lock access to start condition
-		pthread_mutex_lock(&startlock_sch);
-
-		// update start condition
-		next_t1_sch = t1;
-		next_t2_sch = TS_NEVER;
-
-		// signal all the threads
-		pthread_cond_broadcast(&start_sch);
-
-		// unlock access to start count
-		pthread_mutex_unlock(&startlock_sch);
-
-		// begin wait
-		while (donecount_sch>0) 
-			pthread_cond_wait(&done_sch,&donelock_sch);
-		output_debug("passed donecount==0 condition");
+		return NULL;
 
-		// unlock done count
-		pthread_mutex_unlock(&donelock_sch);
+	schedule_task.t1 = t1;
+	schedule_task.runtime = 0;
+	return &schedule_task;
+}
 
-		// process results from all threads
-		if (next_t2_sch<t2) t2=next_t2_sch;
+/** collect the result of the schedule sync task, if it ran
+    @return the time of the next schedule change
+ **/
+TIMESTAMP schedule_syncdone(TPTASK *task) /**< the task returned by schedule_synctask() */
+{
+	if (n_schedules == 0)
+		return TS_NEVER;
+	if (task!=NULL)
+	{
+		next_t2_sch = task->t2;
+		schedule_synctime += task->runtime;
 	}
-
-	schedule_synctime += (clock_t)exec_clock() - ts;
-	return t2;
+	return next_t2_sch;
 }
 
 int schedule_test(void)
@@ -106,7 +106,8 @@ SCHEDULEINDEX schedule_index(SCHEDULE *sch, TIMESTAMP ts);
 double schedule_value(SCHEDULE *sch, SCHEDULEINDEX index);
 int32 schedule_dtnext(SCHEDULE *sch, SCHEDULEINDEX index);
 TIMESTAMP schedule_sync(SCHEDULE *sch, TIMESTAMP t);
-TIMESTAMP schedule_syncall(TIMESTAMP t);
+struct s_tptask *schedule_synctask(TIMESTAMP t);
+TIMESTAMP schedule_syncdone(struct s_tptask *task);
 int schedule_test(void);
 void schedule_dump(SCHEDULE *sch, char *file, char *mode);
 void schedule_dumpall(char *file);
@@ -20,11 +20,19 @@
 #define SOCKET int
 #define INVALID_SOCKET (-1)
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <fcntl.h>
+#define USE_EPOLL /**< event-driven server loop is available */
+#endif
+
 #endif
 
 #include <memory.h>
 #include <string.h>
 #include <errno.h>
+#include <stdint.h>
 #include <pthread.h>
 
 #include "server.h"
@@ -103,6 +111,9 @@ static size_t recv_data(SOCKET s,char *buffer, size_t len)
 #endif
 }
 
+#ifdef USE_EPOLL
+static void *server_routine(void *arg); /* event-driven version is implemented after the request handlers */
+#else
 /** Main server wait loop 
     @returns a pointer to the status flag
  **/
@@ -118,7 +129,7 @@ static void *server_routine(void *arg)
 		return NULL;
 	}
 	started = 1;
-	sockfd = (SOCKET)arg;
+	sockfd = (SOCKET)(intptr_t)arg;
 	// repeat forever..
 	while (!shutdown_server)
 	{
@@ -143,7 +154,7 @@ static void *server_routine(void *arg)
 			output_verbose("accepting incoming connection from on port %d",cli_addr.sin_port);
 #endif
 
-			if ( pthread_create(&thread_id,NULL, http_response,(void*)newsockfd)!=0 )
+			if ( pthread_create(&thread_id,NULL, http_response,(void*)(intptr_t)newsockfd)!=0 )
 				output_error("unable to start http response thread");
 			if (global_server_quit_on_close)
 				shutdown_now();
@@ -166,6 +177,7 @@ Done:
 	started = 0;
 	return (void*)&status;
 }
+#endif
 
 /** Start accepting incoming connections on the designated server socket
 	@returns SUCCESS/FAILED status code
@@ -247,7 +259,7 @@ Retry:
 	global_server_portnum = portNumber;
 
 	/* start the server thread */
-	if (pthread_create(&thread,NULL,server_routine,(void*)sockfd))
+	if (pthread_create(&thread,NULL,server_routine,(void*)(intptr_t)sockfd))
 	{
 		output_error("server thread startup failed: %s",strerror(GetLastError()));
 		return FAILED;
@@ -272,14 +284,37 @@ STATUS server_join(void)
  HTTPCNX routines
  */
 
+typedef struct s_httpsub {
+	OBJECT *obj; /**< object subscribed to (NULL for a global variable) */
+	char name[1024]; /**< property or global variable name */
+	char value[1024]; /**< last value sent to the client */
+	struct s_httpsub *next;
+} HTTPSUB;
+
 typedef struct s_httpcnx {
-	char query[1024];
-	char *buffer;
+	char *query; /**< incoming request buffer (may hold more than one pipelined request) */
+	size_t qlen;
+	size_t qmax;
+	char *buffer; /**< outgoing response content */
 	size_t len;
 	size_t max;
 	char *status;
 	char *type;
+	int keep_alive; /**< connection persists after the response is sent */
+	HTTPSUB *subscription; /**< values streamed to the client on each timestep */
+	int fresh; /**< the first event, which reports every subscribed value, is not posted yet (protected by stream_lock) */
+	char *pending; /**< event stream data waiting to be sent (protected by stream_lock) */
+	size_t plen;
+	size_t pmax;
+	char *output; /**< response data the socket has not accepted yet (bytes ostart to olen) */
+	size_t ostart;
+	size_t olen;
+	size_t omax;
+	int closing; /**< connection closes as soon as its output is sent */
+	int busy; /**< a request is running on a worker thread */
+	int events; /**< events the server loop waits for on the connection */
 	SOCKET s;
+	struct s_httpcnx *next; /**< next connection in the event stream list */
 } HTTPCNX;
 
 /** Create an HTTPCNX connection handle
@@ -288,13 +323,43 @@ typedef struct s_httpcnx {
 static HTTPCNX *http_create(SOCKET s)
 {
 	HTTPCNX *http = (HTTPCNX*)malloc(sizeof(HTTPCNX));
+	if ( http==NULL )
+		return NULL;
 	memset(http,0,sizeof(HTTPCNX));
 	http->s = s;
 	http->max = 4096;
 	http->buffer = malloc(http->max);
+	http->qmax = 4096;
+	http->query = malloc(http->qmax);
+	if ( http->buffer==NULL || http->query==NULL )
+	{
+		free(http->buffer);
+		free(http->query);
+		free(http);
+		return NULL;
+	}
+	http->query[0] = '\0';
 	return http;
 }
 
+/** Destroy an HTTPCNX connection handle
+	@returns Nothing
+ **/
+static void http_destroy(HTTPCNX *http)
+{
+	while ( http->subscription!=NULL )
+	{
+		HTTPSUB *next = http->subscription->next;
+		free(http->subscription);
+		http->subscription = next;
+	}
+	free(http->pending);
+	free(http->output);
+	free(http->query);
+	free(http->buffer);
+	free(http);
+}
+
 /** Reset an HTTPCNX connection handle
 
 	This function clears the contents of HTTPCNX connection block so that it can be reused to handle a new message.
@@ -360,6 +425,99 @@ static void http_type(HTTPCNX *http, char *type)
 {
 	http->type = type;
 }
+#ifdef USE_EPOLL
+#define MAXOUTPUT (1<<24) /**< most unsent output a connection may hold before it is dropped */
+static int epfd = -1; /**< epoll instance of the server loop */
+
+/** Set the events the server loop waits for on a connection
+	@returns Nothing
+ **/
+static void http_watch(HTTPCNX *http)
+{
+	struct epoll_event ev;
+	int events = (http->closing ? 0 : EPOLLIN) | (http->olen>http->ostart ? EPOLLOUT : 0);
+	if ( events==http->events || http->s==INVALID_SOCKET )
+		return;
+	memset(&ev,0,sizeof(ev));
+	ev.events = events;
+	ev.data.ptr = http;
+	if ( epoll_ctl(epfd,EPOLL_CTL_MOD,http->s,&ev)==0 )
+		http->events = events;
+}
+
+/** Send as much of the queued output of a connection as the socket accepts without blocking
+	@returns non-zero on success, 0 if the connection failed
+ **/
+static int http_drain(HTTPCNX *http)
+{
+	while ( http->olen>http->ostart )
+	{
+		ssize_t len = send(http->s,http->output+http->ostart,http->olen-http->ostart,MSG_NOSIGNAL);
+		if ( len<0 )
+		{
+			if ( errno==EINTR )
+				continue;
+			if ( errno==EAGAIN || errno==EWOULDBLOCK )
+				break;
+			return 0;
+		}
+		http->ostart += len;
+	}
+	if ( http->ostart==http->olen )
+		http->ostart = http->olen = 0;
+	http_watch(http);
+	return 1;
+}
+#endif
+
+/** Send data to the client of a connection
+
+	The server loop never waits on a client: data the socket does not accept
+	right away is queued and sent when the socket becomes writable again.
+	@returns non-zero on success, 0 on failure (the connection should be closed)
+ **/
+static int http_output(HTTPCNX *http, char *data, size_t len)
+{
+#ifdef USE_EPOLL
+	if ( http->olen-http->ostart+len>MAXOUTPUT )
+	{
+		output_error("socket %d is not reading its responses, dropping connection", http->s);
+		http->ostart = http->olen = 0;
+		http->keep_alive = 0;
+		return 0;
+	}
+	if ( http->olen+len>http->omax )
+	{
+		char *output;
+		size_t max = http->omax>0 ? http->omax : 4096;
+		memmove(http->output,http->output+http->ostart,http->olen-http->ostart);
+		http->olen -= http->ostart;
+		http->ostart = 0;
+		while ( http->olen+len>max ) max *= 2;
+		output = (char*)realloc(http->output,max);
+		if ( output==NULL )
+		{
+			output_error("unable to extend output buffer for socket %d", http->s);
+			http->keep_alive = 0;
+			return 0;
+		}
+		http->output = output;
+		http->omax = max;
+	}
+	memcpy(http->output+http->olen,data,len);
+	http->olen += len;
+	if ( !http_drain(http) )
+	{
+		http->ostart = http->olen = 0;
+		http->keep_alive = 0;
+		return 0;
+	}
+	return 1;
+#else
+	return send_data(http->s,data,len)==len;
+#endif
+}
+
 /** Send the HTTPCNX response **/
 static void http_send(HTTPCNX *http)
 {
@@ -373,10 +531,10 @@ static void http_send(HTTPCNX *http)
 	len += sprintf(header+len, "Cache-Control: no-cache\n");
 	len += sprintf(header+len, "Cache-Control: no-store\n");
 	len += sprintf(header+len, "Expires: -1\n");
+	len += sprintf(header+len, "Connection: %s\n", http->keep_alive?"keep-alive":"close");
 	len += sprintf(header+len,"\n");
-	send_data(http->s,header,len);
-	if (http->len>0)
-		send_data(http->s,http->buffer,http->len);
+	if ( http_output(http,header,len) && http->len>0 )
+		http_output(http,http->buffer,http->len);
 	http->len = 0;
 }
 /** Write the contents of the HTTPCNX message buffer **/
@@ -405,6 +563,8 @@ static void http_write(HTTPCNX *http, char *data, size_t len)
 /** Close the HTTPCNX connection after sending content **/
 static void http_close(HTTPCNX *http)
 {
+	if (http->s==INVALID_SOCKET)
+		return;
 	if (http->len>0)
 		http_send(http);
 #ifdef WIN32
@@ -412,6 +572,7 @@ static void http_close(HTTPCNX *http)
 #else
 	close(http->s);
 #endif
+	http->s = INVALID_SOCKET;
 }
 /** Set the response MIME type **/
 static void http_mime(HTTPCNX *http, char *path)
@@ -518,17 +679,28 @@ void http_decode(char *buffer)
 	strcpy(buffer,result);
 }
 
-/** Process an incoming XML data request
-	@returns non-zero on success, 0 on failure (errno set)
+/** Locate the object named in a request, either by name or by \p class:id
+	@returns a pointer to the object, or NULL if not found
  **/
-int http_xml_request(HTTPCNX *http,char *uri)
+static OBJECT *http_find_object(char *name)
+{
+	char *id = strchr(name,':');
+	if ( id==NULL )
+		return object_find_name(name);
+	else
+		return object_find_by_id(atoi(id+1));
+}
+
+/** Process a single XML data item, which is either \p global[=value] or \p object/property[=value]
+	@returns non-zero on success, 0 on failure (nothing is written on failure)
+ **/
+static int http_xml_item(HTTPCNX *http,char *uri)
 {
 	char arg1[1024]="", arg2[1024]="";
 	int nargs = sscanf(uri,"%1023[^/=\r\n]/%1023[^\r\n=]",arg1,arg2);
 	char *value = strchr(uri,'=');
 	char buffer[1024]="";
 	OBJECT *obj=NULL;
-	char *id;
 
 	/* value */
 	if (value) *value++;
@@ -555,21 +727,15 @@ int http_xml_request(HTTPCNX *http,char *uri)
 		if (value) global_setvar(arg1,value);
 		
 		/* post the response */
-		http_format(http,"<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n");
 		http_format(http,"<globalvar>\n\t<name>%s</name>\n\t<value>%s</value>\n</globalvar>\n",
 			arg1, http_unquote(buffer));
-		http_type(http,"text/xml");
 		return 1;
 
 	/* get object property */
 	case 2:
 
 		/* find the object */
-		id = strchr(arg1,':');
-		if ( id==NULL )
-			obj = object_find_name(arg1);
-		else
-			obj = object_find_by_id(atoi(id+1));
+		obj = http_find_object(arg1);
 		if ( obj==NULL )
 		{
 			output_error("object '%s' not found", arg1);
@@ -591,13 +757,12 @@ int http_xml_request(HTTPCNX *http,char *uri)
 		}
 
 		/* post the response */
-		http_format(http,"<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n<property>\n");
+		http_format(http,"<property>\n");
 		http_format(http,"\t<object>%s</object>\n", arg1);
 		http_format(http,"\t<name>%s</name>\n", arg2);
 		http_format(http,"\t<value>%s</value>\n", http_unquote(buffer));
 		/* TODO add property type info */
 		http_format(http,"</property>\n");
-		http_type(http,"text/xml");
 		return 1;
 
 	default:
@@ -606,6 +771,272 @@ int http_xml_request(HTTPCNX *http,char *uri)
 	return 0;
 }
 
+/** Process an incoming XML data request
+	@returns non-zero on success, 0 on failure (errno set)
+ **/
+int http_xml_request(HTTPCNX *http,char *uri)
+{
+	size_t len = http->len;
+	http_format(http,"<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n");
+	if ( !http_xml_item(http,uri) )
+	{
+		http->len = len;
+		return 0;
+	}
+	http_type(http,"text/xml");
+	return 1;
+}
+
+/** Process an incoming bulk XML data request
+
+	The request lists any number of items separated by ';', '&' or newlines, each using 
+	the same syntax as an XML request.  The items are given either in the URI (GET) or in
+	the message content (POST).  Items that cannot be processed are reported in \p error elements.
+	@returns non-zero on success, 0 on failure (errno set)
+ **/
+int http_bulk_request(HTTPCNX *http,char *uri)
+{
+	char *item, *next;
+	int count = 0;
+	if ( *uri=='?' ) uri++;
+	http_format(http,"<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n<bulk>\n");
+	for ( item=uri ; item!=NULL ; item=next )
+	{
+		next = strpbrk(item,";&\r\n");
+		if ( next!=NULL ) *next++ = '\0';
+		if ( *item=='\0' )
+			continue;
+		if ( !http_xml_item(http,item) )
+			http_format(http,"<error>%s</error>\n", item);
+		count++;
+	}
+	http_format(http,"</bulk>\n");
+	http_type(http,"text/xml");
+	return count>0;
+}
+
+/********************************************************
+ Event stream routines
+ */
+
+static pthread_mutex_t stream_lock = PTHREAD_MUTEX_INITIALIZER; /**< protects pending stream data and subscribed values */
+static HTTPCNX * volatile stream_list = NULL; /**< connections with active subscriptions (modified only by the server thread) */
+#ifdef USE_EPOLL
+static int evfd = -1; /**< eventfd used by the main loop to signal that stream data is pending */
+#endif
+
+/** Append formatted data to the pending event stream of a connection (stream_lock must be held) **/
+static void http_pending(HTTPCNX *http, char *format, ...)
+{
+	char data[4096];
+	int len;
+	va_list ptr;
+
+	va_start(ptr,format);
+	len = vsnprintf(data,sizeof(data),format,ptr);
+	va_end(ptr);
+	if ( len<0 )
+		return;
+	if ( len>=(int)sizeof(data) )
+		len = sizeof(data)-1;
+
+	if ( http->plen+len>=http->pmax )
+	{
+		size_t max = http->pmax>0 ? http->pmax*2 : 4096;
+		char *pending;
+		while ( http->plen+len>=max ) max *= 2;
+		pending = (char*)realloc(http->pending,max);
+		if ( pending==NULL )
+		{
+			output_error("unable to extend event stream buffer for socket %d", http->s);
+			return;
+		}
+		http->pending = pending;
+		http->pmax = max;
+	}
+	memcpy(http->pending+http->plen,data,len);
+	http->plen += len;
+}
+
+/** Read the current value of a subscribed item
+	@returns non-zero on success, 0 on failure
+ **/
+static int http_subscription_value(HTTPSUB *sub, char *buffer, int size)
+{
+	if ( sub->obj==NULL )
+		return global_getvar(sub->name,buffer,size)!=NULL;
+	else
+		return object_get_value_by_name(sub->obj,sub->name,buffer,size)>0;
+}
+
+/** Post the subscribed values that changed since the last event, or all of them on the
+	first event of a connection (stream_lock must be held)
+ **/
+static void http_stream_sample(HTTPCNX *http, TIMESTAMP ts)
+{
+	HTTPSUB *sub;
+	int count = 0;
+	for ( sub=http->subscription ; sub!=NULL ; sub=sub->next )
+	{
+		char value[1024];
+		if ( !http_subscription_value(sub,value,sizeof(value)) || (!http->fresh && strcmp(value,sub->value)==0) )
+			continue;
+		strcpy(sub->value,value);
+		if ( count++==0 )
+			http_pending(http,"id: %" FMT_INT64 "d\n", ts);
+		if ( sub->obj==NULL )
+			http_pending(http,"data: %s=%s\n", sub->name, http_unquote(value));
+		else if ( sub->obj->name!=NULL )
+			http_pending(http,"data: %s/%s=%s\n", sub->obj->name, sub->name, http_unquote(value));
+		else
+			http_pending(http,"data: %s:%d/%s=%s\n", sub->obj->oclass->name, sub->obj->id, sub->name, http_unquote(value));
+	}
+	if ( count>0 )
+		http_pending(http,"\n");
+	http->fresh = 0;
+}
+
+/** Send the pending event stream data of a connection to the client
+	@returns non-zero on success, 0 on failure
+ **/
+static int http_stream_flush(HTTPCNX *http)
+{
+	size_t len;
+	pthread_mutex_lock(&stream_lock);
+	if ( http->plen>0 )
+	{
+		http_write(http,http->pending,http->plen);
+		http->plen = 0;
+	}
+	pthread_mutex_unlock(&stream_lock);
+	if ( http->len==0 )
+		return 1;
+	len = http->len;
+	http->len = 0;
+	return http_output(http,http->buffer,len);
+}
+
+/** Process an incoming subscription request
+
+	The request lists items using the same syntax as a bulk request, but without assignments.
+	On success the connection becomes a server-sent event stream (text/event-stream).  Its
+	first event reports every subscribed value and each later event the values that changed.
+	The values are sampled by the main loop, after the next clock advance or at once while
+	the simulation is paused, so that they never come from the middle of a pass.
+	@returns non-zero on success, 0 on failure (errno set)
+ **/
+int http_subscribe_request(HTTPCNX *http,char *uri)
+{
+#ifdef USE_EPOLL
+	char *item, *next;
+	HTTPSUB **tail = &(http->subscription);
+	char header[] = "HTTP/1.1 " HTTP_OK "\nContent-Type: text/event-stream\nCache-Control: no-cache\nConnection: close\n\n";
+
+	if ( *uri=='?' ) uri++;
+	for ( item=uri ; item!=NULL ; item=next )
+	{
+		char arg1[1024]="", arg2[1024]="";
+		char buffer[1024];
+		HTTPSUB *sub;
+		int nargs;
+
+		next = strpbrk(item,";&\r\n");
+		if ( next!=NULL ) *next++ = '\0';
+		if ( *item=='\0' )
+			continue;
+		nargs = sscanf(item,"%1023[^/=\r\n]/%1023[^\r\n=]",arg1,arg2);
+		http_decode(arg1);
+		http_decode(arg2);
+
+		sub = (HTTPSUB*)malloc(sizeof(HTTPSUB));
+		if ( sub==NULL )
+		{
+			output_error("unable to allocate subscription for '%s'", item);
+			goto Error;
+		}
+		memset(sub,0,sizeof(HTTPSUB));
+		*tail = sub;
+		tail = &(sub->next);
+		switch ( nargs ) {
+		case 1:
+			strcpy(sub->name,arg1);
+			break;
+		case 2:
+			sub->obj = http_find_object(arg1);
+			if ( sub->obj==NULL )
+			{
+				output_error("object '%s' not found", arg1);
+				goto Error;
+			}
+			strcpy(sub->name,arg2);
+			break;
+		default:
+			output_error("subscription item '%s' is not valid", item);
+			goto Error;
+		}
+		if ( !http_subscription_value(sub,buffer,sizeof(buffer)) )
+		{
+			output_error("subscription item '%s' not found", item);
+			goto Error;
+		}
+	}
+	if ( http->subscription==NULL )
+	{
+		output_error("subscription request does not include any items");
+		return 0;
+	}
+
+	/* the stream is delimited by closing the connection */
+	http->keep_alive = 0;
+	if ( !http_output(http,header,strlen(header)) )
+		goto Error;
+
+	/* the main loop posts all the current values at its next update */
+	pthread_mutex_lock(&stream_lock);
+	http->fresh = 1;
+	http->next = stream_list;
+	stream_list = http;
+	pthread_mutex_unlock(&stream_lock);
+	exec_mls_wake();
+	output_verbose("socket %d subscribed to event stream", http->s);
+	return http_stream_flush(http);
+Error:
+	while ( http->subscription!=NULL )
+	{
+		HTTPSUB *next = http->subscription->next;
+		free(http->subscription);
+		http->subscription = next;
+	}
+	return 0;
+#else
+	output_error("subscription requests are not supported on this platform");
+	return 0;
+#endif
+}
+
+/** Update the event streams of all subscribed connections
+
+	This is called by the main loop after each clock advance, and while it is paused
+	each time it is woken, so that the values are sampled at a consistent state.  The
+	data is sent by the server thread.
+	@returns Nothing
+ **/
+void server_update(TIMESTAMP ts)
+{
+#ifdef USE_EPOLL
+	HTTPCNX *http;
+	uint64 one = 1;
+	if ( evfd<0 || stream_list==NULL )
+		return;
+	pthread_mutex_lock(&stream_lock);
+	for ( http=stream_list ; http!=NULL ; http=http->next )
+		http_stream_sample(http,ts);
+	pthread_mutex_unlock(&stream_lock);
+	if ( write(evfd,&one,sizeof(one))!=sizeof(one) )
+		output_warning("server event stream notification failed: %s", strerror(errno));
+#endif
+}
+
 /** Process an incoming GUI request
 	@returns non-zero on success, 0 on failure (errno set)
  **/
@@ -1196,18 +1627,167 @@ int http_favicon(HTTPCNX *http)
 	return http_copy(http,"icon",fullpath);
 }
 
-/** Process an incoming request
-	@returns nothing
+#define MAXREQUEST (1<<24) /**< largest request accepted (including content) */
+
+/** Receive more data from the client into the HTTPCNX request buffer
+	@returns the number of bytes received, 0 if the connection closed or failed, -1 if no data is available yet
  **/
-void *http_response(void *ptr)
+static int http_receive(HTTPCNX *http)
 {
-	SOCKET fd = (SOCKET)ptr;
-	HTTPCNX *http = http_create(fd);
-	size_t len;
+	int len;
+	if ( http->qlen+1>=http->qmax )
+	{
+		char *query;
+		if ( http->qmax*2>MAXREQUEST )
+		{
+			output_error("request on socket %d exceeds maximum size of %d bytes", http->s, MAXREQUEST);
+			return 0;
+		}
+		query = (char*)realloc(http->query,http->qmax*2);
+		if ( query==NULL )
+		{
+			output_error("unable to extend request buffer for socket %d", http->s);
+			return 0;
+		}
+		http->query = query;
+		http->qmax *= 2;
+	}
+	len = (int)recv_data(http->s,http->query+http->qlen,http->qmax-http->qlen-1);
+	if ( len<0 && (errno==EAGAIN || errno==EWOULDBLOCK || errno==EINTR) )
+		return -1;
+	if ( len<=0 )
+		return 0;
+	http->qlen += len;
+	http->query[http->qlen] = '\0';
+	return len;
+}
+
+/** Determine the size of the first complete request in the HTTPCNX request buffer
+	@returns the number of bytes in the request (including content), or 0 if the request is not complete yet
+ **/
+static size_t http_request_length(HTTPCNX *http, size_t *header)
+{
+	char *crlf = strstr(http->query,"\r\n\r\n");
+	char *lf = strstr(http->query,"\n\n");
+	char *p, *eoh;
+	int content_length = 0;
+
+	/* find the end of the header */
+	if ( crlf!=NULL && (lf==NULL || crlf<lf) )
+		eoh = crlf+4;
+	else if ( lf!=NULL )
+		eoh = lf+2;
+	else
+		return 0;
+	*header = eoh - http->query;
+
+	/* find the content length, if any */
+	for ( p=strchr(http->query,'\n') ; p!=NULL && p<eoh ; p=strchr(p,'\n') )
+	{
+		p++;
+		if ( strnicmp(p,"Content-Length:",15)==0 )
+		{
+			content_length = atoi(p+15);
+			break;
+		}
+	}
+	if ( content_length<0 )
+		content_length = 0;
+	if ( http->qlen < *header+content_length )
+		return 0;
+	return *header+content_length;
+}
+
+#ifdef USE_EPOLL
+/** Request that runs an external program, handled on a worker thread so the server loop is not held up **/
+typedef struct s_httpjob {
+	HTTPCNX *http; /**< connection the response goes to */
+	HTTPCNX *response; /**< private handle the request writes its response into */
+	int (*request)(HTTPCNX*,char*);
+	char *success;
+	char *failure;
+	char uri[1024];
+	struct s_httpjob *next;
+} HTTPJOB;
+
+static pthread_mutex_t job_lock = PTHREAD_MUTEX_INITIALIZER; /**< protects job_done */
+static HTTPJOB *job_done = NULL; /**< finished requests waiting for the server loop */
+
+/** Run a request on a worker thread and hand the result back to the server loop
+	@returns NULL
+ **/
+static void *http_job_routine(void *arg)
+{
+	HTTPJOB *job = (HTTPJOB*)arg;
+	uint64 one = 1;
+	if ( job->request(job->response,job->uri) )
+		http_status(job->response,job->success);
+	else
+		http_status(job->response,job->failure);
+	pthread_mutex_lock(&job_lock);
+	job->next = job_done;
+	job_done = job;
+	pthread_mutex_unlock(&job_lock);
+	if ( write(evfd,&one,sizeof(one))!=sizeof(one) )
+		output_warning("server job completion notification failed: %s", strerror(errno));
+	return NULL;
+}
+
+/** Start a request on a worker thread
+
+	The connection takes no further requests until the response has been sent.
+	@returns non-zero if the request was started, 0 if it must be run by the caller
+ **/
+static int http_start_job(HTTPCNX *http, int (*request)(HTTPCNX*,char*), char *uri, char *success, char *failure)
+{
+	pthread_t thread;
+	pthread_attr_t attr;
+	int ok;
+	HTTPJOB *job = (HTTPJOB*)malloc(sizeof(HTTPJOB));
+	if ( job==NULL )
+		return 0;
+	memset(job,0,sizeof(HTTPJOB));
+	job->response = http_create(INVALID_SOCKET);
+	if ( job->response==NULL )
+	{
+		free(job);
+		return 0;
+	}
+	job->http = http;
+	job->request = request;
+	job->success = success;
+	job->failure = failure;
+	strncpy(job->uri,uri,sizeof(job->uri)-1);
+	http->busy = 1;
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr,PTHREAD_CREATE_DETACHED);
+	ok = (pthread_create(&thread,&attr,http_job_routine,(void*)job)==0);
+	pthread_attr_destroy(&attr);
+	if ( !ok )
+	{
+		output_warning("unable to start worker thread for '%s', running it on the server thread", uri);
+		http->busy = 0;
+		http_destroy(job->response);
+		free(job);
+	}
+	return ok;
+}
+#endif
+
+/** Process one complete request 
+	@returns non-zero if the connection remains open, 0 if it must be closed
+ **/
+static int http_handle(HTTPCNX *http, char *content)
+{
+	/* first term is always the request */
+	char *request = http->query;
+	char method[32];
+	char uri[1024];
+	char version[32];
+	char *p = strpbrk(http->query,"\r\n");
+	int v;
 	int content_length = 0;
-	char *user_agent = NULL;
 	char *host = NULL;
-	int keep_alive = 0;
 	char *connection = NULL;
 	char *accept = NULL;
 	struct s_map {
@@ -1218,137 +1798,479 @@ void *http_response(void *ptr)
 	} map[] = {
 		{"Content-Length", INTEGER, (void*)&content_length, 0},
 		{"Host", STRING, (void*)&host, 0},
-		{"Keep-Alive", INTEGER, (void*)&keep_alive, 0},
 		{"Connection", STRING, (void*)&connection, 0},
 		{"Accept", STRING, (void*)&accept, 0},
 	};
+	
+	/* initialize the response */
+	http_reset(http);
 
-	while ( (int)(len=recv_data(fd,http->query,sizeof(http->query)))>0 )
+	/* read the request string */
+	if (sscanf(request,"%31s %1023s %31s",method,uri,version)!=3)
 	{
-		/* first term is always the request */
-		char *request = http->query;
-		char method[32];
-		char uri[1024];
-		char version[32];
-		char *p = strchr(http->query,'\r');
-		int v;
-		
-		/* initialize the response */
-		http_reset(http);
+		http->keep_alive = 0;
+		http_status(http,HTTP_BADREQUEST);
+		http_format(http,HTTP_BADREQUEST);
+		http_type(http,"text/html");
+		http_send(http);
+		return 0;
+	}
 
-		/* read the request string */
-		if (sscanf(request,"%s %s %s",method,uri,version)!=3)
-		{
-			http_status(http,HTTP_BADREQUEST);
-			http_format(http,HTTP_BADREQUEST);
-			http_type(http,"text/html");
-			http_send(http);
+	/* read the rest of the header */
+	while (p!=NULL && p<content) 
+	{
+		if ( *p=='\r' ) *p++ = '\0';
+		if ( *p=='\n' ) *p++ = '\0';
+		if ( p>=content ) 
 			break;
+		for ( v=0 ; v<sizeof(map)/sizeof(map[0]) ; v++ )
+		{
+			if (map[v].sz==0) map[v].sz = strlen(map[v].name);
+			if (strnicmp(map[v].name,p,map[v].sz)==0 && strncmp(p+map[v].sz,": ",2)==0)
+			{
+				if (map[v].type==INTEGER) { *(int*)(map[v].value) = atoi(p+map[v].sz+2); break; }
+				else if (map[v].type==STRING) { *(char**)map[v].value = p+map[v].sz+2; break; }
+			}
 		}
+		p = strpbrk(p,"\r\n");
+	}
+	output_verbose("%s (host='%s', len=%d)",http->query,host?host:"???",content_length);
+
+	/* HTTP/1.1 connections persist by default, HTTP/1.0 only on request */
+	if ( connection!=NULL )
+		http->keep_alive = (strnicmp(connection,"keep-alive",10)==0);
+	else
+		http->keep_alive = (stricmp(version,"HTTP/1.0")!=0);
+
+	/* only bulk requests may post content */
+	if ( stricmp(method,"POST")==0 && strcmp(uri,"/bulk/")==0 )
+	{
+		if ( http_bulk_request(http,content) )
+			http_status(http,HTTP_OK);
+		else
+			http_status(http,HTTP_NOTFOUND);
+		http_send(http);
+		return http->keep_alive;
+	}
+
+	/* reject anything but a GET */
+	if (stricmp(method,"GET")!=0)
+	{
+		http->keep_alive = 0;
+		http_status(http,HTTP_METHODNOTALLOWED);
+		http_format(http,HTTP_METHODNOTALLOWED);
+		http_type(http,"text/html");
+		/* technically, we should add an Allow entry to the response header */
+		http_send(http);
+		return 0;
+	}
 
-		/* read the rest of the header */
-		while (p!=NULL && (p=strchr(p,'\r'))!=NULL) 
+	/* handle request */
+	if ( strcmp(uri,"/favicon.ico")==0 )
+	{
+		if ( http_favicon(http) )
+			http_status(http,HTTP_OK);
+		else
+			http_status(http,HTTP_NOTFOUND);
+		http_send(http);
+		return http->keep_alive;
+	}
+	else if ( strncmp(uri,"/subscribe/",11)==0 )
+	{
+		/* successful subscriptions take over the connection */
+		if ( http_subscribe_request(http,uri+11) )
+			return 1;
+		http->keep_alive = 0;
+		http_status(http,HTTP_NOTFOUND);
+		http_send(http);
+		return 0;
+	}
+	else {
+		static struct s_map {
+			char *path;
+			int (*request)(HTTPCNX*,char*);
+			char *success;
+			char *failure;
+			int external; /**< runs an external program */
+		} map[] = {
+			/* this is the map of recognize request types */
+			{"/control/",	http_control_request,	HTTP_ACCEPTED, HTTP_NOTFOUND, 0},
+			{"/open/",		http_open_request,		HTTP_ACCEPTED, HTTP_NOTFOUND, 0},
+			{"/xml/",		http_xml_request,		HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/bulk/",		http_bulk_request,		HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/gui/",		http_gui_request,		HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/output/",	http_output_request,	HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/action/",	http_action_request,	HTTP_ACCEPTED,HTTP_NOTFOUND, 0},
+			{"/rt/",		http_get_rt,			HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/perl/",		http_run_perl,			HTTP_OK, HTTP_NOTFOUND, 1},
+			{"/gnuplot/",	http_run_gnuplot,		HTTP_OK, HTTP_NOTFOUND, 1},
+			{"/java/",		http_run_java,			HTTP_OK, HTTP_NOTFOUND, 1},
+			{"/python/",	http_run_python,		HTTP_OK, HTTP_NOTFOUND, 1},
+			{"/r/",			http_run_r,				HTTP_OK, HTTP_NOTFOUND, 1},
+			{"/scilab/",	http_run_scilab,		HTTP_OK, HTTP_NOTFOUND, 1},
+			{"/octave/",	http_run_octave,		HTTP_OK, HTTP_NOTFOUND, 1},
+		};
+		int n;
+		for ( n=0 ; n<sizeof(map)/sizeof(map[0]) ; n++ )
 		{
- 			*p = '\0';
-			p+=2;
-			for ( v=0 ; v<sizeof(map)/sizeof(map[0]) ; v++ )
+			size_t len = strlen(map[n].path);
+			if (strncmp(uri,map[n].path,len)==0)
 			{
-				if (map[v].sz==0) map[v].sz = strlen(map[v].name);
-				if (strnicmp(map[v].name,p,map[v].sz)==0 && strncmp(p+map[v].sz,": ",2)==0)
-				{
-					if (map[v].type==INTEGER) { *(int*)(map[v].value) = atoi(p+map[v].sz+2); break; }
-					else if (map[v].type==STRING) { *(char**)map[v].value = p+map[v].sz+2; break; }
-				}
+#ifdef USE_EPOLL
+				/* the response is sent by the server loop when the program is done */
+				if ( map[n].external && http_start_job(http,map[n].request,uri+len,map[n].success,map[n].failure) )
+					return 1;
+#endif
+				if ( map[n].request(http,uri+len) )
+					http_status(http,map[n].success);
+				else
+					http_status(http,map[n].failure);
+				http_send(http);
+				return http->keep_alive;
 			}
 		}
-		output_verbose("%s (host='%s', len=%d)",http->query,host?host:"???",content_length);
+	}
+	/* deprecated XML usage */
+	if (strncmp(uri,"/",1)==0 )
+	{
+		if ( http_xml_request(http,uri+1) )
+		{	
+			output_warning("deprecate XML usage in request '%s'", uri);
+			http_status(http,HTTP_OK);
+		}
+		else
+			http_status(http,HTTP_NOTFOUND);
+		http_send(http);
+	}
+	else 
+	{
+		http_status(http,HTTP_NOTFOUND);
+		http_format(http,HTTP_NOTFOUND);
+		http_type(http,"text/html");
+		http_send(http);
+	}
+	return http->keep_alive;
+}
+
+/** Process all the complete requests in the HTTPCNX request buffer
+	@returns non-zero if the connection remains open, 0 if it must be closed
+ **/
+static int http_dispatch(HTTPCNX *http)
+{
+	size_t len, header;
+	while ( http->s!=INVALID_SOCKET && !http->busy && (len=http_request_length(http,&header))>0 )
+	{
+		char save = http->query[len];
+		int keep_alive;
 
-		/* reject anything but a GET */
-		if (stricmp(method,"GET")!=0)
+		/* event streams ignore further input */
+		if ( http->subscription!=NULL )
 		{
-			http_status(http,HTTP_METHODNOTALLOWED);
-			http_format(http,HTTP_METHODNOTALLOWED);
-			http_type(http,"text/html");
-			/* technically, we should add an Allow entry to the response header */
-			http_send(http);
-			break;
+			http->qlen = 0;
+			http->query[0] = '\0';
+			return 1;
 		}
 
-		/* handle request */
-		if ( strcmp(uri,"/favicon.ico")==0 )
+		http->query[len] = '\0';
+		keep_alive = http_handle(http,http->query+header);
+		http->query[len] = save;
+		http->qlen -= len;
+		memmove(http->query,http->query+len,http->qlen+1);
+		if ( !keep_alive )
+			return 0;
+	}
+	return http->s!=INVALID_SOCKET;
+}
+
+/** Process incoming requests on a connection (one thread per connection)
+	@returns nothing
+ **/
+void *http_response(void *ptr)
+{
+	SOCKET fd = (SOCKET)(intptr_t)ptr;
+	HTTPCNX *http = http_create(fd);
+	if ( http==NULL )
+	{
+		output_error("unable to create http connection handle for socket %d", fd);
+#ifdef WIN32
+		closesocket(fd);
+#else
+		close(fd);
+#endif
+		return 0;
+	}
+	while ( http_receive(http)>0 && http_dispatch(http) )
+	{
+		/* keep-alive */
+	}
+	http_close(http);
+	output_verbose("socket %d closed",fd);
+	http_destroy(http);
+	return 0;
+}
+
+#ifdef USE_EPOLL
+#define MAXEVENTS 64 /**< maximum number of events handled per wait */
+
+/** Close a connection managed by the server loop
+
+	The connection handle is added to the list of defunct connections to be destroyed
+	after the current batch of events is processed.
+	@returns Nothing
+ **/
+static void server_disconnect(HTTPCNX *http, HTTPCNX **defunct)
+{
+	if ( http->subscription!=NULL )
+	{
+		HTTPCNX **p;
+		pthread_mutex_lock(&stream_lock);
+		for ( p=(HTTPCNX**)&stream_list ; *p!=NULL ; p=&((*p)->next) )
 		{
-			if ( http_favicon(http) )
-				http_status(http,HTTP_OK);
-			else
-				http_status(http,HTTP_NOTFOUND);
+			if ( *p==http )
+			{
+				*p = http->next;
+				break;
+			}
+		}
+		pthread_mutex_unlock(&stream_lock);
+	}
+	if ( http->s!=INVALID_SOCKET )
+	{
+		output_verbose("socket %d closed",http->s);
+		epoll_ctl(epfd,EPOLL_CTL_DEL,http->s,NULL);
+		http->len = 0; /* nothing more can be sent */
+		http_close(http);
+	}
+	/* a connection with a request still running is destroyed when the request finishes */
+	if ( !http->busy )
+	{
+		http->next = *defunct;
+		*defunct = http;
+	}
+	if ( global_server_quit_on_close )
+		shutdown_now();
+}
+
+/** Close a connection once the client has received all its output
+	@returns Nothing
+ **/
+static void server_close(HTTPCNX *http, HTTPCNX **defunct)
+{
+	if ( http->olen>http->ostart )
+	{
+		http->closing = 1;
+		http_watch(http);
+	}
+	else
+		server_disconnect(http,defunct);
+}
+
+/** Send the responses of the requests that finished on worker threads
+	@returns Nothing
+ **/
+static void server_jobs_done(HTTPCNX **defunct)
+{
+	HTTPJOB *job;
+	pthread_mutex_lock(&job_lock);
+	job = job_done;
+	job_done = NULL;
+	pthread_mutex_unlock(&job_lock);
+	while ( job!=NULL )
+	{
+		HTTPJOB *next = job->next;
+		HTTPCNX *http = job->http;
+		http->busy = 0;
+		if ( http->s==INVALID_SOCKET )
+		{
+			/* client went away while the request was running */
+			http->next = *defunct;
+			*defunct = http;
+		}
+		else
+		{
+			http_status(http,job->response->status);
+			http_type(http,job->response->type);
+			if ( job->response->len>0 )
+				http_write(http,job->response->buffer,job->response->len);
 			http_send(http);
+
+			/* carry on with any requests that arrived meanwhile */
+			if ( !http->keep_alive || !http_dispatch(http) )
+				server_close(http,defunct);
+		}
+		http_destroy(job->response);
+		free(job);
+		job = next;
+	}
+}
+
+/** Main server event loop 
+
+	All connections are served by this thread. Connections persist until the client
+	closes them or requests that they be closed, and event stream connections are
+	updated whenever the main loop signals that new data is pending.  Sockets are
+	non-blocking, so a client that does not read its responses cannot stall the loop,
+	and requests that run external programs are handled on worker threads.
+    @returns a pointer to the status flag
+ **/
+static void *server_routine(void *arg)
+{
+	static int status = 0;
+	static int started = 0;
+	struct epoll_event ev, events[MAXEVENTS];
+	if (started)
+	{
+		output_error("server routine is already running");
+		return NULL;
+	}
+	started = 1;
+	sockfd = (SOCKET)(intptr_t)arg;
+
+	/* setup the event loop */
+	epfd = epoll_create(MAXEVENTS);
+	evfd = eventfd(0,EFD_NONBLOCK);
+	if ( epfd<0 || evfd<0 )
+	{
+		status = GetLastError();
+		output_error("server event loop setup failed: %s", strerror(status));
+		goto Done;
+	}
+	memset(&ev,0,sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.ptr = NULL; /* listening socket */
+	if ( epoll_ctl(epfd,EPOLL_CTL_ADD,sockfd,&ev)<0 )
+	{
+		status = GetLastError();
+		output_error("server socket fd=%d cannot be added to event loop: %s", sockfd, strerror(status));
+		goto Done;
+	}
+	ev.data.ptr = &evfd; /* event stream notification */
+	if ( epoll_ctl(epfd,EPOLL_CTL_ADD,evfd,&ev)<0 )
+	{
+		status = GetLastError();
+		output_error("server event stream notification cannot be added to event loop: %s", strerror(status));
+		goto Done;
+	}
+
+	// repeat forever..
+	while (!shutdown_server)
+	{
+		HTTPCNX *defunct = NULL;
+		int n, nfds = epoll_wait(epfd,events,MAXEVENTS,-1);
+		if ( nfds<0 )
+		{
+			if ( errno==EINTR )
+				continue;
+			status = GetLastError();
+			output_error("server event wait error on fd=%d: code %d", epfd, status);
+			goto Done;
 		}
-		else {
-			static struct s_map {
-				char *path;
-				int (*request)(HTTPCNX*,char*);
-				char *success;
-				char *failure;
-			} map[] = {
-				/* this is the map of recognize request types */
-				{"/control/",	http_control_request,	HTTP_ACCEPTED, HTTP_NOTFOUND},
-				{"/open/",		http_open_request,		HTTP_ACCEPTED, HTTP_NOTFOUND},
-				{"/xml/",		http_xml_request,		HTTP_OK, HTTP_NOTFOUND},
-				{"/gui/",		http_gui_request,		HTTP_OK, HTTP_NOTFOUND},
-				{"/output/",	http_output_request,	HTTP_OK, HTTP_NOTFOUND},
-				{"/action/",	http_action_request,	HTTP_ACCEPTED,HTTP_NOTFOUND},
-				{"/rt/",		http_get_rt,			HTTP_OK, HTTP_NOTFOUND},
-				{"/perl/",		http_run_perl,			HTTP_OK, HTTP_NOTFOUND},
-				{"/gnuplot/",	http_run_gnuplot,		HTTP_OK, HTTP_NOTFOUND},
-				{"/java/",		http_run_java,			HTTP_OK, HTTP_NOTFOUND},
-				{"/python/",	http_run_python,		HTTP_OK, HTTP_NOTFOUND},
-				{"/r/",			http_run_r,				HTTP_OK, HTTP_NOTFOUND},
-				{"/scilab/",	http_run_scilab,		HTTP_OK, HTTP_NOTFOUND},
-				{"/octave/",	http_run_octave,		HTTP_OK, HTTP_NOTFOUND},
-			};
-			int n;
-			for ( n=0 ; n<sizeof(map)/sizeof(map[0]) ; n++ )
+		for ( n=0 ; n<nfds ; n++ )
+		{
+			HTTPCNX *http = (HTTPCNX*)events[n].data.ptr;
+
+			/* incoming connection */
+			if ( http==NULL )
 			{
-				size_t len = strlen(map[n].path);
-				if (strncmp(uri,map[n].path,len)==0)
+				struct sockaddr_in cli_addr;
+				socklen_t clilen = sizeof(cli_addr);
+				SOCKET newsockfd = accept(sockfd,(struct sockaddr *)&cli_addr,&clilen);
+				if ( (int)newsockfd<0 )
 				{
-					if ( map[n].request(http,uri+len) )
-						http_status(http,map[n].success);
-					else
-						http_status(http,map[n].failure);
-					http_send(http);
-					goto Next;
+					if ( errno==EINTR || errno==EAGAIN )
+						continue;
+					status = GetLastError();
+					if ( !shutdown_server )
+						output_error("server accept error on fd=%d: code %d", sockfd, status);
+					goto Done;
 				}
+				output_verbose("accepting incoming connection from on port %d",cli_addr.sin_port);
+				if ( fcntl(newsockfd,F_SETFL,fcntl(newsockfd,F_GETFL,0)|O_NONBLOCK)<0 )
+				{
+					output_error("socket %d cannot be made non-blocking: %s", newsockfd, strerror(GetLastError()));
+					close(newsockfd);
+					continue;
+				}
+				http = http_create(newsockfd);
+				if ( http==NULL )
+				{
+					output_error("unable to create http connection handle for socket %d", newsockfd);
+					close(newsockfd);
+					continue;
+				}
+				ev.events = http->events = EPOLLIN;
+				ev.data.ptr = http;
+				if ( epoll_ctl(epfd,EPOLL_CTL_ADD,newsockfd,&ev)<0 )
+				{
+					output_error("socket %d cannot be added to event loop: %s", newsockfd, strerror(GetLastError()));
+					http_close(http);
+					http_destroy(http);
+					continue;
+				}
+				gui_wait_status(0);
 			}
-		}
-		/* deprecated XML usage */
-		if (strncmp(uri,"/",1)==0 )
-		{
-			if ( http_xml_request(http,uri+1) )
-			{	
-				output_warning("deprecate XML usage in request '%s'", uri);
-				http_status(http,HTTP_OK);
+
+			/* event stream data pending or worker requests finished */
+			else if ( (void*)http==(void*)&evfd )
+			{
+				uint64 count;
+				HTTPCNX *next;
+				if ( read(evfd,&count,sizeof(count))<0 && errno!=EAGAIN )
+					output_warning("server event stream notification read failed: %s", strerror(errno));
+				server_jobs_done(&defunct);
+				for ( http=stream_list ; http!=NULL ; http=next )
+				{
+					next = http->next;
+					if ( !http_stream_flush(http) )
+						server_disconnect(http,&defunct);
+				}
+			}
+
+			/* connection events (ignoring connections closed earlier in this batch) */
+			else if ( http->s!=INVALID_SOCKET )
+			{
+				int rc;
+
+				/* socket accepts more of the queued output */
+				if ( (events[n].events&(EPOLLOUT|EPOLLERR|EPOLLHUP)) && http->olen>http->ostart )
+				{
+					if ( !http_drain(http) )
+					{
+						server_disconnect(http,&defunct);
+						continue;
+					}
+				}
+				if ( http->closing )
+				{
+					if ( http->olen==http->ostart || (events[n].events&(EPOLLERR|EPOLLHUP)) )
+						server_disconnect(http,&defunct);
+					continue;
+				}
+
+				/* incoming request data */
+				if ( events[n].events&(EPOLLIN|EPOLLERR|EPOLLHUP) )
+				{
+					rc = http_receive(http);
+					if ( rc==0 )
+						server_disconnect(http,&defunct);
+					else if ( rc>0 && !http_dispatch(http) )
+						server_close(http,&defunct);
+				}
 			}
-			else
-				http_status(http,HTTP_NOTFOUND);
-			http_send(http);
 		}
-		else 
+
+		/* destroy connections closed during this batch */
+		while ( defunct!=NULL )
 		{
-			http_status(http,HTTP_NOTFOUND);
-			http_format(http,HTTP_NOTFOUND);
-			http_type(http,"text/html");
-			http_send(http);
+			HTTPCNX *next = defunct->next;
+			http_destroy(defunct);
+			defunct = next;
 		}
-
-		/* keep-alive not desired*/
-Next:
-		if (connection && stricmp(connection,"close")==0)
-			break;
 	}
-	http_close(http);
-	output_verbose("socket %d closed",http->s);
-	return 0;
+	output_verbose("server shutdown");
+Done:
+	started = 0;
+	return (void*)&status;
 }
-
+#endif
 
@@ -0,0 +1,323 @@
+/* sparsesync.c
+ * Copyright (C) 2008 Battelle Memorial Institute
+ * Sparse dispatch of object syncs that are safe to skip.
+ *
+ * When skipsafe is set, the sync of an object flagged OF_SKIPSAFE returns at once
+ * until the clock reaches the earlier of its valid_to time and its clock plus
+ * skipsafe.  Every such object is still visited on every pass of every iteration,
+ * which on large residential models is most of the work of a pass.
+ *
+ * When sparse_sync is also set, each rank list keeps an active array of the
+ * objects it visits.  An object about to be skipped on a pass is parked instead:
+ * it leaves the active array of that pass and enters a priority queue keyed by
+ * the time it would stop skipping.  At the start of each iteration the objects
+ * that are due are woken back into their lists, in their original order, along
+ * with their parents.  The earliest time in the queue is posted as a hard event,
+ * just as the skipped syncs would have posted it.  An object that does run on a
+ * pass is woken on its other passes, because its sync may have changed the times
+ * it was parked on; the passes already done in the iteration still post the time
+ * they were parked on, as their skipped syncs did.
+ *
+ * Parking an object is exactly equivalent to visiting it and having it skip, so
+ * the results are the same as a full sync with the same skipsafe.  Only objects
+ * in service for the whole of the time they are parked are parked.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "platform.h"
+#include "output.h"
+#include "exception.h"
+#include "globals.h"
+#include "object.h"
+#include "index.h"
+#include "sparsesync.h"
+
+#define SPARSE_NPASSES 3
+
+/** Rank list of one pass **/
+typedef struct s_sparselist {
+	OBJECT **all;			///< every object of the list, in list order
+	OBJECT **active;		///< objects that are visited, in list order
+	unsigned int n_all, n_active;
+	unsigned int *pending;	///< list positions woken since the last visit
+	unsigned int n_pending;
+} SPARSELIST;
+
+/** Parked sync of an object on a pass **/
+typedef struct s_sparseentry {
+	TIMESTAMP due;
+	OBJECT *obj;
+	unsigned int pass;
+} SPARSEENTRY;
+
+static SPARSELIST *list[SPARSE_NPASSES];	/* by ordinal */
+static int *ordinal[SPARSE_NPASSES];		/* by object id, -1 when not synced on the pass */
+static unsigned int *position[SPARSE_NPASSES];	/* by object id */
+static TIMESTAMP *parked[SPARSE_NPASSES];	/* by object id, 0 when active */
+static unsigned int n_ids = 0;
+static SPARSEENTRY *queue = NULL;
+static unsigned int n_queue = 0, max_queue = 0;
+static int skipsafe = 0;		/* skipsafe the entries were parked with */
+static TIMESTAMP step = TS_NEVER;	/* earliest time posted by syncs skipped in this iteration */
+static int64 n_visited = 0;
+
+/** Time a skipped object stops skipping, or 0 if the object would not skip now **/
+static TIMESTAMP sparsesync_due(OBJECT *obj)
+{
+	TIMESTAMP due;
+	if ( !global_sparse_sync || global_skipsafe<=0 || (obj->flags&OF_SKIPSAFE)==0 )
+		return 0;
+
+	/* same test as _object_sync() */
+	due = min(obj->clock+global_skipsafe,obj->valid_to);
+	if ( global_clock>=due )
+		return 0;
+
+	/* must stay in service while parked */
+	if ( global_clock<obj->in_svc || (global_clock==obj->in_svc && obj->in_svc_micro!=0) || due>obj->out_svc )
+		return 0;
+	return due;
+}
+
+static void sparsesync_push(TIMESTAMP due, OBJECT *obj, unsigned int pass)
+{
+	unsigned int n, up;
+	if ( n_queue==max_queue )
+	{
+		unsigned int size = max_queue>0 ? max_queue*2 : 1024;
+		SPARSEENTRY *grow = (SPARSEENTRY*)realloc(queue,size*sizeof(SPARSEENTRY));
+		if ( grow==NULL )
+			throw_exception("sparsesync_push(): memory allocation failed");
+			/* TROUBLESHOOT
+				The sparse sync queue could not be enlarged.  Free up memory or
+				turn off sparse_sync and try again.
+			 */
+		queue = grow;
+		max_queue = size;
+	}
+	for ( n=n_queue++ ; n>0 && queue[up=(n-1)/2].due>due ; n=up )
+		queue[n] = queue[up];
+	queue[n].due = due;
+	queue[n].obj = obj;
+	queue[n].pass = pass;
+}
+
+static void sparsesync_pop(void)
+{
+	SPARSEENTRY last = queue[--n_queue];
+	unsigned int n = 0, child;
+	while ( (child=2*n+1)<n_queue )
+	{
+		if ( child+1<n_queue && queue[child+1].due<queue[child].due )
+			child++;
+		if ( queue[child].due>=last.due )
+			break;
+		queue[n] = queue[child];
+		n = child;
+	}
+	queue[n] = last;
+}
+
+/** Return a parked object to the active array of a pass on its next visit
+	@return the time the object was parked until, or 0 if it was not parked
+ **/
+static TIMESTAMP sparsesync_wake_pass(OBJECT *obj, unsigned int pass)
+{
+	SPARSELIST *item;
+	TIMESTAMP due;
+	if ( parked[pass]==NULL || (due=parked[pass][obj->id])==0 )
+		return 0;
+	parked[pass][obj->id] = 0;
+	item = &list[pass][ordinal[pass][obj->id]];
+	item->pending[item->n_pending++] = position[pass][obj->id];
+	return due;
+}
+
+/** Wake an object on all passes; those before the given pass are done and keep their time **/
+static void sparsesync_wake_object(OBJECT *obj, unsigned int done)
+{
+	unsigned int pass;
+	for ( pass=0 ; pass<SPARSE_NPASSES ; pass++ )
+	{
+		TIMESTAMP due = sparsesync_wake_pass(obj,pass);
+		if ( due>0 && pass<done && due<step )
+			step = due;
+	}
+}
+
+static int sparsesync_compare(const void *a, const void *b)
+{
+	unsigned int pa = *(unsigned int*)a, pb = *(unsigned int*)b;
+	return pa<pb ? -1 : (pa>pb ? 1 : 0);
+}
+
+/** Build the sparse lists of the ranks
+	@return SUCCESS or FAILED
+ **/
+STATUS sparsesync_init(INDEX **ranks)
+{
+	OBJECT *obj;
+	unsigned int pass;
+
+	for ( obj=object_get_first() ; obj!=NULL ; obj=obj->next )
+	{
+		if ( obj->id>=n_ids )
+			n_ids = obj->id+1;
+	}
+	for ( pass=0 ; pass<SPARSE_NPASSES && ranks[pass]!=NULL ; pass++ )
+	{
+		int i, size = ranks[pass]->last_used+1;
+		if ( size<1 )
+			continue;
+		list[pass] = (SPARSELIST*)calloc(size,sizeof(SPARSELIST));
+		ordinal[pass] = (int*)malloc(n_ids*sizeof(int));
+		position[pass] = (unsigned int*)malloc(n_ids*sizeof(unsigned int));
+		parked[pass] = (TIMESTAMP*)calloc(n_ids,sizeof(TIMESTAMP));
+		if ( list[pass]==NULL || ordinal[pass]==NULL || position[pass]==NULL || parked[pass]==NULL )
+		{
+			output_error("sparsesync_init(): memory allocation failed");
+			/* TROUBLESHOOT
+				The rank lists used by sparse sync could not be allocated.  Free up
+				memory or turn off sparse_sync and try again.
+			 */
+			return FAILED;
+		}
+		memset(ordinal[pass],-1,n_ids*sizeof(int));
+		for ( i=ranks[pass]->first_used ; i<=ranks[pass]->last_used ; i++ )
+		{
+			GLLIST *ranklist = ranks[pass]->ordinal[i];
+			SPARSELIST *item = &list[pass][i];
+			LISTITEM *ptr;
+			if ( ranklist==NULL )
+				continue;
+			item->all = (OBJECT**)malloc(ranklist->size*sizeof(OBJECT*));
+			item->active = (OBJECT**)malloc(ranklist->size*sizeof(OBJECT*));
+			item->pending = (unsigned int*)malloc(ranklist->size*sizeof(unsigned int));
+			if ( item->all==NULL || item->active==NULL || item->pending==NULL )
+			{
+				output_error("sparsesync_init(): memory allocation failed");
+				return FAILED;
+			}
+			for ( ptr=ranklist->first ; ptr!=NULL && item->n_all<ranklist->size ; ptr=ptr->next )
+			{
+				obj = (OBJECT*)ptr->data;
+				ordinal[pass][obj->id] = i;
+				position[pass][obj->id] = item->n_all;
+				item->all[item->n_all++] = obj;
+			}
+			memcpy(item->active,item->all,item->n_all*sizeof(OBJECT*));
+			item->n_active = item->n_all;
+		}
+	}
+	skipsafe = global_skipsafe;
+	output_verbose("sparse sync indexed %u objects", n_ids);
+	return SUCCESS;
+}
+
+/** Wake the parked objects that are due at time t, and their parents **/
+void sparsesync_wake(TIMESTAMP t)
+{
+	step = TS_NEVER;
+
+	/* objects parked under other settings must all be checked again */
+	if ( (skipsafe!=global_skipsafe || !global_sparse_sync) && n_queue>0 )
+	{
+		OBJECT *obj;
+		for ( obj=object_get_first() ; obj!=NULL ; obj=obj->next )
+		{
+			if ( obj->id<n_ids )
+				sparsesync_wake_object(obj,0);
+		}
+		n_queue = 0;
+		skipsafe = global_skipsafe;
+		return;
+	}
+
+	while ( n_queue>0 && queue[0].due<=t )
+	{
+		SPARSEENTRY entry = queue[0];
+		sparsesync_pop();
+
+		/* entries of objects that were woken early are stale */
+		if ( parked[entry.pass][entry.obj->id]==entry.due )
+		{
+			OBJECT *parent;
+			sparsesync_wake_pass(entry.obj,entry.pass);
+			for ( parent=entry.obj->parent ; parent!=NULL ; parent=parent->parent )
+				sparsesync_wake_object(parent,0);
+		}
+	}
+}
+
+/** Sync the due objects of a rank list, parking those that would skip **/
+void sparsesync_run(unsigned int pass, int i, SPARSESYNCCALL call)
+{
+	SPARSELIST *item = &list[pass][i];
+	unsigned int n, w = 0;
+
+	/* merge woken objects back in list order */
+	if ( item->n_pending>0 )
+	{
+		unsigned int a = item->n_active, p = item->n_pending, k = a+p;
+		qsort(item->pending,p,sizeof(unsigned int),sparsesync_compare);
+		while ( p>0 )
+		{
+			if ( a>0 && position[pass][item->active[a-1]->id]>item->pending[p-1] )
+				item->active[--k] = item->active[--a];
+			else
+				item->active[--k] = item->all[item->pending[--p]];
+		}
+		item->n_active += item->n_pending;
+		item->n_pending = 0;
+	}
+
+	n_visited += item->n_active;
+	global_sparse_sync_skipped += item->n_all-item->n_active;
+	for ( n=0 ; n<item->n_active ; n++ )
+	{
+		OBJECT *obj = item->active[n];
+		TIMESTAMP due = sparsesync_due(obj);
+		if ( due>0 )
+		{
+			parked[pass][obj->id] = due;
+			sparsesync_push(due,obj,pass);
+			continue;
+		}
+		call(0,obj);
+		item->active[w++] = obj;
+		sparsesync_wake_object(obj,pass);
+
+		/* get out of the loop so others don't run on bad status */
+		if ( obj->valid_to==TS_INVALID )
+		{
+			for ( n++ ; n<item->n_active ; n++ )
+				item->active[w++] = item->active[n];
+			break;
+		}
+	}
+	item->n_active = w;
+}
+
+/** Earliest time posted by the syncs skipped in this iteration, rounded to the minimum timestep
+	@return the time, or TS_NEVER when nothing was skipped
+ **/
+TIMESTAMP sparsesync_next(void)
+{
+	TIMESTAMP t = step;
+	while ( n_queue>0 && parked[queue[0].pass][queue[0].obj->id]!=queue[0].due )
+		sparsesync_pop();
+	if ( n_queue>0 && queue[0].due<t )
+		t = queue[0].due;
+	if ( global_minimum_timestep>1 && t>global_clock && t<TS_NEVER )
+		t = (((t-1)/global_minimum_timestep)+1)*global_minimum_timestep;
+	return t;
+}
+
+/** Count the object syncs visited and the ones skipped by parking **/
+void sparsesync_getstats(int64 *visited, int64 *skipped)
+{
+	*visited = n_visited;
+	*skipped = global_sparse_sync_skipped;
+}
@@ -0,0 +1,21 @@
+/* sparsesync.h
+ * Copyright (C) 2008 Battelle Memorial Institute
+ * Sparse dispatch of object syncs that are safe to skip.
+ */
+
+#ifndef _SPARSESYNC_H
+#define _SPARSESYNC_H
+
+#include "index.h"
+#include "object.h"
+
+/** Sync call made on each object that is due, with the thread number and the object **/
+typedef void (*SPARSESYNCCALL)(int thread, void *item);
+
+STATUS sparsesync_init(INDEX **ranks);
+void sparsesync_wake(TIMESTAMP t);
+void sparsesync_run(unsigned int pass, int ordinal, SPARSESYNCCALL call);
+TIMESTAMP sparsesync_next(void);
+void sparsesync_getstats(int64 *visited, int64 *skipped);
+
+#endif
@@ -11,6 +11,13 @@
 #include "config.h"
 #endif
 
+#if !defined WIN32 && !defined __MACH__
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* for pthread_setaffinity_np() */
+#endif
+#include <sched.h>
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -22,9 +29,14 @@
 
 #include "globals.h"
 #include "threadpool.h"
+#include "instrument.h"
 
 // should include output.h, but this causes a conflict with int64
 int output_error(const char *format,...);
+int output_warning(const char *format,...);
+int output_verbose(const char *format,...);
+// should include module.h, but this causes a conflict with int64
+unsigned short sched_get_cpuid(unsigned short n);
 // should include exec.h, but this causes a conflict with int64
 int64 exec_clock(void);
 
@@ -76,84 +88,317 @@ int processor_count(void)
 }
 #endif /* HAVE_GET_NPROCS */
 
-static MTICODE iterator_proc(MTIPROC *tp)
+/* a set of tasks forked by one tp_run() call; a task that calls tp_run() itself
+   starts a nested run, which the pool processes alongside the one it came from */
+typedef struct s_tprun {
+	TPTASK **task;
+	unsigned int n_tasks;
+	unsigned int n_left;		/* tasks of the run not yet completed */
+	struct s_tprun *next;
+} TPRUN;
+
+/* the worker pool */
+static pthread_mutex_t tp_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t tp_signal = PTHREAD_COND_INITIALIZER; /* broadcast when work is posted or a task completes */
+static pthread_t *tp_thread = NULL;
+static unsigned int tp_n_threads = 1;
+static TPRUN *tp_runs = NULL; /* runs in progress, latest first */
+static int tp_stop = 0;
+static THREADLOCAL unsigned int tp_self = (unsigned int)-1; /* pool thread number, -1 if not a pool thread */
+
+#if defined HAVE_CPU_SET_T && defined HAVE_CPU_SET_MACROS && !defined WIN32 && !defined __MACH__
+#define TP_PINNING
+static cpu_set_t tp_cpuset; /* processors of the process, given back to threads that are not pool threads */
+static int tp_pinned = 0;
+#endif
+
+/* pin a worker thread to the processor the scheduler reserved for it; the calling
+   thread of tp_init() is not pinned so that the threads and processes it creates
+   keep all the processors of the process */
+static void tp_pin(unsigned int thread)
 {
-	MTI *mti = tp->mti;
+#ifdef TP_PINNING
+	unsigned short cpu = sched_get_cpuid((unsigned short)thread);
+	cpu_set_t cpuset;
+	if ( cpu==(unsigned short)-1 )
+		return;
+	CPU_ZERO(&cpuset);
+	CPU_SET(cpu,&cpuset);
+	if ( pthread_setaffinity_np(pthread_self(),sizeof(cpuset),&cpuset)!=0 )
+		output_warning("unable to pin thread %u to processor %u", thread, cpu);
+	else
+		tp_pinned = 1;
+#endif
+}
 
-	/* create the final result */
-	MTIDATA final = mti->fn->set(NULL,NULL);
+void tp_release(void)
+{
+#ifdef TP_PINNING
+	if ( tp_pinned )
+		pthread_setaffinity_np(pthread_self(),sizeof(tp_cpuset),&tp_cpuset);
+#endif
+}
 
-	/* loop as long as enabled */
-	while ( tp->enabled )
+/* claim the next chunk of a run in progress, or only of the run given; must be
+   called with the pool locked
+   @returns the task of the chunk, or NULL if no chunk is ready */
+static TPTASK *tp_claim(TPRUN *only, TPRUN **run, unsigned int *first, unsigned int *last)
+{
+	TPRUN *item;
+	for ( item=(only?only:tp_runs) ; item!=NULL ; item=(only?NULL:item->next) )
 	{
-		size_t n;
+		unsigned int n;
+		for ( n=0 ; n<item->n_tasks ; n++ )
+		{
+			TPTASK *task = item->task[n];
+
+			/* start tasks whose dependency is completed */
+			if ( task->state==TPS_WAITING && (task->depends==NULL || task->depends->state==TPS_DONE) )
+			{
+				if ( task->n_items==0 )
+				{
+					task->state = TPS_DONE;
+					item->n_left--;
+					pthread_cond_broadcast(&tp_signal);
+					continue;
+				}
+				task->state = TPS_READY;
+			}
+			if ( task->state==TPS_READY && task->next<task->n_items )
+			{
+				*first = task->next;
+				*last = task->next + task->chunk;
+				if ( *last>task->n_items )
+					*last = task->n_items;
+				task->next = *last;
+				*run = item;
+				return task;
+			}
+		}
+	}
+	return NULL;
+}
 
-		/* create the itermediate result */
-		MTIDATA result = mti->fn->set(NULL,NULL);
-		
-		/* lock access to the start condition */
-		pthread_mutex_lock(mti->start.lock);
+/* process a chunk with the pool unlocked and record its result */
+static void tp_process(TPRUN *run, TPTASK *task, unsigned int first, unsigned int last, unsigned int thread)
+{
+	clock_t t0 = (clock_t)exec_clock();
+	TIMESTAMP t2;
+	pthread_mutex_unlock(&tp_lock);
+	t2 = task->call(task,first,last,thread);
+	pthread_mutex_lock(&tp_lock);
+	task->runtime += (clock_t)exec_clock() - t0;
+	if ( t2<task->t2 )
+		task->t2 = t2;
+	task->n_left -= last-first;
+	if ( task->n_left==0 )
+	{
+		task->state = TPS_DONE;
+		run->n_left--;
+		pthread_cond_broadcast(&tp_signal);
+	}
+}
 
-		/* wait for the start condition to be satisfied */
-		mti_debug(mti,"iterator %d waiting for start condition",tp->id);
-		while ( mti->fn->compare(tp->data,mti->input)==0 )
-			pthread_cond_wait(mti->start.cond,mti->start.lock);
+static void *tp_worker(void *arg)
+{
+	unsigned int thread = (unsigned int)(size_t)arg;
+	int64 it = instrument_now();
+	int list = -1; /* rank list of the last task processed */
+	instrument_thread("worker %u", thread);
+	tp_self = thread;
+	tp_pin(thread);
+	pthread_mutex_lock(&tp_lock);
+	while ( !tp_stop )
+	{
+		unsigned int first, last;
+		TPRUN *run;
+		TPTASK *task = tp_claim(NULL,&run,&first,&last);
+		if ( task!=NULL )
+		{
+			instrument_span_arg("barrier",IC_WAIT,it,list);
+			tp_process(run,task,first,last,thread);
+			list = (int)task->list-1;
+			it = instrument_now();
+		}
+		else
+			pthread_cond_wait(&tp_signal,&tp_lock);
+	}
+	pthread_mutex_unlock(&tp_lock);
+	return NULL;
+}
 
-		/* unlock access to the start condition */
-		pthread_mutex_unlock(mti->start.lock);
+unsigned int tp_init(void)
+{
+	unsigned int n;
 
-		/* reset the final result */
-		mti->fn->set(final,NULL);
+	/* set thread count equal to processor count if not passed on command-line */
+	tp_self = 0;
+	if ( global_threadcount==0 )
+		global_threadcount = processor_count();
+	if ( tp_thread!=NULL || global_threadcount<2 )
+		return tp_n_threads;
 
-		/* process each item in the list */
-		mti_debug(mti,"iterator %d started", tp->id);
-		tp->active = TRUE;
-		for ( n=0 ; n<tp->n_items ; n++ )
+	tp_thread = (pthread_t*)malloc(sizeof(pthread_t)*global_threadcount);
+	if ( tp_thread==NULL )
+	{
+		output_error("tp_init memory allocation failed");
+		/* TROUBLESHOOT
+		   Memory allocation failed starting the worker pool.  Free up
+		   memory and try again.
+		 */
+		return tp_n_threads;
+	}
+#ifdef TP_PINNING
+	if ( sched_getaffinity(0,sizeof(tp_cpuset),&tp_cpuset)!=0 )
+		CPU_ZERO(&tp_cpuset);
+#endif
+	tp_stop = 0;
+	for ( n=1 ; n<(unsigned int)global_threadcount ; n++ )
+	{
+		if ( pthread_create(&tp_thread[n],NULL,tp_worker,(void*)(size_t)n)!=0 )
 		{
-			/* reset the itermediate result */
-			mti->fn->set(result,NULL);
+			output_warning("only %u of %d worker threads could be started", n, global_threadcount);
+			/* TROUBLESHOOT
+			   The system refused to create more threads for the worker pool.  The
+			   simulation continues with the threads that were started.  Reduce
+			   the threadcount or raise the system thread limit and try again.
+			 */
+			break;
+		}
+	}
+	tp_n_threads = n;
+	output_verbose("using %u pool thread(s)", tp_n_threads);
+	return tp_n_threads;
+}
+
+TIMESTAMP tp_run(TPTASK **task, unsigned int n_tasks)
+{
+	TIMESTAMP t2 = TS_NEVER;
+	unsigned int n, first, last;
+	TPRUN run, **item;
+	TPTASK *next;
 
-			/* make the call */
-			mti->fn->call(result,tp->item[n],mti->input);
+	/* prepare the tasks */
+	for ( n=0 ; n<n_tasks ; n++ )
+	{
+		unsigned int size = tp_n_threads*4;
+		task[n]->state = TPS_WAITING;
+		task[n]->t2 = TS_NEVER;
+		task[n]->next = 0;
+		task[n]->n_left = task[n]->n_items;
+		task[n]->chunk = (task[n]->n_items+size-1)/size;
+		if ( task[n]->chunk<task[n]->grain )
+			task[n]->chunk = task[n]->grain;
+		if ( task[n]->chunk==0 )
+			task[n]->chunk = 1;
+	}
 
-			/* gather result */
-			mti->fn->gather(final,result);
+	/* a single thread runs the tasks in order (also in what-if children, which have no
+	   pool, and on threads that are not pool threads) */
+	if ( tp_n_threads<2 || global_threadcount==1 || tp_self==(unsigned int)-1 )
+	{
+		for ( n=0 ; n<n_tasks ; n++ )
+		{
+			if ( task[n]->n_items>0 )
+			{
+				clock_t t0 = (clock_t)exec_clock();
+				task[n]->t2 = task[n]->call(task[n],0,task[n]->n_items,0);
+				task[n]->runtime += (clock_t)exec_clock() - t0;
+			}
+			task[n]->state = TPS_DONE;
+			task[n]->n_left = 0;
+			if ( task[n]->t2<t2 )
+				t2 = task[n]->t2;
 		}
-		tp->active = FALSE;
-		mti_debug(mti,"iterator %d completed", tp->id);
+		return t2;
+	}
 
-		/* update the current data */
-		mti->fn->set(tp->data,mti->input);
+	/* fork the tasks onto the pool and help with them until all are completed; a
+	   nested run is helped only with its own tasks, so the chunk that started it is
+	   not held up by unrelated work */
+	run.task = task;
+	run.n_tasks = n_tasks;
+	run.n_left = n_tasks;
+	pthread_mutex_lock(&tp_lock);
+	run.next = tp_runs;
+	tp_runs = &run;
+	pthread_cond_broadcast(&tp_signal);
+	while ( run.n_left>0 )
+	{
+		TPRUN *mine;
+		if ( (next=tp_claim(&run,&mine,&first,&last))!=NULL )
+			tp_process(&run,next,first,last,tp_self);
+		else if ( run.n_left>0 )
+		{
+			int64 it = instrument_now();
+			pthread_cond_wait(&tp_signal,&tp_lock);
+			instrument_span_arg("barrier",IC_WAIT,it,(int)task[0]->list-1);
+		}
+	}
+	for ( item=&tp_runs ; *item!=&run ; item=&(*item)->next ) {}
+	*item = run.next;
+	pthread_mutex_unlock(&tp_lock);
 
-		/* lock the stop condition */
-		pthread_mutex_lock(mti->stop.lock);
+	for ( n=0 ; n<n_tasks ; n++ )
+	{
+		if ( task[n]->t2<t2 )
+			t2 = task[n]->t2;
+	}
+	return t2;
+}
 
-		/* decrement the stop counter */
-		mti->stop.count--;
+void tp_term(void)
+{
+	unsigned int n;
+	if ( tp_thread==NULL )
+		return;
+	pthread_mutex_lock(&tp_lock);
+	tp_stop = 1;
+	pthread_cond_broadcast(&tp_signal);
+	pthread_mutex_unlock(&tp_lock);
+	for ( n=1 ; n<tp_n_threads ; n++ )
+		pthread_join(tp_thread[n],NULL);
+	free(tp_thread);
+	tp_thread = NULL;
+	tp_n_threads = 1;
+}
 
-		/* gather output */
-		mti->fn->gather(mti->output,final);
+unsigned int tp_threadcount(void)
+{
+	return tp_n_threads;
+}
 
-		/* notify all of stop condition */
-		pthread_cond_broadcast(mti->stop.cond);
+/* process a chunk of an MTI */
+static TIMESTAMP mti_task_call(TPTASK *task, unsigned int first, unsigned int last, unsigned int thread)
+{
+	MTI *mti = (MTI*)task->data;
+	MTIDATA final = mti->fn->set(NULL,NULL);
+	MTIDATA result = mti->fn->set(NULL,NULL);
+	unsigned int n;
+	for ( n=first ; n<last ; n++ )
+	{
+		/* reset the itermediate result */
+		mti->fn->set(result,NULL);
 
-		/* unlock stop condition */
-		pthread_mutex_unlock(mti->stop.lock);
+		/* make the call */
+		mti->fn->call(result,mti->item[n],mti->input);
 
-		/* free the itermediate result */
-		free(result);
+		/* gather result */
+		mti->fn->gather(final,result);
 	}
 
-	/* free the final result */
-	free(final);
+	/* gather output */
+	pthread_mutex_lock(&mti->lock);
+	mti->fn->gather(mti->output,final);
+	pthread_mutex_unlock(&mti->lock);
 
-	/* exit */
-	return (MTICODE)0;
+	free(result);
+	free(final);
+	return TS_NEVER;
 }
 
 MTI *mti_init(const char *name, MTIFUNCTIONS *fn, size_t minitems)
 {
-	pthread_cond_t new_cond = PTHREAD_COND_INITIALIZER;
 	pthread_mutex_t new_mutex = PTHREAD_MUTEX_INITIALIZER;
 	MTI *mti = NULL;
 	size_t nitems=0, items_per_process=0;
@@ -175,48 +420,30 @@ MTI *mti_init(const char *name, MTIFUNCTIONS *fn, size_t minitems)
 	/* construct MTI */
 	mti = (MTI*)malloc(sizeof(MTI));
 	if ( mti==NULL ) return NULL;
+	memset(mti,0,sizeof(MTI));
 	mti->name = name;
-	mti->start.cond = (pthread_cond_t*)malloc(sizeof(pthread_cond_t));
-	memcpy(mti->start.cond,&new_cond,sizeof(new_cond));
-	mti->start.lock = (pthread_mutex_t*)malloc(sizeof(pthread_mutex_t));
-	memcpy(mti->start.lock,&new_mutex,sizeof(new_mutex));
-	mti->start.count = 0;
-	mti->stop.cond = (pthread_cond_t*)malloc(sizeof(pthread_cond_t));
-	memcpy(mti->stop.cond,&new_cond,sizeof(new_cond));
-	mti->stop.lock = (pthread_mutex_t*)malloc(sizeof(pthread_mutex_t));
-	memcpy(mti->stop.lock,&new_mutex,sizeof(new_mutex));
-	mti->stop.count = 0;
+	memcpy(&mti->lock,&new_mutex,sizeof(new_mutex));
 	mti->input = fn->set(NULL,NULL);
 	mti->output = fn->set(NULL,NULL);
 	mti->runtime = 0;
 	mti->fn = fn;
 
 	/* compute number of threads */
-	mti->n_processes = global_threadcount;
+	mti->n_processes = tp_threadcount();
 	if ( nitems<mti->n_processes*minitems )
 		mti->n_processes = (unsigned int)(nitems/minitems);
 	if ( mti->n_processes==0 )
 		mti->n_processes = 1;
 	items_per_process = nitems/mti->n_processes;
-	mti->n_processes = (unsigned int)(nitems/items_per_process);
-	if ( mti->n_processes*items_per_process<nitems )
-		mti->n_processes++;
 	mti_debug(mti,"nitems = %d", nitems);
 	mti_debug(mti,"nprocs = %d", mti->n_processes);
 	mti_debug(mti,"items/proc = %d", items_per_process);
 
-	/* construct process info if needed */
+	/* index the items to be processed */
 	if ( mti->n_processes>1 )
 	{
-		int p;
-
-		/* get first item */
-		MTIITEM item = fn->get(NULL);
-
-		/* allocate/clear/init process list */
-		mti_debug(mti,"preparing %d processes", mti->n_processes);
-		mti->process = (MTIPROC*)malloc(sizeof(MTIPROC)*mti->n_processes);
-		if ( mti->process==NULL )
+		mti->item = (MTIITEM*)malloc(sizeof(MTIITEM)*nitems);
+		if ( mti->item==NULL )
 		{
 			output_error("mti_init memory allocation failed");
 			/* TROUBLESHOOT
@@ -225,31 +452,14 @@ MTI *mti_init(const char *name, MTIFUNCTIONS *fn, size_t minitems)
 			 */
 			return NULL;
 		}
-		memset(mti->process,0,sizeof(MTIPROC)*mti->n_processes);
-		for ( p=0 ; p<(int)(mti->n_processes) ; p++ )
-		{
-			MTIPROC *proc = &mti->process[p];
-			proc->mti = mti;
-			proc->active = FALSE;
-			proc->data = fn->set(NULL,NULL);
-			proc->item = (MTIITEM*)malloc(sizeof(MTIITEM)*items_per_process);
-			proc->n_items = 0;
-			proc->id = p;
-
-			/* index the items to be processed */
-			while ( item!=NULL && proc->n_items<items_per_process )
-			{
-				proc->item[proc->n_items++] = item;
-				item = fn->get(item);
-			}
-
-			/* create thread to handle the list */
-			proc->enabled  = ( pthread_create(&proc->thread_id,NULL,(void*(*)(void*))iterator_proc,proc)==0 );
-			mti_debug(mti,"proc=%d; enabled=%d, nitems=%d", p, proc->enabled, proc->n_items);
-		}
+		for ( item=fn->get(NULL) ; item!=NULL && mti->n_items<nitems ; item=fn->get(item) )
+			mti->item[mti->n_items++] = item;
+		mti->task.name = name;
+		mti->task.call = mti_task_call;
+		mti->task.data = (void*)mti;
+		mti->task.n_items = mti->n_items;
+		mti->task.grain = (unsigned int)minitems;
 	}
-	else
-		mti->process = NULL;	
 	
 	return mti;
 }
@@ -257,6 +467,7 @@ MTI *mti_init(const char *name, MTIFUNCTIONS *fn, size_t minitems)
 int mti_run(MTIDATA result, MTI *mti, MTIDATA input)
 {
 	clock_t t0 = (clock_t)exec_clock();
+	TPTASK *task = &mti->task;
 	mti->fn->set(result,NULL);
 
 	/* no update required */
@@ -277,37 +488,18 @@ int mti_run(MTIDATA result, MTI *mti, MTIDATA input)
 	/* multi threaded update */
 	else
 	{
-		mti_debug(mti,"starting %d iterators", mti->n_processes);
-
-		/* lock access to stop condition */
-		pthread_mutex_lock(mti->stop.lock);
-
-		/* reset the stop condition */
-		mti->stop.count = mti->n_processes;
-
-		/* lock access to the start condition */
-		pthread_mutex_lock(mti->start.lock);
+		mti_debug(mti,"starting %d items on the pool", mti->n_items);
 
 		/* set start condition */
 		mti->fn->set(mti->input,input);
 		mti->fn->set(mti->output,NULL);
 
-		/* broadcast start condition */
-		pthread_cond_broadcast(mti->start.cond);
-
-		/* unlock access to start condition */
-		pthread_mutex_unlock(mti->start.lock);
-
-		/* wait for stop condition */
-		while ( mti->stop.count>0 )
-			pthread_cond_wait(mti->stop.cond,mti->stop.lock);
-
-		/* unlock access to stop condition */
-		pthread_mutex_unlock(mti->stop.lock);
+		/* run the items */
+		tp_run(&task,1);
 
 		/* gather result */
 		mti->fn->gather(result,mti->output);
-		mti_debug(mti,"%d iterators completed", mti->n_processes);
+		mti_debug(mti,"%d items completed", mti->n_items);
 	}
 	mti->runtime += (clock_t)exec_clock() - t0;
 	return 1;
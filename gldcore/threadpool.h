@@ -38,6 +38,23 @@ instead.
 
 An example of how this is done is implemented in exec.c for commit_all().
 
+MTIs, the object rank lists and the internal property syncs all run on a
+single persistent pool of worker threads, which is started by #tp_init() once
+the thread count is known.  Work is given to the pool as tasks (#TPTASK), each
+of which is a list of items processed in chunks by whichever threads are free.
+A task may depend on another task, in which case it is not started until the
+other is completed.  #tp_run() forks a set of tasks onto the pool, helps
+process them on the calling thread, and returns when all are completed, so
+that independent tasks share a single fork/join.
+
+Worker threads are numbered 1 to #tp_threadcount()-1; the thread that called
+#tp_init() is thread 0.  When the scheduler has reserved a processor for each
+thread, each worker thread is pinned to its processor.  Thread 0 is not pinned,
+and a thread created by a worker should call #tp_release() so that it does not
+share the worker's processor.  A task may call #tp_run() itself, in which case
+its tasks are processed by the pool alongside the run it came from.  Threads
+that are not pool threads run their tasks themselves.
+
 @{**/
 
 #ifndef _THREADPOOL_H
@@ -99,32 +116,53 @@ typedef struct s_mtifunctions
 	int (*reject)(MTI*,MTIDATA);
 } MTIFUNCTIONS; /**< iteration function table */
 	
-/** Thread iterator data for each iterator **/
-typedef struct s_mtiterator {
-    unsigned int id;            /**< id given to iterator */
-    MTI *mti;                   /**< pointer to MTI that controls this iterator */
-    pthread_t thread_id;        /**< pthread handle/id */
-    int enabled;                /**< flag indicating thread is enabled */
-    int active;                 /**< flag indicating thread is active */
-    MTIITEM *item;              /**< pointer to array of items */
-    unsigned int n_items  ;     /**< number of items */
-    MTIDATA data;               /**< iterator data */
-} MTIPROC; /**< iterator process structure */
+/** Pool task **/
+typedef struct s_tptask TPTASK;
+
+/** Task call function prototype
+    These functions process the items first to last-1 of a task on the thread given.
+    @returns the earliest time returned by the items, or TS_NEVER
+ **/
+typedef TIMESTAMP (*TPCALLFN)(TPTASK *task, unsigned int first, unsigned int last, unsigned int thread);
+
+/** Pool task state **/
+typedef enum {
+	TPS_DONE=0,		/**< task is completed (or not submitted) */
+	TPS_WAITING,	/**< task is waiting for the task it depends on */
+	TPS_READY,		/**< task chunks may be claimed */
+} TPSTATE;
+
+/** Pool task control block **/
+struct s_tptask {
+	const char *name;			/**< name of the task */
+	TPCALLFN call;				/**< function called on each chunk */
+	void *data;					/**< data used by the call function */
+	unsigned int n_items;		/**< number of items to process */
+	unsigned int grain;			/**< minimum number of items per chunk */
+	TPTASK *depends;			/**< task that must be completed first (NULL if none) */
+	TIMESTAMP t1;				/**< time given to the call function */
+	TIMESTAMP t2;				/**< earliest time returned by the call function */
+	clock_t runtime;			/**< processor time used by the calls */
+	unsigned int list;			/**< 1 + the object rank list the task syncs (0 for other tasks), shown with the barrier spans that follow the task */
+	/* state used by the pool */
+	TPSTATE state;				/**< run state of the task */
+	unsigned int chunk;			/**< number of items per chunk */
+	unsigned int next;			/**< first item of the next chunk to claim */
+	unsigned int n_left;		/**< number of items not yet processed */
+};
 
 /** Thread iterator control block */
 struct s_mtiteratorlist {
     const char *name;           /**< name given to iterator */
-    struct {
-        pthread_cond_t *cond;   /**< condition variable */    
-        pthread_mutex_t *lock;  /**< mutex object */
-        unsigned int count;     /**< start/stop counter */
-    } start, stop;              /**< start and stop cond/mutex */
+    pthread_mutex_t lock;       /**< lock on the output data */
     MTIDATA input;              /**< iterator input data */
     MTIDATA output;             /**< iterator output data */
     MTIFUNCTIONS *fn;		/**< function table */
     clock_t runtime;            /**< runtime clock */
-    unsigned int n_processes;   /**< number of iterators */
-    MTIPROC *process;           /**< list of iterator processes */
+    unsigned int n_processes;   /**< number of threads used by the iterator */
+    MTIITEM *item;              /**< array of items */
+    unsigned int n_items;       /**< number of items */
+    TPTASK task;                /**< pool task that runs the iterator */
 }; /** iterator list structure */
 
 #ifdef __cplusplus
@@ -158,6 +196,39 @@ int mti_run(MTIDATA result,   /**< result of iterator */
             MTIDATA input);   /**< data to send to iterator call function */
 
 int processor_count(void);
+
+/** Start the worker pool
+
+    Call this function once the thread count is final.  A thread count of 0
+    is replaced by the number of processors.
+
+    @returns the number of threads, including the calling thread
+ **/
+unsigned int tp_init(void);
+
+/** Run pool tasks
+
+    Call this function to process the tasks given and wait for them to complete.
+    A task must be listed after the task it depends on.
+
+    @returns the earliest time returned by the tasks, or TS_NEVER
+ **/
+TIMESTAMP tp_run(TPTASK **task, /**< list of tasks to run */
+                 unsigned int n_tasks); /**< number of tasks in list */
+
+/** Give the calling thread all the processors of the process
+
+    Call this function at the start of a thread that may have been created
+    by a pinned worker thread.
+ **/
+void tp_release(void);
+
+/** Stop the worker pool **/
+void tp_term(void);
+
+/** Get the number of pool threads, including the calling thread **/
+unsigned int tp_threadcount(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -68,6 +68,17 @@ static TIMESTAMP dststart[1000], dstend[1000];
 static TIMESTAMP tzoffset;
 static char current_tzname[64], tzstd[32], tzdst[32];
 
+/* calendar context published for the current clock (double-buffered so readers never see a partial update) */
+static CALENDARCONTEXT clock_context[2];
+static CALENDARCONTEXT * volatile clock_calendar = NULL;
+static unsigned int clock_calendar_lock = 0;
+
+/* bumped whenever the timezone rules change so cached conversions are discarded */
+static volatile unsigned int tz_generation = 1;
+
+/* last conversion made by this thread */
+static THREADLOCAL CALENDARCONTEXT last_calendar;
+
 #define LOCALTIME(T) ((T)-tzoffset+(isdst((T))?3600:0))
 #define GMTIME(T) ((T)+tzoffset-(isdst((T)+tzoffset)?3600:0))
 
@@ -203,10 +214,8 @@ int local_tzoffset(TIMESTAMP t)
 #endif
 }
 
-/** Converts a GMT timestamp to local datetime struct
-	Adjusts to TZ if possible
- **/
-int local_datetime(TIMESTAMP ts, DATETIME *dt)
+/* converts a GMT timestamp to local datetime struct without using the calendar caches */
+static int convert_datetime(TIMESTAMP ts, DATETIME *dt)
 {
 
 	int64 n;
@@ -214,12 +223,6 @@ int local_datetime(TIMESTAMP ts, DATETIME *dt)
 	TIMESTAMP local;
 	int tsyear;
 
-#ifdef USE_TS_CACHE
-	/* allow caching */
-	static TIMESTAMP old_ts =0;
-	static DATETIME old_dt;
-#endif
-
 	if( ts == TS_NEVER || ts==TS_ZERO )
 		return 0;
 
@@ -228,13 +231,6 @@ int local_datetime(TIMESTAMP ts, DATETIME *dt)
 		output_error("local_datetime(ts=%lli,...): invalid local_datetime request",ts);
 		return 0;
 	}
-#ifdef USE_TS_CACHE
-	/* check cache */
-	if (old_ts == ts && old_ts!=0)
-		memcpy(dt,&old_dt,sizeof(DATETIME));
-	else
-		old_ts = 0;
-#endif
 
 	local = LOCALTIME(ts);
 	tsyear = timestamp_year(local, &rem);
@@ -324,14 +320,104 @@ int local_datetime(TIMESTAMP ts, DATETIME *dt)
 	/* timezone offset in seconds */
 	dt->tzoffset = (int)(tzoffset - (isdst(dt->timestamp)?3600:0));
 
-#ifdef USE_TS_CACHE
-	/* cache result */
-	old_ts = ts;
-	memcpy(&old_dt,dt,sizeof(old_dt));
-#endif
 	return 1;
 }
 
+/** Converts a GMT timestamp to its local calendar context
+	The result is memoized per thread and the context of the current clock is
+	shared, so repeated conversions of the same timestamp are cheap and thread-safe.
+	@return 1 on success, 0 on failure
+ **/
+int local_calendar(TIMESTAMP ts, CALENDARCONTEXT *cal)
+{
+	CALENDARCONTEXT *ctx = clock_calendar;
+	unsigned int generation = tz_generation;
+	DATETIME *dt = &(cal->dt);
+
+	/* same as the clock */
+	if ( ctx!=NULL && ctx->dt.timestamp==ts && ctx->generation==generation )
+	{
+		memcpy(cal,ctx,sizeof(CALENDARCONTEXT));
+		return 1;
+	}
+
+	/* same as the last conversion on this thread */
+	if ( last_calendar.generation==generation && last_calendar.dt.timestamp==ts )
+	{
+		memcpy(cal,&last_calendar,sizeof(CALENDARCONTEXT));
+		return 1;
+	}
+
+	if ( !convert_datetime(ts,dt) )
+		return 0;
+
+	/* calendar is based on the weekday of Jan 1 and LY status */
+	cal->calendar = (unsigned short)(((dt->weekday-dt->yearday+53*7)%7)*2 + ISLEAPYEAR(dt->year));
+	cal->minute = (dt->yearday*24 + dt->hour)*60 + dt->minute;
+	cal->generation = generation;
+	memcpy(&last_calendar,cal,sizeof(CALENDARCONTEXT));
+	return 1;
+}
+
+/** Converts a GMT timestamp to local datetime struct
+	Adjusts to TZ if possible
+ **/
+int local_datetime(TIMESTAMP ts, DATETIME *dt)
+{
+	CALENDARCONTEXT *ctx = clock_calendar;
+	CALENDARCONTEXT cal;
+
+	/* most calls are for the current clock */
+	if ( ctx!=NULL && ctx->dt.timestamp==ts && ctx->generation==tz_generation )
+	{
+		memcpy(dt,&(ctx->dt),sizeof(DATETIME));
+		return 1;
+	}
+	if ( !local_calendar(ts,&cal) )
+		return 0;
+	memcpy(dt,&(cal.dt),sizeof(DATETIME));
+	return 1;
+}
+
+/** Publish the calendar context of the clock
+	Called by the main loop each time the clock advances so that objects
+	reading the local time during sync share one conversion.  A context that
+	is already current is left alone, so that callers racing to refresh it
+	during a pass never rewrite the slot another thread may still be reading;
+	the slots are only swapped when the clock or the timezone changes, which
+	happens between passes.
+ **/
+void timestamp_update_calendar(TIMESTAMP ts)
+{
+	CALENDARCONTEXT *next;
+	wlock(&clock_calendar_lock);
+	if ( clock_calendar!=NULL && clock_calendar->dt.timestamp==ts && clock_calendar->generation==tz_generation )
+	{
+		wunlock(&clock_calendar_lock);
+		return;
+	}
+	next = ( clock_calendar==clock_context ) ? clock_context+1 : clock_context;
+	if ( local_calendar(ts,next) )
+		clock_calendar = next;
+	wunlock(&clock_calendar_lock);
+}
+
+/** Get the calendar context of the current clock
+	@return a pointer to the read-only context, or NULL if the clock cannot be converted
+ **/
+const CALENDARCONTEXT *timestamp_calendar(void)
+{
+	CALENDARCONTEXT *ctx = clock_calendar;
+	if ( ctx==NULL || ctx->dt.timestamp!=global_clock || ctx->generation!=tz_generation )
+	{
+		timestamp_update_calendar(global_clock);
+		ctx = clock_calendar;
+		if ( ctx==NULL || ctx->dt.timestamp!=global_clock )
+			return NULL;
+	}
+	return ctx;
+}
+
 /** Convert a datetime struct into a GMT timestamp
  **/
 TIMESTAMP mkdatetime(DATETIME *dt)
@@ -725,6 +811,7 @@ void load_tzspecs(char *tz){
 
 	found = 0;
 	tzvalid = 0;
+	tz_generation++;
 	pTzname = tz_name(tz);
 
 	if(pTzname == 0){
@@ -833,6 +920,7 @@ void load_tzspecs(char *tz){
 
 	fclose(fp);
 	tzvalid = 1;
+	tz_generation++;
 }
 
 /** Establish the default timezone for time conversion.
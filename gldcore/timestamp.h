@@ -64,6 +64,13 @@ typedef struct s_datetime {
 	int tzoffset; /**< time zone offset in seconds (-43200 - 43200) */
 } DATETIME; /**< the s_datetime structure */
 
+typedef struct s_calendarcontext {
+	DATETIME dt; /**< local date/time */
+	unsigned short calendar; /**< calendar index (weekday of Jan 1 * 2 + leap year, 0-13) */
+	unsigned int minute; /**< minute of year (0 to 527039) */
+	unsigned int generation; /**< timezone generation the context was computed under */
+} CALENDARCONTEXT; /**< the local calendar context of a timestamp */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -82,6 +89,9 @@ double timestamp_to_seconds(TIMESTAMP t);
 TIMESTAMP convert_to_timestamp(const char *value);
 TIMESTAMP convert_to_timestamp_delta(const char *value, unsigned int *nanoseconds, double *dbl_time_value);
 int local_datetime(TIMESTAMP ts, DATETIME *dt);
+int local_calendar(TIMESTAMP ts, CALENDARCONTEXT *cal);
+const CALENDARCONTEXT *timestamp_calendar(void);
+void timestamp_update_calendar(TIMESTAMP ts);
 
 int timestamp_test(void);
 
@@ -17,6 +17,7 @@
 #include "exception.h"
 #include "module.h"
 #include "exec.h"
+#include "threadpool.h"
 
 static TRANSFORM *schedule_xformlist=NULL;
 
@@ -429,6 +430,21 @@ TIMESTAMP transform_apply(TIMESTAMP t1, TRANSFORM *xform, double *source)
 }
 
 clock_t transform_synctime = 0;
+
+/* apply a transform at time t1 */
+static TIMESTAMP transform_sync(TIMESTAMP t1, TRANSFORM *xform)
+{
+	if((xform->source_type == XS_SCHEDULE) && (xform->target_obj->schedule_skew != 0)){
+		TIMESTAMP t = t1 - xform->target_obj->schedule_skew; // subtract so the +12 is 'twelve seconds later', not earlier
+		if((t < xform->source_schedule->since) || (t >= xform->source_schedule->next_t)){
+			SCHEDULEINDEX index = schedule_index(xform->source_schedule,t);
+			double value = schedule_value(xform->source_schedule,index);
+			return transform_apply(t1,xform,&value);
+		}
+	}
+	return transform_apply(t1,xform,NULL);
+}
+
 TIMESTAMP transform_syncall(TIMESTAMP t1, TRANSFORMSOURCE source)
 {
 	TRANSFORM *xform;
@@ -439,29 +455,84 @@ TIMESTAMP transform_syncall(TIMESTAMP t1, TRANSFORMSOURCE source)
 	for (xform=schedule_xformlist; xform!=NULL; xform=xform->next)
 	{	
 		if (xform->source_type&source){
-			if((xform->source_type == XS_SCHEDULE) && (xform->target_obj->schedule_skew != 0)){
-				TIMESTAMP t = t1 - xform->target_obj->schedule_skew; // subtract so the +12 is 'twelve seconds later', not earlier
-				if((t < xform->source_schedule->since) || (t >= xform->source_schedule->next_t)){
-					SCHEDULEINDEX index = schedule_index(xform->source_schedule,t);
-					double value = schedule_value(xform->source_schedule,index);
-					TIMESTAMP t = transform_apply(t1,xform,&value);
-					if ( t<t2 ) t2=t;
-				} 
-				else 
-				{
-					TIMESTAMP t = transform_apply(t1,xform,NULL);
-					if ( t<t2 ) t2=t;
-				}
-			} else {
-				TIMESTAMP t = transform_apply(t1,xform,NULL);
-				if ( t<t2 ) t2=t;
-			}
+			TIMESTAMP t = transform_sync(t1,xform);
+			if ( t<t2 ) t2=t;
 		}
 	}
 	transform_synctime += (clock_t)exec_clock() - start;
 	return t2;
 }
 
+static TRANSFORM **transform_item = NULL; /* transforms indexed for the sync task */
+static TPTASK transform_task;
+
+static TIMESTAMP transform_synccall(TPTASK *task, unsigned int first, unsigned int last, unsigned int thread)
+{
+	TRANSFORM **xform = (TRANSFORM**)task->data;
+	TIMESTAMP t2 = TS_NEVER;
+	unsigned int n;
+	for ( n=first ; n<last ; n++ )
+	{
+		TIMESTAMP t = transform_sync(task->t1,xform[n]);
+		if ( t<t2 ) t2=t;
+	}
+	return t2;
+}
+
+/** get the pool task that applies the transforms of the sources given
+	@return the task, or NULL if there are no such transforms
+	The sources of a task are fixed by its first use.
+ **/
+TPTASK *transform_synctask(TIMESTAMP t1, TRANSFORMSOURCE source)
+{
+	/* index the transforms on first use */
+	if (transform_item==NULL)
+	{
+		TRANSFORM *xform;
+		unsigned int n = 0;
+		for (xform=schedule_xformlist; xform!=NULL; xform=xform->next)
+		{
+			if (xform->source_type&source)
+				n++;
+		}
+		memset(&transform_task,0,sizeof(transform_task));
+		transform_item = (TRANSFORM**)malloc(sizeof(TRANSFORM*)*(n+1));
+		if (transform_item==NULL)
+			throw_exception("transform_synctask(): memory allocation failed");
+			/* TROUBLESHOOT
+				The transform list used by the sync task could not be allocated.
+				Free up memory and try again.
+			 */
+		n = 0;
+		for (xform=schedule_xformlist; xform!=NULL; xform=xform->next)
+		{
+			if (xform->source_type&source)
+				transform_item[n++] = xform;
+		}
+		transform_task.name = "transform";
+		transform_task.call = transform_synccall;
+		transform_task.data = (void*)transform_item;
+		transform_task.n_items = n;
+		transform_task.grain = 16;
+	}
+	if (transform_task.n_items==0)
+		return NULL;
+	transform_task.t1 = t1;
+	transform_task.runtime = 0;
+	return &transform_task;
+}
+
+/** collect the result of the transform sync task
+	@return the time of the next transform update
+ **/
+TIMESTAMP transform_syncdone(TPTASK *task)
+{
+	if (task==NULL)
+		return TS_NEVER;
+	transform_synctime += task->runtime;
+	return task->t2;
+}
+
 int transform_saveall(FILE *fp)
 {
 	int count = 0;
@@ -93,6 +93,8 @@ int transform_add_external(struct s_object_list *target_obj, struct s_property_m
 int transform_add_linear(TRANSFORMSOURCE stype, double *source, void *target, double scale, double bias, struct s_object_list *obj, struct s_property_map *prop, SCHEDULE *s);
 TRANSFORM *transform_getnext(TRANSFORM *xform);
 TIMESTAMP transform_syncall(TIMESTAMP t, TRANSFORMSOURCE source);
+struct s_tptask *transform_synctask(TIMESTAMP t, TRANSFORMSOURCE source);
+TIMESTAMP transform_syncdone(struct s_tptask *task);
 int64 transform_apply(TIMESTAMP t1, TRANSFORM *xform, double *source);
 
 GLDVAR *gldvar_create(unsigned int dim);
@@ -0,0 +1,439 @@
+/* whatif.c
+ * Copyright (C) 2008 Battelle Memorial Institute
+ * Fork-based what-if evaluation of candidate decisions against the running model.
+ *
+ * An object that searches for the best value of a set of decision variables creates a
+ * what-if block describing the variables, the objective and the horizon, and starts a
+ * search.  The search is run by the main loop at the next safe point, i.e., at the top
+ * of the next iteration before any object is synchronized.  For each generation the
+ * search proposes, one child process is forked per candidate (up to whatif_maxprocs at
+ * a time).  The child is a copy-on-write snapshot of the simulation: it applies the
+ * candidate to the decision variables, runs the main loop single-threaded until the
+ * end of the horizon, writes the objective into a shared memory slot and exits.  The
+ * parent collects the objectives, calls the search again with the results and then
+ * continues the simulation where it left off.
+ *
+ * Children must not disturb the parent's outputs, so files a child inherits are
+ * isolated before it runs: regular files opened for reading are reopened at the same
+ * offset (the file position is otherwise shared with the parent) and everything else,
+ * including stdout, is redirected to /dev/null.  Error messages still go to stderr.
+ * Outputs normally open their files on their first sync, before the first search can
+ * run; a file that is first opened by a child is not isolated.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#ifndef WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#endif
+#include "platform.h"
+#include "output.h"
+#include "globals.h"
+#include "object.h"
+#include "lock.h"
+#include "threadpool.h"
+#include "whatif.h"
+
+typedef enum {
+	WS_PENDING=0, ///< candidate has not reported
+	WS_DONE=1, ///< candidate reported its objective
+	WS_FAILED=2, ///< candidate could not be evaluated
+} WHATIFSTATUS;
+
+typedef struct s_whatifresult {
+	double value; ///< objective at the end of the horizon
+	int status; ///< WHATIFSTATUS of the candidate
+} WHATIFRESULT;
+
+static WHATIF *first_whatif = NULL;
+static unsigned int whatif_lock = 0;
+static WHATIF *child_whatif = NULL; ///< search this process is evaluating a candidate of (NULL in the parent)
+static WHATIFRESULT *child_result = NULL; ///< shared slot this process reports to
+
+static char *owner_name(OBJECT *owner)
+{
+	static char buffer[1024];
+	if ( owner==NULL || object_name(owner,buffer,sizeof(buffer))==NULL )
+		return "anonymous";
+	return buffer;
+}
+
+/** Create a what-if block
+	@return a pointer to the new block, or NULL on failure
+ **/
+WHATIF *whatif_create(struct s_object_list *owner, /**< object that owns the search */
+					  unsigned int n_vars, /**< number of decision variables */
+					  unsigned int max_candidates, /**< largest generation the search may request */
+					  TIMESTAMP horizon) /**< time each candidate is simulated for (s) */
+{
+	WHATIF *wi;
+	if ( n_vars==0 || max_candidates==0 || horizon<=0 )
+	{
+		output_error("whatif_create(): %s search must have at least one variable and candidate and a positive horizon", owner_name(owner));
+		/* TROUBLESHOOT
+			A what-if search was created without decision variables, with no room for candidates
+			or with a horizon that is not positive.  Check the settings of the object that
+			runs the search and try again.
+		 */
+		return NULL;
+	}
+	wi = (WHATIF*)malloc(sizeof(WHATIF));
+	if ( wi==NULL )
+	{
+		errno = ENOMEM;
+		return NULL;
+	}
+	memset(wi,0,sizeof(WHATIF));
+	wi->var = (double**)malloc(sizeof(double*)*n_vars);
+	if ( wi->var==NULL )
+	{
+		free(wi);
+		errno = ENOMEM;
+		return NULL;
+	}
+	memset(wi->var,0,sizeof(double*)*n_vars);
+	wi->owner = owner;
+	wi->n_vars = n_vars;
+	wi->max_candidates = max_candidates;
+	wi->horizon = horizon;
+	wlock(&whatif_lock);
+	wi->next = first_whatif;
+	first_whatif = wi;
+	wunlock(&whatif_lock);
+	return wi;
+}
+
+/** Set the address of a decision variable
+	@return 1 on success, 0 on failure
+ **/
+int whatif_set_variable(WHATIF *wi, unsigned int n, double *addr)
+{
+	if ( n>=wi->n_vars || addr==NULL )
+		return 0;
+	wi->var[n] = addr;
+	return 1;
+}
+
+/** Set the address of the objective
+	@return 1 on success, 0 on failure
+ **/
+int whatif_set_objective(WHATIF *wi, double *addr)
+{
+	if ( addr==NULL )
+		return 0;
+	wi->objective = addr;
+	return 1;
+}
+
+/** Start a search at the next safe point
+	@return 1 on success, 0 on failure
+ **/
+int whatif_start(WHATIF *wi, WHATIFSEARCH search, void *context)
+{
+	unsigned int n;
+#ifdef WIN32
+	output_error("whatif_start(): what-if evaluation is not supported on this platform");
+	/* TROUBLESHOOT
+		What-if evaluation forks the simulation, which is only available on Linux and Mac systems.
+	 */
+	return 0;
+#endif
+	if ( wi->pending )
+		return 0;
+	for ( n=0 ; n<wi->n_vars ; n++ )
+	{
+		if ( wi->var[n]==NULL )
+			break;
+	}
+	if ( n<wi->n_vars || wi->objective==NULL || search==NULL )
+	{
+		output_error("whatif_start(): %s search is missing a variable, objective or search step", owner_name(wi->owner));
+		/* TROUBLESHOOT
+			A what-if search was started before all of its decision variables and its objective
+			were set.  This is a bug in the module that runs the search.
+		 */
+		return 0;
+	}
+	if ( global_multirun_mode!=MRM_STANDALONE || global_run_realtime>0 )
+	{
+		output_error("whatif_start(): %s search cannot run in multirun or realtime mode", owner_name(wi->owner));
+		/* TROUBLESHOOT
+			What-if searches fork the simulation, which cannot be done while it is connected to
+			other instances or to real time.  Run the model standalone and try again.
+		 */
+		return 0;
+	}
+	wi->search = search;
+	wi->context = context;
+	wi->pending = 1;
+	return 1;
+}
+
+/** Check whether a search is waiting to run
+	@return non-zero if the search has not been run yet
+ **/
+int whatif_pending(WHATIF *wi)
+{
+	return wi->pending;
+}
+
+/** Check whether this process is evaluating a what-if candidate
+	@return non-zero in a what-if child
+ **/
+int whatif_ischild(void)
+{
+	return child_whatif!=NULL;
+}
+
+/** Report the objective of a candidate and terminate the child
+	Does nothing in the parent.
+ **/
+void whatif_child_exit(int ok) /**< non-zero if the horizon was simulated successfully */
+{
+	if ( child_whatif==NULL )
+		return;
+	if ( ok )
+	{
+		child_result->value = *(child_whatif->objective);
+		child_result->status = WS_DONE;
+	}
+	else
+		child_result->status = WS_FAILED;
+#ifndef WIN32
+	_exit(ok?0:1);
+#endif
+}
+
+#ifndef WIN32
+
+/* detach a child from the files it shares with the parent */
+static void isolate_files(void)
+{
+	DIR *dir = opendir("/proc/self/fd");
+	struct dirent *entry;
+	int null = open("/dev/null",O_RDWR);
+	int *fd = NULL;
+	size_t n_fd = 0, max_fd = 0, n;
+	if ( dir==NULL || null<0 )
+	{
+		output_warning("what-if candidate could not isolate its files; outputs may be corrupted");
+		/* TROUBLESHOOT
+			A what-if child could not list its open files, so files it writes may receive
+			output from the candidate simulation.  Make sure /proc is mounted.
+		 */
+		if ( dir!=NULL ) closedir(dir);
+		if ( null>=0 ) close(null);
+		return;
+	}
+	while ( (entry=readdir(dir))!=NULL )
+	{
+		int f = atoi(entry->d_name);
+		if ( entry->d_name[0]=='.' || f<1 || f==2 || f==null || f==dirfd(dir) )
+			continue;
+		if ( n_fd==max_fd )
+		{
+			int *more = (int*)realloc(fd,sizeof(int)*(max_fd=max_fd?max_fd*2:64));
+			if ( more==NULL ) break;
+			fd = more;
+		}
+		fd[n_fd++] = f;
+	}
+	closedir(dir);
+	for ( n=0 ; n<n_fd ; n++ )
+	{
+		struct stat st;
+		int flags = fcntl(fd[n],F_GETFL);
+		if ( flags>=0 && (flags&O_ACCMODE)==O_RDONLY && fstat(fd[n],&st)==0 && S_ISREG(st.st_mode) )
+		{
+			char link[64], path[1024];
+			ssize_t len;
+			sprintf(link,"/proc/self/fd/%d",fd[n]);
+			len = readlink(link,path,sizeof(path)-1);
+			if ( len>0 )
+			{
+				int copy;
+				path[len] = '\0';
+				copy = open(path,O_RDONLY);
+				if ( copy>=0 )
+				{
+					lseek(copy,lseek(fd[n],0,SEEK_CUR),SEEK_SET);
+					dup2(copy,fd[n]);
+					close(copy);
+					continue;
+				}
+			}
+		}
+		dup2(null,fd[n]);
+	}
+	free(fd);
+	close(null);
+}
+
+/* turn this process into a child that evaluates one candidate */
+static void start_child(WHATIF *wi, TIMESTAMP t0, double *x, WHATIFRESULT *result)
+{
+	unsigned int n;
+	child_whatif = wi;
+	child_result = result;
+	isolate_files();
+	for ( n=0 ; n<wi->n_vars ; n++ )
+		*(wi->var[n]) = x[n];
+	if ( t0 + wi->horizon < global_stoptime )
+		global_stoptime = t0 + wi->horizon;
+	global_threadcount = 1; /* only the forking thread exists in the child */
+	tp_release(); /* the child gets the processors of the process, not those of the forking thread */
+	global_checkpoint_type = CPT_NONE;
+	global_show_progress = 0;
+}
+
+/* evaluate one generation of candidates; returns 1 in a child, 0 in the parent */
+static int evaluate(WHATIF *wi, TIMESTAMP t0, unsigned int count, double *candidates, WHATIFRESULT *shared)
+{
+	unsigned int next = 0, running = 0, n;
+	unsigned int maxprocs = global_whatif_maxprocs>0 ? global_whatif_maxprocs : processor_count();
+	pid_t *pid = (pid_t*)malloc(sizeof(pid_t)*count);
+	if ( pid==NULL )
+	{
+		for ( n=0 ; n<count ; n++ )
+			shared[n].status = WS_FAILED;
+		return 0;
+	}
+	memset(pid,0,sizeof(pid_t)*count);
+	if ( maxprocs<1 ) maxprocs = 1;
+	fflush(stdout);
+	fflush(stderr);
+	while ( next<count || running>0 )
+	{
+		int status;
+		pid_t done;
+
+		/* fork candidates until the process limit is reached */
+		while ( next<count && running<maxprocs )
+		{
+			pid_t child;
+			shared[next].status = WS_PENDING;
+			child = fork();
+			if ( child==0 )
+			{
+				start_child(wi,t0,candidates+next*wi->n_vars,shared+next);
+				free(pid);
+				return 1;
+			}
+			else if ( child<0 )
+			{
+				output_error("%s what-if candidate %d could not be forked: %s", owner_name(wi->owner), next, strerror(errno));
+				/* TROUBLESHOOT
+					The system refused to create a process for a what-if candidate, usually because
+					a process or memory limit was reached.  Reduce whatif_maxprocs or the number of
+					candidates and try again.
+				 */
+				shared[next++].status = WS_FAILED;
+				if ( running==0 ) continue;
+				break;
+			}
+			pid[next++] = child;
+			running++;
+		}
+		if ( running==0 )
+			continue;
+
+		/* wait for a candidate to finish */
+		done = waitpid(-1,&status,0);
+		if ( done<0 )
+		{
+			if ( errno==EINTR )
+				continue;
+			break;
+		}
+		for ( n=0 ; n<next ; n++ )
+		{
+			if ( pid[n]!=done )
+				continue;
+			pid[n] = 0;
+			running--;
+			if ( shared[n].status==WS_PENDING || !WIFEXITED(status) || WEXITSTATUS(status)!=0 )
+			{
+				output_warning("%s what-if candidate %d failed to complete its horizon", owner_name(wi->owner), n);
+				/* TROUBLESHOOT
+					The simulation of a what-if candidate stopped before the end of its horizon.
+					The candidate is reported to the search as not a number.  Run the model with
+					the candidate's decision values to see why the simulation fails.
+				 */
+				shared[n].status = WS_FAILED;
+			}
+			break;
+		}
+	}
+	free(pid);
+	return 0;
+}
+
+/* run a search to completion; returns 1 in a child, 0 in the parent */
+static int run_search(WHATIF *wi, TIMESTAMP t0)
+{
+	unsigned int count = 0, max = wi->max_candidates, n;
+	double *candidates = (double*)malloc(sizeof(double)*wi->n_vars*max);
+	double *results = (double*)malloc(sizeof(double)*max);
+	WHATIFRESULT *shared = (WHATIFRESULT*)mmap(NULL,sizeof(WHATIFRESULT)*max,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_ANONYMOUS,-1,0);
+	if ( candidates==NULL || results==NULL || shared==MAP_FAILED )
+	{
+		output_error("%s what-if search could not allocate space for %d candidates", owner_name(wi->owner), max);
+		/* TROUBLESHOOT
+			The memory shared with what-if candidates could not be allocated.  Reduce the
+			number of candidates and try again.
+		 */
+		if ( candidates!=NULL ) free(candidates);
+		if ( results!=NULL ) free(results);
+		if ( shared!=MAP_FAILED ) munmap(shared,sizeof(WHATIFRESULT)*max);
+		return 0;
+	}
+	wi->generations = wi->evaluations = 0;
+	while ( (count=wi->search(wi->context,wi->generations,candidates,wi->generations>0?results:NULL,count,max))>0 )
+	{
+		if ( count>max )
+			count = max;
+		if ( evaluate(wi,t0,count,candidates,shared) )
+			return 1;
+		for ( n=0 ; n<count ; n++ )
+			results[n] = shared[n].status==WS_DONE ? shared[n].value : QNAN;
+		wi->generations++;
+		wi->evaluations += count;
+	}
+	munmap(shared,sizeof(WHATIFRESULT)*max);
+	free(candidates);
+	free(results);
+	output_verbose("%s what-if search evaluated %d candidates in %d generations", owner_name(wi->owner), wi->evaluations, wi->generations);
+	return 0;
+}
+
+#endif
+
+/** Run the searches that are waiting for a safe point
+	This is called by the main loop before objects are synchronized at \p t0.
+	@return 1 if this process is a what-if child that must now simulate its candidate, 0 otherwise
+ **/
+int whatif_run(TIMESTAMP t0) /**< time at which the candidates start */
+{
+#ifndef WIN32
+	WHATIF *wi;
+	if ( child_whatif!=NULL )
+		return 0;
+	for ( wi=first_whatif ; wi!=NULL ; wi=wi->next )
+	{
+		if ( !wi->pending )
+			continue;
+		wi->pending = 0;
+		if ( run_search(wi,t0) )
+			return 1;
+	}
+#endif
+	return 0;
+}
@@ -0,0 +1,53 @@
+/* whatif.h
+ * Copyright (C) 2008 Battelle Memorial Institute
+ * Fork-based what-if evaluation of candidate decisions against the running model.
+ */
+
+#ifndef _WHATIF_H
+#define _WHATIF_H
+
+#include "platform.h"
+#include "timestamp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Search step called by the what-if engine once per generation.
+	On the first call \p results is NULL; afterward it holds the objective value of each
+	candidate of the last generation (QNAN when a candidate could not be evaluated).
+	The search writes up to \p max candidates of the next generation into \p candidates
+	(n_vars values per candidate) and returns how many it wrote, or 0 to end the search.
+ **/
+typedef unsigned int (*WHATIFSEARCH)(void *context, unsigned int generation, double *candidates, const double *results, unsigned int count, unsigned int max);
+
+typedef struct s_whatif {
+	struct s_object_list *owner; ///< object that owns the search (for messages)
+	TIMESTAMP horizon; ///< time each candidate is simulated for (s)
+	unsigned int n_vars; ///< number of decision variables
+	double **var; ///< decision variables applied to each candidate
+	double *objective; ///< objective read at the end of the horizon
+	unsigned int max_candidates; ///< largest generation the search may request
+	WHATIFSEARCH search; ///< search step
+	void *context; ///< search context
+	int pending; ///< non-zero while a search is waiting for the next safe point
+	unsigned int generations; ///< generations evaluated by the last search
+	unsigned int evaluations; ///< candidates evaluated by the last search
+	struct s_whatif *next;
+} WHATIF;
+
+WHATIF *whatif_create(struct s_object_list *owner, unsigned int n_vars, unsigned int max_candidates, TIMESTAMP horizon);
+int whatif_set_variable(WHATIF *wi, unsigned int n, double *addr);
+int whatif_set_objective(WHATIF *wi, double *addr);
+int whatif_start(WHATIF *wi, WHATIFSEARCH search, void *context);
+int whatif_pending(WHATIF *wi);
+
+int whatif_run(TIMESTAMP t0);
+int whatif_ischild(void);
+void whatif_child_exit(int ok);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -26,6 +26,11 @@ uint32 auction::statistic_count = 0;
 static PASSCONFIG passconfig = PC_PRETOPDOWN|PC_POSTTOPDOWN;
 static PASSCONFIG clockpass = PC_POSTTOPDOWN;
 
+/* bid staging slot of the current thread (-1 until first bid) */
+static THREADLOCAL int bid_stage_slot = -1;
+static unsigned int bid_stage_lock = 0;
+static int bid_stage_count = 0;
+
 EXPORT int64 get_market_for_time(OBJECT *obj, TIMESTAMP ts){
 	auction *pAuc = 0;
 	TIMESTAMP market_time = 0;
@@ -223,6 +228,11 @@ int auction::create(void)
 	warmup = 1;
 	market_id = 1;
 	clearing_scalar = 0.5;
+	memset(stage,0,sizeof(stage));
+	name_table = NULL;
+	name_table_len = name_count = 0;
+	rejected = NULL;
+	n_rejected = max_rejected = reject_lock = 0;
 	/* process dynamic statistics */
 	if(statistic_check == -1){
 		int rv;
@@ -748,6 +758,9 @@ TIMESTAMP auction::pop_market_frame(TIMESTAMP t1){
 /* Presync is called when the clock needs to advance on the first top-down pass */
 TIMESTAMP auction::presync(TIMESTAMP t0, TIMESTAMP t1)
 {
+	/* apply bids that arrived after the last postsync */
+	merge_bids();
+
 	if (clearat==TS_ZERO)
 	{
 		clearat = nextclear();
@@ -799,6 +812,9 @@ TIMESTAMP auction::presync(TIMESTAMP t0, TIMESTAMP t1)
 /* Postsync is called when the clock needs to advance on the second top-down pass */
 TIMESTAMP auction::postsync(TIMESTAMP t0, TIMESTAMP t1)
 {
+	/* apply bids received during this timestep */
+	merge_bids();
+
 	return -clearat; /* soft return t2>t1 on success, t2=t1 for retry, t2<t1 on failure */
 }
 
@@ -1481,10 +1497,227 @@ void auction::record_bid(char *from, double quantity, double real_price, BIDDERS
 	}
 }
 
+/** Take a bid from a bidder
+	Bids are staged in a buffer owned by the submitting thread so that bidders
+	do not contend for the auction lock.  The staged bids are applied to the
+	curves in submission order by merge_bids() at the auction's next pass.
+	Bids that can be refused without looking at the curves are refused here;
+	a bid that merge_bids() could not apply is refused on the bidder's next bid.
+	@return 1 if the bid was taken, 0 if it was refused
+ **/
 int auction::submit(char *from, double quantity, double real_price, KEY key, BIDDERSTATE state, bool rebid, int64 mkt_id)
 {
-	gld_wlock lock(my());
-	return submit_nolock(from,quantity,real_price,key,state, rebid, mkt_id);
+	char myname[64];
+	if (mkt_id > market_id)
+	{
+		gl_error("bidding into future markets is not yet supported");
+		/* TROUBLESHOOT
+			Tracking bids input markets other than the immediately open one will be supported in the future.
+			*/
+		return 0;
+	}
+	if (mkt_id < market_id)
+	{
+		if (verbose)
+			gl_output(" ... %s receives %s from object %s for a previously cleared market",
+				gl_name(OBJECTHDR(this),myname,sizeof(myname)),quantity<0?"ask":"offer",from);
+		return 1;
+	}
+	if (quantity==0 && rebid==false)
+	{
+		gl_debug("zero quantity bid from %s is ignored", from);
+		return 1;
+	}
+
+	/* only read without the lock to skip the search when nothing was refused */
+	if (n_rejected>0 && take_rejection(from))
+	{
+		gl_error("%s refuses the bid from %s because its previous bid could not be applied", gl_name(OBJECTHDR(this),myname,sizeof(myname)), from);
+		/* TROUBLESHOOT
+			The previous bid of this bidder was staged but could not be added to the auction's curves,
+			most likely because it resubmitted a bid that is not in the curve or more than one bid has
+			the same bid id.  Check that each bidder uses a unique bid id and try again.
+		 */
+		return 0;
+	}
+
+	if (bid_stage_slot<0)
+	{
+		::wlock(&bid_stage_lock);
+		bid_stage_slot = bid_stage_count++;
+		::wunlock(&bid_stage_lock);
+	}
+	if (bid_stage_slot<MAXBIDSTAGES)
+	{
+		BIDSTAGE *my_stage = stage+bid_stage_slot;
+		::wlock(&my_stage->lock);
+		stage_bid(my_stage,from,quantity,real_price,key,state,rebid,mkt_id);
+		::wunlock(&my_stage->lock);
+	}
+	else
+	{
+		gld_wlock lock(my());
+		stage_bid(stage+MAXBIDSTAGES,from,quantity,real_price,key,state,rebid,mkt_id);
+	}
+	return 1;
+}
+
+void auction::stage_bid(BIDSTAGE *stage, char *from, double quantity, double real_price, KEY key, BIDDERSTATE state, bool rebid, int64 mkt_id)
+{
+	size_t from_len = strlen(from)+1;
+	if (stage->n_bids==stage->max_bids)
+	{
+		unsigned int max_bids = stage->max_bids ? stage->max_bids*2 : 64;
+		STAGEDBID *bid = new STAGEDBID[max_bids];
+		if (stage->n_bids>0)
+			memcpy(bid,stage->bid,sizeof(STAGEDBID)*stage->n_bids);
+		delete [] stage->bid;
+		stage->bid = bid;
+		stage->max_bids = max_bids;
+	}
+	if (stage->n_names+from_len>stage->max_names)
+	{
+		size_t max_names = stage->max_names ? stage->max_names*2 : 4096;
+		while (max_names<stage->n_names+from_len)
+			max_names *= 2;
+		char *names = new char[max_names];
+		if (stage->n_names>0)
+			memcpy(names,stage->names,stage->n_names);
+		delete [] stage->names;
+		stage->names = names;
+		stage->max_names = max_names;
+	}
+	STAGEDBID *next = stage->bid + stage->n_bids++;
+	next->from = stage->n_names;
+	memcpy(stage->names+stage->n_names,from,from_len);
+	stage->n_names += from_len;
+	next->quantity = quantity;
+	next->price = real_price;
+	next->key = key;
+	next->state = state;
+	next->rebid = rebid;
+	next->market_id = mkt_id;
+}
+
+/** Find and clear a refused bid of a bidder
+	@return true if merge_bids() could not apply the bidder's last bid
+ **/
+bool auction::take_rejection(const char *from)
+{
+	unsigned int i;
+	bool found = false;
+	::wlock(&reject_lock);
+	for (i=0; i<n_rejected; i++)
+	{
+		if (strcmp(rejected[i],from)==0)
+		{
+			rejected[i] = rejected[--n_rejected];
+			found = true;
+			break;
+		}
+	}
+	::wunlock(&reject_lock);
+	return found;
+}
+
+/** Get a persistent copy of a bidder name
+	Curves keep the name of each bidder so it must outlive the staging buffer.
+ **/
+char *auction::intern_name(const char *name)
+{
+	unsigned int hash = 5381;
+	const char *p;
+	for (p=name; *p!='\0'; p++)
+		hash = hash*33 + (unsigned char)*p;
+	if (name_count*2>=name_table_len)
+	{
+		unsigned int i, len = name_table_len ? name_table_len*2 : 1024;
+		char **table = new char*[len];
+		memset(table,0,sizeof(char*)*len);
+		for (i=0; i<name_table_len; i++)
+		{
+			if (name_table[i]!=NULL)
+			{
+				unsigned int h = 5381;
+				for (p=name_table[i]; *p!='\0'; p++)
+					h = h*33 + (unsigned char)*p;
+				while (table[h&(len-1)]!=NULL) h++;
+				table[h&(len-1)] = name_table[i];
+			}
+		}
+		delete [] name_table;
+		name_table = table;
+		name_table_len = len;
+	}
+	while (name_table[hash&(name_table_len-1)]!=NULL)
+	{
+		if (strcmp(name_table[hash&(name_table_len-1)],name)==0)
+			return name_table[hash&(name_table_len-1)];
+		hash++;
+	}
+	char *copy = new char[strlen(name)+1];
+	strcpy(copy,name);
+	name_table[hash&(name_table_len-1)] = copy;
+	name_count++;
+	return copy;
+}
+
+/** Apply the staged bids to the curves
+	Stages are merged in slot order and each stage in submission order, so a
+	single-threaded run applies bids exactly in the order they were submitted.
+ **/
+void auction::merge_bids(void)
+{
+	unsigned int n, i, n_staged = 0;
+	for (n=0; n<=MAXBIDSTAGES; n++)
+		n_staged += stage[n].n_bids;
+	if (n_staged==0)
+		return;
+
+	/* size the curves once for the whole batch */
+	asks.reserve(asks.getcount()+n_staged);
+	offers.reserve(offers.getcount()+n_staged);
+
+	for (n=0; n<=MAXBIDSTAGES; n++)
+	{
+		BIDSTAGE *s = stage+n;
+		if (s->n_bids==0)
+			continue;
+		::wlock(&s->lock);
+		for (i=0; i<s->n_bids; i++)
+		{
+			STAGEDBID *bid = s->bid+i;
+			char *from = intern_name(s->names+bid->from);
+			if (submit_nolock(from,bid->quantity,bid->price,bid->key,bid->state,bid->rebid,bid->market_id)==0)
+			{
+				char myname[64];
+				gl_error("%s could not apply the bid from %s", gl_name(OBJECTHDR(this),myname,sizeof(myname)), from);
+				/* TROUBLESHOOT
+					A staged bid could not be added to the auction's curves, most likely because
+					more than one bid in the curve has the same bid id.  Check that each bidder
+					uses a unique bid id and try again.
+				 */
+
+				/* the bidder is told on its next bid */
+				::wlock(&reject_lock);
+				if (n_rejected==max_rejected)
+				{
+					unsigned int max = max_rejected ? max_rejected*2 : 16;
+					char **list = new char*[max];
+					if (n_rejected>0)
+						memcpy(list,rejected,sizeof(char*)*n_rejected);
+					delete [] rejected;
+					rejected = list;
+					max_rejected = max;
+				}
+				rejected[n_rejected++] = from;
+				::wunlock(&reject_lock);
+			}
+		}
+		s->n_bids = 0;
+		s->n_names = 0;
+		::wunlock(&s->lock);
+	}
 }
 int auction::submit_nolock(char *from, double quantity, double real_price, KEY key, BIDDERSTATE state, bool rebid, int64 mkt_id)
 {
@@ -1532,6 +1765,7 @@ int auction::submit_nolock(char *from, double quantity, double real_price, KEY k
 		/* TROUBLESHOOT
 			Tracking bids input markets other than the immediately open one will be supported in the future.
 			*/
+		return 0;
 	}
 	else if (mkt_id == market_id && rebid == true) // resubmit
 	{
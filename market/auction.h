@@ -45,6 +45,29 @@ typedef struct s_market_frame{
 	double *statistics;
 } MARKETFRAME;
 
+#define MAXBIDSTAGES 64 /**< number of threads that get a private bid staging buffer */
+
+/** Bid held in a staging buffer until the auction applies it to its curves */
+typedef struct s_stagedbid {
+	size_t from;		/**< offset of the bidder name in the stage name buffer */
+	double quantity;
+	double price;
+	KEY key;
+	BIDDERSTATE state;
+	bool rebid;
+	int64 market_id;
+} STAGEDBID;
+
+/** Bid staging buffer (one per submitting thread) */
+typedef struct s_bidstage {
+	unsigned int lock;	/**< only contended while the auction merges the stage */
+	STAGEDBID *bid;
+	unsigned int n_bids, max_bids;
+	char *names;
+	size_t n_names, max_names;
+	char pad[16];		/**< keeps stages of different threads on separate cache lines */
+} BIDSTAGE;
+
 typedef enum {
 	AM_NONE=0,
 	AM_DENY=1,
@@ -157,6 +180,16 @@ public:
 	int submit(char *from, double quantity, double real_price, KEY key, BIDDERSTATE state, bool rebid, int64 mkt_id);
 private:
 	int submit_nolock(char *from, double quantity, double real_price, KEY key, BIDDERSTATE state, bool rebid, int64 mkt_id);
+	void stage_bid(BIDSTAGE *stage, char *from, double quantity, double real_price, KEY key, BIDDERSTATE state, bool rebid, int64 mkt_id);
+	void merge_bids(void);
+	char *intern_name(const char *name);
+	BIDSTAGE stage[MAXBIDSTAGES+1]; /**< per-thread staging, plus one shared stage used under the object lock */
+	char **name_table;	/**< interned bidder names */
+	unsigned int name_table_len, name_count;
+	bool take_rejection(const char *from);
+	char **rejected;	/**< interned names of bidders whose last staged bid could not be applied */
+	volatile unsigned int n_rejected;
+	unsigned int max_rejected, reject_lock;
 public:
 	TIMESTAMP nextclear() const;
 private:
@@ -10,6 +10,10 @@ curve::curve(void)
 	bids = NULL;
 	keys = NULL;
 	bid_ids = NULL;
+	work = NULL;
+	index = NULL;
+	index_ids = NULL;
+	index_len = 0;
 	n_bids = 0;
 	total = 0;
 }
@@ -19,6 +23,9 @@ curve::~curve(void)
 	delete [] bids;
 	delete [] keys;
 	delete [] bid_ids;
+	delete [] work;
+	delete [] index;
+	delete [] index_ids;
 }
 
 void curve::clear(void)
@@ -27,6 +34,8 @@ void curve::clear(void)
 	total = 0;
 	total_on = 0;
 	total_off = 0;
+	if (index_len>0)
+		memset(index,0xff,sizeof(int)*index_len);
 }
 
 BID *curve::getbid(KEY n)
@@ -34,33 +43,98 @@ BID *curve::getbid(KEY n)
 	return bids+keys[n];
 }
 
-KEY curve::submit(BID *bid)
+/** Make room for at least n bids without reallocating during submission */
+void curve::reserve(int n)
+{
+	if (n>len)
+		grow(n);
+}
+
+void curve::grow(int n)
+{
+	int newlen = (len==0 ? 8 : len);
+	while (newlen<n)
+		newlen *= 2;
+	BID *newbids = new BID[newlen];
+	KEY *newkeys = new KEY[newlen];
+	KEY *newbid_ids = new KEY[newlen];
+	if (n_bids>0)
+	{
+		memcpy(newbids,bids,n_bids*sizeof(BID));
+		memcpy(newkeys,keys,n_bids*sizeof(KEY));
+		memcpy(newbid_ids,bid_ids,n_bids*sizeof(KEY));
+	}
+	delete[] bids;
+	delete[] keys;
+	delete[] bid_ids;
+	delete[] work;
+	bids = newbids;
+	keys = newkeys;
+	bid_ids = newbid_ids;
+	work = new KEY[newlen];
+	len = newlen;
+
+	/* index is kept at most half full */
+	delete[] index;
+	delete[] index_ids;
+	index_len = newlen*2;
+	index = new int[index_len];
+	index_ids = new KEY[index_len];
+	index_rebuild();
+}
+
+static inline unsigned int hash_bid_id(KEY bid_id, int size)
 {
-	if (len==0) // create the bid list
+	return (unsigned int)(((unsigned long long)bid_id*0x9E3779B97F4A7C15ULL)>>32) & (size-1);
+}
+
+void curve::index_add(KEY bid_id, int pos)
+{
+	unsigned int slot = hash_bid_id(bid_id,index_len);
+	while (index[slot]!=-1)
 	{
-		len = 8;
-		bids = new BID[len];
-		keys = new KEY[len];
-		bid_ids = new KEY[len];
+		if (index_ids[slot]==bid_id)
+		{
+			index[slot] = -2; /* more than one bid with this id */
+			return;
+		}
+		slot = (slot+1) & (index_len-1);
 	}
-	else if (n_bids==len) // grow the bid list
+	index[slot] = pos;
+	index_ids[slot] = bid_id;
+}
+
+/** Find a bid by bid id
+	@return the bid position, -1 if none, or -2 if more than one bid has the id
+ **/
+int curve::index_find(KEY bid_id)
+{
+	if (index_len==0)
+		return -1;
+	unsigned int slot = hash_bid_id(bid_id,index_len);
+	while (index[slot]!=-1)
 	{
-		BID *newbids = new BID[len*2];
-		KEY *newkeys = new KEY[len*2];
-		KEY *newbid_ids = new KEY[len*2];
-		memcpy(newbids,bids,len*sizeof(BID));
-		memcpy(newkeys,keys,len*sizeof(KEY));
-		memcpy(newbid_ids,bid_ids,len*sizeof(KEY));
-		delete[] bids;
-		delete[] keys;
-		delete[] bid_ids;
-		bids = newbids;
-		keys = newkeys;
-		bid_ids = newbid_ids;
-		len*=2;
+		if (index_ids[slot]==bid_id)
+			return index[slot];
+		slot = (slot+1) & (index_len-1);
 	}
+	return -1;
+}
+
+void curve::index_rebuild(void)
+{
+	memset(index,0xff,sizeof(int)*index_len);
+	for (int i=0; i<n_bids; i++)
+		index_add(bid_ids[i],i);
+}
+
+KEY curve::append(BID *bid)
+{
+	if (n_bids==len) // create or grow the bid list
+		grow(n_bids+1);
 	keys[n_bids] = n_bids;
 	bid_ids[n_bids] = bid->bid_id;
+	index_add(bid->bid_id,n_bids);
 	BID *next = bids + n_bids;
 	*next = *bid;
 
@@ -78,63 +152,21 @@ KEY curve::submit(BID *bid)
 	return n_bids++;
 }
 
+KEY curve::submit(BID *bid)
+{
+	return append(bid);
+}
+
 KEY curve::resubmit(BID *bid)
 {
-	int i = 0;
-	int bid_index = 0;
-	int bid_hitcount = 0;
-	for(i = 0; i < n_bids; i++) {
-		if(bid_ids[i] == bid->bid_id) {
-			if(bid_hitcount == 1) {
-				gl_error("curve::resubmit - There is more than one bid with the same bid id in the bid curve.");
-				return -1;
-			}
-			bid_index = i;
-			bid_hitcount++;
-		}
+	int bid_index = index_find(bid->bid_id);
+	if(bid_index == -2) {
+		gl_error("curve::resubmit - There is more than one bid with the same bid id in the bid curve.");
+		return -1;
 	}
-	if(bid_hitcount == 0) {
+	if(bid_index == -1) {
 		gl_warning("The bid was flagged as a rebid but there is no bid in the bid curve with the bid id provided. Submitting the bid.");
-		if (len==0) // create the bid list
-		{
-			len = 8;
-			bids = new BID[len];
-			keys = new KEY[len];
-			bid_ids = new KEY[len];
-		}
-		else if (n_bids==len) // grow the bid list
-		{
-			BID *newbids = new BID[len*2];
-			KEY *newkeys = new KEY[len*2];
-			KEY *newbid_ids = new KEY[len*2];
-			memcpy(newbids,bids,len*sizeof(BID));
-			memcpy(newkeys,keys,len*sizeof(KEY));
-			memcpy(newbid_ids,bid_ids,len*sizeof(KEY));
-			delete[] bids;
-			delete[] keys;
-			delete[] bid_ids;
-			bids = newbids;
-			keys = newkeys;
-			bid_ids = newbid_ids;
-			len*=2;
-		}
-		keys[n_bids] = n_bids;
-		bid_ids[n_bids] = bid->bid_id;
-		BID *next = bids + n_bids;
-		*next = *bid;
-
-		/* handle bid state */
-		switch (bid->state) {
-		case BS_OFF:
-			total_off += bid->quantity;
-			break;
-		case BS_ON:
-			total_on += bid->quantity;
-			break;
-		}
-		total += bid->quantity;
-
-		return n_bids++;
+		return append(bid);
 	} else if(bid_index < n_bids) {
 		/* undo effect of old state */
 		BID *old = &(bids[keys[bid_index]]);
@@ -170,20 +202,11 @@ KEY curve::resubmit(BID *bid)
 //This function is for removing a from a curve if the rebid places the bidder in the opposite curve.(i.e. switching from a seller to a buyer or vice versa)
 int curve::remove_bid(KEY bid_id)
 {
-	int i = 0;
-	int bid_index = 0;
-	int bid_hitcount = 0;
-	for(i = 0; i < n_bids; i++) {
-		if(bid_ids[i] == bid_id) {
-			if(bid_hitcount == 1) {
-				gl_error("curve::resubmit - There is more than one bid with the same bid id in the bid curve.");
-				return -1;
-			}
-			bid_index = i;
-			bid_hitcount++;
-		}
-	}
-	if (bid_index < n_bids && bid_hitcount == 1) {
+	int bid_index = index_find(bid_id);
+	if (bid_index == -2) {
+		gl_error("curve::resubmit - There is more than one bid with the same bid id in the bid curve.");
+		return -1;
+	} else if (bid_index >= 0 && bid_index < n_bids) {
 		/* undo effect of old state */
 		BID *old = &(bids[keys[bid_index]]);
 		switch (old->state) {
@@ -195,28 +218,13 @@ int curve::remove_bid(KEY bid_id)
 			break;
 		}
 		total -= old->quantity;
-		/* copy all other bids into new curve */
-		BID *newbids = new BID[len];
-		KEY *newkeys = new KEY[len];
-		KEY *newbid_ids = new KEY[len];
-		for(i = 0; i <= len; i++){
-			if(i < bid_index){
-				newkeys[i] = keys[i];
-				newbids[i] = bids[i];
-				newbid_ids[i] = bid_ids[i];
-			} else if(i>bid_index){
-				newkeys[i-1] = keys[i];
-				newbids[i-1] = bids[i];
-				newbid_ids[i-1] = bid_ids[i];
-			}
-		}
-		delete[] bids;
-		delete[] keys;
-		delete[] bid_ids;
-		bids = newbids;
-		keys = newkeys;
-		bid_ids = newbid_ids;
+		/* close the gap; the curve is not sorted while bids are taken so keys are in order */
 		n_bids--;
+		memmove(bids+bid_index,bids+bid_index+1,(n_bids-bid_index)*sizeof(BID));
+		memmove(bid_ids+bid_index,bid_ids+bid_index+1,(n_bids-bid_index)*sizeof(KEY));
+		for (int i=0; i<n_bids; i++)
+			keys[i] = i;
+		index_rebuild();
 		return n_bids;
 	} else {
 		return n_bids;
@@ -224,20 +232,19 @@ int curve::remove_bid(KEY bid_id)
 }
 void curve::sort(bool reverse)
 {
-	sort(bids, keys, n_bids, reverse);
+	sort(bids, keys, work, n_bids, reverse);
 }
 
-void curve::sort(BID *list, KEY *key, const int len, const bool reverse)
+void curve::sort(BID *list, KEY *key, KEY *work, const int len, const bool reverse)
 {
-	//merge sort
+	//merge sort (work must have room for len keys)
 	if (len>1)
 	{
 		int split = len/2;
 		KEY *a = key, *b = key+split;
-		if (split>1) sort(list,a,split,reverse);
-		if (len-split>1) sort(list,b,len-split,reverse);
-		KEY *res = new KEY[len];
-		KEY *p = res;
+		if (split>1) sort(list,a,work,split,reverse);
+		if (len-split>1) sort(list,b,work+split,len-split,reverse);
+		KEY *p = work;
 		do {
 			bool altb = list[*a].price < list[*b].price;
 			if ((reverse && !altb) || (!reverse && altb))
@@ -249,8 +256,7 @@ void curve::sort(BID *list, KEY *key, const int len, const bool reverse)
 			*p++ = *a++;
 		while (b<key+len)
 			*p++ = *b++;
-		memcpy(key,res,sizeof(KEY)*len);
-		delete[] res;
+		memcpy(key,work,sizeof(KEY)*len);
 	}
 }
 
@@ -13,16 +13,26 @@ private:
 	BID *bids;
 	KEY *keys;
 	KEY *bid_ids;
+	KEY *work;		/**< merge sort scratch space */
+	int *index;		/**< bid_id hash index (-1 empty, -2 duplicate id) */
+	KEY *index_ids;	/**< bid_id of each index slot */
+	int index_len;
 	double total;
 	double total_on;
 	double total_off;
 private:
-	static void sort(BID *list, KEY *keys, const int len, const bool reverse);
+	static void sort(BID *list, KEY *keys, KEY *work, const int len, const bool reverse);
+	void grow(int n);
+	void index_add(KEY bid_id, int pos);
+	int index_find(KEY bid_id);
+	void index_rebuild(void);
+	KEY append(BID *bid);
 public:
 	curve(void);
 	~curve(void);
 	inline unsigned int getcount() { return n_bids;};
 	void clear(void);
+	void reserve(int n);
 	KEY submit(BID *bid);
 	KEY resubmit(BID *bid);
 	int remove_bid(KEY bid_id);
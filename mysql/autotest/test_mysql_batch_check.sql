@@ -0,0 +1,2 @@
+select count(*) from test_batch_collector;
+DUMP test_batch_collector;
@@ -168,8 +168,13 @@ int collector::init(OBJECT *parent)
 	// check row count
 	else 
 	{
-		if ( db->select("SELECT count(*) FROM `%s`", get_table())==NULL )
+		MYSQL_RES *res = db->select("SELECT count(*) FROM `%s`", get_table());
+		if ( res==NULL )
 			exception("unable to get row count of table '%s'", get_table());
+		MYSQL_ROW row = mysql_fetch_row(res);
+		if ( row!=NULL && row[0]!=NULL )
+			n_rows = atoi64(row[0]);
+		mysql_free_result(res);
 
 		gl_verbose("table '%s' ok", get_table());
 	}
@@ -182,8 +187,17 @@ int collector::init(OBJECT *parent)
 		next_t = TS_NEVER;
 	else
 		exception("%s: interval must be zero or positive");
-		
-	// @todo use prepared statement instead of insert
+
+	// samples are staged and sent by the database as multi-row inserts
+	char buffer[4096];
+	size_t eos = 0;
+	for ( n=0 ; n<n_aggregates ; n++ )
+	{
+		if ( eos+strlen(names[n])+4>=sizeof(buffer) )
+			exception("too many aggregates for table '%s'", get_table());
+		eos += sprintf(buffer+eos,",`%s`",names[n]);
+	}
+	batch = db->open_batch("INSERT INTO `%s` (t%s) VALUES ", get_table(), buffer);
 
 	// set heartbeat
 	if ( interval>0 )
@@ -207,22 +221,18 @@ TIMESTAMP collector::commit(TIMESTAMP t0, TIMESTAMP t1)
 	if ( dt==0 || ( t1==next_t && next_t!=TS_NEVER ) )
 	{
 		char buffer[4096];
-		size_t eos = sprintf(buffer,"INSERT INTO `%s` (t", get_table());
+		size_t eos = sprintf(buffer,"(from_unixtime(%lli)",db->convert_to_dbtime(gl_globalclock));
 		int n;
-		for ( n=0 ; n<n_aggregates ; n++ )
-			eos += sprintf(buffer+eos,",`%s`",names[n]);
-		eos += sprintf(buffer+eos,") VALUES (from_unixtime(%lli)",db->convert_to_dbtime(gl_globalclock));
-		for ( n=0 ; n<n_aggregates ; n++ )
+		for ( n=0 ; n<n_aggregates && eos<sizeof(buffer)-32 ; n++ )
 			eos += sprintf(buffer+eos,",%g",list[n].get_value());
 		sprintf(buffer+eos,"%s",")");
 
-		if ( !db->query(buffer) )
-			exception("unable to add data to '%s' - %s", get_table(), mysql_error(mysql));
-		else
-			gl_verbose("%s: sample added to '%s' ok", get_name(), get_table());
+		db->stage(batch,"%s",buffer);
+		gl_verbose("%s: sample staged for '%s' ok", get_name(), get_table());
+		n_rows++;
 
 		// check limit
-		if ( get_limit()>0 && db->get_last_index()>=get_limit() )
+		if ( get_limit()>0 && n_rows>=get_limit() )
 		{
 			gl_verbose("%s: limit of %d records reached", get_name(), get_limit());
 			next_t = TS_NEVER;
@@ -22,6 +22,8 @@ private:
 	size_t n_aggregates; /// number of aggregates found
 	gld_aggregate *list; ///< list of aggregates
 	char **names; ///< list of aggregate names
+	BATCH *batch; ///< rows staged for insert
+	int64 n_rows; ///< rows in table (including staged rows)
 public:
 	TIMESTAMP next_t;
 public:
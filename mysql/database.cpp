@@ -16,6 +16,7 @@
 #include <math.h>
 #include <ctype.h>
 #include <complex.h>
+#include <time.h>
 
 #include "database.h"
 
@@ -70,6 +71,8 @@ database::database(MODULE *module)
 			PT_double,"sync_interval[s]",get_sync_interval_offset(),PT_ACCESS,PA_PUBLIC,PT_DESCRIPTION,"interval at which on_sync is called",
 			PT_int32,"tz_offset",get_tz_offset_offset(),PT_ACCESS,PA_PUBLIC,PT_DESCRIPTION,"timezone offset used by timestamp in the database",
 			PT_bool,"uses_dst",get_uses_dst_offset(),PT_ACCESS,PA_PUBLIC,PT_DESCRIPTION,"timestamps in database include summer time offsets",
+			PT_int32,"batch_size",get_batch_size_offset(),PT_ACCESS,PA_PUBLIC,PT_DESCRIPTION,"number of rows sent in each multi-row insert (1 or less inserts each row immediately)",
+			PT_double,"batch_latency[s]",get_batch_latency_offset(),PT_ACCESS,PA_PUBLIC,PT_DESCRIPTION,"longest time staged rows wait before they are sent",
 			NULL)<1){
 				char msg[256];
 				sprintf(msg, "unable to publish properties in %s",__FILE__);
@@ -91,6 +94,8 @@ int database::create(void)
 	port = default_port;
 	strcpy(socketname,default_socketname);
 	clientflags = default_clientflags;
+	batch_size = 100;
+	batch_latency = 1.0;
 	last_database = this;
 
 	// term list
@@ -163,6 +168,27 @@ int database::init(OBJECT *parent)
 	if ( mysql_select_db(mysql,get_schema())!=0 )
 		exception("unable to select schema '%s'", get_schema());
 
+	// start the insert pipeline on its own connection
+	if ( get_batch_size()>1 )
+	{
+		MYSQL *handle = mysql_init(NULL);
+		if ( handle==NULL )
+			exception("unable to initialize mysql client for insert pipeline");
+		writer_mysql = mysql_real_connect(handle,hostname,username,strcmp(password,"")?password:NULL,get_schema(),port,socketname,(unsigned long)clientflags);
+		if ( writer_mysql==NULL )
+			exception("mysql connect for insert pipeline failed - %s", mysql_error(handle));
+		pthread_mutex_init(&writer_lock,NULL);
+		pthread_cond_init(&writer_ready,NULL);
+		pthread_cond_init(&writer_idle,NULL);
+		writer_running = true;
+		if ( pthread_create(&writer,NULL,writer_main,(void*)this)!=0 )
+		{
+			writer_running = false;
+			exception("unable to start insert pipeline thread");
+		}
+		gl_verbose("%s insert pipeline started (batch_size=%d, batch_latency=%g s)", get_name(), get_batch_size(), get_batch_latency());
+	}
+
 	// execute on_init script
 	if ( strcmp(get_on_init(),"")!=0 )
 	{
@@ -176,6 +202,28 @@ int database::init(OBJECT *parent)
 
 void database::term(void)
 {	
+	// send all staged rows and stop the insert pipeline
+	if ( writer_running )
+	{
+		pthread_mutex_lock(&writer_lock);
+		writer_stop = true;
+		pthread_cond_signal(&writer_ready);
+		pthread_mutex_unlock(&writer_lock);
+		pthread_join(writer,NULL);
+		writer_running = false;
+		mysql_close(writer_mysql);
+		writer_mysql = NULL;
+		if ( writer_error[0]!='\0' )
+			gl_error("%s insert pipeline failed - %s", get_name(), (const char*)writer_error);
+	}
+	else
+	{
+		for ( BATCH *batch=batches ; batch!=NULL ; batch=batch->next )
+			send_now(batch);
+		if ( writer_error[0]!='\0' )
+			gl_error("%s insert failed - %s", get_name(), (const char*)writer_error);
+	}
+
 	if ( strcmp(get_on_term(),"")!=0 )
 	{
 		gl_verbose("%s running on_term script '%s'", get_name(), get_on_term());
@@ -205,6 +253,7 @@ TIMESTAMP database::commit(TIMESTAMP t0, TIMESTAMP t1)
 			gld_clock ts(t0);
 			char buffer[64];
 			gl_verbose("%s running on_init script '%s' at %s", get_name(), get_on_sync(), ts.to_string(buffer,sizeof(buffer))?buffer:"(unknown time)");
+			flush(); // script must see all the rows staged so far
 			int res = run_script(get_on_sync());
 			if ( res<=0 )
 				exception("on_init script '%s' failed at line %d: %s", get_on_sync(), -res, get_last_error());
@@ -597,6 +646,253 @@ size_t database::backup(char *file)
 	return nrows;
 }
 
+BATCH *database::open_batch(char *fmt,...)
+{
+	char header[4096];
+	va_list ptr;
+	va_start(ptr,fmt);
+	int len = vsnprintf(header,sizeof(header),fmt,ptr);
+	va_end(ptr);
+	if ( len<0 || len>=sizeof(header) )
+		exception("%s->open_batch[%.32s...] insert header too long", get_name(), header);
+
+	BATCH *batch = new BATCH;
+	memset(batch,0,sizeof(BATCH));
+	batch->header = new char[len+1];
+	strcpy(batch->header,header);
+
+	// batches are only added by the main thread but the writer may be walking the list
+	if ( writer_running ) pthread_mutex_lock(&writer_lock);
+	batch->next = batches;
+	batches = batch;
+	if ( writer_running ) pthread_mutex_unlock(&writer_lock);
+	return batch;
+}
+
+void database::stage(BATCH *batch, char *fmt,...)
+{
+	char row[4096];
+	va_list ptr;
+	va_start(ptr,fmt);
+	int len = vsnprintf(row,sizeof(row),fmt,ptr);
+	va_end(ptr);
+	if ( len<0 || len>=sizeof(row) )
+		exception("%s->stage[%.32s...] row too long", get_name(), row);
+
+	if ( writer_running ) 
+	{
+		check_writer();
+		pthread_mutex_lock(&writer_lock);
+	}
+
+	// grow the row buffer (the writer takes ownership of full buffers)
+	size_t need = batch->len + len + 2;
+	if ( need>batch->size )
+	{
+		size_t size = batch->size>0 ? batch->size : 4096;
+		while ( size<need ) size *= 2;
+		char *rows = (char*)realloc(batch->rows,size);
+		if ( rows==NULL )
+		{
+			if ( writer_running ) pthread_mutex_unlock(&writer_lock);
+			exception("%s->stage: unable to allocate %d bytes for staged rows", get_name(), size);
+		}
+		batch->rows = rows;
+		batch->size = size;
+	}
+	if ( batch->count>0 ) 
+		batch->rows[batch->len++] = ',';
+	else
+		batch->first = time(NULL);
+	strcpy(batch->rows+batch->len,row);
+	batch->len += len;
+	batch->count++;
+
+	if ( writer_running )
+	{
+		if ( batch_is_ready(batch,time(NULL),false) )
+			pthread_cond_signal(&writer_ready);
+		pthread_mutex_unlock(&writer_lock);
+	}
+	else if ( batch->count>=get_batch_size() || batch->len>=BATCH_MAXSIZE )
+	{
+		// no pipeline - send the rows now
+		send_now(batch);
+		check_writer();
+	}
+}
+
+void database::flush(void)
+{
+	if ( writer_running )
+	{
+		pthread_mutex_lock(&writer_lock);
+		flushing++;
+		pthread_cond_signal(&writer_ready);
+		for ( ;; )
+		{
+			BATCH *batch;
+			for ( batch=batches ; batch!=NULL && batch->count==0 ; batch=batch->next ) {}
+			if ( batch==NULL && !writer_busy ) 
+				break;
+			pthread_cond_wait(&writer_idle,&writer_lock);
+		}
+		flushing--;
+		pthread_mutex_unlock(&writer_lock);
+		check_writer();
+	}
+	else
+	{
+		for ( BATCH *batch=batches ; batch!=NULL ; batch=batch->next )
+			send_now(batch);
+		check_writer();
+	}
+}
+
+void database::send_now(BATCH *batch)
+{
+	if ( batch->count==0 ) return;
+	BATCH one = *batch;
+	one.next = NULL;
+	send_rows(mysql,&one);
+	batch->len = 0;
+	batch->count = 0;
+}
+
+void database::check_writer(void)
+{
+	// errors from the writer thread are reported on the main thread
+	char1024 error;
+	if ( writer_running ) pthread_mutex_lock(&writer_lock);
+	strcpy(error,writer_error);
+	if ( writer_running ) pthread_mutex_unlock(&writer_lock);
+	if ( error[0]!='\0' )
+		exception("%s insert pipeline failed - %s", get_name(), (const char*)error);
+}
+
+char *database::escape(char *buffer, size_t size, const char *value)
+{
+	size_t len = strlen(value);
+	if ( len*2+1>size )
+		return NULL;
+	mysql_real_escape_string(mysql,buffer,value,(unsigned long)len);
+	return buffer;
+}
+
+void *database::writer_main(void *arg)
+{
+	gl_pool_release();
+	mysql_thread_init();
+	((database*)arg)->writer_loop();
+	mysql_thread_end();
+	return NULL;
+}
+
+void database::writer_loop(void)
+{
+	pthread_mutex_lock(&writer_lock);
+	for ( ;; )
+	{
+		// take every batch that is due (everything when flushing or stopping)
+		time_t now = time(NULL);
+		bool force = flushing>0 || writer_stop;
+		BATCH *list = NULL, *batch;
+		for ( batch=batches ; batch!=NULL ; batch=batch->next )
+		{
+			if ( batch_is_ready(batch,now,force) )
+			{
+				BATCH *item = new BATCH;
+				*item = *batch;
+				item->next = list;
+				list = item;
+				batch->rows = NULL;
+				batch->size = batch->len = 0;
+				batch->count = 0;
+			}
+		}
+
+		// nothing due
+		if ( list==NULL )
+		{
+			pthread_cond_broadcast(&writer_idle);
+			if ( writer_stop )
+				break;
+
+			// wake up in time for the oldest staged row
+			struct timespec until = {now+1,0};
+			for ( batch=batches ; batch!=NULL ; batch=batch->next )
+			{
+				if ( batch->count>0 && batch->first+(time_t)get_batch_latency()+1<until.tv_sec )
+					until.tv_sec = batch->first+(time_t)get_batch_latency()+1;
+			}
+			if ( until.tv_sec<=now ) until.tv_sec = now+1;
+			pthread_cond_timedwait(&writer_ready,&writer_lock,&until);
+			continue;
+		}
+
+		// send outside the lock so the simulation can keep staging rows
+		writer_busy = true;
+		pthread_mutex_unlock(&writer_lock);
+		send_rows(writer_mysql,list);
+		while ( list!=NULL )
+		{
+			batch = list->next;
+			free(list->rows);
+			delete list;
+			list = batch;
+		}
+		pthread_mutex_lock(&writer_lock);
+		writer_busy = false;
+	}
+	pthread_mutex_unlock(&writer_lock);
+}
+
+bool database::batch_is_ready(BATCH *batch, time_t now, bool force)
+{
+	if ( batch->count==0 ) return false;
+	return force || batch->count>=get_batch_size() || batch->len>=BATCH_MAXSIZE 
+		|| difftime(now,batch->first)>=get_batch_latency();
+}
+
+bool database::send_rows(MYSQL *handle, BATCH *list)
+{
+	// sends each batch in the list as one multi-row insert, all inside a single transaction
+	bool ok = mysql_query(handle,"START TRANSACTION")==0;
+	char *statement = NULL;
+	size_t size = 0;
+	BATCH *batch;
+	for ( batch=list ; ok && batch!=NULL ; batch=batch->next )
+	{
+		size_t hlen = strlen(batch->header);
+		if ( hlen+batch->len+1>size )
+		{
+			size = hlen+batch->len+1;
+			delete [] statement;
+			statement = new char[size];
+		}
+		memcpy(statement,batch->header,hlen);
+		memcpy(statement+hlen,batch->rows,batch->len);
+		statement[hlen+batch->len] = '\0';
+		ok = mysql_real_query(handle,statement,(unsigned long)(hlen+batch->len))==0;
+		if ( handle==mysql && ok && get_options()&DBO_SHOWQUERY )
+			gl_verbose("%s->insert[%.64s...] %d rows ok", get_name(), statement, batch->count);
+	}
+	delete [] statement;
+	if ( ok )
+		ok = mysql_query(handle,"COMMIT")==0;
+	if ( !ok )
+	{
+		// the writer thread sends without holding the lock
+		bool locked = writer_running && handle==writer_mysql;
+		if ( locked ) pthread_mutex_lock(&writer_lock);
+		if ( writer_error[0]=='\0' )
+			strncpy(writer_error,mysql_error(handle),sizeof(writer_error)-1);
+		if ( locked ) pthread_mutex_unlock(&writer_lock);
+		mysql_query(handle,"ROLLBACK");
+	}
+	return ok;
+}
+
 TIMESTAMP database::convert_to_dbtime(TIMESTAMP ts)
 {
 	// incoming timestamp is UTC -- convert it to db time by adding offset and dst
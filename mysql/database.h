@@ -26,6 +26,7 @@
 #endif
 
 #include <mysql.h>
+#include <pthread.h>
 
 #ifdef DLMAIN
 #define EXTERN
@@ -50,6 +51,19 @@ EXTERN char default_table_prefix[256] INIT(""); ///< table prefix
 #define DBO_DROPSCHEMA 0x0004 ///< drop schema before using it
 #define DBO_OVERWRITE 0x0008	///< overwrite existing file when dumping and backing up
 
+#define BATCH_MAXSIZE 1048576 ///< largest multi-row insert sent in one statement (bytes)
+
+/// rows staged for a multi-row insert into one table
+typedef struct s_batch {
+	char *header; ///< INSERT INTO ... VALUES prefix of the statement
+	char *rows; ///< comma separated row values staged so far
+	size_t len; ///< length of staged row values
+	size_t size; ///< allocated size of rows
+	unsigned int count; ///< number of rows staged
+	time_t first; ///< wall clock time at which the oldest staged row was added
+	struct s_batch *next;
+} BATCH;
+
 class database : public gld_object {
 public:
 	GL_STRING(char256,hostname);
@@ -66,6 +80,8 @@ public:
 	GL_ATOMIC(double,sync_interval);
 	GL_ATOMIC(int32,tz_offset);
 	GL_ATOMIC(bool,uses_dst);
+	GL_ATOMIC(int32,batch_size);
+	GL_ATOMIC(double,batch_latency);
 
 	// mysql handle
 private:
@@ -73,6 +89,31 @@ private:
 public:
 	inline MYSQL *get_handle() { return mysql; };
 
+	// insert pipeline
+private:
+	MYSQL *writer_mysql; ///< connection used by the writer thread
+	pthread_t writer; ///< writer thread
+	pthread_mutex_t writer_lock; ///< protects batches and writer state
+	pthread_cond_t writer_ready; ///< signals the writer that rows may be ready
+	pthread_cond_t writer_idle; ///< signals waiters that the writer has nothing left to send
+	bool writer_running; ///< writer thread was started
+	bool writer_stop; ///< writer thread must drain and exit
+	bool writer_busy; ///< writer thread is sending rows
+	unsigned int flushing; ///< number of threads waiting for a flush
+	char1024 writer_error; ///< first error reported by the writer thread
+	BATCH *batches; ///< list of staged batches
+	static void *writer_main(void *arg);
+	void writer_loop(void);
+	bool batch_is_ready(BATCH *batch, time_t now, bool force);
+	bool send_rows(MYSQL *handle, BATCH *list);
+	void send_now(BATCH *batch);
+	void check_writer(void);
+public:
+	BATCH *open_batch(char *fmt,...);
+	void stage(BATCH *batch, char *fmt,...);
+	void flush(void);
+	char *escape(char *buffer, size_t size, const char *value);
+
 	// term list
 private:
 	database *next;
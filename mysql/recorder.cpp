@@ -156,8 +156,13 @@ int recorder::init(OBJECT *parent)
 		// check row count
 		else 
 		{
-			if ( db->select("SELECT count(*) FROM `%s`", get_table())==NULL )
+			MYSQL_RES *res = db->select("SELECT count(*) FROM `%s`", get_table());
+			if ( res==NULL )
 				exception("unable to get row count of table '%s'", get_table());
+			MYSQL_ROW row = mysql_fetch_row(res);
+			if ( row!=NULL && row[0]!=NULL )
+				n_rows = atoi64(row[0]);
+			mysql_free_result(res);
 
 			gl_verbose("table '%s' ok", get_table());
 		}
@@ -191,29 +196,8 @@ int recorder::init(OBJECT *parent)
 		}
 	}
 
-	// prepare insert statement
-	char statement[1024];
-	int len = sprintf(statement,"INSERT INTO `%s` (`%s`) VALUES ('?')", get_table(), (const char*)field);
-	gl_verbose("preparing statement '%s'", statement);
-	insert = mysql_stmt_init(db->get_handle());
-	if ( !db->get_sqlbind(value,target,&stmt_error) )
-	{
-		gl_warning("unable to bind target '%s'", target.get_name());
-		mysql_stmt_close(insert);
-		insert = NULL;
-	}
-	else if ( mysql_stmt_prepare(insert,statement,len)!=0 )
-	{
-		gl_warning("insert statement '%s' prepare failed (error='%s'), using slow 'INSERT' method", statement, mysql_stmt_error(insert));
-		mysql_stmt_close(insert);
-		insert = NULL;
-	}
-	else if ( mysql_stmt_bind_param(insert,&value)!=0 )
-	{
-		gl_warning("insert statement '%s' bind failed (error='%s'), using slow 'INSERT' method", statement, mysql_stmt_error(insert));
-		mysql_stmt_close(insert);
-		insert = NULL;
-	}
+	// samples are staged and sent by the database as multi-row inserts
+	batch = db->open_batch("INSERT INTO `%s` (t, `%s`) VALUES ", get_table(), (const char*)field);
 
 	return 1;
 }
@@ -281,44 +265,29 @@ TIMESTAMP recorder::commit(TIMESTAMP t0, TIMESTAMP t1)
 
 		if ( have_data )
 		{
-			// use prepared statement if possible
-			if ( insert )
+			// stage data
+			if ( target.is_double() )
 			{
-				if ( mysql_stmt_execute(insert)!=0 || stmt_error || mysql_stmt_affected_rows(insert)==0 )
-				{
-					int64 n = mysql_stmt_affected_rows(insert);
-					gl_warning("unable to execute insert statement for target '%s' (%s) - reverting to slower INSERT", target.get_name(), mysql_stmt_error(insert));
-					mysql_stmt_close(insert);
-					insert = NULL;
-
-					// if insert totally failed to add the row
-					if ( n==0 )
-						goto Insert;
-				}
+				db->stage(batch,"(from_unixtime('%"FMT_INT64"d'), '%.8g')",
+					db->convert_to_dbtime(gl_globalclock), real);
+			}
+			else if ( target.is_integer() )
+			{
+				db->stage(batch,"(from_unixtime('%"FMT_INT64"d'), '%lli')",
+					db->convert_to_dbtime(gl_globalclock), integer);
 			}
-
-			// use slower INSERT statement
 			else
 			{
-Insert:
-				// send data
-				if ( target.is_double() )
-				{
-					db->query("INSERT INTO `%s` (t, `%s`) VALUES (from_unixtime('%"FMT_INT64"d'), '%.8g')",
-						get_table(), (const char*)field, db->convert_to_dbtime(gl_globalclock), real);
-				}
-				else if ( target.is_integer() )
-				{
-					db->query("INSERT INTO `%s` (t, `%s`) VALUES (from_unixtime('%"FMT_INT64"d'), '%lli')",
-						get_table(), (const char*)field, db->convert_to_dbtime(gl_globalclock), integer);
-				}
-				else
-					db->query("INSERT INTO `%s` (t, `%s`) VALUES (from_unixtime('%"FMT_INT64"d'), '%s')",
-						get_table(), (const char*)field, db->convert_to_dbtime(gl_globalclock), (const char*)string);
+				char value[sizeof(string)*2+1];
+				if ( db->escape(value,sizeof(value),string)==NULL )
+					exception("unable to escape sample '%s'", (const char*)string);
+				db->stage(batch,"(from_unixtime('%"FMT_INT64"d'), '%s')",
+					db->convert_to_dbtime(gl_globalclock), value);
 			}
+			n_rows++;
 
 			// check limit
-			if ( get_limit()>0 && db->get_last_index()>=get_limit() )
+			if ( get_limit()>0 && n_rows>=get_limit() )
 			{
 				// shut off recorder
 				enabled=false;
@@ -27,12 +27,11 @@ private:
 	char256 field;
 	double scale;
 	database *db;
-	MYSQL_STMT *insert;
-	MYSQL_BIND value;
+	BATCH *batch; ///< rows staged for insert
+	int64 n_rows; ///< rows in table (including staged rows)
 	double real;
 	int64 integer;
 	char1024 string;
-	my_bool stmt_error;
 	bool trigger_on;
 	char compare_op[16];
 	char compare_val[32];
@@ -12,5 +12,7 @@ optimize_optimize_la_SOURCES =
 optimize_optimize_la_SOURCES += optimize/init.cpp
 optimize_optimize_la_SOURCES += optimize/main.cpp
 optimize_optimize_la_SOURCES += optimize/optimize.h
+optimize_optimize_la_SOURCES += optimize/particle_swarm_optimization.cpp
+optimize_optimize_la_SOURCES += optimize/particle_swarm_optimization.h
 optimize_optimize_la_SOURCES += optimize/simple.cpp
 optimize_optimize_la_SOURCES += optimize/simple.h
@@ -9,6 +9,7 @@
 
 #include "optimize.h"
 #include "simple.h"
+#include "particle_swarm_optimization.h"
 
 EXPORT CLASS *init(CALLBACKS *fntable, MODULE *module, int argc, char *argv[])
 {
@@ -19,6 +20,7 @@ EXPORT CLASS *init(CALLBACKS *fntable, MODULE *module, int argc, char *argv[])
 	}
 
 	new simple(module);
+	new particle_swarm_optimization(module);
 
 	/*** DO NOT EDIT NEXT LINE ***/
 	//NEWCLASS
@@ -24,6 +24,12 @@ particle_swarm_optimization *particle_swarm_optimization::defaults = NULL;
 static PASSCONFIG passconfig = PC_PRETOPDOWN|PC_POSTTOPDOWN;
 static PASSCONFIG clockpass = PC_POSTTOPDOWN;
 
+// what-if search step
+static unsigned int pso_search(void *context, unsigned int generation, double *candidates, const double *results, unsigned int count, unsigned int max)
+{
+	return ((particle_swarm_optimization*)context)->search(generation,candidates,results,count,max);
+}
+
 // Class registration is only called once to register the class with the core
 particle_swarm_optimization::particle_swarm_optimization(MODULE *module)
 {
@@ -61,6 +67,13 @@ particle_swarm_optimization::particle_swarm_optimization(MODULE *module)
 			PT_double, "velocity_ub", PADDR(velocity_ub), PT_DESCRIPTION, "velocity_ub", //
 
 			PT_double,"cycle_interval[s]", PADDR(cycle_interval),
+
+			PT_char1024, "objective", PADDR(objective), PT_DESCRIPTION, "Optimization objective value (empty to solve the built-in test problem)",
+			PT_char1024, "variables", PADDR(variables), PT_DESCRIPTION, "Optimization decision variables (comma separated, at most 3)",
+			PT_double, "horizon[s]", PADDR(horizon), PT_DESCRIPTION, "Time simulated to evaluate the objective of each particle",
+			PT_enumeration, "goal", PADDR(goal), PT_DESCRIPTION, "Optimization objective goal",
+				PT_KEYWORD, "MINIMUM", OG_MINIMUM,
+				PT_KEYWORD, "MAXIMUM", OG_MAXIMUM,
 						
 			NULL)<1)
 		{
@@ -86,6 +99,7 @@ int particle_swarm_optimization::create(void)
 	/*int rval;*/
 	cycle_interval_TS = 0;
 	time_cycle_interval = 0;	
+	goal = OG_MINIMUM;
 	///*
 	//retur*/n rval;
 	return 1; // return 1 on success, 0 on failure
@@ -187,6 +201,48 @@ int particle_swarm_optimization::init(OBJECT *parent)
 		return 0;
 	}
 
+	// evaluate the swarm against the model when an objective is given
+	if (strcmp(objective,"") != 0)
+	{
+		char list[1024];
+		char *next = NULL;
+		int n = 0;
+		pObjective = find_double(objective);
+		if (pObjective == NULL)
+			return 0;
+		strcpy(list,variables);
+		for (char *spec = strtok_s(list,",",&next); spec != NULL; spec = strtok_s(NULL,",",&next))
+		{
+			if (n == 3)
+			{
+				gl_error("PSO object '%s' has more than 3 decision variables", gl_name(obj,buffer,sizeof(buffer))?buffer:"???");
+				return 0;
+			}
+			pVariable[n] = find_double(spec);
+			if (pVariable[n++] == NULL)
+				return 0;
+		}
+		if (n == 0)
+		{
+			gl_error("The property 'variables' must be set in PSO object '%s' when 'objective' is set", gl_name(obj,buffer,sizeof(buffer))?buffer:"???");
+			return 0;
+		}
+		no_unknowns = n;
+		if (no_particles > 500)
+		{
+			gl_error("The no_particles limit 'no_particles' in PSO object '%s' must not exceed 500", gl_name(obj,buffer,sizeof(buffer))?buffer:"???");
+			return 0;
+		}
+		if (horizon <= 0)
+			horizon = cycle_interval;
+		whatif = gl_whatif_create(obj,n,(unsigned int)no_particles,(TIMESTAMP)horizon);
+		if (whatif == NULL)
+			return 0;
+		gl_whatif_set_objective(whatif,pObjective);
+		for (int dimension = 0; dimension < n; dimension++)
+			gl_whatif_set_variable(whatif,dimension,pVariable[dimension]);
+	}
+
 	time_cycle_interval = gl_globalclock;
 	return 1; // return 1 on success, 0 on failure
 
@@ -218,116 +274,171 @@ TIMESTAMP particle_swarm_optimization::presync(TIMESTAMP t0, TIMESTAMP t1)
 
 	if (curr_cycle_time >= time_cycle_interval)	//Update values
 	{
-
-			for (int particle = 0; particle < no_particles; particle++) 
+		if (whatif != NULL)
+		{
+			// the swarm is evaluated against the model by the what-if engine before the next sync
+			if (!gl_whatif_start(whatif,pso_search,this))
 			{
-				for (int dimension = 0; dimension < no_unknowns; dimension++) 
-				{
-					particle_position[particle][dimension] = position_lb + (position_ub - position_lb) * gl_random_uniform(RNGSTATE,0.0,1.0);
-					particle_velocity[particle][dimension] = velocity_lb + (velocity_ub - velocity_lb) *gl_random_uniform(RNGSTATE,0.0,1.0);
-
-				}
+				gl_error("particle_swarm_optimization:%d what-if search could not be started", obj->id);
+				/*  TROUBLESHOOT
+				The swarm search could not be scheduled, usually because the previous search has not run
+				yet or the simulation runs in a mode that does not allow what-if evaluation.  The preceding
+				messages give more detail.
+				*/
+				return TS_INVALID;
 			}
+		}
+		else
+		{
+			initialize_swarm();
+			for (int iteration = 0; iteration < max_iterations; iteration++) 
+			{
+				for (int particle = 0; particle < no_particles; particle++) 
+					current_fitness[particle] = test_fitness(particle);
+				update_swarm();
+			}
+		}
+  
+		time_cycle_interval += cycle_interval_TS;
+	}
 
-			// Initialize the pbest fitness 
+	//Next update is at the next cycle (t1 is the current time, which would force a reiteration)
+	t1 = time_cycle_interval;
 
-				pbset_fitness = -1000.0;
-				gbest_value = -1000.0;
+	//Make sure we don't send out a negative TS_NEVER
+	if (t1 == TS_NEVER)
+		return TS_NEVER;
+
+	else
+		return -t1;
+}
 
-		for (int iteration = 0; iteration < max_iterations; iteration++) 
+void particle_swarm_optimization::initialize_swarm(void)
+{
+	for (int particle = 0; particle < no_particles; particle++) 
+	{
+		for (int dimension = 0; dimension < no_unknowns; dimension++) 
 		{
-			for (int particle = 0; particle < no_particles; particle++) 
+			particle_position[particle][dimension] = position_lb + (position_ub - position_lb) * gl_random_uniform(RNGSTATE,0.0,1.0);
+			particle_velocity[particle][dimension] = velocity_lb + (velocity_ub - velocity_lb) *gl_random_uniform(RNGSTATE,0.0,1.0);
+		}
+	}
 
-			{
-				variable_1 = particle_position[particle][0];
-				variable_2 = particle_position[particle][1];
-				variable_3 = particle_position[particle][2];
+	// Initialize the pbest fitness 
+	pbset_fitness = -1000.0;
+	gbest_value = -1000.0;
+}
 
+double particle_swarm_optimization::test_fitness(int particle)
+{
+	variable_1 = particle_position[particle][0];
+	variable_2 = particle_position[particle][1];
+	variable_3 = particle_position[particle][2];
 
-				//solution = 100*(variable_2 - (variable_1*variable_1))*(variable_2 - (variable_1*variable_1))+ (1-variable_1)*(1-variable_1) ; 
-				//solution = (0.25*variable_1*variable_1*variable_1*variable_1) + (0.5*variable_2*variable_2) - (variable_1*variable_2) + variable_1 - variable_2;
+	//solution = 100*(variable_2 - (variable_1*variable_1))*(variable_2 - (variable_1*variable_1))+ (1-variable_1)*(1-variable_1) ; 
+	//solution = (0.25*variable_1*variable_1*variable_1*variable_1) + (0.5*variable_2*variable_2) - (variable_1*variable_2) + variable_1 - variable_2;
 
 //Minimization example
-				solution = 2*variable_1 + 10*variable_2 + 8*variable_3;//example 2, page 514
-				
-				if ((variable_1 + variable_2 + variable_3 >= 6) && (variable_2 + 2*variable_3 >= 8) && (-variable_1 + 2*variable_2 + 2*variable_3 >= 4)&& (variable_1 >=0)&&(variable_2 >=0)&& (variable_3 >=0))
-					current_fitness[particle] = -solution;	
-				else
-					current_fitness[particle] = -solution-100000000000000;				
+	solution = 2*variable_1 + 10*variable_2 + 8*variable_3;//example 2, page 514
+	
+	if ((variable_1 + variable_2 + variable_3 >= 6) && (variable_2 + 2*variable_3 >= 8) && (-variable_1 + 2*variable_2 + 2*variable_3 >= 4)&& (variable_1 >=0)&&(variable_2 >=0)&& (variable_3 >=0))
+		return -solution;	
+	else
+		return -solution-100000000000000;				
 
 //Maximization example
-			//	solution = -2*variable_1 + variable_2 - 2*variable_3;//maximize solution = 2*variable_1 - variable_2 + 2*variable_3;(example 2, page 500)
-			//	
-			//	if ((variable_1 + 2*variable_2 - 2*variable_3 <= 20) && (2*variable_1 + variable_2 <= 10) && (variable_2 + 2*variable_3 <= 5)&& (variable_1 >=0)&&(variable_2 >=0)&& (variable_3 >=0))
-			//		current_fitness[particle] = -solution;	
-			//	else
-			//		current_fitness[particle] = solution-100000000000000;	
-
-			}
-
-			// Decide pbest among all the particles
-
-			for (int particle = 0; particle < no_particles; particle++) 
+//	solution = -2*variable_1 + variable_2 - 2*variable_3;//maximize solution = 2*variable_1 - variable_2 + 2*variable_3;(example 2, page 500)
+//	
+//	if ((variable_1 + 2*variable_2 - 2*variable_3 <= 20) && (2*variable_1 + variable_2 <= 10) && (variable_2 + 2*variable_3 <= 5)&& (variable_1 >=0)&&(variable_2 >=0)&& (variable_3 >=0))
+//		return -solution;	
+//	else
+//		return solution-100000000000000;	
+}
 
+void particle_swarm_optimization::update_swarm(void)
+{
+	// Decide pbest among all the particles
+	for (int particle = 0; particle < no_particles; particle++) 
+	{
+		if (current_fitness[particle] > pbset_fitness)
+		{
+			pbset_fitness= current_fitness[particle];
+			for (int dimension = 0; dimension < no_unknowns; dimension++)
 			{
-				if (current_fitness[particle] > pbset_fitness)
-				{
-					pbset_fitness= current_fitness[particle];
-				
-				for (int dimension = 0; dimension < no_unknowns; dimension++)
-				{
-					pbest[0][dimension] = particle_position[particle][dimension];
-				}	
-				}
-
-			}			
-
-			if (pbset_fitness> gbest_value)
-			{
-				gbest_value= pbset_fitness;
-			for (int dimension = 0; dimension < no_unknowns; dimension++)	
-				{
-				gbest[0][dimension] = pbest[0][dimension];				
-				}
-			}
+				pbest[0][dimension] = particle_position[particle][dimension];
+			}	
+		}
+	}			
 
-			gbest1 = gbest[0][0];
-			gbest2 = gbest[0][1];
-			gbest3 = gbest[0][2];
+	if (pbset_fitness> gbest_value)
+	{
+		gbest_value= pbset_fitness;
+		for (int dimension = 0; dimension < no_unknowns; dimension++)	
+		{
+			gbest[0][dimension] = pbest[0][dimension];				
+		}
+	}
 
-				// Update position and velocity
+	gbest1 = gbest[0][0];
+	gbest2 = gbest[0][1];
+	gbest3 = gbest[0][2];
 
-			for (int particle = 0; particle < no_particles; particle++) 
+	// Update position and velocity
+	for (int particle = 0; particle < no_particles; particle++) 
+	{
+		for (int dimension = 0; dimension < no_unknowns; dimension++)
+		{
+			rand1 = gl_random_uniform(RNGSTATE,0.0,1.0);
+			rand2 = gl_random_uniform(RNGSTATE,0.0,1.0);
 
-			{
-				for (int dimension = 0; dimension < no_unknowns; dimension++)
-				{
-					rand1 = gl_random_uniform(RNGSTATE,0.0,1.0);
-					rand2 = gl_random_uniform(RNGSTATE,0.0,1.0);
+			particle_velocity[particle][dimension] = w*particle_velocity[particle][dimension] + C1 * rand1 * (pbest[0][dimension] - particle_position[particle][dimension])+C2 * rand2 * (gbest[0][dimension] - particle_position[particle][dimension]);
 
-					particle_velocity[particle][dimension] = w*particle_velocity[particle][dimension] + C1 * rand1 * (pbest[0][dimension] - particle_position[particle][dimension])+C2 * rand2 * (gbest[0][dimension] - particle_position[particle][dimension]);
+			particle_position[particle][dimension] = particle_position[particle][dimension]+particle_velocity[particle][dimension];
+		}
+	}
+}
 
-					particle_position[particle][dimension] = particle_position[particle][dimension]+particle_velocity[particle][dimension];
+// Search step of a what-if search: the results of each generation of particles are the objective
+// at the end of the horizon (NaN when a particle could not be simulated).  The best position found
+// is applied to the decision variables when the last iteration is done.
+unsigned int particle_swarm_optimization::search(unsigned int generation, double *candidates, const double *results, unsigned int count, unsigned int max)
+{
+	int n_particles = (int)no_particles;
+	int n_unknowns = (int)no_unknowns;
 
-				}
-			}
+	if (results == NULL)
+	{
+		// the built-in sentinel is too small for real objectives, so start from the current decision
+		initialize_swarm();
+		pbset_fitness = gbest_value = -HUGE_VAL;
+		for (int dimension = 0; dimension < n_unknowns; dimension++)
+			gbest[0][dimension] = pbest[0][dimension] = *(pVariable[dimension]);
+	}
+	else
+	{
+		for (int particle = 0; particle < (int)count; particle++)
+		{
+			if (isnan(results[particle]))
+				current_fitness[particle] = -HUGE_VAL;
+			else
+				current_fitness[particle] = goal==OG_MAXIMUM ? results[particle] : -results[particle];
 		}
-  
-		time_cycle_interval += cycle_interval_TS;
-		t1 = time_cycle_interval;
+		update_swarm();
 	}
 
-	if (t1 > time_cycle_interval)
+	if (generation >= max_iterations)
 	{
-		t1 = time_cycle_interval;	//Next output cycle is sooner
+		for (int dimension = 0; dimension < n_unknowns; dimension++)
+			*(pVariable[dimension]) = gbest[0][dimension];
+		return 0;
 	}
 
-	//Make sure we don't send out a negative TS_NEVER
-	if (t1 == TS_NEVER)
-		return TS_NEVER;
-
-	else
-		return -t1;
+	for (int particle = 0; particle < n_particles; particle++)
+	{
+		for (int dimension = 0; dimension < n_unknowns; dimension++)
+			candidates[particle*n_unknowns+dimension] = particle_position[particle][dimension];
+	}
+	return n_particles;
 }
 
 // Postsync is called when the clock needs to advance on the second top-down pass
@@ -343,6 +454,46 @@ TIMESTAMP particle_swarm_optimization::postsync(TIMESTAMP t0, TIMESTAMP t1)
 		return TS_NEVER;
 }
 
+// find a double property given as 'objectname.propertyname'
+double *particle_swarm_optimization::find_double(char *spec)
+{
+	OBJECT *my = OBJECTHDR(this);
+	char oname[1024];
+	char pname[1024];
+	OBJECT *obj;
+	PROPERTY *prop;
+	if ( sscanf(spec," %[^.:].%[a-zA-Z0-9_.]",oname,pname)!=2 )
+	{
+		gl_error("'%s' could not be parsed, expected term in the form 'objectname'.'propertyname'", spec);
+		return NULL;
+	}
+
+	// find the object
+	obj = gl_get_object(oname);
+	if ( obj==NULL )
+	{
+		gl_error("object '%s' could not be found", oname);
+		return NULL;
+	}
+
+	// must outrank dependent objects
+	if ( my->rank<=obj->rank ) gl_set_rank(my,obj->rank+1);
+
+	// get property
+	prop = gl_get_property(obj,pname);
+	if ( prop==NULL )
+	{
+		gl_error("property '%s' could not be found in object '%s'", pname, oname);
+		return NULL;
+	}
+	if ( prop->ptype!=PT_double )
+	{
+		gl_error("property '%s' in object '%s' is not a double", pname, oname);
+		return NULL;
+	}
+	return (double*)gl_get_addr(obj,pname);
+}
+
 bool particle_swarm_optimization::constraint_broken(bool (*op)(double,double), double value, double x)
 {
 	return !op(x,value);
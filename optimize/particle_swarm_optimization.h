@@ -59,6 +59,10 @@ protected:
 
 	double w;
 
+	char1024 objective; // objective variable name ("object.property"), empty to solve the built-in test problem
+	char1024 variables; // decision variable names ("object.property,...")
+	double horizon; // time simulated by each what-if candidate
+
 	
 	int32 trials; // maximum number of trials allowed for one point in DISCRETE_ITERATE
 private:
@@ -87,9 +91,8 @@ private:
 	//	double imag; // constraint value
 	//} *pObjective; // objective variable
 	double *pObjective; // objective variable
-	double *pVariable1; // decision variable
-	double *pVariable2; // decision variable
-	double *pVariable3; // decision variable
+	double *pVariable[3]; // decision variables
+	WHATIF *whatif; // what-if evaluation of the swarm against the model
 	double *pConstraint1; // Constraint variable. One for each, upper and lower for x and y.
 	double *pConstraint2;
 	double *pConstraint3;
@@ -131,6 +134,10 @@ private:
 		double value; // constraint value
 	} constrain8; // describe a constraint
 	bool constraint_broken(bool (*op)(double,double), double value, double x); // detect constraint
+	double *find_double(char *spec); // find a double property of an object
+	void initialize_swarm(void); // place the particles at random
+	void update_swarm(void); // update the bests and move the particles
+	double test_fitness(int particle); // fitness of a particle for the built-in test problem
 public:
 	// required implementations 
 	particle_swarm_optimization(MODULE *module);
@@ -140,6 +147,7 @@ public:
 	TIMESTAMP presync(TIMESTAMP t0, TIMESTAMP t1);
 	TIMESTAMP sync(TIMESTAMP t0, TIMESTAMP t1);
 	TIMESTAMP postsync(TIMESTAMP t0, TIMESTAMP t1);
+	unsigned int search(unsigned int generation, double *candidates, const double *results, unsigned int count, unsigned int max);
 public:
 	static CLASS *oclass;
 	static CLASS *pclass;
@@ -19,8 +19,12 @@ powerflow_powerflow_la_SOURCES += powerflow/billdump.cpp
 powerflow_powerflow_la_SOURCES += powerflow/billdump.h
 powerflow_powerflow_la_SOURCES += powerflow/capacitor.cpp
 powerflow_powerflow_la_SOURCES += powerflow/capacitor.h
+powerflow_powerflow_la_SOURCES += powerflow/cmatrix.cpp
+powerflow_powerflow_la_SOURCES += powerflow/cmatrix.h
 powerflow_powerflow_la_SOURCES += powerflow/currdump.cpp
 powerflow_powerflow_la_SOURCES += powerflow/currdump.h
+powerflow_powerflow_la_SOURCES += powerflow/discrete_control.cpp
+powerflow_powerflow_la_SOURCES += powerflow/discrete_control.h
 powerflow_powerflow_la_SOURCES += powerflow/emissions.cpp
 powerflow_powerflow_la_SOURCES += powerflow/emissions.h
 powerflow_powerflow_la_SOURCES += powerflow/fault_check.cpp
@@ -80,6 +84,8 @@ powerflow_powerflow_la_SOURCES += powerflow/sectionalizer.cpp
 powerflow_powerflow_la_SOURCES += powerflow/sectionalizer.h
 powerflow_powerflow_la_SOURCES += powerflow/series_reactor.cpp
 powerflow_powerflow_la_SOURCES += powerflow/series_reactor.h
+powerflow_powerflow_la_SOURCES += powerflow/solver_fbs.cpp
+powerflow_powerflow_la_SOURCES += powerflow/solver_fbs.h
 powerflow_powerflow_la_SOURCES += powerflow/solver_nr.cpp
 powerflow_powerflow_la_SOURCES += powerflow/solver_nr.h
 powerflow_powerflow_la_SOURCES += powerflow/substation.cpp
@@ -20,6 +20,12 @@
 CLASS* capacitor::oclass = NULL;
 CLASS* capacitor::pclass = NULL;
 
+//Discrete control loop step of a capacitor object (see discrete_control.cpp)
+static bool capacitor_discrete_control(OBJECT *obj, TIMESTAMP t0)
+{
+	return OBJECTDATA(obj,capacitor)->cap_discrete_control_fxn(t0);
+}
+
 /**
 * constructor.  Class registration is only called once to 
 * register the class with the core. Include parent class constructor (node)
@@ -380,6 +386,12 @@ int capacitor::init(OBJECT *parent)
 	
 	switchA_changed = switchB_changed = switchC_changed = 2;
 
+	//Voltage control can settle inside the powerflow solution - VAr and current controls need the link values of postsync.
+	//Capacitors parented to a node have their shunt added to the parent during sync, and a SWING bus sensor is locked by its
+	//own sync while the loop runs, so those keep switching across passes.
+	if ((result == 1) && (discrete_control_loop == true) && (control == VOLT) && ((obj->parent == NULL) || !gl_object_isa(obj->parent,"node","powerflow")) && ((RNode == NULL) || ((RNode->bustype != SWING) && (RNode->bustype != SWING_PQ))))
+		discrete_control_register(obj,capacitor_discrete_control);
+
 	return result;
 }
 
@@ -1131,6 +1143,26 @@ int capacitor::cap_prePost_fxn(double time_value)
 	return 1;
 }
 
+//Discrete control loop step - re-runs the switching logic of sync on the solution just found, at the same timestamp
+//Returns true if a switch moved, so the system needs solving again
+bool capacitor::cap_discrete_control_fxn(TIMESTAMP t0)
+{
+	enumeration old_state[3];
+	double time_value = (double)t0;
+
+	old_state[0] = switchA_state;
+	old_state[1] = switchB_state;
+	old_state[2] = switchC_state;
+
+	cap_sync_fxn(time_value);
+
+	//A switch due now would be made by the next pass on this same solution, so make it here
+	if ((time_to_change <= 0) && ((switchA_state != switchA_state_Next) || (switchB_state != switchB_state_Next) || (switchC_state != switchC_state_Next)))
+		cap_sync_fxn(time_value);
+
+	return ((old_state[0] != switchA_state) || (old_state[1] != switchB_state) || (old_state[2] != switchC_state));
+}
+
 // Functionalized "post Node postsync" postsync routine, so can be called by deltamode	
 double capacitor::cap_postPost_fxn(double result, double time_value)
 {
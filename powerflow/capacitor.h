@@ -57,6 +57,7 @@ public:
 	bool cap_sync_fxn(double time_value);						// Functionalized sync routine, so can be called by deltamode
 	int cap_prePost_fxn(double time_value);						// Functionalized "pre Node postsync" postsync routine, so can be called by deltamode	
 	double cap_postPost_fxn(double result, double time_value);	// Functionalized "post Node postsync" postsync routine, so can be called by deltamode
+	bool cap_discrete_control_fxn(TIMESTAMP t0);				// Discrete control loop step, run after each powerflow solution
 	SIMULATIONMODE inter_deltaupdate_capacitor(unsigned int64 delta_time, unsigned long dt, unsigned int iteration_count_val, bool interupdate_pos);
 
 protected:
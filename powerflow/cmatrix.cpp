@@ -0,0 +1,397 @@
+/* $Id
+ * Complex matrix kernels with split real/imaginary storage
+ *
+ * The complex class keeps the real part, imaginary part and notation of each entry together,
+ * so a loop over a matrix of them strides 24 bytes and mixes the two parts in every
+ * register.  These kernels split the matrices into planes of real and imaginary parts on the
+ * stack, work on the planes, and join the result back.  A single 3x3 matrix does not pay for
+ * the conversion, so the links keep the inline complex forms (inverse, multiply, ...) for those.
+ *
+ * Every kernel performs the same floating point operations, in the same order, as the
+ * complex class operators in the routines they replace (lmatrix_mult, lmatrix_vmult,
+ * lu_matrix_inverse, ...), so the results are bit for bit the same.  cmatrix_test checks
+ * this and times the old and new forms; it is run with "gridlabd --modtest powerflow".
+ */
+
+#include <time.h>
+
+#include "powerflow.h"
+#include "cmatrix.h"
+
+//Real and imaginary parts of (ar+j*ai)*(br+j*bi), as complex::operator*= forms them
+#define CMUL_RE(ar,ai,br,bi) ((ar)*(br)-(ai)*(bi))
+#define CMUL_IM(ar,ai,br,bi) ((ar)*(bi)+(ai)*(br))
+
+//////////////////////////////////////////////////////////////////////////
+// General square kernels, size_val <= CMAT_MAXSIZE
+//////////////////////////////////////////////////////////////////////////
+
+//Splits n complex values into planes
+static void cmatn_split(complex *in, double *re, double *im, int n)
+{
+	int k;
+	for (k=0; k<n; k++)
+	{
+		re[k] = in[k].Re();
+		im[k] = in[k].Im();
+	}
+}
+
+static void cmatn_join(double *re, double *im, complex *out, int n)
+{
+	int k;
+	for (k=0; k<n; k++)
+		out[k] = complex(re[k],im[k]);
+}
+
+/** c = a+b; each sum keeps the notation of its entry of a, as complex::operator+ does **/
+void cmatn_add(complex *a, complex *b, complex *c, int size_val)
+{
+	int k, sq_size = size_val*size_val;
+	for (k=0; k<sq_size; k++)
+		c[k] = a[k] + b[k];
+}
+
+void cmatn_multiply(complex *a, complex *b, complex *c, int size_val)
+{
+	double ar[CMAT_MAXSIZE*CMAT_MAXSIZE], ai[CMAT_MAXSIZE*CMAT_MAXSIZE];
+	double br[CMAT_MAXSIZE*CMAT_MAXSIZE], bi[CMAT_MAXSIZE*CMAT_MAXSIZE];
+	double cr[CMAT_MAXSIZE*CMAT_MAXSIZE], ci[CMAT_MAXSIZE*CMAT_MAXSIZE];
+	int i, j, k, sq_size = size_val*size_val;
+
+	cmatn_split(a,ar,ai,sq_size);
+	cmatn_split(b,br,bi,sq_size);
+
+	//Row of c at a time, walking rows of b, so the inner loop is unit stride
+	for (i=0; i<size_val; i++)
+	{
+		double *rr = &cr[i*size_val], *ri = &ci[i*size_val];
+		for (j=0; j<size_val; j++)
+		{
+			rr[j] = 0.0;
+			ri[j] = 0.0;
+		}
+		for (k=0; k<size_val; k++)
+		{
+			double xr = ar[i*size_val+k], xi = ai[i*size_val+k];
+			const double *yr = &br[k*size_val], *yi = &bi[k*size_val];
+			for (j=0; j<size_val; j++)
+			{
+				rr[j] += CMUL_RE(xr,xi,yr[j],yi[j]);
+				ri[j] += CMUL_IM(xr,xi,yr[j],yi[j]);
+			}
+		}
+	}
+
+	cmatn_join(cr,ci,c,sq_size);
+}
+
+void cmatn_vmult(complex *a, complex *x, complex *y, int size_val)
+{
+	double ar[CMAT_MAXSIZE*CMAT_MAXSIZE], ai[CMAT_MAXSIZE*CMAT_MAXSIZE];
+	double xr[CMAT_MAXSIZE], xi[CMAT_MAXSIZE], yr[CMAT_MAXSIZE], yi[CMAT_MAXSIZE];
+	int i, k;
+
+	cmatn_split(a,ar,ai,size_val*size_val);
+	cmatn_split(x,xr,xi,size_val);
+
+	for (i=0; i<size_val; i++)
+	{
+		const double *rr = &ar[i*size_val], *ri = &ai[i*size_val];
+		double sr = 0.0, si = 0.0;
+		for (k=0; k<size_val; k++)
+		{
+			sr += CMUL_RE(rr[k],ri[k],xr[k],xi[k]);
+			si += CMUL_IM(rr[k],ri[k],xr[k],xi[k]);
+		}
+		yr[i] = sr;
+		yi[i] = si;
+	}
+
+	cmatn_join(yr,yi,y,size_val);
+}
+
+/** Inverse by LU decomposition without pivoting, the same steps as lu_decomp, forward_sub
+	and back_sub in link.cpp but on the stack **/
+void cmatn_lu_inverse(complex *in, complex *out, int size_val)
+{
+	double ar[CMAT_MAXSIZE*CMAT_MAXSIZE], ai[CMAT_MAXSIZE*CMAT_MAXSIZE];
+	double lr[CMAT_MAXSIZE*CMAT_MAXSIZE], li[CMAT_MAXSIZE*CMAT_MAXSIZE];
+	double ur[CMAT_MAXSIZE*CMAT_MAXSIZE], ui[CMAT_MAXSIZE*CMAT_MAXSIZE];
+	double vr[CMAT_MAXSIZE*CMAT_MAXSIZE], vi[CMAT_MAXSIZE*CMAT_MAXSIZE];
+	double br[CMAT_MAXSIZE], bi[CMAT_MAXSIZE], zr[CMAT_MAXSIZE], zi[CMAT_MAXSIZE];
+	double sr, si, dr, di, d, nr, ni;
+	int k, n, m, s, col;
+
+	cmatn_split(in,ar,ai,size_val*size_val);
+
+	//Decomposition - l holds the unit lower triangle, u the upper
+	for (k=0; k<size_val; k++)
+	{
+		for (m=k; m<size_val; m++)
+		{
+			if (k==0)
+			{
+				ur[m] = ar[m];
+				ui[m] = ai[m];
+			}
+			else
+			{
+				sr = 0.0; si = 0.0;
+				for (s=0; s<k; s++)
+				{
+					sr += CMUL_RE(lr[k*size_val+s],li[k*size_val+s],ur[s*size_val+m],ui[s*size_val+m]);
+					si += CMUL_IM(lr[k*size_val+s],li[k*size_val+s],ur[s*size_val+m],ui[s*size_val+m]);
+				}
+				ur[k*size_val+m] = ar[k*size_val+m] - sr;
+				ui[k*size_val+m] = ai[k*size_val+m] - si;
+			}
+		}
+		dr = ur[k*size_val+k];
+		di = ui[k*size_val+k];
+		d = dr*dr+di*di;
+		for (n=k+1; n<size_val; n++)
+		{
+			if (k==0)
+			{
+				nr = ar[n*size_val];
+				ni = ai[n*size_val];
+			}
+			else
+			{
+				sr = 0.0; si = 0.0;
+				for (s=0; s<k; s++)
+				{
+					sr += CMUL_RE(lr[n*size_val+s],li[n*size_val+s],ur[s*size_val+k],ui[s*size_val+k]);
+					si += CMUL_IM(lr[n*size_val+s],li[n*size_val+s],ur[s*size_val+k],ui[s*size_val+k]);
+				}
+				nr = ar[n*size_val+k] - sr;
+				ni = ai[n*size_val+k] - si;
+			}
+			lr[n*size_val+k] = (nr*dr+ni*di)/d;
+			li[n*size_val+k] = (ni*dr-nr*di)/d;
+		}
+	}
+
+	//One column of the inverse per unit vector
+	for (col=0; col<size_val; col++)
+	{
+		for (n=0; n<size_val; n++)
+		{
+			br[n] = (n==col) ? 1.0 : 0.0;
+			bi[n] = 0.0;
+		}
+
+		//Forward substitution
+		zr[0] = br[0];
+		zi[0] = bi[0];
+		for (n=1; n<size_val; n++)
+		{
+			for (m=0; m<n; m++)
+			{
+				br[n] = br[n] - CMUL_RE(lr[n*size_val+m],li[n*size_val+m],zr[m],zi[m]);
+				bi[n] = bi[n] - CMUL_IM(lr[n*size_val+m],li[n*size_val+m],zr[m],zi[m]);
+			}
+			zr[n] = br[n];
+			zi[n] = bi[n];
+		}
+
+		//Backward substitution, written straight into column col
+		for (n=size_val-1; n>-1; n--)
+		{
+			for (m=n+1; m<size_val; m++)
+			{
+				zr[n] = zr[n] - CMUL_RE(ur[n*size_val+m],ui[n*size_val+m],vr[m*size_val+col],vi[m*size_val+col]);
+				zi[n] = zi[n] - CMUL_IM(ur[n*size_val+m],ui[n*size_val+m],vr[m*size_val+col],vi[m*size_val+col]);
+			}
+			dr = ur[n*size_val+n];
+			di = ui[n*size_val+n];
+			d = dr*dr+di*di;
+			vr[n*size_val+col] = (zr[n]*dr+zi[n]*di)/d;
+			vi[n*size_val+col] = (zi[n]*dr-zr[n]*di)/d;
+		}
+	}
+
+	cmatn_join(vr,vi,out,size_val*size_val);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Self test and timing
+//////////////////////////////////////////////////////////////////////////
+
+#define CMAT_TESTCOUNT 4096		/**< inverses in each timing run */
+#define CMAT_TESTCHECKS 64		/**< random matrices of each size checked */
+
+//Reference forms, written with the complex class the way link.cpp had them
+static void ref_lmatrix_mult(complex *a, complex *b, complex *c, int size_val)
+{
+	int j, k, l;
+	for (j=0; j<size_val; j++)
+	{
+		for (k=0; k<size_val; k++)
+		{
+			c[j*size_val+k] = complex(0.0,0.0);
+			for (l=0; l<size_val; l++)
+				c[j*size_val+k] += a[j*size_val+l] * b[l*size_val+k];
+		}
+	}
+}
+
+static void ref_lmatrix_vmult(complex *a, complex *x, complex *y, int size_val)
+{
+	int j, k;
+	for (j=0; j<size_val; j++)
+	{
+		y[j] = complex(0.0,0.0);
+		for (k=0; k<size_val; k++)
+			y[j] += a[j*size_val+k] * x[k];
+	}
+}
+
+static void ref_lu_inverse(complex *a, complex *out, int size_val)
+{
+	complex l[CMAT_MAXSIZE*CMAT_MAXSIZE], u[CMAT_MAXSIZE*CMAT_MAXSIZE];
+	complex b[CMAT_MAXSIZE], z[CMAT_MAXSIZE], x[CMAT_MAXSIZE], sum;
+	int k, n, m, s, col;
+
+	for (k=0; k<size_val; k++)
+	{
+		l[k*size_val+k] = complex(1,0);
+		for (m=k; m<size_val; m++)
+		{
+			sum = complex(0,0);
+			for (s=0; s<k; s++)
+				sum += l[k*size_val+s]*u[s*size_val+m];
+			u[k*size_val+m] = (k==0) ? a[k*size_val+m] : a[k*size_val+m] - sum;
+		}
+		for (n=k+1; n<size_val; n++)
+		{
+			sum = complex(0,0);
+			for (s=0; s<k; s++)
+				sum += l[n*size_val+s]*u[s*size_val+k];
+			l[n*size_val+k] = ((k==0) ? a[n*size_val+k] : a[n*size_val+k] - sum)/u[k*size_val+k];
+		}
+	}
+	for (col=0; col<size_val; col++)
+	{
+		for (n=0; n<size_val; n++)
+			b[n] = complex((n==col) ? 1.0 : 0.0,0.0);
+		z[0] = b[0];
+		for (n=1; n<size_val; n++)
+		{
+			for (m=0; m<n; m++)
+				b[n] = b[n] - (l[n*size_val+m]*z[m]);
+			z[n] = b[n];
+		}
+		x[size_val-1] = z[size_val-1]/u[size_val*size_val-1];
+		for (n=size_val-2; n>-1; n--)
+		{
+			for (m=n+1; m<size_val; m++)
+				z[n] = z[n] - (u[n*size_val+m]*x[m]);
+			x[n] = z[n]/u[n*size_val+n];
+		}
+		for (n=0; n<size_val; n++)
+			out[n*size_val+col] = x[n];
+	}
+}
+
+//Fills a matrix with diagonally heavy values, like a line impedance
+static unsigned int cmat_seed = 12345;
+static double cmat_rand(void)
+{
+	cmat_seed = cmat_seed*1103515245 + 12345;
+	return ((cmat_seed>>8)&0xffff)/65536.0 - 0.5;
+}
+static void cmat_fill(complex *m, int size_val)
+{
+	int j, k;
+	for (j=0; j<size_val; j++)
+		for (k=0; k<size_val; k++)
+			m[j*size_val+k] = complex(cmat_rand() + (j==k ? 2.0 : 0.0), cmat_rand() + (j==k ? 1.0 : 0.0));
+}
+
+//Bitwise comparison, so a reordered operation shows up even when it rounds the same way
+static bool cmat_same(complex *a, complex *b, int n)
+{
+	int k;
+	for (k=0; k<n; k++)
+	{
+		if (memcmp(&a[k].Re(),&b[k].Re(),sizeof(double))!=0 || memcmp(&a[k].Im(),&b[k].Im(),sizeof(double))!=0)
+			return false;
+	}
+	return true;
+}
+
+static double cmat_seconds(clock_t t0)
+{
+	return (double)(clock()-t0)/CLOCKS_PER_SEC;
+}
+
+int cmatrix_test(void)
+{
+	complex big_a[CMAT_MAXSIZE*CMAT_MAXSIZE], big_b[CMAT_MAXSIZE*CMAT_MAXSIZE];
+	complex big_r[CMAT_MAXSIZE*CMAT_MAXSIZE], big_s[CMAT_MAXSIZE*CMAT_MAXSIZE];
+	unsigned int n;
+	int size_val, k, len, failed = 0;
+	char buffer[1024];
+	clock_t t0;
+	double t_ref, t_split;
+
+	//Agreement with the reference forms
+	for (size_val=1; size_val<=CMAT_MAXSIZE; size_val++)
+	{
+		for (n=0; n<CMAT_TESTCHECKS; n++)
+		{
+			cmat_fill(big_a,size_val);
+			cmat_fill(big_b,size_val);
+
+			ref_lmatrix_mult(big_a,big_b,big_r,size_val);
+			cmatn_multiply(big_a,big_b,big_s,size_val);
+			if (!cmat_same(big_r,big_s,size_val*size_val)) failed |= 1;
+
+			ref_lmatrix_vmult(big_a,big_b,big_r,size_val);
+			cmatn_vmult(big_a,big_b,big_s,size_val);
+			if (!cmat_same(big_r,big_s,size_val)) failed |= 2;
+
+			ref_lu_inverse(big_a,big_r,size_val);
+			cmatn_lu_inverse(big_a,big_s,size_val);
+			if (!cmat_same(big_r,big_s,size_val*size_val)) failed |= 4;
+
+			//Sums take the notation of the first operand
+			for (k=0; k<size_val*size_val; k++)
+				big_a[k].SetNotation(k%2 ? I : J);
+			for (k=0; k<size_val*size_val; k++)
+				big_r[k] = big_a[k] + big_b[k];
+			cmatn_add(big_a,big_b,big_s,size_val);
+			if (!cmat_same(big_r,big_s,size_val*size_val)) failed |= 8;
+			for (k=0; k<size_val*size_val; k++)
+			{
+				if (big_s[k].Notation() != big_a[k].Notation())
+					failed |= 8;
+			}
+		}
+	}
+	if (failed)
+		gl_error("cmatrix_test: kernels disagree with the reference routines (failure mask 0x%02x)", failed);
+	else
+		gl_output("cmatrix_test: all kernels match the reference routines bit for bit");
+
+	//Repeated formats are suppressed, so the LU timings go out as one message
+	len = 0;
+	for (size_val=2; size_val<=CMAT_MAXSIZE; size_val+=2)
+	{
+		cmat_fill(big_a,size_val);
+		t0 = clock();
+		for (n=0; n<CMAT_TESTCOUNT; n++)
+			ref_lu_inverse(big_a,big_r,size_val);
+		t_ref = cmat_seconds(t0);
+		t0 = clock();
+		for (n=0; n<CMAT_TESTCOUNT; n++)
+			cmatn_lu_inverse(big_a,big_s,size_val);
+		t_split = cmat_seconds(t0);
+		len += sprintf(buffer+len,"%s%dx%d complex %.3f s, split %.3f s", len>0?"; ":"", size_val, size_val, t_ref, t_split);
+	}
+	gl_output("cmatrix_test: %d LU inverses: %s", CMAT_TESTCOUNT, buffer);
+
+	return failed ? 0 : 1;
+}
@@ -0,0 +1,21 @@
+/* $Id
+ * Complex matrix kernels with split real/imaginary storage
+ */
+
+#ifndef _CMATRIX_H
+#define _CMATRIX_H
+
+#include "complex.h"
+
+#define CMAT_MAXSIZE 8		/**< largest square matrix the general kernels work on without allocating */
+
+//Square matrices of up to CMAT_MAXSIZE, row-major arrays of complex
+void cmatn_add(complex *a, complex *b, complex *c, int size_val);
+void cmatn_multiply(complex *a, complex *b, complex *c, int size_val);
+void cmatn_vmult(complex *a, complex *x, complex *y, int size_val);
+void cmatn_lu_inverse(complex *in, complex *out, int size_val);
+
+//Checks the kernels against the complex class reference and times them
+int cmatrix_test(void);
+
+#endif
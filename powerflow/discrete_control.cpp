@@ -0,0 +1,77 @@
+/* $Id
+ * Discrete control loop of the powerflow solution
+ *
+ * Regulators and capacitors normally move a tap or a switch by returning t0 from
+ * their passes, so every step costs a full exec iteration of the whole model.  With
+ * powerflow::discrete_control_loop set, the voltage-sensing devices register a control
+ * step here at init.  The SWING bus runs every registered step after it solves the
+ * system, and solves again until none of them move (or discrete_control_limit is hit),
+ * before the exec loop sees the result.
+ */
+
+#include <pthread.h>
+
+#include "powerflow.h"
+#include "discrete_control.h"
+
+/** Registered device **/
+typedef struct s_discrete_control {
+	OBJECT *obj;				/**< device object */
+	DISCRETECONTROLFXN step;	/**< control step of the device */
+} DISCRETECONTROL;
+
+static DISCRETECONTROL *control_list = NULL;
+static unsigned int control_count = 0;
+static unsigned int control_size = 0;
+static pthread_mutex_t control_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** Add a device to the discrete control loop - called once by the device's init **/
+void discrete_control_register(OBJECT *obj, DISCRETECONTROLFXN step)
+{
+	pthread_mutex_lock(&control_lock);
+	if (control_count == control_size)
+	{
+		unsigned int new_size = (control_size == 0) ? 16 : control_size*2;
+		DISCRETECONTROL *new_list = (DISCRETECONTROL *)realloc(control_list,new_size*sizeof(DISCRETECONTROL));
+		if (new_list == NULL)
+		{
+			pthread_mutex_unlock(&control_lock);
+			GL_THROW("Unable to allocate the discrete control list for %s",obj->name?obj->name:"Unknown");
+			/*  TROUBLESHOOT
+			While adding a regulator or capacitor to the discrete control loop of the powerflow solution, an attempt
+			to allocate memory failed.  Please try again.  If the error persists, please submit your code and a bug
+			report via the trac website.
+			*/
+		}
+		control_list = new_list;
+		control_size = new_size;
+	}
+	control_list[control_count].obj = obj;
+	control_list[control_count].step = step;
+	control_count++;
+	pthread_mutex_unlock(&control_lock);
+}
+
+/** Run the control step of every registered device on the current solution
+	@return true if any device changed its state
+ **/
+bool discrete_control_step(TIMESTAMP t0)
+{
+	bool changed = false;
+	unsigned int index;
+
+	//Every device decides from the same solution, so all of them get a turn before the next solve
+	for (index=0; index<control_count; index++)
+	{
+		if (control_list[index].step(control_list[index].obj,t0) == true)
+			changed = true;
+	}
+
+	return changed;
+}
+
+/** Number of registered devices **/
+unsigned int discrete_control_count(void)
+{
+	return control_count;
+}
@@ -0,0 +1,19 @@
+/* $Id
+ * Discrete control loop of the powerflow solution
+ */
+
+#ifndef _DISCRETE_CONTROL
+#define _DISCRETE_CONTROL
+
+#include "object.h"
+
+/** Control step of a discrete voltage control device (regulator taps, capacitor switches)
+	@return true if the device changed its state, so the system needs solving again
+ **/
+typedef bool (*DISCRETECONTROLFXN)(OBJECT *obj, TIMESTAMP t0);
+
+void discrete_control_register(OBJECT *obj, DISCRETECONTROLFXN step);
+bool discrete_control_step(TIMESTAMP t0);
+unsigned int discrete_control_count(void);
+
+#endif
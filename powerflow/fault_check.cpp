@@ -71,6 +71,15 @@ int fault_check::create(void)
 
 	associated_grid = NULL;	//Null the array
 
+	mesh_switch_list = NULL;		//Meshed support tracking not built yet
+	mesh_switch_mask = NULL;
+	mesh_switch_count = 0;
+	mesh_branch_count = 0;
+	mesh_work_stack = NULL;
+	mesh_swing_node = -1;
+	mesh_swing_phases = 0x00;
+	mesh_support_current = false;	//No solution to update yet
+
 	grid_association_mode = false;	//By default, we go to normal "Highlander" grid (there can be only one!)
 
 	return result;
@@ -566,29 +575,40 @@ void fault_check::support_check(int swing_node_int)
 //Mesh-capable version of support check -- by default, it doesn't support restoration object
 void fault_check::support_check_mesh(int swing_node_int)
 {
-	unsigned int indexa, indexb;
-
-	//Reset the node status list
-	reset_support_check();
+	unsigned int indexa;
 
-	if (grid_association_mode == false)	//Not needing to do grid association, use normal, inefficient method
+	if (grid_association_mode == false)	//Not needing to do grid association, single swing
 	{
+		//See if the last solution just needs the latest switching actions applied
+		if (update_support_mesh(swing_node_int) == true)
+		{
+			return;
+		}
+
+		//Reset the node status list
+		reset_support_check();
+
 		//Swing node has support - if the phase exists (changed for complete faults)
 		valid_phases[swing_node_int] = NR_busdata[swing_node_int].phases & 0x07;
 
-		//Call the node link-erator (node support check) - call it on the swing, the details are handled inside
-		//Supports possibly meshed topology - brute force method
-		for (indexa=0; indexa<NR_bus_count; indexa++)
-		{
-			for (indexb=0; indexb<NR_bus_count; indexb++)
-			{
-				//Call the search link on individual nodes
-				search_links_mesh(indexb);
-			}
-		}
+		//Record the switch states this solution goes with (allocates the work stack too)
+		snapshot_support_mesh(swing_node_int);
+
+		//Push support out from the swing - same answer as sweeping search_links_mesh over every
+		//node until nothing changes, but each node is only revisited when it gains a phase
+		mesh_work_stack[0] = swing_node_int;
+		propagate_support_mesh(1);
+
+		mesh_support_current = true;
 	}
 	else	//Grid association mode, do slightly different
 	{
+		//Reset the node status list
+		reset_support_check();
+
+		//Multiple sources -- not tracked incrementally
+		mesh_support_current = false;
+
 		//Traverse the whole bus list, just in case (since may be altered in the future)
 		for (indexa=0; indexa<NR_bus_count; indexa++)
 		{
@@ -611,6 +631,207 @@ void fault_check::support_check_mesh(int swing_node_int)
 	}
 }
 
+//Phases a link can carry in the meshed support check -- matches the test in search_links_mesh
+//Only switch-type devices change this by operating; the phases of other links are assumed to stay within
+//their original phases, so they always carry the original phases
+unsigned char fault_check::mesh_link_mask(int branch_idx)
+{
+	unsigned char temp_phases;
+
+	temp_phases = NR_branchdata[branch_idx].phases;
+
+	//Are we a switch
+	if ((NR_branchdata[branch_idx].lnk_type == 2) || (NR_branchdata[branch_idx].lnk_type == 5) || (NR_branchdata[branch_idx].lnk_type == 6))
+	{
+		if (*NR_branchdata[branch_idx].status == 1)
+		{
+			temp_phases |= NR_branchdata[branch_idx].origphases & 0x07;
+		}
+	}
+	else
+	{
+		temp_phases |= NR_branchdata[branch_idx].origphases & 0x07;
+	}
+
+	return (temp_phases & 0x07);
+}
+
+//Push support out from the nodes on the work stack until nothing new is supported
+//A node only goes back on the stack when it gains a phase, so the stack never holds more than 3 entries per node
+void fault_check::propagate_support_mesh(int stack_size)
+{
+	unsigned int index, device_value, node_value;
+	int node_int;
+	unsigned char temp_compare_phases;
+
+	while (stack_size > 0)
+	{
+		//Pull the next node
+		stack_size--;
+		node_int = mesh_work_stack[stack_size];
+
+		//Loop through our connected nodes
+		for (index=0; index<NR_busdata[node_int].Link_Table_Size; index++)
+		{
+			//Pull link index -- just for readabiiity
+			device_value = NR_busdata[node_int].Link_Table[index];
+
+			//Get our opposite end reference
+			if (node_int == NR_branchdata[device_value].from)
+			{
+				node_value = NR_branchdata[device_value].to;
+			}
+			else	//Must be the TO side, so check from
+			{
+				node_value = NR_branchdata[device_value].from;
+			}
+
+			//Check our "contributions" against the other end
+			temp_compare_phases = (valid_phases[node_value] | (valid_phases[node_int] & mesh_link_mask(device_value)));
+
+			//See if it gained anything -- if so, it has to pass that on too
+			if (valid_phases[node_value] != temp_compare_phases)
+			{
+				valid_phases[node_value] = temp_compare_phases;
+
+				mesh_work_stack[stack_size] = node_value;
+				stack_size++;
+			}
+		}
+	}
+}
+
+//Record the switch-type link states a meshed support solution is based on
+void fault_check::snapshot_support_mesh(int swing_node_int)
+{
+	unsigned int index;
+	int switch_count;
+
+	//Build the switch list the first time through (or if the branch list somehow changed)
+	if ((mesh_switch_list == NULL) || (mesh_branch_count != NR_branch_count))
+	{
+		if (mesh_switch_list != NULL)
+		{
+			gl_free(mesh_switch_list);
+			gl_free(mesh_switch_mask);
+			gl_free(mesh_work_stack);
+		}
+
+		//Count them first
+		switch_count = 0;
+		for (index=0; index<NR_branch_count; index++)
+		{
+			if ((NR_branchdata[index].lnk_type == 2) || (NR_branchdata[index].lnk_type == 5) || (NR_branchdata[index].lnk_type == 6))
+			{
+				switch_count++;
+			}
+		}
+
+		mesh_switch_list = (int *)gl_malloc((switch_count+1)*sizeof(int));
+		mesh_switch_mask = (unsigned char *)gl_malloc((switch_count+1)*sizeof(unsigned char));
+
+		//Each node gains a phase at most 3 times, plus both ends of every switch as seeds
+		mesh_work_stack = (int *)gl_malloc((3*NR_bus_count+2*switch_count+1)*sizeof(int));
+
+		//Check them
+		if ((mesh_switch_list == NULL) || (mesh_switch_mask == NULL) || (mesh_work_stack == NULL))
+		{
+			GL_THROW("fault_check: failed to allocate meshed support tracking arrays");
+			/*  TROUBLESHOOT
+			While attempting to allocate the arrays used to track switching devices for the meshed
+			support check, an error occurred.  Please try again.  If the error persists, please submit
+			your code and a bug report via the ticketing system.
+			*/
+		}
+
+		//Now populate
+		mesh_switch_count = 0;
+		for (index=0; index<NR_branch_count; index++)
+		{
+			if ((NR_branchdata[index].lnk_type == 2) || (NR_branchdata[index].lnk_type == 5) || (NR_branchdata[index].lnk_type == 6))
+			{
+				mesh_switch_list[mesh_switch_count] = index;
+				mesh_switch_count++;
+			}
+		}
+
+		mesh_branch_count = NR_branch_count;
+	}
+
+	//Store the current states
+	for (switch_count=0; switch_count<mesh_switch_count; switch_count++)
+	{
+		mesh_switch_mask[switch_count] = mesh_link_mask(mesh_switch_list[switch_count]);
+	}
+
+	mesh_swing_node = swing_node_int;
+	mesh_swing_phases = NR_busdata[swing_node_int].phases & 0x07;
+}
+
+//Apply switching changes since the last meshed support solution, without redoing the whole system
+//Closing a switch only adds support, so it just gets pushed out from the ends of that switch.
+//Opening a switch that carried a phase between two supported nodes may remove support,
+//which can't be undone locally -- return false and let the full check run
+bool fault_check::update_support_mesh(int swing_node_int)
+{
+	int index, branch_val, stack_size;
+	unsigned char new_mask, lost_phases;
+
+	//See if there's anything to update
+	if ((mesh_support_current == false) || (mesh_branch_count != NR_branch_count) || (swing_node_int != mesh_swing_node) || ((NR_busdata[swing_node_int].phases & 0x07) != mesh_swing_phases))
+	{
+		return false;
+	}
+
+	//Look for removals first - any of them forces the full check
+	for (index=0; index<mesh_switch_count; index++)
+	{
+		branch_val = mesh_switch_list[index];
+		new_mask = mesh_link_mask(branch_val);
+
+		//See if this switch stopped carrying anything
+		lost_phases = mesh_switch_mask[index] & ~new_mask;
+
+		//Only matters if it carried that phase into supported nodes -- in a solution, both ends match on any phase a link carries
+		if ((lost_phases & valid_phases[NR_branchdata[branch_val].from] & valid_phases[NR_branchdata[branch_val].to]) != 0x00)
+		{
+			mesh_support_current = false;
+			return false;
+		}
+	}
+
+	//Additions - seed from the ends of anything that picked up a phase
+	stack_size = 0;
+	for (index=0; index<mesh_switch_count; index++)
+	{
+		branch_val = mesh_switch_list[index];
+		new_mask = mesh_link_mask(branch_val);
+
+		if ((new_mask & ~mesh_switch_mask[index]) != 0x00)
+		{
+			if (valid_phases[NR_branchdata[branch_val].from] != 0x00)
+			{
+				mesh_work_stack[stack_size] = NR_branchdata[branch_val].from;
+				stack_size++;
+			}
+
+			if (valid_phases[NR_branchdata[branch_val].to] != 0x00)
+			{
+				mesh_work_stack[stack_size] = NR_branchdata[branch_val].to;
+				stack_size++;
+			}
+		}
+
+		//Update the stored state
+		mesh_switch_mask[index] = new_mask;
+	}
+
+	//Push out the new support
+	propagate_support_mesh(stack_size);
+
+	return true;
+}
+
 void fault_check::reset_support_check(void)
 {
 	unsigned int index;
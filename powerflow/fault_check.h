@@ -58,12 +58,26 @@ public:
 	void associate_grids(void);												//Function to look for the various swing nodes in the system, then associate the grids
 	void search_associated_grids(unsigned int node_int, int grid_counter);	//Function to perform the "grid association" and populate the array
 
+	unsigned char mesh_link_mask(int branch_idx);			//Function to get the phases a link can carry for the meshed support check
+	void propagate_support_mesh(int stack_size);			//Function to push support out from the nodes on the work stack
+	bool update_support_mesh(int swing_node_int);			//Function to update the last meshed support solution for switching changes
+	void snapshot_support_mesh(int swing_node_int);			//Function to record the switch states the meshed support solution is based on
+
 	TIMESTAMP sync(TIMESTAMP t0);
 
 private:
 	TIMESTAMP prev_time;	//Previous timestamp - mainly for intialization
 	FUNCTIONADDR restoration_fxn;	// Function address for restoration object reconfiguration call
 	int *associated_grid;	//Array for assignment of nodes to different "main connection" points
+
+	int *mesh_switch_list;				//Switch-type links (switch, sectionalizer, recloser) - the only links that alter meshed support
+	unsigned char *mesh_switch_mask;	//Phases each switch-type link carried at the last meshed support solution
+	int mesh_switch_count;				//Number of switch-type links
+	unsigned int mesh_branch_count;		//Branch count the switch list was built for
+	int *mesh_work_stack;				//Work stack for meshed support propagation
+	int mesh_swing_node;				//Swing node of the last meshed support solution
+	unsigned char mesh_swing_phases;	//Swing phases of the last meshed support solution
+	bool mesh_support_current;			//valid_phases holds a meshed support solution that can be updated incrementally
 };
 
 EXPORT int powerflow_alterations(OBJECT *thisobj, int baselink,bool rest_mode);
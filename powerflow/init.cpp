@@ -41,6 +41,7 @@
 #include "load_tracker.h"
 #include "triplex_load.h"
 #include "impedance_dump.h"
+#include "cmatrix.h"
 
 EXPORT CLASS *init(CALLBACKS *fntable, MODULE *module, int argc, char *argv[])
 {
@@ -82,6 +83,11 @@ EXPORT CLASS *init(CALLBACKS *fntable, MODULE *module, int argc, char *argv[])
 	gl_global_create("powerflow::NR_iteration_limit",PT_int64,&NR_iteration_limit,NULL);
 	gl_global_create("powerflow::NR_deltamode_iteration_limit",PT_int64,&NR_delta_iteration_limit,NULL);
 	gl_global_create("powerflow::NR_superLU_procs",PT_int32,&NR_superLU_procs,NULL);
+	gl_global_create("powerflow::NR_island_solver",PT_bool,&NR_island_solver,PT_DESCRIPTION,"Flag to solve electrically independent islands of the Newton-Raphson system separately and concurrently",NULL);
+	gl_global_create("powerflow::FBS_array_solver",PT_bool,&FBS_array_solver,PT_DESCRIPTION,"Flag to run the forward-back sweep over flattened arrays of the radial tree from the SWING bus, instead of across the object passes",NULL);
+	gl_global_create("powerflow::FBS_iteration_limit",PT_int64,&FBS_iteration_limit,PT_DESCRIPTION,"Sweeps the FBS array solver makes per pass before it gives up and lets another pass try",NULL);
+	gl_global_create("powerflow::discrete_control_loop",PT_bool,&discrete_control_loop,PT_DESCRIPTION,"Flag to re-solve the system inside the powerflow solution until voltage-sensing regulator taps and capacitor switches stop moving",NULL);
+	gl_global_create("powerflow::discrete_control_limit",PT_int64,&discrete_control_limit,PT_DESCRIPTION,"Re-solves the discrete control loop makes per pass before it leaves the remaining steps to further passes",NULL);
 	gl_global_create("powerflow::default_maximum_voltage_error",PT_double,&default_maximum_voltage_error,NULL);
 	gl_global_create("powerflow::default_maximum_power_error",PT_double,&default_maximum_power_error,NULL);
 	gl_global_create("powerflow::NR_admit_change",PT_bool,&NR_admit_change,NULL);
@@ -498,6 +504,12 @@ CDECL int do_kill()
 	return 0;
 }
 
+/** Module self test, run by "gridlabd --modtest powerflow" **/
+EXPORT void test(int argc, char *argv[])
+{
+	cmatrix_test();
+}
+
 typedef struct s_pflist {
 	OBJECT *ptr;
 	s_pflist *next;
@@ -193,6 +193,51 @@ void line::load_matrix_based_configuration(complex Zabc_mat[3][3], complex Yabc_
 	}
 }
 
+/** Look up the per-mile impedance computed for the same key by another line of this configuration
+	@return the cached entry, or NULL if no line has computed it yet
+ **/
+LINEIMPEDANCE *line::find_impedance(LINEIMPEDANCE *entry)
+{
+	line_configuration *config = OBJECTDATA(configuration, line_configuration);
+	LINEIMPEDANCE *item;
+
+	LOCK_OBJECT(configuration);
+	for (item=config->impedance_cache; item!=NULL; item=item->next)
+	{
+		if (item->key_size==entry->key_size && memcmp(item->key,entry->key,entry->key_size*sizeof(double))==0)
+			break;
+	}
+	UNLOCK_OBJECT(configuration);
+
+	return item;
+}
+
+/** Keep a newly computed per-mile impedance for the other lines of this configuration
+	@return the cached copy of the entry
+ **/
+LINEIMPEDANCE *line::add_impedance(LINEIMPEDANCE *entry)
+{
+	line_configuration *config = OBJECTDATA(configuration, line_configuration);
+	LINEIMPEDANCE *item = (LINEIMPEDANCE *)gl_malloc(sizeof(LINEIMPEDANCE));
+
+	if (item == NULL)
+	{
+		GL_THROW("Unable to allocate the impedance cache of line configuration %s",configuration->name?configuration->name:"Unknown");
+		/*  TROUBLESHOOT
+		While storing the per-mile impedance of a line configuration, an attempt to allocate memory failed.  Please
+		try again.  If the error persists, please submit your code and a bug report via the trac website.
+		*/
+	}
+	memcpy(item,entry,sizeof(LINEIMPEDANCE));
+
+	LOCK_OBJECT(configuration);
+	item->next = config->impedance_cache;
+	config->impedance_cache = item;
+	UNLOCK_OBJECT(configuration);
+
+	return item;
+}
+
 void line::recalc_line_matricies(complex Zabc_mat[3][3], complex Yabc_mat[3][3])
 {
 	complex U_mat[3][3], temp_mat[3][3];
@@ -19,6 +19,21 @@ extern bool show_matrix_values;
 
 #include "powerflow.h"
 #include "link.h"
+
+/** Per-mile series impedance and shunt admittance of one conductor set - computed once
+	per configuration, each line using it only scales by its own length **/
+#define LINE_IMPEDANCE_KEYSIZE 64
+typedef struct s_line_impedance {
+	unsigned int key_size;					///< number of values used in key
+	double key[LINE_IMPEDANCE_KEYSIZE];		///< line class, phases, frequency and the conductor/spacing values the entry came from
+	complex z[3][3];						///< series impedance per mile (or admittance per mile for NR triplex lines)
+	complex y[3][3];						///< shunt admittance per mile, before the frequency scaling
+	complex t[3];							///< triplex neutral current coefficients
+	bool shunt;								///< y holds valid shunt capacitance
+	unsigned char warning[4];				///< capacitance warning raised for each conductor (0 for none)
+	struct s_line_impedance *next;			///< next entry of the configuration
+} LINEIMPEDANCE;
+
 #include "line_spacing.h"
 #include "overhead_line_conductor.h"
 #include "underground_line_conductor.h"
@@ -43,6 +58,8 @@ public:
 protected:
 	void load_matrix_based_configuration(complex Zabc_mat[3][3], complex Yabc_mat[3][3]);
 	void recalc_line_matricies(complex Zabc_mat[3][3], complex Yabc_mat[3][3]);
+	LINEIMPEDANCE *find_impedance(LINEIMPEDANCE *entry);
+	LINEIMPEDANCE *add_impedance(LINEIMPEDANCE *entry);
 };
 
 #include "triplex_line.h"
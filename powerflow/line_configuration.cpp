@@ -78,6 +78,7 @@ int line_configuration::create(void)
 	capacitance11 = capacitance12 = capacitance13 = capacitance21 = capacitance22 = capacitance23 = capacitance31 = capacitance32 = capacitance33 = 0.0;
 	summer.continuous = winter.continuous = 1000;
 	summer.emergency = winter.emergency = 2000;
+	impedance_cache = NULL;
 	return 1;
 }
 
@@ -36,6 +36,7 @@ public:
 	double  capacitance32;
 	double  capacitance33;
 	LINERATINGS winter, summer;
+	LINEIMPEDANCE *impedance_cache;	///< per-mile results of the lines using this configuration
 	
 	line_configuration(MODULE *mod);
 	inline line_configuration(CLASS *cl=oclass):powerflow_library(cl){};
@@ -93,6 +93,7 @@
 #include <math.h>
 #include "link.h"
 #include "node.h"
+#include "cmatrix.h"
 
 CLASS* link_object::oclass = NULL;
 CLASS* link_object::pclass = NULL;
@@ -202,6 +203,7 @@ int link_object::create(void)
 	SpecialLnk = NORMAL;
 	prev_LTime=0;
 	NR_branch_reference=-1;
+	FBS_branch_reference=-1;
 	If_in[0] = If_in[1] = If_in[2] = complex(0,0);
 	If_out[0] = If_out[1] = If_out[2] = complex(0,0);
 
@@ -2655,7 +2657,7 @@ TIMESTAMP link_object::sync(TIMESTAMP t0)
 
 	if (is_closed())
 	{
-		if (solver_method==SM_FBS)
+		if ((solver_method==SM_FBS) && (FBS_branch_reference==-1))	//Array-swept links get their current from the solver
 		{
 			node *f;
 			node *t;
@@ -3019,7 +3021,7 @@ TIMESTAMP link_object::postsync(TIMESTAMP t0)
 		else
 			read_I_out[2] = tc[2];
 		
-		if (!is_open())
+		if (!is_open() && (FBS_branch_reference==-1))	//Array-swept links had their voltages set by the solver
 		{
 			/* compute and update voltages */
 			complex v0 = 
@@ -13230,7 +13232,6 @@ void link_object::fault_current_calc(complex C[7][7],unsigned int removed_phase,
 void link_object::lmatrix_add(complex *matrix_in_A, complex *matrix_in_B, complex *matrix_out, int matsize)
 {
 	//Variables
-	int jindex, kindex;
 	OBJECT *obj = OBJECTHDR(this);
 
 	//Initial check - make sure nothing NULL has been passed
@@ -13250,14 +13251,7 @@ void link_object::lmatrix_add(complex *matrix_in_A, complex *matrix_in_B, comple
 		*/
 	}
 
-	//Loop and do the add - simple
-	for (jindex=0; jindex<matsize; jindex++)
-	{
-		for (kindex=0; kindex<matsize; kindex++)
-		{
-			matrix_out[jindex*matsize+kindex] = matrix_in_A[jindex*matsize+kindex] + matrix_in_B[jindex*matsize+kindex];
-		}
-	}
+	cmatn_add(matrix_in_A,matrix_in_B,matrix_out,matsize);
 }
 
 //Performs a general matrix multiplication for square matrices of size "size"
@@ -13286,6 +13280,13 @@ void link_object::lmatrix_mult(complex *matrix_in_A, complex *matrix_in_B, compl
 		*/
 	}
 
+	//Small ones go to the split real/imaginary kernel
+	if (matsize<=CMAT_MAXSIZE)
+	{
+		cmatn_multiply(matrix_in_A,matrix_in_B,matrix_out,matsize);
+		return;
+	}
+
 	//Perform the matrix mulitplication
 	for (jindex=0; jindex<matsize; jindex++)
 	{
@@ -13325,6 +13326,13 @@ void link_object::lmatrix_vmult(complex *matrix_in, complex *vector_in, complex
 		//Define elsewhere
 	}
 
+	//Small ones go to the split real/imaginary kernel
+	if (matsize<=CMAT_MAXSIZE)
+	{
+		cmatn_vmult(matrix_in,vector_in,vector_out,matsize);
+		return;
+	}
+
 	//Perform the matrix mulitplication
 	for (jindex=0; jindex<matsize; jindex++)
 	{
@@ -13483,6 +13491,13 @@ void lu_matrix_inverse(complex *input_mat, complex *output_mat, int size_val)
 	complex *l_mat, *u_mat, *b_vec, *z_vec, *x_vec;
 	int sq_size,loop_val_x, loop_val_y;
 
+	//Everything the links use fits on the stack of the split real/imaginary kernel
+	if (size_val<=CMAT_MAXSIZE)
+	{
+		cmatn_lu_inverse(input_mat,output_mat,size_val);
+		return;
+	}
+
 	//Get overall size (save a multiply, save something)
 	sq_size = size_val*size_val;
 
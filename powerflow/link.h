@@ -54,6 +54,7 @@ public: /// @todo make this private and create interfaces to control values
 	complex *YSto;			// YSto - Pointer to 3x3 matrix representing admittance seen from "to" side (transformers)
 	double voltage_ratio;	// voltage ratio (normally 1.0)
 	int NR_branch_reference;	//Index of NR_branchdata this link is contained in
+	int FBS_branch_reference;	//Index of the FBS array solver branch this link is swept as (-1 when it sweeps itself)
 	SPECIAL_LINK SpecialLnk;	//Flag for exceptions to the normal handling
 	set flow_direction;		// Flag direction of powerflow: 1 is normal, -1 is reverse flow, 0 is no flow
 	void calculate_power();
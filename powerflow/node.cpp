@@ -243,6 +243,7 @@ int node::create(void)
 	NR_child_nodes = NULL;
 
 	NR_node_reference = -1;	//Newton-Raphson bus index, set to -1 initially
+	FBS_bus_reference = -1;	//FBS array solver bus index, set to -1 initially
 	house_present = false;	//House attachment flag
 	nom_res_curr[0] = nom_res_curr[1] = nom_res_curr[2] = 0.0;	//Nominal house current variables
 
@@ -2194,230 +2195,219 @@ void node::NR_node_sync_fxn(OBJECT *obj)
 	}//end not uninitialized
 }
 
-TIMESTAMP node::sync(TIMESTAMP t0)
+//Functionalized sync pass routine for the FBS solver - adds this node's load currents to current_inj
+//Put in place so the FBS array solver can call it on every sweep
+void node::FBS_node_sync_fxn(OBJECT *obj)
 {
-	TIMESTAMP t1 = powerflow_object::sync(t0);
-	OBJECT *obj = OBJECTHDR(this);
 	complex delta_current[3];
 	complex power_current[3];
 	complex delta_shunt[3];
 	complex delta_shunt_curr[3];
 	complex dy_curr_accum[3];
-	
-	//Generic time keeping variable - used for phase checks (GS does this explicitly below)
-	if (t0!=prev_NTime)
-	{
-		//Update time tracking variable
-		prev_NTime=t0;
-	}
 
-	switch (solver_method)
-	{
-	case SM_FBS:
-		{
-		if (phases&PHASE_S)
-		{	// Split phase
-			complex temp_inj[2];
-			complex adjusted_curr[3];
-			complex temp_curr_val[3];
-
-			if (house_present)
-			{
-				//Update phase adjustments
-				adjusted_curr[0].SetPolar(1.0,voltage[0].Arg());	//Pull phase of V1
-				adjusted_curr[1].SetPolar(1.0,voltage[1].Arg());	//Pull phase of V2
-				adjusted_curr[2].SetPolar(1.0,voltaged[0].Arg());	//Pull phase of V12
+	if (phases&PHASE_S)
+	{	// Split phase
+		complex temp_inj[2];
+		complex adjusted_curr[3];
+		complex temp_curr_val[3];
 
-				//Update these current contributions
-				temp_curr_val[0] = nom_res_curr[0]/(~adjusted_curr[0]);		//Just denominator conjugated to keep math right (rest was conjugated in house)
-				temp_curr_val[1] = nom_res_curr[1]/(~adjusted_curr[1]);
-				temp_curr_val[2] = nom_res_curr[2]/(~adjusted_curr[2]);
-			}
-			else
-			{
-				temp_curr_val[0] = temp_curr_val[1] = temp_curr_val[2] = 0.0;	//No house present, just zero em
-			}
+		if (house_present)
+		{
+			//Update phase adjustments
+			adjusted_curr[0].SetPolar(1.0,voltage[0].Arg());	//Pull phase of V1
+			adjusted_curr[1].SetPolar(1.0,voltage[1].Arg());	//Pull phase of V2
+			adjusted_curr[2].SetPolar(1.0,voltaged[0].Arg());	//Pull phase of V12
+
+			//Update these current contributions
+			temp_curr_val[0] = nom_res_curr[0]/(~adjusted_curr[0]);		//Just denominator conjugated to keep math right (rest was conjugated in house)
+			temp_curr_val[1] = nom_res_curr[1]/(~adjusted_curr[1]);
+			temp_curr_val[2] = nom_res_curr[2]/(~adjusted_curr[2]);
+		}
+		else
+		{
+			temp_curr_val[0] = temp_curr_val[1] = temp_curr_val[2] = 0.0;	//No house present, just zero em
+		}
 
 #ifdef SUPPORT_OUTAGES
-			if (voltage[0]!=0.0)
-			{
+		if (voltage[0]!=0.0)
+		{
 #endif
-			complex d1 = (voltage1.IsZero() || (power1.IsZero() && shunt1.IsZero())) ? (current1 + temp_curr_val[0]) : (current1 + ~(power1/voltage1) + voltage1*shunt1 + temp_curr_val[0]);
-			complex d2 = ((voltage1+voltage2).IsZero() || (power12.IsZero() && shunt12.IsZero())) ? (current12 + temp_curr_val[2]) : (current12 + ~(power12/(voltage1+voltage2)) + (voltage1+voltage2)*shunt12 + temp_curr_val[2]);
-			
-			current_inj[0] += d1;
-			temp_inj[0] = current_inj[0];
-			current_inj[0] += d2;
+		complex d1 = (voltage1.IsZero() || (power1.IsZero() && shunt1.IsZero())) ? (current1 + temp_curr_val[0]) : (current1 + ~(power1/voltage1) + voltage1*shunt1 + temp_curr_val[0]);
+		complex d2 = ((voltage1+voltage2).IsZero() || (power12.IsZero() && shunt12.IsZero())) ? (current12 + temp_curr_val[2]) : (current12 + ~(power12/(voltage1+voltage2)) + (voltage1+voltage2)*shunt12 + temp_curr_val[2]);
+		
+		current_inj[0] += d1;
+		temp_inj[0] = current_inj[0];
+		current_inj[0] += d2;
 
 #ifdef SUPPORT_OUTAGES
-			}
-			else
-			{
-				temp_inj[0] = 0.0;
-				//WRITELOCK_OBJECT(obj);
-				current_inj[0]=0.0;
-				//UNLOCK_OBJECT(obj);
-			}
+		}
+		else
+		{
+			temp_inj[0] = 0.0;
+			//WRITELOCK_OBJECT(obj);
+			current_inj[0]=0.0;
+			//UNLOCK_OBJECT(obj);
+		}
 
-			if (voltage[1]!=0)
-			{
+		if (voltage[1]!=0)
+		{
 #endif
-			d1 = (voltage2.IsZero() || (power2.IsZero() && shunt2.IsZero())) ? (-current2 - temp_curr_val[1]) : (-current2 - ~(power2/voltage2) - voltage2*shunt2 - temp_curr_val[1]);
-			d2 = ((voltage1+voltage2).IsZero() || (power12.IsZero() && shunt12.IsZero())) ? (-current12 - temp_curr_val[2]) : (-current12 - ~(power12/(voltage1+voltage2)) - (voltage1+voltage2)*shunt12 - temp_curr_val[2]);
+		d1 = (voltage2.IsZero() || (power2.IsZero() && shunt2.IsZero())) ? (-current2 - temp_curr_val[1]) : (-current2 - ~(power2/voltage2) - voltage2*shunt2 - temp_curr_val[1]);
+		d2 = ((voltage1+voltage2).IsZero() || (power12.IsZero() && shunt12.IsZero())) ? (-current12 - temp_curr_val[2]) : (-current12 - ~(power12/(voltage1+voltage2)) - (voltage1+voltage2)*shunt12 - temp_curr_val[2]);
 
-			current_inj[1] += d1;
-			temp_inj[1] = current_inj[1];
-			current_inj[1] += d2;
-			
+		current_inj[1] += d1;
+		temp_inj[1] = current_inj[1];
+		current_inj[1] += d2;
+		
 #ifdef SUPPORT_OUTAGES
-			}
-			else
-			{
-				temp_inj[0] = 0.0;
-				//WRITELOCK_OBJECT(obj);
-				current_inj[1] = 0.0;
-				//UNLOCK_OBJECT(obj);
-			}
+		}
+		else
+		{
+			temp_inj[0] = 0.0;
+			//WRITELOCK_OBJECT(obj);
+			current_inj[1] = 0.0;
+			//UNLOCK_OBJECT(obj);
+		}
 #endif
 
-			if (obj->parent!=NULL && gl_object_isa(obj->parent,"triplex_line","powerflow")) {
-				link_object *plink = OBJECTDATA(obj->parent,link_object);
-				complex d = plink->tn[0]*current_inj[0] + plink->tn[1]*current_inj[1];
-				current_inj[2] += d;
-			}
-			else {
-				complex d = ((voltage1.IsZero() || (power1.IsZero() && shunt1.IsZero())) ||
-								   (voltage2.IsZero() || (power2.IsZero() && shunt2.IsZero()))) 
-									? currentN : -(temp_inj[0] + temp_inj[1]);
-				current_inj[2] += d;
-			}
+		if (obj->parent!=NULL && gl_object_isa(obj->parent,"triplex_line","powerflow")) {
+			link_object *plink = OBJECTDATA(obj->parent,link_object);
+			complex d = plink->tn[0]*current_inj[0] + plink->tn[1]*current_inj[1];
+			current_inj[2] += d;
 		}
-		else if (has_phase(PHASE_D)) 
-		{   // 'Delta' connected load
-			
-			//Convert delta connected power to appropriate line current
-			delta_current[0]= (voltageAB.IsZero()) ? 0 : ~(powerA/voltageAB);
-			delta_current[1]= (voltageBC.IsZero()) ? 0 : ~(powerB/voltageBC);
-			delta_current[2]= (voltageCA.IsZero()) ? 0 : ~(powerC/voltageCA);
+		else {
+			complex d = ((voltage1.IsZero() || (power1.IsZero() && shunt1.IsZero())) ||
+							   (voltage2.IsZero() || (power2.IsZero() && shunt2.IsZero()))) 
+								? currentN : -(temp_inj[0] + temp_inj[1]);
+			current_inj[2] += d;
+		}
+	}
+	else if (has_phase(PHASE_D)) 
+	{   // 'Delta' connected load
+		
+		//Convert delta connected power to appropriate line current
+		delta_current[0]= (voltageAB.IsZero()) ? 0 : ~(powerA/voltageAB);
+		delta_current[1]= (voltageBC.IsZero()) ? 0 : ~(powerB/voltageBC);
+		delta_current[2]= (voltageCA.IsZero()) ? 0 : ~(powerC/voltageCA);
 
-			power_current[0]=delta_current[0]-delta_current[2];
-			power_current[1]=delta_current[1]-delta_current[0];
-			power_current[2]=delta_current[2]-delta_current[1];
+		power_current[0]=delta_current[0]-delta_current[2];
+		power_current[1]=delta_current[1]-delta_current[0];
+		power_current[2]=delta_current[2]-delta_current[1];
 
-			//Convert delta connected load to appropriate line current
-			delta_shunt[0] = voltageAB*shuntA;
-			delta_shunt[1] = voltageBC*shuntB;
-			delta_shunt[2] = voltageCA*shuntC;
+		//Convert delta connected load to appropriate line current
+		delta_shunt[0] = voltageAB*shuntA;
+		delta_shunt[1] = voltageBC*shuntB;
+		delta_shunt[2] = voltageCA*shuntC;
 
-			delta_shunt_curr[0] = delta_shunt[0]-delta_shunt[2];
-			delta_shunt_curr[1] = delta_shunt[1]-delta_shunt[0];
-			delta_shunt_curr[2] = delta_shunt[2]-delta_shunt[1];
+		delta_shunt_curr[0] = delta_shunt[0]-delta_shunt[2];
+		delta_shunt_curr[1] = delta_shunt[1]-delta_shunt[0];
+		delta_shunt_curr[2] = delta_shunt[2]-delta_shunt[1];
 
-			//Convert delta-current into a phase current - reuse temp variable
-			delta_current[0]=current[0]-current[2];
-			delta_current[1]=current[1]-current[0];
-			delta_current[2]=current[2]-current[1];
+		//Convert delta-current into a phase current - reuse temp variable
+		delta_current[0]=current[0]-current[2];
+		delta_current[1]=current[1]-current[0];
+		delta_current[2]=current[2]-current[1];
 
 #ifdef SUPPORT_OUTAGES
-			for (char kphase=0;kphase<3;kphase++)
+		for (char kphase=0;kphase<3;kphase++)
+		{
+			if (voltaged[kphase]==0.0)
 			{
-				if (voltaged[kphase]==0.0)
-				{
-					//WRITELOCK_OBJECT(obj);
-					current_inj[kphase] = 0.0;
-					//UNLOCK_OBJECT(obj);
-				}
-				else
-				{
-					//WRITELOCK_OBJECT(obj);
-					current_inj[kphase] += delta_current[kphase] + power_current[kphase] + delta_shunt_curr[kphase];
-					//UNLOCK_OBJECT(obj);
-				}
+				//WRITELOCK_OBJECT(obj);
+				current_inj[kphase] = 0.0;
+				//UNLOCK_OBJECT(obj);
 			}
+			else
+			{
+				//WRITELOCK_OBJECT(obj);
+				current_inj[kphase] += delta_current[kphase] + power_current[kphase] + delta_shunt_curr[kphase];
+				//UNLOCK_OBJECT(obj);
+			}
+		}
 #else
-			complex d[] = {
-				delta_current[0] + power_current[0] + delta_shunt_curr[0],
-				delta_current[1] + power_current[1] + delta_shunt_curr[1],
-				delta_current[2] + power_current[2] + delta_shunt_curr[2]};
-			current_inj[0] += d[0];
-			current_inj[1] += d[1];
-			current_inj[2] += d[2];
+		complex d[] = {
+			delta_current[0] + power_current[0] + delta_shunt_curr[0],
+			delta_current[1] + power_current[1] + delta_shunt_curr[1],
+			delta_current[2] + power_current[2] + delta_shunt_curr[2]};
+		current_inj[0] += d[0];
+		current_inj[1] += d[1];
+		current_inj[2] += d[2];
 #endif
-		}
-		else 
-		{	// 'WYE' connected load
+	}
+	else 
+	{	// 'WYE' connected load
 
 #ifdef SUPPORT_OUTAGES
-			for (char kphase=0;kphase<3;kphase++)
+		for (char kphase=0;kphase<3;kphase++)
+		{
+			if (voltage[kphase]==0.0)
 			{
-				if (voltage[kphase]==0.0)
-				{
-					//WRITELOCK_OBJECT(obj);
-					current_inj[kphase] = 0.0;
-					//UNLOCK_OBJECT(obj);
-				}
-				else
-				{
-					complex d = ((voltage[kphase]==0.0) || ((power[kphase] == 0) && shunt[kphase].IsZero())) ? current[kphase] : current[kphase] + ~(power[kphase]/voltage[kphase]) + voltage[kphase]*shunt[kphase];
-					//WRITELOCK_OBJECT(obj);
-					current_inj[kphase] += d;
-					//UNLOCK_OBJECT(obj);
-				}
+				//WRITELOCK_OBJECT(obj);
+				current_inj[kphase] = 0.0;
+				//UNLOCK_OBJECT(obj);
+			}
+			else
+			{
+				complex d = ((voltage[kphase]==0.0) || ((power[kphase] == 0) && shunt[kphase].IsZero())) ? current[kphase] : current[kphase] + ~(power[kphase]/voltage[kphase]) + voltage[kphase]*shunt[kphase];
+				//WRITELOCK_OBJECT(obj);
+				current_inj[kphase] += d;
+				//UNLOCK_OBJECT(obj);
 			}
+		}
 #else
-			complex d[] = {
-				(voltageA.IsZero() || (powerA.IsZero() && shuntA.IsZero())) ? currentA : currentA + ~(powerA/voltageA) + voltageA*shuntA,
-				(voltageB.IsZero() || (powerB.IsZero() && shuntB.IsZero())) ? currentB : currentB + ~(powerB/voltageB) + voltageB*shuntB,
-				(voltageC.IsZero() || (powerC.IsZero() && shuntC.IsZero())) ? currentC : currentC + ~(powerC/voltageC) + voltageC*shuntC,
-			};
-			current_inj[0] += d[0];
-			current_inj[1] += d[1];
-			current_inj[2] += d[2];
+		complex d[] = {
+			(voltageA.IsZero() || (powerA.IsZero() && shuntA.IsZero())) ? currentA : currentA + ~(powerA/voltageA) + voltageA*shuntA,
+			(voltageB.IsZero() || (powerB.IsZero() && shuntB.IsZero())) ? currentB : currentB + ~(powerB/voltageB) + voltageB*shuntB,
+			(voltageC.IsZero() || (powerC.IsZero() && shuntC.IsZero())) ? currentC : currentC + ~(powerC/voltageC) + voltageC*shuntC,
+		};
+		current_inj[0] += d[0];
+		current_inj[1] += d[1];
+		current_inj[2] += d[2];
 #endif
-		}
+	}
 
-		//Handle explicit delta-wye connections now -- no triplex
-		if (!(has_phase(PHASE_S)))
-		{
-			//Convert delta connected power to appropriate line current
-			delta_current[0]= (voltageAB.IsZero()) ? 0 : ~(power_dy[0]/voltageAB);
-			delta_current[1]= (voltageBC.IsZero()) ? 0 : ~(power_dy[1]/voltageBC);
-			delta_current[2]= (voltageCA.IsZero()) ? 0 : ~(power_dy[2]/voltageCA);
-
-			power_current[0]=delta_current[0]-delta_current[2];
-			power_current[1]=delta_current[1]-delta_current[0];
-			power_current[2]=delta_current[2]-delta_current[1];
-
-			//Convert delta connected load to appropriate line current
-			delta_shunt[0] = voltageAB*shunt_dy[0];
-			delta_shunt[1] = voltageBC*shunt_dy[1];
-			delta_shunt[2] = voltageCA*shunt_dy[2];
-
-			delta_shunt_curr[0] = delta_shunt[0]-delta_shunt[2];
-			delta_shunt_curr[1] = delta_shunt[1]-delta_shunt[0];
-			delta_shunt_curr[2] = delta_shunt[2]-delta_shunt[1];
-
-			//Convert delta-current into a phase current - reuse temp variable
-			delta_current[0]=current_dy[0]-current_dy[2];
-			delta_current[1]=current_dy[1]-current_dy[0];
-			delta_current[2]=current_dy[2]-current_dy[1];
-
-			//Accumulate
-			dy_curr_accum[0] = delta_current[0] + power_current[0] + delta_shunt_curr[0];
-			dy_curr_accum[1] = delta_current[1] + power_current[1] + delta_shunt_curr[1];
-			dy_curr_accum[2] = delta_current[2] + power_current[2] + delta_shunt_curr[2];
-
-			//Wye-connected portions
-			dy_curr_accum[0] += (voltageA.IsZero() || (power_dy[3].IsZero() && shunt_dy[3].IsZero())) ? current_dy[3] : current_dy[3] + ~(power_dy[3]/voltageA) + voltageA*shunt_dy[3];
-			dy_curr_accum[1] += (voltageB.IsZero() || (power_dy[4].IsZero() && shunt_dy[4].IsZero())) ? current_dy[4] : current_dy[4] + ~(power_dy[4]/voltageB) + voltageB*shunt_dy[4];
-			dy_curr_accum[2] += (voltageC.IsZero() || (power_dy[5].IsZero() && shunt_dy[5].IsZero())) ? current_dy[5] : current_dy[5] + ~(power_dy[5]/voltageC) + voltageC*shunt_dy[5];
-				
-			//Accumulate in to final portion
-			current_inj[0] += dy_curr_accum[0];
-			current_inj[1] += dy_curr_accum[1];
-			current_inj[2] += dy_curr_accum[2];
+	//Handle explicit delta-wye connections now -- no triplex
+	if (!(has_phase(PHASE_S)))
+	{
+		//Convert delta connected power to appropriate line current
+		delta_current[0]= (voltageAB.IsZero()) ? 0 : ~(power_dy[0]/voltageAB);
+		delta_current[1]= (voltageBC.IsZero()) ? 0 : ~(power_dy[1]/voltageBC);
+		delta_current[2]= (voltageCA.IsZero()) ? 0 : ~(power_dy[2]/voltageCA);
+
+		power_current[0]=delta_current[0]-delta_current[2];
+		power_current[1]=delta_current[1]-delta_current[0];
+		power_current[2]=delta_current[2]-delta_current[1];
+
+		//Convert delta connected load to appropriate line current
+		delta_shunt[0] = voltageAB*shunt_dy[0];
+		delta_shunt[1] = voltageBC*shunt_dy[1];
+		delta_shunt[2] = voltageCA*shunt_dy[2];
+
+		delta_shunt_curr[0] = delta_shunt[0]-delta_shunt[2];
+		delta_shunt_curr[1] = delta_shunt[1]-delta_shunt[0];
+		delta_shunt_curr[2] = delta_shunt[2]-delta_shunt[1];
+
+		//Convert delta-current into a phase current - reuse temp variable
+		delta_current[0]=current_dy[0]-current_dy[2];
+		delta_current[1]=current_dy[1]-current_dy[0];
+		delta_current[2]=current_dy[2]-current_dy[1];
+
+		//Accumulate
+		dy_curr_accum[0] = delta_current[0] + power_current[0] + delta_shunt_curr[0];
+		dy_curr_accum[1] = delta_current[1] + power_current[1] + delta_shunt_curr[1];
+		dy_curr_accum[2] = delta_current[2] + power_current[2] + delta_shunt_curr[2];
+
+		//Wye-connected portions
+		dy_curr_accum[0] += (voltageA.IsZero() || (power_dy[3].IsZero() && shunt_dy[3].IsZero())) ? current_dy[3] : current_dy[3] + ~(power_dy[3]/voltageA) + voltageA*shunt_dy[3];
+		dy_curr_accum[1] += (voltageB.IsZero() || (power_dy[4].IsZero() && shunt_dy[4].IsZero())) ? current_dy[4] : current_dy[4] + ~(power_dy[4]/voltageB) + voltageB*shunt_dy[4];
+		dy_curr_accum[2] += (voltageC.IsZero() || (power_dy[5].IsZero() && shunt_dy[5].IsZero())) ? current_dy[5] : current_dy[5] + ~(power_dy[5]/voltageC) + voltageC*shunt_dy[5];
+			
+		//Accumulate in to final portion
+		current_inj[0] += dy_curr_accum[0];
+		current_inj[1] += dy_curr_accum[1];
+		current_inj[2] += dy_curr_accum[2];
 
-		}//End delta/wye explicit
+	}//End delta/wye explicit
 
 #ifdef SUPPORT_OUTAGES
 	if (is_open_any())
@@ -2444,6 +2434,71 @@ TIMESTAMP node::sync(TIMESTAMP t0)
 			voltageC /= 2;
 	}
 #endif
+}
+
+TIMESTAMP node::sync(TIMESTAMP t0)
+{
+	TIMESTAMP t1 = powerflow_object::sync(t0);
+	OBJECT *obj = OBJECTHDR(this);
+	
+	//Generic time keeping variable - used for phase checks (GS does this explicitly below)
+	if (t0!=prev_NTime)
+	{
+		//Update time tracking variable
+		prev_NTime=t0;
+	}
+
+	switch (solver_method)
+	{
+	case SM_FBS:
+		{
+		//The SWING bus sweeps the whole tree with the array solver, once everything below it has synced
+		if ((FBS_array_solver == true) && (bustype == SWING))
+		{
+			int64 result = solver_fbs(obj);
+
+			//Settle the discrete controls on this solution, sweeping again until their taps stop moving
+			if ((discrete_control_loop == true) && (result > 0))
+			{
+				int64 control_pass;
+
+				for (control_pass=0; control_pass<discrete_control_limit; control_pass++)
+				{
+					if (discrete_control_step(t0) == false)
+						break;
+
+					result = solver_fbs(obj);
+					if (result < 0)
+						break;
+				}
+
+				if (control_pass == discrete_control_limit)
+				{
+					gl_verbose("Discrete controls did not settle in %lld FBS array solutions, leaving the rest to the next iteration.",discrete_control_limit);
+					/*  TROUBLESHOOT
+					The regulators were still moving taps after discrete_control_limit solutions of the discrete control loop.
+					Their postsync checks will request another pass to carry on (if the global iteration limit has not been reached).
+					*/
+				}
+			}
+
+			if (result < 0)	//Failure to converge, but we just let it stay where we are for now
+			{
+				gl_verbose("FBS array solver failed to converge, sticking at same iteration.");
+				/*  TROUBLESHOOT
+				The forward-back sweep array solver did not converge in the number of sweeps specified in FBS_iteration_limit.
+				The voltage change will request another pass, so it will try again (if the global iteration limit has not been reached).
+				*/
+			}
+
+			if (result != 0)	//Tree was swept by the array solver
+				break;
+		}
+		else if (FBS_bus_reference != -1)	//Swept by the array solver from the SWING bus
+			break;
+
+		//Add our load currents
+		FBS_node_sync_fxn(obj);
 
 		// if the parent object is another node
 		if (obj->parent!=NULL && gl_object_isa(obj->parent,"node","powerflow"))
@@ -2500,6 +2555,30 @@ TIMESTAMP node::sync(TIMESTAMP t0)
 
 				int64 result = solver_nr(NR_bus_count, NR_busdata, NR_branch_count, NR_branchdata, &NR_powerflow, powerflow_type, NULL, &bad_computation);
 
+				//Settle the discrete controls on this solution, re-solving until their taps and switches stop moving
+				if ((discrete_control_loop == true) && (powerflow_type == PF_NORMAL))
+				{
+					int64 control_pass;
+
+					for (control_pass=0; (control_pass<discrete_control_limit) && (bad_computation==false) && (result>=0); control_pass++)
+					{
+						if (discrete_control_step(t0) == false)
+							break;
+
+						NR_admit_change = true;	//Regulator taps are in the admittance matrix
+						result = solver_nr(NR_bus_count, NR_busdata, NR_branch_count, NR_branchdata, &NR_powerflow, powerflow_type, NULL, &bad_computation);
+					}
+
+					if (control_pass == discrete_control_limit)
+					{
+						gl_verbose("Discrete controls did not settle in %lld Newton-Raphson solutions, leaving the rest to the next iteration.",discrete_control_limit);
+						/*  TROUBLESHOOT
+						The regulators and capacitors were still moving after discrete_control_limit solutions of the discrete control loop.
+						Their postsync checks will request another pass to carry on (if the global iteration limit has not been reached).
+						*/
+					}
+				}
+
 				//De-flag the change - no contention should occur
 				NR_admit_change = false;
 
@@ -3268,6 +3347,23 @@ int node::NR_populate(void)
 	return 0;
 }
 
+/**
+* FBS_populate is called by the FBS array solver when it flattens the tree.  It points
+* the solver's bus entry at the voltages and current injection the sweeps update.
+*
+*/
+void node::FBS_populate(FBSBUS *bus_data, int index)
+{
+	bus_data->pNode = this;
+	bus_data->obj = OBJECTHDR(this);
+	bus_data->V = voltage;
+	bus_data->Vd = voltaged;
+	bus_data->I = current_inj;
+	bus_data->split = has_phase(PHASE_S);
+
+	FBS_bus_reference = index;
+}
+
 //Computes "load" portions of current injection
 //postpass is set to true for the "postsync" power update - it does extra child node items needed
 //parentcall is set when a parent object has called this update - mainly for locking purposes
@@ -209,6 +209,7 @@ public:
 	double mean_repair_time;	/// Node's mean repair time - mainly for swing at this point
 
 	int NR_node_reference;		/// Node's reference in NR_busdata
+	int FBS_bus_reference;		/// Node's index in the FBS array solver (-1 when it is swept by its own sync)
 	int *NR_subnode_reference;	/// Pointer to parent node's reference in NR_busdata - just in case things get inited out of synch
 	unsigned char prev_phases;	/// Phase tracking variable for use in reliability calls
 
@@ -231,6 +232,7 @@ public:
 	//Functionalized portions for deltamode calls -- allows updates
 	TIMESTAMP NR_node_presync_fxn(TIMESTAMP t0_val);
 	void NR_node_sync_fxn(OBJECT *obj);
+	void FBS_node_sync_fxn(OBJECT *obj);
 	void BOTH_node_postsync_fxn(OBJECT *obj);
 	OBJECT *NR_master_swing_search(char *node_type_value,bool main_swing);
 
@@ -243,6 +245,7 @@ public:
 	bool current_accumulated;
 
 	int NR_populate(void);
+	void FBS_populate(FBSBUS *bus_data, int index);
 	OBJECT *SubNodeParent;	/// Child node's original parent or child of parent
 	int NR_current_update(bool postpass, bool parentcall);
 	object TopologicalParent;	/// Child node's original parent as per the topological configuration in the GLM file
@@ -248,78 +248,39 @@ void overhead_line::recalc(void)
 	}
 	else
 	{
-		// Use Kersting's equations to define the z-matrix
-		double dab, dbc, dac, dan, dbn, dcn;
-		double gmr_a, gmr_b, gmr_c, gmr_n, res_a, res_b, res_c, res_n;
-		complex z_aa, z_ab, z_ac, z_an, z_bb, z_bc, z_bn, z_cc, z_cn, z_nn;
-		double p_aa, p_ab, p_ac, p_an, p_bb, p_bc, p_bn, p_cc, p_cn, p_nn;
-		double daap, dabp, dacp, danp, dbbp, dbcp, dbnp, dccp, dcnp, dnnp, diamA, diamB, diamC, diamN;
-		complex P_mat[3][3];
-		bool valid_capacitance = false;	//Assume capacitance is invalid by default
-		double freq_coeff_real, freq_coeff_imag, freq_additive_term;
-		line_spacing *spacing_val = NULL;
+		LINEIMPEDANCE imp, *per_mile;
 		double miles = length / 5280.0;
-		double cap_coeff;
 		complex cap_freq_mult;
-		
-		//Calculate coefficients for self and mutual impedance - incorporates frequency values
-		//Per Kersting (4.39) and (4.40)
-		if (enable_frequency_dependence == true)	//See if we may be updating due to frequency changes
+
+		//Lines with the same configuration, phasing and frequency share the per-mile Kersting values - only the first one computes them
+		impedance_key(config, &imp);
+		per_mile = find_impedance(&imp);
+		if (per_mile == NULL)
 		{
-			freq_coeff_real = 0.00158836*current_frequency;
-			freq_coeff_imag = 0.00202237*current_frequency;
-			freq_additive_term = log(EARTH_RESISTIVITY/current_frequency)/2.0 + 7.6786;
+			calc_impedance(config, &imp);
+			per_mile = add_impedance(&imp);
 		}
-		else
+
+		for (int k = 0; k < 4; k++)
 		{
-			freq_coeff_real = 0.00158836*nominal_frequency;
-			freq_coeff_imag = 0.00202237*nominal_frequency;
-			freq_additive_term = log(EARTH_RESISTIVITY/nominal_frequency)/2.0 + 7.6786;
+			if (per_mile->warning[k] != 0)
+			{
+				gl_warning("Shunt capacitance of overhead line:%s not calculated - invalid values",obj->name);
+				/*  TROUBLESHOOT
+				While attempting to calculate the shunt capacitance for an overhead line, an invalid parameter was encountered.
+				To calculate shunt capacitance, ensure the condutor to earth distance for each phase is defined, as well as the
+				diameter of that phases's cable.
+				*/
+			}
 		}
 
-		#define GMR(ph) (has_phase(PHASE_##ph) && config->phase##ph##_conductor ? \
-			OBJECTDATA(config->phase##ph##_conductor, overhead_line_conductor)->geometric_mean_radius : 0.0)
-		#define RES(ph) (has_phase(PHASE_##ph) && config->phase##ph##_conductor ? \
-			OBJECTDATA(config->phase##ph##_conductor, overhead_line_conductor)->resistance : 0.0)
-		#define DIST(ph1, ph2) (has_phase(PHASE_##ph1) && has_phase(PHASE_##ph2) && config->line_spacing ? \
-			OBJECTDATA(config->line_spacing, line_spacing)->distance_##ph1##to##ph2 : 0.0)
-		#define DIAM(ph) (has_phase(PHASE_##ph) && config->phase##ph##_conductor ? \
-			OBJECTDATA(config->phase##ph##_conductor, overhead_line_conductor)->cable_diameter : 0.0)
-
-		gmr_a = GMR(A);
-		gmr_b = GMR(B);
-		gmr_c = GMR(C);
-		gmr_n = GMR(N);
-		//res_a = (status==IMPEDANCE_CHANGED && (affected_phases&PHASE_A)) ? resistance/miles : RES(A);
-		//res_b = (status==IMPEDANCE_CHANGED && (affected_phases&PHASE_A)) ? resistance/miles : RES(B);
-		//res_c = (status==IMPEDANCE_CHANGED && (affected_phases&PHASE_A)) ? resistance/miles : RES(C);
-		//res_n = (status==IMPEDANCE_CHANGED && (affected_phases&PHASE_A)) ? resistance/miles : RES(N);
-		res_a = RES(A);
-		res_b = RES(B);
-		res_c = RES(C);
-		res_n = RES(N);
-		dab = DIST(A, B);
-		dbc = DIST(B, C);
-		dac = DIST(A, C);
-		dan = DIST(A, N);
-		dbn = DIST(B, N);
-		dcn = DIST(C, N);
-
-		diamA = DIAM(A);
-		diamB = DIAM(B);
-		diamC = DIAM(C);
-		diamN = DIAM(N);
-
-		#undef GMR
-		#undef RES
-		#undef DIST
-		#undef DIAM
+		//Update impedance
+		multiply(miles, per_mile->z, Zabc_mat);
 
-		if (use_line_cap == true)
+		// If we have valid capacitance values and line capacitance is turned on then
+		// calculate Yabc_mat otherwise just leave is zeroed out.
+		if (per_mile->shunt == true)
 		{
-			//If capacitance calculations desired, compute overall coefficient
-			cap_coeff = 1.0/(PERMITIVITTY_AIR*2.0*PI);
-
 			//Set capacitor frequency/distance/scaling factor (rad/s*S)
 			if (enable_frequency_dependence == true)	//See which frequency to use
 			{
@@ -330,485 +291,592 @@ void overhead_line::recalc(void)
 				cap_freq_mult = complex(0,(2.0*PI*nominal_frequency*0.000001*miles));
 			}
 
-			//Extract line spacing (nned for capacitance)
-			spacing_val = OBJECTDATA(config->line_spacing, line_spacing);
+			//Scale for frequency, distance, and microSiemens as per Kersting (5.15)
+			for (int i = 0; i < 3; i++)
+			{
+				for (int j = 0; j < 3; j++)
+				{
+					Yabc_mat[i][j] = per_mile->y[i][j] * cap_freq_mult;
+				}
+			}
 
-			//Make sure it worked
-			if (spacing_val == NULL)
+			//Other auxilliary by phase
+			if (has_phase(PHASE_A))
 			{
-				GL_THROW("Line spacing not found, capacitance calculations failed!");
-				/*  TROUBLESHOOT
-				The line spacing values could not be properly mapped.  Capacitance values
-				can not be calculated for this line (and other values may be in error).  Please
-				specific a proper line spacing and try again.
-				*/
+				a_mat[0][0] = 1.0;
+				d_mat[0][0] = 1.0;
+				A_mat[0][0] = 1.0;
+			}
+
+			if (has_phase(PHASE_B))
+			{
+				a_mat[1][1] = 1.0;
+				d_mat[1][1] = 1.0;
+				A_mat[1][1] = 1.0;
+			}
+
+			if (has_phase(PHASE_C))
+			{
+				a_mat[2][2] = 1.0;
+				d_mat[2][2] = 1.0;
+				A_mat[2][2] = 1.0;
 			}
+		}
+	}
 
-			//Start with the assumption the capacitance is valid for appropriate phases
-			valid_capacitance = true;
+	// Calculate line matrixies A_mat, B_mat, a_mat, b_mat, c_mat and d_mat based on Zabc_mat and Yabc_mat
+	recalc_line_matricies(Zabc_mat, Yabc_mat);
+	
+	//Check for negative resistance in the line's impedance matrix
+	bool neg_res = false;
+	for (int n = 0; n < 3; n++){
+		for (int m = 0; m < 3; m++){
+			if(b_mat[n][m].Re() < 0.0){
+				neg_res = true;
+			}
 		}
-		//Defaulted else - not really needed, since if not use_line_cap, these values are irrelevant
+	}
+	
+	if(neg_res == true){
+		gl_warning("INIT: overhead_line:%s has a negative resistance in it's impedance matrix. This will result in unusual behavior. Please check the line's geometry and cable parameters.", obj->name);
+		/*  TROUBLESHOOT
+		A negative resistance value was found for one or more the real parts of the overhead_line's impedance matrix.
+		While this is numerically possible, it is a physical impossibility. This resulted most likely from a improperly 
+		defined conductor cable. Please check and modify the conductor objects used for this line to correct this issue.
+		*/
+	}
 
-		if (has_phase(PHASE_A)) {
-			if (gmr_a > 0.0 && res_a > 0.0)
-				z_aa = complex(res_a + freq_coeff_real, freq_coeff_imag * (log(1.0 / gmr_a) + freq_additive_term));
-			else
-				z_aa = 0.0;
-			if (has_phase(PHASE_B) && dab > 0.0)
-				z_ab = complex(freq_coeff_real, freq_coeff_imag * (log(1.0 / dab) + freq_additive_term));
-			else
-				z_ab = 0.0;
-			if (has_phase(PHASE_C) && dac > 0.0)
-				z_ac = complex(freq_coeff_real, freq_coeff_imag * (log(1.0 / dac) + freq_additive_term));
-			else
-				z_ac = 0.0;
-			if (has_phase(PHASE_N) && dan > 0.0)
-				z_an = complex(freq_coeff_real, freq_coeff_imag * (log(1.0 / dan) + freq_additive_term));
-			else
-				z_an = 0.0;
+#ifdef _TESTING
+	if (show_matrix_values)
+	{
+		OBJECT *obj = GETOBJECT(this);
 
-			//capacitance equations
-			if (use_line_cap == true)
+		gl_testmsg("overhead_line: %s a matrix",obj->name);
+		print_matrix(a_mat);
+
+		gl_testmsg("overhead_line: %s A matrix",obj->name);
+		print_matrix(A_mat);
+
+		gl_testmsg("overhead_line: %s b matrix",obj->name);
+		print_matrix(b_mat);
+
+		gl_testmsg("overhead_line: %s B matrix",obj->name);
+		print_matrix(B_mat);
+
+		gl_testmsg("overhead_line: %s c matrix",obj->name);
+		print_matrix(c_mat);
+
+		gl_testmsg("overhead_line: %s d matrix",obj->name);
+		print_matrix(d_mat);
+	}
+#endif
+}
+
+/** Key of the per-mile impedance of this line - every value calc_impedance() reads
+	from the configuration, so lines only share an entry when their results would match
+ **/
+void overhead_line::impedance_key(line_configuration *config, LINEIMPEDANCE *imp)
+{
+	unsigned int n = 0;
+
+	memset(imp,0,sizeof(LINEIMPEDANCE));
+
+	#define KEY(x) (imp->key[n++] = (double)(x))
+	#define OHC(ph, name) (has_phase(PHASE_##ph) && config->phase##ph##_conductor ? \
+		OBJECTDATA(config->phase##ph##_conductor, overhead_line_conductor)->name : 0.0)
+	#define DIST(ph1, ph2) (has_phase(PHASE_##ph1) && has_phase(PHASE_##ph2) && config->line_spacing ? \
+		OBJECTDATA(config->line_spacing, line_spacing)->distance_##ph1##to##ph2 : 0.0)
+	#define TOE(ph) (has_phase(PHASE_##ph) && config->line_spacing ? \
+		OBJECTDATA(config->line_spacing, line_spacing)->distance_##ph##toE : 0.0)
+
+	KEY(1);	//overhead_line
+	KEY(phases);
+	KEY(enable_frequency_dependence == true ? current_frequency : nominal_frequency);
+	KEY(use_line_cap);
+	KEY(OHC(A, geometric_mean_radius));
+	KEY(OHC(B, geometric_mean_radius));
+	KEY(OHC(C, geometric_mean_radius));
+	KEY(OHC(N, geometric_mean_radius));
+	KEY(OHC(A, resistance));
+	KEY(OHC(B, resistance));
+	KEY(OHC(C, resistance));
+	KEY(OHC(N, resistance));
+	KEY(OHC(A, cable_diameter));
+	KEY(OHC(B, cable_diameter));
+	KEY(OHC(C, cable_diameter));
+	KEY(OHC(N, cable_diameter));
+	KEY(DIST(A, B));
+	KEY(DIST(B, C));
+	KEY(DIST(A, C));
+	KEY(DIST(A, N));
+	KEY(DIST(B, N));
+	KEY(DIST(C, N));
+	KEY(TOE(A));
+	KEY(TOE(B));
+	KEY(TOE(C));
+	KEY(TOE(N));
+
+	#undef KEY
+	#undef OHC
+	#undef DIST
+	#undef TOE
+
+	imp->key_size = n;
+}
+
+/** Per-mile impedance and shunt admittance of this line's configuration, using Kersting's equations **/
+void overhead_line::calc_impedance(line_configuration *config, LINEIMPEDANCE *imp)
+{
+	double dab, dbc, dac, dan, dbn, dcn;
+	double gmr_a, gmr_b, gmr_c, gmr_n, res_a, res_b, res_c, res_n;
+	complex z_aa, z_ab, z_ac, z_an, z_bb, z_bc, z_bn, z_cc, z_cn, z_nn;
+	double p_aa, p_ab, p_ac, p_an, p_bb, p_bc, p_bn, p_cc, p_cn, p_nn;
+	double daap, dabp, dacp, danp, dbbp, dbcp, dbnp, dccp, dcnp, dnnp, diamA, diamB, diamC, diamN;
+	complex P_mat[3][3];
+	bool valid_capacitance = false;	//Assume capacitance is invalid by default
+	double freq_coeff_real, freq_coeff_imag, freq_additive_term;
+	line_spacing *spacing_val = NULL;
+	double cap_coeff;
+	
+	//Calculate coefficients for self and mutual impedance - incorporates frequency values
+	//Per Kersting (4.39) and (4.40)
+	if (enable_frequency_dependence == true)	//See if we may be updating due to frequency changes
+	{
+		freq_coeff_real = 0.00158836*current_frequency;
+		freq_coeff_imag = 0.00202237*current_frequency;
+		freq_additive_term = log(EARTH_RESISTIVITY/current_frequency)/2.0 + 7.6786;
+	}
+	else
+	{
+		freq_coeff_real = 0.00158836*nominal_frequency;
+		freq_coeff_imag = 0.00202237*nominal_frequency;
+		freq_additive_term = log(EARTH_RESISTIVITY/nominal_frequency)/2.0 + 7.6786;
+	}
+
+	#define GMR(ph) (has_phase(PHASE_##ph) && config->phase##ph##_conductor ? \
+		OBJECTDATA(config->phase##ph##_conductor, overhead_line_conductor)->geometric_mean_radius : 0.0)
+	#define RES(ph) (has_phase(PHASE_##ph) && config->phase##ph##_conductor ? \
+		OBJECTDATA(config->phase##ph##_conductor, overhead_line_conductor)->resistance : 0.0)
+	#define DIST(ph1, ph2) (has_phase(PHASE_##ph1) && has_phase(PHASE_##ph2) && config->line_spacing ? \
+		OBJECTDATA(config->line_spacing, line_spacing)->distance_##ph1##to##ph2 : 0.0)
+	#define DIAM(ph) (has_phase(PHASE_##ph) && config->phase##ph##_conductor ? \
+		OBJECTDATA(config->phase##ph##_conductor, overhead_line_conductor)->cable_diameter : 0.0)
+
+	gmr_a = GMR(A);
+	gmr_b = GMR(B);
+	gmr_c = GMR(C);
+	gmr_n = GMR(N);
+	//res_a = (status==IMPEDANCE_CHANGED && (affected_phases&PHASE_A)) ? resistance/miles : RES(A);
+	//res_b = (status==IMPEDANCE_CHANGED && (affected_phases&PHASE_A)) ? resistance/miles : RES(B);
+	//res_c = (status==IMPEDANCE_CHANGED && (affected_phases&PHASE_A)) ? resistance/miles : RES(C);
+	//res_n = (status==IMPEDANCE_CHANGED && (affected_phases&PHASE_A)) ? resistance/miles : RES(N);
+	res_a = RES(A);
+	res_b = RES(B);
+	res_c = RES(C);
+	res_n = RES(N);
+	dab = DIST(A, B);
+	dbc = DIST(B, C);
+	dac = DIST(A, C);
+	dan = DIST(A, N);
+	dbn = DIST(B, N);
+	dcn = DIST(C, N);
+
+	diamA = DIAM(A);
+	diamB = DIAM(B);
+	diamC = DIAM(C);
+	diamN = DIAM(N);
+
+	#undef GMR
+	#undef RES
+	#undef DIST
+	#undef DIAM
+
+	if (use_line_cap == true)
+	{
+		//If capacitance calculations desired, compute overall coefficient
+		cap_coeff = 1.0/(PERMITIVITTY_AIR*2.0*PI);
+
+		//Extract line spacing (nned for capacitance)
+		spacing_val = OBJECTDATA(config->line_spacing, line_spacing);
+
+		//Make sure it worked
+		if (spacing_val == NULL)
+		{
+			GL_THROW("Line spacing not found, capacitance calculations failed!");
+			/*  TROUBLESHOOT
+			The line spacing values could not be properly mapped.  Capacitance values
+			can not be calculated for this line (and other values may be in error).  Please
+			specific a proper line spacing and try again.
+			*/
+		}
+
+		//Start with the assumption the capacitance is valid for appropriate phases
+		valid_capacitance = true;
+	}
+	//Defaulted else - not really needed, since if not use_line_cap, these values are irrelevant
+
+	if (has_phase(PHASE_A)) {
+		if (gmr_a > 0.0 && res_a > 0.0)
+			z_aa = complex(res_a + freq_coeff_real, freq_coeff_imag * (log(1.0 / gmr_a) + freq_additive_term));
+		else
+			z_aa = 0.0;
+		if (has_phase(PHASE_B) && dab > 0.0)
+			z_ab = complex(freq_coeff_real, freq_coeff_imag * (log(1.0 / dab) + freq_additive_term));
+		else
+			z_ab = 0.0;
+		if (has_phase(PHASE_C) && dac > 0.0)
+			z_ac = complex(freq_coeff_real, freq_coeff_imag * (log(1.0 / dac) + freq_additive_term));
+		else
+			z_ac = 0.0;
+		if (has_phase(PHASE_N) && dan > 0.0)
+			z_an = complex(freq_coeff_real, freq_coeff_imag * (log(1.0 / dan) + freq_additive_term));
+		else
+			z_an = 0.0;
+
+		//capacitance equations
+		if (use_line_cap == true)
+		{
+			if ((diamA > 0.0) && (spacing_val->distance_AtoE > 0.0))
 			{
-				if ((diamA > 0.0) && (spacing_val->distance_AtoE > 0.0))
+				//Define values - self image
+				daap = 2.0 * spacing_val->distance_AtoE;
+				p_aa = cap_coeff * log(daap/diamA*24.0);
+
+				//Get distances to relevant images
+				if (has_phase(PHASE_B))
 				{
-					//Define values - self image
-					daap = 2.0 * spacing_val->distance_AtoE;
-					p_aa = cap_coeff * log(daap/diamA*24.0);
+					//Calc distance
+					dabp = calc_image_dist(spacing_val->distance_AtoE,spacing_val->distance_BtoE,spacing_val->distance_AtoB);
 
-					//Get distances to relevant images
-					if (has_phase(PHASE_B))
+					//calculate the contribution
+					if (spacing_val->distance_AtoB != 0)
 					{
-						//Calc distance
-						dabp = calc_image_dist(spacing_val->distance_AtoE,spacing_val->distance_BtoE,spacing_val->distance_AtoB);
-
-						//calculate the contribution
-						if (spacing_val->distance_AtoB != 0)
-						{
-							p_ab = cap_coeff * log(dabp/(spacing_val->distance_AtoB));
-						}
-						else
-						{
-							p_ab = 0.0;
-						}
+						p_ab = cap_coeff * log(dabp/(spacing_val->distance_AtoB));
 					}
 					else
 					{
 						p_ab = 0.0;
 					}
+				}
+				else
+				{
+					p_ab = 0.0;
+				}
+
+				if (has_phase(PHASE_C))
+				{
+					//Calculate distance
+					dacp = calc_image_dist(spacing_val->distance_AtoE,spacing_val->distance_CtoE,spacing_val->distance_AtoC);
 
-					if (has_phase(PHASE_C))
+					//calculate the contribution
+					if (spacing_val->distance_AtoC != 0)
 					{
-						//Calculate distance
-						dacp = calc_image_dist(spacing_val->distance_AtoE,spacing_val->distance_CtoE,spacing_val->distance_AtoC);
-
-						//calculate the contribution
-						if (spacing_val->distance_AtoC != 0)
-						{
-							p_ac = cap_coeff * log(dacp/(spacing_val->distance_AtoC));
-						}
-						else
-						{
-							p_ac = 0.0;
-						}
+						p_ac = cap_coeff * log(dacp/(spacing_val->distance_AtoC));
 					}
 					else
 					{
 						p_ac = 0.0;
 					}
+				}
+				else
+				{
+					p_ac = 0.0;
+				}
 
-					if (has_phase(PHASE_N))
+				if (has_phase(PHASE_N))
+				{
+					//Calculate the distance
+					danp = calc_image_dist(spacing_val->distance_AtoE,spacing_val->distance_NtoE,spacing_val->distance_AtoN);
+
+					//calculate the contribution
+					if (spacing_val->distance_AtoN != 0)
 					{
-						//Calculate the distance
-						danp = calc_image_dist(spacing_val->distance_AtoE,spacing_val->distance_NtoE,spacing_val->distance_AtoN);
-
-						//calculate the contribution
-						if (spacing_val->distance_AtoN != 0)
-						{
-							p_an = cap_coeff * log(danp/(spacing_val->distance_AtoN));
-						}
-						else
-						{
-							p_an = 0.0;
-						}
+						p_an = cap_coeff * log(danp/(spacing_val->distance_AtoN));
 					}
 					else
 					{
 						p_an = 0.0;
 					}
 				}
-				else	//If diamA is 0, nothing is valid, make all zero
+				else
 				{
-					valid_capacitance = false;	//Failed one line of it, so don't include capacitance anywhere
-					
-					gl_warning("Shunt capacitance of overhead line:%s not calculated - invalid values",OBJECTHDR(this)->name);
-					/*  TROUBLESHOOT
-					While attempting to calculate the shunt capacitance for an overhead line, an invalid parameter was encountered.
-					To calculate shunt capacitance, ensure the condutor to earth distance for each phase is defined, as well as the
-					diameter of that phases's cable.
-					*/
-
-					p_aa = p_ab = p_ac = p_an = 0.0;
+					p_an = 0.0;
 				}
 			}
-			//Defaulted else - not desired, so don't set anything
-		} else {
-			p_aa = p_ab = p_ac = p_an = 0.0;
-			z_aa = z_ab = z_ac = z_an = 0.0;
+			else	//If diamA is 0, nothing is valid, make all zero
+			{
+				valid_capacitance = false;	//Failed one line of it, so don't include capacitance anywhere
+				
+				imp->warning[0] = 1;
+
+				p_aa = p_ab = p_ac = p_an = 0.0;
+			}
 		}
+		//Defaulted else - not desired, so don't set anything
+	} else {
+		p_aa = p_ab = p_ac = p_an = 0.0;
+		z_aa = z_ab = z_ac = z_an = 0.0;
+	}
 
-		if (has_phase(PHASE_B)) {
-			if (gmr_b > 0.0 && res_b > 0.0)
-				z_bb = complex(res_b + freq_coeff_real, freq_coeff_imag * (log(1.0 / gmr_b) + freq_additive_term));
-			else
-				z_bb = 0.0;
-			if (has_phase(PHASE_C) && dbc > 0.0)
-				z_bc = complex(freq_coeff_real, freq_coeff_imag * (log(1.0 / dbc) + freq_additive_term));
-			else
-				z_bc = 0.0;
-			if (has_phase(PHASE_N) && dbn > 0.0)
-				z_bn = complex(freq_coeff_real, freq_coeff_imag * (log(1.0 / dbn) + freq_additive_term));
-			else
-				z_bn = 0.0;
+	if (has_phase(PHASE_B)) {
+		if (gmr_b > 0.0 && res_b > 0.0)
+			z_bb = complex(res_b + freq_coeff_real, freq_coeff_imag * (log(1.0 / gmr_b) + freq_additive_term));
+		else
+			z_bb = 0.0;
+		if (has_phase(PHASE_C) && dbc > 0.0)
+			z_bc = complex(freq_coeff_real, freq_coeff_imag * (log(1.0 / dbc) + freq_additive_term));
+		else
+			z_bc = 0.0;
+		if (has_phase(PHASE_N) && dbn > 0.0)
+			z_bn = complex(freq_coeff_real, freq_coeff_imag * (log(1.0 / dbn) + freq_additive_term));
+		else
+			z_bn = 0.0;
 
-			//capacitance equations
-			if (use_line_cap == true)
+		//capacitance equations
+		if (use_line_cap == true)
+		{
+			if ((diamB > 0.0) && (spacing_val->distance_BtoE > 0.0))
 			{
-				if ((diamB > 0.0) && (spacing_val->distance_BtoE > 0.0))
+				//Define values - self image
+				dbbp = 2.0 * spacing_val->distance_BtoE;
+				p_bb = cap_coeff * log(dbbp/diamB*24.0);
+
+				//Get distances to relevant images - assuming weren't done above
+				if (has_phase(PHASE_C))
 				{
-					//Define values - self image
-					dbbp = 2.0 * spacing_val->distance_BtoE;
-					p_bb = cap_coeff * log(dbbp/diamB*24.0);
+					//Calculate distance
+					dbcp = calc_image_dist(spacing_val->distance_BtoE,spacing_val->distance_CtoE,spacing_val->distance_BtoC);
 
-					//Get distances to relevant images - assuming weren't done above
-					if (has_phase(PHASE_C))
+					//calculate the contribution
+					if (spacing_val->distance_BtoC != 0)
 					{
-						//Calculate distance
-						dbcp = calc_image_dist(spacing_val->distance_BtoE,spacing_val->distance_CtoE,spacing_val->distance_BtoC);
-
-						//calculate the contribution
-						if (spacing_val->distance_BtoC != 0)
-						{
-							p_bc = cap_coeff * log(dbcp/(spacing_val->distance_BtoC));
-						}
-						else
-						{
-							p_bc = 0.0;
-						}
+						p_bc = cap_coeff * log(dbcp/(spacing_val->distance_BtoC));
 					}
 					else
 					{
 						p_bc = 0.0;
 					}
+				}
+				else
+				{
+					p_bc = 0.0;
+				}
 
-					if (has_phase(PHASE_N))
-					{
-						//Calculate distance
-						dbnp = calc_image_dist(spacing_val->distance_BtoE,spacing_val->distance_NtoE,spacing_val->distance_BtoN);
-
-						//calculate the contribution
-						if (spacing_val->distance_BtoN != 0)
-						{
-							p_bn = cap_coeff * log(dbnp/(spacing_val->distance_BtoN));
-						}
-						else
-						{
-							p_bn = 0.0;
-						}
+				if (has_phase(PHASE_N))
+				{
+					//Calculate distance
+					dbnp = calc_image_dist(spacing_val->distance_BtoE,spacing_val->distance_NtoE,spacing_val->distance_BtoN);
 
+					//calculate the contribution
+					if (spacing_val->distance_BtoN != 0)
+					{
+						p_bn = cap_coeff * log(dbnp/(spacing_val->distance_BtoN));
 					}
 					else
 					{
 						p_bn = 0.0;
 					}
+
 				}
-				else	//If diamb is 0, nothing is valid, make all zero
+				else
 				{
-					valid_capacitance = false;	//Failed one line of it, so don't include capacitance anywhere
-					
-					gl_warning("Shunt capacitance of overhead line:%s not calculated - invalid values",OBJECTHDR(this)->name);
-					//Defined above
-
-					p_bb = p_bc = p_bn = 0.0;
+					p_bn = 0.0;
 				}
 			}
-			//Defaulted else - not desired, so don't set anything
-		} else {
-			p_bb = p_bc = p_bn = 0.0;
-			z_bb = z_bc = z_bn = 0.0;
+			else	//If diamb is 0, nothing is valid, make all zero
+			{
+				valid_capacitance = false;	//Failed one line of it, so don't include capacitance anywhere
+				
+				imp->warning[1] = 1;
+
+				p_bb = p_bc = p_bn = 0.0;
+			}
 		}
+		//Defaulted else - not desired, so don't set anything
+	} else {
+		p_bb = p_bc = p_bn = 0.0;
+		z_bb = z_bc = z_bn = 0.0;
+	}
 
-		if (has_phase(PHASE_C)) {
-			if (gmr_c > 0.0 && res_c > 0.0)
-				z_cc = complex(res_c + freq_coeff_real, freq_coeff_imag * (log(1.0 / gmr_c) + freq_additive_term));
-			else
-				z_cc = 0.0;
-			if (has_phase(PHASE_N) && dcn > 0.0)
-				z_cn = complex(freq_coeff_real, freq_coeff_imag * (log(1.0 / dcn) + freq_additive_term));
-			else
-				z_cn = 0.0;
+	if (has_phase(PHASE_C)) {
+		if (gmr_c > 0.0 && res_c > 0.0)
+			z_cc = complex(res_c + freq_coeff_real, freq_coeff_imag * (log(1.0 / gmr_c) + freq_additive_term));
+		else
+			z_cc = 0.0;
+		if (has_phase(PHASE_N) && dcn > 0.0)
+			z_cn = complex(freq_coeff_real, freq_coeff_imag * (log(1.0 / dcn) + freq_additive_term));
+		else
+			z_cn = 0.0;
 
-			//capacitance equations
-			if (use_line_cap == true)
+		//capacitance equations
+		if (use_line_cap == true)
+		{
+			if ((diamC > 0.0) && (spacing_val->distance_CtoE > 0.0))
 			{
-				if ((diamC > 0.0) && (spacing_val->distance_CtoE > 0.0))
+				//Define values - self image
+				dccp = 2.0 * spacing_val->distance_CtoE;
+				p_cc = cap_coeff * log(dccp/diamC*24.0);
+
+				//Get distances to relevant images - assuming weren't done above
+				if (has_phase(PHASE_N))
 				{
-					//Define values - self image
-					dccp = 2.0 * spacing_val->distance_CtoE;
-					p_cc = cap_coeff * log(dccp/diamC*24.0);
+					//Calculate the distance
+					dcnp = calc_image_dist(spacing_val->distance_CtoE,spacing_val->distance_NtoE,spacing_val->distance_CtoN);
 
-					//Get distances to relevant images - assuming weren't done above
-					if (has_phase(PHASE_N))
+					//calculate the contribution
+					if (spacing_val->distance_CtoN != 0)
 					{
-						//Calculate the distance
-						dcnp = calc_image_dist(spacing_val->distance_CtoE,spacing_val->distance_NtoE,spacing_val->distance_CtoN);
-
-						//calculate the contribution
-						if (spacing_val->distance_CtoN != 0)
-						{
-							p_cn = cap_coeff * log(dcnp/(spacing_val->distance_CtoN));
-						}
-						else
-						{
-							p_cn = 0.0;
-						}
+						p_cn = cap_coeff * log(dcnp/(spacing_val->distance_CtoN));
 					}
 					else
 					{
 						p_cn = 0.0;
 					}
 				}
-				else	//If diamC is 0, nothing is valid, make all zero
+				else
 				{
-					valid_capacitance = false;	//Failed one line of it, so don't include capacitance anywhere
-
-					gl_warning("Shunt capacitance of overhead line:%s not calculated - invalid values",OBJECTHDR(this)->name);
-					//Defined above
-
-					p_cc = p_cn = 0.0;
+					p_cn = 0.0;
 				}
 			}
-			//Defaulted else - not desired, so don't set anything
-		} else {
-			p_cc = p_cn = 0.0;
-			z_cc = z_cn = 0.0;
-		}
-
-		complex z_nn_inv = 0;
-		if (has_phase(PHASE_N) && gmr_n > 0.0 && res_n > 0.0){
-			z_nn = complex(res_n + freq_coeff_real, freq_coeff_imag * (log(1.0 / gmr_n) + freq_additive_term));
-			z_nn_inv = z_nn^(-1.0);
-
-			//capacitance equations
-			if (use_line_cap == true)
+			else	//If diamC is 0, nothing is valid, make all zero
 			{
-				if ((diamN > 0.0) && (spacing_val->distance_NtoE > 0.0))
-				{
-					//Define values - self image
-					dnnp = 2.0 * spacing_val->distance_NtoE;
-					p_nn = cap_coeff * log(dnnp/diamN*24.0);
-				}
-				else	//If diamN is 0, nothing is valid, make all zero
-				{
-					valid_capacitance = false;	//Failed one line of it, so don't include capacitance anywhere
+				valid_capacitance = false;	//Failed one line of it, so don't include capacitance anywhere
 
-					gl_warning("Shunt capacitance of overhead line:%s not calculated - invalid values",OBJECTHDR(this)->name);
-					//Defined above
+				imp->warning[2] = 1;
 
-					p_nn = 0.0;
-				}
+				p_cc = p_cn = 0.0;
 			}
-			//Defaulted else - not desired, so don't set anything
 		}
-		else
-		{
-			p_nn = 0.0;
-			z_nn = 0.0;
-		}
-
-		//Update impedance
-		Zabc_mat[0][0] = (z_aa - z_an * z_an * z_nn_inv) * miles;
-		Zabc_mat[0][1] = (z_ab - z_an * z_bn * z_nn_inv) * miles;
-		Zabc_mat[0][2] = (z_ac - z_an * z_cn * z_nn_inv) * miles;
-		Zabc_mat[1][0] = (z_ab - z_bn * z_an * z_nn_inv) * miles;
-		Zabc_mat[1][1] = (z_bb - z_bn * z_bn * z_nn_inv) * miles;
-		Zabc_mat[1][2] = (z_bc - z_bn * z_cn * z_nn_inv) * miles;
-		Zabc_mat[2][0] = (z_ac - z_cn * z_an * z_nn_inv) * miles;
-		Zabc_mat[2][1] = (z_bc - z_cn * z_bn * z_nn_inv) * miles;
-		Zabc_mat[2][2] = (z_cc - z_cn * z_cn * z_nn_inv) * miles;
+		//Defaulted else - not desired, so don't set anything
+	} else {
+		p_cc = p_cn = 0.0;
+		z_cc = z_cn = 0.0;
+	}
 
-		// If we have valid capacitance values and line capacitance is turned on then
-		// calculate Yabc_mat otherwise just leave is zeroed out.
+	complex z_nn_inv = 0;
+	if (has_phase(PHASE_N) && gmr_n > 0.0 && res_n > 0.0){
+		z_nn = complex(res_n + freq_coeff_real, freq_coeff_imag * (log(1.0 / gmr_n) + freq_additive_term));
+		z_nn_inv = z_nn^(-1.0);
 
-		if (valid_capacitance == true && use_line_cap == true)
+		//capacitance equations
+		if (use_line_cap == true)
 		{
-			if (p_nn != 0.0)
-			{
-				//Create the Pabc matrix
-				P_mat[0][0] = p_aa - p_an*p_an/p_nn;
-				P_mat[0][1] = P_mat[1][0] = p_ab - p_an*p_bn/p_nn;
-				P_mat[0][2] = P_mat[2][0] = p_ac - p_an*p_cn/p_nn;
-
-				P_mat[1][1] = p_bb - p_bn*p_bn/p_nn;
-				P_mat[1][2] = P_mat[2][1] = p_bc - p_bn*p_cn/p_nn;
-
-				P_mat[2][2] = p_cc - p_cn*p_cn/p_nn;
-			}
-			else //Neutral must have had issues, ignore it
+			if ((diamN > 0.0) && (spacing_val->distance_NtoE > 0.0))
 			{
-				//Create the Pabc matrix
-				P_mat[0][0] = p_aa;
-				P_mat[0][1] = P_mat[1][0] = p_ab;
-				P_mat[0][2] = P_mat[2][0] = p_ac;
-
-				P_mat[1][1] = p_bb;
-				P_mat[1][2] = P_mat[2][1] = p_bc;
-
-				P_mat[2][2] = p_cc;
+				//Define values - self image
+				dnnp = 2.0 * spacing_val->distance_NtoE;
+				p_nn = cap_coeff * log(dnnp/diamN*24.0);
 			}
-
-			//Now appropriately invert it - scale for frequency, distance, and microSiemens as well as per Kersting (5.14) and (5.15) 
-			if (has_phase(PHASE_A) && !has_phase(PHASE_B) && !has_phase(PHASE_C)) //only A
-				Yabc_mat[0][0] = complex(1.0) / P_mat[0][0] * cap_freq_mult;
-			else if (!has_phase(PHASE_A) && has_phase(PHASE_B) && !has_phase(PHASE_C)) //only B
-				Yabc_mat[1][1] = complex(1.0) / P_mat[1][1] * cap_freq_mult;
-			else if (!has_phase(PHASE_A) && !has_phase(PHASE_B) && has_phase(PHASE_C)) //only C
-				Yabc_mat[2][2] = complex(1.0) / P_mat[2][2] * cap_freq_mult;
-			else if (has_phase(PHASE_A) && !has_phase(PHASE_B) && has_phase(PHASE_C)) //has A & C
+			else	//If diamN is 0, nothing is valid, make all zero
 			{
-				complex detvalue = P_mat[0][0]*P_mat[2][2] - P_mat[0][2]*P_mat[2][0];
+				valid_capacitance = false;	//Failed one line of it, so don't include capacitance anywhere
 
-				Yabc_mat[0][0] = P_mat[2][2] / detvalue * cap_freq_mult;
-				Yabc_mat[0][2] = P_mat[0][2] * -1.0 / detvalue * cap_freq_mult;
-				Yabc_mat[2][0] = P_mat[2][0] * -1.0 / detvalue * cap_freq_mult;
-				Yabc_mat[2][2] = P_mat[0][0] / detvalue * cap_freq_mult;
-			}
-			else if (has_phase(PHASE_A) && has_phase(PHASE_B) && !has_phase(PHASE_C)) //has A & B
-			{
-				complex detvalue = P_mat[0][0]*P_mat[1][1] - P_mat[0][1]*P_mat[1][0];
+				imp->warning[3] = 1;
 
-				Yabc_mat[0][0] = P_mat[1][1] / detvalue * cap_freq_mult;
-				Yabc_mat[0][1] = P_mat[0][1] * -1.0 / detvalue * cap_freq_mult;
-				Yabc_mat[1][0] = P_mat[1][0] * -1.0 / detvalue * cap_freq_mult;
-				Yabc_mat[1][1] = P_mat[0][0] / detvalue * cap_freq_mult;
+				p_nn = 0.0;
 			}
-			else if (!has_phase(PHASE_A) && has_phase(PHASE_B) && has_phase(PHASE_C))	//has B & C
-			{
-				complex detvalue = P_mat[1][1]*P_mat[2][2] - P_mat[1][2]*P_mat[2][1];
+		}
+		//Defaulted else - not desired, so don't set anything
+	}
+	else
+	{
+		p_nn = 0.0;
+		z_nn = 0.0;
+	}
 
-				Yabc_mat[1][1] = P_mat[2][2] / detvalue * cap_freq_mult;
-				Yabc_mat[1][2] = P_mat[1][2] * -1.0 / detvalue * cap_freq_mult;
-				Yabc_mat[2][1] = P_mat[2][1] * -1.0 / detvalue * cap_freq_mult;
-				Yabc_mat[2][2] = P_mat[1][1] / detvalue * cap_freq_mult;
+	//Update impedance
+	imp->z[0][0] = z_aa - z_an * z_an * z_nn_inv;
+	imp->z[0][1] = z_ab - z_an * z_bn * z_nn_inv;
+	imp->z[0][2] = z_ac - z_an * z_cn * z_nn_inv;
+	imp->z[1][0] = z_ab - z_bn * z_an * z_nn_inv;
+	imp->z[1][1] = z_bb - z_bn * z_bn * z_nn_inv;
+	imp->z[1][2] = z_bc - z_bn * z_cn * z_nn_inv;
+	imp->z[2][0] = z_ac - z_cn * z_an * z_nn_inv;
+	imp->z[2][1] = z_bc - z_cn * z_bn * z_nn_inv;
+	imp->z[2][2] = z_cc - z_cn * z_cn * z_nn_inv;
+
+	// If we have valid capacitance values and line capacitance is turned on then
+	// calculate the per-mile admittance otherwise just leave it zeroed out.
+
+	if (valid_capacitance == true && use_line_cap == true)
+	{
+		if (p_nn != 0.0)
+		{
+			//Create the Pabc matrix
+			P_mat[0][0] = p_aa - p_an*p_an/p_nn;
+			P_mat[0][1] = P_mat[1][0] = p_ab - p_an*p_bn/p_nn;
+			P_mat[0][2] = P_mat[2][0] = p_ac - p_an*p_cn/p_nn;
 
-				//Other auxilliary by phase
-				if (has_phase(PHASE_A))
-				{
-					a_mat[0][0] = 1.0;
-					d_mat[0][0] = 1.0;
-					A_mat[0][0] = 1.0;
-				}
+			P_mat[1][1] = p_bb - p_bn*p_bn/p_nn;
+			P_mat[1][2] = P_mat[2][1] = p_bc - p_bn*p_cn/p_nn;
 
-				if (has_phase(PHASE_B))
-				{
-					a_mat[1][1] = 1.0;
-					d_mat[1][1] = 1.0;
-					A_mat[1][1] = 1.0;
-				}
+			P_mat[2][2] = p_cc - p_cn*p_cn/p_nn;
+		}
+		else //Neutral must have had issues, ignore it
+		{
+			//Create the Pabc matrix
+			P_mat[0][0] = p_aa;
+			P_mat[0][1] = P_mat[1][0] = p_ab;
+			P_mat[0][2] = P_mat[2][0] = p_ac;
 
-				if (has_phase(PHASE_C))
-				{
-					a_mat[2][2] = 1.0;
-					d_mat[2][2] = 1.0;
-					A_mat[2][2] = 1.0;
-				}
-			}
-			else if ((has_phase(PHASE_A) && has_phase(PHASE_B) && has_phase(PHASE_C)) || (has_phase(PHASE_D))) //has ABC or D (D=ABC)
-			{
-				complex detvalue = P_mat[0][0]*P_mat[1][1]*P_mat[2][2] - P_mat[0][0]*P_mat[1][2]*P_mat[2][1] - P_mat[0][1]*P_mat[1][0]*P_mat[2][2] + P_mat[0][1]*P_mat[2][0]*P_mat[1][2] + P_mat[1][0]*P_mat[0][2]*P_mat[2][1] - P_mat[0][2]*P_mat[1][1]*P_mat[2][0];
-
-				//Invert it
-				Yabc_mat[0][0] = (P_mat[1][1]*P_mat[2][2] - P_mat[1][2]*P_mat[2][1]) / detvalue * cap_freq_mult;
-				Yabc_mat[0][1] = (P_mat[0][2]*P_mat[2][1] - P_mat[0][1]*P_mat[2][2]) / detvalue * cap_freq_mult;
-				Yabc_mat[0][2] = (P_mat[0][1]*P_mat[1][2] - P_mat[0][2]*P_mat[1][1]) / detvalue * cap_freq_mult;
-				Yabc_mat[1][0] = (P_mat[2][0]*P_mat[1][2] - P_mat[1][0]*P_mat[2][2]) / detvalue * cap_freq_mult;
-				Yabc_mat[1][1] = (P_mat[0][0]*P_mat[2][2] - P_mat[0][2]*P_mat[2][0]) / detvalue * cap_freq_mult;
-				Yabc_mat[1][2] = (P_mat[1][0]*P_mat[0][2] - P_mat[0][0]*P_mat[1][2]) / detvalue * cap_freq_mult;
-				Yabc_mat[2][0] = (P_mat[1][0]*P_mat[2][1] - P_mat[1][1]*P_mat[2][0]) / detvalue * cap_freq_mult;
-				Yabc_mat[2][1] = (P_mat[0][1]*P_mat[2][0] - P_mat[0][0]*P_mat[2][1]) / detvalue * cap_freq_mult;
-				Yabc_mat[2][2] = (P_mat[0][0]*P_mat[1][1] - P_mat[0][1]*P_mat[1][0]) / detvalue * cap_freq_mult;
-			}
+			P_mat[1][1] = p_bb;
+			P_mat[1][2] = P_mat[2][1] = p_bc;
 
-			//Other auxilliary by phase
-			if (has_phase(PHASE_A))
-			{
-				a_mat[0][0] = 1.0;
-				d_mat[0][0] = 1.0;
-				A_mat[0][0] = 1.0;
-			}
+			P_mat[2][2] = p_cc;
+		}
 
-			if (has_phase(PHASE_B))
-			{
-				a_mat[1][1] = 1.0;
-				d_mat[1][1] = 1.0;
-				A_mat[1][1] = 1.0;
-			}
+		//Now appropriately invert it - per Kersting (5.14), the lines scale it for frequency, distance, and microSiemens
+		if (has_phase(PHASE_A) && !has_phase(PHASE_B) && !has_phase(PHASE_C)) //only A
+			imp->y[0][0] = complex(1.0) / P_mat[0][0];
+		else if (!has_phase(PHASE_A) && has_phase(PHASE_B) && !has_phase(PHASE_C)) //only B
+			imp->y[1][1] = complex(1.0) / P_mat[1][1];
+		else if (!has_phase(PHASE_A) && !has_phase(PHASE_B) && has_phase(PHASE_C)) //only C
+			imp->y[2][2] = complex(1.0) / P_mat[2][2];
+		else if (has_phase(PHASE_A) && !has_phase(PHASE_B) && has_phase(PHASE_C)) //has A & C
+		{
+			complex detvalue = P_mat[0][0]*P_mat[2][2] - P_mat[0][2]*P_mat[2][0];
 
-			if (has_phase(PHASE_C))
-			{
-				a_mat[2][2] = 1.0;
-				d_mat[2][2] = 1.0;
-				A_mat[2][2] = 1.0;
-			}
+			imp->y[0][0] = P_mat[2][2] / detvalue;
+			imp->y[0][2] = P_mat[0][2] * -1.0 / detvalue;
+			imp->y[2][0] = P_mat[2][0] * -1.0 / detvalue;
+			imp->y[2][2] = P_mat[0][0] / detvalue;
 		}
-	}
+		else if (has_phase(PHASE_A) && has_phase(PHASE_B) && !has_phase(PHASE_C)) //has A & B
+		{
+			complex detvalue = P_mat[0][0]*P_mat[1][1] - P_mat[0][1]*P_mat[1][0];
 
-	// Calculate line matrixies A_mat, B_mat, a_mat, b_mat, c_mat and d_mat based on Zabc_mat and Yabc_mat
-	recalc_line_matricies(Zabc_mat, Yabc_mat);
-	
-	//Check for negative resistance in the line's impedance matrix
-	bool neg_res = false;
-	for (int n = 0; n < 3; n++){
-		for (int m = 0; m < 3; m++){
-			if(b_mat[n][m].Re() < 0.0){
-				neg_res = true;
-			}
+			imp->y[0][0] = P_mat[1][1] / detvalue;
+			imp->y[0][1] = P_mat[0][1] * -1.0 / detvalue;
+			imp->y[1][0] = P_mat[1][0] * -1.0 / detvalue;
+			imp->y[1][1] = P_mat[0][0] / detvalue;
 		}
-	}
-	
-	if(neg_res == true){
-		gl_warning("INIT: overhead_line:%s has a negative resistance in it's impedance matrix. This will result in unusual behavior. Please check the line's geometry and cable parameters.", obj->name);
-		/*  TROUBLESHOOT
-		A negative resistance value was found for one or more the real parts of the overhead_line's impedance matrix.
-		While this is numerically possible, it is a physical impossibility. This resulted most likely from a improperly 
-		defined conductor cable. Please check and modify the conductor objects used for this line to correct this issue.
-		*/
-	}
-
-#ifdef _TESTING
-	if (show_matrix_values)
-	{
-		OBJECT *obj = GETOBJECT(this);
-
-		gl_testmsg("overhead_line: %s a matrix",obj->name);
-		print_matrix(a_mat);
-
-		gl_testmsg("overhead_line: %s A matrix",obj->name);
-		print_matrix(A_mat);
-
-		gl_testmsg("overhead_line: %s b matrix",obj->name);
-		print_matrix(b_mat);
-
-		gl_testmsg("overhead_line: %s B matrix",obj->name);
-		print_matrix(B_mat);
+		else if (!has_phase(PHASE_A) && has_phase(PHASE_B) && has_phase(PHASE_C))	//has B & C
+		{
+			complex detvalue = P_mat[1][1]*P_mat[2][2] - P_mat[1][2]*P_mat[2][1];
 
-		gl_testmsg("overhead_line: %s c matrix",obj->name);
-		print_matrix(c_mat);
+			imp->y[1][1] = P_mat[2][2] / detvalue;
+			imp->y[1][2] = P_mat[1][2] * -1.0 / detvalue;
+			imp->y[2][1] = P_mat[2][1] * -1.0 / detvalue;
+			imp->y[2][2] = P_mat[1][1] / detvalue;
+		}
+		else if ((has_phase(PHASE_A) && has_phase(PHASE_B) && has_phase(PHASE_C)) || (has_phase(PHASE_D))) //has ABC or D (D=ABC)
+		{
+			complex detvalue = P_mat[0][0]*P_mat[1][1]*P_mat[2][2] - P_mat[0][0]*P_mat[1][2]*P_mat[2][1] - P_mat[0][1]*P_mat[1][0]*P_mat[2][2] + P_mat[0][1]*P_mat[2][0]*P_mat[1][2] + P_mat[1][0]*P_mat[0][2]*P_mat[2][1] - P_mat[0][2]*P_mat[1][1]*P_mat[2][0];
+
+			//Invert it
+			imp->y[0][0] = (P_mat[1][1]*P_mat[2][2] - P_mat[1][2]*P_mat[2][1]) / detvalue;
+			imp->y[0][1] = (P_mat[0][2]*P_mat[2][1] - P_mat[0][1]*P_mat[2][2]) / detvalue;
+			imp->y[0][2] = (P_mat[0][1]*P_mat[1][2] - P_mat[0][2]*P_mat[1][1]) / detvalue;
+			imp->y[1][0] = (P_mat[2][0]*P_mat[1][2] - P_mat[1][0]*P_mat[2][2]) / detvalue;
+			imp->y[1][1] = (P_mat[0][0]*P_mat[2][2] - P_mat[0][2]*P_mat[2][0]) / detvalue;
+			imp->y[1][2] = (P_mat[1][0]*P_mat[0][2] - P_mat[0][0]*P_mat[1][2]) / detvalue;
+			imp->y[2][0] = (P_mat[1][0]*P_mat[2][1] - P_mat[1][1]*P_mat[2][0]) / detvalue;
+			imp->y[2][1] = (P_mat[0][1]*P_mat[2][0] - P_mat[0][0]*P_mat[2][1]) / detvalue;
+			imp->y[2][2] = (P_mat[0][0]*P_mat[1][1] - P_mat[0][1]*P_mat[1][0]) / detvalue;
+		}
 
-		gl_testmsg("overhead_line: %s d matrix",obj->name);
-		print_matrix(d_mat);
+		imp->shunt = true;
 	}
-#endif
 }
 
 int overhead_line::isa(char *classname)
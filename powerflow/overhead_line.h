@@ -20,6 +20,8 @@ public:
 	double calc_image_dist(double dist1_to_e, double dist2_to_e, double dist1_to_2); //Calculates image distance
 private:
 	void test_phases(line_configuration *config, const char ph);
+	void impedance_key(line_configuration *config, LINEIMPEDANCE *imp);
+	void calc_impedance(line_configuration *config, LINEIMPEDANCE *imp);
 };
 EXPORT int create_fault_ohline(OBJECT *thisobj, OBJECT **protect_obj, char *fault_type, int *implemented_fault, TIMESTAMP *repair_time, void *Extra_Data);
 EXPORT int fix_fault_ohline(OBJECT *thisobj, int *implemented_fault, char *imp_fault_name, void *Extra_Data);
@@ -12,6 +12,8 @@
 
 #include "gridlabd.h"
 #include "solver_nr.h"
+#include "solver_fbs.h"
+#include "discrete_control.h"
 
 #ifdef _POWERFLOW_CPP
 #define GLOBAL
@@ -70,12 +72,17 @@ GLOBAL int NR_curr_branch INIT(-1);					/**< Newton-Raphson current branch indic
 GLOBAL int64 NR_iteration_limit INIT(500);			/**< Newton-Raphson iteration limit (per GridLAB-D iteration) */
 GLOBAL bool NR_dyn_first_run INIT(true);			/**< Newton-Raphson first run indicator - used by deltamode functionality for initialization powerflow */
 GLOBAL bool NR_admit_change INIT(true);				/**< Newton-Raphson admittance matrix change detector - used to prevent complete recalculation of admittance at every timestep */
+GLOBAL bool NR_island_solver INIT(false);			/**< Newton-Raphson related - solve electrically independent islands as separate systems, concurrently */
 GLOBAL int NR_superLU_procs INIT(1);				/**< Newton-Raphson related - superLU MT processor count to request - separate from thread_count */
 GLOBAL TIMESTAMP NR_retval INIT(TS_NEVER);			/**< Newton-Raphson current return value - if t0 objects know we aren't going anywhere */
 GLOBAL OBJECT *NR_swing_bus INIT(NULL);				/**< Newton-Raphson swing bus */
 GLOBAL int NR_swing_bus_reference INIT(-1);			/**< Newton-Raphson swing bus index reference in NR_busdata */
 GLOBAL int64 NR_delta_iteration_limit INIT(10);		/**< Newton-Raphson iteration limit (per deltamode timestep) */
 GLOBAL bool FBS_swing_set INIT(false);				/**< Forward-Back Sweep swing assignment variable */
+GLOBAL bool FBS_array_solver INIT(false);			/**< Forward-Back Sweep related - sweep the tree below the SWING bus over flattened arrays, converging in one call */
+GLOBAL int64 FBS_iteration_limit INIT(100);		/**< Forward-Back Sweep array solver sweep limit (per GridLAB-D iteration) */
+GLOBAL bool discrete_control_loop INIT(false);		/**< settle regulator taps and capacitor switches inside the powerflow solution, instead of across GridLAB-D iterations */
+GLOBAL int64 discrete_control_limit INIT(32);		/**< re-solves the discrete control loop makes per GridLAB-D iteration */
 GLOBAL bool show_matrix_values INIT(false);			/**< flag to enable dumping matrix calculations as they occur */
 GLOBAL double primary_voltage_ratio INIT(60.0);		/**< primary voltage ratio (@todo explain primary_voltage_ratio in powerflow (ticket #131) */
 GLOBAL double nominal_frequency INIT(60.0);			/**< nomimal operating frequencty */
@@ -21,6 +21,12 @@ using namespace std;
 CLASS* regulator::oclass = NULL;
 CLASS* regulator::pclass = NULL;
 
+//Discrete control loop step of a regulator object (see discrete_control.cpp)
+static bool regulator_discrete_control(OBJECT *obj, TIMESTAMP t0)
+{
+	return OBJECTDATA(obj,regulator)->reg_discrete_control_fxn(t0);
+}
+
 regulator::regulator(MODULE *mod) : link_object(mod)
 {
 	if (oclass==NULL)
@@ -319,6 +325,11 @@ int regulator::init(OBJECT *parent)
 	tap_A_changed = tap_B_changed = tap_C_changed = 2;
 	prev_time = gl_globalclock;
 	new_reverse_flow_action[0] = new_reverse_flow_action[1] = new_reverse_flow_action[2] = false;
+
+	//Voltage-sensing controls can settle inside the powerflow solution (line drop compensation needs the link currents of postsync)
+	if ((result == 1) && (discrete_control_loop == true) && ((pConfig->Control == pConfig->OUTPUT_VOLTAGE) || (pConfig->Control == pConfig->REMOTE_NODE)))
+		discrete_control_register(obj,regulator_discrete_control);
+
 	return result;
 }
 
@@ -330,7 +341,8 @@ TIMESTAMP regulator::presync(TIMESTAMP t0)
 	char phaseWarn;
 
 	//Toggle the iteration variable -- only for voltage-type adjustments (since it's in presync now)
-	if ((solver_method == SM_NR) && ((pConfig->Control == pConfig->OUTPUT_VOLTAGE) || (pConfig->Control == pConfig->REMOTE_NODE)))
+	//The discrete control loop re-checks the taps after every solution, so it doesn't need the "off" pass
+	if ((solver_method == SM_NR) && ((pConfig->Control == pConfig->OUTPUT_VOLTAGE) || (pConfig->Control == pConfig->REMOTE_NODE)) && (discrete_control_loop == false))
 		iteration_flag = !iteration_flag;
 
 	if (pConfig->Control == pConfig->MANUAL) {
@@ -348,373 +360,471 @@ TIMESTAMP regulator::presync(TIMESTAMP t0)
 		next_time = TS_NEVER;
 	}
 	else if (iteration_flag==true)
+		reg_tap_fxn(t0);
+			
+	//Use 'a' matrix to solve appropriate 'A' & 'd' matrices
+	reg_matrix_fxn();
+		
+	TIMESTAMP t1 = link_object::presync(t0);
+	
+	if (solver_method == SM_NR)
 	{
-		if (pConfig->control_level == pConfig->INDIVIDUAL)
+		//Only perform update if a tap has changed.  Since the link calculations are replicated here and it directly
+		//accesses the NR memory space, this won't cause any issues.
+		if (reg_NR_admittance_fxn() == true)	//Change has occurred
 		{
-			//Set flags correctly for each pass, 1 indicates okay to change taps, 0 indicates no go
-			for (int i = 0; i < 3; i++) {
-				if (mech_t_next[i] <= t0) {
-					mech_flag[i] = 1;
-				}
-				if (dwell_t_next[i] <= t0) {
-					dwell_flag[i] = 1;
-				}
-				else if (dwell_t_next[i] > t0) {
-					dwell_flag[i] = 0;
-				}
-			}
+			//Flag an update
+			LOCK_OBJECT(NR_swing_bus);	//Lock SWING since we'll be modifying this
+			NR_admit_change = true;
+			UNLOCK_OBJECT(NR_swing_bus);	//Unlock
+		}
+	}
 
-			get_monitored_voltage();
+	//General warnings for if we're at a railed tap limit
+	if (tap[0] == pConfig->raise_taps)
+	{
+		phaseWarn='A';	//Just so troubleshoot is generic
 
-			if (pConfig->connect_type == pConfig->WYE_WYE)
-			{	
-				//Update first run flag - special solver during first time solved.
-				if ((first_run_flag[0] + first_run_flag[1] + first_run_flag[2]) < 3 ) {
-					for (int i = 0; i < 3; i++) {
-						if (first_run_flag[i] < 1) {
-							first_run_flag[i] += 1;
-						}
-					}
-				}
+		gl_warning("Regulator %s has phase %c at the maximum tap value",OBJECTHDR(this)->name,phaseWarn);
+		/*  TROUBLESHOOT
+		The regulator has set its taps such that it is at the maximum setting.  This may indicate
+		a problem with settings, or your system.
+		*/
+	}
 
-				for (int i = 0; i < 3; i++) 
-				{
-					
-					if (check_voltage[i].Mag() < Vlow)		//raise voltage
-					{	
-						//hit the band center for convergence on first run, otherwise bad initial guess on tap settings 
-						//can fail on the first timestep
-						if (first_run_flag[i] == 0) 
-						{	
-							if(toggle_reverse_flow[i]) {
-								tap[i] = reverse_flow_tap[i];
-							} else {
-								tap[i] = tap[i] + (int16)ceil((pConfig->band_center - check_voltage[i].Mag())/VtapChange);
-							}
-							if (tap[i] > pConfig->raise_taps) 
-							{
-								tap[i] = pConfig->raise_taps;
-							}
-							dwell_t_next[i] = t0 + (int64)pConfig->dwell_time;
-							mech_t_next[i] = t0 + (int64)pConfig->time_delay;
-						}
-						//dwelling has happened, and now waiting for actual physical change time
-						else if (mech_flag[i] == 0 && dwell_flag[i] == 1 && (mech_t_next[i] - t0) >= pConfig->time_delay)
-						{
-							mech_t_next[i] = t0 + (int64)pConfig->time_delay;
-						}
-						//if both flags say it's okay to change the tap, then change the tap
-						else if (mech_flag[i] == 1 && dwell_flag[i] == 1) 
-						{
-							if(toggle_reverse_flow[i]) {
-								tap[i] = reverse_flow_tap[i];
-							} else {
-								tap[i] = tap[i] + (int16) 1;
-							}
-
-							if (tap[i] > pConfig->raise_taps) 
-							{
-								tap[i] = pConfig->raise_taps;
-								dwell_t_next[i] = t0 + (int64)pConfig->dwell_time;
-								mech_t_next[i] = t0 + (int64)pConfig->time_delay;
-								dwell_flag[i] = mech_flag[i] = 0;
-							}
-							else 
-							{
-								mech_t_next[i] = t0 + (int64)pConfig->time_delay;
-								dwell_t_next[i] = t0 + (int64)pConfig->dwell_time;
-								mech_flag[i] = 0;
-							}
-						}
-						//only set the dwell time if we've reached the end of the previous dwell (in case other 
-						//objects update during that time)
-						else if (dwell_flag[i] == 0 && (dwell_t_next[i] - t0) >= pConfig->dwell_time) 
-						{
-							dwell_t_next[i] = t0 + (int64)pConfig->dwell_time;
-							mech_t_next[i] = dwell_t_next[i] + (int64)pConfig->time_delay;
-						}														
-					}
-					else if (check_voltage[i].Mag() > Vhigh)  //lower voltage
-					{
-						if (first_run_flag[i] == 0) 
-						{
-							if(toggle_reverse_flow[i]) {
-								tap[i] = reverse_flow_tap[i];
-							} else {
-								tap[i] = tap[i] - (int16)ceil((check_voltage[i].Mag() - pConfig->band_center)/VtapChange);
-							}
-							if (tap[i] < -pConfig->lower_taps) 
-							{
-								tap[i] = -pConfig->lower_taps;
-							}
-							dwell_t_next[i] = t0 + (int64)pConfig->dwell_time;
-							mech_t_next[i] = t0 + (int64)pConfig->time_delay;
-						}
-						else if (mech_flag[i] == 0 && dwell_flag[i] == 1 && (mech_t_next[i] - t0) >= pConfig->time_delay)
-						{
-							mech_t_next[i] = t0 + (int64)pConfig->time_delay;
-						}
-						else if (mech_flag[i] == 1 && dwell_flag[i] == 1) 
-						{
-							if(toggle_reverse_flow[i]) {
-								tap[i] = reverse_flow_tap[i];
-							} else {
-								tap[i] = tap[i] - (int16) 1;
-							}
-							if (tap[i] < -pConfig->lower_taps) 
-							{
-								tap[i] = -pConfig->lower_taps;
-								dwell_t_next[i] = t0 + (int64)pConfig->dwell_time;
-								mech_t_next[i] = t0 + (int64)pConfig->time_delay;
-								dwell_flag[i] = mech_flag[i] = 0;
-							}
-							else 
-							{
-								mech_t_next[i] = t0 + (int64)pConfig->time_delay;
-								dwell_t_next[i] = t0 + (int64)pConfig->dwell_time;
-								mech_flag[i] = 0;
-							}
-						}
-						else if (dwell_flag[i] == 0 && (dwell_t_next[i] - t0) >= pConfig->dwell_time) 
-						{
-							dwell_t_next[i] = t0 + (int64)pConfig->dwell_time;
-							mech_t_next[i] = dwell_t_next[i] + (int64)pConfig->time_delay;
-						}
-					}
-					//If no tap changes were needed, then this resets dwell_flag to 0 and indicates regulator has no
-					//more changes unless system changes
-					else 
-					{	
-						dwell_t_next[i] = mech_t_next[i] = TS_NEVER;
-						//if (pConfig->dwell_time == 0)
-						//	dwell_flag[i] = 1;
-						//else
-							dwell_flag[i] = 0;
-						//if (pConfig->time_delay == 0)
-						//	mech_flag[i] = 1;
-						//else
-							mech_flag[i] = 0;
-					}
+	if (tap[1] == pConfig->raise_taps)
+	{
+		phaseWarn='B';	//Just so troubleshoot is generic
 
-					//Use tap positions to solve for 'a' matrix
-					if (pConfig->Type == pConfig->A)
-					{	a_mat[i][i] = 1/(1.0 + tap[i] * tapChangePer);}
-					else if (pConfig->Type == pConfig->B)
-					{	a_mat[i][i] = 1.0 - tap[i] * tapChangePer;}
-					else
-					{	throw "invalid regulator type";}
-					/*  TROUBLESHOOT
-					Check the Type of regulator specified.  Type can only be A or B at this time.
-					*/
-				}
-				//Determine how far to advance the clock
-				int64 nt[3];
-				nt[0] = nt[1] = nt[2] = t0;
-				for (int i = 0; i < 3; i++) {
-					if (mech_t_next[i] > t0)
-						nt[i] = mech_t_next[i];
-					if (dwell_t_next[i] > t0)
-						nt[i] = dwell_t_next[i];
-				}
+		gl_warning("Regulator %s has phase %c at the maximum tap value",OBJECTHDR(this)->name,phaseWarn);
+		//Defined above
+	}
 
-				if (nt[0] > t0)
-					next_time = nt[0];
-				if (nt[1] > t0 && nt[1] < next_time)
-					next_time = nt[1];
-				if (nt[2] > t0 && nt[2] < next_time)
-					next_time = nt[2];
+	if (tap[2] == pConfig->raise_taps)
+	{
+		phaseWarn='C';	//Just so troubleshoot is generic
 
-				if (next_time <= t0)
-					next_time = TS_NEVER;
-			}
-			else
-				GL_THROW("Specified connect type is not supported in automatic modes at this time.");
-				/* TROUBLESHOOT
-				At this time only WYE-WYE regulators are supported in automatic control modes. 
-				OPEN_DELTA_ABBC will only work in MANUAL control mode and in FBS at this time.
-				*/
-		}
+		gl_warning("Regulator %s has phase %c at the maximum tap value",OBJECTHDR(this)->name,phaseWarn);
+		//Defined above
+	}
 
-		else if (pConfig->control_level == pConfig->BANK)
-		{
-			//Set flags correctly for each pass, 1 indicates okay to change taps, 0 indicates no go - we'll store all of banked stuff in index=0
-			if (mech_t_next[0] <= t0) {
-				mech_flag[0] = 1;
+	if (tap[0] == -pConfig->lower_taps)
+	{
+		phaseWarn='A';	//Just so troubleshoot is generic
+
+		gl_warning("Regulator %s has phase %c at the minimum tap value",OBJECTHDR(this)->name,phaseWarn);
+		/*  TROUBLESHOOT
+		The regulator has set its taps such that it is at the minimum setting.  This may indicate
+		a problem with settings, or your system.
+		*/
+	}
+
+	if (tap[1] == -pConfig->lower_taps)
+	{
+		phaseWarn='B';	//Just so troubleshoot is generic
+
+		gl_warning("Regulator %s has phase %c at the minimum tap value",OBJECTHDR(this)->name,phaseWarn);
+		//Defined above
+	}
+
+	if (tap[2] == -pConfig->lower_taps)
+	{
+		phaseWarn='C';	//Just so troubleshoot is generic
+
+		gl_warning("Regulator %s has phase %c at the minimum tap value",OBJECTHDR(this)->name,phaseWarn);
+		//Defined above
+	}
+	if (offnominal_time && (t0 > next_time))
+	{
+		next_time = t0;
+	}
+
+	//Force a "reiteration" if we're checking voltage - consequence of this previously being in true pass of NR
+	if ((solver_method == SM_NR) && ((pConfig->Control == pConfig->OUTPUT_VOLTAGE) || (pConfig->Control == pConfig->REMOTE_NODE)) && (iteration_flag==false))
+	{
+		return t0;
+	}
+
+	if (first_run_flag[0] < 1 || first_run_flag[1] < 1 || first_run_flag[2] < 1) return t1;
+	else if (t1 <= next_time) return t1;
+	else if (next_time != TS_NEVER) return -next_time; //soft return to next tap change
+	else return TS_NEVER;
+}
+
+//Functionalized automatic tap control - run by presync, and by the discrete control loop after each powerflow solution
+void regulator::reg_tap_fxn(TIMESTAMP t0)
+{
+	regulator_configuration *pConfig = OBJECTDATA(configuration, regulator_configuration);
+
+	if (pConfig->control_level == pConfig->INDIVIDUAL)
+	{
+		//Set flags correctly for each pass, 1 indicates okay to change taps, 0 indicates no go
+		for (int i = 0; i < 3; i++) {
+			if (mech_t_next[i] <= t0) {
+				mech_flag[i] = 1;
 			}
-			if (dwell_t_next[0] <= t0) {
-				dwell_flag[0] = 1;
+			if (dwell_t_next[i] <= t0) {
+				dwell_flag[i] = 1;
 			}
-			else if (dwell_t_next[0] > t0) {
-				dwell_flag[0] = 0;
+			else if (dwell_t_next[i] > t0) {
+				dwell_flag[i] = 0;
 			}
+		}
 
-			get_monitored_voltage();
+		get_monitored_voltage();
 
-			if (pConfig->connect_type == pConfig->WYE_WYE)
-			{	
-				//Update first run flag - special solver during first time solved.
-				if (first_run_flag[0] < 1)
-				{
-					first_run_flag[0] += 1;	
-					first_run_flag[1] += 1;
-					first_run_flag[2] += 1;
-				}			
+		if (pConfig->connect_type == pConfig->WYE_WYE)
+		{	
+			//Update first run flag - special solver during first time solved.
+			if ((first_run_flag[0] + first_run_flag[1] + first_run_flag[2]) < 3 ) {
+				for (int i = 0; i < 3; i++) {
+					if (first_run_flag[i] < 1) {
+						first_run_flag[i] += 1;
+					}
+				}
+			}
 
-				if (check_voltage[0].Mag() < Vlow)		//raise voltage
+			for (int i = 0; i < 3; i++) 
+			{
+				
+				if (check_voltage[i].Mag() < Vlow)		//raise voltage
 				{	
 					//hit the band center for convergence on first run, otherwise bad initial guess on tap settings 
 					//can fail on the first timestep
-					if (first_run_flag[0] == 0) 
-					{
-						if(toggle_reverse_flow_banked) {
-							tap[0] = reverse_flow_tap[0];
-							tap[1] = reverse_flow_tap[1];
-							tap[2] = reverse_flow_tap[2];
+					if (first_run_flag[i] == 0) 
+					{	
+						if(toggle_reverse_flow[i]) {
+							tap[i] = reverse_flow_tap[i];
 						} else {
-							tap[0] = tap[1] = tap[2] = tap[0] + (int16)ceil((pConfig->band_center - check_voltage[0].Mag())/VtapChange);
+							tap[i] = tap[i] + (int16)ceil((pConfig->band_center - check_voltage[i].Mag())/VtapChange);
 						}
-						if (tap[0] > pConfig->raise_taps) 
+						if (tap[i] > pConfig->raise_taps) 
 						{
-							tap[0] = tap[1] = tap[2] = pConfig->raise_taps;
+							tap[i] = pConfig->raise_taps;
 						}
-						dwell_t_next[0] = t0 + (int64)pConfig->dwell_time;
-						mech_t_next[0] = t0 + (int64)pConfig->time_delay;
+						dwell_t_next[i] = t0 + (int64)pConfig->dwell_time;
+						mech_t_next[i] = t0 + (int64)pConfig->time_delay;
 					}
 					//dwelling has happened, and now waiting for actual physical change time
-					else if (mech_flag[0] == 0 && dwell_flag[0] == 1 && (mech_t_next[0] - t0) >= pConfig->time_delay)
+					else if (mech_flag[i] == 0 && dwell_flag[i] == 1 && (mech_t_next[i] - t0) >= pConfig->time_delay)
 					{
-						mech_t_next[0] = t0 + (int64)pConfig->time_delay;
+						mech_t_next[i] = t0 + (int64)pConfig->time_delay;
 					}
 					//if both flags say it's okay to change the tap, then change the tap
-					else if (mech_flag[0] == 1 && dwell_flag[0] == 1) 
-					{		 
-						if(toggle_reverse_flow_banked) {
-							tap[0] = reverse_flow_tap[0];
-							tap[1] = reverse_flow_tap[1];
-							tap[2] = reverse_flow_tap[2];
+					else if (mech_flag[i] == 1 && dwell_flag[i] == 1) 
+					{
+						if(toggle_reverse_flow[i]) {
+							tap[i] = reverse_flow_tap[i];
 						} else {
-							tap[0] = tap[1] = tap[2] = tap[0] + (int16) 1;
+							tap[i] = tap[i] + (int16) 1;
 						}
-						if (tap[0] > pConfig->raise_taps) 
+
+						if (tap[i] > pConfig->raise_taps) 
 						{
-							tap[0] = tap[1] = tap[2] = pConfig->raise_taps;
-							dwell_t_next[0] = t0 + (int64)pConfig->dwell_time;
-							mech_t_next[0] = t0 + (int64)pConfig->time_delay;
-							dwell_flag[0] = mech_flag[0] = 0;
+							tap[i] = pConfig->raise_taps;
+							dwell_t_next[i] = t0 + (int64)pConfig->dwell_time;
+							mech_t_next[i] = t0 + (int64)pConfig->time_delay;
+							dwell_flag[i] = mech_flag[i] = 0;
 						}
 						else 
 						{
-							mech_t_next[0] = t0 + (int64)pConfig->time_delay;
-							dwell_t_next[0] = t0 + (int64)pConfig->dwell_time;
-							mech_flag[0] = 0;
+							mech_t_next[i] = t0 + (int64)pConfig->time_delay;
+							dwell_t_next[i] = t0 + (int64)pConfig->dwell_time;
+							mech_flag[i] = 0;
 						}
 					}
 					//only set the dwell time if we've reached the end of the previous dwell (in case other 
 					//objects update during that time)
-					else if (dwell_flag[0] == 0 && (dwell_t_next[0] - t0) >= pConfig->dwell_time) 
+					else if (dwell_flag[i] == 0 && (dwell_t_next[i] - t0) >= pConfig->dwell_time) 
 					{
-						dwell_t_next[0] = t0 + (int64)pConfig->dwell_time;
-						mech_t_next[0] = dwell_t_next[0] + (int64)pConfig->time_delay;
+						dwell_t_next[i] = t0 + (int64)pConfig->dwell_time;
+						mech_t_next[i] = dwell_t_next[i] + (int64)pConfig->time_delay;
 					}														
 				}
-				else if (check_voltage[0].Mag() > Vhigh)  //lower voltage
+				else if (check_voltage[i].Mag() > Vhigh)  //lower voltage
 				{
-					if (first_run_flag[0] == 0) 
+					if (first_run_flag[i] == 0) 
 					{
-						if(toggle_reverse_flow_banked) {
-							tap[0] = reverse_flow_tap[0];
-							tap[1] = reverse_flow_tap[1];
-							tap[2] = reverse_flow_tap[2];
+						if(toggle_reverse_flow[i]) {
+							tap[i] = reverse_flow_tap[i];
 						} else {
-							tap[0] = tap[1] = tap[2] = tap[0] - (int16)ceil((check_voltage[0].Mag() - pConfig->band_center)/VtapChange);
+							tap[i] = tap[i] - (int16)ceil((check_voltage[i].Mag() - pConfig->band_center)/VtapChange);
 						}
-						if (tap[0] < -pConfig->lower_taps) 
+						if (tap[i] < -pConfig->lower_taps) 
 						{
-							tap[0] = tap[1] = tap[2] = -pConfig->lower_taps;
+							tap[i] = -pConfig->lower_taps;
 						}
-						dwell_t_next[0] = t0 + (int64)pConfig->dwell_time;
-						mech_t_next[0] = t0 + (int64)pConfig->time_delay;
+						dwell_t_next[i] = t0 + (int64)pConfig->dwell_time;
+						mech_t_next[i] = t0 + (int64)pConfig->time_delay;
 					}
-					else if (mech_flag[0] == 0 && dwell_flag[0] == 1 && (mech_t_next[0] - t0) >= pConfig->time_delay)
+					else if (mech_flag[i] == 0 && dwell_flag[i] == 1 && (mech_t_next[i] - t0) >= pConfig->time_delay)
 					{
-						mech_t_next[0] = t0 + (int64)pConfig->time_delay;
+						mech_t_next[i] = t0 + (int64)pConfig->time_delay;
 					}
-					else if (mech_flag[0] == 1 && dwell_flag[0] == 1) 
+					else if (mech_flag[i] == 1 && dwell_flag[i] == 1) 
 					{
-						if(toggle_reverse_flow_banked) {
-							tap[0] = reverse_flow_tap[0];
-							tap[1] = reverse_flow_tap[1];
-							tap[2] = reverse_flow_tap[2];
+						if(toggle_reverse_flow[i]) {
+							tap[i] = reverse_flow_tap[i];
 						} else {
-							tap[0] = tap[1] = tap[2] = tap[0] - (int16) 1;
+							tap[i] = tap[i] - (int16) 1;
 						}
-						if (tap[0] < -pConfig->lower_taps) 
+						if (tap[i] < -pConfig->lower_taps) 
 						{
-							tap[0] = tap[1] = tap[2] = -pConfig->lower_taps;
-							dwell_t_next[0] = t0 + (int64)pConfig->dwell_time;
-							mech_t_next[0] = t0 + (int64)pConfig->time_delay;
-							dwell_flag[0] = mech_flag[0] = 0;
+							tap[i] = -pConfig->lower_taps;
+							dwell_t_next[i] = t0 + (int64)pConfig->dwell_time;
+							mech_t_next[i] = t0 + (int64)pConfig->time_delay;
+							dwell_flag[i] = mech_flag[i] = 0;
 						}
 						else 
 						{
-							mech_t_next[0] = t0 + (int64)pConfig->time_delay;
-							dwell_t_next[0] = t0 + (int64)pConfig->dwell_time;
-							mech_flag[0] = 0;
+							mech_t_next[i] = t0 + (int64)pConfig->time_delay;
+							dwell_t_next[i] = t0 + (int64)pConfig->dwell_time;
+							mech_flag[i] = 0;
 						}
 					}
-					else if (dwell_flag[0] == 0 && (dwell_t_next[0] - t0) >= pConfig->dwell_time) 
+					else if (dwell_flag[i] == 0 && (dwell_t_next[i] - t0) >= pConfig->dwell_time) 
 					{
-						dwell_t_next[0] = t0 + (int64)pConfig->dwell_time;
-						mech_t_next[0] = dwell_t_next[0] + (int64)pConfig->time_delay;
+						dwell_t_next[i] = t0 + (int64)pConfig->dwell_time;
+						mech_t_next[i] = dwell_t_next[i] + (int64)pConfig->time_delay;
 					}
 				}
 				//If no tap changes were needed, then this resets dwell_flag to 0 and indicates regulator has no
 				//more changes unless system changes
 				else 
 				{	
-					dwell_t_next[0] = mech_t_next[0] = TS_NEVER;
-					dwell_flag[0] = 0;
-					mech_flag[0] = 0;
+					dwell_t_next[i] = mech_t_next[i] = TS_NEVER;
+					//if (pConfig->dwell_time == 0)
+					//	dwell_flag[i] = 1;
+					//else
+						dwell_flag[i] = 0;
+					//if (pConfig->time_delay == 0)
+					//	mech_flag[i] = 1;
+					//else
+						mech_flag[i] = 0;
 				}
 
-				for (int i = 0; i < 3; i++) {
-					//Use tap positions to solve for 'a' matrix
-					if (pConfig->Type == pConfig->A)
-					{	a_mat[i][i] = 1/(1.0 + tap[i] * tapChangePer);}
-					else if (pConfig->Type == pConfig->B)
-					{	a_mat[i][i] = 1.0 - tap[i] * tapChangePer;}
-					else
-					{	throw "invalid regulator type";}
-					/*  TROUBLESHOOT
-					Check the Type of regulator specified.  Type can only be A or B at this time.
-					*/
-				}
+				//Use tap positions to solve for 'a' matrix
+				if (pConfig->Type == pConfig->A)
+				{	a_mat[i][i] = 1/(1.0 + tap[i] * tapChangePer);}
+				else if (pConfig->Type == pConfig->B)
+				{	a_mat[i][i] = 1.0 - tap[i] * tapChangePer;}
+				else
+				{	throw "invalid regulator type";}
+				/*  TROUBLESHOOT
+				Check the Type of regulator specified.  Type can only be A or B at this time.
+				*/
+			}
+			//Determine how far to advance the clock
+			int64 nt[3];
+			nt[0] = nt[1] = nt[2] = t0;
+			for (int i = 0; i < 3; i++) {
+				if (mech_t_next[i] > t0)
+					nt[i] = mech_t_next[i];
+				if (dwell_t_next[i] > t0)
+					nt[i] = dwell_t_next[i];
+			}
 
-				//Determine how far to advance the clock
-				int64 nt[3];
-				nt[0] = nt[1] = nt[2] = t0;
-				if (mech_t_next[0] > t0)
-					nt[0] = mech_t_next[0];
-				if (dwell_t_next[0] > t0)
-					nt[0] = dwell_t_next[0];
+			if (nt[0] > t0)
+				next_time = nt[0];
+			if (nt[1] > t0 && nt[1] < next_time)
+				next_time = nt[1];
+			if (nt[2] > t0 && nt[2] < next_time)
+				next_time = nt[2];
 
-				if (nt[0] > t0)
-					next_time = nt[0];
+			if (next_time <= t0)
+				next_time = TS_NEVER;
+		}
+		else
+			GL_THROW("Specified connect type is not supported in automatic modes at this time.");
+			/* TROUBLESHOOT
+			At this time only WYE-WYE regulators are supported in automatic control modes. 
+			OPEN_DELTA_ABBC will only work in MANUAL control mode and in FBS at this time.
+			*/
+	}
 
-				if (next_time <= t0)
-					next_time = TS_NEVER;
+	else if (pConfig->control_level == pConfig->BANK)
+	{
+		//Set flags correctly for each pass, 1 indicates okay to change taps, 0 indicates no go - we'll store all of banked stuff in index=0
+		if (mech_t_next[0] <= t0) {
+			mech_flag[0] = 1;
+		}
+		if (dwell_t_next[0] <= t0) {
+			dwell_flag[0] = 1;
+		}
+		else if (dwell_t_next[0] > t0) {
+			dwell_flag[0] = 0;
+		}
+
+		get_monitored_voltage();
+
+		if (pConfig->connect_type == pConfig->WYE_WYE)
+		{	
+			//Update first run flag - special solver during first time solved.
+			if (first_run_flag[0] < 1)
+			{
+				first_run_flag[0] += 1;	
+				first_run_flag[1] += 1;
+				first_run_flag[2] += 1;
+			}			
+
+			if (check_voltage[0].Mag() < Vlow)		//raise voltage
+			{	
+				//hit the band center for convergence on first run, otherwise bad initial guess on tap settings 
+				//can fail on the first timestep
+				if (first_run_flag[0] == 0) 
+				{
+					if(toggle_reverse_flow_banked) {
+						tap[0] = reverse_flow_tap[0];
+						tap[1] = reverse_flow_tap[1];
+						tap[2] = reverse_flow_tap[2];
+					} else {
+						tap[0] = tap[1] = tap[2] = tap[0] + (int16)ceil((pConfig->band_center - check_voltage[0].Mag())/VtapChange);
+					}
+					if (tap[0] > pConfig->raise_taps) 
+					{
+						tap[0] = tap[1] = tap[2] = pConfig->raise_taps;
+					}
+					dwell_t_next[0] = t0 + (int64)pConfig->dwell_time;
+					mech_t_next[0] = t0 + (int64)pConfig->time_delay;
+				}
+				//dwelling has happened, and now waiting for actual physical change time
+				else if (mech_flag[0] == 0 && dwell_flag[0] == 1 && (mech_t_next[0] - t0) >= pConfig->time_delay)
+				{
+					mech_t_next[0] = t0 + (int64)pConfig->time_delay;
+				}
+				//if both flags say it's okay to change the tap, then change the tap
+				else if (mech_flag[0] == 1 && dwell_flag[0] == 1) 
+				{		 
+					if(toggle_reverse_flow_banked) {
+						tap[0] = reverse_flow_tap[0];
+						tap[1] = reverse_flow_tap[1];
+						tap[2] = reverse_flow_tap[2];
+					} else {
+						tap[0] = tap[1] = tap[2] = tap[0] + (int16) 1;
+					}
+					if (tap[0] > pConfig->raise_taps) 
+					{
+						tap[0] = tap[1] = tap[2] = pConfig->raise_taps;
+						dwell_t_next[0] = t0 + (int64)pConfig->dwell_time;
+						mech_t_next[0] = t0 + (int64)pConfig->time_delay;
+						dwell_flag[0] = mech_flag[0] = 0;
+					}
+					else 
+					{
+						mech_t_next[0] = t0 + (int64)pConfig->time_delay;
+						dwell_t_next[0] = t0 + (int64)pConfig->dwell_time;
+						mech_flag[0] = 0;
+					}
+				}
+				//only set the dwell time if we've reached the end of the previous dwell (in case other 
+				//objects update during that time)
+				else if (dwell_flag[0] == 0 && (dwell_t_next[0] - t0) >= pConfig->dwell_time) 
+				{
+					dwell_t_next[0] = t0 + (int64)pConfig->dwell_time;
+					mech_t_next[0] = dwell_t_next[0] + (int64)pConfig->time_delay;
+				}														
 			}
-			else
-				GL_THROW("Specified connect type is not supported in automatic modes at this time.");
-				/* TROUBLESHOOT
-				At this time only WYE-WYE regulators are supported in automatic control modes. 
-				OPEN_DELTA_ABBC will only work in MANUAL control mode and in FBS at this time.
+			else if (check_voltage[0].Mag() > Vhigh)  //lower voltage
+			{
+				if (first_run_flag[0] == 0) 
+				{
+					if(toggle_reverse_flow_banked) {
+						tap[0] = reverse_flow_tap[0];
+						tap[1] = reverse_flow_tap[1];
+						tap[2] = reverse_flow_tap[2];
+					} else {
+						tap[0] = tap[1] = tap[2] = tap[0] - (int16)ceil((check_voltage[0].Mag() - pConfig->band_center)/VtapChange);
+					}
+					if (tap[0] < -pConfig->lower_taps) 
+					{
+						tap[0] = tap[1] = tap[2] = -pConfig->lower_taps;
+					}
+					dwell_t_next[0] = t0 + (int64)pConfig->dwell_time;
+					mech_t_next[0] = t0 + (int64)pConfig->time_delay;
+				}
+				else if (mech_flag[0] == 0 && dwell_flag[0] == 1 && (mech_t_next[0] - t0) >= pConfig->time_delay)
+				{
+					mech_t_next[0] = t0 + (int64)pConfig->time_delay;
+				}
+				else if (mech_flag[0] == 1 && dwell_flag[0] == 1) 
+				{
+					if(toggle_reverse_flow_banked) {
+						tap[0] = reverse_flow_tap[0];
+						tap[1] = reverse_flow_tap[1];
+						tap[2] = reverse_flow_tap[2];
+					} else {
+						tap[0] = tap[1] = tap[2] = tap[0] - (int16) 1;
+					}
+					if (tap[0] < -pConfig->lower_taps) 
+					{
+						tap[0] = tap[1] = tap[2] = -pConfig->lower_taps;
+						dwell_t_next[0] = t0 + (int64)pConfig->dwell_time;
+						mech_t_next[0] = t0 + (int64)pConfig->time_delay;
+						dwell_flag[0] = mech_flag[0] = 0;
+					}
+					else 
+					{
+						mech_t_next[0] = t0 + (int64)pConfig->time_delay;
+						dwell_t_next[0] = t0 + (int64)pConfig->dwell_time;
+						mech_flag[0] = 0;
+					}
+				}
+				else if (dwell_flag[0] == 0 && (dwell_t_next[0] - t0) >= pConfig->dwell_time) 
+				{
+					dwell_t_next[0] = t0 + (int64)pConfig->dwell_time;
+					mech_t_next[0] = dwell_t_next[0] + (int64)pConfig->time_delay;
+				}
+			}
+			//If no tap changes were needed, then this resets dwell_flag to 0 and indicates regulator has no
+			//more changes unless system changes
+			else 
+			{	
+				dwell_t_next[0] = mech_t_next[0] = TS_NEVER;
+				dwell_flag[0] = 0;
+				mech_flag[0] = 0;
+			}
+
+			for (int i = 0; i < 3; i++) {
+				//Use tap positions to solve for 'a' matrix
+				if (pConfig->Type == pConfig->A)
+				{	a_mat[i][i] = 1/(1.0 + tap[i] * tapChangePer);}
+				else if (pConfig->Type == pConfig->B)
+				{	a_mat[i][i] = 1.0 - tap[i] * tapChangePer;}
+				else
+				{	throw "invalid regulator type";}
+				/*  TROUBLESHOOT
+				Check the Type of regulator specified.  Type can only be A or B at this time.
 				*/
+			}
+
+			//Determine how far to advance the clock
+			int64 nt[3];
+			nt[0] = nt[1] = nt[2] = t0;
+			if (mech_t_next[0] > t0)
+				nt[0] = mech_t_next[0];
+			if (dwell_t_next[0] > t0)
+				nt[0] = dwell_t_next[0];
+
+			if (nt[0] > t0)
+				next_time = nt[0];
+
+			if (next_time <= t0)
+				next_time = TS_NEVER;
 		}
-		
+		else
+			GL_THROW("Specified connect type is not supported in automatic modes at this time.");
+			/* TROUBLESHOOT
+			At this time only WYE-WYE regulators are supported in automatic control modes. 
+			OPEN_DELTA_ABBC will only work in MANUAL control mode and in FBS at this time.
+			*/
 	}
-			
-	//Use 'a' matrix to solve appropriate 'A' & 'd' matrices
+}
+
+//Functionalized update of the A and d matrices from the tap positions (a matrix)
+void regulator::reg_matrix_fxn(void)
+{
+	regulator_configuration *pConfig = OBJECTDATA(configuration, regulator_configuration);
+
 	complex tmp_mat[3][3] = {{complex(1,0)/a_mat[0][0],complex(0,0),complex(0,0)},
 							 {complex(0,0), complex(1,0)/a_mat[1][1],complex(0,0)},
 							 {complex(-1,0)/a_mat[0][0],complex(-1,0)/a_mat[1][1],complex(0,0)}};
@@ -753,142 +863,94 @@ TIMESTAMP regulator::presync(TIMESTAMP t0)
 			*/
 			break;
 	}
-		
-	TIMESTAMP t1 = link_object::presync(t0);
-	
-	if (solver_method == SM_NR)
-	{
-		//Get matrices for NR
-		int jindex,kindex;
-		complex Ylefttemp[3][3];
-		complex Yto[3][3];
-		complex Yfrom[3][3];
-
-		//Pre-admittancized matrix
-		equalm(b_mat,Yto);
-
-		//Store value into YSto
-		for (jindex=0; jindex<3; jindex++)
-		{
-			for (kindex=0; kindex<3; kindex++)
-			{
-				YSto[jindex*3+kindex]=Yto[jindex][kindex];
-			}
-		}
-		
-		for (jindex=0; jindex<3; jindex++)
-		{
-			Ylefttemp[jindex][jindex] = Yto[jindex][jindex] * complex(1,0) / a_mat[jindex][jindex];
-			Yfrom[jindex][jindex]=Ylefttemp[jindex][jindex] * complex(1,0) / a_mat[jindex][jindex];
-		}
+}
 
+//Functionalized update of the NR admittances from the tap positions - returns true if a tap moved since the last update
+bool regulator::reg_NR_admittance_fxn(void)
+{
+	//Get matrices for NR
+	int jindex,kindex;
+	complex Ylefttemp[3][3];
+	complex Yto[3][3];
+	complex Yfrom[3][3];
 
-		//multiply(invratio,Yto,Ylefttemp);		//Scale from admittance by turns ratio
-		//multiply(invratio,Ylefttemp,Yfrom);
+	//Pre-admittancized matrix
+	equalm(b_mat,Yto);
 
-		//Store value into YSfrom
-		for (jindex=0; jindex<3; jindex++)
+	//Store value into YSto
+	for (jindex=0; jindex<3; jindex++)
+	{
+		for (kindex=0; kindex<3; kindex++)
 		{
-			for (kindex=0; kindex<3; kindex++)
-			{
-				YSfrom[jindex*3+kindex]=Yfrom[jindex][kindex];
-			}
+			YSto[jindex*3+kindex]=Yto[jindex][kindex];
 		}
+	}
+	
+	for (jindex=0; jindex<3; jindex++)
+	{
+		Ylefttemp[jindex][jindex] = Yto[jindex][jindex] * complex(1,0) / a_mat[jindex][jindex];
+		Yfrom[jindex][jindex]=Ylefttemp[jindex][jindex] * complex(1,0) / a_mat[jindex][jindex];
+	}
 
-		for (jindex=0; jindex<3; jindex++)
-		{
-			To_Y[jindex][jindex] = Yto[jindex][jindex] * complex(1,0) / a_mat[jindex][jindex];
-			From_Y[jindex][jindex]=Yfrom[jindex][jindex] * a_mat[jindex][jindex];
-		}
-		//multiply(invratio,Yto,To_Y);		//Incorporate turns ratio information into line's admittance matrix.
-		//multiply(voltage_ratio,Yfrom,From_Y); //Scales voltages to same "level" for GS //uncomment me
 
-		//Only perform update if a tap has changed.  Since the link calculations are replicated here and it directly
-		//accesses the NR memory space, this won't cause any issues.
-		if ((prev_tap[0] != tap[0]) || (prev_tap[1] != tap[1]) || (prev_tap[2] != tap[2]))	//Change has occurred
-		{
-			//Flag an update
-			LOCK_OBJECT(NR_swing_bus);	//Lock SWING since we'll be modifying this
-			NR_admit_change = true;
-			UNLOCK_OBJECT(NR_swing_bus);	//Unlock
+	//multiply(invratio,Yto,Ylefttemp);		//Scale from admittance by turns ratio
+	//multiply(invratio,Ylefttemp,Yfrom);
 
-			//Update our previous tap positions
-			prev_tap[0] = tap[0];
-			prev_tap[1] = tap[1];
-			prev_tap[2] = tap[2];
-		}
-	}
-
-	//General warnings for if we're at a railed tap limit
-	if (tap[0] == pConfig->raise_taps)
+	//Store value into YSfrom
+	for (jindex=0; jindex<3; jindex++)
 	{
-		phaseWarn='A';	//Just so troubleshoot is generic
-
-		gl_warning("Regulator %s has phase %c at the maximum tap value",OBJECTHDR(this)->name,phaseWarn);
-		/*  TROUBLESHOOT
-		The regulator has set its taps such that it is at the maximum setting.  This may indicate
-		a problem with settings, or your system.
-		*/
+		for (kindex=0; kindex<3; kindex++)
+		{
+			YSfrom[jindex*3+kindex]=Yfrom[jindex][kindex];
+		}
 	}
 
-	if (tap[1] == pConfig->raise_taps)
+	for (jindex=0; jindex<3; jindex++)
 	{
-		phaseWarn='B';	//Just so troubleshoot is generic
-
-		gl_warning("Regulator %s has phase %c at the maximum tap value",OBJECTHDR(this)->name,phaseWarn);
-		//Defined above
+		To_Y[jindex][jindex] = Yto[jindex][jindex] * complex(1,0) / a_mat[jindex][jindex];
+		From_Y[jindex][jindex]=Yfrom[jindex][jindex] * a_mat[jindex][jindex];
 	}
+	//multiply(invratio,Yto,To_Y);		//Incorporate turns ratio information into line's admittance matrix.
+	//multiply(voltage_ratio,Yfrom,From_Y); //Scales voltages to same "level" for GS //uncomment me
 
-	if (tap[2] == pConfig->raise_taps)
+	//See if a tap has changed
+	if ((prev_tap[0] != tap[0]) || (prev_tap[1] != tap[1]) || (prev_tap[2] != tap[2]))	//Change has occurred
 	{
-		phaseWarn='C';	//Just so troubleshoot is generic
+		//Update our previous tap positions
+		prev_tap[0] = tap[0];
+		prev_tap[1] = tap[1];
+		prev_tap[2] = tap[2];
 
-		gl_warning("Regulator %s has phase %c at the maximum tap value",OBJECTHDR(this)->name,phaseWarn);
-		//Defined above
+		return true;
 	}
 
-	if (tap[0] == -pConfig->lower_taps)
-	{
-		phaseWarn='A';	//Just so troubleshoot is generic
+	return false;
+}
 
-		gl_warning("Regulator %s has phase %c at the minimum tap value",OBJECTHDR(this)->name,phaseWarn);
-		/*  TROUBLESHOOT
-		The regulator has set its taps such that it is at the minimum setting.  This may indicate
-		a problem with settings, or your system.
-		*/
-	}
+//Discrete control loop step - re-runs the tap control on the solution just found, at the same timestamp
+//Returns true if a tap moved, so the system needs solving again
+bool regulator::reg_discrete_control_fxn(TIMESTAMP t0)
+{
+	int16 old_tap[3];
 
-	if (tap[1] == -pConfig->lower_taps)
-	{
-		phaseWarn='B';	//Just so troubleshoot is generic
+	old_tap[0] = tap[0];
+	old_tap[1] = tap[1];
+	old_tap[2] = tap[2];
 
-		gl_warning("Regulator %s has phase %c at the minimum tap value",OBJECTHDR(this)->name,phaseWarn);
-		//Defined above
-	}
+	reg_tap_fxn(t0);
 
-	if (tap[2] == -pConfig->lower_taps)
-	{
-		phaseWarn='C';	//Just so troubleshoot is generic
+	if ((old_tap[0] == tap[0]) && (old_tap[1] == tap[1]) && (old_tap[2] == tap[2]))	//Settled
+		return false;
 
-		gl_warning("Regulator %s has phase %c at the minimum tap value",OBJECTHDR(this)->name,phaseWarn);
-		//Defined above
-	}
-	if (offnominal_time && (t0 > next_time))
-	{
-		next_time = t0;
-	}
+	reg_matrix_fxn();
 
-	//Force a "reiteration" if we're checking voltage - consequence of this previously being in true pass of NR
-	if ((solver_method == SM_NR) && ((pConfig->Control == pConfig->OUTPUT_VOLTAGE) || (pConfig->Control == pConfig->REMOTE_NODE)) && (iteration_flag==false))
-	{
-		return t0;
-	}
+	//The SWING bus flags the admittance change itself - it is in its own sync, so it can't be locked here
+	if (solver_method == SM_NR)
+		reg_NR_admittance_fxn();
 
-	if (first_run_flag[0] < 1 || first_run_flag[1] < 1 || first_run_flag[2] < 1) return t1;
-	else if (t1 <= next_time) return t1;
-	else if (next_time != TS_NEVER) return -next_time; //soft return to next tap change
-	else return TS_NEVER;
+	return true;
 }
+
 TIMESTAMP regulator::postsync(TIMESTAMP t0)
 {
 	regulator_configuration *pConfig = OBJECTDATA(configuration, regulator_configuration);
@@ -74,6 +74,11 @@ public:
 	TIMESTAMP presync(TIMESTAMP t0);
 	TIMESTAMP postsync(TIMESTAMP t0);
 	int isa(char *classname);
+
+	void reg_tap_fxn(TIMESTAMP t0);				//Functionalized automatic tap control
+	void reg_matrix_fxn(void);					//Functionalized update of A and d from the tap positions
+	bool reg_NR_admittance_fxn(void);			//Functionalized update of the NR admittances from the tap positions
+	bool reg_discrete_control_fxn(TIMESTAMP t0);	//Discrete control loop step, run after each powerflow solution
 };
 
 #endif // _REGULATOR_H
@@ -2377,13 +2377,12 @@ void restoration::renewFaultLocation(BRANCHVERTICES *faultsection)
 // otherwise, return 0.a.
 int restoration::spanningTreeSearch(void)
 {
-	int idx, counter, preCounter, feederID, feeder_overloaded, k, tvi, startIdx, allocsize;
+	int idx, counter, feederID, allocsize, search_result;
 	int powerflow_result;
-	CHORDSET FCutSet, FCutSet_1, FCutSet_2, FCutSet_2_1, FCutSet_2_2, new_tie_swi;
+	CHORDSET FCutSet, FCutSet_1, FCutSet_2;
 	BRANCHVERTICES FCutSetentry, FCutSet_1entry, FCutSet_2entry;
-	BRANCHVERTICES SW_to_Open, SW_to_Open_1, SW_to_Open_2;
-	BRANCHVERTICES sec_swi_2entry;
-	bool feasible, swiInFeederBool;
+	CANDEXPAND expand_work;
+	bool feasible;
 	double overLoad;
 
 	//Initialize local variables -- just in case
@@ -2393,19 +2392,11 @@ int restoration::spanningTreeSearch(void)
 	FCutSet_1.data_2 = NULL;
 	FCutSet_2.data_1 = NULL;
 	FCutSet_2.data_2 = NULL;
-	FCutSet_2_1.data_1 = NULL;
-	FCutSet_2_1.data_2 = NULL;
-	FCutSet_2_2.data_1 = NULL;
-	FCutSet_2_2.data_2 = NULL;
-	new_tie_swi.data_1 = NULL;
-	new_tie_swi.data_2 = NULL;
 
 	//Feasibility flag - default to infeasible
 	feasible = false;
 
 	//Allocate chord sets -- make them maximally big
-	CHORDSETalloc(&FCutSet_2_2,tie_swi_2.maxSize);
-	CHORDSETalloc(&FCutSet_2_1,tie_swi_2.maxSize);
 	CHORDSETalloc(&FCutSet_2,tie_swi_2.maxSize);
 	CHORDSETalloc(&FCutSet_1,tie_swi_2.maxSize);
 	CHORDSETalloc(&FCutSet,tie_swi_2.maxSize);
@@ -2485,12 +2476,50 @@ int restoration::spanningTreeSearch(void)
 	candidateSwOpe_2.currSize = FCutSet_2.currSize;
 
 	// Search for spanning trees without duplication
+	//The powerflow of each candidate has to run serially -- modifyModel toggles the actual switch objects
+	//and solver_nr works on the one NR_busdata/NR_branchdata set.  The graph search that generates the
+	//children of a candidate only needs the topology, so it runs on a worker thread while the next
+	//candidate's powerflow is solved.  Children are still appended in candidate order, so the search
+	//visits exactly the same sequence as before.
+	expand_work.new_tie_swi.data_1 = NULL;
+	expand_work.new_tie_swi.data_2 = NULL;
+	expand_work.FCutSet_2.data_1 = NULL;
+	expand_work.FCutSet_2.data_2 = NULL;
+	expand_work.FCutSet_2_1.data_1 = NULL;
+	expand_work.FCutSet_2_1.data_2 = NULL;
+	expand_work.FCutSet_2_2.data_1 = NULL;
+	expand_work.FCutSet_2_2.data_2 = NULL;
+	expand_work.children.data_1 = NULL;
+	expand_work.children.data_2 = NULL;
+	expand_work.children.data_3 = NULL;
+	expand_work.children.data_4 = NULL;
+	expand_work.running = false;
+	expand_work.threaded = false;
+	expand_work.cancel = false;
+	expand_work.failed = false;
+	expand_work.owner = (void *)this;
+
+	CHORDSETalloc(&expand_work.new_tie_swi,tie_swi_2.currSize);
+	CHORDSETalloc(&expand_work.FCutSet_2,tie_swi_2.maxSize);
+	CHORDSETalloc(&expand_work.FCutSet_2_1,tie_swi_2.maxSize);
+	CHORDSETalloc(&expand_work.FCutSet_2_2,tie_swi_2.maxSize);
+	LOCSETalloc(&expand_work.children,(sec_swi_2.currSize > 0 ? sec_swi_2.currSize : 1)*tie_swi_2.maxSize);
+
 	counter = 0;	//Was 1 in the MATLAB, but it's an index
+	search_result = -1;	//Exhausted, unless something below says otherwise
 
-	while (counter < candidateSwOpe.currSize)
-	{
-		if (candidateSwOpe.data_5[counter] == 0)
+	//modifyModel, runPowerFlow and checkPF2 can throw -- the worker must be stopped before
+	//expand_work goes out of scope
+	try {
+		while ((counter < candidateSwOpe.currSize) || (expand_work.running == true))
 		{
+			//Out of known candidates -- the remaining ones are still being generated
+			if (counter >= candidateSwOpe.currSize)
+			{
+				finishExpansion(&expand_work);
+				continue;
+			}
+
 			//Adjustment from WSU code below - just run a powerflow
 			//If it fails, then modifyModel again (should de-toggle all of what was just toggled)
 
@@ -2507,8 +2536,9 @@ int restoration::spanningTreeSearch(void)
 				//See if it even worked -- if not, modifyModel again and set as a "false"
 				if (powerflow_result == -1)
 				{
-					return -2;	//Serious error occurred, so flag us as "really bad"
+					search_result = -2;	//Serious error occurred, so flag us as "really bad"
 					//basically, the state of the system may be corrupted, so any subsequent powerflows can't be trusted
+					break;
 				}
 				else if (powerflow_result == 0)
 				{
@@ -2535,7 +2565,7 @@ int restoration::spanningTreeSearch(void)
 						PowerflowRestore();
 					}
 				}
-	        
+
 			// If feasible restoration scheme is found
 			if (feasible == true)
 			{
@@ -2550,15 +2580,8 @@ int restoration::spanningTreeSearch(void)
 				}
 				//Default else -- "GridLAB-D" mode, just exit and go onward
 
-				//IdxSW = counter;
-				//Before exiting, free up some of our junk
-				CHORDSETfree(&FCutSet);
-				CHORDSETfree(&FCutSet_1);
-				CHORDSETfree(&FCutSet_2);
-				CHORDSETfree(&FCutSet_2_1);
-				CHORDSETfree(&FCutSet_2_2);
-
-				return counter;
+				search_result = counter;
+				break;
 			}
 
 			// If feasible restoration scheme is not found
@@ -2570,384 +2593,326 @@ int restoration::spanningTreeSearch(void)
 			candidateSwOpe_2.data_7[counter] = feederID;
 			candidateSwOpe_1.data_7[counter] = feederID;
 			candidateSwOpe.data_7[counter] = feederID;
-	        
-			// Form the graph after restoration
-			top_res->copy(top_sim_2);
-			top_res->deleteEdge(candidateSwOpe_2.data_1[counter],candidateSwOpe_2.data_2[counter]);
-			top_res->addEdge(candidateSwOpe_2.data_3[counter],candidateSwOpe_2.data_4[counter]);
-			top_res->BFS(s_ver_2);
-
-			// Form the tie switch list for new graph
-				//Allocate new_tie_swi -- just in case sizes change, this will realloc it (not quite as elegantly)
-				CHORDSETalloc(&new_tie_swi,tie_swi_2.currSize);
-
-			//Copy results in
-			memcpy(new_tie_swi.data_1,tie_swi_2.data_1,tie_swi_2.currSize*sizeof(int));
-			memcpy(new_tie_swi.data_2,tie_swi_2.data_2,tie_swi_2.currSize*sizeof(int));
-			new_tie_swi.currSize = tie_swi_2.currSize;
-
-			for (idx=0; idx<new_tie_swi.currSize; idx++)
+
+			if (candidateSwOpe.data_5[counter] != 0)
 			{
-				if (((new_tie_swi.data_1[idx]==candidateSwOpe_2.data_3[counter]) && (new_tie_swi.data_2[idx]==candidateSwOpe_2.data_4[counter])) || ((new_tie_swi.data_1[idx]==candidateSwOpe_2.data_4[counter]) && (new_tie_swi.data_2[idx]==candidateSwOpe_2.data_3[counter])))
+				//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+				//%%% If counter > 300, we can assume full restoration
+				//%%% is failed.
+				//Adjust this to the real size, to stop things from breaking horribly
+				if (counter >= (allocsize-1))
 				{
-					new_tie_swi.data_1[idx] = candidateSwOpe_2.data_1[counter];
-					new_tie_swi.data_2[idx] = candidateSwOpe_2.data_2[counter];
+					//If caught here, the stuff below should be correct, by default
+					//resObj.candidateSwOpe = resObj.candidateSwOpe(1:300,:);
+					//resObj.candidateSwOpe_1 = resObj.candidateSwOpe_1(1:300,:);
+					//resObj.candidateSwOpe_2 = resObj.candidateSwOpe_2(1:300,:);
+
+					//Pull in whatever was already being generated, so the partial results match a full search
+					finishExpansion(&expand_work);
+
+					//Send effectively, an error
+					search_result = -1;
+					break;
 				}
-			}
-			//
-			for (idx=0; idx<sec_swi_2.currSize; idx++)
-			{
-				// Open the sectionalizing switch
-				SW_to_Open_2.from_vert = sec_swi_2.data_1[idx];
-				SW_to_Open_2.to_vert = sec_swi_2.data_2[idx];
-
-				SW_to_Open.from_vert = sec_swi_map.data_1[idx];
-				SW_to_Open.to_vert = sec_swi_map.data_2[idx];
-
-				SW_to_Open_1.from_vert = sec_swi_map_1.data_1[idx];
-				SW_to_Open_1.to_vert = sec_swi_map_1.data_2[idx];
-	            
-				// If the switch to open is not in the overloaded
-				// feeder, move on to the next candidate switch.
-				feeder_overloaded = candidateSwOpe_2.data_7[counter];
-				swiInFeederBool = isSwiInFeeder(&SW_to_Open_2,feeder_overloaded);
-				if ((feeder_overloaded != 01) && (swiInFeederBool == false))
+				//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+				// If more than one feeder are overloaded OR
+				// one or more microgrids are overloaded OR
+				// move on to the next candidate switching operation
+				if (feederID == -1)
 				{
+					counter++;
 					continue;
 				}
-	            
-				// Fundamental cut set of the sectionalizing switch
-				sec_swi_2entry.from_vert = sec_swi_2.data_1[idx];
-				sec_swi_2entry.to_vert = sec_swi_2.data_2[idx];
-				top_sim_2->findFunCutSet(&tie_swi_2,&sec_swi_2entry,&FCutSet_2_1);
-				top_res->findFunCutSet(&new_tie_swi,&sec_swi_2entry,&FCutSet_2_2);
+			}
 
-				CHORDSETintersect(&FCutSet_2_1, &FCutSet_2_2, &FCutSet_2);
+			//Children of the previous candidate go in first, then start generating ours
+			finishExpansion(&expand_work);
+			startExpansion(&expand_work,counter);
 
-				for (k=0; k<FCutSet_2.currSize; k++)
-				{
-					//Pull the variables into BRANCHVERTICES
-					FCutSet_2entry.from_vert = FCutSet_2.data_1[k];
-					FCutSet_2entry.to_vert = FCutSet_2.data_2[k];
+			counter = counter + 1;
+		}
+	}
+	catch (...)
+	{
+		stopExpansion(&expand_work);
+		CHORDSETfree(&expand_work.new_tie_swi);
+		CHORDSETfree(&expand_work.FCutSet_2);
+		CHORDSETfree(&expand_work.FCutSet_2_1);
+		CHORDSETfree(&expand_work.FCutSet_2_2);
+		LOCSETfree(&expand_work.children);
+		throw;
+	}
 
-					mapTieSwi(&FCutSet_2entry,&FCutSetentry,&FCutSet_1entry);
+	//Anything still being generated is not needed -- prune it
+	stopExpansion(&expand_work);
 
-					//Store them back
-					FCutSet.data_1[k] = FCutSetentry.from_vert;
-					FCutSet.data_2[k] = FCutSetentry.to_vert;
-					FCutSet_1.data_1[k] = FCutSet_1entry.from_vert;
-					FCutSet_1.data_2[k] = FCutSet_1entry.to_vert;
-				}
+	//Before exiting, free up some of our junk
+	CHORDSETfree(&FCutSet);
+	CHORDSETfree(&FCutSet_1);
+	CHORDSETfree(&FCutSet_2);
+	CHORDSETfree(&expand_work.new_tie_swi);
+	CHORDSETfree(&expand_work.FCutSet_2);
+	CHORDSETfree(&expand_work.FCutSet_2_1);
+	CHORDSETfree(&expand_work.FCutSet_2_2);
+	LOCSETfree(&expand_work.children);
 
-				//Find offset
-				//All theoretically the same index (from earlier)
-				tvi=candidateSwOpe_2.currSize;
+	return search_result;
+}
 
-				// Save all candidate solutions -- these get appended to the previous ones (no overwritten)
-				for (k=0; k<FCutSet_2.currSize; k++)
-				{
-					//General error check
-					if ((tvi+k) >= candidateSwOpe.maxSize)
-					{
-						GL_THROW("Maximum size exceeded!");
-						//Add later
-					}
+//Worker thread entry for candidate expansion
+void *restoration::expansion_thread(void *arg)
+{
+	CANDEXPAND *work = (CANDEXPAND *)arg;
+	restoration *owner = (restoration *)work->owner;
 
-					candidateSwOpe_2.data_1[tvi+k]=SW_to_Open_2.from_vert;
-					candidateSwOpe_2.data_2[tvi+k]=SW_to_Open_2.to_vert;
-					candidateSwOpe_2.data_3[tvi+k]=FCutSet_2.data_1[k];
-					candidateSwOpe_2.data_4[tvi+k]=FCutSet_2.data_2[k];
-					candidateSwOpe_2.data_5[tvi+k]=counter;
-					candidateSwOpe_2.data_6[tvi+k]=0.0;
-					candidateSwOpe_2.data_7[tvi+k]=0;
-
-					candidateSwOpe_1.data_1[tvi+k]=SW_to_Open_1.from_vert;
-					candidateSwOpe_1.data_2[tvi+k]=SW_to_Open_1.to_vert;
-					candidateSwOpe_1.data_3[tvi+k]=FCutSet_1.data_1[k];
-					candidateSwOpe_1.data_4[tvi+k]=FCutSet_1.data_2[k];
-					candidateSwOpe_1.data_5[tvi+k]=counter;
-					candidateSwOpe_1.data_6[tvi+k]=0.0;
-					candidateSwOpe_1.data_7[tvi+k]=0;
-
-					candidateSwOpe.data_1[tvi+k]=SW_to_Open.from_vert;
-					candidateSwOpe.data_2[tvi+k]=SW_to_Open.to_vert;
-					candidateSwOpe.data_3[tvi+k]=FCutSet.data_1[k];
-					candidateSwOpe.data_4[tvi+k]=FCutSet.data_2[k];
-					candidateSwOpe.data_5[tvi+k]=counter;
-					candidateSwOpe.data_6[tvi+k]=0.0;
-					candidateSwOpe.data_7[tvi+k]=0;
-				}
+	gl_pool_release();
 
-				//Update the size pointers
-				tvi += FCutSet_2.currSize;
-				candidateSwOpe_2.currSize = tvi;
-				candidateSwOpe_1.currSize = tvi;
-				candidateSwOpe.currSize = tvi;
-			}
+	//Exceptions can't cross the thread -- flag it and let finishExpansion report it
+	try {
+		owner->expandCandidate(work);
+	}
+	catch (...)
+	{
+		work->failed = true;
+	}
+
+	return NULL;
+}
+
+//Hand the children search of a candidate off to the worker thread
+//Falls back to doing it in place if a thread can't be had
+void restoration::startExpansion(CANDEXPAND *work, int counter)
+{
+	work->counter = counter;
+	work->cancel = false;
+	work->failed = false;
+	work->children.currSize = 0;
+
+	work->threaded = (pthread_create(&work->thread,NULL,expansion_thread,(void *)work) == 0);
+	if (work->threaded == false)
+	{
+		try {
+			expandCandidate(work);
 		}
-		else
+		catch (...)
 		{
-			//Adjustment from WSU code below - just run a powerflow
-			//If it fails, then modifyModel again (should de-toggle all of what was just toggled)
-				//Perform the modification
-				modifyModel(counter);
-
-				// Run power flow
-				powerflow_result = runPowerFlow();
-				
-				//See if it even worked -- if not, modifyModel again and set as a "false"
-				if (powerflow_result == -1)
-				{
-					return -2;	//Serious error occurred, so flag us as "really bad"
-					//basically, the state of the system may be corrupted, so any subsequent powerflows can't be trusted
-				}
-				else if (powerflow_result == 0)
-				{
-					//Call the modify function again, to undo what we just did
-					modifyModel(counter);
+			work->failed = true;
+		}
+	}
+	work->running = true;	//Results are pending
+}
 
-					//Set us as invalid
-					feasible=false;
+//Cancel the worker and wait for it -- the children it found are not needed
+void restoration::stopExpansion(CANDEXPAND *work)
+{
+	work->cancel = true;
+	if (work->threaded == true)
+	{
+		pthread_join(work->thread,NULL);
+		work->threaded = false;
+	}
+	work->running = false;
+}
 
-					//Restore voltage for next pass
-					PowerflowRestore();
-				}
-				else	//Success!?
-				{
-					//Check results
-					checkPF2(&feasible, &overLoad, &feederID);
+//Wait for the worker and append the children it found to the candidate lists
+//Must be called in candidate order to keep the search sequence
+void restoration::finishExpansion(CANDEXPAND *work)
+{
+	int k, tvi, secidx;
+	BRANCHVERTICES FCutSetentry, FCutSet_1entry, FCutSet_2entry;
 
-					//Check feasible again -- if not feasible, undo the operations again
-					if (feasible==false)
-					{
-						modifyModel(counter);	//Undo it by calling it again
+	if (work->running == false)
+	{
+		return;
+	}
 
-						//Restore voltage for next pass
-						PowerflowRestore();
-					}
-				}
-	        
-			// If feasible restoration scheme is found
-			if (feasible == true)
-			{
-				//Check our desired "approach" on this -- see if we need to undo for the next section or not
-				if (stop_and_generate == true)
-				{
-					//Undo it by calling it again
-					modifyModel(counter);
+	if (work->threaded == true)
+	{
+		pthread_join(work->thread,NULL);
+		work->threaded = false;
+	}
+	work->running = false;
 
-					//Restore voltage for next pass
-					PowerflowRestore();
-				}
-				//Default else -- "GridLAB-D" mode, just exit and go onward
+	if (work->failed == true)
+	{
+		GL_THROW("Restoration: candidate switching search failed");
+		/*  TROUBLESHOOT
+		While searching for the next set of candidate switching operations, an error occurred in
+		the topology search.  Please try again.  If the error persists, please submit your code
+		and a bug report via the ticketing system.
+		*/
+	}
 
-				//IdxSW = counter;
-				//Before exiting, free up some of our junk
-				CHORDSETfree(&FCutSet);
-				CHORDSETfree(&FCutSet_1);
-				CHORDSETfree(&FCutSet_2);
-				CHORDSETfree(&FCutSet_2_1);
-				CHORDSETfree(&FCutSet_2_2);
+	//Find offset
+	//All theoretically the same index (from earlier)
+	tvi=candidateSwOpe_2.currSize;
 
-				return counter;
-			}
+	// Save all candidate solutions -- these get appended to the previous ones (no overwritten)
+	for (k=0; k<work->children.currSize; k++)
+	{
+		//General error check
+		if ((tvi+k) >= candidateSwOpe.maxSize)
+		{
+			GL_THROW("Maximum size exceeded!");
+			//Add later
+		}
 
-			// If feasible restoration scheme is not found
-			candidateSwOpe_2.data_6[counter] = overLoad;
-			candidateSwOpe_1.data_6[counter] = overLoad;
-			candidateSwOpe.data_6[counter] = overLoad;
+		secidx = work->children.data_1[k];
+
+		FCutSet_2entry.from_vert = work->children.data_2[k];
+		FCutSet_2entry.to_vert = work->children.data_3[k];
+
+		mapTieSwi(&FCutSet_2entry,&FCutSetentry,&FCutSet_1entry);
+
+		candidateSwOpe_2.data_1[tvi+k]=sec_swi_2.data_1[secidx];
+		candidateSwOpe_2.data_2[tvi+k]=sec_swi_2.data_2[secidx];
+		candidateSwOpe_2.data_3[tvi+k]=FCutSet_2entry.from_vert;
+		candidateSwOpe_2.data_4[tvi+k]=FCutSet_2entry.to_vert;
+		candidateSwOpe_2.data_5[tvi+k]=work->counter;
+		candidateSwOpe_2.data_6[tvi+k]=0.0;
+		candidateSwOpe_2.data_7[tvi+k]=0;
+
+		candidateSwOpe_1.data_1[tvi+k]=sec_swi_map_1.data_1[secidx];
+		candidateSwOpe_1.data_2[tvi+k]=sec_swi_map_1.data_2[secidx];
+		candidateSwOpe_1.data_3[tvi+k]=FCutSet_1entry.from_vert;
+		candidateSwOpe_1.data_4[tvi+k]=FCutSet_1entry.to_vert;
+		candidateSwOpe_1.data_5[tvi+k]=work->counter;
+		candidateSwOpe_1.data_6[tvi+k]=0.0;
+		candidateSwOpe_1.data_7[tvi+k]=0;
+
+		candidateSwOpe.data_1[tvi+k]=sec_swi_map.data_1[secidx];
+		candidateSwOpe.data_2[tvi+k]=sec_swi_map.data_2[secidx];
+		candidateSwOpe.data_3[tvi+k]=FCutSetentry.from_vert;
+		candidateSwOpe.data_4[tvi+k]=FCutSetentry.to_vert;
+		candidateSwOpe.data_5[tvi+k]=work->counter;
+		candidateSwOpe.data_6[tvi+k]=0.0;
+		candidateSwOpe.data_7[tvi+k]=0;
+	}
+
+	//Update the size pointers
+	tvi += work->children.currSize;
+	candidateSwOpe_2.currSize = tvi;
+	candidateSwOpe_1.currSize = tvi;
+	candidateSwOpe.currSize = tvi;
+}
 
-			candidateSwOpe_2.data_7[counter] = feederID;
-			candidateSwOpe_1.data_7[counter] = feederID;
-			candidateSwOpe.data_7[counter] = feederID;
+//Generate the children of a candidate switching operation - the graph half of the spanning tree search
+//Runs on the worker thread, so it only touches top_res, top_sim_2 (for the cut sets) and its own workspace
+//Candidate arrays are only read here, for entries that are already settled
+void restoration::expandCandidate(CANDEXPAND *work)
+{
+	int idx, k, counter, preCounter, startIdx, feeder_overloaded, feeder_skip;
+	bool swiInFeederBool;
+	BRANCHVERTICES SW_to_Open_2, sec_swi_2entry;
 
-			//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
-			//%%% If counter > 300, we can assume full restoration
-			//%%% is failed.
-			//Adjust this to the real size, to stop things from breaking horribly
-			if (counter >= (allocsize-1))
-			{
-				//If caught here, the stuff below should be correct, by default
-				//resObj.candidateSwOpe = resObj.candidateSwOpe(1:300,:);
-				//resObj.candidateSwOpe_1 = resObj.candidateSwOpe_1(1:300,:);
-				//resObj.candidateSwOpe_2 = resObj.candidateSwOpe_2(1:300,:);
-
-				//Before exiting, free up some of our junk
-				CHORDSETfree(&FCutSet);
-				CHORDSETfree(&FCutSet_1);
-				CHORDSETfree(&FCutSet_2);
-				CHORDSETfree(&FCutSet_2_1);
-				CHORDSETfree(&FCutSet_2_2);
-
-				//Send effectively, an error
-				return -1;
-			}
-			//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
-	        
-			// If more than one feeder are overloaded OR
-			// one or more microgrids are overloaded OR
-			// move on to the next candidate switching operation
-			if (feederID == -1)
-			{
-				counter++;
-				continue;
-			}
+	counter = work->counter;
+	work->children.currSize = 0;
 
-			// Form new graph
-			top_res->copy(top_sim_2);
-			top_res->deleteEdge(candidateSwOpe_2.data_1[counter],candidateSwOpe_2.data_2[counter]);
-			top_res->addEdge(candidateSwOpe_2.data_3[counter],candidateSwOpe_2.data_4[counter]);
+	// Form new graph
+	top_res->copy(top_sim_2);
+	top_res->deleteEdge(candidateSwOpe_2.data_1[counter],candidateSwOpe_2.data_2[counter]);
+	top_res->addEdge(candidateSwOpe_2.data_3[counter],candidateSwOpe_2.data_4[counter]);
 
-			preCounter = candidateSwOpe_2.data_5[counter];
-			while (preCounter != 0)
-			{
-				top_res->deleteEdge(candidateSwOpe_2.data_1[preCounter],candidateSwOpe_2.data_2[preCounter]);
-				top_res->addEdge(candidateSwOpe_2.data_3[preCounter],candidateSwOpe_2.data_4[preCounter]);
-				preCounter=candidateSwOpe_2.data_5[preCounter];
-			}
-			top_res->BFS(s_ver_2);
+	preCounter = candidateSwOpe_2.data_5[counter];
+	while (preCounter != 0)
+	{
+		top_res->deleteEdge(candidateSwOpe_2.data_1[preCounter],candidateSwOpe_2.data_2[preCounter]);
+		top_res->addEdge(candidateSwOpe_2.data_3[preCounter],candidateSwOpe_2.data_4[preCounter]);
+		preCounter=candidateSwOpe_2.data_5[preCounter];
+	}
+	top_res->BFS(s_ver_2);
 
-			// Form the tie switch list for new graph
-				//Allocate new_tie_swi -- just in case sizes change, this will realloc it (not quite as elegantly)
-				CHORDSETalloc(&new_tie_swi,tie_swi_2.currSize);
+	// Form the tie switch list for new graph
+	memcpy(work->new_tie_swi.data_1,tie_swi_2.data_1,tie_swi_2.currSize*sizeof(int));
+	memcpy(work->new_tie_swi.data_2,tie_swi_2.data_2,tie_swi_2.currSize*sizeof(int));
+	work->new_tie_swi.currSize = tie_swi_2.currSize;
 
-			//Copy results in
-			memcpy(new_tie_swi.data_1,tie_swi_2.data_1,tie_swi_2.currSize*sizeof(int));
-			memcpy(new_tie_swi.data_2,tie_swi_2.data_2,tie_swi_2.currSize*sizeof(int));
-			new_tie_swi.currSize = tie_swi_2.currSize;
+	for (idx=0; idx<work->new_tie_swi.currSize; idx++)
+	{
+		if (((work->new_tie_swi.data_1[idx]==candidateSwOpe_2.data_3[counter]) && (work->new_tie_swi.data_2[idx]==candidateSwOpe_2.data_4[counter])) || ((work->new_tie_swi.data_1[idx]==candidateSwOpe_2.data_4[counter]) && (work->new_tie_swi.data_2[idx]==candidateSwOpe_2.data_3[counter])))
+		{
+			work->new_tie_swi.data_1[idx] = candidateSwOpe_2.data_1[counter];
+			work->new_tie_swi.data_2[idx] = candidateSwOpe_2.data_2[counter];
+		}
+	}
 
-			for (idx=0; idx<new_tie_swi.currSize; idx++)
+	preCounter = candidateSwOpe_2.data_5[counter];
+	while (preCounter != 0)
+	{
+		for (idx=0; idx<work->new_tie_swi.currSize; idx++)
+		{
+			if (((work->new_tie_swi.data_1[idx]==candidateSwOpe_2.data_3[preCounter]) && (work->new_tie_swi.data_2[idx]==candidateSwOpe_2.data_4[preCounter])) || ((work->new_tie_swi.data_1[idx]==candidateSwOpe_2.data_4[preCounter]) && (work->new_tie_swi.data_2[idx]==candidateSwOpe_2.data_3[preCounter])))
 			{
-				if (((new_tie_swi.data_1[idx]==candidateSwOpe_2.data_3[counter]) && (new_tie_swi.data_2[idx]==candidateSwOpe_2.data_4[counter])) || ((new_tie_swi.data_1[idx]==candidateSwOpe_2.data_4[counter]) && (new_tie_swi.data_2[idx]==candidateSwOpe_2.data_3[counter])))
-				{
-					new_tie_swi.data_1[idx] = candidateSwOpe_2.data_1[counter];
-					new_tie_swi.data_2[idx] = candidateSwOpe_2.data_2[counter];
-				}
+				work->new_tie_swi.data_1[idx] = candidateSwOpe_2.data_1[preCounter];
+				work->new_tie_swi.data_2[idx] = candidateSwOpe_2.data_2[preCounter];
 			}
+		}
+		preCounter = candidateSwOpe_2.data_5[preCounter];
+	}
 
-			preCounter = candidateSwOpe_2.data_5[counter];
-			while (preCounter != 0)
-			{
-				for (idx=0; idx<new_tie_swi.currSize; idx++)
-				{
-					if (((new_tie_swi.data_1[idx]==candidateSwOpe_2.data_3[preCounter]) && (new_tie_swi.data_2[idx]==candidateSwOpe_2.data_4[preCounter])) || ((new_tie_swi.data_1[idx]==candidateSwOpe_2.data_4[preCounter]) && (new_tie_swi.data_2[idx]==candidateSwOpe_2.data_3[preCounter])))
-					{
-						new_tie_swi.data_1[idx] = candidateSwOpe_2.data_1[preCounter];
-						new_tie_swi.data_2[idx] = candidateSwOpe_2.data_2[preCounter];
-					}
-				}
-				preCounter = candidateSwOpe_2.data_5[preCounter];
-			}
-			//
-			for (idx=0; idx<sec_swi_2.currSize; idx++)
+	//First-level candidates search every sectionalizing switch (and kept the MATLAB "01" feeder test)
+	//Later ones only search the switches after the one they opened, to avoid duplicate trees
+	if (candidateSwOpe_2.data_5[counter] == 0)
+	{
+		startIdx = 0;
+		feeder_skip = 1;
+	}
+	else
+	{
+		startIdx = sec_swi_2.currSize;
+		feeder_skip = 0;
+
+		for (idx=0; idx<sec_swi_2.currSize; idx++)
+		{
+			if (((sec_swi_2.data_1[idx]==candidateSwOpe_2.data_1[counter]) && (sec_swi_2.data_2[idx]==candidateSwOpe_2.data_2[counter])) || ((sec_swi_2.data_1[idx]==candidateSwOpe_2.data_2[counter]) && (sec_swi_2.data_2[idx]==candidateSwOpe_2.data_1[counter])))
 			{
-				if (((sec_swi_2.data_1[idx]==candidateSwOpe_2.data_1[counter]) && (sec_swi_2.data_2[idx]==candidateSwOpe_2.data_2[counter])) || ((sec_swi_2.data_1[idx]==candidateSwOpe_2.data_2[counter]) && (sec_swi_2.data_2[idx]==candidateSwOpe_2.data_1[counter])))
-				{
-					startIdx = idx + 1;
-					break;
-				}
+				startIdx = idx + 1;
+				break;
 			}
-			//
-			for (idx=startIdx; idx<sec_swi_2.currSize; idx++)
-			{
-				// Open the sectionalizing switch
-				SW_to_Open_2.from_vert = sec_swi_2.data_1[idx];
-				SW_to_Open_2.to_vert = sec_swi_2.data_2[idx];
-				SW_to_Open.from_vert = sec_swi_map.data_1[idx];
-				SW_to_Open.to_vert = sec_swi_map.data_2[idx];
-				SW_to_Open_1.from_vert = sec_swi_map_1.data_1[idx];
-				SW_to_Open_1.to_vert = sec_swi_map_1.data_2[idx];
-
-				// If the switch to open is not in the overloaded
-				// feeder, move on to the next candidate switch.
-				feeder_overloaded = candidateSwOpe_2.data_7[counter];
-
-				swiInFeederBool = isSwiInFeeder(&SW_to_Open_2,feeder_overloaded);
-				if ((feeder_overloaded != 0) && (swiInFeederBool == false))
-				{
-					continue;
-				}
+		}
+	}
 
-				// Fundamental cut set of the sectionalizing switch
-				sec_swi_2entry.from_vert = sec_swi_2.data_1[idx];
-				sec_swi_2entry.to_vert = sec_swi_2.data_2[idx];
-				top_sim_2->findFunCutSet(&tie_swi_2,&sec_swi_2entry,&FCutSet_2_1);
-				top_res->findFunCutSet(&new_tie_swi,&sec_swi_2entry,&FCutSet_2_2);
+	feeder_overloaded = candidateSwOpe_2.data_7[counter];
 
-				CHORDSETintersect(&FCutSet_2_1, &FCutSet_2_2, &FCutSet_2);
+	for (idx=startIdx; idx<sec_swi_2.currSize; idx++)
+	{
+		//A feasible plan was already found -- nobody wants these
+		if (work->cancel == true)
+		{
+			work->children.currSize = 0;
+			return;
+		}
 
-				for (k=0; k<FCutSet_2.currSize; k++)
-				{
-					//Pull the variables into BRANCHVERTICES
-					FCutSet_2entry.from_vert = FCutSet_2.data_1[k];
-					FCutSet_2entry.to_vert = FCutSet_2.data_2[k];
+		// Open the sectionalizing switch
+		SW_to_Open_2.from_vert = sec_swi_2.data_1[idx];
+		SW_to_Open_2.to_vert = sec_swi_2.data_2[idx];
 
-					mapTieSwi(&FCutSet_2entry,&FCutSetentry,&FCutSet_1entry);
+		// If the switch to open is not in the overloaded
+		// feeder, move on to the next candidate switch.
+		swiInFeederBool = isSwiInFeeder(&SW_to_Open_2,feeder_overloaded);
+		if ((feeder_overloaded != feeder_skip) && (swiInFeederBool == false))
+		{
+			continue;
+		}
 
-					//Store them back
-					FCutSet.data_1[k] = FCutSetentry.from_vert;
-					FCutSet.data_2[k] = FCutSetentry.to_vert;
-					FCutSet_1.data_1[k] = FCutSet_1entry.from_vert;
-					FCutSet_1.data_2[k] = FCutSet_1entry.to_vert;
-				}
+		// Fundamental cut set of the sectionalizing switch
+		sec_swi_2entry.from_vert = sec_swi_2.data_1[idx];
+		sec_swi_2entry.to_vert = sec_swi_2.data_2[idx];
+		top_sim_2->findFunCutSet(&tie_swi_2,&sec_swi_2entry,&work->FCutSet_2_1);
+		top_res->findFunCutSet(&work->new_tie_swi,&sec_swi_2entry,&work->FCutSet_2_2);
 
-				//Find offset
-				//All theoretically the same index (from earlier)
-				tvi=candidateSwOpe_2.currSize;
+		CHORDSETintersect(&work->FCutSet_2_1, &work->FCutSet_2_2, &work->FCutSet_2);
 
-				// Save all candidate solutions -- these get appended to the previous ones (no overwritten)
-				for (k=0; k<FCutSet_2.currSize; k++)
-				{
-					//General error check
-					if ((tvi+k) >= candidateSwOpe.maxSize)
-					{
-						GL_THROW("Maximum size exceeded!");
-						//Add later
-					}
-
-					candidateSwOpe_2.data_1[tvi+k]=SW_to_Open_2.from_vert;
-					candidateSwOpe_2.data_2[tvi+k]=SW_to_Open_2.to_vert;
-					candidateSwOpe_2.data_3[tvi+k]=FCutSet_2.data_1[k];
-					candidateSwOpe_2.data_4[tvi+k]=FCutSet_2.data_2[k];
-					candidateSwOpe_2.data_5[tvi+k]=counter;
-					candidateSwOpe_2.data_6[tvi+k]=0.0;
-					candidateSwOpe_2.data_7[tvi+k]=0;
-
-					candidateSwOpe_1.data_1[tvi+k]=SW_to_Open_1.from_vert;
-					candidateSwOpe_1.data_2[tvi+k]=SW_to_Open_1.to_vert;
-					candidateSwOpe_1.data_3[tvi+k]=FCutSet_1.data_1[k];
-					candidateSwOpe_1.data_4[tvi+k]=FCutSet_1.data_2[k];
-					candidateSwOpe_1.data_5[tvi+k]=counter;
-					candidateSwOpe_1.data_6[tvi+k]=0.0;
-					candidateSwOpe_1.data_7[tvi+k]=0;
-
-					candidateSwOpe.data_1[tvi+k]=SW_to_Open.from_vert;
-					candidateSwOpe.data_2[tvi+k]=SW_to_Open.to_vert;
-					candidateSwOpe.data_3[tvi+k]=FCutSet.data_1[k];
-					candidateSwOpe.data_4[tvi+k]=FCutSet.data_2[k];
-					candidateSwOpe.data_5[tvi+k]=counter;
-					candidateSwOpe.data_6[tvi+k]=0.0;
-					candidateSwOpe.data_7[tvi+k]=0;
-				}
-
-				//Update the size pointers
-				tvi += FCutSet_2.currSize;
-				candidateSwOpe_2.currSize = tvi;
-				candidateSwOpe_1.currSize = tvi;
-				candidateSwOpe.currSize = tvi;
-			}
+		//Store them for the append -- mapping back to the other topologies happens there
+		for (k=0; k<work->FCutSet_2.currSize; k++)
+		{
+			work->children.data_1[work->children.currSize] = idx;
+			work->children.data_2[work->children.currSize] = work->FCutSet_2.data_1[k];
+			work->children.data_3[work->children.currSize] = work->FCutSet_2.data_2[k];
+			work->children.currSize++;
 		}
-		counter = counter + 1;
 	}
-
-	//Before exiting, free up some of our junk
-	CHORDSETfree(&FCutSet);
-	CHORDSETfree(&FCutSet_1);
-	CHORDSETfree(&FCutSet_2);
-	CHORDSETfree(&FCutSet_2_1);
-	CHORDSETfree(&FCutSet_2_2);
-
-	return -1;
 }
 
 //Function to replicate MATLAB intersect capability
@@ -4,6 +4,8 @@
 #ifndef _RESTORATION_H
 #define _RESTORATION_H
 
+#include <pthread.h>
+
 #include "powerflow.h"
 #include "powerflow_library.h"
 
@@ -51,6 +53,23 @@ typedef struct s_BranchVertices {
 	int to_vert;	//To vertex
 } BRANCHVERTICES;
 
+//Candidate expansion work item -- the children of one candidate are searched on a worker
+//thread while the next candidate's powerflow is being solved
+typedef struct s_CandExpand {
+	int counter;			//Candidate being expanded
+	CHORDSET new_tie_swi;	//Tie switches of the restored topology
+	CHORDSET FCutSet_2;		//Intersected fundamental cut set
+	CHORDSET FCutSet_2_1;	//Cut set in top_sim_2
+	CHORDSET FCutSet_2_2;	//Cut set in top_res
+	LOCSET children;		//Candidates found - sectionalizing switch index (1), cut-set edge (2 & 3)
+	volatile bool cancel;	//Early exit - a feasible plan was found, so these children will never be used
+	bool running;			//Expansion results are pending
+	bool threaded;			//Expansion runs on the worker thread (needs a join)
+	bool failed;			//Worker hit an exception
+	pthread_t thread;		//Worker thread handle
+	void *owner;			//restoration object doing the search
+} CANDEXPAND;
+
 //ChainNode class
 class Chain
 {
@@ -306,6 +325,11 @@ private:
 	void mapTieSwi(BRANCHVERTICES *tSW_2, BRANCHVERTICES *tSW, BRANCHVERTICES *tSW_1);
 	void renewFaultLocation(BRANCHVERTICES *faultsection);
 	int spanningTreeSearch(void);
+	void expandCandidate(CANDEXPAND *work);
+	void startExpansion(CANDEXPAND *work, int counter);
+	void finishExpansion(CANDEXPAND *work);
+	void stopExpansion(CANDEXPAND *work);
+	static void *expansion_thread(void *arg);
 	void CHORDSETintersect(CHORDSET *set_1, CHORDSET *set_2, CHORDSET *intersect);
 	void modifyModel(int counter);
 	int runPowerFlow(void);
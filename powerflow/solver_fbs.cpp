@@ -0,0 +1,531 @@
+/* $Id
+ * Forward-back sweep array solver
+ *
+ * The radial tree below the FBS SWING bus is flattened once into an array of buses, in
+ * depth-first order so every subtree is a contiguous range, and an array of branches that
+ * hold copies of the link ABCD matrices.  solver_fbs then runs the backward and forward
+ * sweeps over those arrays until the voltages settle, instead of spreading one sweep over
+ * the sync/postsync passes of every node and link.  The objects only read back the
+ * voltages and currents it leaves behind.
+ *
+ * Subtrees hanging off the trunk are independent, so on large systems they are swept on
+ * the core pool threads.  Every bus pulls the currents of its children in a fixed order, so the
+ * answer does not depend on the number of threads.
+ */
+
+#include "solver_fbs.h"
+#include "node.h"
+#include "link.h"
+
+#define FBS_MINBUSES 1024		/**< fewest buses worth sweeping on the pool threads */
+#define FBS_TASKSPERTHREAD 4	/**< subtrees made per thread, so uneven subtrees still balance */
+
+/** Subtree swept by one pool thread **/
+typedef struct s_fbs_task {
+	unsigned int first, last;	/**< buses [first,last) */
+	bool converged;				/**< cleared when a bus of the subtree has not converged (forward sweep) */
+} FBSTASK;
+
+static FBSBUS *FBS_bus = NULL;				//Buses, depth-first from the root
+static unsigned int FBS_bus_count = 0;
+static FBSBRANCH *FBS_branch = NULL;		//Links feeding the buses
+static unsigned int FBS_branch_count = 0;
+static unsigned int *FBS_child = NULL;		//Children of each bus (FBSBUS::child_first/child_count index this)
+static unsigned int *FBS_trunk = NULL;		//Buses not in any subtree task, depth-first
+static unsigned int FBS_trunk_count = 0;
+static FBSTASK *FBS_task = NULL;			//Subtrees swept on the pool threads
+static unsigned int FBS_task_count = 0;
+static unsigned int FBS_thread_count = 1;
+
+static OBJECT *FBS_root = NULL;				//SWING bus the arrays were built below (NULL until built)
+static bool FBS_declined = false;			//Tree could not be flattened - the objects sweep it themselves
+
+/** Backward sweep of one bus - total its current injection and the current it draws from upstream **/
+static void FBS_backward_bus(unsigned int index)
+{
+	FBSBUS *bus = FBS_bus + index;
+	complex *I = bus->I;
+	unsigned int k;
+	char row;
+
+	//Currents drawn by the buses below us, then our own loads
+	I[0] = I[1] = I[2] = 0.0;
+	for (k=bus->child_first; k<bus->child_first+bus->child_count; k++)
+	{
+		FBSBUS *child = FBS_bus + FBS_child[k];
+		I[0] += child->I_up[0];
+		I[1] += child->I_up[1];
+		I[2] += child->I_up[2];
+	}
+	bus->pNode->FBS_node_sync_fxn(bus->obj);
+
+	if (bus->branch >= 0)	//Fed by a link
+	{
+		FBSBRANCH *branch = FBS_branch + bus->branch;
+
+		if (branch->closed)
+		{
+			for (row=0; row<3; row++)
+			{
+				bus->I_up[row] =
+					branch->c[row][0] * bus->V[0] +
+					branch->c[row][1] * bus->V[1] +
+					branch->c[row][2] * bus->V[2] +
+					branch->d[row][0] * I[0] +
+					branch->d[row][1] * I[1] +
+					branch->d[row][2] * I[2];
+				branch->pLink->current_in[row] = bus->I_up[row];
+			}
+		}
+		else
+			bus->I_up[0] = bus->I_up[1] = bus->I_up[2] = 0.0;
+	}
+	else	//Child node (or the root) - the whole injection goes to the parent
+	{
+		bus->I_up[0] = I[0];
+		bus->I_up[1] = I[1];
+		bus->I_up[2] = I[2];
+	}
+}
+
+/** Forward sweep of one bus - update its voltage from its parent's
+	@return true if the voltage moved no more than the bus's maximum_voltage_error
+ **/
+static bool FBS_forward_bus(unsigned int index)
+{
+	FBSBUS *bus = FBS_bus + index;
+	complex *V = bus->V, *I = bus->I, *Vp, V_prev[3];
+	char row;
+
+	if (bus->parent < 0)	//Root voltage is fixed
+		return true;
+
+	Vp = FBS_bus[bus->parent].V;
+	V_prev[0] = V[0];
+	V_prev[1] = V[1];
+	V_prev[2] = V[2];
+
+	if (bus->branch >= 0)	//Fed by a link
+	{
+		FBSBRANCH *branch = FBS_branch + bus->branch;
+
+		if (branch->closed)
+		{
+			complex V_new[3];
+			for (row=0; row<3; row++)
+			{
+				V_new[row] =
+					branch->A[row][0] * Vp[0] +
+					branch->A[row][1] * Vp[1] +
+					branch->A[row][2] * Vp[2] -
+					branch->B[row][0] * I[0] -
+					branch->B[row][1] * I[1] -
+					branch->B[row][2] * I[2];
+			}
+			V[0] = V_new[0];
+			V[1] = V_new[1];
+			V[2] = V_new[2];
+		}
+	}
+	else	//Child node - copy the parent voltage
+	{
+		V[0] = Vp[0];
+		V[1] = Vp[1];
+		V[2] = Vp[2];
+	}
+
+	//Update the "other" voltages the loads use
+	if (bus->split)
+	{
+		bus->Vd[0] = V[0] + V[1];	//V12
+		bus->Vd[1] = V[1] - V[2];	//V2N
+		bus->Vd[2] = V[0] - V[2];	//V1N
+	}
+	else
+	{
+		bus->Vd[0] = V[0] - V[1];	//AB
+		bus->Vd[1] = V[1] - V[2];	//BC
+		bus->Vd[2] = V[2] - V[0];	//CA
+	}
+
+	return ((V_prev[0]-V[0]).Mag() + (V_prev[1]-V[1]).Mag() + (V_prev[2]-V[2]).Mag()) <= bus->pNode->maximum_voltage_error;
+}
+
+/** Sweeps the subtrees [first,last) - the pool task data is non-NULL for the backward sweep **/
+static TIMESTAMP FBS_sweep_tasks(TPTASK *pool_task, unsigned int first, unsigned int last, unsigned int thread)
+{
+	unsigned int task, index;
+
+	for (task=first; task<last; task++)
+	{
+		if (pool_task->data != NULL)	//Bottom of the subtree up
+		{
+			for (index=FBS_task[task].last; index>FBS_task[task].first; index--)
+				FBS_backward_bus(index-1);
+		}
+		else	//Top of the subtree down
+		{
+			FBS_task[task].converged = true;
+			for (index=FBS_task[task].first; index<FBS_task[task].last; index++)
+			{
+				if (FBS_forward_bus(index) == false)
+					FBS_task[task].converged = false;
+			}
+		}
+	}
+	return TS_NEVER;
+}
+
+/** Sweeps all the subtree tasks on the pool threads
+	@return false if a bus of the subtrees has not converged (forward sweep)
+ **/
+static bool FBS_run_tasks(bool backward)
+{
+	TPTASK sweep, *run = &sweep;
+	unsigned int task;
+
+	memset(&sweep,0,sizeof(sweep));
+	sweep.name = backward ? "FBS backward sweep" : "FBS forward sweep";
+	sweep.call = FBS_sweep_tasks;
+	sweep.data = backward ? (void *)FBS_task : NULL;
+	sweep.n_items = FBS_task_count;
+	sweep.grain = 1;
+	gl_pool_run(&run,1);
+
+	if (backward)
+		return true;
+	for (task=0; task<FBS_task_count; task++)
+	{
+		if (FBS_task[task].converged == false)
+			return false;
+	}
+	return true;
+}
+
+/** Releases the system arrays **/
+static void FBS_free(void)
+{
+	gl_free(FBS_bus);
+	gl_free(FBS_branch);
+	gl_free(FBS_child);
+	gl_free(FBS_trunk);
+	gl_free(FBS_task);
+	FBS_bus = NULL;
+	FBS_branch = NULL;
+	FBS_child = NULL;
+	FBS_trunk = NULL;
+	FBS_task = NULL;
+	FBS_bus_count = FBS_branch_count = FBS_trunk_count = FBS_task_count = 0;
+}
+
+/** Flattens the radial tree below the root into the bus and branch arrays.  Links hang from
+	their from node and parent their to node under FBS, and child nodes hang from their parent
+	node, so the tree follows the downstream edges out of the root.
+	@return false if the tree cannot be swept from arrays (the objects then sweep it themselves)
+ **/
+static bool FBS_build(OBJECT *root)
+{
+	FINDLIST *list;
+	OBJECT *obj = NULL, *down_obj, **edge_node, **edge_link, **stack_node, **stack_link;
+	unsigned int n_objects = 0, n_nodes = 0, n_links = 0, n_edges = 0, n_stack = 0;
+	unsigned int *edge_first, *edge_count, *stack_parent, index, k, target;
+
+	if (require_voltage_control == true)	//Sources are checked between passes, which the array sweep skips
+	{
+		gl_warning("FBS array solver does not support require_voltage_control - the objects will sweep the system");
+		/*  TROUBLESHOOT
+		With require_voltage_control set, nodes without a voltage source are zeroed during the postsync pass.  The FBS
+		array solver sweeps the system inside one call, so it leaves those systems to the object-by-object sweep.
+		*/
+		return false;
+	}
+
+	if ((root->parent != NULL) && (gl_object_isa(root->parent,"node","powerflow") || gl_object_isa(root->parent,"link","powerflow")))
+	{
+		gl_warning("FBS array solver: SWING bus %s is not at the top of its tree - the objects will sweep the system",root->name?root->name:"Unknown");
+		/*  TROUBLESHOOT
+		The SWING bus of a forward-back sweep system is fed by another powerflow object, so it is not the root of a radial
+		tree.  The FBS array solver leaves such systems to the object-by-object sweep.
+		*/
+		return false;
+	}
+
+	//Count the objects and the downstream edges (link from->to, and parent node->child node)
+	list = gl_find_objects(FL_NEW,FT_MODULE,SAME,"powerflow",FT_END);
+	if (list == NULL)
+		return false;
+	while ((obj=gl_find_next(list,obj)) != NULL)
+	{
+		if (obj->id >= n_objects)
+			n_objects = obj->id+1;
+		if (gl_object_isa(obj,"capacitor","powerflow"))	//Capacitor controls switch between the object passes
+		{
+			gl_warning("FBS array solver: capacitor %s switches on the object passes - the objects will sweep the system",obj->name?obj->name:"Unknown");
+			/*  TROUBLESHOOT
+			Capacitor control decisions (time delays, dwell times, and the phase-by-phase switching order) are made on the
+			intermediate passes of the object-by-object sweep.  The FBS array solver converges the system inside one call,
+			so systems with capacitors are left to the object-by-object sweep to keep their switching behavior unchanged.
+			*/
+			gl_free(list);
+			return false;
+		}
+		if (gl_object_isa(obj,"link","powerflow"))
+		{
+			n_links++;
+			n_edges++;
+		}
+		else if (gl_object_isa(obj,"node","powerflow"))
+		{
+			n_nodes++;
+			if ((obj->parent != NULL) && gl_object_isa(obj->parent,"node","powerflow"))
+				n_edges++;
+		}
+	}
+	if (root->id >= n_objects)
+		n_objects = root->id+1;
+
+	//Downstream edges of each object, by object id
+	edge_first = (unsigned int *)gl_malloc(n_objects*sizeof(unsigned int));
+	edge_count = (unsigned int *)gl_malloc(n_objects*sizeof(unsigned int));
+	edge_node = (OBJECT **)gl_malloc((n_edges+1)*sizeof(OBJECT *));
+	edge_link = (OBJECT **)gl_malloc((n_edges+1)*sizeof(OBJECT *));
+	stack_node = (OBJECT **)gl_malloc((n_edges+1)*sizeof(OBJECT *));
+	stack_link = (OBJECT **)gl_malloc((n_edges+1)*sizeof(OBJECT *));
+	stack_parent = (unsigned int *)gl_malloc((n_edges+1)*sizeof(unsigned int));
+	FBS_bus = (FBSBUS *)gl_malloc((n_nodes+1)*sizeof(FBSBUS));
+	FBS_branch = (FBSBRANCH *)gl_malloc((n_links+1)*sizeof(FBSBRANCH));
+	FBS_child = (unsigned int *)gl_malloc((n_nodes+1)*sizeof(unsigned int));
+	FBS_trunk = (unsigned int *)gl_malloc((n_nodes+1)*sizeof(unsigned int));
+	FBS_task = (FBSTASK *)gl_malloc((n_nodes+1)*sizeof(FBSTASK));
+
+	if ((edge_first == NULL) || (edge_count == NULL) || (edge_node == NULL) || (edge_link == NULL) || (stack_node == NULL) || (stack_link == NULL) || (stack_parent == NULL) || (FBS_bus == NULL) || (FBS_branch == NULL) || (FBS_child == NULL) || (FBS_trunk == NULL) || (FBS_task == NULL))
+	{
+		GL_THROW("FBS array solver: unable to allocate the system arrays");
+		/*  TROUBLESHOOT
+		While flattening the system for the forward-back sweep array solver, an attempt to allocate memory
+		failed.  Please try again.  If the error persists, please submit your code and a bug report via the trac website.
+		*/
+	}
+
+	memset(edge_count,0,n_objects*sizeof(unsigned int));
+	while ((obj=gl_find_next(list,obj)) != NULL)
+	{
+		if (gl_object_isa(obj,"link","powerflow"))
+			edge_count[OBJECTDATA(obj,link_object)->from->id]++;
+		else if (gl_object_isa(obj,"node","powerflow") && (obj->parent != NULL) && gl_object_isa(obj->parent,"node","powerflow"))
+			edge_count[obj->parent->id]++;
+	}
+	for (index=0, k=0; index<n_objects; index++)
+	{
+		edge_first[index] = k;
+		k += edge_count[index];
+		edge_count[index] = 0;
+	}
+	while ((obj=gl_find_next(list,obj)) != NULL)
+	{
+		OBJECT *up_obj = NULL;
+
+		if (gl_object_isa(obj,"link","powerflow"))
+		{
+			link_object *pLink = OBJECTDATA(obj,link_object);
+			up_obj = pLink->from;
+			edge_node[edge_first[up_obj->id]+edge_count[up_obj->id]] = pLink->to;
+			edge_link[edge_first[up_obj->id]+edge_count[up_obj->id]] = obj;
+		}
+		else if (gl_object_isa(obj,"node","powerflow") && (obj->parent != NULL) && gl_object_isa(obj->parent,"node","powerflow"))
+		{
+			up_obj = obj->parent;
+			edge_node[edge_first[up_obj->id]+edge_count[up_obj->id]] = obj;
+			edge_link[edge_first[up_obj->id]+edge_count[up_obj->id]] = NULL;
+		}
+
+		if (up_obj != NULL)
+			edge_count[up_obj->id]++;
+	}
+	gl_free(list);
+
+	//Depth-first from the root, so each subtree ends up contiguous
+	FBS_bus_count = FBS_branch_count = 0;
+	stack_node[0] = root;
+	stack_link[0] = NULL;
+	stack_parent[0] = 0;
+	n_stack = 1;
+	while (n_stack > 0)
+	{
+		FBSBUS *bus;
+
+		n_stack--;
+		obj = stack_node[n_stack];
+
+		//Every bus has exactly one way in - its link (which must parent it) or its parent node
+		if ((FBS_bus_count >= n_nodes) || ((stack_link[n_stack] != NULL) && (obj->parent != stack_link[n_stack])) || !gl_object_isa(obj,"node","powerflow"))
+		{
+			gl_warning("FBS array solver: %s is not fed radially - the objects will sweep the system",obj->name?obj->name:"Unknown");
+			/*  TROUBLESHOOT
+			While flattening the system below the SWING bus, the FBS array solver found a node that is reached
+			more than once, or that is not parented by the link feeding it.  The system is not radial, so the
+			object-by-object sweep is used instead (and may not give a proper answer either).  Consider the
+			Newton-Raphson solver for such systems.
+			*/
+			break;
+		}
+
+		bus = FBS_bus + FBS_bus_count;
+		memset(bus,0,sizeof(FBSBUS));
+		bus->obj = obj;
+		bus->parent = (FBS_bus_count == 0) ? -1 : (int)stack_parent[n_stack];
+		bus->branch = -1;
+		if (stack_link[n_stack] != NULL)
+		{
+			bus->branch = FBS_branch_count;
+			FBS_branch[FBS_branch_count].obj = stack_link[n_stack];
+			FBS_branch[FBS_branch_count].pLink = OBJECTDATA(stack_link[n_stack],link_object);
+			FBS_branch_count++;
+		}
+
+		//Push the downstream edges last to first, so they come off in order
+		for (k=edge_count[obj->id]; k>0; k--)
+		{
+			down_obj = edge_node[edge_first[obj->id]+k-1];
+			stack_node[n_stack] = down_obj;
+			stack_link[n_stack] = edge_link[edge_first[obj->id]+k-1];
+			stack_parent[n_stack] = FBS_bus_count;
+			n_stack++;
+		}
+		FBS_bus_count++;
+	}
+
+	gl_free(edge_first);
+	gl_free(edge_count);
+	gl_free(edge_node);
+	gl_free(edge_link);
+	gl_free(stack_node);
+	gl_free(stack_link);
+	gl_free(stack_parent);
+
+	if (n_stack > 0)	//Not radial
+	{
+		FBS_free();
+		return false;
+	}
+
+	//Child lists, in bus order - count, offset, then fill
+	for (index=1; index<FBS_bus_count; index++)
+		FBS_bus[FBS_bus[index].parent].child_count++;
+	for (index=0, k=0; index<FBS_bus_count; index++)
+	{
+		FBS_bus[index].child_first = k;
+		k += FBS_bus[index].child_count;
+		FBS_bus[index].child_count = 0;
+	}
+	for (index=1; index<FBS_bus_count; index++)
+	{
+		FBSBUS *parent = FBS_bus + FBS_bus[index].parent;
+		FBS_child[parent->child_first+parent->child_count] = index;
+		parent->child_count++;
+	}
+
+	//Subtree sizes - children always come after their parent
+	for (index=FBS_bus_count; index>0; index--)
+	{
+		FBS_bus[index-1].subtree++;
+		if (index > 1)
+			FBS_bus[FBS_bus[index-1].parent].subtree += FBS_bus[index-1].subtree;
+	}
+
+	//Split off the subtrees the pool threads sweep; the rest is the trunk
+	FBS_thread_count = gl_pool_threadcount();
+
+	FBS_trunk_count = FBS_task_count = 0;
+	target = ((FBS_thread_count > 1) && (FBS_bus_count >= FBS_MINBUSES)) ? FBS_bus_count/(FBS_thread_count*FBS_TASKSPERTHREAD) : 0;
+	for (index=0; index<FBS_bus_count; )
+	{
+		if ((index > 0) && (FBS_bus[index].subtree <= target))
+		{
+			FBS_task[FBS_task_count].first = index;
+			FBS_task[FBS_task_count].last = index+FBS_bus[index].subtree;
+			FBS_task_count++;
+			index += FBS_bus[index].subtree;
+		}
+		else
+			FBS_trunk[FBS_trunk_count++] = index++;
+	}
+
+	//Point the entries at the objects and flag the objects as swept from here
+	for (index=0; index<FBS_bus_count; index++)
+		OBJECTDATA(FBS_bus[index].obj,node)->FBS_populate(FBS_bus+index,index);
+	for (index=0; index<FBS_branch_count; index++)
+		FBS_branch[index].pLink->FBS_branch_reference = index;
+
+	gl_verbose("FBS array solver: %d buses and %d links below %s, %d subtrees swept on up to %d threads",FBS_bus_count,FBS_branch_count,root->name?root->name:"Unknown",FBS_task_count,FBS_thread_count);
+	return true;
+}
+
+/** Forward-back sweep of the radial tree below the SWING bus \p root, repeated until every bus
+	voltage moves less than its maximum_voltage_error.  The tree is flattened on the first call.
+	@return the number of sweeps, the negative of FBS_iteration_limit if it did not converge, or
+	0 if the tree cannot be swept from arrays (the objects then sweep it themselves)
+ **/
+int64 solver_fbs(OBJECT *root)
+{
+	unsigned int index;
+	char row, col;
+	int64 iteration;
+	bool converged;
+
+	if (FBS_root != root)
+	{
+		if ((FBS_root != NULL) || (FBS_declined == true))	//Only the first SWING bus is swept from arrays
+			return 0;
+
+		if (FBS_build(root) == false)
+		{
+			FBS_declined = true;
+			return 0;
+		}
+		FBS_root = root;
+	}
+
+	//Taps and switch states can change between passes, so refresh the matrix copies
+	for (index=0; index<FBS_branch_count; index++)
+	{
+		FBSBRANCH *branch = FBS_branch + index;
+		link_object *pLink = branch->pLink;
+
+		for (row=0; row<3; row++)
+		{
+			for (col=0; col<3; col++)
+			{
+				branch->A[row][col] = pLink->A_mat[row][col];
+				branch->B[row][col] = pLink->B_mat[row][col];
+				branch->c[row][col] = pLink->c_mat[row][col];
+				branch->d[row][col] = pLink->d_mat[row][col];
+			}
+		}
+		branch->closed = (pLink->is_closed() != 0);
+	}
+
+	for (iteration=1; iteration<=FBS_iteration_limit; iteration++)
+	{
+		//Backward sweep - the subtrees, then the trunk from the bottom up
+		if (FBS_task_count > 0)
+			FBS_run_tasks(true);
+		for (index=FBS_trunk_count; index>0; index--)
+			FBS_backward_bus(FBS_trunk[index-1]);
+
+		//Forward sweep - the trunk from the top down, then the subtrees
+		converged = true;
+		for (index=0; index<FBS_trunk_count; index++)
+		{
+			if (FBS_forward_bus(FBS_trunk[index]) == false)
+				converged = false;
+		}
+		if ((FBS_task_count > 0) && (FBS_run_tasks(false) == false))
+			converged = false;
+
+		if (converged == true)
+			return iteration;
+	}
+
+	return -FBS_iteration_limit;
+}
@@ -0,0 +1,41 @@
+/* $Id
+ * Forward-back sweep array solver
+ */
+
+#ifndef _SOLVER_FBS
+#define _SOLVER_FBS
+
+#include "complex.h"
+#include "object.h"
+
+class node;
+class link_object;
+
+typedef struct {
+	node *pNode;			///< node object - its FBS_node_sync_fxn adds the load currents
+	OBJECT *obj;			///< Link to original object header
+	complex *V;				///< bus voltage
+	complex *Vd;			///< bus voltage differences (line-line, or 12/2N/1N for split-phase)
+	complex *I;				///< bus current injection (loads, child nodes and downstream links)
+	bool split;				///< split-phase bus - changes how Vd is formed
+	int parent;				///< index of the upstream bus (-1 for the root)
+	int branch;				///< index of the branch feeding this bus (-1 for the root and child nodes)
+	unsigned int child_first;	///< first entry of this bus in the child list
+	unsigned int child_count;	///< number of buses directly downstream of this bus
+	unsigned int subtree;	///< number of buses in the subtree rooted here (preorder, so they are [index,index+subtree))
+	complex I_up[3];		///< current this bus draws from its parent (link current_in, or the child node injection)
+} FBSBUS;
+
+typedef struct {
+	link_object *pLink;		///< link object
+	OBJECT *obj;			///< Link to original object header
+	bool closed;			///< link is closed - carries current back and sets the to bus voltage
+	complex A[3][3];		///< voltage of the to bus from the from bus voltage
+	complex B[3][3];		///< voltage drop from the to bus current
+	complex c[3][3];		///< from current from the to bus voltage
+	complex d[3][3];		///< from current from the to bus current
+} FBSBRANCH;
+
+int64 solver_fbs(OBJECT *root);
+
+#endif
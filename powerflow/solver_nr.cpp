@@ -34,6 +34,7 @@ Initialization after returning to service?
 
 
 #include "solver_nr.h"
+#include <pthread.h>
 
 #define MT // this enables multithreaded SuperLU
 
@@ -46,12 +47,42 @@ Initialization after returning to service?
 /* access to module global variables */
 #include "powerflow.h"
 
-//Generic solver variables
-NR_SOLVER_VARS matrices_LU;
+//LU working storage of one system (NR_SOLVER_STRUCT::LU) - generic and superLU variables
+typedef struct s_nr_lu {
+	NR_SOLVER_VARS matrices_LU;
+	int *perm_c, *perm_r;
+	SuperMatrix A_LU,B_LU;
+} NR_LU;
+
+//superLU keeps some factorization state in statics, so only one system is factored at a time
+static pthread_mutex_t NR_lu_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** Range of buses handled by one pool task chunk during a Newton-Raphson bus pass **/
+typedef struct s_nr_range {
+	void (*kernel)(struct s_nr_range *);	/**< per-bus pass run over the range */
+	unsigned int first, last;				/**< buses [first,last) */
+	BUSDATA *bus;
+	BRANCHDATA *branch;
+	NR_SOLVER_STRUCT *powerflow_values;
+	NRSOLVERMODE powerflow_type;
+	bool swing_is_a_swing;
+	int64 Iteration;
+	double *sol_LU;
+	complex aval, avalsq;
+	bool swing_converged;					/**< cleared when a generator bus of the range is not balanced yet */
+	bool newiter;							/**< set when a bus of the range has not converged */
+	double Maxmismatch;						/**< largest voltage update in the range */
+	const char *fault;						/**< failure message, NULL if the pass succeeded */
+	unsigned int fault_bus;					/**< bus the failure occurred on */
+} NR_RANGE;
+
+#define NR_MINBUSES 2048	/**< fewest buses in a range of its own */
+#define NR_MAXRANGES 64		/**< most ranges a bus pass is split into */
+
+/* GL_THROW cannot unwind a pool thread, so a pass records its failure and
+   NR_run_ranges throws it once all the ranges are back */
+#define NR_RANGE_FAIL(MSG) { range->fault = MSG; range->fault_bus = indexer; return; }
 
-//SuperLU variables
-int *perm_c, *perm_r;
-SuperMatrix A_LU,B_LU;
 
 //External solver global
 void *ext_solver_glob_vars;
@@ -221,4715 +252,5386 @@ void sparse_tonr(SPARSE* sm, NR_SOLVER_VARS *matrices_LU)
 	}
 }
 
-/** Newton-Raphson solver
-	Solves a power flow problem using the Newton-Raphson method
-	
-	@return n=0 on failure to complete a single iteration, 
-	n>0 to indicate success after n interations, or 
-	n<0 to indicate failure after n iterations
- **/
-int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count, BRANCHDATA *branch, NR_SOLVER_STRUCT *powerflow_values, NRSOLVERMODE powerflow_type , NR_MESHFAULT_IMPEDANCE *mesh_imped_vals, bool *bad_computations)
+/** Specified load (PL and QL) of each bus in the range **/
+static void NR_range_loads(NR_RANGE *range)
 {
-	//Internal iteration counter - just NR limits
-	int64 Iteration;
-
-	//File pointer for debug outputs
-	FILE *FPoutVal;
-
-	//A matrix size variable
-	unsigned int size_Amatrix;
+	BUSDATA *bus = range->bus;
+	NR_SOLVER_STRUCT *powerflow_values = range->powerflow_values;
+	unsigned int indexer;
+	char jindex, temp_index, temp_index_b;
+	double tempPbus, tempQbus;
+	complex undeltacurr[3], delta_current[3], voltageDel[3], temp_current[3], temp_store[3];
+	complex adjusted_constant_current[6], adjust_temp_nominal_voltage[6];
+	double adjust_temp_voltage_mag[6];
+	double adjust_nominal_voltage_val, adjust_nominal_voltaged_val;
 
-	//Voltage mismatch tracking variable
-	double Maxmismatch;
+	for (indexer=range->first; indexer<range->last; indexer++)
+	{
+		if ((bus[indexer].phases & 0x08) == 0x08)	//Delta connected node
+		{
+			//Populate the values for constant current -- deltamode different right now (all same in future?)
+			if (*bus[indexer].dynamics_enabled == true)
+			{
+				//Create nominal magnitudes
+				adjust_nominal_voltage_val = bus[indexer].volt_base * sqrt(3.0);
+
+				//Create the nominal voltage vectors
+				adjust_temp_nominal_voltage[0].SetPolar(adjust_nominal_voltage_val,PI/6.0);
+				adjust_temp_nominal_voltage[1].SetPolar(adjust_nominal_voltage_val,-1.0*PI/2.0);
+				adjust_temp_nominal_voltage[2].SetPolar(adjust_nominal_voltage_val,5.0*PI/6.0);
+
+				//Compute delta voltages
+				voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
+				voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
+				voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
+
+				//Get magnitudes of all
+				adjust_temp_voltage_mag[0] = voltageDel[0].Mag();
+				adjust_temp_voltage_mag[1] = voltageDel[1].Mag();
+				adjust_temp_voltage_mag[2] = voltageDel[2].Mag();
+
+				//Start adjustments - AB
+				if ((bus[indexer].I[0] != 0.0) && (adjust_temp_voltage_mag[0] != 0.0))
+				{
+					//calculate new value
+					adjusted_constant_current[0] = ~(adjust_temp_nominal_voltage[0] * ~bus[indexer].I[0] * adjust_temp_voltage_mag[0] / (voltageDel[0] * adjust_nominal_voltage_val));
+				}
+				else
+				{
+					adjusted_constant_current[0] = 0.0;
+				}
 
-	//Saturation mismatch tracking variable
-	bool SaturationMismatchPresent;
-	int func_result_val;
+				//Start adjustments - BC
+				if ((bus[indexer].I[1] != 0.0) && (adjust_temp_voltage_mag[1] != 0.0))
+				{
+					//calculate new value
+					adjusted_constant_current[1] = ~(adjust_temp_nominal_voltage[1] * ~bus[indexer].I[1] * adjust_temp_voltage_mag[1] / (voltageDel[1] * adjust_nominal_voltage_val));
+				}
+				else
+				{
+					adjusted_constant_current[1] = 0.0;
+				}
 
-	//Phase collapser variable
-	unsigned char phase_worka, phase_workb, phase_workc, phase_workd, phase_worke;
+				//Start adjustments - CA
+				if ((bus[indexer].I[2] != 0.0) && (adjust_temp_voltage_mag[2] != 0.0))
+				{
+					//calculate new value
+					adjusted_constant_current[2] = ~(adjust_temp_nominal_voltage[2] * ~bus[indexer].I[2] * adjust_temp_voltage_mag[2] / (voltageDel[2] * adjust_nominal_voltage_val));
+				}
+				else
+				{
+					adjusted_constant_current[2] = 0.0;
+				}
 
-	//Temporary calculation variables
-	double tempIcalcReal, tempIcalcImag;
-	double tempPbus; //tempPbus store the temporary value of active power load at each bus
-	double tempQbus; //tempQbus store the temporary value of reactive power load at each bus
+				//See if we have any "different children"
+				if ((bus[indexer].phases & 0x10) == 0x10)
+				{
+					//Create nominal magnitudes
+					adjust_nominal_voltage_val = bus[indexer].volt_base;
 
-	//Miscellaneous index variable
-	unsigned int indexer, tempa, tempb, jindexer, kindexer;
-	char jindex, kindex;
-	char temp_index, temp_index_b;
-	unsigned int temp_index_c;
+					//Create the nominal voltage vectors
+					adjust_temp_nominal_voltage[3].SetPolar(bus[indexer].volt_base,0.0);
+					adjust_temp_nominal_voltage[4].SetPolar(bus[indexer].volt_base,-2.0*PI/3.0);
+					adjust_temp_nominal_voltage[5].SetPolar(bus[indexer].volt_base,2.0*PI/3.0);
 
-	//Working matrix for admittance collapsing/determinations
-	complex tempY[3][3];
+					//Get magnitudes of all
+					adjust_temp_voltage_mag[3] = bus[indexer].V[0].Mag();
+					adjust_temp_voltage_mag[4] = bus[indexer].V[1].Mag();
+					adjust_temp_voltage_mag[5] = bus[indexer].V[2].Mag();
 
-	//Working matrix for mesh fault impedance storage, prior to "reconstruction"
-	double temp_z_store[6][6];
+					//Start adjustments - A
+					if ((bus[indexer].extra_var[6] != 0.0) && (adjust_temp_voltage_mag[3] != 0.0))
+					{
+						//calculate new value
+						adjusted_constant_current[3] = ~(adjust_temp_nominal_voltage[3] * ~bus[indexer].extra_var[6] * adjust_temp_voltage_mag[3] / (bus[indexer].V[0] * adjust_nominal_voltage_val));
+					}
+					else
+					{
+						adjusted_constant_current[3] = 0.0;
+					}
 
-	//Miscellaneous flag variables
-	bool Full_Mat_A, Full_Mat_B, proceed_flag;
+					//Start adjustments - B
+					if ((bus[indexer].extra_var[7] != 0.0) && (adjust_temp_voltage_mag[4] != 0.0))
+					{
+						//calculate new value
+						adjusted_constant_current[4] = ~(adjust_temp_nominal_voltage[4] * ~bus[indexer].extra_var[7] * adjust_temp_voltage_mag[4] / (bus[indexer].V[1] * adjust_nominal_voltage_val));
+					}
+					else
+					{
+						adjusted_constant_current[4] = 0.0;
+					}
 
-	//Iteration flag
-	bool newiter;
+					//Start adjustments - C
+					if ((bus[indexer].extra_var[8] != 0.0) && (adjust_temp_voltage_mag[5] != 0.0))
+					{
+						//calculate new value
+						adjusted_constant_current[5] = ~(adjust_temp_nominal_voltage[5] * ~bus[indexer].extra_var[8] * adjust_temp_voltage_mag[5] / (bus[indexer].V[2] * adjust_nominal_voltage_val));
+					}
+					else
+					{
+						adjusted_constant_current[5] = 0.0;
+					}
+				}
+				else	//Nope
+				{
+					//Set to zero, just cause
+					adjusted_constant_current[3] = 0.0;
+					adjusted_constant_current[4] = 0.0;
+					adjusted_constant_current[5] = 0.0;
+				}
+			}
+			else	//"Normal" modes -- handle traditionally
+			{
+				adjusted_constant_current[0] = bus[indexer].I[0];
+				adjusted_constant_current[1] = bus[indexer].I[1];
+				adjusted_constant_current[2] = bus[indexer].I[2];
 
-	//Deltamode pass flag - changes how SWING buses are handled
-	//Multiple SWING-bus attached generators may cause issues, but no good way to detect
-	bool swing_is_a_swing;
+				//See if we have different children too
+				if ((bus[indexer].phases & 0x10) == 0x10)
+				{
+					//Store them too
+					adjusted_constant_current[3] = bus[indexer].extra_var[6];
+					adjusted_constant_current[4] = bus[indexer].extra_var[7];
+					adjusted_constant_current[5] = bus[indexer].extra_var[8];
+				}
+				else	//Nope, just zero this for now
+				{
+					adjusted_constant_current[3] = 0.0;
+					adjusted_constant_current[4] = 0.0;
+					adjusted_constant_current[5] = 0.0;
+				}
+			}//End adjustment code
 
-	//Deltamode initial dynamics run - swing convergence flag (symmetry)
-	bool swing_converged;
+			//Delta components - populate according to what is there
+			if ((bus[indexer].phases & 0x06) == 0x06)	//Check for AB
+			{
+				//Voltage calculations
+				voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
 
-	//Deltamode intermediate variables
-	complex temp_complex_0, temp_complex_1, temp_complex_2, temp_complex_3, temp_complex_4, temp_complex_5;
-	complex aval, avalsq;
+				//Power - convert to a current (uses less iterations this way)
+				delta_current[0] = (voltageDel[0] == 0) ? 0 : ~(bus[indexer].S[0]/voltageDel[0]);
 
-	//Temporary size variable
-	char temp_size, temp_size_b, temp_size_c;
+				//Convert delta connected load to appropriate Wye
+				delta_current[0] += voltageDel[0] * (bus[indexer].Y[0]);
+			}
+			else
+			{
+				//Zero values - they shouldn't be used anyhow
+				voltageDel[0] = 0.0;
+				delta_current[0] = 0.0;
+			}
 
-	//Temporary admittance variables
-	complex Temp_Ad_A[3][3];
-	complex Temp_Ad_B[3][3];
+			if ((bus[indexer].phases & 0x03) == 0x03)	//Check for BC
+			{
+				//Voltage calculations
+				voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
 
-	//Temporary load calculation variables
-	complex undeltacurr[3];
-	complex delta_current[3], voltageDel[3];
-	complex temp_current[3], temp_power[3], temp_store[3];
-	complex adjusted_constant_current[6];
-	complex adjust_temp_nominal_voltage[6];
-	double adjust_temp_voltage_mag[6];
-	double adjust_nominal_voltage_val, adjust_nominal_voltaged_val;
+				//Power - convert to a current (uses less iterations this way)
+				delta_current[1] = (voltageDel[1] == 0) ? 0 : ~(bus[indexer].S[1]/voltageDel[1]);
 
-	//DV checking array
-	complex DVConvCheck[3];
-	double CurrConvVal;
+				//Convert delta connected load to appropriate Wye
+				delta_current[1] += voltageDel[1] * (bus[indexer].Y[1]);
+			}
+			else
+			{
+				//Zero unused
+				voltageDel[1] = 0.0;
+				delta_current[1] = 0.0;
+			}
 
-	//Miscellaneous counter tracker
-	unsigned int index_count = 0;
+			if ((bus[indexer].phases & 0x05) == 0x05)	//Check for CA
+			{
+				//Voltage calculations
+				voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
 
-	//Miscellaneous working variable
-	double work_vals_double_0, work_vals_double_1,work_vals_double_2,work_vals_double_3,work_vals_double_4;
-	char work_vals_char_0;
+				//Power - convert to a current (uses less iterations this way)
+				delta_current[2] = (voltageDel[2] == 0) ? 0 : ~(bus[indexer].S[2]/voltageDel[2]);
 
-	//SuperLU variables
-	SuperMatrix L_LU,U_LU;
-	NCformat *Astore;
-	DNformat *Bstore;
-	int nnz, info;
-	unsigned int m,n;
-	double *sol_LU;
+				//Convert delta connected load to appropriate Wye
+				delta_current[2] += voltageDel[2] * (bus[indexer].Y[2]);
+			}
+			else
+			{
+				//Zero unused
+				voltageDel[2] = 0.0;
+				delta_current[2] = 0.0;
+			}
+			
+			//Convert delta-current into a phase current, where appropriate - reuse temp variable
+			//Everything will be accumulated into the "current" field for ease (including differents)
+			if ((bus[indexer].phases & 0x04) == 0x04)	//Has a phase A
+			{
+				undeltacurr[0]=(adjusted_constant_current[0]+delta_current[0])-(adjusted_constant_current[2]+delta_current[2]);
 
-	//Spare notation variable - for output
-	SP_E *temp_element;
-	int row, col;
-	double value;
-	
-#ifndef MT
-	superlu_options_t options;	//Additional variables for sequential superLU
-	SuperLUStat_t stat;
-#endif
+				//Check for "different" children and apply them, as well
+				if ((bus[indexer].phases & 0x10) == 0x10)	//We do, so they must be Wye-connected
+				{
+					//Power values
+					undeltacurr[0] += (bus[indexer].V[0] == 0) ? 0 : ~(bus[indexer].extra_var[0]/bus[indexer].V[0]);
 
-	//Ensure bad computations flag is set first
-	*bad_computations = false;
+					//Shunt values
+					undeltacurr[0] += bus[indexer].extra_var[3]*bus[indexer].V[0];
 
-	//Determine special circumstances of SWING bus -- do we want it to truly participate right
-	if (powerflow_type != PF_NORMAL)
-	{
-		if (powerflow_type == PF_DYNCALC)	//Parse the list -- anything that is a swing and a generator, deflag it out of principle (and to make it work right)
-		{
-			//Set the master swing flag
-			swing_is_a_swing = false;
+					//Current values
+					undeltacurr[0] += adjusted_constant_current[3];
+				}
+			}
+			else
+			{
+				//Zero it, just in case
+				undeltacurr[0] = 0.0;
+			}
 
-			//Check the buses
-			for (indexer=0; indexer<bus_count; indexer++)
+			if ((bus[indexer].phases & 0x02) == 0x02)	//Has a phase B
 			{
-				//See if we're a swing-flagged bus
-				if ((bus[indexer].type > 1) && (bus[indexer].swing_functions_enabled == true))
+				undeltacurr[1]=(adjusted_constant_current[1]+delta_current[1])-(adjusted_constant_current[0]+delta_current[0]);
+
+				//Check for "different" children and apply them, as well
+				if ((bus[indexer].phases & 0x10) == 0x10)	//We do, so they must be Wye-connected
 				{
-					//See if we're "generator ready"
-					if ((*bus[indexer].dynamics_enabled==true) && (bus[indexer].full_Y != NULL) && (bus[indexer].DynCurrent != NULL))
-					{
-						//Deflag us back to "PQ" status
-						bus[indexer].swing_functions_enabled = false;
-					}
+					//Power values
+					undeltacurr[1] += (bus[indexer].V[1] == 0) ? 0 : ~(bus[indexer].extra_var[1]/bus[indexer].V[1]);
+
+					//Shunt values
+					undeltacurr[1] += bus[indexer].extra_var[4]*bus[indexer].V[1];
+
+					//Current values
+					undeltacurr[1] += adjusted_constant_current[4];
 				}
-				//Default else -- normal bus
-			}//End bus traversion loop
-		}//Handle running dynamics differently
-		else	//Must be PF_DYNINIT
-		{
-			//Flag us as true, initially
-			swing_is_a_swing = true;
-		}
-	}//End not normal
-	else	//Must be normal
-	{
-		swing_is_a_swing = true;	//Flag as a swing, even though this shouldn't do anything
-	}
+			}
+			else
+			{
+				//Zero it, just in case
+				undeltacurr[1] = 0.0;
+			}
 
-	//Populate aval, if necessary
-	if (powerflow_type == PF_DYNINIT)
-	{
-		//Conversion variables - 1@120-deg
-		aval = complex(-0.5,(sqrt(3.0)/2.0));
-		avalsq = aval*aval;	//squared value is used a couple places too
-	}
-	else	//Zero it, just in case something uses it (what would???)
-	{
-		aval = 0.0;
-		avalsq = 0.0;
-	}
 
-	if (matrix_solver_method==MM_EXTERN)
-	{
-		//Call the initialization routine
-		ext_solver_glob_vars = ((void *(*)(void *))(LUSolverFcns.ext_init))(ext_solver_glob_vars);
+			if ((bus[indexer].phases & 0x01) == 0x01)	//Has a phase C
+			{
+				undeltacurr[2]=(adjusted_constant_current[2]+delta_current[2])-(adjusted_constant_current[1]+delta_current[1]);
 
-		//Make sure it worked (allocation check)
-		if (ext_solver_glob_vars==NULL)
-		{
-			GL_THROW("External LU matrix solver failed to allocate memory properly!");
-			/*  TROUBLESHOOT
-			While attempting to allocate memory for the external LU solver, an error occurred.
-			Please try again.  If the error persists, ensure your external LU solver is behaving correctly
-			and coordinate with their development team as necessary.
-			*/
-		}
-	}
+				//Check for "different" children and apply them, as well
+				if ((bus[indexer].phases & 0x10) == 0x10)		//We do, so they must be Wye-connected
+					{
+					//Power values
+					undeltacurr[2] += (bus[indexer].V[2] == 0) ? 0 : ~(bus[indexer].extra_var[2]/bus[indexer].V[2]);
 
-	if (NR_admit_change)	//If an admittance update was detected, fix it
-	{
-		//Build the diagnoal elements of the bus admittance matrix - this should only happen once no matter what
-		if (powerflow_values->BA_diag == NULL)
-		{
-			powerflow_values->BA_diag = (Bus_admit *)gl_malloc(bus_count *sizeof(Bus_admit));   //BA_diag store the location and value of diagonal elements of Bus Admittance matrix
+					//Shunt values
+					undeltacurr[2] += bus[indexer].extra_var[5]*bus[indexer].V[2];
 
-			//Make sure it worked
-			if (powerflow_values->BA_diag == NULL)
+					//Current values
+					undeltacurr[2] += adjusted_constant_current[5];
+				}
+			}
+			else
 			{
-				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
-				/*  TROUBLESHOOT
-				During the allocation stage of the NR algorithm, one of the matrices failed to be allocated.
-				Please try again and if this bug persists, submit your code and a bug report using the trac
-				website.
-				*/
+				//Zero it, just in case
+				undeltacurr[2] = 0.0;
 			}
-		}
-		
-		for (indexer=0; indexer<bus_count; indexer++) // Construct the diagonal elements of Bus admittance matrix.
-		{
-			//Determine the size we need
-			if ((bus[indexer].phases & 0x80) == 0x80)	//Split phase
-				powerflow_values->BA_diag[indexer].size = 2;
-			else										//Other cases, figure out how big they are
+
+			//Provide updates to relevant phases
+			//only compute and store phases that exist (make top heavy)
+			temp_index = -1;
+			temp_index_b = -1;
+			
+			for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
 			{
-				phase_worka = 0;
-				for (jindex=0; jindex<3; jindex++)		//Accumulate number of phases
+				switch(bus[indexer].phases & 0x07) {
+					case 0x01:	//C
+						{
+							temp_index=0;
+							temp_index_b=2;
+							break;
+						}
+					case 0x02:	//B
+						{
+							temp_index=0;
+							temp_index_b=1;
+							break;
+						}
+					case 0x03:	//BC
+						{
+							if (jindex==0)	//B
+							{
+								temp_index=0;
+								temp_index_b=1;
+							}
+							else			//C
+							{
+								temp_index=1;
+								temp_index_b=2;
+							}
+							break;
+						}
+					case 0x04:	//A
+						{
+							temp_index=0;
+							temp_index_b=0;
+							break;
+						}
+					case 0x05:	//AC
+						{
+							if (jindex==0)	//A
+							{
+								temp_index=0;
+								temp_index_b=0;
+							}
+							else			//C
+							{
+								temp_index=1;
+								temp_index_b=2;
+							}
+							break;
+						}
+					case 0x06:	//AB
+					case 0x07:	//ABC
+						{
+							temp_index=jindex;
+							temp_index_b=jindex;
+							break;
+						}
+					default:
+						break;
+				}//end case
+
+				if ((temp_index==-1) || (temp_index_b==-1))
 				{
-					phase_worka += ((bus[indexer].phases & (0x01 << jindex)) >> jindex);
+					NR_RANGE_FAIL("NR: A scheduled power update element failed.");
+					//Defined below
 				}
-				powerflow_values->BA_diag[indexer].size = phase_worka;
-			}
 
-			//Ensure the admittance matrix is zeroed
-			for (jindex=0; jindex<3; jindex++)
+				//Real power calculations
+				tempPbus = (undeltacurr[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Re() + (undeltacurr[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Im();	// Real power portion of Constant current component multiply the magnitude of bus voltage
+				bus[indexer].PL[temp_index] = tempPbus;	//Real power portion - all is current based
+
+				//Reactive load calculations
+				tempQbus = (undeltacurr[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Im() - (undeltacurr[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Re();	// Reactive power portion of Constant current component multiply the magnitude of bus voltage
+				bus[indexer].QL[temp_index] = tempQbus;	//Reactive power portion - all is current based
+				
+			}//End phase traversion
+		}//end delta connected
+		else if ((bus[indexer].phases & 0x80) == 0x80)	//Split-phase connected node
+		{
+			//Convert it all back to current (easiest to handle)
+			//Get V12 first
+			voltageDel[0] = bus[indexer].V[0] + bus[indexer].V[1];
+
+			//Start with the currents (just put them in)
+			temp_current[0] = bus[indexer].I[0];
+			temp_current[1] = bus[indexer].I[1];
+			temp_current[2] = *bus[indexer].extra_var;	//Current12 is not part of the standard current array
+
+			//Add in deltamode unrotated, if necessary
+			if ((bus[indexer].prerot_I[2] != 0.0) && (*bus[indexer].dynamics_enabled == true))
+				temp_current[2] += bus[indexer].prerot_I[2];
+
+			//Now add in power contributions
+			temp_current[0] += bus[indexer].V[0] == 0.0 ? 0.0 : ~(bus[indexer].S[0]/bus[indexer].V[0]);
+			temp_current[1] += bus[indexer].V[1] == 0.0 ? 0.0 : ~(bus[indexer].S[1]/bus[indexer].V[1]);
+			temp_current[2] += voltageDel[0] == 0.0 ? 0.0 : ~(bus[indexer].S[2]/voltageDel[0]);
+
+			//Last, but not least, admittance/impedance contributions
+			temp_current[0] += bus[indexer].Y[0]*bus[indexer].V[0];
+			temp_current[1] += bus[indexer].Y[1]*bus[indexer].V[1];
+			temp_current[2] += bus[indexer].Y[2]*voltageDel[0];
+
+			//See if we are a house-connected node, if so, adjust and add in those values as well
+			if ((bus[indexer].phases & 0x40) == 0x40)
 			{
-				for (kindex=0; kindex<3; kindex++)
+				//Update phase adjustments
+				temp_store[0].SetPolar(1.0,bus[indexer].V[0].Arg());	//Pull phase of V1
+				temp_store[1].SetPolar(1.0,bus[indexer].V[1].Arg());	//Pull phase of V2
+				temp_store[2].SetPolar(1.0,voltageDel[0].Arg());		//Pull phase of V12
+
+				//Update these current contributions (use delta current variable, it isn't used in here anyways)
+				delta_current[0] = bus[indexer].house_var[0]/(~temp_store[0]);		//Just denominator conjugated to keep math right (rest was conjugated in house)
+				delta_current[1] = bus[indexer].house_var[1]/(~temp_store[1]);
+				delta_current[2] = bus[indexer].house_var[2]/(~temp_store[2]);
+
+				//Now add it into the current contributions
+				temp_current[0] += delta_current[0];
+				temp_current[1] += delta_current[1];
+				temp_current[2] += delta_current[2];
+			}//End house-attached splitphase
+
+			//Convert 'em to line currents
+			temp_store[0] = temp_current[0] + temp_current[2];
+			temp_store[1] = -temp_current[1] - temp_current[2];
+
+			//Update the stored values
+			bus[indexer].PL[0] = temp_store[0].Re();
+			bus[indexer].QL[0] = temp_store[0].Im();
+
+			bus[indexer].PL[1] = temp_store[1].Re();
+			bus[indexer].QL[1] = temp_store[1].Im();
+		}//end split-phase connected
+		else	//Wye-connected node
+		{
+			//Populate the values for constant current -- deltamode different right now (all same in future?)
+			if (*bus[indexer].dynamics_enabled == true)
+			{
+				//Create nominal magnitudes
+				adjust_nominal_voltage_val = bus[indexer].volt_base;
+
+				//Create the nominal voltage vectors
+				adjust_temp_nominal_voltage[3].SetPolar(bus[indexer].volt_base,0.0);
+				adjust_temp_nominal_voltage[4].SetPolar(bus[indexer].volt_base,-2.0*PI/3.0);
+				adjust_temp_nominal_voltage[5].SetPolar(bus[indexer].volt_base,2.0*PI/3.0);
+
+				//Get magnitudes of all
+				adjust_temp_voltage_mag[3] = bus[indexer].V[0].Mag();
+				adjust_temp_voltage_mag[4] = bus[indexer].V[1].Mag();
+				adjust_temp_voltage_mag[5] = bus[indexer].V[2].Mag();
+
+				//Start adjustments - A
+				if ((bus[indexer].I[0] != 0.0) && (adjust_temp_voltage_mag[3] != 0.0))
 				{
-					powerflow_values->BA_diag[indexer].Y[jindex][kindex] = 0;
-					tempY[jindex][kindex] = 0;
+					//calculate new value
+					adjusted_constant_current[0] = ~(adjust_temp_nominal_voltage[3] * ~bus[indexer].I[0] * adjust_temp_voltage_mag[3] / (bus[indexer].V[0] * adjust_nominal_voltage_val));
+				}
+				else
+				{
+					adjusted_constant_current[0] = 0.0;
 				}
-			}
 
-			//If we're in any deltamode, store out self-admittance as well, if it exists
-			if ((powerflow_type!=PF_NORMAL) && (bus[indexer].full_Y != NULL))
-			{
-				//Loop and add
-				for (jindex=0; jindex<3; jindex++)
+				//Start adjustments - B
+				if ((bus[indexer].I[1] != 0.0) && (adjust_temp_voltage_mag[4] != 0.0))
 				{
-					for (kindex=0; kindex<3; kindex++)
+					//calculate new value
+					adjusted_constant_current[1] = ~(adjust_temp_nominal_voltage[4] * ~bus[indexer].I[1] * adjust_temp_voltage_mag[4] / (bus[indexer].V[1] * adjust_nominal_voltage_val));
+				}
+				else
+				{
+					adjusted_constant_current[1] = 0.0;
+				}
+
+				//Start adjustments - C
+				if ((bus[indexer].I[2] != 0.0) && (adjust_temp_voltage_mag[5] != 0.0))
+				{
+					//calculate new value
+					adjusted_constant_current[2] = ~(adjust_temp_nominal_voltage[5] * ~bus[indexer].I[2] * adjust_temp_voltage_mag[5] / (bus[indexer].V[2] * adjust_nominal_voltage_val));
+				}
+				else
+				{
+					adjusted_constant_current[2] = 0.0;
+				}
+
+				//Testing - do adjustments for unrotated current
+				if (bus[indexer].prerot_I[0] != 0.0)
+					adjusted_constant_current[0] += bus[indexer].prerot_I[0];
+
+				if (bus[indexer].prerot_I[1] != 0.0)
+					adjusted_constant_current[1] += bus[indexer].prerot_I[1];
+
+				if (bus[indexer].prerot_I[2] != 0.0)
+					adjusted_constant_current[2] += bus[indexer].prerot_I[2];
+
+				//See if we have any "different children"
+				if ((bus[indexer].phases & 0x10) == 0x10)
+				{
+					//Create nominal magnitudes
+					adjust_nominal_voltage_val = bus[indexer].volt_base * sqrt(3.0);
+
+					//Create the nominal voltage vectors
+					adjust_temp_nominal_voltage[0].SetPolar(adjust_nominal_voltage_val,PI/6.0);
+					adjust_temp_nominal_voltage[1].SetPolar(adjust_nominal_voltage_val,-1.0*PI/2.0);
+					adjust_temp_nominal_voltage[2].SetPolar(adjust_nominal_voltage_val,5.0*PI/6.0);
+
+					//Compute delta voltages
+					voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
+					voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
+					voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
+
+					//Get magnitudes of all
+					adjust_temp_voltage_mag[0] = voltageDel[0].Mag();
+					adjust_temp_voltage_mag[1] = voltageDel[1].Mag();
+					adjust_temp_voltage_mag[2] = voltageDel[2].Mag();
+
+					//Start adjustments - AB
+					if ((bus[indexer].extra_var[6] != 0.0) && (adjust_temp_voltage_mag[0] != 0.0))
 					{
-						tempY[jindex][kindex] = bus[indexer].full_Y[jindex*3+kindex];	//Adds in any self-admittance terms (generators)
+						//calculate new value
+						adjusted_constant_current[3] = ~(adjust_temp_nominal_voltage[0] * ~bus[indexer].extra_var[6] * adjust_temp_voltage_mag[0] / (voltageDel[0] * adjust_nominal_voltage_val));
+					}
+					else
+					{
+						adjusted_constant_current[3] = 0.0;
+					}
+
+					//Start adjustments - BC
+					if ((bus[indexer].extra_var[7] != 0.0) && (adjust_temp_voltage_mag[1] != 0.0))
+					{
+						//calculate new value
+						adjusted_constant_current[4] = ~(adjust_temp_nominal_voltage[1] * ~bus[indexer].extra_var[7] * adjust_temp_voltage_mag[1] / (voltageDel[1] * adjust_nominal_voltage_val));
 					}
+					else
+					{
+						adjusted_constant_current[4] = 0.0;
+					}
+
+					//Start adjustments - CA
+					if ((bus[indexer].extra_var[8] != 0.0) && (adjust_temp_voltage_mag[2] != 0.0))
+					{
+						//calculate new value
+						adjusted_constant_current[5] = ~(adjust_temp_nominal_voltage[2] * ~bus[indexer].extra_var[8] * adjust_temp_voltage_mag[2] / (voltageDel[2] * adjust_nominal_voltage_val));
+					}
+					else
+					{
+						adjusted_constant_current[5] = 0.0;
+					}
+				}
+				else	//Nope
+				{
+					//Set to zero, just cause
+					adjusted_constant_current[3] = 0.0;
+					adjusted_constant_current[4] = 0.0;
+					adjusted_constant_current[5] = 0.0;
 				}
 			}
+			else	//"Normal" modes -- handle traditionally
+			{
+				adjusted_constant_current[0] = bus[indexer].I[0];
+				adjusted_constant_current[1] = bus[indexer].I[1];
+				adjusted_constant_current[2] = bus[indexer].I[2];
 
-			//Now go through all of the branches to get the self admittance information (hinges on size)
-			for (kindexer=0; kindexer<(bus[indexer].Link_Table_Size);kindexer++)
-			{ 
-				//Assign jindexer as intermediate variable (easier for me this way)
-				jindexer = bus[indexer].Link_Table[kindexer];
+				//See if we have different children too
+				if ((bus[indexer].phases & 0x10) == 0x10)
+				{
+					//Store them too
+					adjusted_constant_current[3] = bus[indexer].extra_var[6];
+					adjusted_constant_current[4] = bus[indexer].extra_var[7];
+					adjusted_constant_current[5] = bus[indexer].extra_var[8];
+				}
+				else	//Nope, just zero this for now
+				{
+					adjusted_constant_current[3] = 0.0;
+					adjusted_constant_current[4] = 0.0;
+					adjusted_constant_current[5] = 0.0;
+				}
+			}//End adjustment code
 
-				if ((branch[jindexer].from == indexer) || (branch[jindexer].to == indexer))	//Bus is the from or to side of things - not sure how it would be in link table otherwise, but meh
+			//For Wye-connected, only compute and store phases that exist (make top heavy)
+			temp_index = -1;
+			temp_index_b = -1;
+
+			if ((bus[indexer].phases & 0x10) == 0x10)	//"Different" child load - in this case it must be delta - also must be three phase (just because that's how I forced it to be implemented)
+			{											//Calculate all the deltas to wyes in advance (otherwise they'll get repeated)
+				//Delta voltages
+				voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
+				voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
+				voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
+
+				//Make sure phase combinations exist
+				if ((bus[indexer].phases & 0x06) == 0x06)	//Has A-B
 				{
-					if ((bus[indexer].phases & 0x07) == 0x07)		//Full three phase
-					{
-						for (jindex=0; jindex<3; jindex++)	//Add in all three phase values
-						{
-							//See if this phase is valid
-							phase_workb = 0x04 >> jindex;
+					//Power - put into a current value (iterates less this way)
+					delta_current[0] = (voltageDel[0] == 0) ? 0 : ~(bus[indexer].extra_var[0]/voltageDel[0]);
 
-							if ((phase_workb & branch[jindexer].phases) == phase_workb)
-							{
-								for (kindex=0; kindex<3; kindex++)
-								{
-									//Check phase
-									phase_workd = 0x04 >> kindex;
+					//Convert delta connected load to appropriate Wye 
+					delta_current[0] += voltageDel[0] * (bus[indexer].extra_var[3]);
+				}
+				else
+				{
+					//Zero it, for good measure
+					delta_current[0] = 0.0;
+				}
 
-									if ((phase_workd & branch[jindexer].phases) == phase_workd)
-									{
-										if (branch[jindexer].from == indexer)	//We're the from version
-										{
-											tempY[jindex][kindex] += branch[jindexer].YSfrom[jindex*3+kindex];
-										}
-										else									//Must be the to version
-										{
-											tempY[jindex][kindex] += branch[jindexer].YSto[jindex*3+kindex];
-										}
-									}//End valid column phase
-								}
-							}//End valid row phase
+				//Check for BC
+				if ((bus[indexer].phases & 0x03) == 0x03)	//Has B-C
+				{
+					//Power - put into a current value (iterates less this way)
+					delta_current[1] = (voltageDel[1] == 0) ? 0 : ~(bus[indexer].extra_var[1]/voltageDel[1]);
+
+					//Convert delta connected load to appropriate Wye 
+					delta_current[1] += voltageDel[1] * (bus[indexer].extra_var[4]);
+				}
+				else
+				{
+					//Zero it, for good measure
+					delta_current[1] = 0.0;
+				}
+
+				//Check for CA
+				if ((bus[indexer].phases & 0x05) == 0x05)	//Has C-A
+				{
+					//Power - put into a current value (iterates less this way)
+					delta_current[2] = (voltageDel[2] == 0) ? 0 : ~(bus[indexer].extra_var[2]/voltageDel[2]);
+
+					//Convert delta connected load to appropriate Wye 
+					delta_current[2] += voltageDel[2] * (bus[indexer].extra_var[5]);
+				}
+				else
+				{
+					//Zero it, for good measure
+					delta_current[2] = 0.0;
+				}
+
+				//Convert delta-current into a phase current - reuse temp variable
+				undeltacurr[0]=(adjusted_constant_current[3]+delta_current[0])-(adjusted_constant_current[5]+delta_current[2]);
+				undeltacurr[1]=(adjusted_constant_current[4]+delta_current[1])-(adjusted_constant_current[3]+delta_current[0]);
+				undeltacurr[2]=(adjusted_constant_current[5]+delta_current[2])-(adjusted_constant_current[4]+delta_current[1]);
+			}
+			else	//zero the variable so we don't have excessive ifs
+			{
+				undeltacurr[0] = undeltacurr[1] = undeltacurr[2] = 0.0;	//Zero it
+			}
+
+			for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
+			{
+				switch(bus[indexer].phases & 0x07) {
+					case 0x01:	//C
+						{
+							temp_index=0;
+							temp_index_b=2;
+							break;
 						}
-					}
-					else if ((bus[indexer].phases & 0x80) == 0x80)	//Split phase - add in 2x2 element to upper left 2x2
-					{
-						if (branch[jindexer].from == indexer)	//From branch
+					case 0x02:	//B
 						{
-							//End of SPCT transformer requires slightly different Diagonal components (so when it's the To bus of SPCT and from for other triplex
-							if ((bus[indexer].phases & 0x20) == 0x20)	//Special case
+							temp_index=0;
+							temp_index_b=1;
+							break;
+						}
+					case 0x03:	//BC
+						{
+							if (jindex==0)	//B
 							{
-								//Other triplexes need to be negated to match sign conventions
-								tempY[0][0] -= branch[jindexer].YSfrom[0];
-								tempY[0][1] -= branch[jindexer].YSfrom[1];
-								tempY[1][0] -= branch[jindexer].YSfrom[3];
-								tempY[1][1] -= branch[jindexer].YSfrom[4];
+								temp_index=0;
+								temp_index_b=1;
 							}
-							else										//Just a normal to bus
+							else			//C
 							{
-								tempY[0][0] += branch[jindexer].YSfrom[0];
-								tempY[0][1] += branch[jindexer].YSfrom[1];
-								tempY[1][0] += branch[jindexer].YSfrom[3];
-								tempY[1][1] += branch[jindexer].YSfrom[4];
+								temp_index=1;
+								temp_index_b=2;
 							}
+							break;
 						}
-						else									//To branch
+					case 0x04:	//A
 						{
-							tempY[0][0] += branch[jindexer].YSto[0];
-							tempY[0][1] += branch[jindexer].YSto[1];
-							tempY[1][0] += branch[jindexer].YSto[3];
-							tempY[1][1] += branch[jindexer].YSto[4];
+							temp_index=0;
+							temp_index_b=0;
+							break;
 						}
-					}
-					else	//We must be a single or two-phase line - always populate the upper left portion of matrix (easier for later)
-					{
-						switch(bus[indexer].phases & 0x07) {
-							case 0x00:	//No phases (we've been faulted out
-								{
-									break;	//Just get us outta here
-								}
-							case 0x01:	//Only C
-								{
-									if ((branch[jindexer].phases & 0x01) == 0x01)	//Phase C valid on branch
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[0][0] += branch[jindexer].YSfrom[8];
-										}
-										else									//To branch
-										{
-											tempY[0][0] += branch[jindexer].YSto[8];
-										}
-									}//End valid phase C
-									break;
-								}
-							case 0x02:	//Only B
-								{
-									if ((branch[jindexer].phases & 0x02) == 0x02)	//Phase B valid on branch
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[0][0] += branch[jindexer].YSfrom[4];
-										}
-										else									//To branch
-										{
-											tempY[0][0] += branch[jindexer].YSto[4];
-										}
-									}//End valid phase B
-									break;
-								}
-							case 0x03:	//B & C
-								{
-									phase_worka = (branch[jindexer].phases & 0x03);	//Extract branch phases
+					case 0x05:	//AC
+						{
+							if (jindex==0)	//A
+							{
+								temp_index=0;
+								temp_index_b=0;
+							}
+							else			//C
+							{
+								temp_index=1;
+								temp_index_b=2;
+							}
+							break;
+						}
+					case 0x06:	//AB
+					case 0x07:	//ABC
+						{
+							temp_index=jindex;
+							temp_index_b=jindex;
+							break;
+						}
+					default:
+						break;
+				}//end case
 
-									if (phase_worka == 0x03)	//Full B & C
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[0][0] += branch[jindexer].YSfrom[4];
-											tempY[0][1] += branch[jindexer].YSfrom[5];
-											tempY[1][0] += branch[jindexer].YSfrom[7];
-											tempY[1][1] += branch[jindexer].YSfrom[8];
-										}
-										else									//To branch
-										{
-											tempY[0][0] += branch[jindexer].YSto[4];
-											tempY[0][1] += branch[jindexer].YSto[5];
-											tempY[1][0] += branch[jindexer].YSto[7];
-											tempY[1][1] += branch[jindexer].YSto[8];
-										}
-									}//End valid B & C
-									else if (phase_worka == 0x01)	//Only C branch
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[1][1] += branch[jindexer].YSfrom[8];
-										}
-										else									//To branch
-										{
-											tempY[1][1] += branch[jindexer].YSto[8];
-										}
-									}//end valid C
-									else if (phase_worka == 0x02)	//Only B branch
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[0][0] += branch[jindexer].YSfrom[4];
-										}
-										else									//To branch
-										{
-											tempY[0][0] += branch[jindexer].YSto[4];
-										}
-									}//end valid B
-									else	//Must be nothing then - all phases must be faulted, or something
-										;
-									break;
-								}
-							case 0x04:	//Only A
-								{
-									if ((branch[jindexer].phases & 0x04) == 0x04)	//Phase A is valid
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[0][0] += branch[jindexer].YSfrom[0];
-										}
-										else									//To branch
-										{
-											tempY[0][0] += branch[jindexer].YSto[0];
-										}
-									}//end valid phase A
-									break;
-								}
-							case 0x05:	//A & C
-								{
-									phase_worka = branch[jindexer].phases & 0x05;	//Extract phases
+				if ((temp_index==-1) || (temp_index_b==-1))
+				{
+					NR_RANGE_FAIL("NR: A scheduled power update element failed.");
+					/*  TROUBLESHOOT
+					While attempting to calculate the scheduled portions of the
+					attached loads, an update failed to process correctly.
+					Submit you code and a bug report using the trac website.
+					*/
+				}
 
-									if (phase_worka == 0x05)	//Both A & C valid
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[0][0] += branch[jindexer].YSfrom[0];
-											tempY[0][1] += branch[jindexer].YSfrom[2];
-											tempY[1][0] += branch[jindexer].YSfrom[6];
-											tempY[1][1] += branch[jindexer].YSfrom[8];
-										}
-										else									//To branch
-										{
-											tempY[0][0] += branch[jindexer].YSto[0];
-											tempY[0][1] += branch[jindexer].YSto[2];
-											tempY[1][0] += branch[jindexer].YSto[6];
-											tempY[1][1] += branch[jindexer].YSto[8];
-										}
-									}//End A & C valid
-									else if (phase_worka == 0x04)	//Only A valid
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[0][0] += branch[jindexer].YSfrom[0];
-										}
-										else									//To branch
-										{
-											tempY[0][0] += branch[jindexer].YSto[0];
-										}
-									}//end only A valid
-									else if (phase_worka == 0x01)	//Only C valid
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[1][1] += branch[jindexer].YSfrom[8];
-										}
-										else									//To branch
-										{
-											tempY[1][1] += branch[jindexer].YSto[8];
-										}
-									}//end only C valid
-									else	//No connection - must be faulted
-										;
-									break;
-								}
-							case 0x06:	//A & B
-								{
-									phase_worka = branch[jindexer].phases & 0x06;	//Extract phases
+				//Perform the power calculation
+				tempPbus = (bus[indexer].S[temp_index_b]).Re();									// Real power portion of constant power portion
+				tempPbus += (adjusted_constant_current[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Re() + (adjusted_constant_current[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Im();	// Real power portion of Constant current component multiply the magnitude of bus voltage
+				tempPbus += (undeltacurr[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Re() + (undeltacurr[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Im();	// Real power portion of Constant current from "different" children
+				tempPbus += (bus[indexer].Y[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Re() + (bus[indexer].Y[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Im();	// Real power portion of Constant impedance component multiply the square of the magnitude of bus voltage
+				bus[indexer].PL[temp_index] = tempPbus;	//Real power portion
+				
+				
+				tempQbus = (bus[indexer].S[temp_index_b]).Im();									// Reactive power portion of constant power portion
+				tempQbus += (adjusted_constant_current[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Im() - (adjusted_constant_current[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Re();	// Reactive power portion of Constant current component multiply the magnitude of bus voltage
+				tempQbus += (undeltacurr[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Im() - (undeltacurr[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Re();	// Reactive power portion of Constant current from "different" children
+				tempQbus += -(bus[indexer].Y[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Im() - (bus[indexer].Y[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Re();	// Reactive power portion of Constant impedance component multiply the square of the magnitude of bus voltage				
+				bus[indexer].QL[temp_index] = tempQbus;	//Reactive power portion  
 
-									if (phase_worka == 0x06)	//Valid A & B phase
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[0][0] += branch[jindexer].YSfrom[0];
-											tempY[0][1] += branch[jindexer].YSfrom[1];
-											tempY[1][0] += branch[jindexer].YSfrom[3];
-											tempY[1][1] += branch[jindexer].YSfrom[4];
-										}
-										else									//To branch
-										{
-											tempY[0][0] += branch[jindexer].YSto[0];
-											tempY[0][1] += branch[jindexer].YSto[1];
-											tempY[1][0] += branch[jindexer].YSto[3];
-											tempY[1][1] += branch[jindexer].YSto[4];
-										}
-									}//End valid A & B
-									else if (phase_worka == 0x04)	//Only valid A
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[0][0] += branch[jindexer].YSfrom[0];
-										}
-										else									//To branch
-										{
-											tempY[0][0] += branch[jindexer].YSto[0];
-										}
-									}//end valid A
-									else if (phase_worka == 0x02)	//Only valid B
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[1][1] += branch[jindexer].YSfrom[4];
-										}
-										else									//To branch
-										{
-											tempY[1][1] += branch[jindexer].YSto[4];
-										}
-									}//end valid B
-									else	//Default - must be already handled
-										;
-									break;
-								}
-							default:	//How'd we get here?
-								{
-									GL_THROW("Unknown phase connection in NR self admittance diagonal");
-									/*  TROUBLESHOOT
-									An unknown phase condition was encountered in the NR solver when constructing
-									the self admittance diagonal.  Please report this bug and submit your code to 
-									the trac system.
-									*/
-								break;
-								}
-						}	//switch end
-					}	//1 or 2 phase end
-				}	//phase accumulation end
-				else		//It's nothing (no connnection)
-					;
-			}//branch traversion end
+			}//end phase traversion
+		}//end wye-connected
 
-			//Store the self admittance into BA_diag.  Also update the indices for possible use later
-			powerflow_values->BA_diag[indexer].col_ind = powerflow_values->BA_diag[indexer].row_ind = index_count;	// Store the row and column starting information (square matrices)
-			bus[indexer].Matrix_Loc = index_count;								//Store our location so we know where we go
-			index_count += powerflow_values->BA_diag[indexer].size;				// Update the index for this matrix's size, so next one is in appropriate place
+		//Perform explicit delta/wye load accumulation - do if not triplex
+		if ((bus[indexer].phases & 0x80) != 0x80)
+		{
+			//Delta components - populate according to what is there
+			if ((bus[indexer].phases & 0x06) == 0x06)	//Check for AB
+			{
+				//Voltage calculations
+				voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
 
+				//Power - convert to a current (uses less iterations this way)
+				delta_current[0] = (voltageDel[0] == 0) ? 0 : ~(bus[indexer].S_dy[0]/voltageDel[0]);
 
-			//Store the admittance values into the BA_diag matrix structure
-			for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
+				//Convert delta connected load to appropriate Wye
+				delta_current[0] += voltageDel[0] * (bus[indexer].Y_dy[0]);
+
+			}
+			else
 			{
-				for (kindex=0; kindex<powerflow_values->BA_diag[indexer].size; kindex++)			//Store values - assume square matrix - don't bother parsing what doesn't exist.
-				{
-					powerflow_values->BA_diag[indexer].Y[jindex][kindex] = tempY[jindex][kindex];// Store the self admittance terms.
-				}
+				//Zero values - they shouldn't be used anyhow
+				voltageDel[0] = 0.0;
+				delta_current[0] = 0.0;
 			}
 
-			//Copy values into node-specific link (if needed)
-			if (bus[indexer].full_Y_all != NULL)
+			if ((bus[indexer].phases & 0x03) == 0x03)	//Check for BC
 			{
-				for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
-				{
-					for (kindex=0; kindex<powerflow_values->BA_diag[indexer].size; kindex++)			//Store values - assume square matrix - don't bother parsing what doesn't exist.
-					{
-						bus[indexer].full_Y_all[jindex*3+kindex] = tempY[jindex][kindex];// Store the self admittance terms.
-					}
-				}
-			}//End self-admittance update
-		}//End diagonal construction
+				//Voltage calculations
+				voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
 
-		//Store the size of the diagonal, since it represents how many variables we are solving (useful later)
-		powerflow_values->total_variables=index_count;
+				//Power - convert to a current (uses less iterations this way)
+				delta_current[1] = (voltageDel[1] == 0) ? 0 : ~(bus[indexer].S_dy[1]/voltageDel[1]);
 
-		//Check to see if we've exceeded our max.  If so, reallocate!
-		if (powerflow_values->total_variables > powerflow_values->max_total_variables)
-			powerflow_values->NR_realloc_needed = true;
+				//Convert delta connected load to appropriate Wye
+				delta_current[1] += voltageDel[1] * (bus[indexer].Y_dy[1]);
 
-		/// Build the off_diagonal_PQ bus elements of 6n*6n Y_NR matrix.Equation (12). All the value in this part will not be updated at each iteration.
-		//Constructed using sparse methodology, non-zero elements are the only thing considered (and non-PV)
-		//No longer necessarily 6n*6n any more either,
-		powerflow_values->size_offdiag_PQ = 0;
-		for (jindexer=0; jindexer<branch_count;jindexer++)	//Parse all of the branches
-		{
-			tempa  = branch[jindexer].from;
-			tempb  = branch[jindexer].to;
-
-			//Preliminary check to make sure we weren't missed in the initialization
-			if ((bus[tempa].Matrix_Loc == -1) || (bus[tempb].Matrix_Loc == -1))
+			}
+			else
 			{
-				GL_THROW("An element in NR line:%d was not properly localized");
-				/*  TROUBLESHOOT
-				When parsing the bus list, the Newton-Raphson solver found a bus that did not
-				appear to have a location within the overall admittance/Jacobian matrix.  Please
-				submit this as a bug with your code on the Trac site.
-				*/
+				//Zero unused
+				voltageDel[1] = 0.0;
+				delta_current[1] = 0.0;
 			}
 
-			if (((branch[jindexer].phases & 0x80) == 0x80) && (branch[jindexer].v_ratio==1.0))	//Triplex, but not SPCT
+			if ((bus[indexer].phases & 0x05) == 0x05)	//Check for CA
 			{
-				for (jindex=0; jindex<2; jindex++)			//rows
-				{
-					for (kindex=0; kindex<2; kindex++)		//columns
-					{
-						if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))
-							powerflow_values->size_offdiag_PQ += 1; 
+				//Voltage calculations
+				voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
 
-						if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))  
-							powerflow_values->size_offdiag_PQ += 1; 
+				//Power - convert to a current (uses less iterations this way)
+				delta_current[2] = (voltageDel[2] == 0) ? 0 : ~(bus[indexer].S_dy[2]/voltageDel[2]);
 
-						if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
-							powerflow_values->size_offdiag_PQ += 1; 
+				//Convert delta connected load to appropriate Wye
+				delta_current[2] += voltageDel[2] * (bus[indexer].Y_dy[2]);
 
-						if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
-							powerflow_values->size_offdiag_PQ += 1; 
-					}//end columns of split phase
-				}//end rows of split phase
-			}//end traversion of split-phase
-			else											//Three phase or some variety
+			}
+			else
 			{
-				//Make sure we aren't SPCT, otherwise things get jacked
-				if ((branch[jindexer].phases & 0x80) != 0x80)	//SPCT, but v_ratio not = 1
+				//Zero unused
+				voltageDel[2] = 0.0;
+				delta_current[2] = 0.0;
+			}
+			
+			//Populate the values for constant current -- deltamode different right now (all same in future?)
+			if (*bus[indexer].dynamics_enabled == true)
+			{
+				//Create line-line nominal magnitude
+				adjust_nominal_voltage_val = bus[indexer].volt_base;
+				adjust_nominal_voltaged_val = bus[indexer].volt_base * sqrt(3.0);
+
+				//Create the nominal voltage vectors
+				adjust_temp_nominal_voltage[0].SetPolar(adjust_nominal_voltaged_val,PI/6.0);
+				adjust_temp_nominal_voltage[1].SetPolar(adjust_nominal_voltaged_val,-1.0*PI/2.0);
+				adjust_temp_nominal_voltage[2].SetPolar(adjust_nominal_voltaged_val,5.0*PI/6.0);
+				adjust_temp_nominal_voltage[3].SetPolar(adjust_nominal_voltage_val,0.0);
+				adjust_temp_nominal_voltage[4].SetPolar(adjust_nominal_voltage_val,-2.0*PI/3.0);
+				adjust_temp_nominal_voltage[5].SetPolar(adjust_nominal_voltage_val,2.0*PI/3.0);
+
+				//Compute delta voltages
+				voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
+				voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
+				voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
+
+				//Get magnitudes of all
+				adjust_temp_voltage_mag[0] = voltageDel[0].Mag();
+				adjust_temp_voltage_mag[1] = voltageDel[1].Mag();
+				adjust_temp_voltage_mag[2] = voltageDel[2].Mag();
+				adjust_temp_voltage_mag[3] = bus[indexer].V[0].Mag();
+				adjust_temp_voltage_mag[4] = bus[indexer].V[1].Mag();
+				adjust_temp_voltage_mag[5] = bus[indexer].V[2].Mag();
+
+				//Start adjustments - A
+				if ((bus[indexer].I_dy[3] != 0.0) && (adjust_temp_voltage_mag[3] != 0.0))
 				{
-					for (jindex=0; jindex<3; jindex++)			//rows
-					{
-						//See if this phase is valid
-						phase_workb = 0x04 >> jindex;
+					//calculate new value
+					adjusted_constant_current[3] = ~(adjust_temp_nominal_voltage[3] * ~bus[indexer].I_dy[3] * adjust_temp_voltage_mag[3] / (bus[indexer].V[0] * adjust_nominal_voltage_val));
+				}
+				else
+				{
+					adjusted_constant_current[3] = 0.0;
+				}
 
-						if ((phase_workb & branch[jindexer].phases) == phase_workb)	//Row check
-						{
-							for (kindex=0; kindex<3; kindex++)		//columns
-							{
-								//Check this phase as well
-								phase_workd = 0x04 >> kindex;
+				//Start adjustments - B
+				if ((bus[indexer].I_dy[4] != 0.0) && (adjust_temp_voltage_mag[4] != 0.0))
+				{
+					//calculate new value
+					adjusted_constant_current[4] = ~(adjust_temp_nominal_voltage[4] * ~bus[indexer].I_dy[4] * adjust_temp_voltage_mag[4] / (bus[indexer].V[1] * adjust_nominal_voltage_val));
+				}
+				else
+				{
+					adjusted_constant_current[4] = 0.0;
+				}
 
-								if ((phase_workd & branch[jindexer].phases) == phase_workd)	//Column validity check
-								{
-									if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))
-										powerflow_values->size_offdiag_PQ += 1; 
+				//Start adjustments - C
+				if ((bus[indexer].I_dy[5] != 0.0) && (adjust_temp_voltage_mag[5] != 0.0))
+				{
+					//calculate new value
+					adjusted_constant_current[5] = ~(adjust_temp_nominal_voltage[5] * ~bus[indexer].I_dy[5] * adjust_temp_voltage_mag[5] / (bus[indexer].V[2] * adjust_nominal_voltage_val));
+				}
+				else
+				{
+					adjusted_constant_current[5] = 0.0;
+				}
 
-									if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))  
-										powerflow_values->size_offdiag_PQ += 1; 
+				//Start adjustments - AB
+				if ((bus[indexer].I_dy[0] != 0.0) && (adjust_temp_voltage_mag[0] != 0.0))
+				{
+					//calculate new value
+					adjusted_constant_current[0] = ~(adjust_temp_nominal_voltage[0] * ~bus[indexer].I_dy[0] * adjust_temp_voltage_mag[0] / (voltageDel[0] * adjust_nominal_voltaged_val));
+				}
+				else
+				{
+					adjusted_constant_current[0] = 0.0;
+				}
 
-									if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
-										powerflow_values->size_offdiag_PQ += 1; 
+				//Start adjustments - BC
+				if ((bus[indexer].I_dy[1] != 0.0) && (adjust_temp_voltage_mag[1] != 0.0))
+				{
+					//calculate new value
+					adjusted_constant_current[1] = ~(adjust_temp_nominal_voltage[1] * ~bus[indexer].I_dy[1] * adjust_temp_voltage_mag[1] / (voltageDel[1] * adjust_nominal_voltaged_val));
+				}
+				else
+				{
+					adjusted_constant_current[1] = 0.0;
+				}
 
-									if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
-										powerflow_values->size_offdiag_PQ += 1; 
-								}//end column validity check
-							}//end columns of 3 phase
-						}//End row validity check
-					}//end rows of 3 phase
-				}//end not SPCT
-				else	//SPCT inmplementation
+				//Start adjustments - CA
+				if ((bus[indexer].I_dy[2] != 0.0) && (adjust_temp_voltage_mag[2] != 0.0))
 				{
-					for (jindex=0; jindex<3; jindex++)			//rows
-					{
-						//See if this phase is valid
-						phase_workb = 0x04 >> jindex;
+					//calculate new value
+					adjusted_constant_current[2] = ~(adjust_temp_nominal_voltage[2] * ~bus[indexer].I_dy[2] * adjust_temp_voltage_mag[2] / (voltageDel[2] * adjust_nominal_voltaged_val));
+				}
+				else
+				{
+					adjusted_constant_current[2] = 0.0;
+				}
+			}//End deltamode adjustment
+			else	//Normal mode
+			{
+				//Just copy the values in
+				adjusted_constant_current[0] = bus[indexer].I_dy[0];
+				adjusted_constant_current[1] = bus[indexer].I_dy[1];
+				adjusted_constant_current[2] = bus[indexer].I_dy[2];
+				adjusted_constant_current[3] = bus[indexer].I_dy[3];
+				adjusted_constant_current[4] = bus[indexer].I_dy[4];
+				adjusted_constant_current[5] = bus[indexer].I_dy[5];
+			}
 
-						if ((phase_workb & branch[jindexer].phases) == phase_workb)	//Row check
+			//Convert delta-current into a phase current, where appropriate - reuse temp variable
+			//Everything will be accumulated into the "current" field for ease (including differents)
+			//Also handle wye currents in here (was a differently connected child code before)
+			if ((bus[indexer].phases & 0x04) == 0x04)	//Has a phase A
+			{
+				undeltacurr[0]=(adjusted_constant_current[0]+delta_current[0])-(adjusted_constant_current[2]+delta_current[2]);
+
+				//Power values
+				undeltacurr[0] += (bus[indexer].V[0] == 0) ? 0 : ~(bus[indexer].S_dy[3]/bus[indexer].V[0]);
+
+				//Shunt values
+				undeltacurr[0] += bus[indexer].Y_dy[3]*bus[indexer].V[0];
+
+				//Current values
+				undeltacurr[0] += adjusted_constant_current[3];
+			}
+			else
+			{
+				//Zero it, just in case
+				undeltacurr[0] = 0.0;
+			}
+
+			if ((bus[indexer].phases & 0x02) == 0x02)	//Has a phase B
+			{
+				undeltacurr[1]=(adjusted_constant_current[1]+delta_current[1])-(adjusted_constant_current[0]+delta_current[0]);
+
+				//Power values
+				undeltacurr[1] += (bus[indexer].V[1] == 0) ? 0 : ~(bus[indexer].S_dy[4]/bus[indexer].V[1]);
+
+				//Shunt values
+				undeltacurr[1] += bus[indexer].Y_dy[4]*bus[indexer].V[1];
+
+				//Current values
+				undeltacurr[1] += adjusted_constant_current[4];
+			}
+			else
+			{
+				//Zero it, just in case
+				undeltacurr[1] = 0.0;
+			}
+
+
+			if ((bus[indexer].phases & 0x01) == 0x01)	//Has a phase C
+			{
+				undeltacurr[2]=(adjusted_constant_current[2]+delta_current[2])-(adjusted_constant_current[1]+delta_current[1]);
+
+				//Power values
+				undeltacurr[2] += (bus[indexer].V[2] == 0) ? 0 : ~(bus[indexer].S_dy[5]/bus[indexer].V[2]);
+
+				//Shunt values
+				undeltacurr[2] += bus[indexer].Y_dy[5]*bus[indexer].V[2];
+
+				//Current values
+				undeltacurr[2] += adjusted_constant_current[5];
+			}
+			else
+			{
+				//Zero it, just in case
+				undeltacurr[2] = 0.0;
+			}
+
+			//Provide updates to relevant phases
+			//only compute and store phases that exist (make top heavy)
+			temp_index = -1;
+			temp_index_b = -1;
+			
+			for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
+			{
+				switch(bus[indexer].phases & 0x07) {
+					case 0x01:	//C
 						{
-							for (kindex=0; kindex<3; kindex++)		//Row valid, traverse all columns for SPCT Yfrom
+							temp_index=0;
+							temp_index_b=2;
+							break;
+						}
+					case 0x02:	//B
+						{
+							temp_index=0;
+							temp_index_b=1;
+							break;
+						}
+					case 0x03:	//BC
+						{
+							if (jindex==0)	//B
 							{
-								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))
-									powerflow_values->size_offdiag_PQ += 1; 
+								temp_index=0;
+								temp_index_b=1;
+							}
+							else			//C
+							{
+								temp_index=1;
+								temp_index_b=2;
+							}
+							break;
+						}
+					case 0x04:	//A
+						{
+							temp_index=0;
+							temp_index_b=0;
+							break;
+						}
+					case 0x05:	//AC
+						{
+							if (jindex==0)	//A
+							{
+								temp_index=0;
+								temp_index_b=0;
+							}
+							else			//C
+							{
+								temp_index=1;
+								temp_index_b=2;
+							}
+							break;
+						}
+					case 0x06:	//AB
+					case 0x07:	//ABC
+						{
+							temp_index=jindex;
+							temp_index_b=jindex;
+							break;
+						}
+					default:
+						break;
+				}//end case
 
-								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
-									powerflow_values->size_offdiag_PQ += 1; 
-							}//end columns traverse
+				if ((temp_index==-1) || (temp_index_b==-1))
+				{
+					NR_RANGE_FAIL("NR: A scheduled power update element failed.");
+					//Defined below
+				}
 
-							//If row is valid, now traverse the rows of that column for Yto
-							for (kindex=0; kindex<3; kindex++)
-							{
-								if (((branch[jindexer].Yto[kindex*3+jindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))  
-									powerflow_values->size_offdiag_PQ += 1; 
+				//Real power calculations
+				tempPbus = (undeltacurr[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Re() + (undeltacurr[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Im();	// Real power portion of Constant current component multiply the magnitude of bus voltage
+				bus[indexer].PL[temp_index] += tempPbus;	//Real power portion - all is current based -- accumulate in case mixed and matched with old above
 
-								if (((branch[jindexer].Yto[kindex*3+jindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
-									powerflow_values->size_offdiag_PQ += 1; 
-							}//end rows traverse
-						}//End row validity check
-					}//end rows of 3 phase
-				}//End SPCT
-			}//end three phase
-		}//end line traversion
+				//Reactive load calculations
+				tempQbus = (undeltacurr[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Im() - (undeltacurr[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Re();	// Reactive power portion of Constant current component multiply the magnitude of bus voltage
+				bus[indexer].QL[temp_index] += tempQbus;	//Reactive power portion - all is current based -- accumulate in case mixed and matched with old above
+					
+			}//End phase traversion
+		}//End delta/wye explicit load update
+	}//end bus traversion for power update
+}
 
-		//Allocate the space - double the number found (each element goes in two places)
-		if (powerflow_values->Y_offdiag_PQ == NULL)
+/** Current mismatch (deltaI_NR) of each bus in the range, and the dynamic currents of generator buses **/
+static void NR_range_mismatch(NR_RANGE *range)
+{
+	BUSDATA *bus = range->bus;
+	BRANCHDATA *branch = range->branch;
+	NR_SOLVER_STRUCT *powerflow_values = range->powerflow_values;
+	NRSOLVERMODE powerflow_type = range->powerflow_type;
+	bool swing_is_a_swing = range->swing_is_a_swing;
+	int64 Iteration = range->Iteration;
+	complex aval = range->aval, avalsq = range->avalsq;
+	unsigned int indexer, jindexer, kindexer;
+	char jindex, kindex, temp_index, temp_index_b;
+	unsigned char phase_worka;
+	double tempIcalcReal, tempIcalcImag, tempPbus, tempQbus;
+	double work_vals_double_0, work_vals_double_1, work_vals_double_2, work_vals_double_3, work_vals_double_4;
+	char work_vals_char_0;
+	complex temp_complex_0, temp_complex_1, temp_complex_2, temp_complex_3, temp_complex_4, temp_complex_5;
+	bool proceed_flag;
+
+	for (indexer=range->first; indexer<range->last; indexer++) //for specific bus k
+	{
+		//Update for generator symmetry - only in static dynamic mode and when SWING is a SWING
+		if ((powerflow_type == PF_DYNINIT) && (swing_is_a_swing==true))
 		{
-			powerflow_values->Y_offdiag_PQ = (Y_NR *)gl_malloc((powerflow_values->size_offdiag_PQ*2) *sizeof(Y_NR));   //powerflow_values->Y_offdiag_PQ store the row,column and value of off_diagonal elements of Bus Admittance matrix in which all the buses are not PV buses. 
+			//Secondary check - see if it is even needed - basically built around 3-phase right now
+			if ((*bus[indexer].dynamics_enabled==true) && (bus[indexer].full_Y != NULL) && (bus[indexer].DynCurrent != NULL))
+			{
+				//Form denominator term of Ii, since it won't change
+				temp_complex_1 = (~bus[indexer].V[0]) + (~bus[indexer].V[1])*avalsq + (~bus[indexer].V[2])*aval;
+				
+				//Form up numerator portion that doesn't change (Q and admittance)
+				//Do in parts, just for readability
+				temp_complex_2 = ~bus[indexer].V[0];	//conj(Va)
+				
+				//Row 1 of admittance mult
+				temp_complex_0 = temp_complex_2*(bus[indexer].full_Y[0]*bus[indexer].V[0] + bus[indexer].full_Y[1]*bus[indexer].V[1] + bus[indexer].full_Y[2]*bus[indexer].V[2]);
 
-			//Make sure it worked
-			if (powerflow_values->Y_offdiag_PQ == NULL)
-				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+				// Row 1 also calculate Sysource ( = v * conj(ysource * v)) to substract from PTsource and obtain Pgen at generator bus 
+				temp_complex_5 = bus[indexer].full_Y[0]*bus[indexer].V[0] + bus[indexer].full_Y[1]*bus[indexer].V[1] + bus[indexer].full_Y[2]*bus[indexer].V[2];
+				temp_complex_4 = ~temp_complex_5;
+				temp_complex_3 = bus[indexer].V[0]*temp_complex_4;
 
-			//Save our size
-			powerflow_values->max_size_offdiag_PQ = powerflow_values->size_offdiag_PQ;	//Don't care about the 2x, since we'll be comparing it against itself
-		}
-		else if (powerflow_values->size_offdiag_PQ > powerflow_values->max_size_offdiag_PQ)	//Something changed and we are bigger!!
-		{
-			//Destroy us!
-			gl_free(powerflow_values->Y_offdiag_PQ);
+				//conj(Vb)
+				temp_complex_2 = ~bus[indexer].V[1];
 
-			//Rebuild us, we have the technology
-			powerflow_values->Y_offdiag_PQ = (Y_NR *)gl_malloc((powerflow_values->size_offdiag_PQ*2) *sizeof(Y_NR));
+				//Row 2 of admittance
+				temp_complex_0 += temp_complex_2*(bus[indexer].full_Y[3]*bus[indexer].V[0] + bus[indexer].full_Y[4]*bus[indexer].V[1] + bus[indexer].full_Y[5]*bus[indexer].V[2]);
+				
+				// Row 2 also calculate Sysource ( = v * conj(ysource * v)) to substract from PTsource and obtain Pgen at generator bus
+				temp_complex_5 = bus[indexer].full_Y[3]*bus[indexer].V[0] + bus[indexer].full_Y[4]*bus[indexer].V[1] + bus[indexer].full_Y[5]*bus[indexer].V[2];
+				temp_complex_4 = ~temp_complex_5;
+				temp_complex_3 += bus[indexer].V[1]*temp_complex_4;
 
-			//Make sure it worked
-			if (powerflow_values->Y_offdiag_PQ == NULL)
-				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+				//conj(Vc)
+				temp_complex_2 = ~bus[indexer].V[2];
 
-			//Store the new size
-			powerflow_values->max_size_offdiag_PQ = powerflow_values->size_offdiag_PQ;
+				//Row 3 of admittance
+				temp_complex_0 += temp_complex_2*(bus[indexer].full_Y[6]*bus[indexer].V[0] + bus[indexer].full_Y[7]*bus[indexer].V[1] + bus[indexer].full_Y[8]*bus[indexer].V[2]);
 
-			//Flag for a reallocation
-			powerflow_values->NR_realloc_needed = true;
-		}
+				// Row 3 also calculate Sysource ( = v * conj(ysource * v)) to substract from PTsource and obtain Pgen at generator bus
+				temp_complex_5 = bus[indexer].full_Y[6]*bus[indexer].V[0] + bus[indexer].full_Y[7]*bus[indexer].V[1] + bus[indexer].full_Y[8]*bus[indexer].V[2];
+				temp_complex_4 = ~temp_complex_5;
+				temp_complex_3 += bus[indexer].V[2]*temp_complex_4;					
 
-		indexer = 0;
-		for (jindexer=0; jindexer<branch_count;jindexer++)	//Parse through all of the branches
-		{
-			//Extract both ends
-			tempa  = branch[jindexer].from;
-			tempb  = branch[jindexer].to;
+				//numerator done, except PT portion (add in below - SWING bus is different
 
-			phase_worka = 0;
-			phase_workb = 0;
-			for (jindex=0; jindex<3; jindex++)		//Accumulate number of phases
+				//On that note, if we are a SWING, zero our PT portion and QT for accumulation
+				if ((bus[indexer].type == 2) && (Iteration>0))
+				{
+					*bus[indexer].PGenTotal = complex(0.0,0.0);
+				}
+			}
+			else	//Not enabled or not "full-Y-ed" - set to zero
 			{
-				phase_worka += ((bus[tempa].phases & (0x01 << jindex)) >> jindex);
-				phase_workb += ((bus[tempb].phases & (0x01 << jindex)) >> jindex);
+				temp_complex_0 = 0.0;
+				temp_complex_1 = 0.0;	//Basically a flag to ignore it
 			}
+		}//End PF_DYNINIT and SWING is still the same
 
-			if ((phase_worka==3) && (phase_workb==3))	//Both ends are full three phase, normal operations
+		for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++) // rows - for specific phase that exists
+		{
+			tempIcalcReal = tempIcalcImag = 0;   
+
+			if ((bus[indexer].phases & 0x80) == 0x80)	//Split phase - triplex bus
 			{
-				for (jindex=0; jindex<3; jindex++)		//Loop through rows of admittance matrices				
+				//Two states of triplex bus - To node of SPCT transformer needs to be different
+				//First different - Delta-I and diagonal contributions
+				if ((bus[indexer].phases & 0x20) == 0x20)	//We're the To bus
 				{
-					//See if this row is valid for this branch
-					phase_workd = 0x04 >> jindex;
+					//Pre-negated due to the nature of how it's calculated (V1 compared to I1)
+					tempPbus =  bus[indexer].PL[jindex];	//Copy load amounts in
+					tempQbus =  bus[indexer].QL[jindex];	
+				}
+				else	//We're just a normal triplex bus
+				{
+					//This one isn't negated (normal operations)
+					tempPbus =  -bus[indexer].PL[jindex];	//Copy load amounts in
+					tempQbus =  -bus[indexer].QL[jindex];	
+				}//end normal triplex bus
+
+				//Get diagonal contributions - only (& always) 2
+				//Column 1
+				tempIcalcReal += (powerflow_values->BA_diag[indexer].Y[jindex][0]).Re() * (bus[indexer].V[0]).Re() - (powerflow_values->BA_diag[indexer].Y[jindex][0]).Im() * (bus[indexer].V[0]).Im();// equation (7), the diag elements of bus admittance matrix 
+				tempIcalcImag += (powerflow_values->BA_diag[indexer].Y[jindex][0]).Re() * (bus[indexer].V[0]).Im() + (powerflow_values->BA_diag[indexer].Y[jindex][0]).Im() * (bus[indexer].V[0]).Re();// equation (8), the diag elements of bus admittance matrix 
+
+				//Column 2
+				tempIcalcReal += (powerflow_values->BA_diag[indexer].Y[jindex][1]).Re() * (bus[indexer].V[1]).Re() - (powerflow_values->BA_diag[indexer].Y[jindex][1]).Im() * (bus[indexer].V[1]).Im();// equation (7), the diag elements of bus admittance matrix 
+				tempIcalcImag += (powerflow_values->BA_diag[indexer].Y[jindex][1]).Re() * (bus[indexer].V[1]).Im() + (powerflow_values->BA_diag[indexer].Y[jindex][1]).Im() * (bus[indexer].V[1]).Re();// equation (8), the diag elements of bus admittance matrix 
+
+				//Now off diagonals
+				for (kindexer=0; kindexer<(bus[indexer].Link_Table_Size); kindexer++)
+				{
+					//Apply proper index to jindexer (easier to implement this way)
+					jindexer=bus[indexer].Link_Table[kindexer];
 
-					if ((branch[jindexer].phases & phase_workd) == phase_workd)	//Validity check
+					if (branch[jindexer].from == indexer)	//We're the from bus
 					{
-						for (kindex=0; kindex<3; kindex++)	//Loop through columns of admittance matrices
+						if ((bus[indexer].phases & 0x20) == 0x20)	//SPCT from bus - needs different signage
 						{
-							//Extract column information
-							phase_worke = 0x04 >> kindex;
+							work_vals_char_0 = jindex*3;
 
-							if ((branch[jindexer].phases & phase_worke) == phase_worke)	//Valid column too!
+							//This situation can only be a normal line (triplex will never be the from for another type)
+							//Again only, & always 2 columns (just do them explicitly)
+							//Column 1
+							tempIcalcReal += ((branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Re() - ((branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+							tempIcalcImag += ((branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Im() + ((branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+
+							//Column2
+							tempIcalcReal += ((branch[jindexer].Yfrom[jindex*3+1])).Re() * (bus[branch[jindexer].to].V[1]).Re() - ((branch[jindexer].Yfrom[jindex*3+1])).Im() * (bus[branch[jindexer].to].V[1]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+							tempIcalcImag += ((branch[jindexer].Yfrom[jindex*3+1])).Re() * (bus[branch[jindexer].to].V[1]).Im() + ((branch[jindexer].Yfrom[jindex*3+1])).Im() * (bus[branch[jindexer].to].V[1]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+
+						}//End SPCT To bus - from diagonal contributions
+						else		//Normal line connection to normal triplex
+						{
+							work_vals_char_0 = jindex*3;
+							//This situation can only be a normal line (triplex will never be the from for another type)
+							//Again only, & always 2 columns (just do them explicitly)
+							//Column 1
+							tempIcalcReal += (-(branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Re() - (-(branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+							tempIcalcImag += (-(branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Im() + (-(branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+
+							//Column2
+							tempIcalcReal += (-(branch[jindexer].Yfrom[jindex*3+1])).Re() * (bus[branch[jindexer].to].V[1]).Re() - (-(branch[jindexer].Yfrom[jindex*3+1])).Im() * (bus[branch[jindexer].to].V[1]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+							tempIcalcImag += (-(branch[jindexer].Yfrom[jindex*3+1])).Re() * (bus[branch[jindexer].to].V[1]).Im() + (-(branch[jindexer].Yfrom[jindex*3+1])).Im() * (bus[branch[jindexer].to].V[1]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+
+						}//end normal triplex from
+					}//end from bus
+					else if (branch[jindexer].to == indexer)	//We're the to bus
+					{
+						if (branch[jindexer].v_ratio != 1.0)	//Transformer
+						{
+							//Only a single contributor on the from side - figure out how to get to it
+							if ((branch[jindexer].phases & 0x01) == 0x01)	//C
 							{
-								//Indices counted out from Self admittance above.  needs doubling due to complex separation
-								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
-								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
-									indexer += 1;
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 3;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 3;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
-									indexer += 1;
-								}
+								temp_index=2;
+							}
+							else if ((branch[jindexer].phases & 0x02) == 0x02)	//B
+							{
+								temp_index=1;
+							}
+							else if ((branch[jindexer].phases & 0x04) == 0x04)	//A
+							{
+								temp_index=0;
+							}
+							else	//How'd we get here!?!
+							{
+								NR_RANGE_FAIL("NR: A split-phase transformer appears to have an invalid phase");
+							}
 
-								if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
-								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Im());
-									indexer += 1;
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 3;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 3;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yto[jindex*3+kindex]).Im();
-									indexer += 1;
-								}
+							work_vals_char_0 = jindex*3+temp_index;
 
-								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
-								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 3;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-									indexer += 1;
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 3;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-									indexer += 1;	
-								}
+							//Perform the update, it only happens for one column (nature of the transformer)
+							tempIcalcReal += (-(branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[temp_index]).Re() - (-(branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[temp_index]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+							tempIcalcImag += (-(branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[temp_index]).Im() + (-(branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[temp_index]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
 
-								if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
-								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 3;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
-									indexer += 1;
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 3;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
-									indexer += 1;	
-								}
-							}//End valid column
-						}//column end
-					}//End valid row
-				}//row end
-			}//if all 3 end
-			else if (((bus[tempa].phases & 0x80) == 0x80) || ((bus[tempb].phases & 0x80) == 0x80))	//Someone's a triplex
-			{
-				if (((bus[tempa].phases & 0x80) == 0x80) && ((bus[tempb].phases & 0x80) == 0x80))	//Both are triplex, easy case
+						}//end transformer
+						else									//Must be a normal line then
+						{
+							if ((bus[indexer].phases & 0x20) == 0x20)	//SPCT from bus - needs different signage
+							{
+								work_vals_char_0 = jindex*3;
+								//This case should never really exist, but if someone reverses a secondary or is doing meshed secondaries, it might
+								//Again only, & always 2 columns (just do them explicitly)
+								//Column 1
+								tempIcalcReal += ((branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[0]).Re() - ((branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[0]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+								tempIcalcImag += ((branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[0]).Im() + ((branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[0]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+
+								//Column2
+								tempIcalcReal += ((branch[jindexer].Yto[work_vals_char_0+1])).Re() * (bus[branch[jindexer].from].V[1]).Re() - ((branch[jindexer].Yto[work_vals_char_0+1])).Im() * (bus[branch[jindexer].from].V[1]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+								tempIcalcImag += ((branch[jindexer].Yto[work_vals_char_0+1])).Re() * (bus[branch[jindexer].from].V[1]).Im() + ((branch[jindexer].Yto[work_vals_char_0+1])).Im() * (bus[branch[jindexer].from].V[1]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+							}//End SPCT To bus - from diagonal contributions
+							else		//Normal line connection to normal triplex
+							{
+								work_vals_char_0 = jindex*3;
+								//Again only, & always 2 columns (just do them explicitly)
+								//Column 1
+								tempIcalcReal += (-(branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[0]).Re() - (-(branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[0]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+								tempIcalcImag += (-(branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[0]).Im() + (-(branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[0]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+
+								//Column2
+								tempIcalcReal += (-(branch[jindexer].Yto[work_vals_char_0+1])).Re() * (bus[branch[jindexer].from].V[1]).Re() - (-(branch[jindexer].Yto[work_vals_char_0+1])).Im() * (bus[branch[jindexer].from].V[1]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+								tempIcalcImag += (-(branch[jindexer].Yto[work_vals_char_0+1])).Re() * (bus[branch[jindexer].from].V[1]).Im() + (-(branch[jindexer].Yto[work_vals_char_0+1])).Im() * (bus[branch[jindexer].from].V[1]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+							}//End normal triplex connection
+						}//end normal line
+					}//end to bus
+					else	//We're nothing
+						;
+
+				}//End branch traversion
+
+				//Determine how we are posting this update
+				if ((bus[indexer].type > 1) && (bus[indexer].swing_functions_enabled == true))	//SWING bus is different (when it really is a SWING bus)
 				{
-					for (jindex=0; jindex<2; jindex++)		//Loop through rows of admittance matrices (only 2x2)
+					if ((powerflow_type == PF_DYNINIT) && (bus[indexer].full_Y != NULL) && (bus[indexer].DynCurrent != NULL))
 					{
-						for (kindex=0; kindex<2; kindex++)	//Loop through columns of admittance matrices (only 2x2)
+						//Compute the delta_I, just like below - but don't post it (still zero in calcs)
+						work_vals_double_3 = tempPbus - tempIcalcReal;
+						work_vals_double_4 = tempQbus - tempIcalcImag;
+
+						//Form a magnitude vector
+						work_vals_double_0 = sqrt((work_vals_double_3*work_vals_double_3+work_vals_double_4*work_vals_double_4));
+						
+						if (work_vals_double_0 > bus[indexer].max_volt_error)	//Failure check (defaults to voltage convergence for now)
 						{
-							//Make sure one end of us isn't a SPCT transformer To node (they are different)
-							if (((bus[tempa].phases & 0x20) & (bus[tempb].phases & 0x20)) == 0x20)	//Both ends are SPCT tos
+							range->swing_converged=false;
+						}
+					}//End PF_DYNINIT SWING traversion
+
+					//Must be normal run, since DYNRUN should have swing capabilities deflagged
+					//Normal run - zero it - should already be zerod, but let's be paranoid for now
+					powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + jindex] = 0.0;
+					powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = 0.0;
+				}//End SWING bus cases
+				else	//PQ bus or SWING masquerading as a PQ
+				{
+					//It's I.  Just a direct conversion (P changed above to I as well)
+					powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+ powerflow_values->BA_diag[indexer].size + jindex] = tempPbus - tempIcalcReal;
+					powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = tempQbus - tempIcalcImag;
+				}//End Normal PQ bus
+			}//End split-phase present
+			else	//Three phase or some variant thereof
+			{
+				tempPbus =  - bus[indexer].PL[jindex];	//Copy load amounts in
+				tempQbus =  - bus[indexer].QL[jindex];	
+
+				for (kindex=0; kindex<powerflow_values->BA_diag[indexer].size; kindex++)		//cols - Still only for specified phases
+				{
+					//Determine our indices, based on phase information
+					temp_index = -1;
+					switch(bus[indexer].phases & 0x07) {
+						case 0x01:	//C
 							{
-								GL_THROW("NR: SPCT to SPCT via triplex connections are unsupported at this time.");
-								/*  TROUBLESHOOT
-								The Newton-Raphson solve does not currently support running a triplex line between the low-voltage
-								side of two different split-phase center tapped transformers.  This functionality may be added if needed
-								in the future.
-								*/
-							}//end both ends SPCT to
-							else if ((bus[tempa].phases & 0x20) == 0x20)	//From end is a SPCT to
+								temp_index=2;
+								break;
+							}//end 0x01
+						case 0x02:	//B
 							{
-								//Indices counted out from Self admittance above.  needs doubling due to complex separation
+								temp_index=1;
+								break;
+							}//end 0x02
+						case 0x03:	//BC
+							{
+								if (kindex==0)	//B
+									temp_index=1;
+								else	//C
+									temp_index=2;
+								break;
+							}//end 0x03
+						case 0x04:	//A
+							{
+								temp_index=0;
+								break;
+							}//end 0x04
+						case 0x05:	//AC
+							{
+								if (kindex==0)	//A
+									temp_index=0;
+								else			//C
+									temp_index=2;
+								break;
+							}//end 0x05
+						case 0x06:	//AB
+							{
+								if (kindex==0)	//A
+									temp_index=0;
+								else			//B
+									temp_index=1;
+								break;
+							}//end 0x06
+						case 0x07:	//ABC
+							{
+								temp_index = kindex;	//Will loop all 3
+								break;
+							}//end 0x07
+					}//End switch/case
 
-								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
-								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = ((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
-									indexer += 1;
-									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(branch[jindexer].Yfrom[jindex*3+kindex]).Im();
-									indexer += 1;
-								}
+					if (temp_index==-1)	//Error check
+					{
+						NR_RANGE_FAIL("NR: A voltage index failed to be found.");
+						/*  TROUBLESHOOT
+						While attempting to compute the calculated power current, a voltage index failed to be
+						resolved.  Please submit your code and a bug report via the trac website.
+						*/
+					}
 
-								if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
-								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Im());
-									indexer += 1;
-									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yto[jindex*3+kindex]).Im();
-									indexer += 1;
-								}
+					//Normal diagonal contributions
+					tempIcalcReal += (powerflow_values->BA_diag[indexer].Y[jindex][kindex]).Re() * (bus[indexer].V[temp_index]).Re() - (powerflow_values->BA_diag[indexer].Y[jindex][kindex]).Im() * (bus[indexer].V[temp_index]).Im();// equation (7), the diag elements of bus admittance matrix 
+					tempIcalcImag += (powerflow_values->BA_diag[indexer].Y[jindex][kindex]).Re() * (bus[indexer].V[temp_index]).Im() + (powerflow_values->BA_diag[indexer].Y[jindex][kindex]).Im() * (bus[indexer].V[temp_index]).Re();// equation (8), the diag elements of bus admittance matrix 
 
-								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
-								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = ((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-									indexer += 1;
-									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = ((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-									indexer += 1;	
-								}
+					//In-rush load contributions (if any) - only along explicit diagonal
+					if ((bus[indexer].full_Y_load != NULL) && (jindex==kindex))
+					{
+						tempIcalcReal += (bus[indexer].full_Y_load[temp_index]).Re() * (bus[indexer].V[temp_index]).Re() - (bus[indexer].full_Y_load[temp_index]).Im() * (bus[indexer].V[temp_index]).Im();// equation (7), the diag elements of bus admittance matrix 
+						tempIcalcImag += (bus[indexer].full_Y_load[temp_index]).Re() * (bus[indexer].V[temp_index]).Im() + (bus[indexer].full_Y_load[temp_index]).Im() * (bus[indexer].V[temp_index]).Re();// equation (8), the diag elements of bus admittance matrix 
+					}
 
-								if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1 && bus[tempb].type != 1))	//To reals
-								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
-									indexer += 1;
-									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
-									indexer += 1;	
-								}
-							}//end From end SPCT to
-							else if ((bus[tempb].phases & 0x20) == 0x20)	//To end is a SPCT to
+					//Off diagonal contributions
+					//Need another variable to handle the rows
+					temp_index_b = -1;
+					switch(bus[indexer].phases & 0x07) {
+						case 0x01:	//C
 							{
-								//Indices counted out from Self admittance above.  needs doubling due to complex separation
+								temp_index_b=2;
+								break;
+							}//end 0x01
+						case 0x02:	//B
+							{
+								temp_index_b=1;
+								break;
+							}//end 0x02
+						case 0x03:	//BC
+							{
+								if (jindex==0)	//B
+									temp_index_b=1;
+								else	//C
+									temp_index_b=2;
+								break;
+							}//end 0x03
+						case 0x04:	//A
+							{
+								temp_index_b=0;
+								break;
+							}//end 0x04
+						case 0x05:	//AC
+							{
+								if (jindex==0)	//A
+									temp_index_b=0;
+								else			//C
+									temp_index_b=2;
+								break;
+							}//end 0x05
+						case 0x06:	//AB
+							{
+								if (jindex==0)	//A
+									temp_index_b=0;
+								else			//B
+									temp_index_b=1;
+								break;
+							}//end 0x06
+						case 0x07:	//ABC
+							{
+								temp_index_b = jindex;	//Will loop all 3
+								break;
+							}//end 0x07
+					}//End switch/case
 
-								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
-								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
-									indexer += 1;
-									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
-									indexer += 1;
-								}
+					if (temp_index_b==-1)	//Error check
+					{
+						NR_RANGE_FAIL("NR: A voltage index failed to be found.");
+					}
 
-								if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
+					for (kindexer=0; kindexer<(bus[indexer].Link_Table_Size); kindexer++)	//Parse through the branch list
+					{
+						//Apply proper index to jindexer (easier to implement this way)
+						jindexer=bus[indexer].Link_Table[kindexer];
+
+						if (branch[jindexer].from == indexer) 
+						{
+							//See if we're a triplex transformer (will only occur on the from side)
+							if ((branch[jindexer].phases & 0x80) == 0x80)	//Triplexy
+							{
+								proceed_flag = false;
+								phase_worka = branch[jindexer].phases & 0x07;
+
+								if (kindex==0)	//All of this will only occur the first column iteration
 								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Im());
-									indexer += 1;
-									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(branch[jindexer].Yto[jindex*3+kindex]).Im();
-									indexer += 1;
+									switch (bus[indexer].phases & 0x07)	{
+										case 0x01:	//C
+											{
+												if (phase_worka==0x01)
+													proceed_flag=true;
+												break;
+											}//end 0x01
+										case 0x02:	//B
+											{
+												if (phase_worka==0x02)
+													proceed_flag=true;
+												break;
+											}//end 0x02
+										case 0x03:	//BC
+											{
+												if ((jindex==0) && (phase_worka==0x02))	//First row and is a B
+													proceed_flag=true;
+												else if ((jindex==1) && (phase_worka==0x01))	//Second row and is a C
+													proceed_flag=true;
+												else
+													;
+												break;
+											}//end 0x03
+										case 0x04:	//A
+											{
+												if (phase_worka==0x04)
+													proceed_flag=true;
+												break;
+											}//end 0x04
+										case 0x05:	//AC
+											{
+												if ((jindex==0) && (phase_worka==0x04))	//First row and is a A
+													proceed_flag=true;
+												else if ((jindex==1) && (phase_worka==0x01))	//Second row and is a C
+													proceed_flag=true;
+												else
+													;
+												break;
+											}//end 0x05
+										case 0x06:	//AB - shares with ABC
+										case 0x07:	//ABC 
+											{
+												if ((jindex==0) && (phase_worka==0x04))	//A & first row
+													proceed_flag=true;
+												else if ((jindex==1) && (phase_worka==0x02))	//B & second row
+													proceed_flag=true;
+												else if ((jindex==2) && (phase_worka==0x01))	//C & third row
+													proceed_flag=true;
+												else;
+												break;
+											}//end 0x07
+									}//end switch
+								}//End if kindex==0
+
+								if (proceed_flag)
+								{
+									work_vals_char_0 = temp_index_b*3;
+									//Do columns individually
+									//1
+									tempIcalcReal += (-(branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Re() - (-(branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+									tempIcalcImag += (-(branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Im() + (-(branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+
+									//2
+									tempIcalcReal += (-(branch[jindexer].Yfrom[work_vals_char_0+1])).Re() * (bus[branch[jindexer].to].V[1]).Re() - (-(branch[jindexer].Yfrom[work_vals_char_0+1])).Im() * (bus[branch[jindexer].to].V[1]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+									tempIcalcImag += (-(branch[jindexer].Yfrom[work_vals_char_0+1])).Re() * (bus[branch[jindexer].to].V[1]).Im() + (-(branch[jindexer].Yfrom[work_vals_char_0+1])).Im() * (bus[branch[jindexer].to].V[1]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+
 								}
+							}//end SPCT transformer
+							else	///Must be a standard line
+							{
+								work_vals_char_0 = temp_index_b*3+temp_index;
+								work_vals_double_0 = (-branch[jindexer].Yfrom[work_vals_char_0]).Re();
+								work_vals_double_1 = (-branch[jindexer].Yfrom[work_vals_char_0]).Im();
+								work_vals_double_2 = (bus[branch[jindexer].to].V[temp_index]).Re();
+								work_vals_double_3 = (bus[branch[jindexer].to].V[temp_index]).Im();
 
-								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
-								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-									indexer += 1;
-									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-									indexer += 1;	
-								}
-
-								if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1 && bus[tempb].type != 1))	//To reals
-								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Re());
-									indexer += 1;
-									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Re());
-									indexer += 1;	
-								}
-							}//end To end SPCT to
-							else											//Plain old ugly line
-							{
-								//Indices counted out from Self admittance above.  needs doubling due to complex separation
+								tempIcalcReal += work_vals_double_0 * work_vals_double_2 - work_vals_double_1 * work_vals_double_3;// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+								tempIcalcImag += work_vals_double_0 * work_vals_double_3 + work_vals_double_1 * work_vals_double_2;// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
 
-								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
-								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
-									indexer += 1;
-									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
-									indexer += 1;
-								}
+							}//end standard line
+						}	
+						if  (branch[jindexer].to == indexer)
+						{
+							work_vals_char_0 = temp_index_b*3+temp_index;
+							work_vals_double_0 = (-branch[jindexer].Yto[work_vals_char_0]).Re();
+							work_vals_double_1 = (-branch[jindexer].Yto[work_vals_char_0]).Im();
+							work_vals_double_2 = (bus[branch[jindexer].from].V[temp_index]).Re();
+							work_vals_double_3 = (bus[branch[jindexer].from].V[temp_index]).Im();
+
+							tempIcalcReal += work_vals_double_0 * work_vals_double_2 - work_vals_double_1 * work_vals_double_3;// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+							tempIcalcImag += work_vals_double_0 * work_vals_double_3 + work_vals_double_1 * work_vals_double_2;// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+						}
+						else;
+					}
+				}//end intermediate current for each phase column
 
-								if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
-								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Im());
-									indexer += 1;
-									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yto[jindex*3+kindex]).Im();
-									indexer += 1;
-								}
+				//Determine how we are posting this update
+				if ((bus[indexer].type > 1) && (bus[indexer].swing_functions_enabled == true))	//SWING bus is different (when it really is a SWING bus)
+				{
+					if ((powerflow_type == PF_DYNINIT) && (bus[indexer].full_Y != NULL) && (bus[indexer].DynCurrent != NULL))
+					{
+						//Compute our "power generated" value for this phase - conjugated in formation
+						temp_complex_2 = bus[indexer].V[jindex] * complex(tempIcalcReal,-tempIcalcImag);
 
-								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
-								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-									indexer += 1;
-									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-									indexer += 1;	
-								}
+						if (Iteration>0)	//Only update SWING on subsequent passes
+						{
+							//Now add it into the "generation total" for the SWING
+							(*bus[indexer].PGenTotal) += temp_complex_2 - temp_complex_3/3.0; // both PT and QT = Ssource-Sysource = v conj(I) - v conj(ysource v)
+						}
+							
+						//Compute the delta_I, just like below - but don't post it (still zero in calcs)
+						work_vals_double_0 = (bus[indexer].V[temp_index_b]).Mag()*(bus[indexer].V[temp_index_b]).Mag();
 
-								if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1 && bus[tempb].type != 1))	//To reals
-								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
-									indexer += 1;
-									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
-									indexer += 1;	
-								}
-							}//end Normal triplex branch
-						}//column end
-					}//row end
-				}//end both triplexy
-				else if ((bus[tempa].phases & 0x80) == 0x80)	//From is the triplex - this implies transformer with or something, we don't support this
-				{
-					GL_THROW("NR does not support triplex to 3-phase connections.");
-					/*  TROUBLESHOOT
-					The Newton-Raphson solver does not have any implementation elements
-					to support the connection of a split-phase or triplex node to a three-phase
-					node.  The opposite (3-phase to triplex) is available as the split-phase-center-
-					tapped transformer model.  See if that will work for your implementation.
-					*/
-				}//end from triplexy
-				else	//Only option left is the to must be the triplex - implies SPCT xformer - so only one phase on the three-phase side (we just need to figure out where)
-				{
-					//Extract the line phase
-					phase_workc = (branch[jindexer].phases & 0x07);
+						if (work_vals_double_0!=0)	//Only normal one (not square), but a zero is still a zero even after that
+						{
+							work_vals_double_1 = (bus[indexer].V[temp_index_b]).Re();
+							work_vals_double_2 = (bus[indexer].V[temp_index_b]).Im();
+							work_vals_double_3 = (tempPbus * work_vals_double_1 + tempQbus * work_vals_double_2)/ (work_vals_double_0) - tempIcalcReal ; // equation(7), Real part of deltaI, left hand side of equation (11)
+							work_vals_double_4 = (tempPbus * work_vals_double_2 - tempQbus * work_vals_double_1)/ (work_vals_double_0) - tempIcalcImag; // Imaginary part of deltaI, left hand side of equation (11)
 
-					//Reset temp_index and size, just in case
-					temp_index = -1;
-					temp_size = -1;
+							//Form a magnitude value - put in work_vals_double_0, since we're done with it
+							work_vals_double_0 = sqrt((work_vals_double_3*work_vals_double_3+work_vals_double_4*work_vals_double_4));
+						}
+						else	//Would give us a NAN, so it must be out of service or something (case from below - really shouldn't apply to SWING)
+						{
+           						work_vals_double_0 = 0.0;	//Assumes "converged"
+						}
+						
+						if (work_vals_double_0 > bus[indexer].max_volt_error)	//Failure check (defaults to voltage convergence for now)
+						{
+							range->swing_converged=false;
+						}
+					}//End PF_DYNINIT SWING traversion
 
-					//Figure out what the offset on the from side is (how many phases and which one we are)
-					switch(bus[tempa].phases & 0x07)
+					//Effectively Zero out the components, regardless of normal run or not
+					//Should already be zerod, but do it again for paranoia sake
+					if (bus[indexer].BusHistTerm != NULL)	//See if we're "delta-capable"
 					{
-						case 0x01:	//C
-							{
-								temp_size = 1;	//Single phase matrix
+						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + jindex] = bus[indexer].BusHistTerm[jindex].Re();
+						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = bus[indexer].BusHistTerm[jindex].Im();
+					}
+					else
+					{
+						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + jindex] = 0.0;
+						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = 0.0;
+					}
 
-								if (phase_workc==0x01)	//Line is phase C
-								{
-									//Only C in the node, so no offset
-									temp_index = 0;
-								}
-								else if (phase_workc==0x02)	//Line is phase B
-								{
-									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
-									/*  TROUBLESHOOT
-									A split-phase, center-tapped transformer in the Newton-Raphson solver is somehow attached
-									to a node that is missing the required phase of the transformer.  This should have been caught.
-									Please submit your code and a bug report using the trac website.
-									*/
-								}
-								else					//Has to be phase A
-									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+					//Saturation skipped for "swing is a swing" case, since it doesn't affect the admittance (no need to offset)
+				}//End SWING bus cases
+				else	//PQ bus or SWING masquerading as a PQ
+				{
+					work_vals_double_0 = (bus[indexer].V[temp_index_b]).Mag()*(bus[indexer].V[temp_index_b]).Mag();
 
-								break;
-							}
-						case 0x02:	//B
-							{
-								temp_size = 1;	//Single phase matrix
+					if (work_vals_double_0!=0)	//Only normal one (not square), but a zero is still a zero even after that
+					{
+						work_vals_double_1 = (bus[indexer].V[temp_index_b]).Re();
+						work_vals_double_2 = (bus[indexer].V[temp_index_b]).Im();
 
-								if (phase_workc==0x01)	//Line is phase C
-									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
-								else if (phase_workc==0x02)	//Line is phase B
-								{
-									//Only B in the node, so no offset
-									temp_index = 0;
-								}
-								else					//Has to be phase A
-									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+						//See if deltamode needs to include extra term
+						if (bus[indexer].BusHistTerm != NULL)
+						{
+							powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+ powerflow_values->BA_diag[indexer].size + jindex] = (tempPbus * work_vals_double_1 + tempQbus * work_vals_double_2)/ (work_vals_double_0) + bus[indexer].BusHistTerm[jindex].Re() - tempIcalcReal ; // equation(7), Real part of deltaI, left hand side of equation (11)
+							powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = (tempPbus * work_vals_double_2 - tempQbus * work_vals_double_1)/ (work_vals_double_0) + bus[indexer].BusHistTerm[jindex].Im() - tempIcalcImag; // Imaginary part of deltaI, left hand side of equation (11)
+						}
+						else	//Nope
+						{
+							powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+ powerflow_values->BA_diag[indexer].size + jindex] = (tempPbus * work_vals_double_1 + tempQbus * work_vals_double_2)/ (work_vals_double_0) - tempIcalcReal ; // equation(7), Real part of deltaI, left hand side of equation (11)
+							powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = (tempPbus * work_vals_double_2 - tempQbus * work_vals_double_1)/ (work_vals_double_0) - tempIcalcImag; // Imaginary part of deltaI, left hand side of equation (11)
+						}
 
-								break;
-							}
-						case 0x03:	//BC
-							{
-								temp_size = 2;	//Two phase matrix
+						//Accumulate in any saturation current values as well, while we're here
+						if (bus[indexer].BusSatTerm != NULL)
+						{
+							powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+ powerflow_values->BA_diag[indexer].size + jindex] -= bus[indexer].BusSatTerm[jindex].Re();
+							powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] -= bus[indexer].BusSatTerm[jindex].Im();
+						}
+					}
+					else
+					{
+						if (bus[indexer].BusHistTerm != NULL)	//See if extra deltamode term needs to be included
+						{
+           						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + jindex] = bus[indexer].BusHistTerm[jindex].Re();
+							powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = bus[indexer].BusHistTerm[jindex].Im();
+						}
+						else
+						{
+           						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + jindex] = 0.0;
+							powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = 0.0;
+						}
 
-								if (phase_workc==0x01)	//Line is phase C
-								{
-									//BC in the node, so offset by 1
-									temp_index = 1;
-								}
-								else if (phase_workc==0x02)	//Line is phase B
-								{
-									//BC in the node, so offset by 0
-									temp_index = 0;
-								}
-								else					//Has to be phase A
-									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+						//Accumulate in any saturation current values as well, while we're here
+						if (bus[indexer].BusSatTerm != NULL)
+						{
+							powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+ powerflow_values->BA_diag[indexer].size + jindex] -= bus[indexer].BusSatTerm[jindex].Re();
+							powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] -= bus[indexer].BusSatTerm[jindex].Im();
+						}
+					}
+				}//End normal bus handling
+			}//End three-phase or variant thereof
+		}//End delta_I for each phase row
 
-								break;
-							}
-						case 0x04:	//A
-							{
-								temp_size = 1;	//Single phase matrix
+		//Add in generator current amounts, if relevant
+		if (powerflow_type != PF_NORMAL)
+		{
+			//Secondary check - see if it is even needed - basically built around 3-phase right now (checks)
+			if ((*bus[indexer].dynamics_enabled==true) && (bus[indexer].full_Y != NULL) && (bus[indexer].DynCurrent != NULL))
+			{
+				if ((bus[indexer].phases & 0x07) == 0x07)	//Make sure is three-phase
+				{
+					//Only update in particular mode - SWING bus values should still be treated as such
+					if ((swing_is_a_swing == true) && (powerflow_type == PF_DYNINIT))	//Really only true for PF_DYNINIT anyways
+					{
+						//Power should be all updated, now update current values
+						temp_complex_0 += complex((*bus[indexer].PGenTotal).Re(),-(*bus[indexer].PGenTotal).Im()); // total generated power injected congugated
 
-								if (phase_workc==0x01)	//Line is phase C
-									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
-								else if (phase_workc==0x02)	//Line is phase B
-									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
-								else					//Has to be phase A
-								{
-									//Only A in the node, so no offset
-									temp_index = 0;
-								}
+						//Compute Ii
+						if (temp_complex_1.Mag() > 0.0)	//Non zero
+						{
+							temp_complex_2 = temp_complex_0/temp_complex_1;	//Forms Ii
 
-								break;
-							}
-						case 0x05:	//AC
-							{
-								temp_size = 2;	//Two phase matrix
+							//Now convert Ii to the individual phase amounts
+							bus[indexer].DynCurrent[0] = temp_complex_2;
+							bus[indexer].DynCurrent[1] = temp_complex_2*avalsq;
+							bus[indexer].DynCurrent[2] = temp_complex_2*aval;
+						}
+						else	//Must make zero
+						{
+							bus[indexer].DynCurrent[0] = complex(0.0,0.0);
+							bus[indexer].DynCurrent[1] = complex(0.0,0.0);
+							bus[indexer].DynCurrent[2] = complex(0.0,0.0);
+						}
+					}//End SWING is still swing, otherwise should just accumulate what it had
 
-								if (phase_workc==0x01)	//Line is phase C
-								{
-									//AC in the node, so offset by 1
-									temp_index = 1;
-								}
-								else if (phase_workc==0x02)	//Line is phase B
-									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
-								else					//Has to be phase A
-								{
-									//AC in the node, so offset by 0
-									temp_index = 0;
-								}
+					//Don't get added in as part of "normal swing" routine
+					if ((bus[indexer].type == 0) || ((bus[indexer].type>1) && (bus[indexer].swing_functions_enabled == false)))
+					{
+						//Add these into the system - added because "generation"
+       						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size] += bus[indexer].DynCurrent[0].Re();		//Phase A
+       						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + 1] += bus[indexer].DynCurrent[1].Re();	//Phase B
+       						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + 2] += bus[indexer].DynCurrent[2].Re();	//Phase C
 
-								break;
-							}
-						case 0x06:	//AB
-							{
-								temp_size = 2;	//Two phase matrix
+						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc] += bus[indexer].DynCurrent[0].Im();		//Phase A
+						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + 1] += bus[indexer].DynCurrent[1].Im();	//Phase B
+						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + 2] += bus[indexer].DynCurrent[2].Im();	//Phase C
+					}
+					//Defaulted else - leave as they were
+				}//End three-phase
+				else	//Not three-phase athe moment
+				{
+					//See if we ever were (reliability call)
+					if ((bus[indexer].origphases & 0x07) == 0x07)
+					{
+						//Just zero it
+						bus[indexer].DynCurrent[0] = complex(0.0,0.0);
+						bus[indexer].DynCurrent[1] = complex(0.0,0.0);
+						bus[indexer].DynCurrent[2] = complex(0.0,0.0);
+					}
+					else	//Never was, just fail out
+					{
+						NR_RANGE_FAIL("NR_solver: bus:%s has tried updating deltamode dyanmics, but is not three-phase!");
+						/*  TROUBLESHOOT
+						The NR_solver routine tried update a three-phase current value for a bus that is not
+						three phase.  At this time, the deltamode system only supports three-phase buses for
+						generator attachment.
+						*/
+					}
+				}
+			}//End extra current adds
+		}//End dynamic (generator postings)
+	}//End delta_I for each bus
+}
 
-								if (phase_workc==0x01)	//Line is phase C
-									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
-								else if (phase_workc==0x02)	//Line is phase B
-								{
-									//BC in the node, so offset by 1
-									temp_index = 1;
-								}
-								else					//Has to be phase A
-								{
-									//AB in the node, so offset by 0
-									temp_index = 0;
-								}
+/** Load contributions to the Jacobian diagonal (Jacob_A..D) of each bus in the range **/
+static void NR_range_jacobian(NR_RANGE *range)
+{
+	BUSDATA *bus = range->bus;
+	NR_SOLVER_STRUCT *powerflow_values = range->powerflow_values;
+	unsigned int indexer;
+	char jindex, temp_index, temp_index_b;
+	complex undeltacurr[3], delta_current[3], voltageDel[3], temp_current[3], temp_store[3];
+	complex adjusted_constant_current[6], adjust_temp_nominal_voltage[6];
+	double adjust_temp_voltage_mag[6];
+	double adjust_nominal_voltage_val, adjust_nominal_voltaged_val;
 
-								break;
-							}
-						case 0x07:	//ABC
-							{
-								temp_size = 3;	//Three phase matrix
+	for (indexer=range->first; indexer<range->last; indexer++)
+	{
+		if ((bus[indexer].phases & 0x08) == 0x08)	//Delta connected node
+		{
+			//Populate the values for constant current -- deltamode different right now (all same in future?)
+			if (*bus[indexer].dynamics_enabled == true)
+			{
+				//Create nominal magnitudes
+				adjust_nominal_voltage_val = bus[indexer].volt_base * sqrt(3.0);
+
+				//Create the nominal voltage vectors
+				adjust_temp_nominal_voltage[0].SetPolar(adjust_nominal_voltage_val,PI/6.0);
+				adjust_temp_nominal_voltage[1].SetPolar(adjust_nominal_voltage_val,-1.0*PI/2.0);
+				adjust_temp_nominal_voltage[2].SetPolar(adjust_nominal_voltage_val,5.0*PI/6.0);
+
+				//Compute delta voltages
+				voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
+				voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
+				voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
+
+				//Get magnitudes of all
+				adjust_temp_voltage_mag[0] = voltageDel[0].Mag();
+				adjust_temp_voltage_mag[1] = voltageDel[1].Mag();
+				adjust_temp_voltage_mag[2] = voltageDel[2].Mag();
+
+				//Start adjustments - AB
+				if ((bus[indexer].I[0] != 0.0) && (adjust_temp_voltage_mag[0] != 0.0))
+				{
+					//calculate new value
+					adjusted_constant_current[0] = ~(adjust_temp_nominal_voltage[0] * ~bus[indexer].I[0] * adjust_temp_voltage_mag[0] / (voltageDel[0] * adjust_nominal_voltage_val));
+				}
+				else
+				{
+					adjusted_constant_current[0] = 0.0;
+				}
 
-								if (phase_workc==0x01)	//Line is phase C
-								{
-									//ABC in the node, so offset by 2
-									temp_index = 2;
-								}
-								else if (phase_workc==0x02)	//Line is phase B
-								{
-									//ABC in the node, so offset by 1
-									temp_index = 1;
-								}
-								else					//Has to be phase A
-								{
-									//ABC in the node, so offset by 0
-									temp_index = 0;
-								}
+				//Start adjustments - BC
+				if ((bus[indexer].I[1] != 0.0) && (adjust_temp_voltage_mag[1] != 0.0))
+				{
+					//calculate new value
+					adjusted_constant_current[1] = ~(adjust_temp_nominal_voltage[1] * ~bus[indexer].I[1] * adjust_temp_voltage_mag[1] / (voltageDel[1] * adjust_nominal_voltage_val));
+				}
+				else
+				{
+					adjusted_constant_current[1] = 0.0;
+				}
 
-								break;
-							}
-						default:
-							GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
-							break;
-					}//end switch
-					if ((temp_index==-1) || (temp_size==-1))	//Should never get here
-						GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+				//Start adjustments - CA
+				if ((bus[indexer].I[2] != 0.0) && (adjust_temp_voltage_mag[2] != 0.0))
+				{
+					//calculate new value
+					adjusted_constant_current[2] = ~(adjust_temp_nominal_voltage[2] * ~bus[indexer].I[2] * adjust_temp_voltage_mag[2] / (voltageDel[2] * adjust_nominal_voltage_val));
+				}
+				else
+				{
+					adjusted_constant_current[2] = 0.0;
+				}
 
-					//Determine first index
-					if (phase_workc==0x01)	//Line is phase C
-					{
-						jindex=2;
-					}//end line C if
-					else if (phase_workc==0x02)	//Line is phase B
+				//See if we have any "different children"
+				if ((bus[indexer].phases & 0x10) == 0x10)
+				{
+					//Create nominal magnitudes
+					adjust_nominal_voltage_val = bus[indexer].volt_base;
+
+					//Create the nominal voltage vectors
+					adjust_temp_nominal_voltage[3].SetPolar(bus[indexer].volt_base,0.0);
+					adjust_temp_nominal_voltage[4].SetPolar(bus[indexer].volt_base,-2.0*PI/3.0);
+					adjust_temp_nominal_voltage[5].SetPolar(bus[indexer].volt_base,2.0*PI/3.0);
+
+					//Get magnitudes of all
+					adjust_temp_voltage_mag[3] = bus[indexer].V[0].Mag();
+					adjust_temp_voltage_mag[4] = bus[indexer].V[1].Mag();
+					adjust_temp_voltage_mag[5] = bus[indexer].V[2].Mag();
+
+					//Start adjustments - A
+					if ((bus[indexer].extra_var[6] != 0.0) && (adjust_temp_voltage_mag[3] != 0.0))
 					{
-						jindex=1;
-					}//end line B if
-					else						//Line has to be phase A
+						//calculate new value
+						adjusted_constant_current[3] = ~(adjust_temp_nominal_voltage[3] * ~bus[indexer].extra_var[6] * adjust_temp_voltage_mag[3] / (bus[indexer].V[0] * adjust_nominal_voltage_val));
+					}
+					else
 					{
-						jindex=0;
-					}//End line A if
+						adjusted_constant_current[3] = 0.0;
+					}
 
+					//Start adjustments - B
+					if ((bus[indexer].extra_var[7] != 0.0) && (adjust_temp_voltage_mag[4] != 0.0))
+					{
+						//calculate new value
+						adjusted_constant_current[4] = ~(adjust_temp_nominal_voltage[4] * ~bus[indexer].extra_var[7] * adjust_temp_voltage_mag[4] / (bus[indexer].V[1] * adjust_nominal_voltage_val));
+					}
+					else
+					{
+						adjusted_constant_current[4] = 0.0;
+					}
 
-					//Indices counted out from Self admittance above.  needs doubling due to complex separation
-					for (kindex=0; kindex<2; kindex++)	//Loop through columns of admittance matrices (only 2x2)
+					//Start adjustments - C
+					if ((bus[indexer].extra_var[8] != 0.0) && (adjust_temp_voltage_mag[5] != 0.0))
+					{
+						//calculate new value
+						adjusted_constant_current[5] = ~(adjust_temp_nominal_voltage[5] * ~bus[indexer].extra_var[8] * adjust_temp_voltage_mag[5] / (bus[indexer].V[2] * adjust_nominal_voltage_val));
+					}
+					else
 					{
+						adjusted_constant_current[5] = 0.0;
+					}
+				}
+				else	//Nope
+				{
+					//Set to zero, just cause
+					adjusted_constant_current[3] = 0.0;
+					adjusted_constant_current[4] = 0.0;
+					adjusted_constant_current[5] = 0.0;
+				}
+			}
+			else	//"Normal" modes -- handle traditionally
+			{
+				adjusted_constant_current[0] = bus[indexer].I[0];
+				adjusted_constant_current[1] = bus[indexer].I[1];
+				adjusted_constant_current[2] = bus[indexer].I[2];
 
-						if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
-						{
-							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index;
-							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-							powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
-							indexer += 1;
-							
-							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
-							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-							powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
-							indexer += 1;
-						}
+				//See if we have different children too
+				if ((bus[indexer].phases & 0x10) == 0x10)
+				{
+					//Store them too
+					adjusted_constant_current[3] = bus[indexer].extra_var[6];
+					adjusted_constant_current[4] = bus[indexer].extra_var[7];
+					adjusted_constant_current[5] = bus[indexer].extra_var[8];
+				}
+				else	//Nope, just zero this for now
+				{
+					adjusted_constant_current[3] = 0.0;
+					adjusted_constant_current[4] = 0.0;
+					adjusted_constant_current[5] = 0.0;
+				}
+			}//End adjustment code
 
-						if (((branch[jindexer].Yto[kindex*3+jindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
-						{
-							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex;
-							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index;
-							powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[kindex*3+jindex]).Im());
-							indexer += 1;
-							
-							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
-							powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yto[kindex*3+jindex]).Im();
-							indexer += 1;
-						}
+			//Delta components - populate according to what is there
+			if ((bus[indexer].phases & 0x06) == 0x06)	//Check for AB
+			{
+				//Voltage calculations
+				voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
 
-						if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
-						{
-							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
-							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-							powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-							indexer += 1;
-							
-							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index;
-							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-							powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-							indexer += 1;	
-						}
+				//Power - convert to a current (uses less iterations this way)
+				delta_current[0] = (voltageDel[0] == 0) ? 0 : ~(bus[indexer].S[0]/voltageDel[0]);
 
-						if (((branch[jindexer].Yto[kindex*3+jindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
-						{
-							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index;
-							powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[kindex*3+jindex]).Re());
-							indexer += 1;
-							
-							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex;
-							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
-							powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[kindex*3+jindex]).Re());
-							indexer += 1;	
-						}
-					}//secondary index end
+				//Convert delta connected load to appropriate Wye
+				delta_current[0] += voltageDel[0] * (bus[indexer].Y[0]);
 
-				}//end to triplexy
-			}//end triplex in here
-			else					//Some combination of not-3 phase
+			}
+			else
 			{
-				//Clear working variables, just in case
-				temp_index = temp_index_b = -1;
-				temp_size = temp_size_b = temp_size_c = -1;
-				Full_Mat_A = Full_Mat_B = false;
+				//Zero values - they shouldn't be used anyhow
+				voltageDel[0] = 0.0;
+				delta_current[0] = 0.0;
+			}
 
-				//Intermediate store the admittance matrices so they can be directly indexed later
-				switch(branch[jindexer].phases & 0x07) {
-					case 0x00:	//No phases (open switch or reliability excluded item)
+			if ((bus[indexer].phases & 0x03) == 0x03)	//Check for BC
+			{
+				//Voltage calculations
+				voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
+
+				//Power - convert to a current (uses less iterations this way)
+				delta_current[1] = (voltageDel[1] == 0) ? 0 : ~(bus[indexer].S[1]/voltageDel[1]);
+
+				//Convert delta connected load to appropriate Wye
+				delta_current[1] += voltageDel[1] * (bus[indexer].Y[1]);
+
+			}
+			else
+			{
+				//Zero unused
+				voltageDel[1] = 0.0;
+				delta_current[1] = 0.0;
+			}
+
+			if ((bus[indexer].phases & 0x05) == 0x05)	//Check for CA
+			{
+				//Voltage calculations
+				voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
+
+				//Power - convert to a current (uses less iterations this way)
+				delta_current[2] = (voltageDel[2] == 0) ? 0 : ~(bus[indexer].S[2]/voltageDel[2]);
+
+				//Convert delta connected load to appropriate Wye
+				delta_current[2] += voltageDel[2] * (bus[indexer].Y[2]);
+
+			}
+			else
+			{
+				//Zero unused
+				voltageDel[2] = 0.0;
+				delta_current[2] = 0.0;
+			}
+			
+			//Convert delta-current into a phase current, where appropriate - reuse temp variable
+			//Everything will be accumulated into the "current" field for ease (including differents)
+			if ((bus[indexer].phases & 0x04) == 0x04)	//Has a phase A
+			{
+				undeltacurr[0]=(adjusted_constant_current[0]+delta_current[0])-(adjusted_constant_current[2]+delta_current[2]);
+
+				//Check for "different" children and apply them, as well
+				if ((bus[indexer].phases & 0x10) == 0x10)	//We do, so they must be Wye-connected
+				{
+					//Power values
+					undeltacurr[0] += (bus[indexer].V[0] == 0) ? 0 : ~(bus[indexer].extra_var[0]/bus[indexer].V[0]);
+
+					//Shunt values
+					undeltacurr[0] += bus[indexer].extra_var[3]*bus[indexer].V[0];
+
+					//Current values
+					undeltacurr[0] += adjusted_constant_current[3];
+				}
+			}
+			else
+			{
+				//Zero it, just in case
+				undeltacurr[0] = 0.0;
+			}
+
+			if ((bus[indexer].phases & 0x02) == 0x02)	//Has a phase B
+			{
+				undeltacurr[1]=(adjusted_constant_current[1]+delta_current[1])-(adjusted_constant_current[0]+delta_current[0]);
+
+				//Check for "different" children and apply them, as well
+				if ((bus[indexer].phases & 0x10) == 0x10)	//We do, so they must be Wye-connected
+				{
+					//Power values
+					undeltacurr[1] += (bus[indexer].V[1] == 0) ? 0 : ~(bus[indexer].extra_var[1]/bus[indexer].V[1]);
+
+					//Shunt values
+					undeltacurr[1] += bus[indexer].extra_var[4]*bus[indexer].V[1];
+
+					//Current values
+					undeltacurr[1] += adjusted_constant_current[4];
+				}
+			}
+			else
+			{
+				//Zero it, just in case
+				undeltacurr[1] = 0.0;
+			}
+
+
+			if ((bus[indexer].phases & 0x01) == 0x01)	//Has a phase C
+			{
+				undeltacurr[2]=(adjusted_constant_current[2]+delta_current[2])-(adjusted_constant_current[1]+delta_current[1]);
+
+				//Check for "different" children and apply them, as well
+				if ((bus[indexer].phases & 0x10) == 0x10)		//We do, so they must be Wye-connected
+				{
+					//Power values
+					undeltacurr[2] += (bus[indexer].V[2] == 0) ? 0 : ~(bus[indexer].extra_var[2]/bus[indexer].V[2]);
+
+					//Shunt values
+					undeltacurr[2] += bus[indexer].extra_var[5]*bus[indexer].V[2];
+
+					//Current values
+					undeltacurr[2] += adjusted_constant_current[5];
+				}
+			}
+			else
+			{
+				//Zero it, just in case
+				undeltacurr[2] = 0.0;
+			}
+
+			//Provide updates to relevant phases
+			//only compute and store phases that exist (make top heavy)
+			temp_index = -1;
+			temp_index_b = -1;
+			
+			for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
+			{
+				switch(bus[indexer].phases & 0x07) {
+					case 0x01:	//C
 						{
-							temp_size_c = -99;	//Arbitrary flag
+							temp_index=0;
+							temp_index_b=2;
 							break;
 						}
-					case 0x01:	//C only
+					case 0x02:	//B
 						{
-							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[8];
-							Temp_Ad_B[0][0] = branch[jindexer].Yto[8];
-							temp_size_c = 1;
+							temp_index=0;
+							temp_index_b=1;
 							break;
 						}
-					case 0x02:	//B only
+					case 0x03:	//BC
 						{
-							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[4];
-							Temp_Ad_B[0][0] = branch[jindexer].Yto[4];
-							temp_size_c = 1;
-							break;
-						}
-					case 0x03:	//BC only
-						{
-							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[4];
-							Temp_Ad_A[0][1] = branch[jindexer].Yfrom[5];
-							Temp_Ad_A[1][0] = branch[jindexer].Yfrom[7];
-							Temp_Ad_A[1][1] = branch[jindexer].Yfrom[8];
-							
-							Temp_Ad_B[0][0] = branch[jindexer].Yto[4];
-							Temp_Ad_B[0][1] = branch[jindexer].Yto[5];
-							Temp_Ad_B[1][0] = branch[jindexer].Yto[7];
-							Temp_Ad_B[1][1] = branch[jindexer].Yto[8];
-
-							temp_size_c = 2;
+							if (jindex==0)	//B
+							{
+								temp_index=0;
+								temp_index_b=1;
+							}
+							else			//C
+							{
+								temp_index=1;
+								temp_index_b=2;
+							}
 							break;
 						}
-					case 0x04:	//A only
+					case 0x04:	//A
 						{
-							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[0];
-							Temp_Ad_B[0][0] = branch[jindexer].Yto[0];
-							temp_size_c = 1;
+							temp_index=0;
+							temp_index_b=0;
 							break;
 						}
-					case 0x05:	//AC only
+					case 0x05:	//AC
 						{
-							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[0];
-							Temp_Ad_A[0][1] = branch[jindexer].Yfrom[2];
-							Temp_Ad_A[1][0] = branch[jindexer].Yfrom[6];
-							Temp_Ad_A[1][1] = branch[jindexer].Yfrom[8];
-							
-							Temp_Ad_B[0][0] = branch[jindexer].Yto[0];
-							Temp_Ad_B[0][1] = branch[jindexer].Yto[2];
-							Temp_Ad_B[1][0] = branch[jindexer].Yto[6];
-							Temp_Ad_B[1][1] = branch[jindexer].Yto[8];
-
-							temp_size_c = 2;
+							if (jindex==0)	//A
+							{
+								temp_index=0;
+								temp_index_b=0;
+							}
+							else			//C
+							{
+								temp_index=1;
+								temp_index_b=2;
+							}
 							break;
 						}
-					case 0x06:	//AB only
+					case 0x06:	//AB
+					case 0x07:	//ABC
 						{
-							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[0];
-							Temp_Ad_A[0][1] = branch[jindexer].Yfrom[1];
-							Temp_Ad_A[1][0] = branch[jindexer].Yfrom[3];
-							Temp_Ad_A[1][1] = branch[jindexer].Yfrom[4];
-							
-							Temp_Ad_B[0][0] = branch[jindexer].Yto[0];
-							Temp_Ad_B[0][1] = branch[jindexer].Yto[1];
-							Temp_Ad_B[1][0] = branch[jindexer].Yto[3];
-							Temp_Ad_B[1][1] = branch[jindexer].Yto[4];
-
-							temp_size_c = 2;
+							temp_index=jindex;
+							temp_index_b=jindex;
 							break;
 						}
 					default:
-						{
-							break;
-						}
-				}//end line switch/case
+						break;
+				}//end case
 
-				if (temp_size_c==-99)
+				if ((temp_index==-1) || (temp_index_b==-1))
 				{
-					continue;	//Next iteration of branch loop
+					NR_RANGE_FAIL("NR: A Jacobian update element failed.");
+					//Defined below
 				}
 
-				if (temp_size_c==-1)	//Make sure it is right
+				if ((bus[indexer].V[temp_index_b]).Mag()!=0)
 				{
-					GL_THROW("NR: A line's phase was flagged as not full three-phase, but wasn't");
-					/*  TROUBLESHOOT
-					A line inside the powerflow model was flagged as not being full three-phase or
-					triplex in any form.  It failed the other cases though, so it must have been.
-					Please submit your code and a bug report to the trac website.
-					*/
+					bus[indexer].Jacob_A[temp_index] = ((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Re() + (undeltacurr[temp_index_b]).Im() *pow((bus[indexer].V[temp_index_b]).Im(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3);// second part of equation(37) - no power term needed
+					bus[indexer].Jacob_B[temp_index] = -((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Im() + (undeltacurr[temp_index_b]).Re() *pow((bus[indexer].V[temp_index_b]).Re(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3);// second part of equation(38) - no power term needed
+					bus[indexer].Jacob_C[temp_index] =((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Im() - (undeltacurr[temp_index_b]).Re() *pow((bus[indexer].V[temp_index_b]).Im(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3);// second part of equation(39) - no power term needed
+					bus[indexer].Jacob_D[temp_index] = ((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Re() - (undeltacurr[temp_index_b]).Im() *pow((bus[indexer].V[temp_index_b]).Re(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3);// second part of equation(40) - no power term needed
+				}
+				else	//Zero voltage = only impedance is valid (others get divided by VMag, so are IND) - not entirely sure how this gets in here anyhow
+				{
+					bus[indexer].Jacob_A[temp_index] = -1e-4;	//Small offset to avoid singularities (if impedance is zero too)
+					bus[indexer].Jacob_B[temp_index] = -1e-4;
+					bus[indexer].Jacob_C[temp_index] = -1e-4;
+					bus[indexer].Jacob_D[temp_index] = -1e-4;
+				}
+			}//End phase traversion
+		}//end delta-connected load
+		else if	((bus[indexer].phases & 0x80) == 0x80)	//Split phase computations
+		{
+			//Convert it all back to current (easiest to handle)
+			//Get V12 first
+			voltageDel[0] = bus[indexer].V[0] + bus[indexer].V[1];
+
+			//Start with the currents (just put them in)
+			temp_current[0] = bus[indexer].I[0];
+			temp_current[1] = bus[indexer].I[1];
+			temp_current[2] = *bus[indexer].extra_var; //current12 is not part of the standard current array
+
+			//Add in deltamode unrotated, if necessary
+			if ((bus[indexer].prerot_I[2] != 0.0) && (*bus[indexer].dynamics_enabled == true))
+				temp_current[2] += bus[indexer].prerot_I[2];
+
+			//Now add in power contributions
+			temp_current[0] += bus[indexer].V[0] == 0.0 ? 0.0 : ~(bus[indexer].S[0]/bus[indexer].V[0]);
+			temp_current[1] += bus[indexer].V[1] == 0.0 ? 0.0 : ~(bus[indexer].S[1]/bus[indexer].V[1]);
+			temp_current[2] += voltageDel[0] == 0.0 ? 0.0 : ~(bus[indexer].S[2]/voltageDel[0]);
+
+			//Last, but not least, admittance/impedance contributions
+			temp_current[0] += bus[indexer].Y[0]*bus[indexer].V[0];
+			temp_current[1] += bus[indexer].Y[1]*bus[indexer].V[1];
+			temp_current[2] += bus[indexer].Y[2]*voltageDel[0];
+
+			//See if we are a house-connected node, if so, adjust and add in those values as well
+			if ((bus[indexer].phases & 0x40) == 0x40)
+			{
+				//Update phase adjustments
+				temp_store[0].SetPolar(1.0,bus[indexer].V[0].Arg());	//Pull phase of V1
+				temp_store[1].SetPolar(1.0,bus[indexer].V[1].Arg());	//Pull phase of V2
+				temp_store[2].SetPolar(1.0,voltageDel[0].Arg());		//Pull phase of V12
+
+				//Update these current contributions (use delta current variable, it isn't used in here anyways)
+				delta_current[0] = bus[indexer].house_var[0]/(~temp_store[0]);		//Just denominator conjugated to keep math right (rest was conjugated in house)
+				delta_current[1] = bus[indexer].house_var[1]/(~temp_store[1]);
+				delta_current[2] = bus[indexer].house_var[2]/(~temp_store[2]);
+
+				//Now add it into the current contributions
+				temp_current[0] += delta_current[0];
+				temp_current[1] += delta_current[1];
+				temp_current[2] += delta_current[2];
+			}//End house-attached splitphase
+
+			//Convert 'em to line currents - they need to be negated (due to the convention from earlier)
+			temp_store[0] = -(temp_current[0] + temp_current[2]);
+			temp_store[1] = -(-temp_current[1] - temp_current[2]);
+
+			for (jindex=0; jindex<2; jindex++)
+			{
+				if ((bus[indexer].V[jindex]).Mag()!=0)	//Only current
+				{
+					bus[indexer].Jacob_A[jindex] = ((bus[indexer].V[jindex]).Re()*(bus[indexer].V[jindex]).Im()*(temp_store[jindex]).Re() + (temp_store[jindex]).Im() *pow((bus[indexer].V[jindex]).Im(),2))/pow((bus[indexer].V[jindex]).Mag(),3);// second part of equation(37)
+					bus[indexer].Jacob_B[jindex] = -((bus[indexer].V[jindex]).Re()*(bus[indexer].V[jindex]).Im()*(temp_store[jindex]).Im() + (temp_store[jindex]).Re() *pow((bus[indexer].V[jindex]).Re(),2))/pow((bus[indexer].V[jindex]).Mag(),3);// second part of equation(38)
+					bus[indexer].Jacob_C[jindex] =((bus[indexer].V[jindex]).Re()*(bus[indexer].V[jindex]).Im()*(temp_store[jindex]).Im() - (temp_store[jindex]).Re() *pow((bus[indexer].V[jindex]).Im(),2))/pow((bus[indexer].V[jindex]).Mag(),3);// second part of equation(39)
+					bus[indexer].Jacob_D[jindex] = ((bus[indexer].V[jindex]).Re()*(bus[indexer].V[jindex]).Im()*(temp_store[jindex]).Re() - (temp_store[jindex]).Im() *pow((bus[indexer].V[jindex]).Re(),2))/pow((bus[indexer].V[jindex]).Mag(),3);// second part of equation(40)
+				}
+				else
+				{
+					bus[indexer].Jacob_A[jindex]=  -1e-4;	//Put very small to avoid singularity issues
+					bus[indexer].Jacob_B[jindex]=  -1e-4;
+					bus[indexer].Jacob_C[jindex]=  -1e-4;
+					bus[indexer].Jacob_D[jindex]=  -1e-4;
 				}
+			}
 
-				//Check the from side and get all appropriate offsets
-				switch(bus[tempa].phases & 0x07) {
+			//Zero the last elements, just to be safe (shouldn't be an issue, but who knows)
+			bus[indexer].Jacob_A[2] = 0.0;
+			bus[indexer].Jacob_B[2] = 0.0;
+			bus[indexer].Jacob_C[2] = 0.0;
+			bus[indexer].Jacob_D[2] = 0.0;
+
+		}//end split-phase connected
+		else	//Wye-connected system/load
+		{
+			//Populate the values for constant current -- deltamode different right now (all same in future?)
+			if (*bus[indexer].dynamics_enabled == true)
+			{
+				//Create nominal magnitudes
+				adjust_nominal_voltage_val = bus[indexer].volt_base;
+
+				//Create the nominal voltage vectors
+				adjust_temp_nominal_voltage[3].SetPolar(bus[indexer].volt_base,0.0);
+				adjust_temp_nominal_voltage[4].SetPolar(bus[indexer].volt_base,-2.0*PI/3.0);
+				adjust_temp_nominal_voltage[5].SetPolar(bus[indexer].volt_base,2.0*PI/3.0);
+
+				//Get magnitudes of all
+				adjust_temp_voltage_mag[3] = bus[indexer].V[0].Mag();
+				adjust_temp_voltage_mag[4] = bus[indexer].V[1].Mag();
+				adjust_temp_voltage_mag[5] = bus[indexer].V[2].Mag();
+
+				//Start adjustments - A
+				if ((bus[indexer].I[0] != 0.0) && (adjust_temp_voltage_mag[3] != 0.0))
+				{
+					//calculate new value
+					adjusted_constant_current[0] = ~(adjust_temp_nominal_voltage[3] * ~bus[indexer].I[0] * adjust_temp_voltage_mag[3] / (bus[indexer].V[0] * adjust_nominal_voltage_val));
+				}
+				else
+				{
+					adjusted_constant_current[0] = 0.0;
+				}
+
+				//Start adjustments - B
+				if ((bus[indexer].I[1] != 0.0) && (adjust_temp_voltage_mag[4] != 0.0))
+				{
+					//calculate new value
+					adjusted_constant_current[1] = ~(adjust_temp_nominal_voltage[4] * ~bus[indexer].I[1] * adjust_temp_voltage_mag[4] / (bus[indexer].V[1] * adjust_nominal_voltage_val));
+				}
+				else
+				{
+					adjusted_constant_current[1] = 0.0;
+				}
+
+				//Start adjustments - C
+				if ((bus[indexer].I[2] != 0.0) && (adjust_temp_voltage_mag[5] != 0.0))
+				{
+					//calculate new value
+					adjusted_constant_current[2] = ~(adjust_temp_nominal_voltage[5] * ~bus[indexer].I[2] * adjust_temp_voltage_mag[5] / (bus[indexer].V[2] * adjust_nominal_voltage_val));
+				}
+				else
+				{
+					adjusted_constant_current[2] = 0.0;
+				}
+
+				if (bus[indexer].prerot_I[0] != 0.0)
+					adjusted_constant_current[0] += bus[indexer].prerot_I[0];
+
+				if (bus[indexer].prerot_I[1] != 0.0)
+					adjusted_constant_current[1] += bus[indexer].prerot_I[1];
+
+				if (bus[indexer].prerot_I[2] != 0.0)
+					adjusted_constant_current[2] += bus[indexer].prerot_I[2];
+
+				//See if we have any "different children"
+				if ((bus[indexer].phases & 0x10) == 0x10)
+				{
+					//Create nominal magnitudes
+					adjust_nominal_voltage_val = bus[indexer].volt_base * sqrt(3.0);
+
+					//Create the nominal voltage vectors
+					adjust_temp_nominal_voltage[0].SetPolar(adjust_nominal_voltage_val,PI/6.0);
+					adjust_temp_nominal_voltage[1].SetPolar(adjust_nominal_voltage_val,-1.0*PI/2.0);
+					adjust_temp_nominal_voltage[2].SetPolar(adjust_nominal_voltage_val,5.0*PI/6.0);
+
+					//Compute delta voltages
+					voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
+					voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
+					voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
+
+					//Get magnitudes of all
+					adjust_temp_voltage_mag[0] = voltageDel[0].Mag();
+					adjust_temp_voltage_mag[1] = voltageDel[1].Mag();
+					adjust_temp_voltage_mag[2] = voltageDel[2].Mag();
+
+					//Start adjustments - AB
+					if ((bus[indexer].extra_var[6] != 0.0) && (adjust_temp_voltage_mag[0] != 0.0))
+					{
+						//calculate new value
+						adjusted_constant_current[3] = ~(adjust_temp_nominal_voltage[0] * ~bus[indexer].extra_var[6] * adjust_temp_voltage_mag[0] / (voltageDel[0] * adjust_nominal_voltage_val));
+					}
+					else
+					{
+						adjusted_constant_current[3] = 0.0;
+					}
+
+					//Start adjustments - BC
+					if ((bus[indexer].extra_var[7] != 0.0) && (adjust_temp_voltage_mag[1] != 0.0))
+					{
+						//calculate new value
+						adjusted_constant_current[4] = ~(adjust_temp_nominal_voltage[1] * ~bus[indexer].extra_var[7] * adjust_temp_voltage_mag[1] / (voltageDel[1] * adjust_nominal_voltage_val));
+					}
+					else
+					{
+						adjusted_constant_current[4] = 0.0;
+					}
+
+					//Start adjustments - CA
+					if ((bus[indexer].extra_var[8] != 0.0) && (adjust_temp_voltage_mag[2] != 0.0))
+					{
+						//calculate new value
+						adjusted_constant_current[5] = ~(adjust_temp_nominal_voltage[2] * ~bus[indexer].extra_var[8] * adjust_temp_voltage_mag[2] / (voltageDel[2] * adjust_nominal_voltage_val));
+					}
+					else
+					{
+						adjusted_constant_current[5] = 0.0;
+					}
+				}
+				else	//Nope
+				{
+					//Set to zero, just cause
+					adjusted_constant_current[3] = 0.0;
+					adjusted_constant_current[4] = 0.0;
+					adjusted_constant_current[5] = 0.0;
+				}
+			}
+			else	//"Normal" modes -- handle traditionally
+			{
+				adjusted_constant_current[0] = bus[indexer].I[0];
+				adjusted_constant_current[1] = bus[indexer].I[1];
+				adjusted_constant_current[2] = bus[indexer].I[2];
+
+				//See if we have different children too
+				if ((bus[indexer].phases & 0x10) == 0x10)
+				{
+					//Store them too
+					adjusted_constant_current[3] = bus[indexer].extra_var[6];
+					adjusted_constant_current[4] = bus[indexer].extra_var[7];
+					adjusted_constant_current[5] = bus[indexer].extra_var[8];
+				}
+				else	//Nope, just zero this for now
+				{
+					adjusted_constant_current[3] = 0.0;
+					adjusted_constant_current[4] = 0.0;
+					adjusted_constant_current[5] = 0.0;
+				}
+			}//End adjustment code
+
+			//For Wye-connected, only compute and store phases that exist (make top heavy)
+			temp_index = -1;
+			temp_index_b = -1;
+			
+			if ((bus[indexer].phases & 0x10) == 0x10)	//"Different" child load - in this case it must be delta - also must be three phase (just because that's how I forced it to be implemented)
+			{											//Calculate all the deltas to wyes in advance (otherwise they'll get repeated)
+				//Make sure phase combinations exist
+				if ((bus[indexer].phases & 0x06) == 0x06)	//Has A-B
+				{
+				//Delta voltages
+				voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
+
+					//Power - put into a current value (iterates less this way)
+					delta_current[0] = (voltageDel[0] == 0) ? 0 : ~(bus[indexer].extra_var[0]/voltageDel[0]);
+
+					//Convert delta connected load to appropriate Wye 
+					delta_current[0] += voltageDel[0] * (bus[indexer].extra_var[3]);
+				}
+				else
+				{
+					//Zero it, for good measure
+					voltageDel[0] = 0.0;
+					delta_current[0] = 0.0;
+				}
+
+				//Check for BC
+				if ((bus[indexer].phases & 0x03) == 0x03)	//Has B-C
+				{
+					//Delta voltages
+					voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
+
+					//Power - put into a current value (iterates less this way)
+					delta_current[1] = (voltageDel[1] == 0) ? 0 : ~(bus[indexer].extra_var[1]/voltageDel[1]);
+
+					//Convert delta connected load to appropriate Wye 
+					delta_current[1] += voltageDel[1] * (bus[indexer].extra_var[4]);
+				}
+				else
+				{
+					//Zero it, for good measure
+					voltageDel[1] = 0.0;
+					delta_current[1] = 0.0;
+				}
+
+				//Check for CA
+				if ((bus[indexer].phases & 0x05) == 0x05)	//Has C-A
+				{
+					//Delta voltages
+					voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
+
+					//Power - put into a current value (iterates less this way)
+					delta_current[2] = (voltageDel[2] == 0) ? 0 : ~(bus[indexer].extra_var[2]/voltageDel[2]);
+
+					//Convert delta connected load to appropriate Wye 
+					delta_current[2] += voltageDel[2] * (bus[indexer].extra_var[5]);
+				}
+				else
+				{
+					//Zero it, for good measure
+					voltageDel[2] = 0.0;
+					delta_current[2] = 0.0;
+				}
+
+				//Convert delta-current into a phase current - reuse temp variable
+				undeltacurr[0]=(adjusted_constant_current[3]+delta_current[0])-(adjusted_constant_current[5]+delta_current[2]);
+				undeltacurr[1]=(adjusted_constant_current[4]+delta_current[1])-(adjusted_constant_current[3]+delta_current[0]);
+				undeltacurr[2]=(adjusted_constant_current[5]+delta_current[2])-(adjusted_constant_current[4]+delta_current[1]);
+			}
+			else	//zero the variable so we don't have excessive ifs
+			{
+				undeltacurr[0] = undeltacurr[1] = undeltacurr[2] = 0.0;	//Zero it
+			}
+
+			for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
+			{
+				switch(bus[indexer].phases & 0x07) {
 					case 0x01:	//C
 						{
-							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
-							{
-								temp_size = 1;		//Single size
-								temp_index = 0;		//No offset (only 1 big)
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-								/*  TROUBLESHOOT
-								One of the lines in the powerflow model has an invalid phase in
-								reference to its to and from ends.  This should have been caught
-								earlier, so submit your code and a bug report using the trac website.
-								*/
-							}
+							temp_index=0;
+							temp_index_b=2;
 							break;
-						}//end 0x01
+						}
 					case 0x02:	//B
 						{
-							if ((branch[jindexer].phases & 0x07) == 0x02)	//B
+							temp_index=0;
+							temp_index_b=1;
+							break;
+						}
+					case 0x03:	//BC
+						{
+							if (jindex==0)	//B
 							{
-								temp_size = 1;		//Single size
-								temp_index = 0;		//No offset (only 1 big)
+								temp_index=0;
+								temp_index_b=1;
 							}
-							else
+							else			//C
 							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
+								temp_index=1;
+								temp_index_b=2;
 							}
 							break;
-						}//end 0x02
-					case 0x03:	//BC
+						}
+					case 0x04:	//A
 						{
-							temp_size = 2;	//Size of this matrix's admittance
-							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
+							temp_index=0;
+							temp_index_b=0;
+							break;
+						}
+					case 0x05:	//AC
+						{
+							if (jindex==0)	//A
 							{
-								temp_index = 1;		//offset
+								temp_index=0;
+								temp_index_b=0;
 							}
-							else if ((branch[jindexer].phases & 0x07) == 0x02)	//B
+							else			//C
 							{
-								temp_index = 0;		//offset
+								temp_index=1;
+								temp_index_b=2;
 							}
-							else if ((branch[jindexer].phases & 0x07) == 0x03)	//BC
+							break;
+						}
+					case 0x06:	//AB
+					case 0x07:	//ABC
+						{
+							temp_index=jindex;
+							temp_index_b=jindex;
+							break;
+						}
+					default:
+						break;
+				}//end case
+
+				if ((temp_index==-1) || (temp_index_b==-1))
+				{
+					NR_RANGE_FAIL("NR: A Jacobian update element failed.");
+					/*  TROUBLESHOOT
+					While attempting to calculate the "dynamic" portions of the
+					Jacobian matrix that encompass attached loads, an update failed to process correctly.
+					Submit you code and a bug report using the trac website.
+					*/
+				}
+
+				if ((bus[indexer].V[temp_index_b]).Mag()!=0)
+				{
+					bus[indexer].Jacob_A[temp_index] = ((bus[indexer].S[temp_index_b]).Im() * (pow((bus[indexer].V[temp_index_b]).Re(),2) - pow((bus[indexer].V[temp_index_b]).Im(),2)) - 2*(bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(bus[indexer].S[temp_index_b]).Re())/pow((bus[indexer].V[temp_index_b]).Mag(),4);// first part of equation(37)
+					bus[indexer].Jacob_A[temp_index] += ((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(adjusted_constant_current[temp_index_b]).Re() + (adjusted_constant_current[temp_index_b]).Im() *pow((bus[indexer].V[temp_index_b]).Im(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3) + (bus[indexer].Y[temp_index_b]).Im();// second part of equation(37)
+					bus[indexer].Jacob_A[temp_index] += ((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Re() + (undeltacurr[temp_index_b]).Im() *pow((bus[indexer].V[temp_index_b]).Im(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3);// current part of equation (37) - Handles "different" children
+					
+					bus[indexer].Jacob_B[temp_index] = ((bus[indexer].S[temp_index_b]).Re() * (pow((bus[indexer].V[temp_index_b]).Re(),2) - pow((bus[indexer].V[temp_index_b]).Im(),2)) + 2*(bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(bus[indexer].S[temp_index_b]).Im())/pow((bus[indexer].V[temp_index_b]).Mag(),4);// first part of equation(38)
+					bus[indexer].Jacob_B[temp_index] += -((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(adjusted_constant_current[temp_index_b]).Im() + (adjusted_constant_current[temp_index_b]).Re() *pow((bus[indexer].V[temp_index_b]).Re(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3) - (bus[indexer].Y[temp_index_b]).Re();// second part of equation(38)
+					bus[indexer].Jacob_B[temp_index] += -((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Im() + (undeltacurr[temp_index_b]).Re() *pow((bus[indexer].V[temp_index_b]).Re(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3);// current part of equation(38) - Handles "different" children
+					
+					bus[indexer].Jacob_C[temp_index] = ((bus[indexer].S[temp_index_b]).Re() * (pow((bus[indexer].V[temp_index_b]).Im(),2) - pow((bus[indexer].V[temp_index_b]).Re(),2)) - 2*(bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(bus[indexer].S[temp_index_b]).Im())/pow((bus[indexer].V[temp_index_b]).Mag(),4);// first part of equation(39)
+					bus[indexer].Jacob_C[temp_index] +=((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(adjusted_constant_current[temp_index_b]).Im() - (adjusted_constant_current[temp_index_b]).Re() *pow((bus[indexer].V[temp_index_b]).Im(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3) - (bus[indexer].Y[temp_index_b]).Re();// second part of equation(39)
+					bus[indexer].Jacob_C[temp_index] +=((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Im() - (undeltacurr[temp_index_b]).Re() *pow((bus[indexer].V[temp_index_b]).Im(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3);// Current part of equation(39) - Handles "different" children
+					
+					bus[indexer].Jacob_D[temp_index] = ((bus[indexer].S[temp_index_b]).Im() * (pow((bus[indexer].V[temp_index_b]).Re(),2) - pow((bus[indexer].V[temp_index_b]).Im(),2)) - 2*(bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(bus[indexer].S[temp_index_b]).Re())/pow((bus[indexer].V[temp_index_b]).Mag(),4);// first part of equation(40)
+					bus[indexer].Jacob_D[temp_index] += ((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(adjusted_constant_current[temp_index_b]).Re() - (adjusted_constant_current[temp_index_b]).Im() *pow((bus[indexer].V[temp_index_b]).Re(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3) - (bus[indexer].Y[temp_index_b]).Im();// second part of equation(40)
+					bus[indexer].Jacob_D[temp_index] += ((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Re() - (undeltacurr[temp_index_b]).Im() *pow((bus[indexer].V[temp_index_b]).Re(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3);// Current part of equation(40) - Handles "different" children
+				
+				}
+				else
+				{
+					bus[indexer].Jacob_A[temp_index]= (bus[indexer].Y[temp_index_b]).Im() - 1e-4;	//Small offset to avoid singularity issues
+					bus[indexer].Jacob_B[temp_index]= -(bus[indexer].Y[temp_index_b]).Re() - 1e-4;
+					bus[indexer].Jacob_C[temp_index]= -(bus[indexer].Y[temp_index_b]).Re() - 1e-4;
+					bus[indexer].Jacob_D[temp_index]= -(bus[indexer].Y[temp_index_b]).Im() - 1e-4;
+				}
+			}//End phase traversion - Wye
+		}//End wye-connected load
+
+		//Perform delta/wye explicit load updates -- no triplex
+		if ((bus[indexer].phases & 0x80) != 0x80)	//Not triplex
+		{
+			//Delta components - populate according to what is there
+			if ((bus[indexer].phases & 0x06) == 0x06)	//Check for AB
+			{
+				//Voltage calculations
+				voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
+
+				//Power - convert to a current (uses less iterations this way)
+				delta_current[0] = (voltageDel[0] == 0) ? 0 : ~(bus[indexer].S_dy[0]/voltageDel[0]);
+
+				//Convert delta connected load to appropriate Wye
+				delta_current[0] += voltageDel[0] * (bus[indexer].Y_dy[0]);
+
+			}
+			else
+			{
+				//Zero values - they shouldn't be used anyhow
+				voltageDel[0] = 0.0;
+				delta_current[0] = 0.0;
+			}
+
+			if ((bus[indexer].phases & 0x03) == 0x03)	//Check for BC
+			{
+				//Voltage calculations
+				voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
+
+				//Power - convert to a current (uses less iterations this way)
+				delta_current[1] = (voltageDel[1] == 0) ? 0 : ~(bus[indexer].S_dy[1]/voltageDel[1]);
+
+				//Convert delta connected load to appropriate Wye
+				delta_current[1] += voltageDel[1] * (bus[indexer].Y_dy[1]);
+
+			}
+			else
+			{
+				//Zero unused
+				voltageDel[1] = 0.0;
+				delta_current[1] = 0.0;
+			}
+
+			if ((bus[indexer].phases & 0x05) == 0x05)	//Check for CA
+			{
+				//Voltage calculations
+				voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
+
+				//Power - convert to a current (uses less iterations this way)
+				delta_current[2] = (voltageDel[2] == 0) ? 0 : ~(bus[indexer].S_dy[2]/voltageDel[2]);
+
+				//Convert delta connected load to appropriate Wye
+				delta_current[2] += voltageDel[2] * (bus[indexer].Y_dy[2]);
+
+			}
+			else
+			{
+				//Zero unused
+				voltageDel[2] = 0.0;
+				delta_current[2] = 0.0;
+			}
+
+			//Populate the values for constant current -- deltamode different right now (all same in future?)
+			if (*bus[indexer].dynamics_enabled == true)
+			{
+				//Create line-line nominal magnitude
+				adjust_nominal_voltage_val = bus[indexer].volt_base;
+				adjust_nominal_voltaged_val = bus[indexer].volt_base * sqrt(3.0);
+
+				//Create the nominal voltage vectors
+				adjust_temp_nominal_voltage[0].SetPolar(adjust_nominal_voltaged_val,PI/6.0);
+				adjust_temp_nominal_voltage[1].SetPolar(adjust_nominal_voltaged_val,-1.0*PI/2.0);
+				adjust_temp_nominal_voltage[2].SetPolar(adjust_nominal_voltaged_val,5.0*PI/6.0);
+				adjust_temp_nominal_voltage[3].SetPolar(adjust_nominal_voltage_val,0.0);
+				adjust_temp_nominal_voltage[4].SetPolar(adjust_nominal_voltage_val,-2.0*PI/3.0);
+				adjust_temp_nominal_voltage[5].SetPolar(adjust_nominal_voltage_val,2.0*PI/3.0);
+
+				//Compute delta voltages
+				voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
+				voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
+				voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
+
+				//Get magnitudes of all
+				adjust_temp_voltage_mag[0] = voltageDel[0].Mag();
+				adjust_temp_voltage_mag[1] = voltageDel[1].Mag();
+				adjust_temp_voltage_mag[2] = voltageDel[2].Mag();
+				adjust_temp_voltage_mag[3] = bus[indexer].V[0].Mag();
+				adjust_temp_voltage_mag[4] = bus[indexer].V[1].Mag();
+				adjust_temp_voltage_mag[5] = bus[indexer].V[2].Mag();
+
+				//Start adjustments - A
+				if ((bus[indexer].I_dy[3] != 0.0) && (adjust_temp_voltage_mag[3] != 0.0))
+				{
+					//calculate new value
+					adjusted_constant_current[3] = ~(adjust_temp_nominal_voltage[3] * ~bus[indexer].I_dy[3] * adjust_temp_voltage_mag[3] / (bus[indexer].V[0] * adjust_nominal_voltage_val));
+				}
+				else
+				{
+					adjusted_constant_current[3] = 0.0;
+				}
+
+				//Start adjustments - B
+				if ((bus[indexer].I_dy[4] != 0.0) && (adjust_temp_voltage_mag[4] != 0.0))
+				{
+					//calculate new value
+					adjusted_constant_current[4] = ~(adjust_temp_nominal_voltage[4] * ~bus[indexer].I_dy[4] * adjust_temp_voltage_mag[4] / (bus[indexer].V[1] * adjust_nominal_voltage_val));
+				}
+				else
+				{
+					adjusted_constant_current[4] = 0.0;
+				}
+
+				//Start adjustments - C
+				if ((bus[indexer].I_dy[5] != 0.0) && (adjust_temp_voltage_mag[5] != 0.0))
+				{
+					//calculate new value
+					adjusted_constant_current[5] = ~(adjust_temp_nominal_voltage[5] * ~bus[indexer].I_dy[5] * adjust_temp_voltage_mag[5] / (bus[indexer].V[2] * adjust_nominal_voltage_val));
+				}
+				else
+				{
+					adjusted_constant_current[5] = 0.0;
+				}
+
+				//Start adjustments - AB
+				if ((bus[indexer].I_dy[0] != 0.0) && (adjust_temp_voltage_mag[0] != 0.0))
+				{
+					//calculate new value
+					adjusted_constant_current[0] = ~(adjust_temp_nominal_voltage[0] * ~bus[indexer].I_dy[0] * adjust_temp_voltage_mag[0] / (voltageDel[0] * adjust_nominal_voltaged_val));
+				}
+				else
+				{
+					adjusted_constant_current[0] = 0.0;
+				}
+
+				//Start adjustments - BC
+				if ((bus[indexer].I_dy[1] != 0.0) && (adjust_temp_voltage_mag[1] != 0.0))
+				{
+					//calculate new value
+					adjusted_constant_current[1] = ~(adjust_temp_nominal_voltage[1] * ~bus[indexer].I_dy[1] * adjust_temp_voltage_mag[1] / (voltageDel[1] * adjust_nominal_voltaged_val));
+				}
+				else
+				{
+					adjusted_constant_current[1] = 0.0;
+				}
+
+				//Start adjustments - CA
+				if ((bus[indexer].I_dy[2] != 0.0) && (adjust_temp_voltage_mag[2] != 0.0))
+				{
+					//calculate new value
+					adjusted_constant_current[2] = ~(adjust_temp_nominal_voltage[2] * ~bus[indexer].I_dy[2] * adjust_temp_voltage_mag[2] / (voltageDel[2] * adjust_nominal_voltaged_val));
+				}
+				else
+				{
+					adjusted_constant_current[2] = 0.0;
+				}
+			}//End deltamode adjustment
+			else	//Normal mode
+			{
+				//Just copy the values in
+				adjusted_constant_current[0] = bus[indexer].I_dy[0];
+				adjusted_constant_current[1] = bus[indexer].I_dy[1];
+				adjusted_constant_current[2] = bus[indexer].I_dy[2];
+				adjusted_constant_current[3] = bus[indexer].I_dy[3];
+				adjusted_constant_current[4] = bus[indexer].I_dy[4];
+				adjusted_constant_current[5] = bus[indexer].I_dy[5];
+			}
+
+			//Convert delta-current into a phase current, where appropriate - reuse temp variable
+			//Everything will be accumulated into the "current" field for ease (including differents)
+			if ((bus[indexer].phases & 0x04) == 0x04)	//Has a phase A
+			{
+				undeltacurr[0]=(adjusted_constant_current[0]+delta_current[0])-(adjusted_constant_current[2]+delta_current[2]);
+
+				//Apply wye-connected loads
+
+				//Power values
+				undeltacurr[0] += (bus[indexer].V[0] == 0) ? 0 : ~(bus[indexer].S_dy[3]/bus[indexer].V[0]);
+
+				//Shunt values
+				undeltacurr[0] += bus[indexer].Y_dy[3]*bus[indexer].V[0];
+
+				//Current values
+				undeltacurr[0] += adjusted_constant_current[3];
+			}
+			else
+			{
+				//Zero it, just in case
+				undeltacurr[0] = 0.0;
+			}
+
+			if ((bus[indexer].phases & 0x02) == 0x02)	//Has a phase B
+			{
+				undeltacurr[1]=(adjusted_constant_current[1]+delta_current[1])-(adjusted_constant_current[0]+delta_current[0]);
+
+				//Apply wye-connected loads
+
+				//Power values
+				undeltacurr[1] += (bus[indexer].V[1] == 0) ? 0 : ~(bus[indexer].S_dy[4]/bus[indexer].V[1]);
+
+				//Shunt values
+				undeltacurr[1] += bus[indexer].Y_dy[4]*bus[indexer].V[1];
+
+				//Current values
+				undeltacurr[1] += adjusted_constant_current[4];
+			}
+			else
+			{
+				//Zero it, just in case
+				undeltacurr[1] = 0.0;
+			}
+
+			if ((bus[indexer].phases & 0x01) == 0x01)	//Has a phase C
+			{
+				undeltacurr[2]=(adjusted_constant_current[2]+delta_current[2])-(adjusted_constant_current[1]+delta_current[1]);
+
+				//Apply wye-connected loads
+
+				//Power values
+				undeltacurr[2] += (bus[indexer].V[2] == 0) ? 0 : ~(bus[indexer].S_dy[5]/bus[indexer].V[2]);
+
+				//Shunt values
+				undeltacurr[2] += bus[indexer].Y_dy[5]*bus[indexer].V[2];
+
+				//Current values
+				undeltacurr[2] += adjusted_constant_current[5];
+			}
+			else
+			{
+				//Zero it, just in case
+				undeltacurr[2] = 0.0;
+			}
+
+			//Provide updates to relevant phases
+			//only compute and store phases that exist (make top heavy)
+			temp_index = -1;
+			temp_index_b = -1;
+			
+			for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
+			{
+				switch(bus[indexer].phases & 0x07) {
+					case 0x01:	//C
+						{
+							temp_index=0;
+							temp_index_b=2;
+							break;
+						}
+					case 0x02:	//B
+						{
+							temp_index=0;
+							temp_index_b=1;
+							break;
+						}
+					case 0x03:	//BC
+						{
+							if (jindex==0)	//B
 							{
-								temp_index = 0;
+								temp_index=0;
+								temp_index_b=1;
 							}
-							else
+							else			//C
 							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
+								temp_index=1;
+								temp_index_b=2;
 							}
 							break;
-						}//end 0x03
+						}
 					case 0x04:	//A
 						{
-							if ((branch[jindexer].phases & 0x07) == 0x04)	//A
-							{
-								temp_size = 1;		//Single size
-								temp_index = 0;		//No offset (only 1 big)
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-							}
+							temp_index=0;
+							temp_index_b=0;
 							break;
-						}//end 0x04
+						}
 					case 0x05:	//AC
 						{
-							temp_size = 2;	//Size of this matrix's admittance
-							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
-							{
-								temp_index = 1;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
-							{
-								temp_index = 0;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x05)	//AC
+							if (jindex==0)	//A
 							{
-								temp_index = 0;
+								temp_index=0;
+								temp_index_b=0;
 							}
-							else
+							else			//C
 							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
+								temp_index=1;
+								temp_index_b=2;
 							}
 							break;
-						}//end 0x05
+						}
 					case 0x06:	//AB
+					case 0x07:	//ABC
 						{
-							temp_size = 2;	//Size of this matrix's admittance
-							if ((branch[jindexer].phases & 0x07) == 0x02)	//B
+							temp_index=jindex;
+							temp_index_b=jindex;
+							break;
+						}
+					default:
+						break;
+				}//end case
+
+				if ((temp_index==-1) || (temp_index_b==-1))
+				{
+					NR_RANGE_FAIL("NR: A Jacobian update element failed.");
+					//Defined below
+				}
+
+				if ((bus[indexer].V[temp_index_b]).Mag()!=0)
+				{
+					//Apply as an accumulation, in case any "normal" connections are present too
+					bus[indexer].Jacob_A[temp_index] += ((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Re() + (undeltacurr[temp_index_b]).Im() *pow((bus[indexer].V[temp_index_b]).Im(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3); // + (undeltaimped[temp_index_b]).Im();// second part of equation(37) - no power term needed
+					bus[indexer].Jacob_B[temp_index] += -((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Im() + (undeltacurr[temp_index_b]).Re() *pow((bus[indexer].V[temp_index_b]).Re(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3); // - (undeltaimped[temp_index_b]).Re();// second part of equation(38) - no power term needed
+					bus[indexer].Jacob_C[temp_index] +=((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Im() - (undeltacurr[temp_index_b]).Re() *pow((bus[indexer].V[temp_index_b]).Im(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3); // - (undeltaimped[temp_index_b]).Re();// second part of equation(39) - no power term needed
+					bus[indexer].Jacob_D[temp_index] += ((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Re() - (undeltacurr[temp_index_b]).Im() *pow((bus[indexer].V[temp_index_b]).Re(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3); // - (undeltaimped[temp_index_b]).Im();// second part of equation(40) - no power term needed
+				}
+				else	//Zero voltage = only impedance is valid (others get divided by VMag, so are IND) - not entirely sure how this gets in here anyhow
+				{
+					bus[indexer].Jacob_A[temp_index] += -1e-4; //(undeltaimped[temp_index_b]).Im() - 1e-4;	//Small offset to avoid singularities (if impedance is zero too)
+					bus[indexer].Jacob_B[temp_index] += -1e-4; //-(undeltaimped[temp_index_b]).Re() - 1e-4;
+					bus[indexer].Jacob_C[temp_index] += -1e-4; //-(undeltaimped[temp_index_b]).Re() - 1e-4;
+					bus[indexer].Jacob_D[temp_index] += -1e-4; //-(undeltaimped[temp_index_b]).Im() - 1e-4;
+				}
+
+			}//End phase traversion
+		}//End delta/wye explicit loads
+
+		//Delta load components  get added to the Jacobian values too -- mostly because this is the most convenient place to do it
+		//See if we're even needed first
+		if (bus[indexer].full_Y_load != NULL)
+		{
+			//Provide updates to relevant phases
+			//only compute and store phases that exist (make top heavy)
+			temp_index = -1;
+			temp_index_b = -1;
+			
+			for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
+			{
+				switch(bus[indexer].phases & 0x07) {
+					case 0x01:	//C
+						{
+							temp_index=0;
+							temp_index_b=2;
+							break;
+						}
+					case 0x02:	//B
+						{
+							temp_index=0;
+							temp_index_b=1;
+							break;
+						}
+					case 0x03:	//BC
+						{
+							if (jindex==0)	//B
 							{
-								temp_index = 1;		//offset
+								temp_index=0;
+								temp_index_b=1;
 							}
-							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
+							else			//C
 							{
-								temp_index = 0;		//offset
+								temp_index=1;
+								temp_index_b=2;
 							}
-							else if ((branch[jindexer].phases & 0x07) == 0x06)	//AB
+							break;
+						}
+					case 0x04:	//A
+						{
+							temp_index=0;
+							temp_index_b=0;
+							break;
+						}
+					case 0x05:	//AC
+						{
+							if (jindex==0)	//A
 							{
-								temp_index = 0;
+								temp_index=0;
+								temp_index_b=0;
 							}
-							else
+							else			//C
 							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
+								temp_index=1;
+								temp_index_b=2;
 							}
 							break;
-						}//end 0x06
+						}
+					case 0x06:	//AB
 					case 0x07:	//ABC
 						{
-							temp_size = 3;	//Size of this matrix's admittance
-							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
+							temp_index=jindex;
+							temp_index_b=jindex;
+							break;
+						}
+					default:
+						break;
+				}//end case
+
+				if ((temp_index==-1) || (temp_index_b==-1))
+				{
+					NR_RANGE_FAIL("NR: A Jacobian update element failed.");
+					//Defined below
+				}
+
+				//Accumulate the values
+				bus[indexer].Jacob_A[temp_index] += bus[indexer].full_Y_load[temp_index_b].Im();
+				bus[indexer].Jacob_B[temp_index] += bus[indexer].full_Y_load[temp_index_b].Re();
+				bus[indexer].Jacob_C[temp_index] += bus[indexer].full_Y_load[temp_index_b].Re();
+				bus[indexer].Jacob_D[temp_index] -= bus[indexer].full_Y_load[temp_index_b].Im();
+			}//End phase traversion
+		}//End deltamode-enabled in-rush loads updates
+	}//end bus traversion for a,b,c, d value computation
+}
+
+/** Voltage update of each bus in the range; Maxmismatch and newiter hold the range's convergence test **/
+static void NR_range_update(NR_RANGE *range)
+{
+	BUSDATA *bus = range->bus;
+	NR_SOLVER_STRUCT *powerflow_values = range->powerflow_values;
+	double *sol_LU = range->sol_LU;
+	unsigned int indexer;
+	char jindex, temp_index = -1, temp_index_b = -1;
+	complex DVConvCheck[3];
+	double CurrConvVal, Maxmismatch = 0.0;
+	bool newiter = false;
+
+	for (indexer=range->first; indexer<range->last; indexer++)
+	{
+		//Avoid swing bus updates on normal runs
+		if ((bus[indexer].type == 0) || ((bus[indexer].type > 1) && (bus[indexer].swing_functions_enabled == false)))
+		{
+			//Figure out the offset we need to be for each phase
+			if ((bus[indexer].phases & 0x80) == 0x80)	//Split phase
+			{
+				//Pull the two updates (assume split-phase is always 2)
+				DVConvCheck[0]=complex(sol_LU[2*bus[indexer].Matrix_Loc],sol_LU[(2*bus[indexer].Matrix_Loc+2)]);
+				DVConvCheck[1]=complex(sol_LU[(2*bus[indexer].Matrix_Loc+1)],sol_LU[(2*bus[indexer].Matrix_Loc+3)]);
+				bus[indexer].V[0] += DVConvCheck[0];
+				bus[indexer].V[1] += DVConvCheck[1];	//Negative due to convention
+				
+				//Pull off the magnitude (no sense calculating it twice)
+				CurrConvVal=DVConvCheck[0].Mag();
+				if (CurrConvVal > Maxmismatch)	//Update our convergence check if it is bigger
+					Maxmismatch=CurrConvVal;
+
+				if (CurrConvVal > bus[indexer].max_volt_error)	//Check for convergence
+					newiter=true;								//Flag that a new iteration must occur
+
+				CurrConvVal=DVConvCheck[1].Mag();
+				if (CurrConvVal > Maxmismatch)	//Update our convergence check if it is bigger
+					Maxmismatch=CurrConvVal;
+
+				if (CurrConvVal > bus[indexer].max_volt_error)	//Check for convergence
+					newiter=true;								//Flag that a new iteration must occur
+			}//end split phase update
+			else										//Not split phase
+			{
+				for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)	//parse through the phases
+				{
+					switch(bus[indexer].phases & 0x07) {
+						case 0x01:	//C
 							{
-								temp_index = 2;		//offset
+								temp_index=0;
+								temp_index_b=2;
+								break;
 							}
-							else if ((branch[jindexer].phases & 0x07) == 0x02)	//B
+						case 0x02:	//B
 							{
-								temp_index = 1;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x03)	//BC
-							{
-								temp_index = 1;
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
-							{
-								temp_index = 0;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x05)	//AC
-							{
-								temp_index = 0;
-								Full_Mat_A = true;		//Flag so we know C needs to be gapped
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x06)	//AB
-							{
-								temp_index = 0;
+								temp_index=0;
+								temp_index_b=1;
+								break;
 							}
-							else
+						case 0x03:	//BC
 							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-							}
-							break;
-						}//end 0x07
-					default:
-						{
-							break;
-						}
-				}//End switch/case for from
+								if (jindex==0)	//B
+								{
+									temp_index=0;
+									temp_index_b=1;
+								}
+								else			//C
+								{
+									temp_index=1;
+									temp_index_b=2;
+								}
 
-				//Check the to side and get all appropriate offsets
-				switch(bus[tempb].phases & 0x07) {
-					case 0x01:	//C
-						{
-							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
-							{
-								temp_size_b = 1;		//Single size
-								temp_index_b = 0;		//No offset (only 1 big)
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-								/*  TROUBLESHOOT
-								One of the lines in the powerflow model has an invalid phase in
-								reference to its to and from ends.  This should have been caught
-								earlier, so submit your code and a bug report using the trac website.
-								*/
-							}
-							break;
-						}//end 0x01
-					case 0x02:	//B
-						{
-							if ((branch[jindexer].phases & 0x07) == 0x02)	//B
-							{
-								temp_size_b = 1;		//Single size
-								temp_index_b = 0;		//No offset (only 1 big)
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-							}
-							break;
-						}//end 0x02
-					case 0x03:	//BC
-						{
-							temp_size_b = 2;	//Size of this matrix's admittance
-							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
-							{
-								temp_index_b = 1;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x02)	//B
-							{
-								temp_index_b = 0;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x03)	//BC
-							{
-								temp_index_b = 0;
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-							}
-							break;
-						}//end 0x03
-					case 0x04:	//A
-						{
-							if ((branch[jindexer].phases & 0x07) == 0x04)	//A
-							{
-								temp_size_b = 1;		//Single size
-								temp_index_b = 0;		//No offset (only 1 big)
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-							}
-							break;
-						}//end 0x04
-					case 0x05:	//AC
-						{
-							temp_size_b = 2;	//Size of this matrix's admittance
-							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
-							{
-								temp_index_b = 1;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
-							{
-								temp_index_b = 0;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x05)	//AC
-							{
-								temp_index_b = 0;
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-							}
-							break;
-						}//end 0x05
-					case 0x06:	//AB
-						{
-							temp_size_b = 2;	//Size of this matrix's admittance
-							if ((branch[jindexer].phases & 0x07) == 0x02)	//B
-							{
-								temp_index_b = 1;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
-							{
-								temp_index_b = 0;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x06)	//AB
-							{
-								temp_index_b = 0;
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-							}
-							break;
-						}//end 0x06
-					case 0x07:	//ABC
-						{
-							temp_size_b = 3;	//Size of this matrix's admittance
-							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
-							{
-								temp_index_b = 2;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x02)	//B
-							{
-								temp_index_b = 1;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x03)	//BC
-							{
-								temp_index_b = 1;
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
-							{
-								temp_index_b = 0;		//offset
+								break;
 							}
-							else if ((branch[jindexer].phases & 0x07) == 0x05)	//AC
+						case 0x04:	//A
 							{
-								temp_index_b = 0;
-								Full_Mat_B = true;		//Flag so we know C needs to be gapped
+								temp_index=0;
+								temp_index_b=0;
+								break;
 							}
-							else if ((branch[jindexer].phases & 0x07) == 0x06)	//AB
+						case 0x05:	//AC
 							{
-								temp_index_b = 0;
+								if (jindex==0)	//A
+								{
+									temp_index=0;
+									temp_index_b=0;
+								}
+								else			//C
+								{
+									temp_index=1;
+									temp_index_b=2;
+								}
+								break;
 							}
-							else
+						case 0x06:	//AB
+						case 0x07:	//ABC
 							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
+								temp_index = jindex;
+								temp_index_b = jindex;
+								break;
 							}
-							break;
-						}//end 0x07
-					default:
-						{
-							break;
-						}
-				}//End switch/case for to
-
-				//Make sure everything was set before proceeding
-				if ((temp_index==-1) || (temp_index_b==-1) || (temp_size==-1) || (temp_size_b==-1) || (temp_size_c==-1))
-				{
-					GL_THROW("NR: Failure to construct single/double phase line indices");
-					/*  TROUBLESHOOT
-					A single or double phase line (e.g., just A or AB) has failed to properly initialize all of the indices
-					necessary to form the admittance matrix.  Please submit a bug report, with your code, to the trac site.
-					*/
-				}
+					}//end phase switch/case
 
-				if (Full_Mat_A)	//From side is a full ABC and we have AC
-				{
-					for (jindex=0; jindex<temp_size_c; jindex++)		//Loop through rows of admittance matrices				
+					if ((temp_index==-1) || (temp_index_b==-1))
 					{
-						for (kindex=0; kindex<temp_size_c; kindex++)	//Loop through columns of admittance matrices
-						{
-							//Indices counted out from Self admittance above.  needs doubling due to complex separation
-							if ((Temp_Ad_A[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
-							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Im());
-								indexer += 1;
-								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2 + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = (Temp_Ad_A[jindex][kindex].Im());
-								indexer += 1;
-							}
+						NR_RANGE_FAIL("NR: An error occurred indexing voltage updates");
+						/*  TROUBLESHOOT
+						While attempting to create the voltage update indices for the
+						Newton-Raphson solver, an error was encountered.  Please submit
+						your code and a bug report using the trac website.
+						*/
+					}
 
-							if ((Temp_Ad_B[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
-							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Im());
-								indexer += 1;
-								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2 + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = Temp_Ad_B[jindex][kindex].Im();
-								indexer += 1;
-							}
+					DVConvCheck[jindex]=complex(sol_LU[(2*bus[indexer].Matrix_Loc+temp_index)],sol_LU[(2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size+temp_index)]);
+					bus[indexer].V[temp_index_b] += DVConvCheck[jindex];
+					
+					//Pull off the magnitude (no sense calculating it twice)
+					CurrConvVal=DVConvCheck[jindex].Mag();
+					if (CurrConvVal > bus[indexer].max_volt_error)	//Check for convergence
+						newiter=true;								//Flag that a new iteration must occur
 
-							if ((Temp_Ad_A[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
-							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2 + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
-								indexer += 1;
-								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
-								indexer += 1;	
-							}
+					if (CurrConvVal > Maxmismatch)	//See if the current differential is the largest found so far or not
+						Maxmismatch = CurrConvVal;	//It is, store it
 
-							if ((Temp_Ad_B[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
-							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
-								indexer += 1;
-								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2 + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
-								indexer += 1;	
-							}
-						}//column end
-					}//row end
-				}//end full ABC for from AC
+				}//End For loop for phase traversion
+			}//End not split phase update
+		}//end if not swing
+		else	//So this must be the swing and in a valid interval
+		{
+			temp_index +=2*powerflow_values->BA_diag[indexer].size;	//Increment us for what this bus would have been had it not been a swing
+		}
+	}//End bus traversion
 
-				if (Full_Mat_B)	//To side is a full ABC and we have AC
-				{
-					for (jindex=0; jindex<temp_size_c; jindex++)		//Loop through rows of admittance matrices				
-					{
-						for (kindex=0; kindex<temp_size_c; kindex++)	//Loop through columns of admittance matrices
-						{
-							//Indices counted out from Self admittance above.  needs doubling due to complex separation
-							if ((Temp_Ad_A[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
-							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Im());
-								indexer += 1;
-								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2 + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = (Temp_Ad_A[jindex][kindex].Im());
-								indexer += 1;
-							}
+	range->Maxmismatch = Maxmismatch;
+	range->newiter = newiter;
+}
 
-							if ((Temp_Ad_B[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
-							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Im());
-								indexer += 1;
-								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2 + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = Temp_Ad_B[jindex][kindex].Im();
-								indexer += 1;
-							}
+//Runs the ranges [first,last) of a bus pass on a pool thread
+static TIMESTAMP NR_range_task(TPTASK *task, unsigned int first, unsigned int last, unsigned int thread)
+{
+	NR_RANGE *range = (NR_RANGE *)task->data;
+	unsigned int index;
 
-							if ((Temp_Ad_A[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
-							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
-								indexer += 1;
-								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2 + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
-								indexer += 1;	
-							}
+	for (index=first; index<last; index++)
+		(*range[index].kernel)(range+index);
+	return TS_NEVER;
+}
 
-							if ((Temp_Ad_B[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
-							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2 + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
-								indexer += 1;
-								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
-								indexer += 1;	
-							}
-						}//column end
-					}//row end
-				}//end full ABC for to AC
+/** Runs a per-bus pass over all the buses.  Large systems are split into contiguous
+	ranges that run on the core pool threads; every bus only writes its own entries (including
+	its Matrix_Loc rows of deltaI_NR), so the ranges never overlap.  The convergence
+	results and failures are combined in range order, so the outcome does not depend on
+	the number of threads.
+ **/
+static void NR_run_ranges(void (*kernel)(NR_RANGE *), NR_RANGE *pass, unsigned int bus_count, unsigned int n_threads)
+{
+	NR_RANGE range[NR_MAXRANGES];
+	TPTASK pass_task, *run = &pass_task;
+	unsigned int n_ranges, i;
+
+	n_ranges = bus_count/NR_MINBUSES;
+	if (n_ranges > n_threads)
+		n_ranges = n_threads;
+	if (n_ranges > NR_MAXRANGES)
+		n_ranges = NR_MAXRANGES;
+	if (n_ranges < 1)
+		n_ranges = 1;
+
+	for (i=0; i<n_ranges; i++)
+	{
+		range[i] = *pass;
+		range[i].kernel = kernel;
+		range[i].first = (unsigned int)((double)bus_count*i/n_ranges);
+		range[i].last = (i == n_ranges-1) ? bus_count : (unsigned int)((double)bus_count*(i+1)/n_ranges);
+		range[i].swing_converged = true;
+		range[i].newiter = false;
+		range[i].Maxmismatch = 0.0;
+		range[i].fault = NULL;
+	}
 
-				if ((!Full_Mat_A) && (!Full_Mat_B))	//Neither is a full ABC, or we aren't doing AC, so we don't care
-				{
-					for (jindex=0; jindex<temp_size_c; jindex++)		//Loop through rows of admittance matrices				
-					{
-						for (kindex=0; kindex<temp_size_c; kindex++)	//Loop through columns of admittance matrices
-						{
-							//Indices counted out from Self admittance above.  needs doubling due to complex separation
-							if ((Temp_Ad_A[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
-							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Im());
-								indexer += 1;
-								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = (Temp_Ad_A[jindex][kindex].Im());
-								indexer += 1;
-							}
+	if (n_ranges > 1)
+	{
+		memset(&pass_task,0,sizeof(pass_task));
+		pass_task.name = "NR bus pass";
+		pass_task.call = NR_range_task;
+		pass_task.data = (void *)range;
+		pass_task.n_items = n_ranges;
+		pass_task.grain = 1;
+		gl_pool_run(&run,1);
+	}
+	else
+		(*kernel)(range);
 
-							if ((Temp_Ad_B[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
-							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Im());
-								indexer += 1;
-								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = Temp_Ad_B[jindex][kindex].Im();
-								indexer += 1;
-							}
+	for (i=0; i<n_ranges; i++)
+	{
+		if (range[i].fault != NULL)
+			GL_THROW((char *)range[i].fault,pass->bus[range[i].fault_bus].name);
+		if (range[i].swing_converged == false)
+			pass->swing_converged = false;
+		if (range[i].newiter == true)
+			pass->newiter = true;
+		if (range[i].Maxmismatch > pass->Maxmismatch)
+			pass->Maxmismatch = range[i].Maxmismatch;
+	}
+}
 
-							if ((Temp_Ad_A[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
-							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
-								indexer += 1;
-								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
-								indexer += 1;	
-							}
 
-							if ((Temp_Ad_B[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
-							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
-								indexer += 1;
-								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
-								indexer += 1;	
-							}
-						}//column end
-					}//row end
-				}//end not full ABC with AC on either side case
-			}//end all others else
-		}//end branch for
+/** Electrically independent part of the NR system, solved as a system of its own.  The bus and
+	branch entries are copies of NR_busdata/NR_branchdata (their pointers still reach the objects),
+	renumbered so from/to and the link tables index the island's own arrays.
+ **/
+typedef struct s_nr_island {
+	unsigned int bus_count, branch_count;
+	unsigned int *bus_index;			/**< NR_busdata entry of each island bus */
+	unsigned int *branch_index;			/**< NR_branchdata entry of each island branch */
+	unsigned int *matrix_loc;			/**< Matrix_Loc of each island bus in the island's own matrices */
+	int *link_table;					/**< island link tables of all the buses, back to back */
+	BUSDATA *bus;
+	BRANCHDATA *branch;
+	NR_SOLVER_STRUCT powerflow_values;	/**< island working matrices - kept between solves */
+	NRSOLVERMODE powerflow_type;
+	int64 result;						/**< solver_nr result of the last solve */
+	bool bad_computations;
+	char fault[1024];					/**< message the last solve threw, empty if it did not throw */
+} NR_ISLAND;
+
+static NR_ISLAND *NR_islands = NULL;	//Islands of the last partition
+static unsigned int NR_island_count = 0;
+static bool NR_islands_valid = false;	//Partition matches the current topology
+
+//Free the working matrices of a system
+static void NR_free_solver(NR_SOLVER_STRUCT *powerflow_values)
+{
+	gl_free(powerflow_values->deltaI_NR);
+	gl_free(powerflow_values->BA_diag);
+	gl_free(powerflow_values->Y_offdiag_PQ);
+	gl_free(powerflow_values->Y_diag_fixed);
+	gl_free(powerflow_values->Y_diag_update);
+	if (powerflow_values->Y_Amatrix != NULL)
+	{
+		sparse_clear(powerflow_values->Y_Amatrix);
+		gl_free(powerflow_values->Y_Amatrix);
+	}
+	if (powerflow_values->LU != NULL)
+	{
+		gl_free(powerflow_values->LU->matrices_LU.a_LU);
+		gl_free(powerflow_values->LU->matrices_LU.rows_LU);
+		gl_free(powerflow_values->LU->matrices_LU.cols_LU);
+		gl_free(powerflow_values->LU->matrices_LU.rhs_LU);
+		gl_free(powerflow_values->LU->perm_c);
+		gl_free(powerflow_values->LU->perm_r);
+		gl_free(powerflow_values->LU->A_LU.Store);
+		gl_free(powerflow_values->LU->B_LU.Store);
+		gl_free(powerflow_values->LU);
+	}
+	memset(powerflow_values,0,sizeof(NR_SOLVER_STRUCT));
+}
 
-		//Build the fixed part of the diagonal PQ bus elements of 6n*6n Y_NR matrix. This part will not be updated at each iteration. 
-		powerflow_values->size_diag_fixed = 0;
-		for (jindexer=0; jindexer<bus_count;jindexer++) 
+static void NR_free_islands(void)
+{
+	unsigned int index;
+
+	for (index=0; index<NR_island_count; index++)
+	{
+		gl_free(NR_islands[index].bus_index);
+		gl_free(NR_islands[index].branch_index);
+		gl_free(NR_islands[index].matrix_loc);
+		gl_free(NR_islands[index].link_table);
+		gl_free(NR_islands[index].bus);
+		gl_free(NR_islands[index].branch);
+		NR_free_solver(&NR_islands[index].powerflow_values);
+	}
+	gl_free(NR_islands);
+	NR_islands = NULL;
+	NR_island_count = 0;
+}
+
+//Union-find root of a bus
+static unsigned int NR_island_root(unsigned int *parent, unsigned int index)
+{
+	while (parent[index] != index)
+	{
+		parent[index] = parent[parent[index]];	//Halve the path as we go
+		index = parent[index];
+	}
+	return index;
+}
+
+/** Partitions the NR system into electrically independent islands.  Buses are joined by
+	every branch that still carries a phase, and by any branch of a split-phase bus (its
+	self admittance is used whatever the branch phases are), so only fully opened or faulted
+	branches separate islands.  Islands without a single energized bus are left out.  The
+	partition is only rebuilt on an admittance change.
+	@return the number of islands to solve
+ **/
+static unsigned int NR_find_islands(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count, BRANCHDATA *branch)
+{
+	unsigned int *parent, *label, *local;
+	unsigned int index, jindex, root, from_root, count, offset;
+	NR_ISLAND *island;
+
+	if ((NR_islands_valid == true) && (NR_admit_change == false))
+		return NR_island_count;
+
+	NR_free_islands();
+
+	parent = (unsigned int *)gl_malloc(bus_count*sizeof(unsigned int));
+	label = (unsigned int *)gl_malloc(bus_count*sizeof(unsigned int));
+	local = (unsigned int *)gl_malloc(((bus_count > branch_count) ? bus_count : branch_count)*sizeof(unsigned int));
+	if ((parent == NULL) || (label == NULL) || (local == NULL))
+	{
+		GL_THROW("NR: Failed to allocate memory for the island partition");
+		/*  TROUBLESHOOT
+		While splitting the system into electrically independent islands, the Newton-Raphson solver
+		was unable to allocate its working memory.  Please try again.  If the error persists, turn off
+		NR_island_solver or submit your code and a bug report via the ticketing system.
+		*/
+	}
+
+	//Join the ends of every connecting branch
+	for (index=0; index<bus_count; index++)
+		parent[index] = index;
+	for (index=0; index<branch_count; index++)
+	{
+		if ((branch[index].phases != 0) || ((bus[branch[index].from].phases & 0x80) == 0x80) || ((bus[branch[index].to].phases & 0x80) == 0x80))
 		{
-			for (jindex=0; jindex<3; jindex++)
-			{
-				for (kindex=0; kindex<3; kindex++)
-				{		 
-				  if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re() != 0 && bus[jindexer].type != 1 && jindex!=kindex)  
-					  powerflow_values->size_diag_fixed += 1; 
-				  if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im() != 0 && bus[jindexer].type != 1 && jindex!=kindex) 
-					  powerflow_values->size_diag_fixed += 1; 
-				  else {}
-				 }
-			}
+			from_root = NR_island_root(parent,branch[index].from);
+			root = NR_island_root(parent,branch[index].to);
+			if (from_root < root)
+				parent[root] = from_root;
+			else
+				parent[from_root] = root;
 		}
-		if (powerflow_values->Y_diag_fixed == NULL)
-		{
-			powerflow_values->Y_diag_fixed = (Y_NR *)gl_malloc((powerflow_values->size_diag_fixed*2) *sizeof(Y_NR));   //powerflow_values->Y_diag_fixed store the row,column and value of the fixed part of the diagonal PQ bus elements of 6n*6n Y_NR matrix.
+	}
 
-			//Make sure it worked
-			if (powerflow_values->Y_diag_fixed == NULL)
-				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+	//Number the energized islands in bus order
+	for (index=0; index<bus_count; index++)
+		label[index] = bus_count;	//Not energized (yet)
+	count = 0;
+	for (index=0; index<bus_count; index++)
+	{
+		root = NR_island_root(parent,index);
+		if (((bus[index].phases & 0x87) != 0) && (label[root] == bus_count))
+			label[root] = count++;
+	}
 
-			//Update the max size
-			powerflow_values->max_size_diag_fixed = powerflow_values->size_diag_fixed;
+	NR_islands = (NR_ISLAND *)gl_malloc(count*sizeof(NR_ISLAND));
+	if ((count > 0) && (NR_islands == NULL))
+		GL_THROW("NR: Failed to allocate memory for the island partition");
+		//Defined above
+	memset(NR_islands,0,count*sizeof(NR_ISLAND));
+	NR_island_count = count;
+
+	//Size the islands
+	for (index=0; index<bus_count; index++)
+	{
+		root = NR_island_root(parent,index);
+		if (label[root] < count)
+			NR_islands[label[root]].bus_count++;
+	}
+	for (index=0; index<branch_count; index++)
+	{
+		root = NR_island_root(parent,branch[index].from);
+		if ((root == NR_island_root(parent,branch[index].to)) && (label[root] < count))
+			NR_islands[label[root]].branch_count++;
+	}
+
+	//Allocate and list the buses and branches of each island
+	for (jindex=0; jindex<count; jindex++)
+	{
+		island = NR_islands + jindex;
+		island->bus_index = (unsigned int *)gl_malloc(island->bus_count*sizeof(unsigned int));
+		island->matrix_loc = (unsigned int *)gl_malloc(island->bus_count*sizeof(unsigned int));
+		island->bus = (BUSDATA *)gl_malloc(island->bus_count*sizeof(BUSDATA));
+		island->branch_index = (unsigned int *)gl_malloc((island->branch_count+1)*sizeof(unsigned int));
+		island->branch = (BRANCHDATA *)gl_malloc((island->branch_count+1)*sizeof(BRANCHDATA));
+		if ((island->bus_index == NULL) || (island->matrix_loc == NULL) || (island->bus == NULL) || (island->branch_index == NULL) || (island->branch == NULL))
+			GL_THROW("NR: Failed to allocate memory for the island partition");
+			//Defined above
+		island->bus_count = island->branch_count = 0;
+	}
+	for (index=0; index<bus_count; index++)
+	{
+		root = NR_island_root(parent,index);
+		if (label[root] < count)
+		{
+			island = NR_islands + label[root];
+			local[index] = island->bus_count;
+			island->matrix_loc[island->bus_count] = 0;
+			island->bus_index[island->bus_count++] = index;
 		}
-		else if (powerflow_values->size_diag_fixed > powerflow_values->max_size_diag_fixed)		//Something changed and we are bigger!!
+	}
+	for (index=0; index<branch_count; index++)
+	{
+		root = NR_island_root(parent,branch[index].from);
+		if ((root == NR_island_root(parent,branch[index].to)) && (label[root] < count))
 		{
-			//Destroy us!
-			gl_free(powerflow_values->Y_diag_fixed);
-
-			//Rebuild us, we have the technology
-			powerflow_values->Y_diag_fixed = (Y_NR *)gl_malloc((powerflow_values->size_diag_fixed*2) *sizeof(Y_NR));
+			island = NR_islands + label[root];
+			island->branch_index[island->branch_count++] = index;
+		}
+	}
 
-			//Make sure it worked
-			if (powerflow_values->Y_diag_fixed == NULL)
-				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+	//Renumber the link tables - bus-local numbering is no longer needed, so reuse it for branches
+	for (jindex=0; jindex<count; jindex++)
+	{
+		island = NR_islands + jindex;
+		for (index=0; index<island->branch_count; index++)
+			local[island->branch_index[index]] = index;
+
+		offset = 0;
+		for (index=0; index<island->bus_count; index++)
+			offset += bus[island->bus_index[index]].Link_Table_Size;
+		island->link_table = (int *)gl_malloc((offset+1)*sizeof(int));
+		if (island->link_table == NULL)
+			GL_THROW("NR: Failed to allocate memory for the island partition");
+			//Defined above
 
-			//Store the new size
-			powerflow_values->max_size_diag_fixed = powerflow_values->size_diag_fixed;
+		offset = 0;
+		for (index=0; index<island->bus_count; index++)
+		{
+			BUSDATA *node = bus + island->bus_index[index];
+			unsigned int link;
+			island->bus[index] = *node;
+			island->bus[index].Link_Table = island->link_table + offset;
+			island->bus[index].Link_Table_Size = 0;
+			for (link=0; link<node->Link_Table_Size; link++)
+			{
+				BRANCHDATA *line = branch + node->Link_Table[link];
+				if (NR_island_root(parent,line->from) == NR_island_root(parent,line->to))
+					island->link_table[offset + island->bus[index].Link_Table_Size++] = local[node->Link_Table[link]];
+				//Default else - opened branch to another island, not part of either
+			}
+			offset += island->bus[index].Link_Table_Size;
+		}
+	}
 
-			//Flag for a reallocation
-			powerflow_values->NR_realloc_needed = true;
+	//Branch ends in island numbering (the link tables above used local for branches)
+	for (jindex=0; jindex<count; jindex++)
+	{
+		island = NR_islands + jindex;
+		for (index=0; index<island->bus_count; index++)
+			local[island->bus_index[index]] = index;
+		for (index=0; index<island->branch_count; index++)
+		{
+			island->branch[index] = branch[island->branch_index[index]];
+			island->branch[index].from = local[island->branch[index].from];
+			island->branch[index].to = local[island->branch[index].to];
 		}
+	}
 
-		indexer = 0;
-		for (jindexer=0; jindexer<bus_count;jindexer++)	//Parse through bus list
-		{ 
-			for (jindex=0; jindex<powerflow_values->BA_diag[jindexer].size; jindex++)
-			{
-				for (kindex=0; kindex<powerflow_values->BA_diag[jindexer].size; kindex++)
-				{					
-					if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im() != 0 && bus[jindexer].type != 1 && jindex!=kindex)
-					{
-						powerflow_values->Y_diag_fixed[indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex;
-						powerflow_values->Y_diag_fixed[indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex;
-						powerflow_values->Y_diag_fixed[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im();
-						indexer += 1;
-
-						powerflow_values->Y_diag_fixed[indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex +powerflow_values->BA_diag[jindexer].size;
-						powerflow_values->Y_diag_fixed[indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex +powerflow_values->BA_diag[jindexer].size;
-						powerflow_values->Y_diag_fixed[indexer].Y_value = -(powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im();
-						indexer += 1;
-					}
+	gl_free(parent);
+	gl_free(label);
+	gl_free(local);
 
-					if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re() != 0 && bus[jindexer].type != 1 && jindex!=kindex)
-					{
-						powerflow_values->Y_diag_fixed[indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex;
-						powerflow_values->Y_diag_fixed[indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex +powerflow_values->BA_diag[jindexer].size;
-						powerflow_values->Y_diag_fixed[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re();
-						indexer += 1;
-						
-						powerflow_values->Y_diag_fixed[indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex +powerflow_values->BA_diag[jindexer].size;
-						powerflow_values->Y_diag_fixed[indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex;
-						powerflow_values->Y_diag_fixed[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re();
-						indexer += 1;
-					}
-				}
-			}
-		}//End bus parse for fixed diagonal
-	}//End admittance update
+	NR_islands_valid = true;
+	gl_verbose("solver_nr: system split into %d independent islands",count);
+	return count;
+}
 
-	//Reset saturation checks
-	SaturationMismatchPresent = false;
+//Solve one island - refreshes the copies from the NR arrays, since the objects may have changed their entries
+static void NR_solve_island(NR_ISLAND *island)
+{
+	unsigned int index;
+	int *links;
+	unsigned int link_size;
 
-	//Calculate the system load - this is the specified power of the system
-	for (Iteration=0; Iteration<NR_iteration_limit; Iteration++)
+	for (index=0; index<island->bus_count; index++)
 	{
-		//System load at each bus is represented by second order polynomial equations
-		for (indexer=0; indexer<bus_count; indexer++)
-		{
-			if ((bus[indexer].phases & 0x08) == 0x08)	//Delta connected node
-			{
-				//Populate the values for constant current -- deltamode different right now (all same in future?)
-				if (*bus[indexer].dynamics_enabled == true)
-				{
-					//Create nominal magnitudes
-					adjust_nominal_voltage_val = bus[indexer].volt_base * sqrt(3.0);
+		links = island->bus[index].Link_Table;
+		link_size = island->bus[index].Link_Table_Size;
+		island->bus[index] = NR_busdata[island->bus_index[index]];
+		island->bus[index].Link_Table = links;
+		island->bus[index].Link_Table_Size = link_size;
+		island->bus[index].Matrix_Loc = island->matrix_loc[index];
+	}
+	for (index=0; index<island->branch_count; index++)
+	{
+		int from = island->branch[index].from;
+		int to = island->branch[index].to;
+		island->branch[index] = NR_branchdata[island->branch_index[index]];
+		island->branch[index].from = from;
+		island->branch[index].to = to;
+	}
 
-					//Create the nominal voltage vectors
-					adjust_temp_nominal_voltage[0].SetPolar(adjust_nominal_voltage_val,PI/6.0);
-					adjust_temp_nominal_voltage[1].SetPolar(adjust_nominal_voltage_val,-1.0*PI/2.0);
-					adjust_temp_nominal_voltage[2].SetPolar(adjust_nominal_voltage_val,5.0*PI/6.0);
+	island->result = solver_nr(island->bus_count,island->bus,island->branch_count,island->branch,&island->powerflow_values,island->powerflow_type,NULL,&island->bad_computations);
 
-					//Compute delta voltages
-					voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
-					voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
-					voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
+	for (index=0; index<island->bus_count; index++)
+		island->matrix_loc[index] = island->bus[index].Matrix_Loc;
+}
 
-					//Get magnitudes of all
-					adjust_temp_voltage_mag[0] = voltageDel[0].Mag();
-					adjust_temp_voltage_mag[1] = voltageDel[1].Mag();
-					adjust_temp_voltage_mag[2] = voltageDel[2].Mag();
+//Solves the islands [first,last) on a pool thread
+static TIMESTAMP NR_island_task(TPTASK *task, unsigned int first, unsigned int last, unsigned int thread)
+{
+	unsigned int index;
 
-					//Start adjustments - AB
-					if ((bus[indexer].I[0] != 0.0) && (adjust_temp_voltage_mag[0] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[0] = ~(adjust_temp_nominal_voltage[0] * ~bus[indexer].I[0] * adjust_temp_voltage_mag[0] / (voltageDel[0] * adjust_nominal_voltage_val));
-					}
-					else
-					{
-						adjusted_constant_current[0] = 0.0;
-					}
+	for (index=first; index<last; index++)
+	{
+		//A throw cannot unwind a pool thread, so it is kept with the island for NR_solve_islands
+		NR_islands[index].fault[0] = '\0';
+		try {
+			NR_solve_island(NR_islands+index);
+		}
+		catch (const char *msg)
+		{
+			snprintf(NR_islands[index].fault,sizeof(NR_islands[index].fault),"%s",msg);
+		}
+		catch (...)
+		{
+			snprintf(NR_islands[index].fault,sizeof(NR_islands[index].fault),"unhandled exception");
+		}
+	}
+	return TS_NEVER;
+}
 
-					//Start adjustments - BC
-					if ((bus[indexer].I[1] != 0.0) && (adjust_temp_voltage_mag[1] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[1] = ~(adjust_temp_nominal_voltage[1] * ~bus[indexer].I[1] * adjust_temp_voltage_mag[1] / (voltageDel[1] * adjust_nominal_voltage_val));
-					}
-					else
-					{
-						adjusted_constant_current[1] = 0.0;
-					}
+/** Solves the islands found by NR_find_islands, concurrently on the core pool threads.  Each
+	island iterates until it converges on its own, so one island that fails does not hold the
+	others back; every island's outcome is reported.
+	@return the most iterations any island took, the negative of that if an island did not
+	converge, or 0 if an island could not be solved
+ **/
+static int64 NR_solve_islands(NRSOLVERMODE powerflow_type, bool *bad_computations)
+{
+	TPTASK solve, *run = &solve;
+	unsigned int index, jindex;
+	int64 iterations = 0;
+	bool failed = false, singular = false;
+
+	for (index=0; index<NR_island_count; index++)
+		NR_islands[index].powerflow_type = powerflow_type;
+
+	memset(&solve,0,sizeof(solve));
+	solve.name = "NR islands";
+	solve.call = NR_island_task;
+	solve.n_items = NR_island_count;
+	solve.grain = 1;
+	gl_pool_run(&run,1);
+
+	//Report the first island that threw, as the serial solver would have
+	for (index=0; index<NR_island_count; index++)
+	{
+		if (NR_islands[index].fault[0] != '\0')
+			GL_THROW("%s",NR_islands[index].fault);
+	}
 
-					//Start adjustments - CA
-					if ((bus[indexer].I[2] != 0.0) && (adjust_temp_voltage_mag[2] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[2] = ~(adjust_temp_nominal_voltage[2] * ~bus[indexer].I[2] * adjust_temp_voltage_mag[2] / (voltageDel[2] * adjust_nominal_voltage_val));
-					}
-					else
-					{
-						adjusted_constant_current[2] = 0.0;
-					}
+	//Pass the solver-side bus changes back and combine the outcomes, in island order
+	for (index=0; index<NR_island_count; index++)
+	{
+		NR_ISLAND *island = NR_islands + index;
+		for (jindex=0; jindex<island->bus_count; jindex++)
+			NR_busdata[island->bus_index[jindex]].swing_functions_enabled = island->bus[jindex].swing_functions_enabled;
 
-					//See if we have any "different children"
-					if ((bus[indexer].phases & 0x10) == 0x10)
-					{
-						//Create nominal magnitudes
-						adjust_nominal_voltage_val = bus[indexer].volt_base;
+		if (island->bad_computations == true)
+		{
+			gl_warning("solver_nr: island %d (%d buses, starting at %s) could not be solved",index,island->bus_count,island->bus[0].name);
+			/*  TROUBLESHOOT
+			With NR_island_solver enabled, one of the electrically independent islands of the system could not
+			be solved, typically because its admittance matrix is singular.  The other islands were solved.  Make
+			sure the island has a SWING node or a source, or remove it from service.
+			*/
+			singular = true;
+		}
+		else if (island->result < 0)
+		{
+			gl_warning("solver_nr: island %d (%d buses, starting at %s) did not converge in %d iterations",index,island->bus_count,island->bus[0].name,(int)(-island->result));
+			/*  TROUBLESHOOT
+			With NR_island_solver enabled, one of the electrically independent islands of the system did not
+			converge within NR_iteration_limit.  The other islands were still solved.  Check the loading and
+			sources of that island, or raise NR_iteration_limit.
+			*/
+			failed = true;
+			if (-island->result > iterations)
+				iterations = -island->result;
+		}
+		else
+		{
+			gl_verbose("solver_nr: island %d (%d buses, starting at %s) converged in %d iterations",index,island->bus_count,island->bus[0].name,(int)island->result);
+			if (island->result > iterations)
+				iterations = island->result;
+		}
+	}
 
-						//Create the nominal voltage vectors
-						adjust_temp_nominal_voltage[3].SetPolar(bus[indexer].volt_base,0.0);
-						adjust_temp_nominal_voltage[4].SetPolar(bus[indexer].volt_base,-2.0*PI/3.0);
-						adjust_temp_nominal_voltage[5].SetPolar(bus[indexer].volt_base,2.0*PI/3.0);
+	//The whole-system matrices no longer match the topology they were built for
+	NR_powerflow.admit_stale = true;
 
-						//Get magnitudes of all
-						adjust_temp_voltage_mag[3] = bus[indexer].V[0].Mag();
-						adjust_temp_voltage_mag[4] = bus[indexer].V[1].Mag();
-						adjust_temp_voltage_mag[5] = bus[indexer].V[2].Mag();
+	*bad_computations = singular;
+	if (singular)
+		return 0;
+	else if (failed)
+		return -iterations;
+	else
+		return iterations;
+}
 
-						//Start adjustments - A
-						if ((bus[indexer].extra_var[6] != 0.0) && (adjust_temp_voltage_mag[3] != 0.0))
-						{
-							//calculate new value
-							adjusted_constant_current[3] = ~(adjust_temp_nominal_voltage[3] * ~bus[indexer].extra_var[6] * adjust_temp_voltage_mag[3] / (bus[indexer].V[0] * adjust_nominal_voltage_val));
-						}
-						else
-						{
-							adjusted_constant_current[3] = 0.0;
-						}
+/** Newton-Raphson solver
+	Solves a power flow problem using the Newton-Raphson method
+	
+	@return n=0 on failure to complete a single iteration, 
+	n>0 to indicate success after n interations, or 
+	n<0 to indicate failure after n iterations
+ **/
+int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count, BRANCHDATA *branch, NR_SOLVER_STRUCT *powerflow_values, NRSOLVERMODE powerflow_type , NR_MESHFAULT_IMPEDANCE *mesh_imped_vals, bool *bad_computations)
+{
+	//Internal iteration counter - just NR limits
+	int64 Iteration;
 
-						//Start adjustments - B
-						if ((bus[indexer].extra_var[7] != 0.0) && (adjust_temp_voltage_mag[4] != 0.0))
-						{
-							//calculate new value
-							adjusted_constant_current[4] = ~(adjust_temp_nominal_voltage[4] * ~bus[indexer].extra_var[7] * adjust_temp_voltage_mag[4] / (bus[indexer].V[1] * adjust_nominal_voltage_val));
-						}
-						else
-						{
-							adjusted_constant_current[4] = 0.0;
-						}
+	//File pointer for debug outputs
+	FILE *FPoutVal;
 
-						//Start adjustments - C
-						if ((bus[indexer].extra_var[8] != 0.0) && (adjust_temp_voltage_mag[5] != 0.0))
-						{
-							//calculate new value
-							adjusted_constant_current[5] = ~(adjust_temp_nominal_voltage[5] * ~bus[indexer].extra_var[8] * adjust_temp_voltage_mag[5] / (bus[indexer].V[2] * adjust_nominal_voltage_val));
-						}
-						else
-						{
-							adjusted_constant_current[5] = 0.0;
-						}
-					}
-					else	//Nope
-					{
-						//Set to zero, just cause
-						adjusted_constant_current[3] = 0.0;
-						adjusted_constant_current[4] = 0.0;
-						adjusted_constant_current[5] = 0.0;
-					}
-				}
-				else	//"Normal" modes -- handle traditionally
-				{
-					adjusted_constant_current[0] = bus[indexer].I[0];
-					adjusted_constant_current[1] = bus[indexer].I[1];
-					adjusted_constant_current[2] = bus[indexer].I[2];
+	//A matrix size variable
+	unsigned int size_Amatrix;
 
-					//See if we have different children too
-					if ((bus[indexer].phases & 0x10) == 0x10)
-					{
-						//Store them too
-						adjusted_constant_current[3] = bus[indexer].extra_var[6];
-						adjusted_constant_current[4] = bus[indexer].extra_var[7];
-						adjusted_constant_current[5] = bus[indexer].extra_var[8];
-					}
-					else	//Nope, just zero this for now
-					{
-						adjusted_constant_current[3] = 0.0;
-						adjusted_constant_current[4] = 0.0;
-						adjusted_constant_current[5] = 0.0;
-					}
-				}//End adjustment code
+	//Voltage mismatch tracking variable
+	double Maxmismatch;
 
-				//Delta components - populate according to what is there
-				if ((bus[indexer].phases & 0x06) == 0x06)	//Check for AB
-				{
-					//Voltage calculations
-					voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
+	//Saturation mismatch tracking variable
+	bool SaturationMismatchPresent;
+	int func_result_val;
 
-					//Power - convert to a current (uses less iterations this way)
-					delta_current[0] = (voltageDel[0] == 0) ? 0 : ~(bus[indexer].S[0]/voltageDel[0]);
+	//Phase collapser variable
+	unsigned char phase_worka, phase_workb, phase_workc, phase_workd, phase_worke;
 
-					//Convert delta connected load to appropriate Wye
-					delta_current[0] += voltageDel[0] * (bus[indexer].Y[0]);
-				}
-				else
-				{
-					//Zero values - they shouldn't be used anyhow
-					voltageDel[0] = 0.0;
-					delta_current[0] = 0.0;
-				}
+	//Miscellaneous index variable
+	unsigned int indexer, tempa, tempb, jindexer, kindexer;
+	char jindex, kindex;
+	char temp_index, temp_index_b;
+	unsigned int temp_index_c;
 
-				if ((bus[indexer].phases & 0x03) == 0x03)	//Check for BC
-				{
-					//Voltage calculations
-					voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
+	//Working matrix for admittance collapsing/determinations
+	complex tempY[3][3];
 
-					//Power - convert to a current (uses less iterations this way)
-					delta_current[1] = (voltageDel[1] == 0) ? 0 : ~(bus[indexer].S[1]/voltageDel[1]);
+	//Working matrix for mesh fault impedance storage, prior to "reconstruction"
+	double temp_z_store[6][6];
 
-					//Convert delta connected load to appropriate Wye
-					delta_current[1] += voltageDel[1] * (bus[indexer].Y[1]);
-				}
-				else
-				{
-					//Zero unused
-					voltageDel[1] = 0.0;
-					delta_current[1] = 0.0;
-				}
+	//Miscellaneous flag variables
+	bool Full_Mat_A, Full_Mat_B;
 
-				if ((bus[indexer].phases & 0x05) == 0x05)	//Check for CA
-				{
-					//Voltage calculations
-					voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
+	//Iteration flag
+	bool newiter;
 
-					//Power - convert to a current (uses less iterations this way)
-					delta_current[2] = (voltageDel[2] == 0) ? 0 : ~(bus[indexer].S[2]/voltageDel[2]);
+	//Deltamode pass flag - changes how SWING buses are handled
+	//Multiple SWING-bus attached generators may cause issues, but no good way to detect
+	bool swing_is_a_swing;
 
-					//Convert delta connected load to appropriate Wye
-					delta_current[2] += voltageDel[2] * (bus[indexer].Y[2]);
-				}
-				else
-				{
-					//Zero unused
-					voltageDel[2] = 0.0;
-					delta_current[2] = 0.0;
-				}
-				
-				//Convert delta-current into a phase current, where appropriate - reuse temp variable
-				//Everything will be accumulated into the "current" field for ease (including differents)
-				if ((bus[indexer].phases & 0x04) == 0x04)	//Has a phase A
-				{
-					undeltacurr[0]=(adjusted_constant_current[0]+delta_current[0])-(adjusted_constant_current[2]+delta_current[2]);
+	//Deltamode initial dynamics run - swing convergence flag (symmetry)
+	bool swing_converged;
 
-					//Check for "different" children and apply them, as well
-					if ((bus[indexer].phases & 0x10) == 0x10)	//We do, so they must be Wye-connected
-					{
-						//Power values
-						undeltacurr[0] += (bus[indexer].V[0] == 0) ? 0 : ~(bus[indexer].extra_var[0]/bus[indexer].V[0]);
+	//Deltamode intermediate variables
+	complex temp_complex_0, temp_complex_1, temp_complex_2, temp_complex_3, temp_complex_4, temp_complex_5;
+	complex aval, avalsq;
 
-						//Shunt values
-						undeltacurr[0] += bus[indexer].extra_var[3]*bus[indexer].V[0];
+	//Temporary size variable
+	char temp_size, temp_size_b, temp_size_c;
 
-						//Current values
-						undeltacurr[0] += adjusted_constant_current[3];
-					}
-				}
-				else
-				{
-					//Zero it, just in case
-					undeltacurr[0] = 0.0;
-				}
+	//Temporary admittance variables
+	complex Temp_Ad_A[3][3];
+	complex Temp_Ad_B[3][3];
 
-				if ((bus[indexer].phases & 0x02) == 0x02)	//Has a phase B
-				{
-					undeltacurr[1]=(adjusted_constant_current[1]+delta_current[1])-(adjusted_constant_current[0]+delta_current[0]);
+	//Per-bus pass description
+	NR_RANGE bus_pass;
+	unsigned int n_threads;
 
-					//Check for "different" children and apply them, as well
-					if ((bus[indexer].phases & 0x10) == 0x10)	//We do, so they must be Wye-connected
-					{
-						//Power values
-						undeltacurr[1] += (bus[indexer].V[1] == 0) ? 0 : ~(bus[indexer].extra_var[1]/bus[indexer].V[1]);
+	//Miscellaneous counter tracker
+	unsigned int index_count = 0;
 
-						//Shunt values
-						undeltacurr[1] += bus[indexer].extra_var[4]*bus[indexer].V[1];
+	//SuperLU variables
+	SuperMatrix L_LU,U_LU;
+	NCformat *Astore;
+	DNformat *Bstore;
+	int nnz, info;
+	unsigned int m,n;
+	double *sol_LU;
 
-						//Current values
-						undeltacurr[1] += adjusted_constant_current[4];
-					}
-				}
-				else
-				{
-					//Zero it, just in case
-					undeltacurr[1] = 0.0;
-				}
+	//Spare notation variable - for output
+	SP_E *temp_element;
+	int row, col;
+	double value;
+	
+#ifndef MT
+	superlu_options_t options;	//Additional variables for sequential superLU
+	SuperLUStat_t stat;
+#endif
 
+	//Admittance change flag for this system - also rebuild if its structures are out of date
+	bool admit_change;
 
-				if ((bus[indexer].phases & 0x01) == 0x01)	//Has a phase C
-				{
-					undeltacurr[2]=(adjusted_constant_current[2]+delta_current[2])-(adjusted_constant_current[1]+delta_current[1]);
+	//Electrically independent islands are solved as separate systems
+	if ((mesh_imped_vals == NULL) && (bus == NR_busdata) && (powerflow_values == &NR_powerflow) && (NR_island_solver == true) && (matrix_solver_method == MM_SUPERLU) && (NRMatDumpMethod == MD_NONE))
+	{
+		if (NR_find_islands(bus_count,bus,branch_count,branch) > 1)
+			return NR_solve_islands(powerflow_type,bad_computations);
+		//Default else - one island, solve the whole system below
+	}
 
-					//Check for "different" children and apply them, as well
-					if ((bus[indexer].phases & 0x10) == 0x10)		//We do, so they must be Wye-connected
-						{
-						//Power values
-						undeltacurr[2] += (bus[indexer].V[2] == 0) ? 0 : ~(bus[indexer].extra_var[2]/bus[indexer].V[2]);
+	//Per-system LU storage
+	if (powerflow_values->LU == NULL)
+	{
+		powerflow_values->LU = (NR_LU *)gl_malloc(sizeof(NR_LU));
+		if (powerflow_values->LU == NULL)
+			GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
+			//Defined below
+		memset(powerflow_values->LU,0,sizeof(NR_LU));
+	}
+	NR_SOLVER_VARS &matrices_LU = powerflow_values->LU->matrices_LU;
+	int *&perm_c = powerflow_values->LU->perm_c;
+	int *&perm_r = powerflow_values->LU->perm_r;
+	SuperMatrix &A_LU = powerflow_values->LU->A_LU;
+	SuperMatrix &B_LU = powerflow_values->LU->B_LU;
 
-						//Shunt values
-						undeltacurr[2] += bus[indexer].extra_var[5]*bus[indexer].V[2];
+	admit_change = NR_admit_change || powerflow_values->admit_stale || (powerflow_values->BA_diag == NULL);
+	powerflow_values->admit_stale = false;
 
-						//Current values
-						undeltacurr[2] += adjusted_constant_current[5];
-					}
-				}
-				else
-				{
-					//Zero it, just in case
-					undeltacurr[2] = 0.0;
-				}
+	//Ensure bad computations flag is set first
+	*bad_computations = false;
 
-				//Provide updates to relevant phases
-				//only compute and store phases that exist (make top heavy)
-				temp_index = -1;
-				temp_index_b = -1;
-				
-				for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
-				{
-					switch(bus[indexer].phases & 0x07) {
-						case 0x01:	//C
-							{
-								temp_index=0;
-								temp_index_b=2;
-								break;
-							}
-						case 0x02:	//B
-							{
-								temp_index=0;
-								temp_index_b=1;
-								break;
-							}
-						case 0x03:	//BC
-							{
-								if (jindex==0)	//B
-								{
-									temp_index=0;
-									temp_index_b=1;
-								}
-								else			//C
-								{
-									temp_index=1;
-									temp_index_b=2;
-								}
-								break;
-							}
-						case 0x04:	//A
-							{
-								temp_index=0;
-								temp_index_b=0;
-								break;
-							}
-						case 0x05:	//AC
-							{
-								if (jindex==0)	//A
-								{
-									temp_index=0;
-									temp_index_b=0;
-								}
-								else			//C
-								{
-									temp_index=1;
-									temp_index_b=2;
-								}
-								break;
-							}
-						case 0x06:	//AB
-						case 0x07:	//ABC
-							{
-								temp_index=jindex;
-								temp_index_b=jindex;
-								break;
-							}
-						default:
-							break;
-					}//end case
+	//Determine special circumstances of SWING bus -- do we want it to truly participate right
+	if (powerflow_type != PF_NORMAL)
+	{
+		if (powerflow_type == PF_DYNCALC)	//Parse the list -- anything that is a swing and a generator, deflag it out of principle (and to make it work right)
+		{
+			//Set the master swing flag
+			swing_is_a_swing = false;
 
-					if ((temp_index==-1) || (temp_index_b==-1))
+			//Check the buses
+			for (indexer=0; indexer<bus_count; indexer++)
+			{
+				//See if we're a swing-flagged bus
+				if ((bus[indexer].type > 1) && (bus[indexer].swing_functions_enabled == true))
+				{
+					//See if we're "generator ready"
+					if ((*bus[indexer].dynamics_enabled==true) && (bus[indexer].full_Y != NULL) && (bus[indexer].DynCurrent != NULL))
 					{
-						GL_THROW("NR: A scheduled power update element failed.");
-						//Defined below
+						//Deflag us back to "PQ" status
+						bus[indexer].swing_functions_enabled = false;
 					}
+				}
+				//Default else -- normal bus
+			}//End bus traversion loop
+		}//Handle running dynamics differently
+		else	//Must be PF_DYNINIT
+		{
+			//Flag us as true, initially
+			swing_is_a_swing = true;
+		}
+	}//End not normal
+	else	//Must be normal
+	{
+		swing_is_a_swing = true;	//Flag as a swing, even though this shouldn't do anything
+	}
 
-					//Real power calculations
-					tempPbus = (undeltacurr[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Re() + (undeltacurr[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Im();	// Real power portion of Constant current component multiply the magnitude of bus voltage
-					bus[indexer].PL[temp_index] = tempPbus;	//Real power portion - all is current based
+	//Populate aval, if necessary
+	if (powerflow_type == PF_DYNINIT)
+	{
+		//Conversion variables - 1@120-deg
+		aval = complex(-0.5,(sqrt(3.0)/2.0));
+		avalsq = aval*aval;	//squared value is used a couple places too
+	}
+	else	//Zero it, just in case something uses it (what would???)
+	{
+		aval = 0.0;
+		avalsq = 0.0;
+	}
 
-					//Reactive load calculations
-					tempQbus = (undeltacurr[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Im() - (undeltacurr[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Re();	// Reactive power portion of Constant current component multiply the magnitude of bus voltage
-					bus[indexer].QL[temp_index] = tempQbus;	//Reactive power portion - all is current based
-					
-				}//End phase traversion
-			}//end delta connected
-			else if ((bus[indexer].phases & 0x80) == 0x80)	//Split-phase connected node
-			{
-				//Convert it all back to current (easiest to handle)
-				//Get V12 first
-				voltageDel[0] = bus[indexer].V[0] + bus[indexer].V[1];
-
-				//Start with the currents (just put them in)
-				temp_current[0] = bus[indexer].I[0];
-				temp_current[1] = bus[indexer].I[1];
-				temp_current[2] = *bus[indexer].extra_var;	//Current12 is not part of the standard current array
-
-				//Add in deltamode unrotated, if necessary
-				if ((bus[indexer].prerot_I[2] != 0.0) && (*bus[indexer].dynamics_enabled == true))
-					temp_current[2] += bus[indexer].prerot_I[2];
-
-				//Now add in power contributions
-				temp_current[0] += bus[indexer].V[0] == 0.0 ? 0.0 : ~(bus[indexer].S[0]/bus[indexer].V[0]);
-				temp_current[1] += bus[indexer].V[1] == 0.0 ? 0.0 : ~(bus[indexer].S[1]/bus[indexer].V[1]);
-				temp_current[2] += voltageDel[0] == 0.0 ? 0.0 : ~(bus[indexer].S[2]/voltageDel[0]);
-
-				//Last, but not least, admittance/impedance contributions
-				temp_current[0] += bus[indexer].Y[0]*bus[indexer].V[0];
-				temp_current[1] += bus[indexer].Y[1]*bus[indexer].V[1];
-				temp_current[2] += bus[indexer].Y[2]*voltageDel[0];
-
-				//See if we are a house-connected node, if so, adjust and add in those values as well
-				if ((bus[indexer].phases & 0x40) == 0x40)
-				{
-					//Update phase adjustments
-					temp_store[0].SetPolar(1.0,bus[indexer].V[0].Arg());	//Pull phase of V1
-					temp_store[1].SetPolar(1.0,bus[indexer].V[1].Arg());	//Pull phase of V2
-					temp_store[2].SetPolar(1.0,voltageDel[0].Arg());		//Pull phase of V12
-
-					//Update these current contributions (use delta current variable, it isn't used in here anyways)
-					delta_current[0] = bus[indexer].house_var[0]/(~temp_store[0]);		//Just denominator conjugated to keep math right (rest was conjugated in house)
-					delta_current[1] = bus[indexer].house_var[1]/(~temp_store[1]);
-					delta_current[2] = bus[indexer].house_var[2]/(~temp_store[2]);
-
-					//Now add it into the current contributions
-					temp_current[0] += delta_current[0];
-					temp_current[1] += delta_current[1];
-					temp_current[2] += delta_current[2];
-				}//End house-attached splitphase
-
-				//Convert 'em to line currents
-				temp_store[0] = temp_current[0] + temp_current[2];
-				temp_store[1] = -temp_current[1] - temp_current[2];
-
-				//Update the stored values
-				bus[indexer].PL[0] = temp_store[0].Re();
-				bus[indexer].QL[0] = temp_store[0].Im();
-
-				bus[indexer].PL[1] = temp_store[1].Re();
-				bus[indexer].QL[1] = temp_store[1].Im();
-			}//end split-phase connected
-			else	//Wye-connected node
-			{
-				//Populate the values for constant current -- deltamode different right now (all same in future?)
-				if (*bus[indexer].dynamics_enabled == true)
-				{
-					//Create nominal magnitudes
-					adjust_nominal_voltage_val = bus[indexer].volt_base;
+	if (matrix_solver_method==MM_EXTERN)
+	{
+		//Call the initialization routine
+		ext_solver_glob_vars = ((void *(*)(void *))(LUSolverFcns.ext_init))(ext_solver_glob_vars);
 
-					//Create the nominal voltage vectors
-					adjust_temp_nominal_voltage[3].SetPolar(bus[indexer].volt_base,0.0);
-					adjust_temp_nominal_voltage[4].SetPolar(bus[indexer].volt_base,-2.0*PI/3.0);
-					adjust_temp_nominal_voltage[5].SetPolar(bus[indexer].volt_base,2.0*PI/3.0);
+		//Make sure it worked (allocation check)
+		if (ext_solver_glob_vars==NULL)
+		{
+			GL_THROW("External LU matrix solver failed to allocate memory properly!");
+			/*  TROUBLESHOOT
+			While attempting to allocate memory for the external LU solver, an error occurred.
+			Please try again.  If the error persists, ensure your external LU solver is behaving correctly
+			and coordinate with their development team as necessary.
+			*/
+		}
+	}
 
-					//Get magnitudes of all
-					adjust_temp_voltage_mag[3] = bus[indexer].V[0].Mag();
-					adjust_temp_voltage_mag[4] = bus[indexer].V[1].Mag();
-					adjust_temp_voltage_mag[5] = bus[indexer].V[2].Mag();
+	if (admit_change)	//If an admittance update was detected, fix it
+	{
+		//Build the diagnoal elements of the bus admittance matrix - this should only happen once no matter what
+		if (powerflow_values->BA_diag == NULL)
+		{
+			powerflow_values->BA_diag = (Bus_admit *)gl_malloc(bus_count *sizeof(Bus_admit));   //BA_diag store the location and value of diagonal elements of Bus Admittance matrix
 
-					//Start adjustments - A
-					if ((bus[indexer].I[0] != 0.0) && (adjust_temp_voltage_mag[3] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[0] = ~(adjust_temp_nominal_voltage[3] * ~bus[indexer].I[0] * adjust_temp_voltage_mag[3] / (bus[indexer].V[0] * adjust_nominal_voltage_val));
-					}
-					else
-					{
-						adjusted_constant_current[0] = 0.0;
-					}
+			//Make sure it worked
+			if (powerflow_values->BA_diag == NULL)
+			{
+				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+				/*  TROUBLESHOOT
+				During the allocation stage of the NR algorithm, one of the matrices failed to be allocated.
+				Please try again and if this bug persists, submit your code and a bug report using the trac
+				website.
+				*/
+			}
+		}
+		
+		for (indexer=0; indexer<bus_count; indexer++) // Construct the diagonal elements of Bus admittance matrix.
+		{
+			//Determine the size we need
+			if ((bus[indexer].phases & 0x80) == 0x80)	//Split phase
+				powerflow_values->BA_diag[indexer].size = 2;
+			else										//Other cases, figure out how big they are
+			{
+				phase_worka = 0;
+				for (jindex=0; jindex<3; jindex++)		//Accumulate number of phases
+				{
+					phase_worka += ((bus[indexer].phases & (0x01 << jindex)) >> jindex);
+				}
+				powerflow_values->BA_diag[indexer].size = phase_worka;
+			}
 
-					//Start adjustments - B
-					if ((bus[indexer].I[1] != 0.0) && (adjust_temp_voltage_mag[4] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[1] = ~(adjust_temp_nominal_voltage[4] * ~bus[indexer].I[1] * adjust_temp_voltage_mag[4] / (bus[indexer].V[1] * adjust_nominal_voltage_val));
-					}
-					else
-					{
-						adjusted_constant_current[1] = 0.0;
-					}
+			//Ensure the admittance matrix is zeroed
+			for (jindex=0; jindex<3; jindex++)
+			{
+				for (kindex=0; kindex<3; kindex++)
+				{
+					powerflow_values->BA_diag[indexer].Y[jindex][kindex] = 0;
+					tempY[jindex][kindex] = 0;
+				}
+			}
 
-					//Start adjustments - C
-					if ((bus[indexer].I[2] != 0.0) && (adjust_temp_voltage_mag[5] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[2] = ~(adjust_temp_nominal_voltage[5] * ~bus[indexer].I[2] * adjust_temp_voltage_mag[5] / (bus[indexer].V[2] * adjust_nominal_voltage_val));
-					}
-					else
+			//If we're in any deltamode, store out self-admittance as well, if it exists
+			if ((powerflow_type!=PF_NORMAL) && (bus[indexer].full_Y != NULL))
+			{
+				//Loop and add
+				for (jindex=0; jindex<3; jindex++)
+				{
+					for (kindex=0; kindex<3; kindex++)
 					{
-						adjusted_constant_current[2] = 0.0;
+						tempY[jindex][kindex] = bus[indexer].full_Y[jindex*3+kindex];	//Adds in any self-admittance terms (generators)
 					}
+				}
+			}
 
-					//Testing - do adjustments for unrotated current
-					if (bus[indexer].prerot_I[0] != 0.0)
-						adjusted_constant_current[0] += bus[indexer].prerot_I[0];
-
-					if (bus[indexer].prerot_I[1] != 0.0)
-						adjusted_constant_current[1] += bus[indexer].prerot_I[1];
-
-					if (bus[indexer].prerot_I[2] != 0.0)
-						adjusted_constant_current[2] += bus[indexer].prerot_I[2];
+			//Now go through all of the branches to get the self admittance information (hinges on size)
+			for (kindexer=0; kindexer<(bus[indexer].Link_Table_Size);kindexer++)
+			{ 
+				//Assign jindexer as intermediate variable (easier for me this way)
+				jindexer = bus[indexer].Link_Table[kindexer];
 
-					//See if we have any "different children"
-					if ((bus[indexer].phases & 0x10) == 0x10)
+				if ((branch[jindexer].from == indexer) || (branch[jindexer].to == indexer))	//Bus is the from or to side of things - not sure how it would be in link table otherwise, but meh
+				{
+					if ((bus[indexer].phases & 0x07) == 0x07)		//Full three phase
 					{
-						//Create nominal magnitudes
-						adjust_nominal_voltage_val = bus[indexer].volt_base * sqrt(3.0);
-
-						//Create the nominal voltage vectors
-						adjust_temp_nominal_voltage[0].SetPolar(adjust_nominal_voltage_val,PI/6.0);
-						adjust_temp_nominal_voltage[1].SetPolar(adjust_nominal_voltage_val,-1.0*PI/2.0);
-						adjust_temp_nominal_voltage[2].SetPolar(adjust_nominal_voltage_val,5.0*PI/6.0);
-
-						//Compute delta voltages
-						voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
-						voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
-						voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
-
-						//Get magnitudes of all
-						adjust_temp_voltage_mag[0] = voltageDel[0].Mag();
-						adjust_temp_voltage_mag[1] = voltageDel[1].Mag();
-						adjust_temp_voltage_mag[2] = voltageDel[2].Mag();
-
-						//Start adjustments - AB
-						if ((bus[indexer].extra_var[6] != 0.0) && (adjust_temp_voltage_mag[0] != 0.0))
-						{
-							//calculate new value
-							adjusted_constant_current[3] = ~(adjust_temp_nominal_voltage[0] * ~bus[indexer].extra_var[6] * adjust_temp_voltage_mag[0] / (voltageDel[0] * adjust_nominal_voltage_val));
-						}
-						else
+						for (jindex=0; jindex<3; jindex++)	//Add in all three phase values
 						{
-							adjusted_constant_current[3] = 0.0;
-						}
+							//See if this phase is valid
+							phase_workb = 0x04 >> jindex;
 
-						//Start adjustments - BC
-						if ((bus[indexer].extra_var[7] != 0.0) && (adjust_temp_voltage_mag[1] != 0.0))
-						{
-							//calculate new value
-							adjusted_constant_current[4] = ~(adjust_temp_nominal_voltage[1] * ~bus[indexer].extra_var[7] * adjust_temp_voltage_mag[1] / (voltageDel[1] * adjust_nominal_voltage_val));
-						}
-						else
-						{
-							adjusted_constant_current[4] = 0.0;
-						}
+							if ((phase_workb & branch[jindexer].phases) == phase_workb)
+							{
+								for (kindex=0; kindex<3; kindex++)
+								{
+									//Check phase
+									phase_workd = 0x04 >> kindex;
 
-						//Start adjustments - CA
-						if ((bus[indexer].extra_var[8] != 0.0) && (adjust_temp_voltage_mag[2] != 0.0))
+									if ((phase_workd & branch[jindexer].phases) == phase_workd)
+									{
+										if (branch[jindexer].from == indexer)	//We're the from version
+										{
+											tempY[jindex][kindex] += branch[jindexer].YSfrom[jindex*3+kindex];
+										}
+										else									//Must be the to version
+										{
+											tempY[jindex][kindex] += branch[jindexer].YSto[jindex*3+kindex];
+										}
+									}//End valid column phase
+								}
+							}//End valid row phase
+						}
+					}
+					else if ((bus[indexer].phases & 0x80) == 0x80)	//Split phase - add in 2x2 element to upper left 2x2
+					{
+						if (branch[jindexer].from == indexer)	//From branch
 						{
-							//calculate new value
-							adjusted_constant_current[5] = ~(adjust_temp_nominal_voltage[2] * ~bus[indexer].extra_var[8] * adjust_temp_voltage_mag[2] / (voltageDel[2] * adjust_nominal_voltage_val));
+							//End of SPCT transformer requires slightly different Diagonal components (so when it's the To bus of SPCT and from for other triplex
+							if ((bus[indexer].phases & 0x20) == 0x20)	//Special case
+							{
+								//Other triplexes need to be negated to match sign conventions
+								tempY[0][0] -= branch[jindexer].YSfrom[0];
+								tempY[0][1] -= branch[jindexer].YSfrom[1];
+								tempY[1][0] -= branch[jindexer].YSfrom[3];
+								tempY[1][1] -= branch[jindexer].YSfrom[4];
+							}
+							else										//Just a normal to bus
+							{
+								tempY[0][0] += branch[jindexer].YSfrom[0];
+								tempY[0][1] += branch[jindexer].YSfrom[1];
+								tempY[1][0] += branch[jindexer].YSfrom[3];
+								tempY[1][1] += branch[jindexer].YSfrom[4];
+							}
 						}
-						else
+						else									//To branch
 						{
-							adjusted_constant_current[5] = 0.0;
+							tempY[0][0] += branch[jindexer].YSto[0];
+							tempY[0][1] += branch[jindexer].YSto[1];
+							tempY[1][0] += branch[jindexer].YSto[3];
+							tempY[1][1] += branch[jindexer].YSto[4];
 						}
 					}
-					else	//Nope
+					else	//We must be a single or two-phase line - always populate the upper left portion of matrix (easier for later)
 					{
-						//Set to zero, just cause
-						adjusted_constant_current[3] = 0.0;
-						adjusted_constant_current[4] = 0.0;
-						adjusted_constant_current[5] = 0.0;
-					}
-				}
-				else	//"Normal" modes -- handle traditionally
+						switch(bus[indexer].phases & 0x07) {
+							case 0x00:	//No phases (we've been faulted out
+								{
+									break;	//Just get us outta here
+								}
+							case 0x01:	//Only C
+								{
+									if ((branch[jindexer].phases & 0x01) == 0x01)	//Phase C valid on branch
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[0][0] += branch[jindexer].YSfrom[8];
+										}
+										else									//To branch
+										{
+											tempY[0][0] += branch[jindexer].YSto[8];
+										}
+									}//End valid phase C
+									break;
+								}
+							case 0x02:	//Only B
+								{
+									if ((branch[jindexer].phases & 0x02) == 0x02)	//Phase B valid on branch
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[0][0] += branch[jindexer].YSfrom[4];
+										}
+										else									//To branch
+										{
+											tempY[0][0] += branch[jindexer].YSto[4];
+										}
+									}//End valid phase B
+									break;
+								}
+							case 0x03:	//B & C
+								{
+									phase_worka = (branch[jindexer].phases & 0x03);	//Extract branch phases
+
+									if (phase_worka == 0x03)	//Full B & C
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[0][0] += branch[jindexer].YSfrom[4];
+											tempY[0][1] += branch[jindexer].YSfrom[5];
+											tempY[1][0] += branch[jindexer].YSfrom[7];
+											tempY[1][1] += branch[jindexer].YSfrom[8];
+										}
+										else									//To branch
+										{
+											tempY[0][0] += branch[jindexer].YSto[4];
+											tempY[0][1] += branch[jindexer].YSto[5];
+											tempY[1][0] += branch[jindexer].YSto[7];
+											tempY[1][1] += branch[jindexer].YSto[8];
+										}
+									}//End valid B & C
+									else if (phase_worka == 0x01)	//Only C branch
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[1][1] += branch[jindexer].YSfrom[8];
+										}
+										else									//To branch
+										{
+											tempY[1][1] += branch[jindexer].YSto[8];
+										}
+									}//end valid C
+									else if (phase_worka == 0x02)	//Only B branch
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[0][0] += branch[jindexer].YSfrom[4];
+										}
+										else									//To branch
+										{
+											tempY[0][0] += branch[jindexer].YSto[4];
+										}
+									}//end valid B
+									else	//Must be nothing then - all phases must be faulted, or something
+										;
+									break;
+								}
+							case 0x04:	//Only A
+								{
+									if ((branch[jindexer].phases & 0x04) == 0x04)	//Phase A is valid
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[0][0] += branch[jindexer].YSfrom[0];
+										}
+										else									//To branch
+										{
+											tempY[0][0] += branch[jindexer].YSto[0];
+										}
+									}//end valid phase A
+									break;
+								}
+							case 0x05:	//A & C
+								{
+									phase_worka = branch[jindexer].phases & 0x05;	//Extract phases
+
+									if (phase_worka == 0x05)	//Both A & C valid
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[0][0] += branch[jindexer].YSfrom[0];
+											tempY[0][1] += branch[jindexer].YSfrom[2];
+											tempY[1][0] += branch[jindexer].YSfrom[6];
+											tempY[1][1] += branch[jindexer].YSfrom[8];
+										}
+										else									//To branch
+										{
+											tempY[0][0] += branch[jindexer].YSto[0];
+											tempY[0][1] += branch[jindexer].YSto[2];
+											tempY[1][0] += branch[jindexer].YSto[6];
+											tempY[1][1] += branch[jindexer].YSto[8];
+										}
+									}//End A & C valid
+									else if (phase_worka == 0x04)	//Only A valid
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[0][0] += branch[jindexer].YSfrom[0];
+										}
+										else									//To branch
+										{
+											tempY[0][0] += branch[jindexer].YSto[0];
+										}
+									}//end only A valid
+									else if (phase_worka == 0x01)	//Only C valid
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[1][1] += branch[jindexer].YSfrom[8];
+										}
+										else									//To branch
+										{
+											tempY[1][1] += branch[jindexer].YSto[8];
+										}
+									}//end only C valid
+									else	//No connection - must be faulted
+										;
+									break;
+								}
+							case 0x06:	//A & B
+								{
+									phase_worka = branch[jindexer].phases & 0x06;	//Extract phases
+
+									if (phase_worka == 0x06)	//Valid A & B phase
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[0][0] += branch[jindexer].YSfrom[0];
+											tempY[0][1] += branch[jindexer].YSfrom[1];
+											tempY[1][0] += branch[jindexer].YSfrom[3];
+											tempY[1][1] += branch[jindexer].YSfrom[4];
+										}
+										else									//To branch
+										{
+											tempY[0][0] += branch[jindexer].YSto[0];
+											tempY[0][1] += branch[jindexer].YSto[1];
+											tempY[1][0] += branch[jindexer].YSto[3];
+											tempY[1][1] += branch[jindexer].YSto[4];
+										}
+									}//End valid A & B
+									else if (phase_worka == 0x04)	//Only valid A
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[0][0] += branch[jindexer].YSfrom[0];
+										}
+										else									//To branch
+										{
+											tempY[0][0] += branch[jindexer].YSto[0];
+										}
+									}//end valid A
+									else if (phase_worka == 0x02)	//Only valid B
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[1][1] += branch[jindexer].YSfrom[4];
+										}
+										else									//To branch
+										{
+											tempY[1][1] += branch[jindexer].YSto[4];
+										}
+									}//end valid B
+									else	//Default - must be already handled
+										;
+									break;
+								}
+							default:	//How'd we get here?
+								{
+									GL_THROW("Unknown phase connection in NR self admittance diagonal");
+									/*  TROUBLESHOOT
+									An unknown phase condition was encountered in the NR solver when constructing
+									the self admittance diagonal.  Please report this bug and submit your code to 
+									the trac system.
+									*/
+								break;
+								}
+						}	//switch end
+					}	//1 or 2 phase end
+				}	//phase accumulation end
+				else		//It's nothing (no connnection)
+					;
+			}//branch traversion end
+
+			//Store the self admittance into BA_diag.  Also update the indices for possible use later
+			powerflow_values->BA_diag[indexer].col_ind = powerflow_values->BA_diag[indexer].row_ind = index_count;	// Store the row and column starting information (square matrices)
+			bus[indexer].Matrix_Loc = index_count;								//Store our location so we know where we go
+			index_count += powerflow_values->BA_diag[indexer].size;				// Update the index for this matrix's size, so next one is in appropriate place
+
+
+			//Store the admittance values into the BA_diag matrix structure
+			for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
+			{
+				for (kindex=0; kindex<powerflow_values->BA_diag[indexer].size; kindex++)			//Store values - assume square matrix - don't bother parsing what doesn't exist.
 				{
-					adjusted_constant_current[0] = bus[indexer].I[0];
-					adjusted_constant_current[1] = bus[indexer].I[1];
-					adjusted_constant_current[2] = bus[indexer].I[2];
+					powerflow_values->BA_diag[indexer].Y[jindex][kindex] = tempY[jindex][kindex];// Store the self admittance terms.
+				}
+			}
 
-					//See if we have different children too
-					if ((bus[indexer].phases & 0x10) == 0x10)
-					{
-						//Store them too
-						adjusted_constant_current[3] = bus[indexer].extra_var[6];
-						adjusted_constant_current[4] = bus[indexer].extra_var[7];
-						adjusted_constant_current[5] = bus[indexer].extra_var[8];
-					}
-					else	//Nope, just zero this for now
+			//Copy values into node-specific link (if needed)
+			if (bus[indexer].full_Y_all != NULL)
+			{
+				for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
+				{
+					for (kindex=0; kindex<powerflow_values->BA_diag[indexer].size; kindex++)			//Store values - assume square matrix - don't bother parsing what doesn't exist.
 					{
-						adjusted_constant_current[3] = 0.0;
-						adjusted_constant_current[4] = 0.0;
-						adjusted_constant_current[5] = 0.0;
+						bus[indexer].full_Y_all[jindex*3+kindex] = tempY[jindex][kindex];// Store the self admittance terms.
 					}
-				}//End adjustment code
-
-				//For Wye-connected, only compute and store phases that exist (make top heavy)
-				temp_index = -1;
-				temp_index_b = -1;
+				}
+			}//End self-admittance update
+		}//End diagonal construction
 
-				if ((bus[indexer].phases & 0x10) == 0x10)	//"Different" child load - in this case it must be delta - also must be three phase (just because that's how I forced it to be implemented)
-				{											//Calculate all the deltas to wyes in advance (otherwise they'll get repeated)
-					//Delta voltages
-					voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
-					voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
-					voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
+		//Store the size of the diagonal, since it represents how many variables we are solving (useful later)
+		powerflow_values->total_variables=index_count;
 
-					//Make sure phase combinations exist
-					if ((bus[indexer].phases & 0x06) == 0x06)	//Has A-B
-					{
-						//Power - put into a current value (iterates less this way)
-						delta_current[0] = (voltageDel[0] == 0) ? 0 : ~(bus[indexer].extra_var[0]/voltageDel[0]);
+		//Check to see if we've exceeded our max.  If so, reallocate!
+		if (powerflow_values->total_variables > powerflow_values->max_total_variables)
+			powerflow_values->NR_realloc_needed = true;
 
-						//Convert delta connected load to appropriate Wye 
-						delta_current[0] += voltageDel[0] * (bus[indexer].extra_var[3]);
-					}
-					else
-					{
-						//Zero it, for good measure
-						delta_current[0] = 0.0;
-					}
+		/// Build the off_diagonal_PQ bus elements of 6n*6n Y_NR matrix.Equation (12). All the value in this part will not be updated at each iteration.
+		//Constructed using sparse methodology, non-zero elements are the only thing considered (and non-PV)
+		//No longer necessarily 6n*6n any more either,
+		powerflow_values->size_offdiag_PQ = 0;
+		for (jindexer=0; jindexer<branch_count;jindexer++)	//Parse all of the branches
+		{
+			tempa  = branch[jindexer].from;
+			tempb  = branch[jindexer].to;
 
-					//Check for BC
-					if ((bus[indexer].phases & 0x03) == 0x03)	//Has B-C
-					{
-						//Power - put into a current value (iterates less this way)
-						delta_current[1] = (voltageDel[1] == 0) ? 0 : ~(bus[indexer].extra_var[1]/voltageDel[1]);
+			//Preliminary check to make sure we weren't missed in the initialization
+			if ((bus[tempa].Matrix_Loc == -1) || (bus[tempb].Matrix_Loc == -1))
+			{
+				GL_THROW("An element in NR line:%d was not properly localized");
+				/*  TROUBLESHOOT
+				When parsing the bus list, the Newton-Raphson solver found a bus that did not
+				appear to have a location within the overall admittance/Jacobian matrix.  Please
+				submit this as a bug with your code on the Trac site.
+				*/
+			}
 
-						//Convert delta connected load to appropriate Wye 
-						delta_current[1] += voltageDel[1] * (bus[indexer].extra_var[4]);
-					}
-					else
+			if (((branch[jindexer].phases & 0x80) == 0x80) && (branch[jindexer].v_ratio==1.0))	//Triplex, but not SPCT
+			{
+				for (jindex=0; jindex<2; jindex++)			//rows
+				{
+					for (kindex=0; kindex<2; kindex++)		//columns
 					{
-						//Zero it, for good measure
-						delta_current[1] = 0.0;
-					}
+						if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))
+							powerflow_values->size_offdiag_PQ += 1; 
 
-					//Check for CA
-					if ((bus[indexer].phases & 0x05) == 0x05)	//Has C-A
-					{
-						//Power - put into a current value (iterates less this way)
-						delta_current[2] = (voltageDel[2] == 0) ? 0 : ~(bus[indexer].extra_var[2]/voltageDel[2]);
+						if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))  
+							powerflow_values->size_offdiag_PQ += 1; 
 
-						//Convert delta connected load to appropriate Wye 
-						delta_current[2] += voltageDel[2] * (bus[indexer].extra_var[5]);
-					}
-					else
-					{
-						//Zero it, for good measure
-						delta_current[2] = 0.0;
-					}
+						if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
+							powerflow_values->size_offdiag_PQ += 1; 
 
-					//Convert delta-current into a phase current - reuse temp variable
-					undeltacurr[0]=(adjusted_constant_current[3]+delta_current[0])-(adjusted_constant_current[5]+delta_current[2]);
-					undeltacurr[1]=(adjusted_constant_current[4]+delta_current[1])-(adjusted_constant_current[3]+delta_current[0]);
-					undeltacurr[2]=(adjusted_constant_current[5]+delta_current[2])-(adjusted_constant_current[4]+delta_current[1]);
-				}
-				else	//zero the variable so we don't have excessive ifs
+						if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
+							powerflow_values->size_offdiag_PQ += 1; 
+					}//end columns of split phase
+				}//end rows of split phase
+			}//end traversion of split-phase
+			else											//Three phase or some variety
+			{
+				//Make sure we aren't SPCT, otherwise things get jacked
+				if ((branch[jindexer].phases & 0x80) != 0x80)	//SPCT, but v_ratio not = 1
 				{
-					undeltacurr[0] = undeltacurr[1] = undeltacurr[2] = 0.0;	//Zero it
-				}
+					for (jindex=0; jindex<3; jindex++)			//rows
+					{
+						//See if this phase is valid
+						phase_workb = 0x04 >> jindex;
 
-				for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
-				{
-					switch(bus[indexer].phases & 0x07) {
-						case 0x01:	//C
-							{
-								temp_index=0;
-								temp_index_b=2;
-								break;
-							}
-						case 0x02:	//B
-							{
-								temp_index=0;
-								temp_index_b=1;
-								break;
-							}
-						case 0x03:	//BC
-							{
-								if (jindex==0)	//B
-								{
-									temp_index=0;
-									temp_index_b=1;
-								}
-								else			//C
-								{
-									temp_index=1;
-									temp_index_b=2;
-								}
-								break;
-							}
-						case 0x04:	//A
-							{
-								temp_index=0;
-								temp_index_b=0;
-								break;
-							}
-						case 0x05:	//AC
+						if ((phase_workb & branch[jindexer].phases) == phase_workb)	//Row check
+						{
+							for (kindex=0; kindex<3; kindex++)		//columns
 							{
-								if (jindex==0)	//A
-								{
-									temp_index=0;
-									temp_index_b=0;
-								}
-								else			//C
+								//Check this phase as well
+								phase_workd = 0x04 >> kindex;
+
+								if ((phase_workd & branch[jindexer].phases) == phase_workd)	//Column validity check
 								{
-									temp_index=1;
-									temp_index_b=2;
-								}
-								break;
-							}
-						case 0x06:	//AB
-						case 0x07:	//ABC
-							{
-								temp_index=jindex;
-								temp_index_b=jindex;
-								break;
-							}
-						default:
-							break;
-					}//end case
+									if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))
+										powerflow_values->size_offdiag_PQ += 1; 
 
-					if ((temp_index==-1) || (temp_index_b==-1))
+									if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))  
+										powerflow_values->size_offdiag_PQ += 1; 
+
+									if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
+										powerflow_values->size_offdiag_PQ += 1; 
+
+									if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
+										powerflow_values->size_offdiag_PQ += 1; 
+								}//end column validity check
+							}//end columns of 3 phase
+						}//End row validity check
+					}//end rows of 3 phase
+				}//end not SPCT
+				else	//SPCT inmplementation
+				{
+					for (jindex=0; jindex<3; jindex++)			//rows
 					{
-						GL_THROW("NR: A scheduled power update element failed.");
-						/*  TROUBLESHOOT
-						While attempting to calculate the scheduled portions of the
-						attached loads, an update failed to process correctly.
-						Submit you code and a bug report using the trac website.
-						*/
-					}
+						//See if this phase is valid
+						phase_workb = 0x04 >> jindex;
 
-					//Perform the power calculation
-					tempPbus = (bus[indexer].S[temp_index_b]).Re();									// Real power portion of constant power portion
-					tempPbus += (adjusted_constant_current[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Re() + (adjusted_constant_current[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Im();	// Real power portion of Constant current component multiply the magnitude of bus voltage
-					tempPbus += (undeltacurr[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Re() + (undeltacurr[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Im();	// Real power portion of Constant current from "different" children
-					tempPbus += (bus[indexer].Y[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Re() + (bus[indexer].Y[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Im();	// Real power portion of Constant impedance component multiply the square of the magnitude of bus voltage
-					bus[indexer].PL[temp_index] = tempPbus;	//Real power portion
-					
-					
-					tempQbus = (bus[indexer].S[temp_index_b]).Im();									// Reactive power portion of constant power portion
-					tempQbus += (adjusted_constant_current[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Im() - (adjusted_constant_current[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Re();	// Reactive power portion of Constant current component multiply the magnitude of bus voltage
-					tempQbus += (undeltacurr[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Im() - (undeltacurr[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Re();	// Reactive power portion of Constant current from "different" children
-					tempQbus += -(bus[indexer].Y[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Im() - (bus[indexer].Y[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Re();	// Reactive power portion of Constant impedance component multiply the square of the magnitude of bus voltage				
-					bus[indexer].QL[temp_index] = tempQbus;	//Reactive power portion  
+						if ((phase_workb & branch[jindexer].phases) == phase_workb)	//Row check
+						{
+							for (kindex=0; kindex<3; kindex++)		//Row valid, traverse all columns for SPCT Yfrom
+							{
+								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))
+									powerflow_values->size_offdiag_PQ += 1; 
 
-				}//end phase traversion
-			}//end wye-connected
+								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
+									powerflow_values->size_offdiag_PQ += 1; 
+							}//end columns traverse
 
-			//Perform explicit delta/wye load accumulation - do if not triplex
-			if ((bus[indexer].phases & 0x80) != 0x80)
-			{
-				//Delta components - populate according to what is there
-				if ((bus[indexer].phases & 0x06) == 0x06)	//Check for AB
-				{
-					//Voltage calculations
-					voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
+							//If row is valid, now traverse the rows of that column for Yto
+							for (kindex=0; kindex<3; kindex++)
+							{
+								if (((branch[jindexer].Yto[kindex*3+jindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))  
+									powerflow_values->size_offdiag_PQ += 1; 
 
-					//Power - convert to a current (uses less iterations this way)
-					delta_current[0] = (voltageDel[0] == 0) ? 0 : ~(bus[indexer].S_dy[0]/voltageDel[0]);
+								if (((branch[jindexer].Yto[kindex*3+jindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
+									powerflow_values->size_offdiag_PQ += 1; 
+							}//end rows traverse
+						}//End row validity check
+					}//end rows of 3 phase
+				}//End SPCT
+			}//end three phase
+		}//end line traversion
 
-					//Convert delta connected load to appropriate Wye
-					delta_current[0] += voltageDel[0] * (bus[indexer].Y_dy[0]);
+		//Allocate the space - double the number found (each element goes in two places)
+		if (powerflow_values->Y_offdiag_PQ == NULL)
+		{
+			powerflow_values->Y_offdiag_PQ = (Y_NR *)gl_malloc((powerflow_values->size_offdiag_PQ*2) *sizeof(Y_NR));   //powerflow_values->Y_offdiag_PQ store the row,column and value of off_diagonal elements of Bus Admittance matrix in which all the buses are not PV buses. 
 
-				}
-				else
-				{
-					//Zero values - they shouldn't be used anyhow
-					voltageDel[0] = 0.0;
-					delta_current[0] = 0.0;
-				}
+			//Make sure it worked
+			if (powerflow_values->Y_offdiag_PQ == NULL)
+				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
 
-				if ((bus[indexer].phases & 0x03) == 0x03)	//Check for BC
-				{
-					//Voltage calculations
-					voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
+			//Save our size
+			powerflow_values->max_size_offdiag_PQ = powerflow_values->size_offdiag_PQ;	//Don't care about the 2x, since we'll be comparing it against itself
+		}
+		else if (powerflow_values->size_offdiag_PQ > powerflow_values->max_size_offdiag_PQ)	//Something changed and we are bigger!!
+		{
+			//Destroy us!
+			gl_free(powerflow_values->Y_offdiag_PQ);
 
-					//Power - convert to a current (uses less iterations this way)
-					delta_current[1] = (voltageDel[1] == 0) ? 0 : ~(bus[indexer].S_dy[1]/voltageDel[1]);
+			//Rebuild us, we have the technology
+			powerflow_values->Y_offdiag_PQ = (Y_NR *)gl_malloc((powerflow_values->size_offdiag_PQ*2) *sizeof(Y_NR));
 
-					//Convert delta connected load to appropriate Wye
-					delta_current[1] += voltageDel[1] * (bus[indexer].Y_dy[1]);
+			//Make sure it worked
+			if (powerflow_values->Y_offdiag_PQ == NULL)
+				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
 
-				}
-				else
-				{
-					//Zero unused
-					voltageDel[1] = 0.0;
-					delta_current[1] = 0.0;
-				}
+			//Store the new size
+			powerflow_values->max_size_offdiag_PQ = powerflow_values->size_offdiag_PQ;
 
-				if ((bus[indexer].phases & 0x05) == 0x05)	//Check for CA
-				{
-					//Voltage calculations
-					voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
+			//Flag for a reallocation
+			powerflow_values->NR_realloc_needed = true;
+		}
 
-					//Power - convert to a current (uses less iterations this way)
-					delta_current[2] = (voltageDel[2] == 0) ? 0 : ~(bus[indexer].S_dy[2]/voltageDel[2]);
+		indexer = 0;
+		for (jindexer=0; jindexer<branch_count;jindexer++)	//Parse through all of the branches
+		{
+			//Extract both ends
+			tempa  = branch[jindexer].from;
+			tempb  = branch[jindexer].to;
 
-					//Convert delta connected load to appropriate Wye
-					delta_current[2] += voltageDel[2] * (bus[indexer].Y_dy[2]);
+			phase_worka = 0;
+			phase_workb = 0;
+			for (jindex=0; jindex<3; jindex++)		//Accumulate number of phases
+			{
+				phase_worka += ((bus[tempa].phases & (0x01 << jindex)) >> jindex);
+				phase_workb += ((bus[tempb].phases & (0x01 << jindex)) >> jindex);
+			}
 
-				}
-				else
-				{
-					//Zero unused
-					voltageDel[2] = 0.0;
-					delta_current[2] = 0.0;
-				}
-				
-				//Populate the values for constant current -- deltamode different right now (all same in future?)
-				if (*bus[indexer].dynamics_enabled == true)
+			if ((phase_worka==3) && (phase_workb==3))	//Both ends are full three phase, normal operations
+			{
+				for (jindex=0; jindex<3; jindex++)		//Loop through rows of admittance matrices				
 				{
-					//Create line-line nominal magnitude
-					adjust_nominal_voltage_val = bus[indexer].volt_base;
-					adjust_nominal_voltaged_val = bus[indexer].volt_base * sqrt(3.0);
+					//See if this row is valid for this branch
+					phase_workd = 0x04 >> jindex;
 
-					//Create the nominal voltage vectors
-					adjust_temp_nominal_voltage[0].SetPolar(adjust_nominal_voltaged_val,PI/6.0);
-					adjust_temp_nominal_voltage[1].SetPolar(adjust_nominal_voltaged_val,-1.0*PI/2.0);
-					adjust_temp_nominal_voltage[2].SetPolar(adjust_nominal_voltaged_val,5.0*PI/6.0);
-					adjust_temp_nominal_voltage[3].SetPolar(adjust_nominal_voltage_val,0.0);
-					adjust_temp_nominal_voltage[4].SetPolar(adjust_nominal_voltage_val,-2.0*PI/3.0);
-					adjust_temp_nominal_voltage[5].SetPolar(adjust_nominal_voltage_val,2.0*PI/3.0);
+					if ((branch[jindexer].phases & phase_workd) == phase_workd)	//Validity check
+					{
+						for (kindex=0; kindex<3; kindex++)	//Loop through columns of admittance matrices
+						{
+							//Extract column information
+							phase_worke = 0x04 >> kindex;
 
-					//Compute delta voltages
-					voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
-					voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
-					voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
+							if ((branch[jindexer].phases & phase_worke) == phase_worke)	//Valid column too!
+							{
+								//Indices counted out from Self admittance above.  needs doubling due to complex separation
+								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
+								{
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
+									indexer += 1;
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 3;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 3;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
+									indexer += 1;
+								}
 
-					//Get magnitudes of all
-					adjust_temp_voltage_mag[0] = voltageDel[0].Mag();
-					adjust_temp_voltage_mag[1] = voltageDel[1].Mag();
-					adjust_temp_voltage_mag[2] = voltageDel[2].Mag();
-					adjust_temp_voltage_mag[3] = bus[indexer].V[0].Mag();
-					adjust_temp_voltage_mag[4] = bus[indexer].V[1].Mag();
-					adjust_temp_voltage_mag[5] = bus[indexer].V[2].Mag();
+								if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
+								{
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Im());
+									indexer += 1;
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 3;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 3;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yto[jindex*3+kindex]).Im();
+									indexer += 1;
+								}
 
-					//Start adjustments - A
-					if ((bus[indexer].I_dy[3] != 0.0) && (adjust_temp_voltage_mag[3] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[3] = ~(adjust_temp_nominal_voltage[3] * ~bus[indexer].I_dy[3] * adjust_temp_voltage_mag[3] / (bus[indexer].V[0] * adjust_nominal_voltage_val));
-					}
-					else
-					{
-						adjusted_constant_current[3] = 0.0;
-					}
+								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
+								{
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 3;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									indexer += 1;
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 3;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									indexer += 1;	
+								}
 
-					//Start adjustments - B
-					if ((bus[indexer].I_dy[4] != 0.0) && (adjust_temp_voltage_mag[4] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[4] = ~(adjust_temp_nominal_voltage[4] * ~bus[indexer].I_dy[4] * adjust_temp_voltage_mag[4] / (bus[indexer].V[1] * adjust_nominal_voltage_val));
-					}
-					else
+								if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
+								{
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 3;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									indexer += 1;
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 3;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									indexer += 1;	
+								}
+							}//End valid column
+						}//column end
+					}//End valid row
+				}//row end
+			}//if all 3 end
+			else if (((bus[tempa].phases & 0x80) == 0x80) || ((bus[tempb].phases & 0x80) == 0x80))	//Someone's a triplex
+			{
+				if (((bus[tempa].phases & 0x80) == 0x80) && ((bus[tempb].phases & 0x80) == 0x80))	//Both are triplex, easy case
+				{
+					for (jindex=0; jindex<2; jindex++)		//Loop through rows of admittance matrices (only 2x2)
 					{
-						adjusted_constant_current[4] = 0.0;
-					}
+						for (kindex=0; kindex<2; kindex++)	//Loop through columns of admittance matrices (only 2x2)
+						{
+							//Make sure one end of us isn't a SPCT transformer To node (they are different)
+							if (((bus[tempa].phases & 0x20) & (bus[tempb].phases & 0x20)) == 0x20)	//Both ends are SPCT tos
+							{
+								GL_THROW("NR: SPCT to SPCT via triplex connections are unsupported at this time.");
+								/*  TROUBLESHOOT
+								The Newton-Raphson solve does not currently support running a triplex line between the low-voltage
+								side of two different split-phase center tapped transformers.  This functionality may be added if needed
+								in the future.
+								*/
+							}//end both ends SPCT to
+							else if ((bus[tempa].phases & 0x20) == 0x20)	//From end is a SPCT to
+							{
+								//Indices counted out from Self admittance above.  needs doubling due to complex separation
 
-					//Start adjustments - C
-					if ((bus[indexer].I_dy[5] != 0.0) && (adjust_temp_voltage_mag[5] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[5] = ~(adjust_temp_nominal_voltage[5] * ~bus[indexer].I_dy[5] * adjust_temp_voltage_mag[5] / (bus[indexer].V[2] * adjust_nominal_voltage_val));
-					}
-					else
-					{
-						adjusted_constant_current[5] = 0.0;
-					}
+								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
+								{
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = ((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
+									indexer += 1;
+									
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(branch[jindexer].Yfrom[jindex*3+kindex]).Im();
+									indexer += 1;
+								}
 
-					//Start adjustments - AB
-					if ((bus[indexer].I_dy[0] != 0.0) && (adjust_temp_voltage_mag[0] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[0] = ~(adjust_temp_nominal_voltage[0] * ~bus[indexer].I_dy[0] * adjust_temp_voltage_mag[0] / (voltageDel[0] * adjust_nominal_voltaged_val));
-					}
-					else
-					{
-						adjusted_constant_current[0] = 0.0;
-					}
+								if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
+								{
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Im());
+									indexer += 1;
+									
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yto[jindex*3+kindex]).Im();
+									indexer += 1;
+								}
 
-					//Start adjustments - BC
-					if ((bus[indexer].I_dy[1] != 0.0) && (adjust_temp_voltage_mag[1] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[1] = ~(adjust_temp_nominal_voltage[1] * ~bus[indexer].I_dy[1] * adjust_temp_voltage_mag[1] / (voltageDel[1] * adjust_nominal_voltaged_val));
-					}
-					else
-					{
-						adjusted_constant_current[1] = 0.0;
-					}
+								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
+								{
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = ((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									indexer += 1;
+									
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = ((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									indexer += 1;	
+								}
 
-					//Start adjustments - CA
-					if ((bus[indexer].I_dy[2] != 0.0) && (adjust_temp_voltage_mag[2] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[2] = ~(adjust_temp_nominal_voltage[2] * ~bus[indexer].I_dy[2] * adjust_temp_voltage_mag[2] / (voltageDel[2] * adjust_nominal_voltaged_val));
-					}
-					else
-					{
-						adjusted_constant_current[2] = 0.0;
-					}
-				}//End deltamode adjustment
-				else	//Normal mode
-				{
-					//Just copy the values in
-					adjusted_constant_current[0] = bus[indexer].I_dy[0];
-					adjusted_constant_current[1] = bus[indexer].I_dy[1];
-					adjusted_constant_current[2] = bus[indexer].I_dy[2];
-					adjusted_constant_current[3] = bus[indexer].I_dy[3];
-					adjusted_constant_current[4] = bus[indexer].I_dy[4];
-					adjusted_constant_current[5] = bus[indexer].I_dy[5];
-				}
+								if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1 && bus[tempb].type != 1))	//To reals
+								{
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									indexer += 1;
+									
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									indexer += 1;	
+								}
+							}//end From end SPCT to
+							else if ((bus[tempb].phases & 0x20) == 0x20)	//To end is a SPCT to
+							{
+								//Indices counted out from Self admittance above.  needs doubling due to complex separation
 
-				//Convert delta-current into a phase current, where appropriate - reuse temp variable
-				//Everything will be accumulated into the "current" field for ease (including differents)
-				//Also handle wye currents in here (was a differently connected child code before)
-				if ((bus[indexer].phases & 0x04) == 0x04)	//Has a phase A
-				{
-					undeltacurr[0]=(adjusted_constant_current[0]+delta_current[0])-(adjusted_constant_current[2]+delta_current[2]);
+								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
+								{
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
+									indexer += 1;
+									
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
+									indexer += 1;
+								}
 
-					//Power values
-					undeltacurr[0] += (bus[indexer].V[0] == 0) ? 0 : ~(bus[indexer].S_dy[3]/bus[indexer].V[0]);
+								if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
+								{
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Im());
+									indexer += 1;
+									
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(branch[jindexer].Yto[jindex*3+kindex]).Im();
+									indexer += 1;
+								}
 
-					//Shunt values
-					undeltacurr[0] += bus[indexer].Y_dy[3]*bus[indexer].V[0];
+								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
+								{
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									indexer += 1;
+									
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									indexer += 1;	
+								}
 
-					//Current values
-					undeltacurr[0] += adjusted_constant_current[3];
-				}
-				else
-				{
-					//Zero it, just in case
-					undeltacurr[0] = 0.0;
-				}
+								if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1 && bus[tempb].type != 1))	//To reals
+								{
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									indexer += 1;
+									
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									indexer += 1;	
+								}
+							}//end To end SPCT to
+							else											//Plain old ugly line
+							{
+								//Indices counted out from Self admittance above.  needs doubling due to complex separation
 
-				if ((bus[indexer].phases & 0x02) == 0x02)	//Has a phase B
-				{
-					undeltacurr[1]=(adjusted_constant_current[1]+delta_current[1])-(adjusted_constant_current[0]+delta_current[0]);
+								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
+								{
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
+									indexer += 1;
+									
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
+									indexer += 1;
+								}
 
-					//Power values
-					undeltacurr[1] += (bus[indexer].V[1] == 0) ? 0 : ~(bus[indexer].S_dy[4]/bus[indexer].V[1]);
+								if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
+								{
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Im());
+									indexer += 1;
+									
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yto[jindex*3+kindex]).Im();
+									indexer += 1;
+								}
 
-					//Shunt values
-					undeltacurr[1] += bus[indexer].Y_dy[4]*bus[indexer].V[1];
+								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
+								{
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									indexer += 1;
+									
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									indexer += 1;	
+								}
 
-					//Current values
-					undeltacurr[1] += adjusted_constant_current[4];
-				}
-				else
+								if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1 && bus[tempb].type != 1))	//To reals
+								{
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									indexer += 1;
+									
+									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
+									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									indexer += 1;	
+								}
+							}//end Normal triplex branch
+						}//column end
+					}//row end
+				}//end both triplexy
+				else if ((bus[tempa].phases & 0x80) == 0x80)	//From is the triplex - this implies transformer with or something, we don't support this
 				{
-					//Zero it, just in case
-					undeltacurr[1] = 0.0;
-				}
-
-
-				if ((bus[indexer].phases & 0x01) == 0x01)	//Has a phase C
+					GL_THROW("NR does not support triplex to 3-phase connections.");
+					/*  TROUBLESHOOT
+					The Newton-Raphson solver does not have any implementation elements
+					to support the connection of a split-phase or triplex node to a three-phase
+					node.  The opposite (3-phase to triplex) is available as the split-phase-center-
+					tapped transformer model.  See if that will work for your implementation.
+					*/
+				}//end from triplexy
+				else	//Only option left is the to must be the triplex - implies SPCT xformer - so only one phase on the three-phase side (we just need to figure out where)
 				{
-					undeltacurr[2]=(adjusted_constant_current[2]+delta_current[2])-(adjusted_constant_current[1]+delta_current[1]);
-
-					//Power values
-					undeltacurr[2] += (bus[indexer].V[2] == 0) ? 0 : ~(bus[indexer].S_dy[5]/bus[indexer].V[2]);
-
-					//Shunt values
-					undeltacurr[2] += bus[indexer].Y_dy[5]*bus[indexer].V[2];
+					//Extract the line phase
+					phase_workc = (branch[jindexer].phases & 0x07);
 
-					//Current values
-					undeltacurr[2] += adjusted_constant_current[5];
-				}
-				else
-				{
-					//Zero it, just in case
-					undeltacurr[2] = 0.0;
-				}
+					//Reset temp_index and size, just in case
+					temp_index = -1;
+					temp_size = -1;
 
-				//Provide updates to relevant phases
-				//only compute and store phases that exist (make top heavy)
-				temp_index = -1;
-				temp_index_b = -1;
-				
-				for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
-				{
-					switch(bus[indexer].phases & 0x07) {
+					//Figure out what the offset on the from side is (how many phases and which one we are)
+					switch(bus[tempa].phases & 0x07)
+					{
 						case 0x01:	//C
 							{
-								temp_index=0;
-								temp_index_b=2;
-								break;
-							}
-						case 0x02:	//B
-							{
-								temp_index=0;
-								temp_index_b=1;
-								break;
-							}
-						case 0x03:	//BC
-							{
-								if (jindex==0)	//B
+								temp_size = 1;	//Single phase matrix
+
+								if (phase_workc==0x01)	//Line is phase C
 								{
-									temp_index=0;
-									temp_index_b=1;
+									//Only C in the node, so no offset
+									temp_index = 0;
 								}
-								else			//C
+								else if (phase_workc==0x02)	//Line is phase B
 								{
-									temp_index=1;
-									temp_index_b=2;
+									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+									/*  TROUBLESHOOT
+									A split-phase, center-tapped transformer in the Newton-Raphson solver is somehow attached
+									to a node that is missing the required phase of the transformer.  This should have been caught.
+									Please submit your code and a bug report using the trac website.
+									*/
 								}
+								else					//Has to be phase A
+									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+
 								break;
 							}
-						case 0x04:	//A
+						case 0x02:	//B
 							{
-								temp_index=0;
-								temp_index_b=0;
+								temp_size = 1;	//Single phase matrix
+
+								if (phase_workc==0x01)	//Line is phase C
+									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+								else if (phase_workc==0x02)	//Line is phase B
+								{
+									//Only B in the node, so no offset
+									temp_index = 0;
+								}
+								else					//Has to be phase A
+									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+
 								break;
 							}
-						case 0x05:	//AC
+						case 0x03:	//BC
 							{
-								if (jindex==0)	//A
+								temp_size = 2;	//Two phase matrix
+
+								if (phase_workc==0x01)	//Line is phase C
 								{
-									temp_index=0;
-									temp_index_b=0;
+									//BC in the node, so offset by 1
+									temp_index = 1;
 								}
-								else			//C
+								else if (phase_workc==0x02)	//Line is phase B
 								{
-									temp_index=1;
-									temp_index_b=2;
+									//BC in the node, so offset by 0
+									temp_index = 0;
 								}
-								break;
-							}
-						case 0x06:	//AB
-						case 0x07:	//ABC
-							{
-								temp_index=jindex;
-								temp_index_b=jindex;
-								break;
-							}
-						default:
-							break;
-					}//end case
-
-					if ((temp_index==-1) || (temp_index_b==-1))
-					{
-						GL_THROW("NR: A scheduled power update element failed.");
-						//Defined below
-					}
-
-					//Real power calculations
-					tempPbus = (undeltacurr[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Re() + (undeltacurr[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Im();	// Real power portion of Constant current component multiply the magnitude of bus voltage
-					bus[indexer].PL[temp_index] += tempPbus;	//Real power portion - all is current based -- accumulate in case mixed and matched with old above
-
-					//Reactive load calculations
-					tempQbus = (undeltacurr[temp_index_b]).Re() * (bus[indexer].V[temp_index_b]).Im() - (undeltacurr[temp_index_b]).Im() * (bus[indexer].V[temp_index_b]).Re();	// Reactive power portion of Constant current component multiply the magnitude of bus voltage
-					bus[indexer].QL[temp_index] += tempQbus;	//Reactive power portion - all is current based -- accumulate in case mixed and matched with old above
-						
-				}//End phase traversion
-			}//End delta/wye explicit load update
-		}//end bus traversion for power update
-	
-		// Calculate the mismatch of three phase current injection at each bus (deltaI), 
-		//and store the deltaI in terms of real and reactive value in array powerflow_values->deltaI_NR    
-		if (powerflow_values->deltaI_NR==NULL)
-		{
-			powerflow_values->deltaI_NR = (double *)gl_malloc((2*powerflow_values->total_variables) *sizeof(double));   // left_hand side of equation (11)
-
-			//Make sure it worked
-			if (powerflow_values->deltaI_NR == NULL)
-				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
-
-			//Update the max size
-			powerflow_values->max_total_variables = powerflow_values->total_variables;
-		}
-		else if (powerflow_values->NR_realloc_needed)		//Bigger sized (this was checked above)
-		{
-			//Decimate the existing value
-			gl_free(powerflow_values->deltaI_NR);
-
-			//Reallocate it...bigger...faster...stronger!
-			powerflow_values->deltaI_NR = (double *)gl_malloc((2*powerflow_values->total_variables) *sizeof(double));
-
-			//Make sure it worked
-			if (powerflow_values->deltaI_NR == NULL)
-				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
-
-			//Store the updated value
-			powerflow_values->max_total_variables = powerflow_values->total_variables;
-		}
-
-		//If we're in PF_DYNINIT mode, initialize the balancing convergence
-		if (powerflow_type == PF_DYNINIT)
-		{
-			swing_converged = true;	//init it to yes, fail by exception, not default
-		}
-
-		//Compute the calculated loads (not specified) at each bus
-		for (indexer=0; indexer<bus_count; indexer++) //for specific bus k
-		{
-			//Update for generator symmetry - only in static dynamic mode and when SWING is a SWING
-			if ((powerflow_type == PF_DYNINIT) && (swing_is_a_swing==true))
-			{
-				//Secondary check - see if it is even needed - basically built around 3-phase right now
-				if ((*bus[indexer].dynamics_enabled==true) && (bus[indexer].full_Y != NULL) && (bus[indexer].DynCurrent != NULL))
-				{
-					//Form denominator term of Ii, since it won't change
-					temp_complex_1 = (~bus[indexer].V[0]) + (~bus[indexer].V[1])*avalsq + (~bus[indexer].V[2])*aval;
-					
-					//Form up numerator portion that doesn't change (Q and admittance)
-					//Do in parts, just for readability
-					temp_complex_2 = ~bus[indexer].V[0];	//conj(Va)
-					
-					//Row 1 of admittance mult
-					temp_complex_0 = temp_complex_2*(bus[indexer].full_Y[0]*bus[indexer].V[0] + bus[indexer].full_Y[1]*bus[indexer].V[1] + bus[indexer].full_Y[2]*bus[indexer].V[2]);
-
-					// Row 1 also calculate Sysource ( = v * conj(ysource * v)) to substract from PTsource and obtain Pgen at generator bus 
-					temp_complex_5 = bus[indexer].full_Y[0]*bus[indexer].V[0] + bus[indexer].full_Y[1]*bus[indexer].V[1] + bus[indexer].full_Y[2]*bus[indexer].V[2];
-					temp_complex_4 = ~temp_complex_5;
-					temp_complex_3 = bus[indexer].V[0]*temp_complex_4;
-
-					//conj(Vb)
-					temp_complex_2 = ~bus[indexer].V[1];
-
-					//Row 2 of admittance
-					temp_complex_0 += temp_complex_2*(bus[indexer].full_Y[3]*bus[indexer].V[0] + bus[indexer].full_Y[4]*bus[indexer].V[1] + bus[indexer].full_Y[5]*bus[indexer].V[2]);
-					
-					// Row 2 also calculate Sysource ( = v * conj(ysource * v)) to substract from PTsource and obtain Pgen at generator bus
-					temp_complex_5 = bus[indexer].full_Y[3]*bus[indexer].V[0] + bus[indexer].full_Y[4]*bus[indexer].V[1] + bus[indexer].full_Y[5]*bus[indexer].V[2];
-					temp_complex_4 = ~temp_complex_5;
-					temp_complex_3 += bus[indexer].V[1]*temp_complex_4;
-
-					//conj(Vc)
-					temp_complex_2 = ~bus[indexer].V[2];
-
-					//Row 3 of admittance
-					temp_complex_0 += temp_complex_2*(bus[indexer].full_Y[6]*bus[indexer].V[0] + bus[indexer].full_Y[7]*bus[indexer].V[1] + bus[indexer].full_Y[8]*bus[indexer].V[2]);
-
-					// Row 3 also calculate Sysource ( = v * conj(ysource * v)) to substract from PTsource and obtain Pgen at generator bus
-					temp_complex_5 = bus[indexer].full_Y[6]*bus[indexer].V[0] + bus[indexer].full_Y[7]*bus[indexer].V[1] + bus[indexer].full_Y[8]*bus[indexer].V[2];
-					temp_complex_4 = ~temp_complex_5;
-					temp_complex_3 += bus[indexer].V[2]*temp_complex_4;					
-
-					//numerator done, except PT portion (add in below - SWING bus is different
-
-					//On that note, if we are a SWING, zero our PT portion and QT for accumulation
-					if ((bus[indexer].type == 2) && (Iteration>0))
-					{
-						*bus[indexer].PGenTotal = complex(0.0,0.0);
-					}
-				}
-				else	//Not enabled or not "full-Y-ed" - set to zero
-				{
-					temp_complex_0 = 0.0;
-					temp_complex_1 = 0.0;	//Basically a flag to ignore it
-				}
-			}//End PF_DYNINIT and SWING is still the same
-
-			for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++) // rows - for specific phase that exists
-			{
-				tempIcalcReal = tempIcalcImag = 0;   
-
-				if ((bus[indexer].phases & 0x80) == 0x80)	//Split phase - triplex bus
-				{
-					//Two states of triplex bus - To node of SPCT transformer needs to be different
-					//First different - Delta-I and diagonal contributions
-					if ((bus[indexer].phases & 0x20) == 0x20)	//We're the To bus
-					{
-						//Pre-negated due to the nature of how it's calculated (V1 compared to I1)
-						tempPbus =  bus[indexer].PL[jindex];	//Copy load amounts in
-						tempQbus =  bus[indexer].QL[jindex];	
-					}
-					else	//We're just a normal triplex bus
-					{
-						//This one isn't negated (normal operations)
-						tempPbus =  -bus[indexer].PL[jindex];	//Copy load amounts in
-						tempQbus =  -bus[indexer].QL[jindex];	
-					}//end normal triplex bus
-
-					//Get diagonal contributions - only (& always) 2
-					//Column 1
-					tempIcalcReal += (powerflow_values->BA_diag[indexer].Y[jindex][0]).Re() * (bus[indexer].V[0]).Re() - (powerflow_values->BA_diag[indexer].Y[jindex][0]).Im() * (bus[indexer].V[0]).Im();// equation (7), the diag elements of bus admittance matrix 
-					tempIcalcImag += (powerflow_values->BA_diag[indexer].Y[jindex][0]).Re() * (bus[indexer].V[0]).Im() + (powerflow_values->BA_diag[indexer].Y[jindex][0]).Im() * (bus[indexer].V[0]).Re();// equation (8), the diag elements of bus admittance matrix 
-
-					//Column 2
-					tempIcalcReal += (powerflow_values->BA_diag[indexer].Y[jindex][1]).Re() * (bus[indexer].V[1]).Re() - (powerflow_values->BA_diag[indexer].Y[jindex][1]).Im() * (bus[indexer].V[1]).Im();// equation (7), the diag elements of bus admittance matrix 
-					tempIcalcImag += (powerflow_values->BA_diag[indexer].Y[jindex][1]).Re() * (bus[indexer].V[1]).Im() + (powerflow_values->BA_diag[indexer].Y[jindex][1]).Im() * (bus[indexer].V[1]).Re();// equation (8), the diag elements of bus admittance matrix 
-
-					//Now off diagonals
-					for (kindexer=0; kindexer<(bus[indexer].Link_Table_Size); kindexer++)
-					{
-						//Apply proper index to jindexer (easier to implement this way)
-						jindexer=bus[indexer].Link_Table[kindexer];
-
-						if (branch[jindexer].from == indexer)	//We're the from bus
-						{
-							if ((bus[indexer].phases & 0x20) == 0x20)	//SPCT from bus - needs different signage
-							{
-								work_vals_char_0 = jindex*3;
-
-								//This situation can only be a normal line (triplex will never be the from for another type)
-								//Again only, & always 2 columns (just do them explicitly)
-								//Column 1
-								tempIcalcReal += ((branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Re() - ((branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-								tempIcalcImag += ((branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Im() + ((branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-
-								//Column2
-								tempIcalcReal += ((branch[jindexer].Yfrom[jindex*3+1])).Re() * (bus[branch[jindexer].to].V[1]).Re() - ((branch[jindexer].Yfrom[jindex*3+1])).Im() * (bus[branch[jindexer].to].V[1]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-								tempIcalcImag += ((branch[jindexer].Yfrom[jindex*3+1])).Re() * (bus[branch[jindexer].to].V[1]).Im() + ((branch[jindexer].Yfrom[jindex*3+1])).Im() * (bus[branch[jindexer].to].V[1]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+								else					//Has to be phase A
+									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
 
-							}//End SPCT To bus - from diagonal contributions
-							else		//Normal line connection to normal triplex
+								break;
+							}
+						case 0x04:	//A
 							{
-								work_vals_char_0 = jindex*3;
-								//This situation can only be a normal line (triplex will never be the from for another type)
-								//Again only, & always 2 columns (just do them explicitly)
-								//Column 1
-								tempIcalcReal += (-(branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Re() - (-(branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-								tempIcalcImag += (-(branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Im() + (-(branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+								temp_size = 1;	//Single phase matrix
 
-								//Column2
-								tempIcalcReal += (-(branch[jindexer].Yfrom[jindex*3+1])).Re() * (bus[branch[jindexer].to].V[1]).Re() - (-(branch[jindexer].Yfrom[jindex*3+1])).Im() * (bus[branch[jindexer].to].V[1]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-								tempIcalcImag += (-(branch[jindexer].Yfrom[jindex*3+1])).Re() * (bus[branch[jindexer].to].V[1]).Im() + (-(branch[jindexer].Yfrom[jindex*3+1])).Im() * (bus[branch[jindexer].to].V[1]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+								if (phase_workc==0x01)	//Line is phase C
+									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+								else if (phase_workc==0x02)	//Line is phase B
+									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+								else					//Has to be phase A
+								{
+									//Only A in the node, so no offset
+									temp_index = 0;
+								}
 
-							}//end normal triplex from
-						}//end from bus
-						else if (branch[jindexer].to == indexer)	//We're the to bus
-						{
-							if (branch[jindexer].v_ratio != 1.0)	//Transformer
+								break;
+							}
+						case 0x05:	//AC
 							{
-								//Only a single contributor on the from side - figure out how to get to it
-								if ((branch[jindexer].phases & 0x01) == 0x01)	//C
+								temp_size = 2;	//Two phase matrix
+
+								if (phase_workc==0x01)	//Line is phase C
 								{
-									temp_index=2;
+									//AC in the node, so offset by 1
+									temp_index = 1;
 								}
-								else if ((branch[jindexer].phases & 0x02) == 0x02)	//B
+								else if (phase_workc==0x02)	//Line is phase B
+									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+								else					//Has to be phase A
 								{
-									temp_index=1;
+									//AC in the node, so offset by 0
+									temp_index = 0;
 								}
-								else if ((branch[jindexer].phases & 0x04) == 0x04)	//A
+
+								break;
+							}
+						case 0x06:	//AB
+							{
+								temp_size = 2;	//Two phase matrix
+
+								if (phase_workc==0x01)	//Line is phase C
+									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+								else if (phase_workc==0x02)	//Line is phase B
 								{
-									temp_index=0;
+									//BC in the node, so offset by 1
+									temp_index = 1;
 								}
-								else	//How'd we get here!?!
+								else					//Has to be phase A
 								{
-									GL_THROW("NR: A split-phase transformer appears to have an invalid phase");
+									//AB in the node, so offset by 0
+									temp_index = 0;
 								}
 
-								work_vals_char_0 = jindex*3+temp_index;
-
-								//Perform the update, it only happens for one column (nature of the transformer)
-								tempIcalcReal += (-(branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[temp_index]).Re() - (-(branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[temp_index]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-								tempIcalcImag += (-(branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[temp_index]).Im() + (-(branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[temp_index]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-
-							}//end transformer
-							else									//Must be a normal line then
+								break;
+							}
+						case 0x07:	//ABC
 							{
-								if ((bus[indexer].phases & 0x20) == 0x20)	//SPCT from bus - needs different signage
+								temp_size = 3;	//Three phase matrix
+
+								if (phase_workc==0x01)	//Line is phase C
+								{
+									//ABC in the node, so offset by 2
+									temp_index = 2;
+								}
+								else if (phase_workc==0x02)	//Line is phase B
 								{
-									work_vals_char_0 = jindex*3;
-									//This case should never really exist, but if someone reverses a secondary or is doing meshed secondaries, it might
-									//Again only, & always 2 columns (just do them explicitly)
-									//Column 1
-									tempIcalcReal += ((branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[0]).Re() - ((branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[0]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-									tempIcalcImag += ((branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[0]).Im() + ((branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[0]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-
-									//Column2
-									tempIcalcReal += ((branch[jindexer].Yto[work_vals_char_0+1])).Re() * (bus[branch[jindexer].from].V[1]).Re() - ((branch[jindexer].Yto[work_vals_char_0+1])).Im() * (bus[branch[jindexer].from].V[1]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-									tempIcalcImag += ((branch[jindexer].Yto[work_vals_char_0+1])).Re() * (bus[branch[jindexer].from].V[1]).Im() + ((branch[jindexer].Yto[work_vals_char_0+1])).Im() * (bus[branch[jindexer].from].V[1]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-								}//End SPCT To bus - from diagonal contributions
-								else		//Normal line connection to normal triplex
+									//ABC in the node, so offset by 1
+									temp_index = 1;
+								}
+								else					//Has to be phase A
 								{
-									work_vals_char_0 = jindex*3;
-									//Again only, & always 2 columns (just do them explicitly)
-									//Column 1
-									tempIcalcReal += (-(branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[0]).Re() - (-(branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[0]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-									tempIcalcImag += (-(branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[0]).Im() + (-(branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[0]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-
-									//Column2
-									tempIcalcReal += (-(branch[jindexer].Yto[work_vals_char_0+1])).Re() * (bus[branch[jindexer].from].V[1]).Re() - (-(branch[jindexer].Yto[work_vals_char_0+1])).Im() * (bus[branch[jindexer].from].V[1]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-									tempIcalcImag += (-(branch[jindexer].Yto[work_vals_char_0+1])).Re() * (bus[branch[jindexer].from].V[1]).Im() + (-(branch[jindexer].Yto[work_vals_char_0+1])).Im() * (bus[branch[jindexer].from].V[1]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-								}//End normal triplex connection
-							}//end normal line
-						}//end to bus
-						else	//We're nothing
-							;
-
-					}//End branch traversion
-
-					//Determine how we are posting this update
-					if ((bus[indexer].type > 1) && (bus[indexer].swing_functions_enabled == true))	//SWING bus is different (when it really is a SWING bus)
-					{
-						if ((powerflow_type == PF_DYNINIT) && (bus[indexer].full_Y != NULL) && (bus[indexer].DynCurrent != NULL))
-						{
-							//Compute the delta_I, just like below - but don't post it (still zero in calcs)
-							work_vals_double_3 = tempPbus - tempIcalcReal;
-							work_vals_double_4 = tempQbus - tempIcalcImag;
+									//ABC in the node, so offset by 0
+									temp_index = 0;
+								}
 
-							//Form a magnitude vector
-							work_vals_double_0 = sqrt((work_vals_double_3*work_vals_double_3+work_vals_double_4*work_vals_double_4));
-							
-							if (work_vals_double_0 > bus[indexer].max_volt_error)	//Failure check (defaults to voltage convergence for now)
-							{
-								swing_converged=false;
+								break;
 							}
-						}//End PF_DYNINIT SWING traversion
+						default:
+							GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+							break;
+					}//end switch
+					if ((temp_index==-1) || (temp_size==-1))	//Should never get here
+						GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
 
-						//Must be normal run, since DYNRUN should have swing capabilities deflagged
-						//Normal run - zero it - should already be zerod, but let's be paranoid for now
-						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + jindex] = 0.0;
-						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = 0.0;
-					}//End SWING bus cases
-					else	//PQ bus or SWING masquerading as a PQ
+					//Determine first index
+					if (phase_workc==0x01)	//Line is phase C
 					{
-						//It's I.  Just a direct conversion (P changed above to I as well)
-						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+ powerflow_values->BA_diag[indexer].size + jindex] = tempPbus - tempIcalcReal;
-						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = tempQbus - tempIcalcImag;
-					}//End Normal PQ bus
-				}//End split-phase present
-				else	//Three phase or some variant thereof
-				{
-					tempPbus =  - bus[indexer].PL[jindex];	//Copy load amounts in
-					tempQbus =  - bus[indexer].QL[jindex];	
+						jindex=2;
+					}//end line C if
+					else if (phase_workc==0x02)	//Line is phase B
+					{
+						jindex=1;
+					}//end line B if
+					else						//Line has to be phase A
+					{
+						jindex=0;
+					}//End line A if
 
-					for (kindex=0; kindex<powerflow_values->BA_diag[indexer].size; kindex++)		//cols - Still only for specified phases
+
+					//Indices counted out from Self admittance above.  needs doubling due to complex separation
+					for (kindex=0; kindex<2; kindex++)	//Loop through columns of admittance matrices (only 2x2)
 					{
-						//Determine our indices, based on phase information
-						temp_index = -1;
-						switch(bus[indexer].phases & 0x07) {
-							case 0x01:	//C
-								{
-									temp_index=2;
-									break;
-								}//end 0x01
-							case 0x02:	//B
-								{
-									temp_index=1;
-									break;
-								}//end 0x02
-							case 0x03:	//BC
-								{
-									if (kindex==0)	//B
-										temp_index=1;
-									else	//C
-										temp_index=2;
-									break;
-								}//end 0x03
-							case 0x04:	//A
-								{
-									temp_index=0;
-									break;
-								}//end 0x04
-							case 0x05:	//AC
-								{
-									if (kindex==0)	//A
-										temp_index=0;
-									else			//C
-										temp_index=2;
-									break;
-								}//end 0x05
-							case 0x06:	//AB
-								{
-									if (kindex==0)	//A
-										temp_index=0;
-									else			//B
-										temp_index=1;
-									break;
-								}//end 0x06
-							case 0x07:	//ABC
-								{
-									temp_index = kindex;	//Will loop all 3
-									break;
-								}//end 0x07
-						}//End switch/case
 
-						if (temp_index==-1)	//Error check
+						if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
+						{
+							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index;
+							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+							powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
+							indexer += 1;
+							
+							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
+							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+							powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
+							indexer += 1;
+						}
+
+						if (((branch[jindexer].Yto[kindex*3+jindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
 						{
-							GL_THROW("NR: A voltage index failed to be found.");
-							/*  TROUBLESHOOT
-							While attempting to compute the calculated power current, a voltage index failed to be
-							resolved.  Please submit your code and a bug report via the trac website.
-							*/
+							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex;
+							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index;
+							powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[kindex*3+jindex]).Im());
+							indexer += 1;
+							
+							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
+							powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yto[kindex*3+jindex]).Im();
+							indexer += 1;
 						}
 
-						//Normal diagonal contributions
-						tempIcalcReal += (powerflow_values->BA_diag[indexer].Y[jindex][kindex]).Re() * (bus[indexer].V[temp_index]).Re() - (powerflow_values->BA_diag[indexer].Y[jindex][kindex]).Im() * (bus[indexer].V[temp_index]).Im();// equation (7), the diag elements of bus admittance matrix 
-						tempIcalcImag += (powerflow_values->BA_diag[indexer].Y[jindex][kindex]).Re() * (bus[indexer].V[temp_index]).Im() + (powerflow_values->BA_diag[indexer].Y[jindex][kindex]).Im() * (bus[indexer].V[temp_index]).Re();// equation (8), the diag elements of bus admittance matrix 
+						if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
+						{
+							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
+							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+							powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+							indexer += 1;
+							
+							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index;
+							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+							powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+							indexer += 1;	
+						}
 
-						//In-rush load contributions (if any) - only along explicit diagonal
-						if ((bus[indexer].full_Y_load != NULL) && (jindex==kindex))
+						if (((branch[jindexer].Yto[kindex*3+jindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
 						{
-							tempIcalcReal += (bus[indexer].full_Y_load[temp_index]).Re() * (bus[indexer].V[temp_index]).Re() - (bus[indexer].full_Y_load[temp_index]).Im() * (bus[indexer].V[temp_index]).Im();// equation (7), the diag elements of bus admittance matrix 
-							tempIcalcImag += (bus[indexer].full_Y_load[temp_index]).Re() * (bus[indexer].V[temp_index]).Im() + (bus[indexer].full_Y_load[temp_index]).Im() * (bus[indexer].V[temp_index]).Re();// equation (8), the diag elements of bus admittance matrix 
+							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index;
+							powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[kindex*3+jindex]).Re());
+							indexer += 1;
+							
+							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex;
+							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
+							powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[kindex*3+jindex]).Re());
+							indexer += 1;	
 						}
+					}//secondary index end
 
-						//Off diagonal contributions
-						//Need another variable to handle the rows
-						temp_index_b = -1;
-						switch(bus[indexer].phases & 0x07) {
-							case 0x01:	//C
-								{
-									temp_index_b=2;
-									break;
-								}//end 0x01
-							case 0x02:	//B
-								{
-									temp_index_b=1;
-									break;
-								}//end 0x02
-							case 0x03:	//BC
-								{
-									if (jindex==0)	//B
-										temp_index_b=1;
-									else	//C
-										temp_index_b=2;
-									break;
-								}//end 0x03
-							case 0x04:	//A
-								{
-									temp_index_b=0;
-									break;
-								}//end 0x04
-							case 0x05:	//AC
-								{
-									if (jindex==0)	//A
-										temp_index_b=0;
-									else			//C
-										temp_index_b=2;
-									break;
-								}//end 0x05
-							case 0x06:	//AB
-								{
-									if (jindex==0)	//A
-										temp_index_b=0;
-									else			//B
-										temp_index_b=1;
-									break;
-								}//end 0x06
-							case 0x07:	//ABC
-								{
-									temp_index_b = jindex;	//Will loop all 3
-									break;
-								}//end 0x07
-						}//End switch/case
+				}//end to triplexy
+			}//end triplex in here
+			else					//Some combination of not-3 phase
+			{
+				//Clear working variables, just in case
+				temp_index = temp_index_b = -1;
+				temp_size = temp_size_b = temp_size_c = -1;
+				Full_Mat_A = Full_Mat_B = false;
+
+				//Intermediate store the admittance matrices so they can be directly indexed later
+				switch(branch[jindexer].phases & 0x07) {
+					case 0x00:	//No phases (open switch or reliability excluded item)
+						{
+							temp_size_c = -99;	//Arbitrary flag
+							break;
+						}
+					case 0x01:	//C only
+						{
+							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[8];
+							Temp_Ad_B[0][0] = branch[jindexer].Yto[8];
+							temp_size_c = 1;
+							break;
+						}
+					case 0x02:	//B only
+						{
+							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[4];
+							Temp_Ad_B[0][0] = branch[jindexer].Yto[4];
+							temp_size_c = 1;
+							break;
+						}
+					case 0x03:	//BC only
+						{
+							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[4];
+							Temp_Ad_A[0][1] = branch[jindexer].Yfrom[5];
+							Temp_Ad_A[1][0] = branch[jindexer].Yfrom[7];
+							Temp_Ad_A[1][1] = branch[jindexer].Yfrom[8];
+							
+							Temp_Ad_B[0][0] = branch[jindexer].Yto[4];
+							Temp_Ad_B[0][1] = branch[jindexer].Yto[5];
+							Temp_Ad_B[1][0] = branch[jindexer].Yto[7];
+							Temp_Ad_B[1][1] = branch[jindexer].Yto[8];
+
+							temp_size_c = 2;
+							break;
+						}
+					case 0x04:	//A only
+						{
+							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[0];
+							Temp_Ad_B[0][0] = branch[jindexer].Yto[0];
+							temp_size_c = 1;
+							break;
+						}
+					case 0x05:	//AC only
+						{
+							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[0];
+							Temp_Ad_A[0][1] = branch[jindexer].Yfrom[2];
+							Temp_Ad_A[1][0] = branch[jindexer].Yfrom[6];
+							Temp_Ad_A[1][1] = branch[jindexer].Yfrom[8];
+							
+							Temp_Ad_B[0][0] = branch[jindexer].Yto[0];
+							Temp_Ad_B[0][1] = branch[jindexer].Yto[2];
+							Temp_Ad_B[1][0] = branch[jindexer].Yto[6];
+							Temp_Ad_B[1][1] = branch[jindexer].Yto[8];
+
+							temp_size_c = 2;
+							break;
+						}
+					case 0x06:	//AB only
+						{
+							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[0];
+							Temp_Ad_A[0][1] = branch[jindexer].Yfrom[1];
+							Temp_Ad_A[1][0] = branch[jindexer].Yfrom[3];
+							Temp_Ad_A[1][1] = branch[jindexer].Yfrom[4];
+							
+							Temp_Ad_B[0][0] = branch[jindexer].Yto[0];
+							Temp_Ad_B[0][1] = branch[jindexer].Yto[1];
+							Temp_Ad_B[1][0] = branch[jindexer].Yto[3];
+							Temp_Ad_B[1][1] = branch[jindexer].Yto[4];
 
-						if (temp_index_b==-1)	//Error check
-						{
-							GL_THROW("NR: A voltage index failed to be found.");
+							temp_size_c = 2;
+							break;
 						}
-
-						for (kindexer=0; kindexer<(bus[indexer].Link_Table_Size); kindexer++)	//Parse through the branch list
+					default:
 						{
-							//Apply proper index to jindexer (easier to implement this way)
-							jindexer=bus[indexer].Link_Table[kindexer];
-
-							if (branch[jindexer].from == indexer) 
-							{
-								//See if we're a triplex transformer (will only occur on the from side)
-								if ((branch[jindexer].phases & 0x80) == 0x80)	//Triplexy
-								{
-									proceed_flag = false;
-									phase_worka = branch[jindexer].phases & 0x07;
+							break;
+						}
+				}//end line switch/case
 
-									if (kindex==0)	//All of this will only occur the first column iteration
-									{
-										switch (bus[indexer].phases & 0x07)	{
-											case 0x01:	//C
-												{
-													if (phase_worka==0x01)
-														proceed_flag=true;
-													break;
-												}//end 0x01
-											case 0x02:	//B
-												{
-													if (phase_worka==0x02)
-														proceed_flag=true;
-													break;
-												}//end 0x02
-											case 0x03:	//BC
-												{
-													if ((jindex==0) && (phase_worka==0x02))	//First row and is a B
-														proceed_flag=true;
-													else if ((jindex==1) && (phase_worka==0x01))	//Second row and is a C
-														proceed_flag=true;
-													else
-														;
-													break;
-												}//end 0x03
-											case 0x04:	//A
-												{
-													if (phase_worka==0x04)
-														proceed_flag=true;
-													break;
-												}//end 0x04
-											case 0x05:	//AC
-												{
-													if ((jindex==0) && (phase_worka==0x04))	//First row and is a A
-														proceed_flag=true;
-													else if ((jindex==1) && (phase_worka==0x01))	//Second row and is a C
-														proceed_flag=true;
-													else
-														;
-													break;
-												}//end 0x05
-											case 0x06:	//AB - shares with ABC
-											case 0x07:	//ABC 
-												{
-													if ((jindex==0) && (phase_worka==0x04))	//A & first row
-														proceed_flag=true;
-													else if ((jindex==1) && (phase_worka==0x02))	//B & second row
-														proceed_flag=true;
-													else if ((jindex==2) && (phase_worka==0x01))	//C & third row
-														proceed_flag=true;
-													else;
-													break;
-												}//end 0x07
-										}//end switch
-									}//End if kindex==0
-
-									if (proceed_flag)
-									{
-										work_vals_char_0 = temp_index_b*3;
-										//Do columns individually
-										//1
-										tempIcalcReal += (-(branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Re() - (-(branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-										tempIcalcImag += (-(branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Im() + (-(branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-
-										//2
-										tempIcalcReal += (-(branch[jindexer].Yfrom[work_vals_char_0+1])).Re() * (bus[branch[jindexer].to].V[1]).Re() - (-(branch[jindexer].Yfrom[work_vals_char_0+1])).Im() * (bus[branch[jindexer].to].V[1]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-										tempIcalcImag += (-(branch[jindexer].Yfrom[work_vals_char_0+1])).Re() * (bus[branch[jindexer].to].V[1]).Im() + (-(branch[jindexer].Yfrom[work_vals_char_0+1])).Im() * (bus[branch[jindexer].to].V[1]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-
-									}
-								}//end SPCT transformer
-								else	///Must be a standard line
-								{
-									work_vals_char_0 = temp_index_b*3+temp_index;
-									work_vals_double_0 = (-branch[jindexer].Yfrom[work_vals_char_0]).Re();
-									work_vals_double_1 = (-branch[jindexer].Yfrom[work_vals_char_0]).Im();
-									work_vals_double_2 = (bus[branch[jindexer].to].V[temp_index]).Re();
-									work_vals_double_3 = (bus[branch[jindexer].to].V[temp_index]).Im();
+				if (temp_size_c==-99)
+				{
+					continue;	//Next iteration of branch loop
+				}
 
-									tempIcalcReal += work_vals_double_0 * work_vals_double_2 - work_vals_double_1 * work_vals_double_3;// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-									tempIcalcImag += work_vals_double_0 * work_vals_double_3 + work_vals_double_1 * work_vals_double_2;// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+				if (temp_size_c==-1)	//Make sure it is right
+				{
+					GL_THROW("NR: A line's phase was flagged as not full three-phase, but wasn't");
+					/*  TROUBLESHOOT
+					A line inside the powerflow model was flagged as not being full three-phase or
+					triplex in any form.  It failed the other cases though, so it must have been.
+					Please submit your code and a bug report to the trac website.
+					*/
+				}
 
-								}//end standard line
-							}	
-							if  (branch[jindexer].to == indexer)
+				//Check the from side and get all appropriate offsets
+				switch(bus[tempa].phases & 0x07) {
+					case 0x01:	//C
+						{
+							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
 							{
-								work_vals_char_0 = temp_index_b*3+temp_index;
-								work_vals_double_0 = (-branch[jindexer].Yto[work_vals_char_0]).Re();
-								work_vals_double_1 = (-branch[jindexer].Yto[work_vals_char_0]).Im();
-								work_vals_double_2 = (bus[branch[jindexer].from].V[temp_index]).Re();
-								work_vals_double_3 = (bus[branch[jindexer].from].V[temp_index]).Im();
-
-								tempIcalcReal += work_vals_double_0 * work_vals_double_2 - work_vals_double_1 * work_vals_double_3;// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-								tempIcalcImag += work_vals_double_0 * work_vals_double_3 + work_vals_double_1 * work_vals_double_2;// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+								temp_size = 1;		//Single size
+								temp_index = 0;		//No offset (only 1 big)
 							}
-							else;
-						}
-					}//end intermediate current for each phase column
-
-					//Determine how we are posting this update
-					if ((bus[indexer].type > 1) && (bus[indexer].swing_functions_enabled == true))	//SWING bus is different (when it really is a SWING bus)
-					{
-						if ((powerflow_type == PF_DYNINIT) && (bus[indexer].full_Y != NULL) && (bus[indexer].DynCurrent != NULL))
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+								/*  TROUBLESHOOT
+								One of the lines in the powerflow model has an invalid phase in
+								reference to its to and from ends.  This should have been caught
+								earlier, so submit your code and a bug report using the trac website.
+								*/
+							}
+							break;
+						}//end 0x01
+					case 0x02:	//B
 						{
-							//Compute our "power generated" value for this phase - conjugated in formation
-							temp_complex_2 = bus[indexer].V[jindex] * complex(tempIcalcReal,-tempIcalcImag);
-
-							if (Iteration>0)	//Only update SWING on subsequent passes
+							if ((branch[jindexer].phases & 0x07) == 0x02)	//B
+							{
+								temp_size = 1;		//Single size
+								temp_index = 0;		//No offset (only 1 big)
+							}
+							else
 							{
-								//Now add it into the "generation total" for the SWING
-								(*bus[indexer].PGenTotal) += temp_complex_2 - temp_complex_3/3.0; // both PT and QT = Ssource-Sysource = v conj(I) - v conj(ysource v)
+								GL_THROW("NR: One of the lines has invalid phase parameters");
 							}
-								
-							//Compute the delta_I, just like below - but don't post it (still zero in calcs)
-							work_vals_double_0 = (bus[indexer].V[temp_index_b]).Mag()*(bus[indexer].V[temp_index_b]).Mag();
-
-							if (work_vals_double_0!=0)	//Only normal one (not square), but a zero is still a zero even after that
+							break;
+						}//end 0x02
+					case 0x03:	//BC
+						{
+							temp_size = 2;	//Size of this matrix's admittance
+							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
 							{
-								work_vals_double_1 = (bus[indexer].V[temp_index_b]).Re();
-								work_vals_double_2 = (bus[indexer].V[temp_index_b]).Im();
-								work_vals_double_3 = (tempPbus * work_vals_double_1 + tempQbus * work_vals_double_2)/ (work_vals_double_0) - tempIcalcReal ; // equation(7), Real part of deltaI, left hand side of equation (11)
-								work_vals_double_4 = (tempPbus * work_vals_double_2 - tempQbus * work_vals_double_1)/ (work_vals_double_0) - tempIcalcImag; // Imaginary part of deltaI, left hand side of equation (11)
-
-								//Form a magnitude value - put in work_vals_double_0, since we're done with it
-								work_vals_double_0 = sqrt((work_vals_double_3*work_vals_double_3+work_vals_double_4*work_vals_double_4));
+								temp_index = 1;		//offset
 							}
-							else	//Would give us a NAN, so it must be out of service or something (case from below - really shouldn't apply to SWING)
+							else if ((branch[jindexer].phases & 0x07) == 0x02)	//B
 							{
-           						work_vals_double_0 = 0.0;	//Assumes "converged"
+								temp_index = 0;		//offset
 							}
-							
-							if (work_vals_double_0 > bus[indexer].max_volt_error)	//Failure check (defaults to voltage convergence for now)
+							else if ((branch[jindexer].phases & 0x07) == 0x03)	//BC
 							{
-								swing_converged=false;
+								temp_index = 0;
 							}
-						}//End PF_DYNINIT SWING traversion
-
-						//Effectively Zero out the components, regardless of normal run or not
-						//Should already be zerod, but do it again for paranoia sake
-						if (NR_busdata[indexer].BusHistTerm != NULL)	//See if we're "delta-capable"
-						{
-							powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + jindex] = NR_busdata[indexer].BusHistTerm[jindex].Re();
-							powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = NR_busdata[indexer].BusHistTerm[jindex].Im();
-						}
-						else
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+							}
+							break;
+						}//end 0x03
+					case 0x04:	//A
 						{
-							powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + jindex] = 0.0;
-							powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = 0.0;
-						}
-
-						//Saturation skipped for "swing is a swing" case, since it doesn't affect the admittance (no need to offset)
-					}//End SWING bus cases
-					else	//PQ bus or SWING masquerading as a PQ
-					{
-						work_vals_double_0 = (bus[indexer].V[temp_index_b]).Mag()*(bus[indexer].V[temp_index_b]).Mag();
-
-						if (work_vals_double_0!=0)	//Only normal one (not square), but a zero is still a zero even after that
+							if ((branch[jindexer].phases & 0x07) == 0x04)	//A
+							{
+								temp_size = 1;		//Single size
+								temp_index = 0;		//No offset (only 1 big)
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+							}
+							break;
+						}//end 0x04
+					case 0x05:	//AC
 						{
-							work_vals_double_1 = (bus[indexer].V[temp_index_b]).Re();
-							work_vals_double_2 = (bus[indexer].V[temp_index_b]).Im();
-
-							//See if deltamode needs to include extra term
-							if (NR_busdata[indexer].BusHistTerm != NULL)
+							temp_size = 2;	//Size of this matrix's admittance
+							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
 							{
-								powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+ powerflow_values->BA_diag[indexer].size + jindex] = (tempPbus * work_vals_double_1 + tempQbus * work_vals_double_2)/ (work_vals_double_0) + NR_busdata[indexer].BusHistTerm[jindex].Re() - tempIcalcReal ; // equation(7), Real part of deltaI, left hand side of equation (11)
-								powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = (tempPbus * work_vals_double_2 - tempQbus * work_vals_double_1)/ (work_vals_double_0) + NR_busdata[indexer].BusHistTerm[jindex].Im() - tempIcalcImag; // Imaginary part of deltaI, left hand side of equation (11)
+								temp_index = 1;		//offset
 							}
-							else	//Nope
+							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
 							{
-								powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+ powerflow_values->BA_diag[indexer].size + jindex] = (tempPbus * work_vals_double_1 + tempQbus * work_vals_double_2)/ (work_vals_double_0) - tempIcalcReal ; // equation(7), Real part of deltaI, left hand side of equation (11)
-								powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = (tempPbus * work_vals_double_2 - tempQbus * work_vals_double_1)/ (work_vals_double_0) - tempIcalcImag; // Imaginary part of deltaI, left hand side of equation (11)
+								temp_index = 0;		//offset
 							}
-
-							//Accumulate in any saturation current values as well, while we're here
-							if (NR_busdata[indexer].BusSatTerm != NULL)
+							else if ((branch[jindexer].phases & 0x07) == 0x05)	//AC
 							{
-								powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+ powerflow_values->BA_diag[indexer].size + jindex] -= NR_busdata[indexer].BusSatTerm[jindex].Re();
-								powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] -= NR_busdata[indexer].BusSatTerm[jindex].Im();
+								temp_index = 0;
 							}
-						}
-						else
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+							}
+							break;
+						}//end 0x05
+					case 0x06:	//AB
 						{
-							if (NR_busdata[indexer].BusHistTerm != NULL)	//See if extra deltamode term needs to be included
+							temp_size = 2;	//Size of this matrix's admittance
+							if ((branch[jindexer].phases & 0x07) == 0x02)	//B
 							{
-           						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + jindex] = NR_busdata[indexer].BusHistTerm[jindex].Re();
-								powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = NR_busdata[indexer].BusHistTerm[jindex].Im();
+								temp_index = 1;		//offset
 							}
-							else
+							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
 							{
-           						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + jindex] = 0.0;
-								powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = 0.0;
+								temp_index = 0;		//offset
 							}
-
-							//Accumulate in any saturation current values as well, while we're here
-							if (NR_busdata[indexer].BusSatTerm != NULL)
+							else if ((branch[jindexer].phases & 0x07) == 0x06)	//AB
+							{
+								temp_index = 0;
+							}
+							else
 							{
-								powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+ powerflow_values->BA_diag[indexer].size + jindex] -= NR_busdata[indexer].BusSatTerm[jindex].Re();
-								powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] -= NR_busdata[indexer].BusSatTerm[jindex].Im();
+								GL_THROW("NR: One of the lines has invalid phase parameters");
 							}
-						}
-					}//End normal bus handling
-				}//End three-phase or variant thereof
-			}//End delta_I for each phase row
-
-			//Add in generator current amounts, if relevant
-			if (powerflow_type != PF_NORMAL)
-			{
-				//Secondary check - see if it is even needed - basically built around 3-phase right now (checks)
-				if ((*bus[indexer].dynamics_enabled==true) && (bus[indexer].full_Y != NULL) && (bus[indexer].DynCurrent != NULL))
-				{
-					if ((bus[indexer].phases & 0x07) == 0x07)	//Make sure is three-phase
-					{
-						//Only update in particular mode - SWING bus values should still be treated as such
-						if ((swing_is_a_swing == true) && (powerflow_type == PF_DYNINIT))	//Really only true for PF_DYNINIT anyways
+							break;
+						}//end 0x06
+					case 0x07:	//ABC
 						{
-							//Power should be all updated, now update current values
-							temp_complex_0 += complex((*bus[indexer].PGenTotal).Re(),-(*bus[indexer].PGenTotal).Im()); // total generated power injected congugated
-
-							//Compute Ii
-							if (temp_complex_1.Mag() > 0.0)	//Non zero
+							temp_size = 3;	//Size of this matrix's admittance
+							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
 							{
-								temp_complex_2 = temp_complex_0/temp_complex_1;	//Forms Ii
-
-								//Now convert Ii to the individual phase amounts
-								bus[indexer].DynCurrent[0] = temp_complex_2;
-								bus[indexer].DynCurrent[1] = temp_complex_2*avalsq;
-								bus[indexer].DynCurrent[2] = temp_complex_2*aval;
+								temp_index = 2;		//offset
 							}
-							else	//Must make zero
+							else if ((branch[jindexer].phases & 0x07) == 0x02)	//B
 							{
-								bus[indexer].DynCurrent[0] = complex(0.0,0.0);
-								bus[indexer].DynCurrent[1] = complex(0.0,0.0);
-								bus[indexer].DynCurrent[2] = complex(0.0,0.0);
+								temp_index = 1;		//offset
 							}
-						}//End SWING is still swing, otherwise should just accumulate what it had
-
-						//Don't get added in as part of "normal swing" routine
-						if ((bus[indexer].type == 0) || ((bus[indexer].type>1) && (bus[indexer].swing_functions_enabled == false)))
-						{
-							//Add these into the system - added because "generation"
-       						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size] += bus[indexer].DynCurrent[0].Re();		//Phase A
-       						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + 1] += bus[indexer].DynCurrent[1].Re();	//Phase B
-       						powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + 2] += bus[indexer].DynCurrent[2].Re();	//Phase C
-
-							powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc] += bus[indexer].DynCurrent[0].Im();		//Phase A
-							powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + 1] += bus[indexer].DynCurrent[1].Im();	//Phase B
-							powerflow_values->deltaI_NR[2*bus[indexer].Matrix_Loc + 2] += bus[indexer].DynCurrent[2].Im();	//Phase C
-						}
-						//Defaulted else - leave as they were
-					}//End three-phase
-					else	//Not three-phase athe moment
-					{
-						//See if we ever were (reliability call)
-						if ((bus[indexer].origphases & 0x07) == 0x07)
-						{
-							//Just zero it
-							bus[indexer].DynCurrent[0] = complex(0.0,0.0);
-							bus[indexer].DynCurrent[1] = complex(0.0,0.0);
-							bus[indexer].DynCurrent[2] = complex(0.0,0.0);
-						}
-						else	//Never was, just fail out
-						{
-							GL_THROW("NR_solver: bus:%s has tried updating deltamode dyanmics, but is not three-phase!",bus[indexer].name);
-							/*  TROUBLESHOOT
-							The NR_solver routine tried update a three-phase current value for a bus that is not
-							three phase.  At this time, the deltamode system only supports three-phase buses for
-							generator attachment.
-							*/
-						}
-					}
-				}//End extra current adds
-			}//End dynamic (generator postings)
-		}//End delta_I for each bus
-
-		// Calculate the elements of a,b,c,d in equations(14),(15),(16),(17). These elements are used to update the Jacobian matrix.	
-		for (indexer=0; indexer<bus_count; indexer++)
-		{
-			if ((bus[indexer].phases & 0x08) == 0x08)	//Delta connected node
-			{
-				//Populate the values for constant current -- deltamode different right now (all same in future?)
-				if (*bus[indexer].dynamics_enabled == true)
-				{
-					//Create nominal magnitudes
-					adjust_nominal_voltage_val = bus[indexer].volt_base * sqrt(3.0);
-
-					//Create the nominal voltage vectors
-					adjust_temp_nominal_voltage[0].SetPolar(adjust_nominal_voltage_val,PI/6.0);
-					adjust_temp_nominal_voltage[1].SetPolar(adjust_nominal_voltage_val,-1.0*PI/2.0);
-					adjust_temp_nominal_voltage[2].SetPolar(adjust_nominal_voltage_val,5.0*PI/6.0);
-
-					//Compute delta voltages
-					voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
-					voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
-					voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
-
-					//Get magnitudes of all
-					adjust_temp_voltage_mag[0] = voltageDel[0].Mag();
-					adjust_temp_voltage_mag[1] = voltageDel[1].Mag();
-					adjust_temp_voltage_mag[2] = voltageDel[2].Mag();
-
-					//Start adjustments - AB
-					if ((bus[indexer].I[0] != 0.0) && (adjust_temp_voltage_mag[0] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[0] = ~(adjust_temp_nominal_voltage[0] * ~bus[indexer].I[0] * adjust_temp_voltage_mag[0] / (voltageDel[0] * adjust_nominal_voltage_val));
-					}
-					else
-					{
-						adjusted_constant_current[0] = 0.0;
-					}
-
-					//Start adjustments - BC
-					if ((bus[indexer].I[1] != 0.0) && (adjust_temp_voltage_mag[1] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[1] = ~(adjust_temp_nominal_voltage[1] * ~bus[indexer].I[1] * adjust_temp_voltage_mag[1] / (voltageDel[1] * adjust_nominal_voltage_val));
-					}
-					else
-					{
-						adjusted_constant_current[1] = 0.0;
-					}
-
-					//Start adjustments - CA
-					if ((bus[indexer].I[2] != 0.0) && (adjust_temp_voltage_mag[2] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[2] = ~(adjust_temp_nominal_voltage[2] * ~bus[indexer].I[2] * adjust_temp_voltage_mag[2] / (voltageDel[2] * adjust_nominal_voltage_val));
-					}
-					else
-					{
-						adjusted_constant_current[2] = 0.0;
-					}
-
-					//See if we have any "different children"
-					if ((bus[indexer].phases & 0x10) == 0x10)
-					{
-						//Create nominal magnitudes
-						adjust_nominal_voltage_val = bus[indexer].volt_base;
-
-						//Create the nominal voltage vectors
-						adjust_temp_nominal_voltage[3].SetPolar(bus[indexer].volt_base,0.0);
-						adjust_temp_nominal_voltage[4].SetPolar(bus[indexer].volt_base,-2.0*PI/3.0);
-						adjust_temp_nominal_voltage[5].SetPolar(bus[indexer].volt_base,2.0*PI/3.0);
-
-						//Get magnitudes of all
-						adjust_temp_voltage_mag[3] = bus[indexer].V[0].Mag();
-						adjust_temp_voltage_mag[4] = bus[indexer].V[1].Mag();
-						adjust_temp_voltage_mag[5] = bus[indexer].V[2].Mag();
-
-						//Start adjustments - A
-						if ((bus[indexer].extra_var[6] != 0.0) && (adjust_temp_voltage_mag[3] != 0.0))
-						{
-							//calculate new value
-							adjusted_constant_current[3] = ~(adjust_temp_nominal_voltage[3] * ~bus[indexer].extra_var[6] * adjust_temp_voltage_mag[3] / (bus[indexer].V[0] * adjust_nominal_voltage_val));
-						}
-						else
-						{
-							adjusted_constant_current[3] = 0.0;
-						}
-
-						//Start adjustments - B
-						if ((bus[indexer].extra_var[7] != 0.0) && (adjust_temp_voltage_mag[4] != 0.0))
-						{
-							//calculate new value
-							adjusted_constant_current[4] = ~(adjust_temp_nominal_voltage[4] * ~bus[indexer].extra_var[7] * adjust_temp_voltage_mag[4] / (bus[indexer].V[1] * adjust_nominal_voltage_val));
-						}
-						else
+							else if ((branch[jindexer].phases & 0x07) == 0x03)	//BC
+							{
+								temp_index = 1;
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
+							{
+								temp_index = 0;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x05)	//AC
+							{
+								temp_index = 0;
+								Full_Mat_A = true;		//Flag so we know C needs to be gapped
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x06)	//AB
+							{
+								temp_index = 0;
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+							}
+							break;
+						}//end 0x07
+					default:
 						{
-							adjusted_constant_current[4] = 0.0;
+							break;
 						}
+				}//End switch/case for from
 
-						//Start adjustments - C
-						if ((bus[indexer].extra_var[8] != 0.0) && (adjust_temp_voltage_mag[5] != 0.0))
+				//Check the to side and get all appropriate offsets
+				switch(bus[tempb].phases & 0x07) {
+					case 0x01:	//C
 						{
-							//calculate new value
-							adjusted_constant_current[5] = ~(adjust_temp_nominal_voltage[5] * ~bus[indexer].extra_var[8] * adjust_temp_voltage_mag[5] / (bus[indexer].V[2] * adjust_nominal_voltage_val));
-						}
-						else
+							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
+							{
+								temp_size_b = 1;		//Single size
+								temp_index_b = 0;		//No offset (only 1 big)
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+								/*  TROUBLESHOOT
+								One of the lines in the powerflow model has an invalid phase in
+								reference to its to and from ends.  This should have been caught
+								earlier, so submit your code and a bug report using the trac website.
+								*/
+							}
+							break;
+						}//end 0x01
+					case 0x02:	//B
 						{
-							adjusted_constant_current[5] = 0.0;
-						}
-					}
-					else	//Nope
-					{
-						//Set to zero, just cause
-						adjusted_constant_current[3] = 0.0;
-						adjusted_constant_current[4] = 0.0;
-						adjusted_constant_current[5] = 0.0;
-					}
-				}
-				else	//"Normal" modes -- handle traditionally
-				{
-					adjusted_constant_current[0] = bus[indexer].I[0];
-					adjusted_constant_current[1] = bus[indexer].I[1];
-					adjusted_constant_current[2] = bus[indexer].I[2];
-
-					//See if we have different children too
-					if ((bus[indexer].phases & 0x10) == 0x10)
-					{
-						//Store them too
-						adjusted_constant_current[3] = bus[indexer].extra_var[6];
-						adjusted_constant_current[4] = bus[indexer].extra_var[7];
-						adjusted_constant_current[5] = bus[indexer].extra_var[8];
-					}
-					else	//Nope, just zero this for now
-					{
-						adjusted_constant_current[3] = 0.0;
-						adjusted_constant_current[4] = 0.0;
-						adjusted_constant_current[5] = 0.0;
-					}
-				}//End adjustment code
-
-				//Delta components - populate according to what is there
-				if ((bus[indexer].phases & 0x06) == 0x06)	//Check for AB
-				{
-					//Voltage calculations
-					voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
-
-					//Power - convert to a current (uses less iterations this way)
-					delta_current[0] = (voltageDel[0] == 0) ? 0 : ~(bus[indexer].S[0]/voltageDel[0]);
-
-					//Convert delta connected load to appropriate Wye
-					delta_current[0] += voltageDel[0] * (bus[indexer].Y[0]);
-
-				}
-				else
-				{
-					//Zero values - they shouldn't be used anyhow
-					voltageDel[0] = 0.0;
-					delta_current[0] = 0.0;
-				}
-
-				if ((bus[indexer].phases & 0x03) == 0x03)	//Check for BC
-				{
-					//Voltage calculations
-					voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
-
-					//Power - convert to a current (uses less iterations this way)
-					delta_current[1] = (voltageDel[1] == 0) ? 0 : ~(bus[indexer].S[1]/voltageDel[1]);
-
-					//Convert delta connected load to appropriate Wye
-					delta_current[1] += voltageDel[1] * (bus[indexer].Y[1]);
-
-				}
-				else
-				{
-					//Zero unused
-					voltageDel[1] = 0.0;
-					delta_current[1] = 0.0;
-				}
-
-				if ((bus[indexer].phases & 0x05) == 0x05)	//Check for CA
-				{
-					//Voltage calculations
-					voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
-
-					//Power - convert to a current (uses less iterations this way)
-					delta_current[2] = (voltageDel[2] == 0) ? 0 : ~(bus[indexer].S[2]/voltageDel[2]);
-
-					//Convert delta connected load to appropriate Wye
-					delta_current[2] += voltageDel[2] * (bus[indexer].Y[2]);
-
-				}
-				else
-				{
-					//Zero unused
-					voltageDel[2] = 0.0;
-					delta_current[2] = 0.0;
-				}
-				
-				//Convert delta-current into a phase current, where appropriate - reuse temp variable
-				//Everything will be accumulated into the "current" field for ease (including differents)
-				if ((bus[indexer].phases & 0x04) == 0x04)	//Has a phase A
-				{
-					undeltacurr[0]=(adjusted_constant_current[0]+delta_current[0])-(adjusted_constant_current[2]+delta_current[2]);
-
-					//Check for "different" children and apply them, as well
-					if ((bus[indexer].phases & 0x10) == 0x10)	//We do, so they must be Wye-connected
-					{
-						//Power values
-						undeltacurr[0] += (bus[indexer].V[0] == 0) ? 0 : ~(bus[indexer].extra_var[0]/bus[indexer].V[0]);
-
-						//Shunt values
-						undeltacurr[0] += bus[indexer].extra_var[3]*bus[indexer].V[0];
-
-						//Current values
-						undeltacurr[0] += adjusted_constant_current[3];
-					}
-				}
-				else
-				{
-					//Zero it, just in case
-					undeltacurr[0] = 0.0;
-				}
-
-				if ((bus[indexer].phases & 0x02) == 0x02)	//Has a phase B
-				{
-					undeltacurr[1]=(adjusted_constant_current[1]+delta_current[1])-(adjusted_constant_current[0]+delta_current[0]);
-
-					//Check for "different" children and apply them, as well
-					if ((bus[indexer].phases & 0x10) == 0x10)	//We do, so they must be Wye-connected
-					{
-						//Power values
-						undeltacurr[1] += (bus[indexer].V[1] == 0) ? 0 : ~(bus[indexer].extra_var[1]/bus[indexer].V[1]);
-
-						//Shunt values
-						undeltacurr[1] += bus[indexer].extra_var[4]*bus[indexer].V[1];
-
-						//Current values
-						undeltacurr[1] += adjusted_constant_current[4];
-					}
-				}
-				else
-				{
-					//Zero it, just in case
-					undeltacurr[1] = 0.0;
-				}
-
-
-				if ((bus[indexer].phases & 0x01) == 0x01)	//Has a phase C
-				{
-					undeltacurr[2]=(adjusted_constant_current[2]+delta_current[2])-(adjusted_constant_current[1]+delta_current[1]);
-
-					//Check for "different" children and apply them, as well
-					if ((bus[indexer].phases & 0x10) == 0x10)		//We do, so they must be Wye-connected
-					{
-						//Power values
-						undeltacurr[2] += (bus[indexer].V[2] == 0) ? 0 : ~(bus[indexer].extra_var[2]/bus[indexer].V[2]);
-
-						//Shunt values
-						undeltacurr[2] += bus[indexer].extra_var[5]*bus[indexer].V[2];
-
-						//Current values
-						undeltacurr[2] += adjusted_constant_current[5];
-					}
-				}
-				else
-				{
-					//Zero it, just in case
-					undeltacurr[2] = 0.0;
-				}
-
-				//Provide updates to relevant phases
-				//only compute and store phases that exist (make top heavy)
-				temp_index = -1;
-				temp_index_b = -1;
-				
-				for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
-				{
-					switch(bus[indexer].phases & 0x07) {
-						case 0x01:	//C
+							if ((branch[jindexer].phases & 0x07) == 0x02)	//B
 							{
-								temp_index=0;
-								temp_index_b=2;
-								break;
+								temp_size_b = 1;		//Single size
+								temp_index_b = 0;		//No offset (only 1 big)
 							}
-						case 0x02:	//B
+							else
 							{
-								temp_index=0;
-								temp_index_b=1;
-								break;
+								GL_THROW("NR: One of the lines has invalid phase parameters");
 							}
-						case 0x03:	//BC
+							break;
+						}//end 0x02
+					case 0x03:	//BC
+						{
+							temp_size_b = 2;	//Size of this matrix's admittance
+							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
 							{
-								if (jindex==0)	//B
-								{
-									temp_index=0;
-									temp_index_b=1;
-								}
-								else			//C
-								{
-									temp_index=1;
-									temp_index_b=2;
-								}
-								break;
+								temp_index_b = 1;		//offset
 							}
-						case 0x04:	//A
+							else if ((branch[jindexer].phases & 0x07) == 0x02)	//B
 							{
-								temp_index=0;
-								temp_index_b=0;
-								break;
+								temp_index_b = 0;		//offset
 							}
-						case 0x05:	//AC
+							else if ((branch[jindexer].phases & 0x07) == 0x03)	//BC
 							{
-								if (jindex==0)	//A
-								{
-									temp_index=0;
-									temp_index_b=0;
-								}
-								else			//C
-								{
-									temp_index=1;
-									temp_index_b=2;
-								}
-								break;
+								temp_index_b = 0;
 							}
-						case 0x06:	//AB
-						case 0x07:	//ABC
+							else
 							{
-								temp_index=jindex;
-								temp_index_b=jindex;
-								break;
+								GL_THROW("NR: One of the lines has invalid phase parameters");
 							}
-						default:
 							break;
-					}//end case
-
-					if ((temp_index==-1) || (temp_index_b==-1))
-					{
-						GL_THROW("NR: A Jacobian update element failed.");
-						//Defined below
-					}
-
-					if ((bus[indexer].V[temp_index_b]).Mag()!=0)
-					{
-						bus[indexer].Jacob_A[temp_index] = ((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Re() + (undeltacurr[temp_index_b]).Im() *pow((bus[indexer].V[temp_index_b]).Im(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3);// second part of equation(37) - no power term needed
-						bus[indexer].Jacob_B[temp_index] = -((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Im() + (undeltacurr[temp_index_b]).Re() *pow((bus[indexer].V[temp_index_b]).Re(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3);// second part of equation(38) - no power term needed
-						bus[indexer].Jacob_C[temp_index] =((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Im() - (undeltacurr[temp_index_b]).Re() *pow((bus[indexer].V[temp_index_b]).Im(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3);// second part of equation(39) - no power term needed
-						bus[indexer].Jacob_D[temp_index] = ((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Re() - (undeltacurr[temp_index_b]).Im() *pow((bus[indexer].V[temp_index_b]).Re(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3);// second part of equation(40) - no power term needed
-					}
-					else	//Zero voltage = only impedance is valid (others get divided by VMag, so are IND) - not entirely sure how this gets in here anyhow
-					{
-						bus[indexer].Jacob_A[temp_index] = -1e-4;	//Small offset to avoid singularities (if impedance is zero too)
-						bus[indexer].Jacob_B[temp_index] = -1e-4;
-						bus[indexer].Jacob_C[temp_index] = -1e-4;
-						bus[indexer].Jacob_D[temp_index] = -1e-4;
-					}
-				}//End phase traversion
-			}//end delta-connected load
-			else if	((bus[indexer].phases & 0x80) == 0x80)	//Split phase computations
-			{
-				//Convert it all back to current (easiest to handle)
-				//Get V12 first
-				voltageDel[0] = bus[indexer].V[0] + bus[indexer].V[1];
-
-				//Start with the currents (just put them in)
-				temp_current[0] = bus[indexer].I[0];
-				temp_current[1] = bus[indexer].I[1];
-				temp_current[2] = *bus[indexer].extra_var; //current12 is not part of the standard current array
-
-				//Add in deltamode unrotated, if necessary
-				if ((bus[indexer].prerot_I[2] != 0.0) && (*bus[indexer].dynamics_enabled == true))
-					temp_current[2] += bus[indexer].prerot_I[2];
-
-				//Now add in power contributions
-				temp_current[0] += bus[indexer].V[0] == 0.0 ? 0.0 : ~(bus[indexer].S[0]/bus[indexer].V[0]);
-				temp_current[1] += bus[indexer].V[1] == 0.0 ? 0.0 : ~(bus[indexer].S[1]/bus[indexer].V[1]);
-				temp_current[2] += voltageDel[0] == 0.0 ? 0.0 : ~(bus[indexer].S[2]/voltageDel[0]);
-
-				//Last, but not least, admittance/impedance contributions
-				temp_current[0] += bus[indexer].Y[0]*bus[indexer].V[0];
-				temp_current[1] += bus[indexer].Y[1]*bus[indexer].V[1];
-				temp_current[2] += bus[indexer].Y[2]*voltageDel[0];
-
-				//See if we are a house-connected node, if so, adjust and add in those values as well
-				if ((bus[indexer].phases & 0x40) == 0x40)
-				{
-					//Update phase adjustments
-					temp_store[0].SetPolar(1.0,bus[indexer].V[0].Arg());	//Pull phase of V1
-					temp_store[1].SetPolar(1.0,bus[indexer].V[1].Arg());	//Pull phase of V2
-					temp_store[2].SetPolar(1.0,voltageDel[0].Arg());		//Pull phase of V12
-
-					//Update these current contributions (use delta current variable, it isn't used in here anyways)
-					delta_current[0] = bus[indexer].house_var[0]/(~temp_store[0]);		//Just denominator conjugated to keep math right (rest was conjugated in house)
-					delta_current[1] = bus[indexer].house_var[1]/(~temp_store[1]);
-					delta_current[2] = bus[indexer].house_var[2]/(~temp_store[2]);
-
-					//Now add it into the current contributions
-					temp_current[0] += delta_current[0];
-					temp_current[1] += delta_current[1];
-					temp_current[2] += delta_current[2];
-				}//End house-attached splitphase
-
-				//Convert 'em to line currents - they need to be negated (due to the convention from earlier)
-				temp_store[0] = -(temp_current[0] + temp_current[2]);
-				temp_store[1] = -(-temp_current[1] - temp_current[2]);
-
-				for (jindex=0; jindex<2; jindex++)
-				{
-					if ((bus[indexer].V[jindex]).Mag()!=0)	//Only current
-					{
-						bus[indexer].Jacob_A[jindex] = ((bus[indexer].V[jindex]).Re()*(bus[indexer].V[jindex]).Im()*(temp_store[jindex]).Re() + (temp_store[jindex]).Im() *pow((bus[indexer].V[jindex]).Im(),2))/pow((bus[indexer].V[jindex]).Mag(),3);// second part of equation(37)
-						bus[indexer].Jacob_B[jindex] = -((bus[indexer].V[jindex]).Re()*(bus[indexer].V[jindex]).Im()*(temp_store[jindex]).Im() + (temp_store[jindex]).Re() *pow((bus[indexer].V[jindex]).Re(),2))/pow((bus[indexer].V[jindex]).Mag(),3);// second part of equation(38)
-						bus[indexer].Jacob_C[jindex] =((bus[indexer].V[jindex]).Re()*(bus[indexer].V[jindex]).Im()*(temp_store[jindex]).Im() - (temp_store[jindex]).Re() *pow((bus[indexer].V[jindex]).Im(),2))/pow((bus[indexer].V[jindex]).Mag(),3);// second part of equation(39)
-						bus[indexer].Jacob_D[jindex] = ((bus[indexer].V[jindex]).Re()*(bus[indexer].V[jindex]).Im()*(temp_store[jindex]).Re() - (temp_store[jindex]).Im() *pow((bus[indexer].V[jindex]).Re(),2))/pow((bus[indexer].V[jindex]).Mag(),3);// second part of equation(40)
-					}
-					else
-					{
-						bus[indexer].Jacob_A[jindex]=  -1e-4;	//Put very small to avoid singularity issues
-						bus[indexer].Jacob_B[jindex]=  -1e-4;
-						bus[indexer].Jacob_C[jindex]=  -1e-4;
-						bus[indexer].Jacob_D[jindex]=  -1e-4;
-					}
-				}
-
-				//Zero the last elements, just to be safe (shouldn't be an issue, but who knows)
-				bus[indexer].Jacob_A[2] = 0.0;
-				bus[indexer].Jacob_B[2] = 0.0;
-				bus[indexer].Jacob_C[2] = 0.0;
-				bus[indexer].Jacob_D[2] = 0.0;
-
-			}//end split-phase connected
-			else	//Wye-connected system/load
-			{
-				//Populate the values for constant current -- deltamode different right now (all same in future?)
-				if (*bus[indexer].dynamics_enabled == true)
-				{
-					//Create nominal magnitudes
-					adjust_nominal_voltage_val = bus[indexer].volt_base;
-
-					//Create the nominal voltage vectors
-					adjust_temp_nominal_voltage[3].SetPolar(bus[indexer].volt_base,0.0);
-					adjust_temp_nominal_voltage[4].SetPolar(bus[indexer].volt_base,-2.0*PI/3.0);
-					adjust_temp_nominal_voltage[5].SetPolar(bus[indexer].volt_base,2.0*PI/3.0);
-
-					//Get magnitudes of all
-					adjust_temp_voltage_mag[3] = bus[indexer].V[0].Mag();
-					adjust_temp_voltage_mag[4] = bus[indexer].V[1].Mag();
-					adjust_temp_voltage_mag[5] = bus[indexer].V[2].Mag();
-
-					//Start adjustments - A
-					if ((bus[indexer].I[0] != 0.0) && (adjust_temp_voltage_mag[3] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[0] = ~(adjust_temp_nominal_voltage[3] * ~bus[indexer].I[0] * adjust_temp_voltage_mag[3] / (bus[indexer].V[0] * adjust_nominal_voltage_val));
-					}
-					else
-					{
-						adjusted_constant_current[0] = 0.0;
-					}
-
-					//Start adjustments - B
-					if ((bus[indexer].I[1] != 0.0) && (adjust_temp_voltage_mag[4] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[1] = ~(adjust_temp_nominal_voltage[4] * ~bus[indexer].I[1] * adjust_temp_voltage_mag[4] / (bus[indexer].V[1] * adjust_nominal_voltage_val));
-					}
-					else
-					{
-						adjusted_constant_current[1] = 0.0;
-					}
-
-					//Start adjustments - C
-					if ((bus[indexer].I[2] != 0.0) && (adjust_temp_voltage_mag[5] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[2] = ~(adjust_temp_nominal_voltage[5] * ~bus[indexer].I[2] * adjust_temp_voltage_mag[5] / (bus[indexer].V[2] * adjust_nominal_voltage_val));
-					}
-					else
-					{
-						adjusted_constant_current[2] = 0.0;
-					}
-
-					if (bus[indexer].prerot_I[0] != 0.0)
-						adjusted_constant_current[0] += bus[indexer].prerot_I[0];
-
-					if (bus[indexer].prerot_I[1] != 0.0)
-						adjusted_constant_current[1] += bus[indexer].prerot_I[1];
-
-					if (bus[indexer].prerot_I[2] != 0.0)
-						adjusted_constant_current[2] += bus[indexer].prerot_I[2];
-
-					//See if we have any "different children"
-					if ((bus[indexer].phases & 0x10) == 0x10)
-					{
-						//Create nominal magnitudes
-						adjust_nominal_voltage_val = bus[indexer].volt_base * sqrt(3.0);
-
-						//Create the nominal voltage vectors
-						adjust_temp_nominal_voltage[0].SetPolar(adjust_nominal_voltage_val,PI/6.0);
-						adjust_temp_nominal_voltage[1].SetPolar(adjust_nominal_voltage_val,-1.0*PI/2.0);
-						adjust_temp_nominal_voltage[2].SetPolar(adjust_nominal_voltage_val,5.0*PI/6.0);
-
-						//Compute delta voltages
-						voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
-						voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
-						voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
-
-						//Get magnitudes of all
-						adjust_temp_voltage_mag[0] = voltageDel[0].Mag();
-						adjust_temp_voltage_mag[1] = voltageDel[1].Mag();
-						adjust_temp_voltage_mag[2] = voltageDel[2].Mag();
-
-						//Start adjustments - AB
-						if ((bus[indexer].extra_var[6] != 0.0) && (adjust_temp_voltage_mag[0] != 0.0))
-						{
-							//calculate new value
-							adjusted_constant_current[3] = ~(adjust_temp_nominal_voltage[0] * ~bus[indexer].extra_var[6] * adjust_temp_voltage_mag[0] / (voltageDel[0] * adjust_nominal_voltage_val));
-						}
-						else
-						{
-							adjusted_constant_current[3] = 0.0;
-						}
-
-						//Start adjustments - BC
-						if ((bus[indexer].extra_var[7] != 0.0) && (adjust_temp_voltage_mag[1] != 0.0))
+						}//end 0x03
+					case 0x04:	//A
 						{
-							//calculate new value
-							adjusted_constant_current[4] = ~(adjust_temp_nominal_voltage[1] * ~bus[indexer].extra_var[7] * adjust_temp_voltage_mag[1] / (voltageDel[1] * adjust_nominal_voltage_val));
-						}
-						else
+							if ((branch[jindexer].phases & 0x07) == 0x04)	//A
+							{
+								temp_size_b = 1;		//Single size
+								temp_index_b = 0;		//No offset (only 1 big)
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+							}
+							break;
+						}//end 0x04
+					case 0x05:	//AC
 						{
-							adjusted_constant_current[4] = 0.0;
-						}
-
-						//Start adjustments - CA
-						if ((bus[indexer].extra_var[8] != 0.0) && (adjust_temp_voltage_mag[2] != 0.0))
+							temp_size_b = 2;	//Size of this matrix's admittance
+							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
+							{
+								temp_index_b = 1;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
+							{
+								temp_index_b = 0;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x05)	//AC
+							{
+								temp_index_b = 0;
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+							}
+							break;
+						}//end 0x05
+					case 0x06:	//AB
 						{
-							//calculate new value
-							adjusted_constant_current[5] = ~(adjust_temp_nominal_voltage[2] * ~bus[indexer].extra_var[8] * adjust_temp_voltage_mag[2] / (voltageDel[2] * adjust_nominal_voltage_val));
-						}
-						else
+							temp_size_b = 2;	//Size of this matrix's admittance
+							if ((branch[jindexer].phases & 0x07) == 0x02)	//B
+							{
+								temp_index_b = 1;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
+							{
+								temp_index_b = 0;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x06)	//AB
+							{
+								temp_index_b = 0;
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+							}
+							break;
+						}//end 0x06
+					case 0x07:	//ABC
 						{
-							adjusted_constant_current[5] = 0.0;
-						}
-					}
-					else	//Nope
-					{
-						//Set to zero, just cause
-						adjusted_constant_current[3] = 0.0;
-						adjusted_constant_current[4] = 0.0;
-						adjusted_constant_current[5] = 0.0;
-					}
-				}
-				else	//"Normal" modes -- handle traditionally
-				{
-					adjusted_constant_current[0] = bus[indexer].I[0];
-					adjusted_constant_current[1] = bus[indexer].I[1];
-					adjusted_constant_current[2] = bus[indexer].I[2];
-
-					//See if we have different children too
-					if ((bus[indexer].phases & 0x10) == 0x10)
-					{
-						//Store them too
-						adjusted_constant_current[3] = bus[indexer].extra_var[6];
-						adjusted_constant_current[4] = bus[indexer].extra_var[7];
-						adjusted_constant_current[5] = bus[indexer].extra_var[8];
-					}
-					else	//Nope, just zero this for now
-					{
-						adjusted_constant_current[3] = 0.0;
-						adjusted_constant_current[4] = 0.0;
-						adjusted_constant_current[5] = 0.0;
-					}
-				}//End adjustment code
-
-				//For Wye-connected, only compute and store phases that exist (make top heavy)
-				temp_index = -1;
-				temp_index_b = -1;
-				
-				if ((bus[indexer].phases & 0x10) == 0x10)	//"Different" child load - in this case it must be delta - also must be three phase (just because that's how I forced it to be implemented)
-				{											//Calculate all the deltas to wyes in advance (otherwise they'll get repeated)
-					//Make sure phase combinations exist
-					if ((bus[indexer].phases & 0x06) == 0x06)	//Has A-B
-					{
-					//Delta voltages
-					voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
-
-						//Power - put into a current value (iterates less this way)
-						delta_current[0] = (voltageDel[0] == 0) ? 0 : ~(bus[indexer].extra_var[0]/voltageDel[0]);
-
-						//Convert delta connected load to appropriate Wye 
-						delta_current[0] += voltageDel[0] * (bus[indexer].extra_var[3]);
-					}
-					else
-					{
-						//Zero it, for good measure
-						voltageDel[0] = 0.0;
-						delta_current[0] = 0.0;
-					}
-
-					//Check for BC
-					if ((bus[indexer].phases & 0x03) == 0x03)	//Has B-C
-					{
-						//Delta voltages
-						voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
-
-						//Power - put into a current value (iterates less this way)
-						delta_current[1] = (voltageDel[1] == 0) ? 0 : ~(bus[indexer].extra_var[1]/voltageDel[1]);
-
-						//Convert delta connected load to appropriate Wye 
-						delta_current[1] += voltageDel[1] * (bus[indexer].extra_var[4]);
-					}
-					else
-					{
-						//Zero it, for good measure
-						voltageDel[1] = 0.0;
-						delta_current[1] = 0.0;
-					}
-
-					//Check for CA
-					if ((bus[indexer].phases & 0x05) == 0x05)	//Has C-A
-					{
-						//Delta voltages
-						voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
-
-						//Power - put into a current value (iterates less this way)
-						delta_current[2] = (voltageDel[2] == 0) ? 0 : ~(bus[indexer].extra_var[2]/voltageDel[2]);
-
-						//Convert delta connected load to appropriate Wye 
-						delta_current[2] += voltageDel[2] * (bus[indexer].extra_var[5]);
-					}
-					else
-					{
-						//Zero it, for good measure
-						voltageDel[2] = 0.0;
-						delta_current[2] = 0.0;
-					}
-
-					//Convert delta-current into a phase current - reuse temp variable
-					undeltacurr[0]=(adjusted_constant_current[3]+delta_current[0])-(adjusted_constant_current[5]+delta_current[2]);
-					undeltacurr[1]=(adjusted_constant_current[4]+delta_current[1])-(adjusted_constant_current[3]+delta_current[0]);
-					undeltacurr[2]=(adjusted_constant_current[5]+delta_current[2])-(adjusted_constant_current[4]+delta_current[1]);
-				}
-				else	//zero the variable so we don't have excessive ifs
-				{
-					undeltacurr[0] = undeltacurr[1] = undeltacurr[2] = 0.0;	//Zero it
-				}
-
-				for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
-				{
-					switch(bus[indexer].phases & 0x07) {
-						case 0x01:	//C
+							temp_size_b = 3;	//Size of this matrix's admittance
+							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
 							{
-								temp_index=0;
-								temp_index_b=2;
-								break;
+								temp_index_b = 2;		//offset
 							}
-						case 0x02:	//B
+							else if ((branch[jindexer].phases & 0x07) == 0x02)	//B
 							{
-								temp_index=0;
-								temp_index_b=1;
-								break;
+								temp_index_b = 1;		//offset
 							}
-						case 0x03:	//BC
+							else if ((branch[jindexer].phases & 0x07) == 0x03)	//BC
 							{
-								if (jindex==0)	//B
-								{
-									temp_index=0;
-									temp_index_b=1;
-								}
-								else			//C
-								{
-									temp_index=1;
-									temp_index_b=2;
-								}
-								break;
+								temp_index_b = 1;
 							}
-						case 0x04:	//A
+							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
 							{
-								temp_index=0;
-								temp_index_b=0;
-								break;
+								temp_index_b = 0;		//offset
 							}
-						case 0x05:	//AC
+							else if ((branch[jindexer].phases & 0x07) == 0x05)	//AC
 							{
-								if (jindex==0)	//A
-								{
-									temp_index=0;
-									temp_index_b=0;
-								}
-								else			//C
-								{
-									temp_index=1;
-									temp_index_b=2;
-								}
-								break;
+								temp_index_b = 0;
+								Full_Mat_B = true;		//Flag so we know C needs to be gapped
 							}
-						case 0x06:	//AB
-						case 0x07:	//ABC
+							else if ((branch[jindexer].phases & 0x07) == 0x06)	//AB
 							{
-								temp_index=jindex;
-								temp_index_b=jindex;
-								break;
+								temp_index_b = 0;
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
 							}
-						default:
 							break;
-					}//end case
-
-					if ((temp_index==-1) || (temp_index_b==-1))
-					{
-						GL_THROW("NR: A Jacobian update element failed.");
-						/*  TROUBLESHOOT
-						While attempting to calculate the "dynamic" portions of the
-						Jacobian matrix that encompass attached loads, an update failed to process correctly.
-						Submit you code and a bug report using the trac website.
-						*/
-					}
-
-					if ((bus[indexer].V[temp_index_b]).Mag()!=0)
-					{
-						bus[indexer].Jacob_A[temp_index] = ((bus[indexer].S[temp_index_b]).Im() * (pow((bus[indexer].V[temp_index_b]).Re(),2) - pow((bus[indexer].V[temp_index_b]).Im(),2)) - 2*(bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(bus[indexer].S[temp_index_b]).Re())/pow((bus[indexer].V[temp_index_b]).Mag(),4);// first part of equation(37)
-						bus[indexer].Jacob_A[temp_index] += ((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(adjusted_constant_current[temp_index_b]).Re() + (adjusted_constant_current[temp_index_b]).Im() *pow((bus[indexer].V[temp_index_b]).Im(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3) + (bus[indexer].Y[temp_index_b]).Im();// second part of equation(37)
-						bus[indexer].Jacob_A[temp_index] += ((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Re() + (undeltacurr[temp_index_b]).Im() *pow((bus[indexer].V[temp_index_b]).Im(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3);// current part of equation (37) - Handles "different" children
-						
-						bus[indexer].Jacob_B[temp_index] = ((bus[indexer].S[temp_index_b]).Re() * (pow((bus[indexer].V[temp_index_b]).Re(),2) - pow((bus[indexer].V[temp_index_b]).Im(),2)) + 2*(bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(bus[indexer].S[temp_index_b]).Im())/pow((bus[indexer].V[temp_index_b]).Mag(),4);// first part of equation(38)
-						bus[indexer].Jacob_B[temp_index] += -((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(adjusted_constant_current[temp_index_b]).Im() + (adjusted_constant_current[temp_index_b]).Re() *pow((bus[indexer].V[temp_index_b]).Re(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3) - (bus[indexer].Y[temp_index_b]).Re();// second part of equation(38)
-						bus[indexer].Jacob_B[temp_index] += -((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Im() + (undeltacurr[temp_index_b]).Re() *pow((bus[indexer].V[temp_index_b]).Re(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3);// current part of equation(38) - Handles "different" children
-						
-						bus[indexer].Jacob_C[temp_index] = ((bus[indexer].S[temp_index_b]).Re() * (pow((bus[indexer].V[temp_index_b]).Im(),2) - pow((bus[indexer].V[temp_index_b]).Re(),2)) - 2*(bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(bus[indexer].S[temp_index_b]).Im())/pow((bus[indexer].V[temp_index_b]).Mag(),4);// first part of equation(39)
-						bus[indexer].Jacob_C[temp_index] +=((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(adjusted_constant_current[temp_index_b]).Im() - (adjusted_constant_current[temp_index_b]).Re() *pow((bus[indexer].V[temp_index_b]).Im(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3) - (bus[indexer].Y[temp_index_b]).Re();// second part of equation(39)
-						bus[indexer].Jacob_C[temp_index] +=((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Im() - (undeltacurr[temp_index_b]).Re() *pow((bus[indexer].V[temp_index_b]).Im(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3);// Current part of equation(39) - Handles "different" children
-						
-						bus[indexer].Jacob_D[temp_index] = ((bus[indexer].S[temp_index_b]).Im() * (pow((bus[indexer].V[temp_index_b]).Re(),2) - pow((bus[indexer].V[temp_index_b]).Im(),2)) - 2*(bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(bus[indexer].S[temp_index_b]).Re())/pow((bus[indexer].V[temp_index_b]).Mag(),4);// first part of equation(40)
-						bus[indexer].Jacob_D[temp_index] += ((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(adjusted_constant_current[temp_index_b]).Re() - (adjusted_constant_current[temp_index_b]).Im() *pow((bus[indexer].V[temp_index_b]).Re(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3) - (bus[indexer].Y[temp_index_b]).Im();// second part of equation(40)
-						bus[indexer].Jacob_D[temp_index] += ((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Re() - (undeltacurr[temp_index_b]).Im() *pow((bus[indexer].V[temp_index_b]).Re(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3);// Current part of equation(40) - Handles "different" children
-					
-					}
-					else
-					{
-						bus[indexer].Jacob_A[temp_index]= (bus[indexer].Y[temp_index_b]).Im() - 1e-4;	//Small offset to avoid singularity issues
-						bus[indexer].Jacob_B[temp_index]= -(bus[indexer].Y[temp_index_b]).Re() - 1e-4;
-						bus[indexer].Jacob_C[temp_index]= -(bus[indexer].Y[temp_index_b]).Re() - 1e-4;
-						bus[indexer].Jacob_D[temp_index]= -(bus[indexer].Y[temp_index_b]).Im() - 1e-4;
-					}
-				}//End phase traversion - Wye
-			}//End wye-connected load
-
-			//Perform delta/wye explicit load updates -- no triplex
-			if ((bus[indexer].phases & 0x80) != 0x80)	//Not triplex
-			{
-				//Delta components - populate according to what is there
-				if ((bus[indexer].phases & 0x06) == 0x06)	//Check for AB
-				{
-					//Voltage calculations
-					voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
-
-					//Power - convert to a current (uses less iterations this way)
-					delta_current[0] = (voltageDel[0] == 0) ? 0 : ~(bus[indexer].S_dy[0]/voltageDel[0]);
-
-					//Convert delta connected load to appropriate Wye
-					delta_current[0] += voltageDel[0] * (bus[indexer].Y_dy[0]);
-
-				}
-				else
-				{
-					//Zero values - they shouldn't be used anyhow
-					voltageDel[0] = 0.0;
-					delta_current[0] = 0.0;
-				}
-
-				if ((bus[indexer].phases & 0x03) == 0x03)	//Check for BC
-				{
-					//Voltage calculations
-					voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
-
-					//Power - convert to a current (uses less iterations this way)
-					delta_current[1] = (voltageDel[1] == 0) ? 0 : ~(bus[indexer].S_dy[1]/voltageDel[1]);
-
-					//Convert delta connected load to appropriate Wye
-					delta_current[1] += voltageDel[1] * (bus[indexer].Y_dy[1]);
+						}//end 0x07
+					default:
+						{
+							break;
+						}
+				}//End switch/case for to
 
-				}
-				else
+				//Make sure everything was set before proceeding
+				if ((temp_index==-1) || (temp_index_b==-1) || (temp_size==-1) || (temp_size_b==-1) || (temp_size_c==-1))
 				{
-					//Zero unused
-					voltageDel[1] = 0.0;
-					delta_current[1] = 0.0;
+					GL_THROW("NR: Failure to construct single/double phase line indices");
+					/*  TROUBLESHOOT
+					A single or double phase line (e.g., just A or AB) has failed to properly initialize all of the indices
+					necessary to form the admittance matrix.  Please submit a bug report, with your code, to the trac site.
+					*/
 				}
 
-				if ((bus[indexer].phases & 0x05) == 0x05)	//Check for CA
+				if (Full_Mat_A)	//From side is a full ABC and we have AC
 				{
-					//Voltage calculations
-					voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
+					for (jindex=0; jindex<temp_size_c; jindex++)		//Loop through rows of admittance matrices				
+					{
+						for (kindex=0; kindex<temp_size_c; kindex++)	//Loop through columns of admittance matrices
+						{
+							//Indices counted out from Self admittance above.  needs doubling due to complex separation
+							if ((Temp_Ad_A[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
+							{
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Im());
+								indexer += 1;
+								
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2 + temp_size;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = (Temp_Ad_A[jindex][kindex].Im());
+								indexer += 1;
+							}
 
-					//Power - convert to a current (uses less iterations this way)
-					delta_current[2] = (voltageDel[2] == 0) ? 0 : ~(bus[indexer].S_dy[2]/voltageDel[2]);
+							if ((Temp_Ad_B[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
+							{
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Im());
+								indexer += 1;
+								
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2 + temp_size;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = Temp_Ad_B[jindex][kindex].Im();
+								indexer += 1;
+							}
 
-					//Convert delta connected load to appropriate Wye
-					delta_current[2] += voltageDel[2] * (bus[indexer].Y_dy[2]);
+							if ((Temp_Ad_A[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
+							{
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2 + temp_size;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
+								indexer += 1;
+								
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
+								indexer += 1;	
+							}
 
-				}
-				else
-				{
-					//Zero unused
-					voltageDel[2] = 0.0;
-					delta_current[2] = 0.0;
-				}
+							if ((Temp_Ad_B[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
+							{
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
+								indexer += 1;
+								
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2 + temp_size;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
+								indexer += 1;	
+							}
+						}//column end
+					}//row end
+				}//end full ABC for from AC
 
-				//Populate the values for constant current -- deltamode different right now (all same in future?)
-				if (*bus[indexer].dynamics_enabled == true)
+				if (Full_Mat_B)	//To side is a full ABC and we have AC
 				{
-					//Create line-line nominal magnitude
-					adjust_nominal_voltage_val = bus[indexer].volt_base;
-					adjust_nominal_voltaged_val = bus[indexer].volt_base * sqrt(3.0);
-
-					//Create the nominal voltage vectors
-					adjust_temp_nominal_voltage[0].SetPolar(adjust_nominal_voltaged_val,PI/6.0);
-					adjust_temp_nominal_voltage[1].SetPolar(adjust_nominal_voltaged_val,-1.0*PI/2.0);
-					adjust_temp_nominal_voltage[2].SetPolar(adjust_nominal_voltaged_val,5.0*PI/6.0);
-					adjust_temp_nominal_voltage[3].SetPolar(adjust_nominal_voltage_val,0.0);
-					adjust_temp_nominal_voltage[4].SetPolar(adjust_nominal_voltage_val,-2.0*PI/3.0);
-					adjust_temp_nominal_voltage[5].SetPolar(adjust_nominal_voltage_val,2.0*PI/3.0);
-
-					//Compute delta voltages
-					voltageDel[0] = bus[indexer].V[0] - bus[indexer].V[1];
-					voltageDel[1] = bus[indexer].V[1] - bus[indexer].V[2];
-					voltageDel[2] = bus[indexer].V[2] - bus[indexer].V[0];
+					for (jindex=0; jindex<temp_size_c; jindex++)		//Loop through rows of admittance matrices				
+					{
+						for (kindex=0; kindex<temp_size_c; kindex++)	//Loop through columns of admittance matrices
+						{
+							//Indices counted out from Self admittance above.  needs doubling due to complex separation
+							if ((Temp_Ad_A[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
+							{
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Im());
+								indexer += 1;
+								
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2 + temp_size_b;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = (Temp_Ad_A[jindex][kindex].Im());
+								indexer += 1;
+							}
 
-					//Get magnitudes of all
-					adjust_temp_voltage_mag[0] = voltageDel[0].Mag();
-					adjust_temp_voltage_mag[1] = voltageDel[1].Mag();
-					adjust_temp_voltage_mag[2] = voltageDel[2].Mag();
-					adjust_temp_voltage_mag[3] = bus[indexer].V[0].Mag();
-					adjust_temp_voltage_mag[4] = bus[indexer].V[1].Mag();
-					adjust_temp_voltage_mag[5] = bus[indexer].V[2].Mag();
+							if ((Temp_Ad_B[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
+							{
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Im());
+								indexer += 1;
+								
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2 + temp_size_b;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = Temp_Ad_B[jindex][kindex].Im();
+								indexer += 1;
+							}
 
-					//Start adjustments - A
-					if ((bus[indexer].I_dy[3] != 0.0) && (adjust_temp_voltage_mag[3] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[3] = ~(adjust_temp_nominal_voltage[3] * ~bus[indexer].I_dy[3] * adjust_temp_voltage_mag[3] / (bus[indexer].V[0] * adjust_nominal_voltage_val));
-					}
-					else
-					{
-						adjusted_constant_current[3] = 0.0;
-					}
+							if ((Temp_Ad_A[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
+							{
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
+								indexer += 1;
+								
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2 + temp_size_b;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
+								indexer += 1;	
+							}
 
-					//Start adjustments - B
-					if ((bus[indexer].I_dy[4] != 0.0) && (adjust_temp_voltage_mag[4] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[4] = ~(adjust_temp_nominal_voltage[4] * ~bus[indexer].I_dy[4] * adjust_temp_voltage_mag[4] / (bus[indexer].V[1] * adjust_nominal_voltage_val));
-					}
-					else
-					{
-						adjusted_constant_current[4] = 0.0;
-					}
+							if ((Temp_Ad_B[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
+							{
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2 + temp_size_b;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
+								indexer += 1;
+								
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
+								indexer += 1;	
+							}
+						}//column end
+					}//row end
+				}//end full ABC for to AC
 
-					//Start adjustments - C
-					if ((bus[indexer].I_dy[5] != 0.0) && (adjust_temp_voltage_mag[5] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[5] = ~(adjust_temp_nominal_voltage[5] * ~bus[indexer].I_dy[5] * adjust_temp_voltage_mag[5] / (bus[indexer].V[2] * adjust_nominal_voltage_val));
-					}
-					else
+				if ((!Full_Mat_A) && (!Full_Mat_B))	//Neither is a full ABC, or we aren't doing AC, so we don't care
+				{
+					for (jindex=0; jindex<temp_size_c; jindex++)		//Loop through rows of admittance matrices				
 					{
-						adjusted_constant_current[5] = 0.0;
-					}
+						for (kindex=0; kindex<temp_size_c; kindex++)	//Loop through columns of admittance matrices
+						{
+							//Indices counted out from Self admittance above.  needs doubling due to complex separation
+							if ((Temp_Ad_A[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
+							{
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Im());
+								indexer += 1;
+								
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = (Temp_Ad_A[jindex][kindex].Im());
+								indexer += 1;
+							}
 
-					//Start adjustments - AB
-					if ((bus[indexer].I_dy[0] != 0.0) && (adjust_temp_voltage_mag[0] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[0] = ~(adjust_temp_nominal_voltage[0] * ~bus[indexer].I_dy[0] * adjust_temp_voltage_mag[0] / (voltageDel[0] * adjust_nominal_voltaged_val));
-					}
-					else
-					{
-						adjusted_constant_current[0] = 0.0;
-					}
+							if ((Temp_Ad_B[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
+							{
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Im());
+								indexer += 1;
+								
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = Temp_Ad_B[jindex][kindex].Im();
+								indexer += 1;
+							}
 
-					//Start adjustments - BC
-					if ((bus[indexer].I_dy[1] != 0.0) && (adjust_temp_voltage_mag[1] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[1] = ~(adjust_temp_nominal_voltage[1] * ~bus[indexer].I_dy[1] * adjust_temp_voltage_mag[1] / (voltageDel[1] * adjust_nominal_voltaged_val));
-					}
-					else
-					{
-						adjusted_constant_current[1] = 0.0;
-					}
+							if ((Temp_Ad_A[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
+							{
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
+								indexer += 1;
+								
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
+								indexer += 1;	
+							}
 
-					//Start adjustments - CA
-					if ((bus[indexer].I_dy[2] != 0.0) && (adjust_temp_voltage_mag[2] != 0.0))
-					{
-						//calculate new value
-						adjusted_constant_current[2] = ~(adjust_temp_nominal_voltage[2] * ~bus[indexer].I_dy[2] * adjust_temp_voltage_mag[2] / (voltageDel[2] * adjust_nominal_voltaged_val));
-					}
-					else
-					{
-						adjusted_constant_current[2] = 0.0;
-					}
-				}//End deltamode adjustment
-				else	//Normal mode
-				{
-					//Just copy the values in
-					adjusted_constant_current[0] = bus[indexer].I_dy[0];
-					adjusted_constant_current[1] = bus[indexer].I_dy[1];
-					adjusted_constant_current[2] = bus[indexer].I_dy[2];
-					adjusted_constant_current[3] = bus[indexer].I_dy[3];
-					adjusted_constant_current[4] = bus[indexer].I_dy[4];
-					adjusted_constant_current[5] = bus[indexer].I_dy[5];
-				}
+							if ((Temp_Ad_B[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
+							{
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
+								indexer += 1;
+								
+								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
+								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
+								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
+								indexer += 1;	
+							}
+						}//column end
+					}//row end
+				}//end not full ABC with AC on either side case
+			}//end all others else
+		}//end branch for
 
-				//Convert delta-current into a phase current, where appropriate - reuse temp variable
-				//Everything will be accumulated into the "current" field for ease (including differents)
-				if ((bus[indexer].phases & 0x04) == 0x04)	//Has a phase A
-				{
-					undeltacurr[0]=(adjusted_constant_current[0]+delta_current[0])-(adjusted_constant_current[2]+delta_current[2]);
+		//Build the fixed part of the diagonal PQ bus elements of 6n*6n Y_NR matrix. This part will not be updated at each iteration. 
+		powerflow_values->size_diag_fixed = 0;
+		for (jindexer=0; jindexer<bus_count;jindexer++) 
+		{
+			for (jindex=0; jindex<3; jindex++)
+			{
+				for (kindex=0; kindex<3; kindex++)
+				{		 
+				  if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re() != 0 && bus[jindexer].type != 1 && jindex!=kindex)  
+					  powerflow_values->size_diag_fixed += 1; 
+				  if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im() != 0 && bus[jindexer].type != 1 && jindex!=kindex) 
+					  powerflow_values->size_diag_fixed += 1; 
+				  else {}
+				 }
+			}
+		}
+		if (powerflow_values->Y_diag_fixed == NULL)
+		{
+			powerflow_values->Y_diag_fixed = (Y_NR *)gl_malloc((powerflow_values->size_diag_fixed*2) *sizeof(Y_NR));   //powerflow_values->Y_diag_fixed store the row,column and value of the fixed part of the diagonal PQ bus elements of 6n*6n Y_NR matrix.
 
-					//Apply wye-connected loads
+			//Make sure it worked
+			if (powerflow_values->Y_diag_fixed == NULL)
+				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
 
-					//Power values
-					undeltacurr[0] += (bus[indexer].V[0] == 0) ? 0 : ~(bus[indexer].S_dy[3]/bus[indexer].V[0]);
+			//Update the max size
+			powerflow_values->max_size_diag_fixed = powerflow_values->size_diag_fixed;
+		}
+		else if (powerflow_values->size_diag_fixed > powerflow_values->max_size_diag_fixed)		//Something changed and we are bigger!!
+		{
+			//Destroy us!
+			gl_free(powerflow_values->Y_diag_fixed);
 
-					//Shunt values
-					undeltacurr[0] += bus[indexer].Y_dy[3]*bus[indexer].V[0];
+			//Rebuild us, we have the technology
+			powerflow_values->Y_diag_fixed = (Y_NR *)gl_malloc((powerflow_values->size_diag_fixed*2) *sizeof(Y_NR));
 
-					//Current values
-					undeltacurr[0] += adjusted_constant_current[3];
-				}
-				else
-				{
-					//Zero it, just in case
-					undeltacurr[0] = 0.0;
-				}
+			//Make sure it worked
+			if (powerflow_values->Y_diag_fixed == NULL)
+				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
 
-				if ((bus[indexer].phases & 0x02) == 0x02)	//Has a phase B
-				{
-					undeltacurr[1]=(adjusted_constant_current[1]+delta_current[1])-(adjusted_constant_current[0]+delta_current[0]);
+			//Store the new size
+			powerflow_values->max_size_diag_fixed = powerflow_values->size_diag_fixed;
 
-					//Apply wye-connected loads
+			//Flag for a reallocation
+			powerflow_values->NR_realloc_needed = true;
+		}
 
-					//Power values
-					undeltacurr[1] += (bus[indexer].V[1] == 0) ? 0 : ~(bus[indexer].S_dy[4]/bus[indexer].V[1]);
+		indexer = 0;
+		for (jindexer=0; jindexer<bus_count;jindexer++)	//Parse through bus list
+		{ 
+			for (jindex=0; jindex<powerflow_values->BA_diag[jindexer].size; jindex++)
+			{
+				for (kindex=0; kindex<powerflow_values->BA_diag[jindexer].size; kindex++)
+				{					
+					if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im() != 0 && bus[jindexer].type != 1 && jindex!=kindex)
+					{
+						powerflow_values->Y_diag_fixed[indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex;
+						powerflow_values->Y_diag_fixed[indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex;
+						powerflow_values->Y_diag_fixed[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im();
+						indexer += 1;
 
-					//Shunt values
-					undeltacurr[1] += bus[indexer].Y_dy[4]*bus[indexer].V[1];
+						powerflow_values->Y_diag_fixed[indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex +powerflow_values->BA_diag[jindexer].size;
+						powerflow_values->Y_diag_fixed[indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex +powerflow_values->BA_diag[jindexer].size;
+						powerflow_values->Y_diag_fixed[indexer].Y_value = -(powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im();
+						indexer += 1;
+					}
 
-					//Current values
-					undeltacurr[1] += adjusted_constant_current[4];
-				}
-				else
-				{
-					//Zero it, just in case
-					undeltacurr[1] = 0.0;
+					if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re() != 0 && bus[jindexer].type != 1 && jindex!=kindex)
+					{
+						powerflow_values->Y_diag_fixed[indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex;
+						powerflow_values->Y_diag_fixed[indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex +powerflow_values->BA_diag[jindexer].size;
+						powerflow_values->Y_diag_fixed[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re();
+						indexer += 1;
+						
+						powerflow_values->Y_diag_fixed[indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex +powerflow_values->BA_diag[jindexer].size;
+						powerflow_values->Y_diag_fixed[indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex;
+						powerflow_values->Y_diag_fixed[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re();
+						indexer += 1;
+					}
 				}
+			}
+		}//End bus parse for fixed diagonal
+	}//End admittance update
 
-				if ((bus[indexer].phases & 0x01) == 0x01)	//Has a phase C
-				{
-					undeltacurr[2]=(adjusted_constant_current[2]+delta_current[2])-(adjusted_constant_current[1]+delta_current[1]);
+	//Reset saturation checks
+	SaturationMismatchPresent = false;
 
-					//Apply wye-connected loads
+	//Common inputs of the per-bus passes below
+	bus_pass.bus = bus;
+	bus_pass.branch = branch;
+	bus_pass.powerflow_values = powerflow_values;
+	bus_pass.powerflow_type = powerflow_type;
+	bus_pass.swing_is_a_swing = swing_is_a_swing;
+	bus_pass.aval = aval;
+	bus_pass.avalsq = avalsq;
+	n_threads = gl_pool_threadcount();
 
-					//Power values
-					undeltacurr[2] += (bus[indexer].V[2] == 0) ? 0 : ~(bus[indexer].S_dy[5]/bus[indexer].V[2]);
+	//Calculate the system load - this is the specified power of the system
+	for (Iteration=0; Iteration<NR_iteration_limit; Iteration++)
+	{
+		int64 instrument_t = gl_instrument_now();
 
-					//Shunt values
-					undeltacurr[2] += bus[indexer].Y_dy[5]*bus[indexer].V[2];
+		//System load at each bus is represented by second order polynomial equations
+		NR_run_ranges(NR_range_loads,&bus_pass,bus_count,n_threads);
+	
+		// Calculate the mismatch of three phase current injection at each bus (deltaI), 
+		//and store the deltaI in terms of real and reactive value in array powerflow_values->deltaI_NR    
+		if (powerflow_values->deltaI_NR==NULL)
+		{
+			powerflow_values->deltaI_NR = (double *)gl_malloc((2*powerflow_values->total_variables) *sizeof(double));   // left_hand side of equation (11)
 
-					//Current values
-					undeltacurr[2] += adjusted_constant_current[5];
-				}
-				else
-				{
-					//Zero it, just in case
-					undeltacurr[2] = 0.0;
-				}
+			//Make sure it worked
+			if (powerflow_values->deltaI_NR == NULL)
+				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
 
-				//Provide updates to relevant phases
-				//only compute and store phases that exist (make top heavy)
-				temp_index = -1;
-				temp_index_b = -1;
-				
-				for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
-				{
-					switch(bus[indexer].phases & 0x07) {
-						case 0x01:	//C
-							{
-								temp_index=0;
-								temp_index_b=2;
-								break;
-							}
-						case 0x02:	//B
-							{
-								temp_index=0;
-								temp_index_b=1;
-								break;
-							}
-						case 0x03:	//BC
-							{
-								if (jindex==0)	//B
-								{
-									temp_index=0;
-									temp_index_b=1;
-								}
-								else			//C
-								{
-									temp_index=1;
-									temp_index_b=2;
-								}
-								break;
-							}
-						case 0x04:	//A
-							{
-								temp_index=0;
-								temp_index_b=0;
-								break;
-							}
-						case 0x05:	//AC
-							{
-								if (jindex==0)	//A
-								{
-									temp_index=0;
-									temp_index_b=0;
-								}
-								else			//C
-								{
-									temp_index=1;
-									temp_index_b=2;
-								}
-								break;
-							}
-						case 0x06:	//AB
-						case 0x07:	//ABC
-							{
-								temp_index=jindex;
-								temp_index_b=jindex;
-								break;
-							}
-						default:
-							break;
-					}//end case
+			//Update the max size
+			powerflow_values->max_total_variables = powerflow_values->total_variables;
+		}
+		else if (powerflow_values->NR_realloc_needed)		//Bigger sized (this was checked above)
+		{
+			//Decimate the existing value
+			gl_free(powerflow_values->deltaI_NR);
 
-					if ((temp_index==-1) || (temp_index_b==-1))
-					{
-						GL_THROW("NR: A Jacobian update element failed.");
-						//Defined below
-					}
+			//Reallocate it...bigger...faster...stronger!
+			powerflow_values->deltaI_NR = (double *)gl_malloc((2*powerflow_values->total_variables) *sizeof(double));
 
-					if ((bus[indexer].V[temp_index_b]).Mag()!=0)
-					{
-						//Apply as an accumulation, in case any "normal" connections are present too
-						bus[indexer].Jacob_A[temp_index] += ((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Re() + (undeltacurr[temp_index_b]).Im() *pow((bus[indexer].V[temp_index_b]).Im(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3); // + (undeltaimped[temp_index_b]).Im();// second part of equation(37) - no power term needed
-						bus[indexer].Jacob_B[temp_index] += -((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Im() + (undeltacurr[temp_index_b]).Re() *pow((bus[indexer].V[temp_index_b]).Re(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3); // - (undeltaimped[temp_index_b]).Re();// second part of equation(38) - no power term needed
-						bus[indexer].Jacob_C[temp_index] +=((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Im() - (undeltacurr[temp_index_b]).Re() *pow((bus[indexer].V[temp_index_b]).Im(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3); // - (undeltaimped[temp_index_b]).Re();// second part of equation(39) - no power term needed
-						bus[indexer].Jacob_D[temp_index] += ((bus[indexer].V[temp_index_b]).Re()*(bus[indexer].V[temp_index_b]).Im()*(undeltacurr[temp_index_b]).Re() - (undeltacurr[temp_index_b]).Im() *pow((bus[indexer].V[temp_index_b]).Re(),2))/pow((bus[indexer].V[temp_index_b]).Mag(),3); // - (undeltaimped[temp_index_b]).Im();// second part of equation(40) - no power term needed
-					}
-					else	//Zero voltage = only impedance is valid (others get divided by VMag, so are IND) - not entirely sure how this gets in here anyhow
-					{
-						bus[indexer].Jacob_A[temp_index] += -1e-4; //(undeltaimped[temp_index_b]).Im() - 1e-4;	//Small offset to avoid singularities (if impedance is zero too)
-						bus[indexer].Jacob_B[temp_index] += -1e-4; //-(undeltaimped[temp_index_b]).Re() - 1e-4;
-						bus[indexer].Jacob_C[temp_index] += -1e-4; //-(undeltaimped[temp_index_b]).Re() - 1e-4;
-						bus[indexer].Jacob_D[temp_index] += -1e-4; //-(undeltaimped[temp_index_b]).Im() - 1e-4;
-					}
+			//Make sure it worked
+			if (powerflow_values->deltaI_NR == NULL)
+				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
 
-				}//End phase traversion
-			}//End delta/wye explicit loads
+			//Store the updated value
+			powerflow_values->max_total_variables = powerflow_values->total_variables;
+		}
 
-			//Delta load components  get added to the Jacobian values too -- mostly because this is the most convenient place to do it
-			//See if we're even needed first
-			if (bus[indexer].full_Y_load != NULL)
-			{
-				//Provide updates to relevant phases
-				//only compute and store phases that exist (make top heavy)
-				temp_index = -1;
-				temp_index_b = -1;
-				
-				for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
-				{
-					switch(bus[indexer].phases & 0x07) {
-						case 0x01:	//C
-							{
-								temp_index=0;
-								temp_index_b=2;
-								break;
-							}
-						case 0x02:	//B
-							{
-								temp_index=0;
-								temp_index_b=1;
-								break;
-							}
-						case 0x03:	//BC
-							{
-								if (jindex==0)	//B
-								{
-									temp_index=0;
-									temp_index_b=1;
-								}
-								else			//C
-								{
-									temp_index=1;
-									temp_index_b=2;
-								}
-								break;
-							}
-						case 0x04:	//A
-							{
-								temp_index=0;
-								temp_index_b=0;
-								break;
-							}
-						case 0x05:	//AC
-							{
-								if (jindex==0)	//A
-								{
-									temp_index=0;
-									temp_index_b=0;
-								}
-								else			//C
-								{
-									temp_index=1;
-									temp_index_b=2;
-								}
-								break;
-							}
-						case 0x06:	//AB
-						case 0x07:	//ABC
-							{
-								temp_index=jindex;
-								temp_index_b=jindex;
-								break;
-							}
-						default:
-							break;
-					}//end case
+		//If we're in PF_DYNINIT mode, initialize the balancing convergence
+		if (powerflow_type == PF_DYNINIT)
+		{
+			swing_converged = true;	//init it to yes, fail by exception, not default
+		}
 
-					if ((temp_index==-1) || (temp_index_b==-1))
-					{
-						GL_THROW("NR: A Jacobian update element failed.");
-						//Defined below
-					}
+		//Compute the calculated loads (not specified) at each bus
+		bus_pass.Iteration = Iteration;
+		bus_pass.swing_converged = swing_converged;
+		NR_run_ranges(NR_range_mismatch,&bus_pass,bus_count,n_threads);
+		swing_converged = bus_pass.swing_converged;
 
-					//Accumulate the values
-					bus[indexer].Jacob_A[temp_index] += bus[indexer].full_Y_load[temp_index_b].Im();
-					bus[indexer].Jacob_B[temp_index] += bus[indexer].full_Y_load[temp_index_b].Re();
-					bus[indexer].Jacob_C[temp_index] += bus[indexer].full_Y_load[temp_index_b].Re();
-					bus[indexer].Jacob_D[temp_index] -= bus[indexer].full_Y_load[temp_index_b].Im();
-				}//End phase traversion
-			}//End deltamode-enabled in-rush loads updates
-		}//end bus traversion for a,b,c, d value computation
+		// Calculate the elements of a,b,c,d in equations(14),(15),(16),(17). These elements are used to update the Jacobian matrix.	
+		NR_run_ranges(NR_range_jacobian,&bus_pass,bus_count,n_threads);
 
 		//Build the dynamic diagnal elements of 6n*6n Y matrix. All the elements in this part will be updated at each iteration.
 		unsigned int size_diag_update = 0;
@@ -5053,7 +5755,7 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
 
 			//Initiliaze it
-			sparse_init(powerflow_values->Y_Amatrix, size_Amatrix, 6*NR_bus_count);
+			sparse_init(powerflow_values->Y_Amatrix, size_Amatrix, 6*bus_count);
 		}
 		else if (powerflow_values->NR_realloc_needed)	//If one of the above changed, we changed too
 		{
@@ -5061,12 +5763,12 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 			sparse_clear(powerflow_values->Y_Amatrix);
 
 			//Create a new 
-			sparse_init(powerflow_values->Y_Amatrix, size_Amatrix, 6*NR_bus_count);
+			sparse_init(powerflow_values->Y_Amatrix, size_Amatrix, 6*bus_count);
 		}
 		else
 		{
 			//Just clear it out
-			sparse_reset(powerflow_values->Y_Amatrix, 6*NR_bus_count);
+			sparse_reset(powerflow_values->Y_Amatrix, 6*bus_count);
 		}
 
 		//integrate off diagonal components
@@ -5249,7 +5951,7 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 			else if (matrix_solver_method == MM_EXTERN)	//External routine
 			{
 				//Run allocation routine
-				((void (*)(void *,unsigned int, unsigned int, bool))(LUSolverFcns.ext_alloc))(ext_solver_glob_vars,n,n,NR_admit_change);
+				((void (*)(void *,unsigned int, unsigned int, bool))(LUSolverFcns.ext_alloc))(ext_solver_glob_vars,n,n,admit_change);
 			}
 			else
 			{
@@ -5322,7 +6024,7 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 			else if (matrix_solver_method == MM_EXTERN)	//External routine
 			{
 				//Run allocation routine
-				((void (*)(void *,unsigned int, unsigned int, bool))(LUSolverFcns.ext_alloc))(ext_solver_glob_vars,n,n,NR_admit_change);
+				((void (*)(void *,unsigned int, unsigned int, bool))(LUSolverFcns.ext_alloc))(ext_solver_glob_vars,n,n,admit_change);
 			}
 			else
 			{
@@ -5346,7 +6048,7 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 			else if (matrix_solver_method == MM_EXTERN)	//External routine - call full reallocation, just in case
 			{
 				//Run allocation routine
-				((void (*)(void *,unsigned int, unsigned int, bool))(LUSolverFcns.ext_alloc))(ext_solver_glob_vars,n,n,NR_admit_change);
+				((void (*)(void *,unsigned int, unsigned int, bool))(LUSolverFcns.ext_alloc))(ext_solver_glob_vars,n,n,admit_change);
 			}
 			else
 			{
@@ -5367,6 +6069,10 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 		//Default else - not superLU
 #endif
 		
+		//Everything up to here builds the mismatch and Jacobian
+		gl_instrument_span("nr_assembly",IC_SOLVER,instrument_t);
+		instrument_t = gl_instrument_now();
+
 		sparse_tonr(powerflow_values->Y_Amatrix, &matrices_LU);
 		matrices_LU.cols_LU[n] = nnz ;// number of non-zeros;
 
@@ -5626,11 +6332,11 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 #ifdef MT
 				//superLU_MT commands
 
-				//Populate perm_c
+				//Populate perm_c and solve the system
+				pthread_mutex_lock(&NR_lu_lock);
 				get_perm_c(1, &A_LU, perm_c);
-
-				//Solve the system
 				pdgssv(NR_superLU_procs, &A_LU, perm_c, perm_r, &L_LU, &U_LU, &B_LU, &info);
+				pthread_mutex_unlock(&NR_lu_lock);
 #else
 				//sequential superLU
 
@@ -5684,132 +6390,18 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 			*/
 		}
 
-		//Update bus voltages - check convergence while we're here
-		Maxmismatch = 0;
-
-		temp_index = -1;
-		temp_index_b = -1;
-		newiter = false;	//Reset iteration requester flag - defaults to not needing another
-
-		for (indexer=0; indexer<bus_count; indexer++)
-		{
-			//Avoid swing bus updates on normal runs
-			if ((bus[indexer].type == 0) || ((bus[indexer].type > 1) && (bus[indexer].swing_functions_enabled == false)))
-			{
-				//Figure out the offset we need to be for each phase
-				if ((bus[indexer].phases & 0x80) == 0x80)	//Split phase
-				{
-					//Pull the two updates (assume split-phase is always 2)
-					DVConvCheck[0]=complex(sol_LU[2*bus[indexer].Matrix_Loc],sol_LU[(2*bus[indexer].Matrix_Loc+2)]);
-					DVConvCheck[1]=complex(sol_LU[(2*bus[indexer].Matrix_Loc+1)],sol_LU[(2*bus[indexer].Matrix_Loc+3)]);
-					bus[indexer].V[0] += DVConvCheck[0];
-					bus[indexer].V[1] += DVConvCheck[1];	//Negative due to convention
-					
-					//Pull off the magnitude (no sense calculating it twice)
-					CurrConvVal=DVConvCheck[0].Mag();
-					if (CurrConvVal > Maxmismatch)	//Update our convergence check if it is bigger
-						Maxmismatch=CurrConvVal;
-
-					if (CurrConvVal > bus[indexer].max_volt_error)	//Check for convergence
-						newiter=true;								//Flag that a new iteration must occur
-
-					CurrConvVal=DVConvCheck[1].Mag();
-					if (CurrConvVal > Maxmismatch)	//Update our convergence check if it is bigger
-						Maxmismatch=CurrConvVal;
-
-					if (CurrConvVal > bus[indexer].max_volt_error)	//Check for convergence
-						newiter=true;								//Flag that a new iteration must occur
-				}//end split phase update
-				else										//Not split phase
-				{
-					for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)	//parse through the phases
-					{
-						switch(bus[indexer].phases & 0x07) {
-							case 0x01:	//C
-								{
-									temp_index=0;
-									temp_index_b=2;
-									break;
-								}
-							case 0x02:	//B
-								{
-									temp_index=0;
-									temp_index_b=1;
-									break;
-								}
-							case 0x03:	//BC
-								{
-									if (jindex==0)	//B
-									{
-										temp_index=0;
-										temp_index_b=1;
-									}
-									else			//C
-									{
-										temp_index=1;
-										temp_index_b=2;
-									}
-
-									break;
-								}
-							case 0x04:	//A
-								{
-									temp_index=0;
-									temp_index_b=0;
-									break;
-								}
-							case 0x05:	//AC
-								{
-									if (jindex==0)	//A
-									{
-										temp_index=0;
-										temp_index_b=0;
-									}
-									else			//C
-									{
-										temp_index=1;
-										temp_index_b=2;
-									}
-									break;
-								}
-							case 0x06:	//AB
-							case 0x07:	//ABC
-								{
-									temp_index = jindex;
-									temp_index_b = jindex;
-									break;
-								}
-						}//end phase switch/case
-
-						if ((temp_index==-1) || (temp_index_b==-1))
-						{
-							GL_THROW("NR: An error occurred indexing voltage updates");
-							/*  TROUBLESHOOT
-							While attempting to create the voltage update indices for the
-							Newton-Raphson solver, an error was encountered.  Please submit
-							your code and a bug report using the trac website.
-							*/
-						}
+		//Factorization and solve are a single call for superLU
+		gl_instrument_span("nr_solve",IC_SOLVER,instrument_t);
+		instrument_t = gl_instrument_now();
 
-						DVConvCheck[jindex]=complex(sol_LU[(2*bus[indexer].Matrix_Loc+temp_index)],sol_LU[(2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size+temp_index)]);
-						bus[indexer].V[temp_index_b] += DVConvCheck[jindex];
-						
-						//Pull off the magnitude (no sense calculating it twice)
-						CurrConvVal=DVConvCheck[jindex].Mag();
-						if (CurrConvVal > bus[indexer].max_volt_error)	//Check for convergence
-							newiter=true;								//Flag that a new iteration must occur
-
-						if (CurrConvVal > Maxmismatch)	//See if the current differential is the largest found so far or not
-							Maxmismatch = CurrConvVal;	//It is, store it
-
-					}//End For loop for phase traversion
-				}//End not split phase update
-			}//end if not swing
-			else	//So this must be the swing and in a valid interval
-			{
-				temp_index +=2*powerflow_values->BA_diag[indexer].size;	//Increment us for what this bus would have been had it not been a swing
-			}
-		}//End bus traversion
+		//Update bus voltages - check convergence while we're here
+		bus_pass.sol_LU = sol_LU;
+		bus_pass.Maxmismatch = 0.0;
+		bus_pass.newiter = false;	//Reset iteration requester flag - defaults to not needing another
+		NR_run_ranges(NR_range_update,&bus_pass,bus_count,n_threads);
+		Maxmismatch = bus_pass.Maxmismatch;
+		newiter = bus_pass.newiter;
+		gl_instrument_span("nr_update",IC_SOLVER,instrument_t);
 
 		//Perform saturation current update/convergence check
 		//******************** FIGURE OUT HOW TO DO THIS BETTER - This is very inefficient!***********************//
@@ -127,6 +127,8 @@ typedef struct {
 	Y_NR *Y_diag_fixed;					///Y_diag_fixed store the row,column and value of fixed diagonal elements of 6n*6n Y_NR matrix. No PV bus is included.
 	Y_NR *Y_diag_update;				///Y_diag_update store the row,column and value of updated diagonal elements of 6n*6n Y_NR matrix at each iteration. No PV bus is included.
 	SPARSE *Y_Amatrix;					///Y_Amatrix store all the elements of Amatrix in equation AX=B;
+	bool admit_stale;					///Admittance structures are out of date and must be rebuilt on the next solve (e.g., islands were solved separately)
+	struct s_nr_lu *LU;					///LU solver working storage of this system (allocated by solver_nr)
 } NR_SOLVER_STRUCT;
 
 //Mesh-fault-related structure - passing information
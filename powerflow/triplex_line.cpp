@@ -227,6 +227,8 @@ void triplex_line::recalc(void)
 		complex zp11,zp22,zp33,zp12,zp13,zp23;
 		complex zs[3][3];
 		double freq_coeff_real, freq_coeff_imag, freq_additive_term;
+		LINEIMPEDANCE imp, *per_mile;
+		unsigned int n = 0;
 
 		//Calculate coefficients for self and mutual impedance - incorporates frequency values
 		//Per Kersting (4.39) and (4.40) - coefficients end up same as OHLs
@@ -284,65 +286,91 @@ void triplex_line::recalc(void)
 			*/
 		}
 
-		zp11 = complex(r1,0) + freq_coeff_real + complex(0.0,freq_coeff_imag) * (log(1/gmr1) + freq_additive_term);
-		zp22 = complex(r2,0) + freq_coeff_real + complex(0.0,freq_coeff_imag) * (log(1/gmr2) + freq_additive_term);
-		zp33 = complex(rn,0) + freq_coeff_real + complex(0.0,freq_coeff_imag) * (log(1/gmrn) + freq_additive_term);
-		zp12 = complex(freq_coeff_real,0.0) + complex(0.0,freq_coeff_imag) * (log(1/D12) + freq_additive_term);
-		zp13 = complex(freq_coeff_real,0.0) + complex(0.0,freq_coeff_imag) * (log(1/D13) + freq_additive_term);
-		zp23 = complex(freq_coeff_real,0.0) + complex(0.0,freq_coeff_imag) * (log(1/D23) + freq_additive_term);
-		
-		if (solver_method==SM_FBS)
-		{
-			zs[0][0] = zp11-((zp13*zp13)/zp33);
-			zs[0][1] = zp12-((zp13*zp23)/zp33);
-			zs[1][0] = -(zp12-((zp13*zp23)/zp33));
-			zs[1][1] = -(zp22-((zp23*zp23)/zp33));
-			zs[0][2] = complex(0,0);
-			zs[1][2] = complex(0,0);
-			zs[2][2] = complex(0,0);
-			zs[2][1] = complex(0,0);
-			zs[2][0] = complex(0,0);
-		}
-		else if (solver_method==SM_GS)
+		//Lines with the same configuration and frequency share the per-mile values - only the first one computes them
+		memset(&imp,0,sizeof(LINEIMPEDANCE));
+		imp.key[n++] = 3;	//triplex_line
+		imp.key[n++] = (double)solver_method;
+		imp.key[n++] = (enable_frequency_dependence == true) ? current_frequency : nominal_frequency;
+		imp.key[n++] = r1;
+		imp.key[n++] = r2;
+		imp.key[n++] = rn;
+		imp.key[n++] = gmr1;
+		imp.key[n++] = gmr2;
+		imp.key[n++] = gmrn;
+		imp.key[n++] = D12;
+		imp.key[n++] = D13;
+		imp.key_size = n;
+
+		per_mile = find_impedance(&imp);
+		if (per_mile == NULL)
 		{
-			zs[0][0] = zp11;
-			zs[0][1] = zp12;
-			zs[0][2] = zp13;
-			zs[1][0] = zp12;
-			zs[1][1] = zp22;
-			zs[1][2] = zp23;
-			zs[2][0] = zp13;
-			zs[2][1] = zp23;
-			zs[2][2] = zp33;
+			zp11 = complex(r1,0) + freq_coeff_real + complex(0.0,freq_coeff_imag) * (log(1/gmr1) + freq_additive_term);
+			zp22 = complex(r2,0) + freq_coeff_real + complex(0.0,freq_coeff_imag) * (log(1/gmr2) + freq_additive_term);
+			zp33 = complex(rn,0) + freq_coeff_real + complex(0.0,freq_coeff_imag) * (log(1/gmrn) + freq_additive_term);
+			zp12 = complex(freq_coeff_real,0.0) + complex(0.0,freq_coeff_imag) * (log(1/D12) + freq_additive_term);
+			zp13 = complex(freq_coeff_real,0.0) + complex(0.0,freq_coeff_imag) * (log(1/D13) + freq_additive_term);
+			zp23 = complex(freq_coeff_real,0.0) + complex(0.0,freq_coeff_imag) * (log(1/D23) + freq_additive_term);
+			
+			if (solver_method==SM_FBS)
+			{
+				zs[0][0] = zp11-((zp13*zp13)/zp33);
+				zs[0][1] = zp12-((zp13*zp23)/zp33);
+				zs[1][0] = -(zp12-((zp13*zp23)/zp33));
+				zs[1][1] = -(zp22-((zp23*zp23)/zp33));
+				zs[0][2] = complex(0,0);
+				zs[1][2] = complex(0,0);
+				zs[2][2] = complex(0,0);
+				zs[2][1] = complex(0,0);
+				zs[2][0] = complex(0,0);
+			}
+			else if (solver_method==SM_GS)
+			{
+				zs[0][0] = zp11;
+				zs[0][1] = zp12;
+				zs[0][2] = zp13;
+				zs[1][0] = zp12;
+				zs[1][1] = zp22;
+				zs[1][2] = zp23;
+				zs[2][0] = zp13;
+				zs[2][1] = zp23;
+				zs[2][2] = zp33;
 
+			}
+			else if (solver_method==SM_NR)
+			{
+				//Inverted
+				complex tempval = (-zp11*zp33*zp22+zp11*zp23*zp23+zp13*zp13*zp22+zp12*zp12*zp33-complex(2.0,0)*zp12*zp13*zp23);
+
+				zs[0][0] = -(zp22*zp33-zp23*zp23)/tempval;
+				zs[0][1] = (-zp12*zp33+zp13*zp23)/tempval;
+				zs[1][0] = -(-zp12*zp33+zp13*zp23)/tempval;
+				zs[1][1] = -(-zp11*zp33+zp13*zp13)/tempval;
+
+				zs[0][2] = 0.0;
+				zs[1][2] = 0.0;
+				zs[2][2] = 0.0;
+				zs[2][1] = 0.0;
+				zs[2][0] = 0.0;
+			}
+			else
+			{
+				throw "unsupported solver method";
+			}
+
+			//Neutral current coefficients
+			imp.t[0] = -zp13/zp33;
+			imp.t[1] = -zp23/zp33;
+			imp.t[2] = 0;
+
+			equalm(zs, imp.z);
+			per_mile = add_impedance(&imp);
 		}
-		else if (solver_method==SM_NR)
-		{
-			//Inverted
-			complex tempval = (-zp11*zp33*zp22+zp11*zp23*zp23+zp13*zp13*zp22+zp12*zp12*zp33-complex(2.0,0)*zp12*zp13*zp23);
-
-			zs[0][0] = -(zp22*zp33-zp23*zp23)/tempval;
-			zs[0][1] = (-zp12*zp33+zp13*zp23)/tempval;
-			zs[1][0] = -(-zp12*zp33+zp13*zp23)/tempval;
-			zs[1][1] = -(-zp11*zp33+zp13*zp13)/tempval;
-
-			zs[0][2] = 0.0;
-			zs[1][2] = 0.0;
-			zs[2][2] = 0.0;
-			zs[2][1] = 0.0;
-			zs[2][0] = 0.0;
-		}
-		else
-		{
-			throw "unsupported solver method";
-		}
+		equalm(per_mile->z, zs);
 
-		
-		
 		if (solver_method==SM_FBS) {
-			tn[0] = -zp13/zp33;
-			tn[1] = -zp23/zp33;
-			tn[2] = 0;
+			tn[0] = per_mile->t[0];
+			tn[1] = per_mile->t[1];
+			tn[2] = per_mile->t[2];
 
 			multiply(length/5280.0,zs,b_mat); // Length comes in ft, convert to miles.
 			multiply(length/5280.0,zs,B_mat);
@@ -355,9 +383,9 @@ void triplex_line::recalc(void)
 		else if (solver_method == SM_NR)
 		{
 			//Copied from SM_FBS - used for extra current flow (not used in any powerflow convergence calculations)
-			tn[0] = -zp13/zp33;
-			tn[1] = -zp23/zp33;
-			tn[2] = 0;
+			tn[0] = per_mile->t[0];
+			tn[1] = per_mile->t[1];
+			tn[2] = per_mile->t[2];
 
 			multiply(1/(length/5280.0),zs,b_mat); // Length comes in ft, convert to miles.
 			multiply(1/(length/5280.0),zs,B_mat); // We're in admittance form now, so multiply by 1/L.
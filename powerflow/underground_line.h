@@ -19,6 +19,8 @@ public:
 	int create(void);
 private:
 	void test_phases(line_configuration *config, const char ph);
+	void impedance_key(line_configuration *config, LINEIMPEDANCE *imp);
+	void calc_impedance(line_configuration *config, LINEIMPEDANCE *imp);
 };
 
 EXPORT int create_fault_ugline(OBJECT *thisobj, OBJECT **protect_obj, char *fault_type, int *implemented_fault, TIMESTAMP *repair_time, void *Extra_Data);
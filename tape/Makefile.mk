@@ -7,6 +7,8 @@ tape_tape_la_LDFLAGS =
 tape_tape_la_LDFLAGS += $(AM_LDFLAGS)
 
 tape_tape_la_LIBADD = -ldl
+tape_tape_la_LIBADD += $(PTHREAD_CFLAGS)
+tape_tape_la_LIBADD += $(PTHREAD_LIBS)
 
 tape_tape_la_SOURCES =
 tape_tape_la_SOURCES += tape/collector.c
@@ -27,6 +29,8 @@ tape_tape_la_SOURCES += tape/multi_recorder.c
 tape_tape_la_SOURCES += tape/odbc.c
 tape_tape_la_SOURCES += tape/odbc.h
 tape_tape_la_SOURCES += tape/player.c
+tape_tape_la_SOURCES += tape/quantile.cpp
+tape_tape_la_SOURCES += tape/quantile.h
 tape_tape_la_SOURCES += tape/recorder.c
 tape_tape_la_SOURCES += tape/shaper.c
 tape_tape_la_SOURCES += tape/tape.c
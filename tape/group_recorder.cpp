@@ -8,6 +8,30 @@ void new_group_recorder(MODULE *mod){
 	new group_recorder(mod);
 }
 
+/**
+	@return the number of bytes staged for a value of the type, or 0 if the value must be formatted when it is read
+ **/
+static size_t get_stage_size(PROPERTYTYPE ptype){
+	switch(ptype){
+		case PT_double: return sizeof(double);
+		case PT_complex: return sizeof(complex);
+		case PT_enumeration: return sizeof(enumeration);
+		case PT_set: return sizeof(set);
+		case PT_int16: return sizeof(int16);
+		case PT_int32: return sizeof(int32);
+		case PT_int64: return sizeof(int64);
+		case PT_char8: return sizeof(char8);
+		case PT_char32: return sizeof(char32);
+		case PT_char256: return sizeof(char256);
+		case PT_char1024: return sizeof(char1024);
+		case PT_object: return sizeof(OBJECT *);
+		case PT_bool: return sizeof(bool);
+		case PT_timestamp: return sizeof(TIMESTAMP);
+		case PT_float: return sizeof(float);
+		default: return 0;
+	}
+}
+
 group_recorder::group_recorder(MODULE *mod){
 	if(oclass == NULL)
 		{
@@ -49,6 +73,7 @@ int group_recorder::create(){
 
 int group_recorder::init(OBJECT *obj){
 	OBJECT *gr_obj = 0;
+	int i = 0;
 
 	// check for group
 	if(0 == group_def[0]){
@@ -142,9 +167,23 @@ int group_recorder::init(OBJECT *obj){
 		}
 	}
 
-	// turn list into objlist, count items
+	// resolve the recorded property of every member, count items
+	member_obj = (OBJECT **)malloc(sizeof(OBJECT *) * items->hit_count);
+	member_addr = (void **)malloc(sizeof(void *) * items->hit_count);
+	member_prop = (PROPERTY *)malloc(sizeof(PROPERTY) * items->hit_count);
+	member_kind = (int *)malloc(sizeof(int) * items->hit_count);
+	member_offset = (size_t *)malloc(sizeof(size_t) * items->hit_count);
+	if(0 == member_obj || 0 == member_addr || 0 == member_prop || 0 == member_kind || 0 == member_offset){
+		gl_error("group_recorder::init(): malloc failure");
+		/* TROUBLESHOOT
+			Memory allocation failure.
+		*/
+		return 0;
+	}
 	obj_count = 0;
-	for(gr_obj = gl_find_next(items, 0); gr_obj != 0; gr_obj = gl_find_next(items, gr_obj) ){
+	stage_size = 0;
+	for(gr_obj = gl_find_next(items, 0); gr_obj != 0 && obj_count < items->hit_count; gr_obj = gl_find_next(items, gr_obj) ){
+		size_t size = 0;
 		prop_ptr = gl_get_property(gr_obj, property_name.get_string());
 		// might make this a 'strict-only' issue in the future
 		if(prop_ptr == NULL){
@@ -154,20 +193,43 @@ int group_recorder::init(OBJECT *obj){
 			 */
 			return 0;
 		}
-		++obj_count;
-		if(obj_list == 0){
-			obj_list = new quickobjlist(gr_obj, prop_ptr);
+		member_obj[obj_count] = gr_obj;
+		member_addr[obj_count] = GETADDR(gr_obj, prop_ptr);
+		memcpy(member_prop+obj_count, prop_ptr, sizeof(PROPERTY));
+		// check if we should expunge the units from our copied PROP structs
+		if(!print_units){
+			member_prop[obj_count].unit = NULL;
+		}
+		if(prop_ptr->ptype == PT_complex && complex_part != NONE){
+			member_kind[obj_count] = GR_PART;
+			size = sizeof(double);
+		} else if(0 < (size = get_stage_size(prop_ptr->ptype))){
+			member_kind[obj_count] = GR_RAW;
 		} else {
-			obj_list->tack(gr_obj, prop_ptr);
+			member_kind[obj_count] = GR_TEXT;
+			size = GR_TEXTSIZE;
 		}
+		member_offset[obj_count] = stage_size;
+		stage_size += (size + 7) & ~7; // keep the staged values aligned
+		++obj_count;
 	}
 
-	// check if we should expunge the units from our copied PROP structs
-	if(!print_units){
-		quickobjlist *itr = obj_list;
-		for(; itr != 0; itr = itr->next){
-			itr->prop.unit = NULL;
+	// allocate the staged lines
+	for(i = 0; i < GR_QUEUESIZE; ++i){
+		queue[i].stage = (char *)malloc(stage_size);
+		if(0 == queue[i].stage){
+			gl_error("group_recorder::init(): malloc failure");
+			return 0;
+		}
+		memset(queue[i].stage, 0, stage_size);
+	}
+	if(-1 == write_interval){ // 'on change', will need the last line written
+		prev_stage = (char *)malloc(stage_size);
+		if(0 == prev_stage){
+			gl_error("group_recorder::init(): malloc failure");
+			return 0;
 		}
+		memset(prev_stage, 0, stage_size);
 	}
 
 	tape_status = TS_OPEN;
@@ -180,6 +242,8 @@ int group_recorder::init(OBJECT *obj){
 		return 0;
 	}
 	
+	// lines are formatted and written by a writer thread
+	start_writer();
 
 	return 1;
 }
@@ -187,9 +251,12 @@ int group_recorder::init(OBJECT *obj){
 TIMESTAMP group_recorder::postsync(TIMESTAMP t0, TIMESTAMP t1){
 	// if we are strict and an error has occured, stop the simulation
 
+	GRLINE *line = 0;
+
 	// if eventful interval, read
 	if(0 == write_interval){//
-		if(0 == read_line()){
+		line = next_line();
+		if(0 == read_line(line->stage)){
 			gl_error("group_recorder::sync");
 			/* TROUBLESHOOT
 				Placeholder.
@@ -210,18 +277,13 @@ TIMESTAMP group_recorder::postsync(TIMESTAMP t0, TIMESTAMP t1){
 	}
 	// if every iteration, write
 	if(0 == write_interval){
-		if(0 == write_line(t1) ){
+		if(0 == queue_line(line, t1, flush_interval < 0 && ((write_count + 2) % (-flush_interval)) == 0) ){
 			gl_error("group_recorder::sync(): error when writing the values to the file");
 			/* TROUBLESHOOT
 				Placeholder.
 			 */
 			return 0;
 		}
-		if(flush_interval < 0){
-			if( ((write_count + 1) % (-flush_interval)) == 0 ){
-				flush_line();
-			}
-		}
 	}
 	
 	// the interval recorders have already return'ed out, earlier in the sequence.
@@ -229,6 +291,11 @@ TIMESTAMP group_recorder::postsync(TIMESTAMP t0, TIMESTAMP t1){
 }
 
 int group_recorder::commit(TIMESTAMP t1){
+	GRLINE *line = 0;
+
+	// report errors of the writer thread
+	check_writer();
+
 	// short-circuit if strict & error
 	if((TS_ERROR == tape_status) && strict){
 		gl_error("group_recorder::commit(): the object has error'ed and is halting the simulation");
@@ -247,11 +314,12 @@ int group_recorder::commit(TIMESTAMP t1){
 	// if periodic interval, check for write
 	if(write_interval > 0){
 		if(interval_write){
-			if(0 == read_line()){
+			line = next_line();
+			if(0 == read_line(line->stage)){
 				gl_error("group_recorder::commit(): error when reading the values");
 				return 0;
 			}
-			if(0 == write_line(t1)){
+			if(0 == queue_line(line, t1, false)){
 				gl_error("group_recorder::commit(): error when writing the values to the file");
 				return 0;
 			}
@@ -264,19 +332,18 @@ int group_recorder::commit(TIMESTAMP t1){
 	//	* compare to last values
 	//	* if different, write
 	if(-1 == write_interval){
-		if(0 == read_line()){
-			if(0 == read_line()){
-				gl_error("group_recorder::commit(): error when reading the values");
+		line = next_line();
+		if(0 == read_line(line->stage)){
+			gl_error("group_recorder::commit(): error when reading the values");
+			return 0;
+		}
+		if(0 == write_count || 0 != memcmp(line->stage, prev_stage, stage_size) ){
+			memcpy(prev_stage, line->stage, stage_size);
+			if(0 == queue_line(line, t1, false)){
+				gl_error("group_recorder::commit(): error when writing the values to the file");
 				return 0;
 			}
-			if(0 != strcmp(line_buffer, prev_line_buffer) ){
-				if(0 == write_line(t1)){
-					gl_error("group_recorder::commit(): error when writing the values to the file");
-					return 0;
-				}
-			}
 		}
-
 	}
 
 	// if periodic flush, check for flush
@@ -292,14 +359,17 @@ int group_recorder::commit(TIMESTAMP t1){
 
 	// check if write limit
 	if(limit > 0 && write_count >= limit){
-		// write footer
-		write_footer();
+		// write footer once the queued lines are written
+		stop_writer();
+		if(check_writer()){
+			write_footer();
+			tape_status = TS_DONE;
+		}
 		fclose(rec_file);
 		rec_file = 0;
 		free(line_buffer);
 		line_buffer = 0;
 		line_size = 0;
-		tape_status = TS_DONE;
 	}
 
 	// check if strict & error ... a second time in case the periodic behavior failed.
@@ -315,6 +385,24 @@ int group_recorder::commit(TIMESTAMP t1){
 	return 1;
 }
 
+/**
+	Writes the lines still queued when the simulation ends.
+	@return 0 on failure, 1 on success
+ **/
+int group_recorder::finalize(OBJECT *obj){
+	stop_writer();
+	if(TS_OPEN != tape_status){
+		return 1;
+	}
+	if(0 == check_writer()){
+		return 0;
+	}
+	if(0 != rec_file){
+		fflush(rec_file);
+	}
+	return 1;
+}
+
 int group_recorder::isa(char *classname){
 	return (strcmp(classname, oclass->name) == 0);
 }
@@ -325,7 +413,7 @@ int group_recorder::isa(char *classname){
 int group_recorder::write_header(){
 //	size_t name_size;
 	time_t now = time(NULL);
-	quickobjlist *qol = 0;
+	int n = 0;
 	OBJECT *obj=OBJECTHDR(this);
 
 	if(TS_OPEN != tape_status){
@@ -359,198 +447,352 @@ int group_recorder::write_header(){
 
 	// write list of properties
 	if(0 > fprintf(rec_file, "# timestamp")){ return 0; }
-	for(qol = obj_list; qol != 0; qol = qol->next){
-		if(0 != qol->obj->name){
-			if(0 > fprintf(rec_file, ",%s", qol->obj->name)){ return 0; }
+	for(n = 0; n < obj_count; ++n){
+		if(0 != member_obj[n]->name){
+			if(0 > fprintf(rec_file, ",%s", member_obj[n]->name)){ return 0; }
 		} else {
-			if(0 > fprintf(rec_file, ",%s:%i", qol->obj->oclass->name, qol->obj->id)){ return 0; }
+			if(0 > fprintf(rec_file, ",%s:%i", member_obj[n]->oclass->name, member_obj[n]->id)){ return 0; }
 		}
 	}
 	if(0 > fprintf(rec_file, "\n")){ return 0; }
 	return 1;
 }
 
+typedef struct s_grread {
+	group_recorder *gr;
+	char *stage;
+	int failed;		// lowest member that could not be read, -1 if none
+	pthread_mutex_t lock;
+} GRREAD;
+
+TIMESTAMP group_recorder::read_task(TPTASK *task, unsigned int first, unsigned int last, unsigned int thread){
+	GRREAD *read = (GRREAD *)task->data;
+	int failed = read->gr->read_range(read->stage, (int)first, (int)last);
+	if(failed >= 0){
+		pthread_mutex_lock(&read->lock);
+		if(read->failed < 0 || failed < read->failed){
+			read->failed = failed;
+		}
+		pthread_mutex_unlock(&read->lock);
+	}
+	return TS_NEVER;
+}
+
 /**
+	Copies the values of members first to last-1 into a staged line.
+	@return -1 on success, the index of the member that could not be read on failure
+ **/
+int group_recorder::read_range(char *stage, int first, int last){
+	int n = 0;
+
+	for(n = first; n < last; ++n){
+		char *value = stage + member_offset[n];
+		switch(member_kind[n]){
+			case GR_RAW:
+				memcpy(value, member_addr[n], get_stage_size(member_prop[n].ptype));
+				break;
+			case GR_PART:
+				{
+					complex *cptr = (complex *)member_addr[n];
+					double part_value = 0.0;
+					switch(complex_part){
+						case REAL:
+							part_value = cptr->Re();
+							break;
+						case IMAG:
+							part_value = cptr->Im();
+							break;
+						case MAG:
+							part_value = cptr->Mag();
+							break;
+						case ANG:
+							part_value = cptr->Arg() * 180/PI;
+							break;
+						case ANG_RAD:
+							part_value = cptr->Arg();
+							break;
+						default:
+							return n;
+					}
+					memcpy(value, &part_value, sizeof(double));
+				}
+				break;
+			case GR_TEXT:
+				memset(value, 0, GR_TEXTSIZE);
+				if(0 == gl_get_value(member_obj[n], member_addr[n], value, GR_TEXTSIZE-1, member_prop+n)){
+					return n;
+				}
+				break;
+		}
+	}
+	return -1;
+}
+
+/**
+	Copies the values of all the members into a staged line, in chunks on the core pool threads for large groups.
 	@return 0 on failure, 1 on success
  **/
-int group_recorder::read_line(){
-	size_t index = 0, offset = 0, unit_len = 0;
-	quickobjlist *curr = 0;
-	char *swap_ptr = 0;
-	char buffer[128];
+int group_recorder::read_line(char *stage){
 	char objname[128];
+	int failed = -1;
 
 	if(TS_OPEN != tape_status){
 		// could be ERROR or CLOSED
 		return 0;
 	}
 
-	// pre-calculate buffer needs
-	if(line_size <= 0 || line_buffer == 0){
-		size_t prop_size;
-		
-		// in v2.3, there's no measure of the property's string representation size.
-		//	this value *is* present in 3.0.
-		prop_size = 48;
+	if(obj_count < 2 * GR_MINITEMS || gl_pool_threadcount() < 2){
+		failed = read_range(stage, 0, obj_count);
+	} else {
+		GRREAD read;
+		TPTASK task, *run = &task;
+		read.gr = this;
+		read.stage = stage;
+		read.failed = -1;
+		pthread_mutex_init(&read.lock, NULL);
+		memset(&task, 0, sizeof(task));
+		task.name = "group_recorder read";
+		task.call = read_task;
+		task.data = (void *)&read;
+		task.n_items = obj_count;
+		task.grain = GR_MINITEMS;
+		gl_pool_run(&run, 1);
+		pthread_mutex_destroy(&read.lock);
+		failed = read.failed;
+	}
+
+	if(failed >= 0){
+		gl_error("group_recorder::read_line(): unable to get value for '%s' in object '%s'", member_prop[failed].name, gl_name(member_obj[failed], objname, 127));
+		/* TROUBLESHOOT
+			An error occured while reading the specified property in one of the objects.
+		 */
+		return 0;
+	}
+	return 1;
+}
+
+/**
+	Returns the next free staged line, waiting for the writer if all of them are queued.
+ **/
+GRLINE *group_recorder::next_line(){
+	GRLINE *line = 0;
+	if(!writer_running){
+		return queue;
+	}
+	pthread_mutex_lock(&writer_lock);
+	while(queue_count == GR_QUEUESIZE){
+		pthread_cond_wait(&writer_space, &writer_lock);
+	}
+	line = queue + (queue_head + queue_count) % GR_QUEUESIZE;
+	pthread_mutex_unlock(&writer_lock);
+	line->flush = false;
+	return line;
+}
 
-		line_size = (prop_size + 1) * obj_count + 1;
-		line_buffer = (char *)malloc(line_size);
-		if(0 == line_buffer){
+/**
+	Hands a staged line to the writer, or writes it directly when there is no writer thread.
+	The line is only written if a time is given; otherwise it only flushes the file.
+	@return 0 on failure, 1 on success
+ **/
+int group_recorder::queue_line(GRLINE *line, TIMESTAMP t1, bool flush){
+	DATETIME dt;
+
+	line->flush = flush;
+	line->time_str[0] = 0;
+	if(TS_NEVER != t1){
+		// write time_str
+		// recorder.c uses multiple formats, in the sense of "formatted or not".  This does not.
+		if(0 == gl_localtime(t1, &dt)){
+			gl_error("group_recorder::write_line(): error when converting the sync time");
+			/* TROUBLESHOOT
+				Unprintable timestamp.
+			 */
+			tape_status = TS_ERROR;
 			return 0;
 		}
-		memset(line_buffer, 0, line_size);
-		if(-1 == write_interval){ // 'on change', will need second buffer
-			prev_line_buffer = (char *)malloc(line_size);
-			if(0 == prev_line_buffer){
-				gl_error("group_recorder::read_line(): malloc failure");
-				/* TROUBLESHOOT
-					Memory allocation failure.
-				*/
-				return 0;
-			}
-			memset(prev_line_buffer, 0, line_size);
+		if(0 == gl_strtime(&dt, line->time_str, sizeof(line->time_str) ) ){
+			gl_error("group_recorder::write_line(): error when writing the sync time as a string");
+			/* TROUBLESHOOT
+				Error printing the timestamp.
+			 */
+			tape_status = TS_ERROR;
+			return 0;
 		}
+		++write_count;
 	}
 
-	// if we need the previous buffer to compare against, swap the buffers
-	if(-1 == write_interval){
-		swap_ptr = prev_line_buffer;
-		prev_line_buffer = line_buffer;
-		line_buffer = swap_ptr;
-	}
-	memset(line_buffer, 0, line_size);
-	for(curr = obj_list; curr != 0; curr = curr->next){
-		// GETADDR is a macro defined in object.h
-		if(curr->prop.ptype == PT_complex && complex_part != NONE){
-			double part_value = 0.0;
-			complex *cptr = 0;
-			// get value as a complex
-			cptr = gl_get_complex(curr->obj, &(curr->prop));
-			if(0 == cptr){
-				gl_error("group_recorder::read_line(): unable to get complex property '%s' from object '%s'", curr->prop.name, gl_name(curr->obj, objname, 127));
-				/* TROUBLESHOOT
-					Could not read a complex property as a complex value.
-				 */
-				return 0;
-			}
-			// switch on part
-			switch(complex_part){
-				case NONE:
-					// didn't we test != NONE just a few lines ago?
-					gl_error("group_recorder::read_line(): inconsistant complex_part states!");
+	if(!writer_running){
+		int64 it = gl_instrument_now();
+		if(0 != line->time_str[0] && 0 == write_line(line)){
+			writer_failed = true;
+		} else if(line->flush && 0 != fflush(rec_file)){
+			writer_failed = true;
+		}
+		gl_instrument_span("group_recorder_write", IC_IO, it);
+		return check_writer();
+	}
+	pthread_mutex_lock(&writer_lock);
+	++queue_count;
+	pthread_cond_signal(&writer_ready);
+	pthread_mutex_unlock(&writer_lock);
+	return 1;
+}
+
+/**
+	Formats a staged line and writes it to the file.  Runs on the writer thread.
+	@return 1 on successful write, 0 on unsuccessful write
+ **/
+int group_recorder::write_line(GRLINE *line){
+	char buffer[GR_TEXTSIZE];
+	size_t index = 0, offset = 0;
+	int n = 0;
+
+	for(n = 0; n < obj_count; ++n){
+		char *value = line->stage + member_offset[n];
+		switch(member_kind[n]){
+			case GR_RAW:
+				offset = gl_get_value(member_obj[n], value, buffer, 127, member_prop+n);
+				if(0 == offset){
 					return 0;
-				case REAL:
-					part_value = cptr->Re();
-					break;
-				case IMAG:
-					part_value = cptr->Im();
-					break;
-				case MAG:
-					part_value = cptr->Mag();
-					break;
-				case ANG:
-					part_value = cptr->Arg() * 180/PI;
-					break;
-				case ANG_RAD:
-					part_value = cptr->Arg();
-					break;
+				}
+				break;
+			case GR_PART:
+				offset = sprintf(buffer, "%f", *(double *)value);
+				break;
+			case GR_TEXT:
+				offset = strlen(value);
+				memcpy(buffer, value, offset+1);
+				break;
+		}
+		// check line_buffer space
+		if( (index + offset + 2) > line_size ){
+			size_t size = (line_size > 0 ? line_size : 49 * obj_count + 1);
+			char *grow = 0;
+			while(size < index + offset + 2){
+				size *= 2;
 			}
-			sprintf(buffer, "%f", part_value);
-			offset = strlen(buffer);
-		} else {
-			offset = gl_get_value(curr->obj, GETADDR(curr->obj, &(curr->prop)), buffer, 127, &(curr->prop));
-			if(0 == offset){
-				gl_error("group_recorder::read_line(): unable to get value for '%s' in object '%s'", curr->prop.name, curr->obj->name);
-				/* TROUBLESHOOT
-					An error occured while reading the specified property in one of the objects.
-				 */
+			grow = (char *)realloc(line_buffer, size);
+			if(0 == grow){
 				return 0;
 			}
-		}
-		// check line_buffer space
-		if( (index + offset + 1) > line_size ){
-			gl_error("group_recorder::read_line(): potential buffer overflow from a too-short automatically sized output value buffer");
-			/* TROUBLESHOOT
-				A potential buffer overflow was caught, most likely due to incorrect property
-				representation assumptions for buffer allocation.
-			 */
-			return 0;
+			line_buffer = grow;
+			line_size = size;
 		}
 		// write to line_buffer
 		// * lead with a comma on all entries, assume leading timestamp will NOT print a comma
-		if(0 >= sprintf(line_buffer+index, ",%s", buffer)){return 0;}
-		index += (offset + 1); // add the comma
+		line_buffer[index++] = ',';
+		memcpy(line_buffer+index, buffer, offset);
+		index += offset;
+	}
+	if(0 == line_buffer){
+		return 0;
 	}
-	// assume write_line will add newline character
+	line_buffer[index] = 0;
 
+	// print line to file
+	if(0 >= fprintf(rec_file, "%s%s\n", line->time_str, line_buffer)){
+		return 0;
+	}
 	return 1;
 }
 
+void *group_recorder::writer_main(void *arg){
+	gl_pool_release();
+	((group_recorder *)arg)->writer_loop();
+	return 0;
+}
+
 /**
-	@return 1 on successful write, 0 on unsuccessful write, error, or when not ready
+	Writes queued lines in order until the writer is stopped and the queue is empty.
+	After a failure the remaining lines are discarded so the simulation is not blocked.
  **/
-int group_recorder::write_line(TIMESTAMP t1){
-	char time_str[64];
-	DATETIME dt;
+void group_recorder::writer_loop(){
+	GRLINE *line = 0;
+	pthread_mutex_lock(&writer_lock);
+	while(true){
+		while(0 == queue_count && !writer_stop){
+			pthread_cond_wait(&writer_ready, &writer_lock);
+		}
+		if(0 == queue_count){
+			break;
+		}
+		line = queue + queue_head;
+		pthread_mutex_unlock(&writer_lock);
+
+		if(!writer_failed){
+			int64 it = gl_instrument_now();
+			if(0 != line->time_str[0] && 0 == write_line(line)){
+				writer_failed = true;
+			} else if(line->flush && 0 != fflush(rec_file)){
+				writer_failed = true;
+			}
+			gl_instrument_span("group_recorder_write", IC_IO, it);
+		}
 
-	if(TS_OPEN != tape_status){
-		gl_error("group_recorder::write_line(): trying to write line when the tape is not open");
-		// could be ERROR or CLOSED, should not have happened
-		return 0;
-	}
-	if(0 == rec_file){
-		gl_error("group_recorder::write_line(): no output file open and state is 'open'");
-		/* TROUBLESHOOT
-			group_recorder claimed to be open and attempted to write to a file when
-			a file had not successfully	opened.
-		 */
-		tape_status = TS_ERROR;
-		return 0;
+		pthread_mutex_lock(&writer_lock);
+		queue_head = (queue_head + 1) % GR_QUEUESIZE;
+		--queue_count;
+		pthread_cond_signal(&writer_space);
 	}
+	pthread_mutex_unlock(&writer_lock);
+}
 
-	// check that buffer needs were pre-calculated
-	if(line_size <= 0 || line_buffer == 0){
-		gl_error("group_recorder::write_line(): output buffer not initialized (read_line() not called)");
+/**
+	@return 1 if the writer thread is running, 0 if lines are written on the simulation thread
+ **/
+int group_recorder::start_writer(){
+	queue_head = queue_count = 0;
+	writer_stop = writer_failed = false;
+	writer_running = false;
+	pthread_mutex_init(&writer_lock, NULL);
+	pthread_cond_init(&writer_ready, NULL);
+	pthread_cond_init(&writer_space, NULL);
+	if(0 != pthread_create(&writer, NULL, writer_main, (void *)this)){
+		gl_warning("group_recorder::init(): unable to start the writer thread, lines will be written by the simulation");
 		/* TROUBLESHOOT
-			read_line was not called before write_line, indicating an internal logic error.
+			The thread that formats and writes the group_recorder lines could not be created.
+			The group_recorder will still work, but the simulation waits for each line to be written.
 		 */
-		tape_status = TS_ERROR;
 		return 0;
 	}
+	writer_running = true;
+	return 1;
+}
 
-	// write time_str
-	// recorder.c uses multiple formats, in the sense of "formatted or not".  This does not.
-	if(0 == gl_localtime(t1, &dt)){
-		gl_error("group_recorder::write_line(): error when converting the sync time");
-		/* TROUBLESHOOT
-			Unprintable timestamp.
-		 */
-		tape_status = TS_ERROR;
-		return 0;
-	}
-	if(0 == gl_strtime(&dt, time_str, sizeof(time_str) ) ){
-		gl_error("group_recorder::write_line(): error when writing the sync time as a string");
-		/* TROUBLESHOOT
-			Error printing the timestamp.
-		 */
-		tape_status = TS_ERROR;
-		return 0;
-	}
-	// print line to file
-	if(0 >= fprintf(rec_file, "%s%s\n", time_str, line_buffer)){
-		gl_error("group_recorder::write_line(): error when writing to the output file");
+/**
+	Waits for the writer to write the queued lines and stops it.
+ **/
+void group_recorder::stop_writer(){
+	if(!writer_running){
+		return;
+	}
+	pthread_mutex_lock(&writer_lock);
+	writer_stop = true;
+	pthread_cond_signal(&writer_ready);
+	pthread_mutex_unlock(&writer_lock);
+	pthread_join(writer, NULL);
+	writer_running = false;
+}
+
+/**
+	Reports a failure of the writer on the simulation thread.
+	@return 0 on failure, 1 on success
+ **/
+int group_recorder::check_writer(){
+	if(writer_failed && TS_OPEN == tape_status){
+		gl_error("group_recorder: unable to format or write a line to '%s'", filename.get_string());
 		/* TROUBLESHOOT
-			File I/O error.
+			A recorded value could not be converted to text or the output file could not be written.
+			Check the recorded property and the space available for the output file.
 		 */
 		tape_status = TS_ERROR;
 		return 0;
 	}
-	++write_count;
-	
 	return 1;
 }
 
 /**
+	Queues a flush of the output file behind the lines already queued.
 	@return 0 on failure, 1 on success
  **/
 int group_recorder::flush_line(){
@@ -568,15 +810,7 @@ int group_recorder::flush_line(){
 		tape_status = TS_ERROR;
 		return 0;
 	}
-	if(0 != fflush(rec_file)){
-		gl_error("group_recorder::flush_line(): unable to flush output file");
-		/* TROUBLESHOOT
-			An IO error has occured.
-		 */
-		tape_status = TS_ERROR;
-		return 0;
-	}
-	return 1;
+	return queue_line(next_line(), TS_NEVER, true);
 }
 
 /**
@@ -687,6 +921,21 @@ EXPORT int commit_group_recorder(OBJECT *obj){
 	return rv;
 }
 
+EXPORT int finalize_group_recorder(OBJECT *obj){
+	int rv = 0;
+	group_recorder *my = OBJECTDATA(obj, group_recorder);
+	try {
+		rv = my->finalize(obj);
+	}
+	catch (char *msg){
+		gl_error("finalize_group_recorder: %s", msg);
+	}
+	catch (const char *msg){
+		gl_error("finalize_group_recorder: %s", msg);
+	}
+	return rv;
+}
+
 EXPORT int isa_group_recorder(OBJECT *obj, char *classname)
 {
 	return OBJECTDATA(obj, group_recorder)->isa(classname);
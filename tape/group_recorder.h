@@ -4,21 +4,28 @@
 #define _GROUP_RECORDER_H_
 
 #include "tape.h"
+#include <pthread.h>
 
 EXPORT void new_group_recorder(MODULE *);
 
 #ifdef __cplusplus
 
-class quickobjlist{
-public:
-	quickobjlist(){obj = 0; next = 0; memset(&prop, 0, sizeof(PROPERTY));}
-	quickobjlist(OBJECT *o, PROPERTY *p){obj = o; next = 0; memcpy(&prop, p, sizeof(PROPERTY));}
-	~quickobjlist(){if(next != 0) delete next;}
-	void tack(OBJECT *o, PROPERTY *p){if(next){next->tack(o, p);} else {next = new quickobjlist(o, p);}}
-	OBJECT *obj;
-	PROPERTY prop;
-	quickobjlist *next;
-};
+#define GR_RAW		0	// value is copied as is and formatted by the writer
+#define GR_PART		1	// complex part is computed as a double and formatted by the writer
+#define GR_TEXT		2	// value is formatted when it is read (types that can not be copied)
+
+#define GR_TEXTSIZE		128		// staged size of a formatted value
+#define GR_MINITEMS		4096	// minimum number of members read by each thread
+#define GR_QUEUESIZE	4		// number of lines staged ahead of the writer
+
+/** Staged line
+	The values of all the members at one time, waiting to be formatted and written.
+ **/
+typedef struct s_grline {
+	char *stage;
+	char time_str[64];
+	bool flush;	// flush the file after this line
+} GRLINE;
 
 class group_recorder{
 public:
@@ -32,6 +39,7 @@ public:
 	TIMESTAMP postsync(TIMESTAMP, TIMESTAMP);
 
 	int commit(TIMESTAMP);
+	int finalize(OBJECT *);
 public:
 	char1024 group_def;
 	double dInterval;
@@ -44,16 +52,40 @@ public:
 	CPLPT complex_part;
 private:
 	int write_header();
-	int read_line();
-	int write_line(TIMESTAMP);
+	int read_line(char *);
+	int read_range(char *, int, int);
+	static TIMESTAMP read_task(TPTASK *, unsigned int, unsigned int, unsigned int);
+	GRLINE *next_line();
+	int queue_line(GRLINE *, TIMESTAMP, bool);
+	int write_line(GRLINE *);
 	int flush_line();
 	int write_footer();
+	int start_writer();
+	void stop_writer();
+	static void *writer_main(void *);
+	void writer_loop();
+	int check_writer();
 private:
 	FILE *rec_file;
 	FINDLIST *items;
-	quickobjlist *obj_list;
 	PROPERTY *prop_ptr;
 	int obj_count;
+	OBJECT **member_obj;	// members of the group
+	void **member_addr;		// address of the recorded property of each member
+	PROPERTY *member_prop;	// copy of the recorded property of each member (units removed if not printed)
+	int *member_kind;		// GR_RAW, GR_PART or GR_TEXT
+	size_t *member_offset;	// offset of each member's value in a staged line
+	size_t stage_size;
+	GRLINE queue[GR_QUEUESIZE];
+	int queue_head;
+	int queue_count;
+	pthread_t writer;
+	pthread_mutex_t writer_lock;
+	pthread_cond_t writer_ready;	// a line was queued or the writer must stop
+	pthread_cond_t writer_space;	// a line was written
+	bool writer_running;
+	bool writer_stop;
+	bool writer_failed;
 	int write_count;
 	TIMESTAMP next_write;
 	TIMESTAMP last_write;
@@ -62,8 +94,8 @@ private:
 	TIMESTAMP flush_interval;
 	int32 write_ct;
 	TAPESTATUS tape_status; // TS_INIT/OPEN/DONE/ERROR
-	char *prev_line_buffer;
-	char *line_buffer;
+	char *prev_stage;	// last staged line written ('on change' only)
+	char *line_buffer;	// writer's text buffer
 	size_t line_size;
 	bool interval_write;
 };
@@ -47,6 +47,7 @@ histogram::histogram(MODULE *mod)
 			PT_char32, "mode", PADDR(mode),PT_DESCRIPTION,"the mode of file output",
 			PT_char1024, "group", PADDR(group),PT_DESCRIPTION,"the GridLAB-D group expression to use for this histogram",
 			PT_char1024, "bins", PADDR(bins),PT_DESCRIPTION,"the specific bin values to use",
+			PT_char256, "quantiles", PADDR(quantiles),PT_DESCRIPTION,"the quantiles to estimate from the samples (e.g., 0.5,0.95,0.99)",
 			PT_char256, "property", PADDR(property),PT_DESCRIPTION,"the property to sample",
 			PT_double, "min", PADDR(min),PT_DESCRIPTION,"the minimum value of the auto-sized bins to use",
 			PT_double, "max", PADDR(max),PT_DESCRIPTION,"the maximum value of the auto-sized bins to use",
@@ -60,6 +61,7 @@ histogram::histogram(MODULE *mod)
 		memset(group, 0, 1025);
 		memset(bins, 0, 1025);
 		memset(property, 0, 33);
+		memset(quantiles, 0, 257);
 		min = 0;
 		max = -1;
 		bin_count = -1;
@@ -70,6 +72,15 @@ histogram::histogram(MODULE *mod)
 		group_list = NULL;
 		binctr = NULL;
 		prop_ptr = NULL;
+		sample_addr = NULL;
+		sample_type = NULL;
+		n_samples = 0;
+		bin_mode = HB_LINEAR;
+		bin_step = 0.0;
+		n_slots = 1;
+		sketch = NULL;
+		quantile_list = NULL;
+		n_quantiles = 0;
 		next_count = t_count = next_sample = t_sample = TS_ZERO;
 		strcpy(mode, "file");
 		flags[0]='w';
@@ -206,6 +217,26 @@ void histogram::test_for_complex(char *tprop, char *tpart){
 	}
 }
 
+/**
+ *	Resolves the address of the sampled property of an object so sampling does not look it up again.
+ *	@return 1 on success, 0 on error
+ */
+int histogram::add_sample(OBJECT *obj, PROPERTY *prop){
+	int size = n_samples + 1;
+	void **addr = (void **)realloc(sample_addr, sizeof(void *) * size);
+	PROPERTYTYPE *type = (PROPERTYTYPE *)realloc(sample_type, sizeof(PROPERTYTYPE) * size);
+	if(addr == NULL || type == NULL){
+		gl_error("Histogram malloc error: unable to alloc %i samples", size);
+		return 0;
+	}
+	sample_addr = addr;
+	sample_type = type;
+	sample_addr[n_samples] = GETADDR(obj, prop);
+	sample_type[n_samples] = prop->ptype;
+	n_samples = size;
+	return 1;
+}
+
 /**
 * Object initialization is called once after all object have been created
 *
@@ -258,7 +289,8 @@ int histogram::init(OBJECT *parent)
 			if(oclass != group_obj->oclass){
 				prop_ptr = NULL;
 			} 
-			
+			if(add_sample(group_obj, prop) == 0)
+				return 0;
 		}
 	} else { /* if we have a parent, we only focus on that one object */
 
@@ -271,9 +303,23 @@ int histogram::init(OBJECT *parent)
 			return 0;
 		} else {
 			prop_ptr = prop; /* saved for later */
+			if(add_sample(parent, prop) == 0)
+				return 0;
 		}
 	}
 
+	/* large groups are sampled by several threads, each counting into its own slot */
+	n_slots = 1;
+	if(n_samples >= 2 * HG_MINITEMS){
+		char buffer[32];
+		if(gl_global_getvar("threadcount", buffer, sizeof(buffer)) != NULL)
+			n_slots = atoi(buffer);
+		if(n_slots > n_samples / HG_MINITEMS)
+			n_slots = n_samples / HG_MINITEMS;
+		if(n_slots < 1)
+			n_slots = 1;
+	}
+
 	// initialize first timesteps
 	if(counting_interval > 0.0)
 		next_count = gl_globalclock + counting_interval;
@@ -301,8 +347,10 @@ int histogram::init(OBJECT *parent)
 			bin_list[i].high_inc = 0;
 		}
 		bin_list[i-1].high_inc = 1;	/* tail value capture */
-		binctr = (int *)gl_malloc(sizeof(int) * bin_count);
-		memset(binctr, 0, sizeof(int) * bin_count);
+		binctr = (int *)gl_malloc(sizeof(int) * bin_count * n_slots);
+		memset(binctr, 0, sizeof(int) * bin_count * n_slots);
+		bin_mode = HB_UNIFORM;
+		bin_step = step;
 	}
 	else if (bins[0] != 0)
 	/*
@@ -352,13 +400,63 @@ int histogram::init(OBJECT *parent)
 			gl_error("Histrogram encountered a problem parsing bins for %s", obj->name ? obj->name : "(unnamed histogram)");
 			return 0;
 		}
-		binctr = (int *)malloc(sizeof(int) * bin_count);
-		memset(binctr, 0, sizeof(int) * bin_count);
+		binctr = (int *)malloc(sizeof(int) * bin_count * n_slots);
+		memset(binctr, 0, sizeof(int) * bin_count * n_slots);
+
+		/* sorted disjoint bins can be searched instead of scanned */
+		bin_mode = HB_SEARCH;
+		for(i = 0; i < bin_count; ++i){
+			if(bin_list[i].low_val > bin_list[i].high_val){
+				bin_mode = HB_LINEAR;
+			} else if(i > 0 && (bin_list[i-1].low_val >= bin_list[i].low_val || bin_list[i-1].high_val > bin_list[i].low_val || (bin_list[i-1].high_val == bin_list[i].low_val && bin_list[i-1].high_inc && bin_list[i].low_inc))){
+				bin_mode = HB_LINEAR;
+			}
+		}
+	} else if(quantiles[0] != 0){
+		/* quantiles only */
+		bin_count = 0;
 	} else {
-		gl_error("Histogram has neither bins or a bin range to work with");
+		gl_error("Histogram has neither bins, a bin range, nor quantiles to work with");
 		return 0;
 	}
 
+	/*
+	 *	Quantiles are estimated with a streaming sketch for each thread slot, merged when the row is written.
+	 */
+	if(quantiles[0] != 0){
+		char qcpy[257];
+		char *cptr = NULL;
+		int i = 0;
+		n_quantiles = 1;
+		for(cptr = quantiles; *cptr != 0; ++cptr){
+			if(*cptr == ',' && cptr[1] != 0){
+				++n_quantiles;
+			}
+		}
+		quantile_list = (double *)gl_malloc(sizeof(double) * n_quantiles);
+		sketch = (qsketch **)gl_malloc(sizeof(qsketch *) * n_slots);
+		if(quantile_list == NULL || sketch == NULL){
+			gl_error("Histogram malloc error: unable to alloc %i quantiles for %s", n_quantiles, obj->name ? obj->name : "(anon. histogram)");
+			return 0;
+		}
+		memcpy(qcpy, quantiles, 256);
+		qcpy[256] = 0;
+		cptr = strtok(qcpy, ",\t\r\n");
+		for(i = 0; i < n_quantiles && cptr != NULL; ++i){
+			char *end = NULL;
+			quantile_list[i] = strtod(cptr, &end);
+			if(end == cptr || quantile_list[i] < 0.0 || quantile_list[i] > 1.0){
+				gl_error("Histogram unable to parse quantile \'%s\' in %s (must be between 0 and 1)", cptr, obj->name ? obj->name : "(unnamed histogram)");
+				return 0;
+			}
+			cptr = strtok(NULL, ",\t\r\n");
+		}
+		n_quantiles = i;
+		for(i = 0; i < n_slots; ++i){
+			sketch[i] = new qsketch();
+		}
+	}
+
 	/* open file ~ copied from recorder.c */
 		/* if prefix is omitted (no colons found) */
 //	if (sscanf(filename,"%32[^:]:%1024[^:]:%[^:]",ftype,fname,flags)==1)
@@ -383,84 +481,152 @@ int histogram::init(OBJECT *parent)
 	return ops->open(this, fname, flags);
 }
 
-int histogram::feed_bins(OBJECT *obj){
-	double value = 0.0;
-	complex cval = 0.0; //gl_get_complex(obj, ;
-	int64 ival = 0;
-	int i = 0;
+/**
+ *	Reads the sampled property of sample n.
+ *	Integer, enumeration and set properties are compared to the bins as doubles.
+ */
+double histogram::get_sample(int n){
+	void *addr = sample_addr[n];
+	complex *cval = NULL;
 
-	switch(prop_ptr->ptype){
+	switch(sample_type[n]){
 		case PT_complex:
-			cval = (prop_ptr ? *gl_get_complex(obj, prop_ptr) : *gl_get_complex_by_name(obj, property) );
+			cval = (complex *)addr;
 			switch(this->comp_part){
 				case REAL:
-					value = cval.Re();
-					break;
+					return cval->Re();
 				case IMAG:
-					value = cval.Im();
-					break;
+					return cval->Im();
 				case MAG:
-					value = cval.Mag();
-					break;
+					return cval->Mag();
 				case ANG:
-					value = cval.Arg();
-					break;
+					return cval->Arg();
 				default:
-					gl_error("Complex property with no part defined in %s", (obj->name ? obj->name : "(unnamed)"));
+					gl_error("Complex property with no part defined in %s", (OBJECTHDR(this)->name ? OBJECTHDR(this)->name : "(unnamed)"));
+					return QNAN;
 			}
-			ival = 1;
-			/* fall through */
 		case PT_double:
-			if(ival == 0) 
-				value = (prop_ptr ? *gl_get_double(obj, prop_ptr) : *gl_get_double_by_name(obj, property.get_string()) );
-			for(i = 0; i < bin_count; ++i){
-				if(value > bin_list[i].low_val && value < bin_list[i].high_val){
-					++binctr[i];
-				} else if(bin_list[i].low_inc && bin_list[i].low_val == value){
-					++binctr[i];
-				} else if(bin_list[i].high_inc && bin_list[i].high_val == value){
-					++binctr[i];
-				}
-			}
-			break;
+			return *(double *)addr;
 		case PT_int16:
-			ival = (prop_ptr ? *gl_get_int16(obj, prop_ptr) : *gl_get_int16_by_name(obj, property.get_string()) );
-			value = 1.0;
+			return (double)*(int16 *)addr;
 		case PT_int32:
-			if(value == 0.0){
-				ival = (prop_ptr ? *gl_get_int32(obj, prop_ptr) : *gl_get_int32_by_name(obj, property.get_string()) );
-				value = 1.0;
-			}
+			return (double)*(int32 *)addr;
 		case PT_int64:
-			if(value == 0.0){
-				ival = (prop_ptr ? *gl_get_int64(obj, prop_ptr) : *gl_get_int64_by_name(obj, property.get_string()) );
-				value = 1.0;
-			}
+			return (double)*(int64 *)addr;
 		case PT_enumeration:
-			if(value == 0.0){
-				ival = (prop_ptr ? *gl_get_enum(obj, prop_ptr) : *gl_get_enum_by_name(obj, property.get_string()) );
-				value = 1.0;
-			}
+			return (double)*(enumeration *)addr;
 		case PT_set:
-			if(value == 0.0){
-				ival = (prop_ptr ? *gl_get_set(obj, prop_ptr) : *gl_get_set_by_name(obj, property.get_string()) );
-				value = 1.0;
-			}
-			
-			/* may be prone to fractional errors */
+			return (double)*(set *)addr;
+		default:
+			return QNAN;
+	}
+}
+
+static inline int in_bin(BIN *bin, double value){
+	return (value > bin->low_val && value < bin->high_val)
+		|| (bin->low_inc && bin->low_val == value)
+		|| (bin->high_inc && bin->high_val == value);
+}
+
+/**
+ *	Finds the bin of a value when bins are disjoint.
+ *	@return the bin index, or -1 if no bin contains the value
+ */
+int histogram::find_bin(double value){
+	int i = 0;
+
+	if(bin_mode == HB_UNIFORM){
+		if(!(value >= bin_list[0].low_val && value <= bin_list[bin_count-1].high_val))
+			return -1;
+		i = (int)floor((value - bin_list[0].low_val) / bin_step);
+		if(i >= bin_count)
+			i = bin_count - 1;
+		else if(i < 0)
+			i = 0;
+	} else {
+		/* last bin whose lower bound is at or below the value */
+		int lo = 0, hi = bin_count;
+		while(lo < hi){
+			int mid = (lo + hi) / 2;
+			if(bin_list[mid].low_val <= value)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		i = lo - 1;
+		if(i < 0)
+			return -1;
+	}
+
+	/* computed and searched bins may be off by one on the bin edges */
+	if(in_bin(bin_list+i, value))
+		return i;
+	if(i > 0 && in_bin(bin_list+i-1, value))
+		return i-1;
+	if(i+1 < bin_count && in_bin(bin_list+i+1, value))
+		return i+1;
+	return -1;
+}
+
+/**
+ *	Counts samples first to last-1 into the bins and sketch of a thread slot.
+ */
+void histogram::feed_bins(int slot, int first, int last){
+	int *counter = binctr + slot * bin_count;
+	qsketch *qs = (sketch ? sketch[slot] : NULL);
+	int n = 0, i = 0;
+
+	for(n = first; n < last; ++n){
+		double value = get_sample(n);
+		if(bin_mode == HB_LINEAR){
+			/* overlapping bins may all count the same value */
 			for(i = 0; i < bin_count; ++i){
-				if(ival > bin_list[i].low_val && ival < bin_list[i].high_val){
-					++binctr[i];
-				} else if(bin_list[i].low_inc && bin_list[i].low_val == ival){
-					++binctr[i];
-				} else if(bin_list[i].high_inc && bin_list[i].high_val == ival){
-					++binctr[i];
+				if(in_bin(bin_list+i, value)){
+					++counter[i];
 				}
 			}
-			break;
+		} else if(bin_count > 0){
+			i = find_bin(value);
+			if(i >= 0){
+				++counter[i];
+			}
+		}
+		if(qs != NULL){
+			qs->add(value);
+		}
 	}
+}
 
-	return 0;
+/**
+ *	Counts the samples of the slots first to last-1 on a core pool thread.
+ */
+TIMESTAMP histogram::feed_task(TPTASK *task, unsigned int first, unsigned int last, unsigned int thread){
+	histogram *hist = (histogram *)task->data;
+	unsigned int slot = 0;
+	for(slot = first; slot < last; ++slot){
+		hist->feed_bins(slot, (int)((int64)hist->n_samples * slot / hist->n_slots), (int)((int64)hist->n_samples * (slot+1) / hist->n_slots));
+	}
+	return TS_NEVER;
+}
+
+/**
+ *	Counts all samples, splitting large groups across the thread slots.
+ */
+void histogram::feed_all(void){
+	TPTASK task, *run = &task;
+
+	if(n_slots < 2){
+		feed_bins(0, 0, n_samples);
+		return;
+	}
+
+	memset(&task, 0, sizeof(task));
+	task.name = "histogram feed";
+	task.call = feed_task;
+	task.data = (void *)this;
+	task.n_items = n_slots;
+	task.grain = 1;
+	gl_pool_run(&run, 1);
 }
 
 TIMESTAMP histogram::sync(TIMESTAMP t0, TIMESTAMP t1)
@@ -473,14 +639,7 @@ TIMESTAMP histogram::sync(TIMESTAMP t0, TIMESTAMP t1)
 		sampling_interval == 0.0 ||
 		(sampling_interval > 0.0 && t1 >= next_sample))
 	{
-		if(group_list == NULL){
-			feed_bins(obj->parent);
-		} else {
-			OBJECT *obj = gl_find_next(group_list, NULL);
-			for(; obj != NULL; obj = gl_find_next(group_list, obj)){
-				feed_bins(obj);
-			}
-		}
+		feed_all();
 		t_sample = t1;
 		if(sampling_interval > 0.0001){
 			next_sample = t1 + (int64)(sampling_interval/TS_SECOND);
@@ -502,6 +661,17 @@ TIMESTAMP histogram::sync(TIMESTAMP t0, TIMESTAMP t1)
 		gl_localtime(t1,&dt);
 		gl_strtime(&dt,ts,64);
 		
+		/* merge the thread slots */
+		for(i = 1; i < n_slots; ++i){
+			int j = 0;
+			for(j = 0; j < bin_count; ++j){
+				binctr[j] += binctr[i * bin_count + j];
+			}
+			if(sketch != NULL){
+				sketch[0]->merge(sketch[i]);
+			}
+		}
+
 		/* write bins */
 		for(i = 0; i < bin_count; ++i){
 			off += sprintf(line+off, "%i", binctr[i]);
@@ -510,13 +680,24 @@ TIMESTAMP histogram::sync(TIMESTAMP t0, TIMESTAMP t1)
 			}
 		}
 
+		/* write quantiles */
+		for(i = 0; i < n_quantiles; ++i){
+			off += sprintf(line+off, "%g", sketch[0]->quantile(quantile_list[i]));
+			if(i+1 < n_quantiles){
+				off += sprintf(line+off, ",");
+			}
+		}
+
 		/* write line */
 		ops->write(this, ts, line);
 		
 		/* cleanup */
-		for(i = 0; i < bin_count; ++i){
+		for(i = 0; i < bin_count * n_slots; ++i){
 			binctr[i] = 0;
 		}
+		for(i = 0; sketch != NULL && i < n_slots; ++i){
+			sketch[i]->clear();
+		}
 		t_count = t1;
 		if(counting_interval > 0){
 			next_count = t_count + (int64)(counting_interval/TS_SECOND);
@@ -11,6 +11,8 @@
 EXPORT void new_histogram(MODULE *mod);
 
 #ifdef __cplusplus
+#include "quantile.h"
+
 typedef struct s_histogram_bin {
 	double low_val;
 	double high_val;
@@ -18,14 +20,27 @@ typedef struct s_histogram_bin {
 	int high_inc;
 } BIN;
 
+#define HB_LINEAR	0	/* bins may overlap, each one is tested */
+#define HB_SEARCH	1	/* bins are sorted and disjoint, binary search */
+#define HB_UNIFORM	2	/* bins are uniform, bin is computed */
+
+#define HG_MINITEMS	4096	/* minimum number of samples given to each sampling thread */
+
 class histogram
 {
 protected:
 	FINDLIST *group_list;
-	int *binctr;
+	int *binctr;	/* bin counters of each thread slot */
 	CPLPT comp_part;
 	PROPERTY *prop_ptr;
 	TAPEOPS *ops;
+	void **sample_addr;	/* resolved property address of each sampled object */
+	PROPERTYTYPE *sample_type;
+	int n_samples;
+	int bin_mode;
+	double bin_step;
+	int n_slots;	/* number of thread slots */
+	qsketch **sketch;	/* quantile sketch of each thread slot */
 
 public:
     static CLASS *oclass;
@@ -43,6 +58,7 @@ public:
 	char1024 group;
 	char256 property;
 	char1024 bins;
+	char256 quantiles;
 	int32 bin_count;
 	double min;
 	double max;
@@ -59,6 +75,8 @@ public:
 	};
 
 	BIN *bin_list;
+	double *quantile_list;
+	int n_quantiles;
 public:
 	histogram(MODULE *mod);
 	int create(void);
@@ -67,7 +85,12 @@ public:
 	int isa(char *classname);
 protected:
 	void test_for_complex(char *, char *);
-	int feed_bins(OBJECT *);
+	int add_sample(OBJECT *, PROPERTY *);
+	double get_sample(int);
+	int find_bin(double);
+	void feed_bins(int, int, int);
+	void feed_all(void);
+	static TIMESTAMP feed_task(TPTASK *, unsigned int, unsigned int, unsigned int);
 };
 
 #endif // C++
@@ -0,0 +1,186 @@
+/** $Id$
+	Copyright (C) 2008 Battelle Memorial Institute
+	@file quantile.cpp
+	@addtogroup tape
+	@ingroup tape
+
+	Streaming quantile sketch used by the histogram.
+
+ @{
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "tape.h"
+#include "quantile.h"
+
+typedef struct s_qvalue {
+	double value;
+	double weight;
+} QVALUE;
+
+static int compare_double(const void *a, const void *b)
+{
+	double x = *(double*)a, y = *(double*)b;
+	return x<y ? -1 : (x>y ? 1 : 0);
+}
+
+static int compare_qvalue(const void *a, const void *b)
+{
+	return compare_double(&((QVALUE*)a)->value,&((QVALUE*)b)->value);
+}
+
+qsketch::qsketch(unsigned int sz)
+{
+	k = sz<2 ? 2 : sz;
+	n_levels = 0;
+	level = NULL;
+	size = NULL;
+	capacity = NULL;
+	parity = 0;
+	count = 0;
+}
+
+qsketch::~qsketch(void)
+{
+	unsigned int h;
+	for ( h=0 ; h<n_levels ; h++ )
+		free(level[h]);
+	free(level);
+	free(size);
+	free(capacity);
+}
+
+/** Make room for n more values in compactor h, adding compactors as needed **/
+void qsketch::grow(unsigned int h, unsigned int n)
+{
+	if ( h>=n_levels )
+	{
+		unsigned int i;
+		level = (double**)realloc(level,(h+1)*sizeof(double*));
+		size = (unsigned int*)realloc(size,(h+1)*sizeof(unsigned int));
+		capacity = (unsigned int*)realloc(capacity,(h+1)*sizeof(unsigned int));
+		if ( level==NULL || size==NULL || capacity==NULL )
+			GL_THROW("qsketch: unable to allocate compactor %d", h);
+		for ( i=n_levels ; i<=h ; i++ )
+		{
+			level[i] = NULL;
+			size[i] = capacity[i] = 0;
+		}
+		n_levels = h+1;
+	}
+	if ( size[h]+n>capacity[h] )
+	{
+		unsigned int need = capacity[h]>0 ? capacity[h] : k;
+		while ( need<size[h]+n ) need *= 2;
+		level[h] = (double*)realloc(level[h],need*sizeof(double));
+		if ( level[h]==NULL )
+			GL_THROW("qsketch: unable to allocate %d values for compactor %d", need, h);
+		capacity[h] = need;
+	}
+}
+
+/** Promote half of compactor h to compactor h+1, keeping the odd value out **/
+void qsketch::compact(unsigned int h)
+{
+	unsigned int n = size[h]&~1, i;
+	double *src;
+	qsort(level[h],size[h],sizeof(double),compare_double);
+	grow(h+1,n/2);
+	src = level[h];
+	for ( i=parity ; i<n ; i+=2 )
+		level[h+1][size[h+1]++] = src[i];
+	parity ^= 1;
+	if ( size[h]&1 )
+		src[0] = src[size[h]-1];
+	size[h] -= n;
+	if ( size[h+1]>=k )
+		compact(h+1);
+}
+
+void qsketch::add(double x)
+{
+	if ( isnan(x) )
+		return;
+	grow(0,1);
+	level[0][size[0]++] = x;
+	count++;
+	if ( size[0]>=k )
+		compact(0);
+}
+
+/** Add the samples summarized by another sketch **/
+void qsketch::merge(qsketch *other)
+{
+	unsigned int h;
+	for ( h=0 ; h<other->n_levels ; h++ )
+	{
+		if ( other->size[h]==0 )
+			continue;
+		grow(h,other->size[h]);
+		memcpy(level[h]+size[h],other->level[h],other->size[h]*sizeof(double));
+		size[h] += other->size[h];
+	}
+	count += other->count;
+	for ( h=0 ; h<n_levels ; h++ )
+	{
+		if ( size[h]>=k )
+			compact(h);
+	}
+}
+
+void qsketch::clear(void)
+{
+	unsigned int h;
+	for ( h=0 ; h<n_levels ; h++ )
+		size[h] = 0;
+	count = 0;
+}
+
+/** Estimate the value below which a fraction q of the samples fall
+	@return the estimate, or QNAN when no samples were added
+ **/
+double qsketch::quantile(double q)
+{
+	unsigned int h, i, n=0;
+	double total=0, target, sum=0, result;
+	QVALUE *list;
+
+	for ( h=0 ; h<n_levels ; h++ )
+		n += size[h];
+	if ( n==0 )
+		return QNAN;
+
+	list = (QVALUE*)malloc(n*sizeof(QVALUE));
+	if ( list==NULL )
+		GL_THROW("qsketch: unable to allocate %d values for quantile", n);
+	for ( h=0, n=0 ; h<n_levels ; h++ )
+	{
+		double weight = ldexp(1.0,h);
+		for ( i=0 ; i<size[h] ; i++,n++ )
+		{
+			list[n].value = level[h][i];
+			list[n].weight = weight;
+			total += weight;
+		}
+	}
+	qsort(list,n,sizeof(QVALUE),compare_qvalue);
+
+	target = q*total;
+	result = list[n-1].value;
+	for ( i=0 ; i<n ; i++ )
+	{
+		sum += list[i].weight;
+		if ( sum>=target )
+		{
+			result = list[i].value;
+			break;
+		}
+	}
+	free(list);
+	return result;
+}
+
+/**@}**/
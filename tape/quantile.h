@@ -0,0 +1,47 @@
+/** $Id$
+	Copyright (C) 2008 Battelle Memorial Institute
+	@file quantile.h
+	@addtogroup tape
+	@ingroup tape
+
+	Streaming quantile sketch used by the histogram.
+
+	The sketch is a stack of compactors of size k.  Samples go into the
+	first compactor; when a compactor is full it is sorted and every other
+	value is promoted to the next one, where it stands for twice as many
+	samples.  The rank error is about log2(n/k)/k, memory is O(k log(n/k)),
+	and two sketches are merged by merging their compactors level by level,
+	so sketches filled by different threads can be combined at output time.
+ @{
+ **/
+
+#ifndef _QUANTILE_H
+#define _QUANTILE_H
+
+#define QS_DEFAULTSIZE 256 /**< default compactor size */
+
+class qsketch {
+private:
+	unsigned int k;			/**< compactor size */
+	unsigned int n_levels;	/**< compactors in use */
+	double **level;			/**< compactor values (level h values stand for 2^h samples) */
+	unsigned int *size;		/**< values in each compactor */
+	unsigned int *capacity;	/**< allocated values of each compactor */
+	unsigned int parity;	/**< alternates which half of a compactor is promoted */
+	double count;			/**< samples added */
+private:
+	void grow(unsigned int h, unsigned int n);
+	void compact(unsigned int h);
+public:
+	qsketch(unsigned int size=QS_DEFAULTSIZE);
+	~qsketch(void);
+	void add(double x);
+	void merge(qsketch *other);
+	void clear(void);
+	double quantile(double q);
+	inline double get_count(void) { return count; };
+};
+
+#endif
+
+/**@}**/
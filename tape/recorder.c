@@ -357,9 +357,11 @@ static int recorder_open(OBJECT *obj)
 
 static int write_recorder(struct recorder *my, char *ts, char *value)
 {
+	int64 it = gl_instrument_now();
 	int rc=my->ops->write(my, ts, value);
 	if ( (my->flush==0 || (my->flush>0 && my->flush%gl_globalclock==0)) && my->ops->flush!=NULL ) 
 		my->ops->flush(my);
+	gl_instrument_span("recorder_write",IC_IO,it);
 	return rc;
 }
 
@@ -174,6 +174,9 @@ int violation_recorder::init(OBJECT *obj){
 	tplx_meter_list_v7 = uniqueList_alloc_fxn(tplx_meter_list_v7);
 	comm_meter_list_v7 = uniqueList_alloc_fxn(comm_meter_list_v7);
 
+	// resolve the enabled rules against the objects found above
+	compile_checks();
+
 	return 1;
 }
 
@@ -423,14 +426,17 @@ int violation_recorder::check_violations(TIMESTAMP t1) {
 
 	if ((t1-sim_start) < violation_start_delay) return 1;
 
+	// evaluate the compiled checks first, then report violations in rule order
+	evaluate_checks(violation_flag, t1);
+
 	if (violation_flag & VIOLATION1)
-		check_violation_1(t1);
+		emit_checks(1, t1);
 
 	if (violation_flag & VIOLATION2)
-		check_violation_2(t1);
+		emit_checks(2, t1);
 
 	if (violation_flag & VIOLATION3)
-		check_violation_3(t1);
+		emit_checks(3, t1);
 
 	if (violation_flag & VIOLATION4)
 		check_violation_4(t1);
@@ -439,10 +445,10 @@ int violation_recorder::check_violations(TIMESTAMP t1) {
 		check_violation_5(t1);
 
 	if (violation_flag & VIOLATION6)
-		check_violation_6(t1);
+		emit_checks(6, t1);
 
 	if (violation_flag & VIOLATION7)
-		check_violation_7(t1);
+		emit_checks(7, t1);
 
 	if (violation_flag & VIOLATION8)
 		check_violation_8(t1);
@@ -450,49 +456,122 @@ int violation_recorder::check_violations(TIMESTAMP t1) {
 	return 1;
 }
 
+// Resolve the rules of the enabled violations into the check array
+int violation_recorder::compile_checks() {
+	int n;
+
+	first_check[0] = n_checks = 0;
+	for (n = 1; n <= 8; n++) {
+		if (violation_flag & (1<<(n-1))) {
+			switch (n) {
+			case 1: compile_violation_1(); break;
+			case 2: compile_violation_2(); break;
+			case 3: compile_violation_3(); break;
+			case 6: compile_violation_6(); break;
+			case 7: compile_violation_7(); break;
+			default: break; // checked directly on the substation link
+			}
+		}
+		first_check[n] = n_checks;
+	}
+
+	gl_verbose("violation_recorder::init(): %d violation checks compiled", (int)n_checks);
+	return 1;
+}
+
+void *violation_recorder::get_check_value(OBJECT *obj, char *prop_name, bool *is_complex) {
+	PROPERTY *p_ptr = gl_get_property(obj, prop_name);
+	if (p_ptr == NULL)
+		return NULL;
+	*is_complex = (p_ptr->ptype == PT_complex);
+	return GETADDR(obj, p_ptr);
+}
+
+double *violation_recorder::get_nominal_voltage(OBJECT *obj) {
+	PROPERTY *p_ptr = gl_get_property(obj, "nominal_voltage");
+	if (p_ptr == NULL)
+		return NULL;
+	return (double*)GETADDR(obj, p_ptr);
+}
+
+// Add a check of prop_name on obj normalized by (*nominal)*factor (factor alone when nominal is NULL)
+vcheck *violation_recorder::add_check(vrule &rule, OBJECT *obj, char *prop_name, double *nominal, double factor, char *phase) {
+	bool is_complex = false;
+	void *value = get_check_value(obj, prop_name, &is_complex);
+
+	// a missing property can never be in violation
+	if (value == NULL)
+		return NULL;
+
+	if (n_checks == max_checks) {
+		size_t size = (max_checks > 0) ? max_checks*2 : 1024;
+		vcheck *list = (vcheck *)realloc(checks, size*sizeof(vcheck));
+		if (list == NULL) {
+			GL_THROW("violation_recorder - Failed to allocate space for the violation checks");
+			/*  TROUBLESHOOT
+			While attempting to allocate the memory for the compiled violation checks within the violation recorder, an error occurred.  Please check your
+			file and try again.  If the error persists, please submit you code and a bug report via the ticketing system.
+			*/
+		}
+		checks = list;
+		max_checks = size;
+	}
+
+	vcheck *check = checks + n_checks;
+	memset(check, 0, sizeof(vcheck));
+	check->violation = rule.violation;
+	check->type = rule.type;
+	check->kind = rule.kind;
+	check->obj = obj;
+	check->value = value;
+	check->value_is_complex = is_complex;
+	check->nominal = nominal;
+	check->factor = factor;
+	check->upper_bound = rule.upper_bound;
+	check->lower_bound = rule.lower_bound;
+	check->interval = rule.interval;
+	check->uniq_list = rule.uniq_list;
+	check->phase = phase;
+	check->message = rule.message;
+
+	// phases of the same object are counted once in the unique list
+	if (n_checks > 0 && checks[n_checks-1].obj == obj && checks[n_checks-1].uniq_list == rule.uniq_list)
+		check->first = checks[n_checks-1].first;
+	else
+		check->first = n_checks;
+
+	n_checks++;
+	return check;
+}
+
 // Exceeding device thermal limit
-int violation_recorder::check_violation_1(TIMESTAMP t1) {
-//	gl_output("VIOLATION 1");
-	vobjlist *curr = 0;
+int violation_recorder::compile_violation_1() {
 
-	check_xfrmr_thermal_limit(t1, xfrmr_obj_list, xfrmr_list_v1, XFMR, xfrmr_thermal_limit_upper, xfrmr_thermal_limit_lower);
-	check_line_thermal_limit(t1, ohl_obj_list, ohl_list_v1, OHLN, line_thermal_limit_upper, line_thermal_limit_lower);
-	check_line_thermal_limit(t1, ugl_obj_list, ugl_list_v1, UGLN, line_thermal_limit_upper, line_thermal_limit_lower);
-	check_line_thermal_limit(t1, tplxl_obj_list, tplxl_list_v1, TPXL, line_thermal_limit_upper, line_thermal_limit_lower);
+	compile_xfrmr_thermal_limit(xfrmr_obj_list, xfrmr_list_v1, XFMR);
+	compile_line_thermal_limit(ohl_obj_list, ohl_list_v1, OHLN);
+	compile_line_thermal_limit(ugl_obj_list, ugl_list_v1, UGLN);
+	compile_line_thermal_limit(tplxl_obj_list, tplxl_list_v1, TPXL);
 
 	return 1;
 
 }
 
-int violation_recorder::check_line_thermal_limit(TIMESTAMP t1, vobjlist *list, uniqueList *uniq_list, int type, double upper_bound, double lower_bound) {
+int violation_recorder::compile_line_thermal_limit(vobjlist *list, uniqueList *uniq_list, int type) {
 
 	vobjlist *curr = 0;
-	double nominal, nominalA, nominalB, nominalC;
-	char objname[128];
-	double retval;
+	double *nominalA = 0, *nominalB = 0, *nominalC = 0;
+	vrule rule = {VIOLATION1, type, VC_STATIC, &line_thermal_limit_upper, &line_thermal_limit_lower, NULL, uniq_list, "Current violates thermal limit."};
 
 	for(curr = list; curr != 0; curr = curr->next){
 		if (curr->obj == 0) continue;
-		//p_ptr = gl_get_property(curr->obj, "continuous_rating");
-		//nominal = get_observed_double_value(curr->obj, p_ptr);
 		if (has_phase(curr->obj, PHASE_S)) { // split phase line
 			triplex_line *pTriplex_line = OBJECTDATA(curr->obj,triplex_line);
 			triplex_line_configuration *pConfiguration1 = OBJECTDATA(pTriplex_line->configuration,triplex_line_configuration);
 			
 			triplex_line_conductor *pConfigurationA = OBJECTDATA(pConfiguration1->phaseA_conductor,triplex_line_conductor);
-			nominal = pConfigurationA->summer.continuous;
-			if (fails_static_condition(curr->obj, "current_out_A", upper_bound, lower_bound, nominal, &retval)) {
-				uniq_list->insert(curr->obj->name);
-				increment_violation(VIOLATION1, type);
-				write_to_stream(t1, echo, "VIOLATION1, %f, %f, %f, %s, %s, S1, Current violates thermal limit.", retval, upper_bound, lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name);
-			}
+			add_check(rule, curr->obj, "current_out_A", &pConfigurationA->summer.continuous, 1.0, "S1");
 			triplex_line_conductor *pConfigurationB = OBJECTDATA(pConfiguration1->phaseB_conductor,triplex_line_conductor);
-			nominal = pConfigurationB->summer.continuous;
-			if (fails_static_condition(curr->obj, "current_out_B", upper_bound, lower_bound, nominal, &retval)) {
-				uniq_list->insert(curr->obj->name);
-				increment_violation(VIOLATION1, type);
-				write_to_stream(t1, echo, "VIOLATION1, %f, %f, %f, %s, %s, S2, Current violates thermal limit.", retval, upper_bound, lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name);
-			}
+			add_check(rule, curr->obj, "current_out_B", &pConfigurationB->summer.continuous, 1.0, "S2");
 		} else { // 'normal' 3-phase line
 			if ( gl_object_isa(curr->obj,"underground_line","powerflow") ) {
 				underground_line *pThree_phase_line = OBJECTDATA(curr->obj,underground_line);
@@ -501,25 +580,25 @@ int violation_recorder::check_line_thermal_limit(TIMESTAMP t1, vobjlist *list, u
 				if (has_phase(curr->obj, PHASE_A)) {
 					underground_line_conductor *pConfigurationA = OBJECTDATA(pConfiguration1->phaseA_conductor,underground_line_conductor);
 					if ( pConfigurationA == NULL)
-						nominalA = pConfiguration1->summer.continuous;
+						nominalA = &pConfiguration1->summer.continuous;
 					else
-						nominalA = pConfigurationA->summer.continuous;
+						nominalA = &pConfigurationA->summer.continuous;
 				}
 					
 				if (has_phase(curr->obj, PHASE_B)) {
 					underground_line_conductor *pConfigurationB = OBJECTDATA(pConfiguration1->phaseB_conductor,underground_line_conductor);	
 					if ( pConfigurationB == NULL)
-						nominalB = pConfiguration1->summer.continuous;
+						nominalB = &pConfiguration1->summer.continuous;
 					else
-						nominalB = pConfigurationB->summer.continuous;
+						nominalB = &pConfigurationB->summer.continuous;
 				}
 
 				if (has_phase(curr->obj, PHASE_C)) {
 					underground_line_conductor *pConfigurationC = OBJECTDATA(pConfiguration1->phaseC_conductor,underground_line_conductor);	
 					if ( pConfigurationC == NULL)
-						nominalC = pConfiguration1->summer.continuous;
+						nominalC = &pConfiguration1->summer.continuous;
 					else
-						nominalC = pConfigurationC->summer.continuous;
+						nominalC = &pConfigurationC->summer.continuous;
 				}
 			}
 			else {
@@ -529,49 +608,34 @@ int violation_recorder::check_line_thermal_limit(TIMESTAMP t1, vobjlist *list, u
 				if (has_phase(curr->obj, PHASE_A)) {
 					overhead_line_conductor *pConfigurationA = OBJECTDATA(pConfiguration1->phaseA_conductor,overhead_line_conductor);
 					if ( pConfigurationA == NULL)
-						nominalA = pConfiguration1->summer.continuous;
+						nominalA = &pConfiguration1->summer.continuous;
 					else
-						nominalA = pConfigurationA->summer.continuous;
+						nominalA = &pConfigurationA->summer.continuous;
 				}
 
 				if (has_phase(curr->obj, PHASE_B)) {
 					overhead_line_conductor *pConfigurationB = OBJECTDATA(pConfiguration1->phaseB_conductor,overhead_line_conductor);
 					if ( pConfigurationB == NULL)
-						nominalB = pConfiguration1->summer.continuous;
+						nominalB = &pConfiguration1->summer.continuous;
 					else
-						nominalB = pConfigurationB->summer.continuous;
+						nominalB = &pConfigurationB->summer.continuous;
 				}
 
 				if (has_phase(curr->obj, PHASE_C)) {
 					overhead_line_conductor *pConfigurationC = OBJECTDATA(pConfiguration1->phaseC_conductor,overhead_line_conductor);
 					if ( pConfigurationC == NULL)
-						nominalC = pConfiguration1->summer.continuous;
+						nominalC = &pConfiguration1->summer.continuous;
 					else
-						nominalC = pConfigurationC->summer.continuous;
+						nominalC = &pConfigurationC->summer.continuous;
 				}				
 				
 			}		
-			if (has_phase(curr->obj, PHASE_A)) {
-				if (fails_static_condition(curr->obj, "current_out_A", upper_bound, lower_bound, nominalA, &retval)) {
-					uniq_list->insert(curr->obj->name);
-					increment_violation(VIOLATION1, type);
-					write_to_stream(t1, echo, "VIOLATION1, %f, %f, %f, %s, %s, A, Current violates thermal limit.", retval, upper_bound, lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name);
-				}
-			}
-			if (has_phase(curr->obj, PHASE_B)) {
-				if (fails_static_condition(curr->obj, "current_out_B", upper_bound, lower_bound, nominalB, &retval)) {
-					uniq_list->insert(curr->obj->name);
-					increment_violation(VIOLATION1, type);
-					write_to_stream(t1, echo, "VIOLATION1, %f, %f, %f, %s, %s, B, Current violates thermal limit.", retval, upper_bound, lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name);
-				}
-			}
-			if (has_phase(curr->obj, PHASE_C)) {
-				if (fails_static_condition(curr->obj, "current_out_C", upper_bound, lower_bound, nominalC, &retval)) {
-					uniq_list->insert(curr->obj->name);
-					increment_violation(VIOLATION1, type);
-					write_to_stream(t1, echo, "VIOLATION1, %f, %f, %f, %s, %s, C, Current violates thermal limit.", retval, upper_bound, lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name);
-				}
-			}
+			if (has_phase(curr->obj, PHASE_A))
+				add_check(rule, curr->obj, "current_out_A", nominalA, 1.0, "A");
+			if (has_phase(curr->obj, PHASE_B))
+				add_check(rule, curr->obj, "current_out_B", nominalB, 1.0, "B");
+			if (has_phase(curr->obj, PHASE_C))
+				add_check(rule, curr->obj, "current_out_C", nominalC, 1.0, "C");
 		}
 	}
 
@@ -579,53 +643,26 @@ int violation_recorder::check_line_thermal_limit(TIMESTAMP t1, vobjlist *list, u
 
 }
 
-int violation_recorder::check_xfrmr_thermal_limit(TIMESTAMP t1, vobjlist *list, uniqueList *uniq_list, int type, double upper_bound, double lower_bound) {
+int violation_recorder::compile_xfrmr_thermal_limit(vobjlist *list, uniqueList *uniq_list, int type) {
 
 	vobjlist *curr = 0;
-	double nominal;
-	char objname[128];
-	double retval;
+	vrule rule = {VIOLATION1, type, VC_STATIC, &xfrmr_thermal_limit_upper, &xfrmr_thermal_limit_lower, NULL, uniq_list, "Power violates thermal limit."};
 
 	for(curr = list; curr != 0; curr = curr->next){
 		if (curr->obj == 0) continue;
+		transformer *pTransformer = OBJECTDATA(curr->obj,transformer);
+		transformer_configuration *pConfiguration = OBJECTDATA(pTransformer->configuration,transformer_configuration);
 		// this is for the triplex transformers b/c phase is meaningless
 		if (has_phase(curr->obj, PHASE_S)) {
-			transformer *pTransformer = OBJECTDATA(curr->obj,transformer);
-			transformer_configuration *pConfiguration = OBJECTDATA(pTransformer->configuration,transformer_configuration);
-			nominal = pConfiguration->kVA_rating*1000.;
-			if (fails_static_condition(curr->obj, "power_out", upper_bound, lower_bound, nominal, &retval)) {
-				uniq_list->insert(curr->obj->name);
-				increment_violation(VIOLATION1, type);
-				write_to_stream(t1, echo, "VIOLATION1, %f, %f, %f, %s, %s, S, Power violates thermal limit.", retval, upper_bound, lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name);
-			}
+			add_check(rule, curr->obj, "power_out", &pConfiguration->kVA_rating, 1000., "S");
 		// this is for the other transformers which have 3 phases, each of which can violate the limit
 		} else {
-			transformer *pTransformer = OBJECTDATA(curr->obj,transformer);
-			transformer_configuration *pConfiguration = OBJECTDATA(pTransformer->configuration,transformer_configuration);
-			if (has_phase(curr->obj, PHASE_A)) {
-				nominal = pConfiguration->phaseA_kVA_rating*1000.;
-				if (fails_static_condition(curr->obj, "power_out_A", upper_bound, lower_bound, nominal, &retval)) {
-					uniq_list->insert(curr->obj->name);
-					increment_violation(VIOLATION1, type);
-					write_to_stream(t1, echo, "VIOLATION1, %f, %f, %f, %s, %s, A, Power violates thermal limit.", retval, upper_bound, lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name);
-				}
-			}
-			if (has_phase(curr->obj, PHASE_B)) {
-				nominal = pConfiguration->phaseB_kVA_rating*1000.;
-				if (fails_static_condition(curr->obj, "power_out_B", upper_bound, lower_bound, nominal, &retval)) {
-					uniq_list->insert(curr->obj->name);
-					increment_violation(VIOLATION1, type);
-					write_to_stream(t1, echo, "VIOLATION1, %f, %f, %f, %s, %s, B, Power violates thermal limit.", retval, upper_bound, lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name);
-				}
-			}
-			if (has_phase(curr->obj, PHASE_C)) {
-				nominal = pConfiguration->phaseC_kVA_rating*1000.;
-				if (fails_static_condition(curr->obj, "power_out_C", upper_bound, lower_bound, nominal, &retval)) {
-					uniq_list->insert(curr->obj->name);
-					increment_violation(VIOLATION1, type);
-					write_to_stream(t1, echo, "VIOLATION1, %f, %f, %f, %s, %s, C, Power violates thermal limit.", retval, upper_bound, lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name);
-				}
-			}
+			if (has_phase(curr->obj, PHASE_A))
+				add_check(rule, curr->obj, "power_out_A", &pConfiguration->phaseA_kVA_rating, 1000., "A");
+			if (has_phase(curr->obj, PHASE_B))
+				add_check(rule, curr->obj, "power_out_B", &pConfiguration->phaseB_kVA_rating, 1000., "B");
+			if (has_phase(curr->obj, PHASE_C))
+				add_check(rule, curr->obj, "power_out_C", &pConfiguration->phaseC_kVA_rating, 1000., "C");
 		}
 	}
 
@@ -634,95 +671,51 @@ int violation_recorder::check_xfrmr_thermal_limit(TIMESTAMP t1, vobjlist *list,
 }
 
 // Instantaneous voltage of node over 1.1pu
-int violation_recorder::check_violation_2(TIMESTAMP t1) {
-//	gl_output("VIOLATION 2");
+int violation_recorder::compile_violation_2() {
 	vobjlist *curr = 0;
-	PROPERTY *p_ptr;
-	double nominal;
-	char objname[128];
-	int c = 0;
-	double node_upper_bound = node_instantaneous_voltage_limit_upper;
-	double node_lower_bound = node_instantaneous_voltage_limit_lower;
-	double retval;
+	double *nominal;
+	vrule rule = {VIOLATION2, NODE, VC_STATIC, &node_instantaneous_voltage_limit_upper, &node_instantaneous_voltage_limit_lower, NULL, node_list_v2, "Per unit voltage violates limit."};
 
 	for(curr = node_obj_list; curr != 0; curr = curr->next){
 		if (curr->obj == 0) continue;
-		p_ptr = gl_get_property(curr->obj, "nominal_voltage");
-		nominal = get_observed_double_value(curr->obj, p_ptr);
-		if (has_phase(curr->obj, PHASE_A)) {
-			if (fails_static_condition(curr->obj, "voltage_A", node_upper_bound, node_lower_bound, nominal, &retval)) {
-				node_list_v2->insert(curr->obj->name);
-				increment_violation(VIOLATION2, NODE);
-				write_to_stream(t1, echo, "VIOLATION2, %f, %f, %f, %s, %s, A, Per unit voltage violates limit.", retval, node_upper_bound, node_lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name);
-			}
-		}
-		if (has_phase(curr->obj, PHASE_B)) {
-			if (fails_static_condition(curr->obj, "voltage_B", node_upper_bound, node_lower_bound, nominal, &retval)) {
-				node_list_v2->insert(curr->obj->name);
-				increment_violation(VIOLATION2, NODE);
-				write_to_stream(t1, echo, "VIOLATION2, %f, %f, %f, %s, %s, B, Per unit voltage violates limit.", retval, node_upper_bound, node_lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name);
-			}
-		}
-		if (has_phase(curr->obj, PHASE_C)) {
-			if (fails_static_condition(curr->obj, "voltage_C", node_upper_bound, node_lower_bound, nominal, &retval)) {
-				node_list_v2->insert(curr->obj->name);
-				increment_violation(VIOLATION2, NODE);
-				write_to_stream(t1, echo, "VIOLATION2, %f, %f, %f, %s, %s, C, Per unit voltage violates limit.", retval, node_upper_bound, node_lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name);
-			}
-		}
+		if ((nominal = get_nominal_voltage(curr->obj)) == NULL) continue;
+		if (has_phase(curr->obj, PHASE_A))
+			add_check(rule, curr->obj, "voltage_A", nominal, 1.0, "A");
+		if (has_phase(curr->obj, PHASE_B))
+			add_check(rule, curr->obj, "voltage_B", nominal, 1.0, "B");
+		if (has_phase(curr->obj, PHASE_C))
+			add_check(rule, curr->obj, "voltage_C", nominal, 1.0, "C");
 	}
 
+	rule.type = CMTR;
+	rule.uniq_list = comm_meter_list_v2;
 	for(curr = comm_mtr_obj_list; curr != 0; curr = curr->next){
 		if (curr->obj == 0) continue;
-		p_ptr = gl_get_property(curr->obj, "nominal_voltage");
-		nominal = get_observed_double_value(curr->obj, p_ptr);
-		if (has_phase(curr->obj, PHASE_A)) {
-			if (fails_static_condition(curr->obj, "voltage_A", node_upper_bound, node_lower_bound, nominal, &retval)) {
-				comm_meter_list_v2->insert(curr->obj->name);
-				increment_violation(VIOLATION2, CMTR);
-				write_to_stream(t1, echo, "VIOLATION2, %f, %f, %f, %s, %s, A, Per unit voltage violates limit.", retval, node_upper_bound, node_lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name);
-			}
-		}
-		if (has_phase(curr->obj, PHASE_B)) {
-			if (fails_static_condition(curr->obj, "voltage_B", node_upper_bound, node_lower_bound, nominal, &retval)) {
-				comm_meter_list_v2->insert(curr->obj->name);
-				increment_violation(VIOLATION2, CMTR);
-				write_to_stream(t1, echo, "VIOLATION2, %f, %f, %f, %s, %s, B, Per unit voltage violates limit.", retval, node_upper_bound, node_lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name);
-			}
-		}
-		if (has_phase(curr->obj, PHASE_C)) {
-			if (fails_static_condition(curr->obj, "voltage_C", node_upper_bound, node_lower_bound, nominal, &retval)) {
-				comm_meter_list_v2->insert(curr->obj->name);
-				increment_violation(VIOLATION2, CMTR);
-				write_to_stream(t1, echo, "VIOLATION2, %f, %f, %f, %s, %s, C, Per unit voltage violates limit.", retval, node_upper_bound, node_lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name);
-			}
-		}
+		if ((nominal = get_nominal_voltage(curr->obj)) == NULL) continue;
+		if (has_phase(curr->obj, PHASE_A))
+			add_check(rule, curr->obj, "voltage_A", nominal, 1.0, "A");
+		if (has_phase(curr->obj, PHASE_B))
+			add_check(rule, curr->obj, "voltage_B", nominal, 1.0, "B");
+		if (has_phase(curr->obj, PHASE_C))
+			add_check(rule, curr->obj, "voltage_C", nominal, 1.0, "C");
 	}
 
+	rule.type = TPXN;
+	rule.uniq_list = tplx_node_list_v2;
 	for(curr = tplx_node_obj_list; curr != 0; curr = curr->next){
 		if (curr->obj == 0) continue;
-		p_ptr = gl_get_property(curr->obj, "nominal_voltage");
-		nominal = get_observed_double_value(curr->obj, p_ptr) * 2.;
-		if (has_phase(curr->obj, PHASE_S1) && has_phase(curr->obj, PHASE_S2)) {
-			if (fails_static_condition(curr->obj, "voltage_12", node_upper_bound, node_lower_bound, nominal, &retval)) {
-				tplx_node_list_v2->insert(curr->obj->name);
-				increment_violation(VIOLATION2, TPXN);
-				write_to_stream(t1, echo, "VIOLATION2, %f, %f, %f, %s, %s, S, Per unit voltage violates limit.", retval, node_upper_bound, node_lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name);
-			}
-		}
+		if ((nominal = get_nominal_voltage(curr->obj)) == NULL) continue;
+		if (has_phase(curr->obj, PHASE_S1) && has_phase(curr->obj, PHASE_S2))
+			add_check(rule, curr->obj, "voltage_12", nominal, 2., "S");
 	}
 
+	rule.type = TPXM;
+	rule.uniq_list = tplx_meter_list_v2;
 	for(curr = tplx_mtr_obj_list; curr != 0; curr = curr->next){
 		if (curr->obj == 0) continue;
-		p_ptr = gl_get_property(curr->obj, "nominal_voltage");
-		nominal = get_observed_double_value(curr->obj, p_ptr) * 2.;
-		if (has_phase(curr->obj, PHASE_S1) && has_phase(curr->obj, PHASE_S2)) {
-			if (fails_static_condition(curr->obj, "voltage_12", node_upper_bound, node_lower_bound, nominal, &retval)) {
-				tplx_meter_list_v2->insert(curr->obj->name);
-				increment_violation(VIOLATION2, TPXM);
-				write_to_stream(t1, echo, "VIOLATION2, %f, %f, %f, %s, %s, S, Per unit voltage violates limit.", retval, node_upper_bound, node_lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name);
-			}
-		}
+		if ((nominal = get_nominal_voltage(curr->obj)) == NULL) continue;
+		if (has_phase(curr->obj, PHASE_S1) && has_phase(curr->obj, PHASE_S2))
+			add_check(rule, curr->obj, "voltage_12", nominal, 2., "S");
 	}
 
 	return 1;
@@ -730,69 +723,38 @@ int violation_recorder::check_violation_2(TIMESTAMP t1) {
 }
 
 // Voltage of node over 1.05pu or under 0.95pu for 5 minutes or more
-int violation_recorder::check_violation_3(TIMESTAMP t1) {
-//	gl_output("VIOLATION 3");
+int violation_recorder::compile_violation_3() {
 	vobjlist *curr = 0;
-	PROPERTY *p_ptr;
-	double nominal;
-	char objname[128];
-	int c = 0;
-	double node_upper_bound = node_continuous_voltage_limit_upper;
-	double node_lower_bound = node_continuous_voltage_limit_lower;
-	double interval = node_continuous_voltage_interval;
-	double retval;
+	double *nominal;
+	vrule rule = {VIOLATION3, TPXN, VC_CONTINUOUS, &node_continuous_voltage_limit_upper, &node_continuous_voltage_limit_lower, &node_continuous_voltage_interval, tplx_node_list_v3, "Per unit voltage violates limit continuously over %is interval."};
 
 	for(curr = tplx_node_obj_list; curr != 0; curr = curr->next){
 		if (curr->obj == 0) continue;
-		p_ptr = gl_get_property(curr->obj, "nominal_voltage");
-		nominal = get_observed_double_value(curr->obj, p_ptr) * 2.;
-		if (has_phase(curr->obj, PHASE_S1) && has_phase(curr->obj, PHASE_S2)) { // We are now checking all objects regardless of parent // && gl_object_isa(curr->obj->parent,"transformer")) {
-			if (fails_continuous_condition(curr, 0, "voltage_12", t1, interval, node_upper_bound, node_lower_bound, nominal, &retval)) {
-				tplx_node_list_v3->insert(curr->obj->name);
-				increment_violation(VIOLATION3, TPXN);
-				write_to_stream(t1, echo, "VIOLATION3, %f, %f, %f, %s, %s, S, Per unit voltage violates limit continuously over %is interval.", retval, node_upper_bound, node_lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name, (int)node_continuous_voltage_interval);
-			}
-		}
+		if ((nominal = get_nominal_voltage(curr->obj)) == NULL) continue;
+		if (has_phase(curr->obj, PHASE_S1) && has_phase(curr->obj, PHASE_S2)) // We are now checking all objects regardless of parent // && gl_object_isa(curr->obj->parent,"transformer")) {
+			add_check(rule, curr->obj, "voltage_12", nominal, 2., "S");
 	}
 
+	rule.type = TPXM;
+	rule.uniq_list = tplx_meter_list_v3;
 	for(curr = tplx_mtr_obj_list; curr != 0; curr = curr->next){
 		if (curr->obj == 0) continue;
-		p_ptr = gl_get_property(curr->obj, "nominal_voltage");
-		nominal = get_observed_double_value(curr->obj, p_ptr) * 2.;
-		if (has_phase(curr->obj, PHASE_S1) && has_phase(curr->obj, PHASE_S2)) { // We are now checking all objects regardless of parent // && gl_object_isa(curr->obj->parent,"transformer")) {
-			if (fails_continuous_condition(curr, 0, "voltage_12", t1, interval, node_upper_bound, node_lower_bound, nominal, &retval)) {
-				tplx_meter_list_v3->insert(curr->obj->name);
-				increment_violation(VIOLATION3, TPXM);
-				write_to_stream(t1, echo, "VIOLATION3, %f, %f, %f, %s, %s, S, Per unit voltage violates limit continuously over %is interval.", retval, node_upper_bound, node_lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name, (int)node_continuous_voltage_interval);
-			}
-		}
+		if ((nominal = get_nominal_voltage(curr->obj)) == NULL) continue;
+		if (has_phase(curr->obj, PHASE_S1) && has_phase(curr->obj, PHASE_S2)) // We are now checking all objects regardless of parent // && gl_object_isa(curr->obj->parent,"transformer")) {
+			add_check(rule, curr->obj, "voltage_12", nominal, 2., "S");
 	}
 
+	rule.type = CMTR;
+	rule.uniq_list = comm_meter_list_v3;
 	for(curr = comm_mtr_obj_list; curr != 0; curr = curr->next){
 		if (curr->obj == 0) continue;
-		p_ptr = gl_get_property(curr->obj, "nominal_voltage");
-		nominal = get_observed_double_value(curr->obj, p_ptr);
-		if (has_phase(curr->obj, PHASE_A)) {
-			if (fails_continuous_condition(curr, 0, "voltage_A", t1, interval, node_upper_bound, node_lower_bound, nominal, &retval)) {
-				comm_meter_list_v3->insert(curr->obj->name);
-				increment_violation(VIOLATION3, CMTR);
-				write_to_stream(t1, echo, "VIOLATION3, %f, %f, %f, %s, %s, A, Per unit voltage violates limit continuously over %is interval.", retval, node_upper_bound, node_lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name, (int)node_continuous_voltage_interval);
-			}
-		}
-		if (has_phase(curr->obj, PHASE_B)) {
-			if (fails_continuous_condition(curr, 0, "voltage_B", t1, interval, node_upper_bound, node_lower_bound, nominal, &retval)) {
-				comm_meter_list_v3->insert(curr->obj->name);
-				increment_violation(VIOLATION3, CMTR);
-				write_to_stream(t1, echo, "VIOLATION3, %f, %f, %f, %s, %s, B, Per unit voltage violates limit continuously over %is interval.", retval, node_upper_bound, node_lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name, (int)node_continuous_voltage_interval);
-			}
-		}
-		if (has_phase(curr->obj, PHASE_C)) {
-			if (fails_continuous_condition(curr, 0, "voltage_C", t1, interval, node_upper_bound, node_lower_bound, nominal, &retval)) {
-				comm_meter_list_v3->insert(curr->obj->name);
-				increment_violation(VIOLATION3, CMTR);
-				write_to_stream(t1, echo, "VIOLATION3, %f, %f, %f, %s, %s, C, Per unit voltage violates limit continuously over %is interval.", retval, node_upper_bound, node_lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name, (int)node_continuous_voltage_interval);
-			}
-		}
+		if ((nominal = get_nominal_voltage(curr->obj)) == NULL) continue;
+		if (has_phase(curr->obj, PHASE_A))
+			add_check(rule, curr->obj, "voltage_A", nominal, 1.0, "A");
+		if (has_phase(curr->obj, PHASE_B))
+			add_check(rule, curr->obj, "voltage_B", nominal, 1.0, "B");
+		if (has_phase(curr->obj, PHASE_C))
+			add_check(rule, curr->obj, "voltage_C", nominal, 1.0, "C");
 	}
 
 	return 1;
@@ -854,46 +816,21 @@ int violation_recorder::check_reverse_flow_violation(TIMESTAMP t1, int violation
 }
 
 // Any voltage change at a PV POC that is greater than 1.5% between two one-minute simulation time-steps.
-int violation_recorder::check_violation_6(TIMESTAMP t1) {
-//	gl_output("VIOLATION 6");
+int violation_recorder::compile_violation_6() {
 	vobjlist *curr = 0;
-	char objname[128];
-	double upper_bound = inverter_v_chng_per_interval_upper_bound;
-	double lower_bound = inverter_v_chng_per_interval_lower_bound;
-	double interval = inverter_v_chng_interval;
-	double nominal = 1.0;
-	double retval;
+	vrule rule = {VIOLATION6, 0, VC_DYNAMIC, &inverter_v_chng_per_interval_upper_bound, &inverter_v_chng_per_interval_lower_bound, &inverter_v_chng_interval, inverter_list_v6, "Voltage change between %is intervals violates limit."};
 
 	for(curr = inverter_obj_list; curr != 0; curr = curr->next){
 		if (curr->obj == 0) continue;
 		if (has_phase(curr->obj, PHASE_S)) { // inverter connected to a triplex system, only checking one phase here
-			if (fails_dynamic_condition(curr, 1, "phaseB_V_Out", t1, interval, upper_bound, lower_bound, nominal, &retval)) { // this is S1 !?!
-				inverter_list_v6->insert(curr->obj->name);
-				increment_violation(VIOLATION6);
-				write_to_stream(t1, echo, "VIOLATION6, %f, %f, %f, %s, %s, S, Voltage change between %is intervals violates limit.", retval, upper_bound, lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name, (int)inverter_v_chng_interval);
-			}
+			add_check(rule, curr->obj, "phaseB_V_Out", NULL, 1.0, "S"); // this is S1 !?!
 		} else { // assume we are a three phase inverter
-			if (has_phase(curr->obj, PHASE_A)) {
-				if (fails_dynamic_condition(curr, 0, "phaseA_V_Out", t1, interval, upper_bound, lower_bound, nominal, &retval)) {
-					inverter_list_v6->insert(curr->obj->name);
-					increment_violation(VIOLATION6);
-					write_to_stream(t1, echo, "VIOLATION6, %f, %f, %f, %s, %s, A, Voltage change between %is intervals violates limit.", retval, upper_bound, lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name, (int)inverter_v_chng_interval);
-				}
-			}
-			if (has_phase(curr->obj, PHASE_B)) {
-				if (fails_dynamic_condition(curr, 1, "phaseB_V_Out", t1, interval, upper_bound, lower_bound, nominal, &retval)) {
-					inverter_list_v6->insert(curr->obj->name);
-					increment_violation(VIOLATION6);
-					write_to_stream(t1, echo, "VIOLATION6, %f, %f, %f, %s, %s, B, Voltage change between %is intervals violates limit.", retval, upper_bound, lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name, (int)inverter_v_chng_interval);
-				}
-			}
-			if (has_phase(curr->obj, PHASE_C)) {
-				if (fails_dynamic_condition(curr, 2, "phaseC_V_Out", t1, interval, upper_bound, lower_bound, nominal, &retval)) {
-					inverter_list_v6->insert(curr->obj->name);
-					increment_violation(VIOLATION6);
-					write_to_stream(t1, echo, "VIOLATION6, %f, %f, %f, %s, %s, C, Voltage change between %is intervals violates limit.", retval, upper_bound, lower_bound, gl_name(curr->obj, objname, 127), curr->obj->oclass->name, (int)inverter_v_chng_interval);
-				}
-			}
+			if (has_phase(curr->obj, PHASE_A))
+				add_check(rule, curr->obj, "phaseA_V_Out", NULL, 1.0, "A");
+			if (has_phase(curr->obj, PHASE_B))
+				add_check(rule, curr->obj, "phaseB_V_Out", NULL, 1.0, "B");
+			if (has_phase(curr->obj, PHASE_C))
+				add_check(rule, curr->obj, "phaseC_V_Out", NULL, 1.0, "C");
 		}
 	}
 
@@ -901,151 +838,54 @@ int violation_recorder::check_violation_6(TIMESTAMP t1) {
 }
 
 // 3V rise across the secondary distribution system
-int violation_recorder::check_violation_7(TIMESTAMP t1) {
-//	gl_output("VIOLATION 7");
+int violation_recorder::compile_violation_7() {
 	vobjlist *curr = 0;
-	PROPERTY *p_ptr;
-	double meter_voltage, meter_nominal, xfrmr_voltage, xfrmr_nominal, pu;
-	char metername[128];
-	char xfrmrname[128];
-	double pu_upper_bound = secondary_dist_voltage_rise_upper_limit;
-	double pu_lower_bound = secondary_dist_voltage_rise_lower_limit;
-	double retval;
+	vcheck *check;
+	double *meter_nominal, *xfrmr_nominal;
+	vrule rule = {VIOLATION7, TPXM, VC_DIFFERENCE, &secondary_dist_voltage_rise_upper_limit, &secondary_dist_voltage_rise_lower_limit, NULL, tplx_meter_list_v7, "Per unit voltage difference between objects violates limit."};
+	static char *phase_name[2][3] = {{"A S1","B S1","C S1"},{"A S2","B S2","C S2"}};
+	static char *meter_voltage[2] = {"voltage_1","voltage_2"};
+	static int meter_phase[2] = {PHASE_S1,PHASE_S2};
+	static char *xfrmr_voltage[3] = {"voltage_A","voltage_B","voltage_C"};
+	static int xfrmr_phase[3] = {PHASE_A,PHASE_B,PHASE_C};
+	static char *comm_phase_name[3] = {"A","B","C"};
+	int i, j;
 
 	for(curr = tplx_mtr_obj_list; curr != 0; curr = curr->next){
 		if (curr->obj == 0) continue;
 		if (curr->ref_obj == 0) continue;
-		p_ptr = gl_get_property(curr->obj, "nominal_voltage");
-		meter_nominal = get_observed_double_value(curr->obj, p_ptr);
-		pu = 0;
-		if (has_phase(curr->obj, PHASE_S1)) {
-			p_ptr = gl_get_property(curr->obj, "voltage_1");
-			meter_voltage = get_observed_double_value(curr->obj, p_ptr);
-			if (has_phase(curr->obj, PHASE_A)) {
-				p_ptr = gl_get_property(curr->ref_obj, "nominal_voltage");
-				xfrmr_nominal = get_observed_double_value(curr->ref_obj, p_ptr);
-				p_ptr = gl_get_property(curr->ref_obj, "voltage_A");
-				xfrmr_voltage = get_observed_double_value(curr->ref_obj, p_ptr);
-				pu = meter_voltage/meter_nominal-xfrmr_voltage/xfrmr_nominal;
-				if (fails_static_condition(pu, pu_upper_bound, pu_lower_bound, 1.0, &retval)) {
-					tplx_meter_list_v7->insert(curr->obj->name);
-					increment_violation(VIOLATION7, TPXM);
-					write_to_stream(t1, echo, "VIOLATION7, %f, %f, %f, %s %s, %s %s, A S1, Per unit voltage difference between objects violates limit.", retval, pu_upper_bound, pu_lower_bound, gl_name(curr->obj, metername, 127), gl_name(curr->ref_obj, xfrmrname, 127), curr->obj->oclass->name, curr->ref_obj->oclass->name);
-				}
-			}
-			if (has_phase(curr->obj, PHASE_B)) {
-				p_ptr = gl_get_property(curr->ref_obj, "nominal_voltage");
-				xfrmr_nominal = get_observed_double_value(curr->ref_obj, p_ptr);
-				p_ptr = gl_get_property(curr->ref_obj, "voltage_B");
-				xfrmr_voltage = get_observed_double_value(curr->ref_obj, p_ptr);
-				pu = meter_voltage/meter_nominal-xfrmr_voltage/xfrmr_nominal;
-				if (fails_static_condition(pu, pu_upper_bound, pu_lower_bound, 1.0, &retval)) {
-					tplx_meter_list_v7->insert(curr->obj->name);
-					increment_violation(VIOLATION7, TPXM);
-					write_to_stream(t1, echo, "VIOLATION7, %f, %f, %f, %s %s, %s %s, B S1, Per unit voltage difference between objects violates limit.", retval, pu_upper_bound, pu_lower_bound, gl_name(curr->obj, metername, 127), gl_name(curr->ref_obj, xfrmrname, 127), curr->obj->oclass->name, curr->ref_obj->oclass->name);
-				}
-			}
-			if (has_phase(curr->obj, PHASE_C)) {
-				p_ptr = gl_get_property(curr->ref_obj, "nominal_voltage");
-				xfrmr_nominal = get_observed_double_value(curr->ref_obj, p_ptr);
-				p_ptr = gl_get_property(curr->ref_obj, "voltage_C");
-				xfrmr_voltage = get_observed_double_value(curr->ref_obj, p_ptr);
-				pu = meter_voltage/meter_nominal-xfrmr_voltage/xfrmr_nominal;
-				if (fails_static_condition(pu, pu_upper_bound, pu_lower_bound, 1.0, &retval)) {
-					tplx_meter_list_v7->insert(curr->obj->name);
-					increment_violation(VIOLATION7, TPXM);
-					write_to_stream(t1, echo, "VIOLATION7, %f, %f, %f, %s %s, %s %s, C S1, Per unit voltage difference between objects violates limit.", retval, pu_upper_bound, pu_lower_bound, gl_name(curr->obj, metername, 127), gl_name(curr->ref_obj, xfrmrname, 127), curr->obj->oclass->name, curr->ref_obj->oclass->name);
-				}
-			}
-		}
-		if (has_phase(curr->obj, PHASE_S2)) {
-			p_ptr = gl_get_property(curr->obj, "voltage_2");
-			meter_voltage = get_observed_double_value(curr->obj, p_ptr);
-			if (has_phase(curr->obj, PHASE_A)) {
-				p_ptr = gl_get_property(curr->ref_obj, "nominal_voltage");
-				xfrmr_nominal = get_observed_double_value(curr->ref_obj, p_ptr);
-				p_ptr = gl_get_property(curr->ref_obj, "voltage_A");
-				xfrmr_voltage = get_observed_double_value(curr->ref_obj, p_ptr);
-				pu = meter_voltage/meter_nominal-xfrmr_voltage/xfrmr_nominal;
-				if (fails_static_condition(pu, pu_upper_bound, pu_lower_bound, 1.0, &retval)) {
-					tplx_meter_list_v7->insert(curr->obj->name);
-					increment_violation(VIOLATION7, TPXM);
-					write_to_stream(t1, echo, "VIOLATION7, %f, %f, %f, %s %s, %s %s, A S2, Per unit voltage difference between objects violates limit.", retval, pu_upper_bound, pu_lower_bound, gl_name(curr->obj, metername, 127), gl_name(curr->ref_obj, xfrmrname, 127), curr->obj->oclass->name, curr->ref_obj->oclass->name);
-				}
-			}
-			if (has_phase(curr->obj, PHASE_B)) {
-				p_ptr = gl_get_property(curr->ref_obj, "nominal_voltage");
-				xfrmr_nominal = get_observed_double_value(curr->ref_obj, p_ptr);
-				p_ptr = gl_get_property(curr->ref_obj, "voltage_B");
-				xfrmr_voltage = get_observed_double_value(curr->ref_obj, p_ptr);
-				pu = meter_voltage/meter_nominal-xfrmr_voltage/xfrmr_nominal;
-				if (fails_static_condition(pu, pu_upper_bound, pu_lower_bound, 1.0, &retval)) {
-					tplx_meter_list_v7->insert(curr->obj->name);
-					increment_violation(VIOLATION7, TPXM);
-					write_to_stream(t1, echo, "VIOLATION7, %f, %f, %f, %s %s, %s %s, B S2, Per unit voltage difference between objects violates limit.", retval, pu_upper_bound, pu_lower_bound, gl_name(curr->obj, metername, 127), gl_name(curr->ref_obj, xfrmrname, 127), curr->obj->oclass->name, curr->ref_obj->oclass->name);
-				}
-			}
-			if (has_phase(curr->obj, PHASE_C)) {
-				p_ptr = gl_get_property(curr->ref_obj, "nominal_voltage");
-				xfrmr_nominal = get_observed_double_value(curr->ref_obj, p_ptr);
-				p_ptr = gl_get_property(curr->ref_obj, "voltage_C");
-				xfrmr_voltage = get_observed_double_value(curr->ref_obj, p_ptr);
-				pu = meter_voltage/meter_nominal-xfrmr_voltage/xfrmr_nominal;
-				if (fails_static_condition(pu, pu_upper_bound, pu_lower_bound, 1.0, &retval)) {
-					tplx_meter_list_v7->insert(curr->obj->name);
-					increment_violation(VIOLATION7, TPXM);
-					write_to_stream(t1, echo, "VIOLATION7, %f, %f, %f, %s %s, %s %s, C S2, Per unit voltage difference between objects violates limit.", retval, pu_upper_bound, pu_lower_bound, gl_name(curr->obj, metername, 127), gl_name(curr->ref_obj, xfrmrname, 127), curr->obj->oclass->name, curr->ref_obj->oclass->name);
+		if ((meter_nominal = get_nominal_voltage(curr->obj)) == NULL) continue;
+		if ((xfrmr_nominal = get_nominal_voltage(curr->ref_obj)) == NULL) continue;
+		for (i = 0; i < 2; i++) {
+			if (!has_phase(curr->obj, meter_phase[i])) continue;
+			for (j = 0; j < 3; j++) {
+				if (!has_phase(curr->obj, xfrmr_phase[j])) continue;
+				check = add_check(rule, curr->obj, meter_voltage[i], meter_nominal, 1.0, phase_name[i][j]);
+				if (check != NULL && (check->ref_value = get_check_value(curr->ref_obj, xfrmr_voltage[j], &check->ref_is_complex)) != NULL) {
+					check->ref_obj = curr->ref_obj;
+					check->ref_nominal = xfrmr_nominal;
+				} else if (check != NULL) {
+					n_checks--; // reference has no such voltage
 				}
 			}
 		}
 	}
 
+	rule.type = CMTR;
+	rule.uniq_list = comm_meter_list_v7;
 	for(curr = comm_mtr_obj_list; curr != 0; curr = curr->next){
 		if (curr->obj == 0) continue;
 		if (curr->ref_obj == 0) continue;
-		p_ptr = gl_get_property(curr->obj, "nominal_voltage");
-		meter_nominal = get_observed_double_value(curr->obj, p_ptr);
-		pu = 0;
-		if (has_phase(curr->obj, PHASE_A)) {
-			p_ptr = gl_get_property(curr->obj, "voltage_A");
-			meter_voltage = get_observed_double_value(curr->obj, p_ptr);
-			p_ptr = gl_get_property(curr->ref_obj, "nominal_voltage");
-			xfrmr_nominal = get_observed_double_value(curr->ref_obj, p_ptr);
-			p_ptr = gl_get_property(curr->ref_obj, "voltage_A");
-			xfrmr_voltage = get_observed_double_value(curr->ref_obj, p_ptr);
-			pu = meter_voltage/meter_nominal-xfrmr_voltage/xfrmr_nominal;
-			if (fails_static_condition(pu, pu_upper_bound, pu_lower_bound, 1.0, &retval)) {
-				comm_meter_list_v7->insert(curr->obj->name);
-				increment_violation(VIOLATION7, CMTR);
-				write_to_stream(t1, echo, "VIOLATION7, %f, %f, %f, %s %s, %s %s, A, Per unit voltage difference between objects violates limit.", retval, pu_upper_bound, pu_lower_bound, gl_name(curr->obj, metername, 127), gl_name(curr->ref_obj, xfrmrname, 127), curr->obj->oclass->name, curr->ref_obj->oclass->name);
-			}
-		}
-		if (has_phase(curr->obj, PHASE_B)) {
-			p_ptr = gl_get_property(curr->obj, "voltage_B");
-			meter_voltage = get_observed_double_value(curr->obj, p_ptr);
-			p_ptr = gl_get_property(curr->ref_obj, "nominal_voltage");
-			xfrmr_nominal = get_observed_double_value(curr->ref_obj, p_ptr);
-			p_ptr = gl_get_property(curr->ref_obj, "voltage_B");
-			xfrmr_voltage = get_observed_double_value(curr->ref_obj, p_ptr);
-			pu = meter_voltage/meter_nominal-xfrmr_voltage/xfrmr_nominal;
-			if (fails_static_condition(pu, pu_upper_bound, pu_lower_bound, 1.0, &retval)) {
-				comm_meter_list_v7->insert(curr->obj->name);
-				increment_violation(VIOLATION7, CMTR);
-				write_to_stream(t1, echo, "VIOLATION7, %f, %f, %f, %s %s, %s %s, B, Per unit voltage difference between objects violates limit.", retval, pu_upper_bound, pu_lower_bound, gl_name(curr->obj, metername, 127), gl_name(curr->ref_obj, xfrmrname, 127), curr->obj->oclass->name, curr->ref_obj->oclass->name);
-			}
-		}
-		if (has_phase(curr->obj, PHASE_C)) {
-			p_ptr = gl_get_property(curr->obj, "voltage_C");
-			meter_voltage = get_observed_double_value(curr->obj, p_ptr);
-			p_ptr = gl_get_property(curr->ref_obj, "nominal_voltage");
-			xfrmr_nominal = get_observed_double_value(curr->ref_obj, p_ptr);
-			p_ptr = gl_get_property(curr->ref_obj, "voltage_C");
-			xfrmr_voltage = get_observed_double_value(curr->ref_obj, p_ptr);
-			pu = meter_voltage/meter_nominal-xfrmr_voltage/xfrmr_nominal;
-			if (fails_static_condition(pu, pu_upper_bound, pu_lower_bound, 1.0, &retval)) {
-				comm_meter_list_v7->insert(curr->obj->name);
-				increment_violation(VIOLATION7, CMTR);
-				write_to_stream(t1, echo, "VIOLATION7, %f, %f, %f, %s %s, %s %s, C, Per unit voltage difference between objects violates limit.", retval, pu_upper_bound, pu_lower_bound, gl_name(curr->obj, metername, 127), gl_name(curr->ref_obj, xfrmrname, 127), curr->obj->oclass->name, curr->ref_obj->oclass->name);
+		if ((meter_nominal = get_nominal_voltage(curr->obj)) == NULL) continue;
+		if ((xfrmr_nominal = get_nominal_voltage(curr->ref_obj)) == NULL) continue;
+		for (j = 0; j < 3; j++) {
+			if (!has_phase(curr->obj, xfrmr_phase[j])) continue;
+			check = add_check(rule, curr->obj, xfrmr_voltage[j], meter_nominal, 1.0, comm_phase_name[j]);
+			if (check != NULL && (check->ref_value = get_check_value(curr->ref_obj, xfrmr_voltage[j], &check->ref_is_complex)) != NULL) {
+				check->ref_obj = curr->ref_obj;
+				check->ref_nominal = xfrmr_nominal;
+			} else if (check != NULL) {
+				n_checks--; // reference has no such voltage
 			}
 		}
 	}
@@ -1139,93 +979,190 @@ int violation_recorder::fails_static_condition (double value, double upper_bound
 	return 0;
 }
 
-int violation_recorder::fails_dynamic_condition (vobjlist *curr, int i, char *prop_name, TIMESTAMP t1, double interval, double upper_bound, double lower_bound, double normalization_value, double *retval) {
-	PROPERTY *p_ptr;
-	double value, pu;
-	p_ptr = gl_get_property(curr->obj, prop_name);
-	if (p_ptr == NULL)
-		return 0;
-	value = get_observed_double_value(curr->obj, p_ptr);
-	pu = value/normalization_value;
-	if (curr->last_t[i] == 0) {
-		// this one can not violate on the first timestep
-		curr->update_last(i, pu, t1, 0);
-		return 0;
-	}
-	// relative change since the last update
-	double pct = ((pu-curr->last_v[i])/curr->last_v[i]);
-	*retval = pct;
-	int s_curr, s_prev;
-	// we've exceeded the limit and we did
-	if (pct > upper_bound || pct < lower_bound) {
-		// the elapsed time has exceeded the interval
-		// this throws the violation flag and updates
-		// time and value
-		s_prev = sign(curr->last_s[i]);
-		s_curr = sign(pct);
-		if ((s_prev == 0) || (s_prev == s_curr)) {
-			if ((t1-curr->last_t[i]) >= (long)interval) {
-				curr->update_last(i, pu, t1, s_curr);
-				return 1;
-			// the elapsed time has not exceed the interval,
-			// we want to keep the flag, but not update
-			// time or value
-			} else {
-				curr->update_last(i, curr->last_v[i], curr->last_t[i], s_curr); // this indexing stuff is sloppy :(
-				return 0;
+static inline double get_check_observation(void *addr, bool is_complex) {
+	return is_complex ? ((complex *)addr)->Mag() : *(double *)addr;
+}
+
+// Evaluate a range of compiled checks; each check only touches its own state so ranges can run concurrently
+static void evaluate_check_range(vcheck *check, vcheck *end, TIMESTAMP t1) {
+	for ( ; check < end; check++) {
+		double value = get_check_observation(check->value, check->value_is_complex);
+		double normalization_value = check->nominal ? (*check->nominal)*check->factor : check->factor;
+		double upper_bound = *check->upper_bound;
+		double lower_bound = *check->lower_bound;
+		double pu, pct;
+		int s_curr = 0, s_prev = 0;
+
+		check->failed = false;
+		switch (check->kind) {
+
+		case VC_STATIC:
+			(normalization_value != 0. && normalization_value != 1.) ? pu = value/normalization_value : pu = value;
+			if (pu > upper_bound || pu < lower_bound) {
+				check->retval = pu;
+				check->failed = true;
 			}
+			break;
+
+		case VC_DIFFERENCE:
+			pu = value/normalization_value - get_check_observation(check->ref_value, check->ref_is_complex)/(*check->ref_nominal);
+			if (pu > upper_bound || pu < lower_bound) {
+				check->retval = pu;
+				check->failed = true;
+			}
+			break;
+
+		case VC_DYNAMIC:
+			pu = value/normalization_value;
+			if (check->last_t == 0) {
+				// this one can not violate on the first timestep
+				check->last_v = pu;
+				check->last_t = t1;
+				check->last_s = 0;
+				break;
+			}
+			// relative change since the last update
+			pct = ((pu-check->last_v)/check->last_v);
+			check->retval = pct;
+			// we've exceeded the limit
+			if (pct > upper_bound || pct < lower_bound) {
+				s_prev = sign(check->last_s);
+				s_curr = sign(pct);
+				if ((s_prev == 0) || (s_prev == s_curr)) {
+					// the elapsed time has exceeded the interval
+					// this throws the violation flag and updates
+					// time and value
+					if ((t1-check->last_t) >= (long)*check->interval) {
+						check->last_v = pu;
+						check->last_t = t1;
+						check->last_s = s_curr;
+						check->failed = true;
+					// the elapsed time has not exceed the interval,
+					// we want to keep the flag, but not update
+					// time or value
+					} else {
+						check->last_s = s_curr;
+					}
+					break;
+				}
+			}
+			check->last_v = pu;
+			check->last_t = t1;
+			check->last_s = 0;
+			break;
+
+		case VC_CONTINUOUS:
+			pu = value/normalization_value;
+			check->retval = pu;
+			// first time through
+			if (check->last_t == 0) {
+				// this one can violate on the first timestep
+				if (pu > upper_bound || pu < lower_bound) {
+					s_curr = sign(pu);
+				}
+				check->last_v = pu;
+				check->last_t = t1;
+				check->last_s = s_curr;
+				break;
+			}
+			// we've exceeded the limit
+			if (pu > upper_bound || pu < lower_bound) {
+				s_prev = sign(check->last_s);
+				s_curr = sign(pu);
+				if ((s_prev == 0) || (s_prev == s_curr)) {
+					// the elapsed time has exceeded the interval
+					// this throws the violation flag and updates
+					// time and value
+					if ((t1-check->last_t) >= (long)*check->interval) {
+						check->last_v = pu;
+						check->last_t = t1;
+						check->last_s = s_curr;
+						check->failed = true;
+					// the elapsed time has not exceed the interval,
+					// we want to keep the flag, and update
+					// time and value only if the violation hasn't been
+					// seen before
+					} else if (s_prev == 0) {
+						check->last_v = pu;
+						check->last_t = t1;
+						check->last_s = s_curr;
+					} else {
+						check->last_s = s_curr;
+					}
+					break;
+				}
+			}
+			check->last_v = pu;
+			check->last_t = t1;
+			check->last_s = 0;
+			break;
+
+		default:
+			break;
 		}
 	}
-	curr->update_last(i, pu, t1, 0);
-	return 0;
 }
 
-int violation_recorder::fails_continuous_condition (vobjlist *curr, int i, char *prop_name, TIMESTAMP t1, double interval, double upper_bound, double lower_bound, double normalization_value, double *retval) {
-	PROPERTY *p_ptr;
-	double value, pu;
-	p_ptr = gl_get_property(curr->obj, prop_name);
-	if (p_ptr == NULL)
-		return 0;
-	int s_curr = 0, s_prev = 0;
-	value = get_observed_double_value(curr->obj, p_ptr);
-	pu = value/normalization_value;
-	*retval = pu;
-	// first time through
-	if (curr->last_t[i] == 0) {
-		// this one can violate on the first timestep
-		if (pu > upper_bound || pu < lower_bound) {
-			s_curr = sign(pu);
+// Evaluate the checks [first,last) of a range on a core pool thread
+static TIMESTAMP evaluate_check_task(TPTASK *task, unsigned int first, unsigned int last, unsigned int thread) {
+	vcheck *begin = (vcheck *)task->data;
+	evaluate_check_range(begin+first, begin+last, task->t1);
+	return TS_NEVER;
+}
+
+void violation_recorder::evaluate_checks(int flags, TIMESTAMP t1) {
+	int n;
+
+	for (n = 1; n <= 8; n++) {
+		if (!(flags & (1<<(n-1))) || first_check[n-1] == first_check[n]) continue;
+
+		// gather contiguous enabled violations into one range
+		size_t begin = first_check[n-1];
+		while (n < 8 && (flags & (1<<n)))
+			n++;
+		size_t count = first_check[n] - begin;
+
+		// split large ranges across the core pool threads
+		if (count < 2*VC_MINITEMS || gl_pool_threadcount() < 2) {
+			evaluate_check_range(checks+begin, checks+begin+count, t1);
+			continue;
 		}
-		curr->update_last(i, pu, t1, s_curr);
-		return 0;
+		TPTASK task, *run = &task;
+		memset(&task, 0, sizeof(task));
+		task.name = "violation checks";
+		task.call = evaluate_check_task;
+		task.data = (void *)(checks+begin);
+		task.n_items = (unsigned int)count;
+		task.grain = VC_MINITEMS;
+		task.t1 = t1;
+		gl_pool_run(&run, 1);
 	}
-	// change since the last update
-	// we've exceeded the limit
-	if (pu > upper_bound || pu < lower_bound) {
-		// the elapsed time has exceeded the interval
-		// this throws the violation flag and updates
-		// time and value
-		s_prev = sign(curr->last_s[i]);
-		s_curr = sign(pu);
-		if ((s_prev == 0) || (s_prev == s_curr)) {
-			if ((t1-curr->last_t[i]) >= (long)interval) {
-				curr->update_last(i, pu, t1, s_curr);
-				return 1;
-			// the elapsed time has not exceed the interval,
-			// we want to keep the flag, and update
-			// time and value only if the violation hasn't been
-			// seen before
-			} else if (s_prev == 0) {
-				curr->update_last(i, pu, t1, s_curr);
-				return 0;
-			} else {
-				curr->update_last(i, curr->last_v[i], curr->last_t[i], s_curr); // this indexing stuff is sloppy :(
-				return 0;
-			}
+}
+
+// Report the failed checks of violation n, in the order they were compiled
+void violation_recorder::emit_checks(int n, TIMESTAMP t1) {
+	char objname[128];
+	char refname[128];
+	char message[256];
+	size_t i;
+
+	for (i = first_check[n-1]; i < first_check[n]; i++) {
+		vcheck *check = checks + i;
+		if (!check->failed) continue;
+		if (check->uniq_list != NULL && !checks[check->first].listed) {
+			check->uniq_list->add(check->obj->name);
+			checks[check->first].listed = true;
 		}
+		if (check->type != 0)
+			increment_violation(check->violation, check->type);
+		else
+			increment_violation(check->violation);
+		sprintf(message, check->message, check->interval ? (int)*check->interval : 0);
+		if (check->kind == VC_DIFFERENCE)
+			write_to_stream(t1, echo, "VIOLATION%i, %f, %f, %f, %s %s, %s %s, %s, %s", n, check->retval, *check->upper_bound, *check->lower_bound, gl_name(check->obj, objname, 127), gl_name(check->ref_obj, refname, 127), check->obj->oclass->name, check->ref_obj->oclass->name, check->phase, message);
+		else
+			write_to_stream(t1, echo, "VIOLATION%i, %f, %f, %f, %s, %s, %s, %s", n, check->retval, *check->upper_bound, *check->lower_bound, gl_name(check->obj, objname, 127), check->obj->oclass->name, check->phase, message);
 	}
-	curr->update_last(i, pu, t1, 0);
-	return 0;
 }
 
 int violation_recorder::has_phase(OBJECT *obj, int phase) {
@@ -8,6 +8,7 @@
 #include "../powerflow/transformer.h"
 #include "../powerflow/line.h"
 #include <new>
+#include <pthread.h>
 
 EXPORT void new_violation_recorder(MODULE *);
 
@@ -83,6 +84,7 @@ public:
 	vobjlist(){
 		obj = 0;
 		next = 0; 
+		last = 0;
 		ref_obj=0;
 		for( int i = 0; i < 3; i++ ){
 			last_v[i] = 0;
@@ -93,6 +95,7 @@ public:
 	vobjlist(OBJECT *o){
 		obj = o; 
 		next = 0; 
+		last = 0;
 		ref_obj=0;
 		for( int i = 0; i < 3; i++ ){
 			last_v[i] = 0;
@@ -103,24 +106,24 @@ public:
 	~vobjlist(){if(next != 0) delete next;}
 	void tack(OBJECT *o) {
 		if (obj) {
-			if(next){
-				next->tack(o);
-			} else {
-				//Core-callback allocation - replicates the function, but done manually here
-				next = (vobjlist *)gl_malloc(sizeof(vobjlist));
-
-				if (next == NULL)
-				{
-					GL_THROW("violation_recorder - Failed to allocate space for object list to check");
-					/*  TROUBLESHOOT
-					While attempting to allocate the memory for an object list within the violation recorder, an error occurred.  Please check your
-					file and try again.  If the error persists, please submit you code and a bug report via the ticketing system.
-					*/
-				}
-
-				//"Constructor"
-				new (next) vobjlist();
+			//Append after the last item so building the list stays linear
+			vobjlist *end = last ? last : this;
+
+			//Core-callback allocation - replicates the function, but done manually here
+			end->next = (vobjlist *)gl_malloc(sizeof(vobjlist));
+
+			if (end->next == NULL)
+			{
+				GL_THROW("violation_recorder - Failed to allocate space for object list to check");
+				/*  TROUBLESHOOT
+				While attempting to allocate the memory for an object list within the violation recorder, an error occurred.  Please check your
+				file and try again.  If the error persists, please submit you code and a bug report via the ticketing system.
+				*/
 			}
+
+			//"Constructor"
+			new (end->next) vobjlist(o);
+			last = end->next;
 		} else {
 			obj = o;
 		}
@@ -129,13 +132,11 @@ public:
 		ref_obj = o;
 	}
 	int length() {
-		if(next){
-			return 1+next->length();
+		int n = 0;
+		for (vobjlist *item = this; item != 0; item = item->next) {
+			if (item->obj) n++;
 		}
-		if (obj) {
-			return 1;
-		}
-		return 0;
+		return n;
 	}
 	void update_last(int i, double v, TIMESTAMP t, int s) { // ugh.. this is a bit ugly
 		if (i>2 || i<0)
@@ -146,6 +147,7 @@ public:
 	}
 	OBJECT *obj;
 	vobjlist *next;
+	vobjlist *last; // last item of the list (head only)
 	OBJECT *ref_obj;
 	double last_v[3];
 	TIMESTAMP last_t[3];
@@ -165,42 +167,108 @@ public:
 	}
 	~uniqueList(){if(next != 0) delete next;}
 	void insert(char *n) {
-		if (name && strcmp(name, n) != 0) {
-			if(next){
-				next->insert(n);
-			} else {
-				//Core-callback allocation - replicates the function, but done manually here
-				next = (uniqueList *)gl_malloc(sizeof(uniqueList));
-
-				if (next == NULL)
-				{
-					GL_THROW("violation_recorder - Failed to allocate space for unique list");
-					/*  TROUBLESHOOT
-					While attempting to allocate the memory for a list of unique objects within the violation recorder, an error occurred.  Please check your
-					file and try again.  If the error persists, please submit you code and a bug report via the ticketing system.
-					*/
-				}
-
-				//"Constructor"
-				new (next) uniqueList();
+		uniqueList *item = this;
+		if (name == 0) {
+			name = n;
+			return;
+		}
+		for (;;) {
+			if (strcmp(item->name, n) == 0) return;
+			if (item->next == 0) break;
+			item = item->next;
+		}
+		item->add(n);
+	}
+	// adds a name the caller knows is not in the list yet
+	void add(char *n) {
+		if (name) {
+			//Core-callback allocation - replicates the function, but done manually here
+			uniqueList *item = (uniqueList *)gl_malloc(sizeof(uniqueList));
+
+			if (item == NULL)
+			{
+				GL_THROW("violation_recorder - Failed to allocate space for unique list");
+				/*  TROUBLESHOOT
+				While attempting to allocate the memory for a list of unique objects within the violation recorder, an error occurred.  Please check your
+				file and try again.  If the error persists, please submit you code and a bug report via the ticketing system.
+				*/
 			}
+
+			//"Constructor"
+			new (item) uniqueList(n);
+			item->next = next;
+			next = item;
 		} else {
 			name = n;
 		}
 	}
 	int length() {
-		if(next){
-			return 1+next->length();
-		}
-		if(name) {
-			return 1;
+		int n = 0;
+		for (uniqueList *item = this; item != 0; item = item->next) {
+			if (item->name) n++;
 		}
-		return 0;
+		return n;
 	}
 	char *name;
 	uniqueList *next;
 };
 
+#define VC_STATIC		0	// value out of limits
+#define VC_CONTINUOUS	1	// value out of limits continuously over an interval
+#define VC_DYNAMIC		2	// relative change out of limits over an interval
+#define VC_DIFFERENCE	3	// difference of two per unit values out of limits
+
+#define VC_MINITEMS		4096	// minimum number of checks given to each pool thread
+
+/** Compiled violation check
+	Each rule is resolved at init into one check per object and phase.  The check holds
+	the address of the observed property and of its normalization value, so a timestep
+	only walks the check array; nothing is looked up by name.
+ **/
+class vcheck{
+public:
+	int violation;		// violation flag (VIOLATION1..VIOLATION8)
+	int type;			// component type counted (0 for none)
+	int kind;			// VC_STATIC, VC_CONTINUOUS, VC_DYNAMIC or VC_DIFFERENCE
+	OBJECT *obj;		// observed object
+	OBJECT *ref_obj;	// reference object (VC_DIFFERENCE only)
+	void *value;		// observed property
+	bool value_is_complex;	// magnitude of complex properties is observed
+	double *nominal;	// normalization property (NULL when factor alone is used)
+	double factor;		// normalization multiplier
+	void *ref_value;	// reference property (VC_DIFFERENCE only)
+	bool ref_is_complex;
+	double *ref_nominal;	// reference normalization property (VC_DIFFERENCE only)
+	double *upper_bound;
+	double *lower_bound;
+	double *interval;	// VC_CONTINUOUS and VC_DYNAMIC only
+	uniqueList *uniq_list;	// list of objects in violation (NULL for none)
+	size_t first;		// first check of the same object in the same rule list
+	bool listed;		// object was added to uniq_list (first check only)
+	char *phase;		// phase label written with the violation
+	char *message;		// message written with the violation (%i is the interval)
+	// evaluation state
+	double last_v;
+	TIMESTAMP last_t;
+	int last_s;
+	bool failed;
+	double retval;
+};
+
+/** Violation rule
+	Settings shared by all the checks compiled from one rule.
+ **/
+typedef struct s_vrule {
+	int violation;
+	int type;
+	int kind;
+	double *upper_bound;
+	double *lower_bound;
+	double *interval;
+	uniqueList *uniq_list;
+	char *message;
+} vrule;
+
 class violation_recorder{
 public:
 	static violation_recorder *defaults;
@@ -250,17 +318,23 @@ private:
 	int write_footer();
 	int pass_error_check();
 	int check_violations(TIMESTAMP);
-	int check_violation_1(TIMESTAMP);
-	int check_violation_2(TIMESTAMP);
-	int check_violation_3(TIMESTAMP);
 	int check_violation_4(TIMESTAMP);
 	int check_violation_5(TIMESTAMP);
-	int check_violation_6(TIMESTAMP);
-	int check_violation_7(TIMESTAMP);
 	int check_violation_8(TIMESTAMP);
-	int check_line_thermal_limit(TIMESTAMP, vobjlist *, uniqueList *, int, double, double);
-	int check_xfrmr_thermal_limit(TIMESTAMP, vobjlist *, uniqueList *, int, double, double);
 	int check_reverse_flow_violation(TIMESTAMP, int, double, char*);
+	int compile_checks();
+	int compile_violation_1();
+	int compile_violation_2();
+	int compile_violation_3();
+	int compile_violation_6();
+	int compile_violation_7();
+	int compile_line_thermal_limit(vobjlist *, uniqueList *, int);
+	int compile_xfrmr_thermal_limit(vobjlist *, uniqueList *, int);
+	vcheck *add_check(vrule &, OBJECT *, char *, double *, double, char *);
+	void *get_check_value(OBJECT *, char *, bool *);
+	double *get_nominal_voltage(OBJECT *);
+	void evaluate_checks(int, TIMESTAMP);
+	void emit_checks(int, TIMESTAMP);
 	int write_to_stream (TIMESTAMP, bool, char *, ...);
 	double get_observed_double_value(OBJECT *, PROPERTY *);
 	complex get_observed_complex_value(OBJECT *, PROPERTY *);
@@ -270,8 +344,6 @@ private:
 	int has_phase(OBJECT *, int);
 	int fails_static_condition (OBJECT *, char *, double, double, double, double *);
 	int fails_static_condition (double, double, double, double, double *);
-	int fails_dynamic_condition (vobjlist *, int, char *, TIMESTAMP, double, double, double, double, double *);
-	int fails_continuous_condition (vobjlist *, int, char *, TIMESTAMP, double, double, double, double, double *);
 	int increment_violation (int);
 	int increment_violation (int, int);
 	int get_violation_count(int);
@@ -321,6 +393,11 @@ private:
 	uniqueList *tplx_meter_list_v7;
 	uniqueList *comm_meter_list_v7;
 
+	vcheck *checks;
+	size_t n_checks;
+	size_t max_checks;
+	size_t first_check[9]; // checks of violation n are first_check[n-1] to first_check[n]-1
+
 	int write_count;
 	TIMESTAMP next_write;
 	TIMESTAMP last_write;
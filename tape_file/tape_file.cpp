@@ -425,7 +425,7 @@ EXPORT int open_histogram(histogram *my, char *fname, char *flags)
 		fprintf(my->fp,"# sampling interval.. %f\n", my->sampling_interval);
 		fprintf(my->fp,"# limit..... %d\n", my->limit);
 		if(my->bins[0] != 0){
-			fprintf(my->fp,"# timestamp,%s\n", my->bins.get_string());
+			fprintf(my->fp,"# timestamp,%s", my->bins.get_string());
 		} else {
 			int i = 0;
 			for(i = 0; i < my->bin_count; ++i){
@@ -434,8 +434,11 @@ EXPORT int open_histogram(histogram *my, char *fname, char *flags)
 					fprintf(my->fp,",");
 				}
 			}
-			fprintf(my->fp, "\n");
 		}
+		if(my->quantiles[0] != 0){
+			fprintf(my->fp,"%s%s", (my->bin_count > 0 ? "," : ""), my->quantiles.get_string());
+		}
+		fprintf(my->fp, "\n");
 	}	
 
 	return 1;